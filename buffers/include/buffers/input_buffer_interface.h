@@ -28,6 +28,12 @@ public:
 	std::size_t physical_size() { return size() - virtual_size(); }
 
 	virtual std::size_t read(std::size_t pos, std::size_t count, std::byte* data) = 0;
+
+	//Hints that [pos, pos + count) will be read sequentially.
+	//Only buffers which own a file mapping act on the hint. Stream buffers
+	//ignore it, as std::istream gives no portable access to the file descriptor.
+	virtual void advise_sequential_read(std::size_t /* pos */,
+		std::size_t /* count */) noexcept {}
 	
 	[[nodiscard]]
 	std::size_t absolute_offset() const noexcept
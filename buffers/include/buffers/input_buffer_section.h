@@ -23,6 +23,8 @@ public:
 
 	virtual std::size_t read(std::size_t pos,
 		std::size_t count, std::byte* data) override;
+	virtual void advise_sequential_read(std::size_t pos,
+		std::size_t count) noexcept override;
 
 	[[nodiscard]]
 	virtual std::size_t size() override;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+#include "buffers/input_buffer_interface.h"
+
+namespace buffers
+{
+
+//Read-only memory mapping of the whole file.
+//Throws std::system_error if the file can not be opened or mapped.
+class [[nodiscard]] input_file_mapping_buffer final
+	: public input_buffer_interface
+{
+public:
+	explicit input_file_mapping_buffer(const std::filesystem::path& path);
+	virtual ~input_file_mapping_buffer() override;
+
+	input_file_mapping_buffer(const input_file_mapping_buffer&) = delete;
+	input_file_mapping_buffer& operator=(const input_file_mapping_buffer&) = delete;
+
+	[[nodiscard]]
+	virtual const std::byte* get_raw_data(std::size_t pos, std::size_t count) const override;
+	[[nodiscard]]
+	virtual std::size_t size() override;
+
+	virtual std::size_t read(std::size_t pos,
+		std::size_t count, std::byte* data) override;
+	virtual void advise_sequential_read(std::size_t pos,
+		std::size_t count) noexcept override;
+
+private:
+	const std::byte* memory_ = nullptr;
+	std::size_t size_{};
+};
+
+} //namespace buffers
@@ -30,6 +30,13 @@ public:
 	[[nodiscard]]
 	virtual std::size_t wpos() override;
 
+	//Reserves memory for the expected number of bytes
+	//(e.g. image_builder::get_built_size)
+	void reserve(std::size_t size);
+	//Clears the data and moves the write position to the beginning.
+	//Allocated memory is kept, so the buffer can be reused.
+	void reset() noexcept;
+
 private:
 	buffer_type& data_;
 	std::size_t pos_ = 0;
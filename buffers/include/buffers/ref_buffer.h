@@ -38,6 +38,10 @@ public:
 	ref_buffer& operator=(ref_buffer&&) = default;
 
 	void deserialize(const input_buffer_ptr& buffer, bool copy_memory);
+	//References the buffer if its physical data is contiguous in memory
+	//(see input_buffer_interface::get_raw_data), copies the data otherwise.
+	//Returns true if the data was copied.
+	bool deserialize_contiguous(const input_buffer_ptr& buffer);
 	void serialize(output_buffer_interface& buffer,
 		bool write_virtual_data = false) const;
 	std::size_t serialize_until(output_buffer_interface& buffer,
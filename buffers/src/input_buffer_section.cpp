@@ -79,6 +79,15 @@ const std::byte* input_buffer_section::get_raw_data(std::size_t pos, std::size_t
 	return buf_->get_raw_data(pos + offset_, count);
 }
 
+void input_buffer_section::advise_sequential_read(std::size_t pos,
+	std::size_t count) noexcept
+{
+	if (!utilities::math::is_sum_safe(pos, count) || pos + count > size_)
+		return;
+
+	buf_->advise_sequential_read(pos + offset_, count);
+}
+
 std::size_t input_buffer_section::size()
 {
 	return size_;
@@ -0,0 +1,160 @@
+#include "buffers/input_file_mapping_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif //NOMINMAX
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif //WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else //_WIN32
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif //_WIN32
+
+#include "utilities/generic_error.h"
+#include "utilities/math.h"
+#include "utilities/scoped_guard.h"
+
+namespace
+{
+
+#ifdef _WIN32
+[[noreturn]] void throw_last_error()
+{
+	throw std::system_error(static_cast<int>(::GetLastError()), std::system_category());
+}
+#else //_WIN32
+[[noreturn]] void throw_last_error()
+{
+	throw std::system_error(errno, std::generic_category());
+}
+#endif //_WIN32
+
+} //namespace
+
+namespace buffers
+{
+
+#ifdef _WIN32
+input_file_mapping_buffer::input_file_mapping_buffer(const std::filesystem::path& path)
+{
+	HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw_last_error();
+
+	utilities::scoped_guard file_guard([file] { ::CloseHandle(file); });
+
+	LARGE_INTEGER file_size{};
+	if (!::GetFileSizeEx(file, &file_size))
+		throw_last_error();
+
+	if (static_cast<unsigned long long>(file_size.QuadPart) > SIZE_MAX)
+		throw std::system_error(std::make_error_code(std::errc::file_too_large));
+
+	size_ = static_cast<std::size_t>(file_size.QuadPart);
+	if (!size_)
+		return;
+
+	HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+		throw_last_error();
+
+	//The view keeps the mapping object alive
+	utilities::scoped_guard mapping_guard([mapping] { ::CloseHandle(mapping); });
+	memory_ = static_cast<const std::byte*>(
+		::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!memory_)
+		throw_last_error();
+}
+
+input_file_mapping_buffer::~input_file_mapping_buffer()
+{
+	if (memory_)
+		::UnmapViewOfFile(memory_);
+}
+#else //_WIN32
+input_file_mapping_buffer::input_file_mapping_buffer(const std::filesystem::path& path)
+{
+	const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file == -1)
+		throw_last_error();
+
+	utilities::scoped_guard file_guard([file] { ::close(file); });
+
+	struct stat file_stat {};
+	if (::fstat(file, &file_stat) == -1)
+		throw_last_error();
+
+	size_ = static_cast<std::size_t>(file_stat.st_size);
+	if (!size_)
+		return;
+
+	void* memory = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+	if (memory == MAP_FAILED)
+		throw_last_error();
+
+	memory_ = static_cast<const std::byte*>(memory);
+}
+
+input_file_mapping_buffer::~input_file_mapping_buffer()
+{
+	if (memory_)
+		::munmap(const_cast<std::byte*>(memory_), size_);
+}
+#endif //_WIN32
+
+void input_file_mapping_buffer::advise_sequential_read(
+	[[maybe_unused]] std::size_t pos, [[maybe_unused]] std::size_t count) noexcept
+{
+#ifndef _WIN32
+	if (pos >= size_)
+		return;
+
+	static const long system_page_size = ::sysconf(_SC_PAGESIZE);
+	if (system_page_size <= 0)
+		return;
+
+	//The mapping starts on a page boundary, so the range start
+	//aligned down to the page boundary is still inside the mapping
+	count = (std::min)(count, size_ - pos);
+	const auto aligned_pos = pos - pos % static_cast<std::size_t>(system_page_size);
+	//This is only a hint, errors are ignored
+	static_cast<void>(::posix_madvise(const_cast<std::byte*>(memory_ + aligned_pos),
+		count + (pos - aligned_pos), POSIX_MADV_SEQUENTIAL));
+#endif //_WIN32
+}
+
+std::size_t input_file_mapping_buffer::size()
+{
+	return size_;
+}
+
+std::size_t input_file_mapping_buffer::read(std::size_t pos,
+	std::size_t count, std::byte* data)
+{
+	if (!count)
+		return 0u;
+
+	std::memcpy(data, get_raw_data(pos, count), count);
+	return count;
+}
+
+const std::byte* input_file_mapping_buffer::get_raw_data(
+	std::size_t pos, std::size_t count) const
+{
+	if (!utilities::math::is_sum_safe(pos, count) || pos + count > size_)
+		throw std::system_error(utilities::generic_errc::buffer_overrun);
+
+	return memory_ + pos;
+}
+
+} //namespace buffers
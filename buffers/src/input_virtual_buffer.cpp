@@ -59,6 +59,12 @@ const std::byte* input_virtual_buffer::get_raw_data(std::size_t pos, std::size_t
 	return buf_->get_raw_data(pos, count);
 }
 
+void input_virtual_buffer::advise_sequential_read(std::size_t pos,
+	std::size_t count) noexcept
+{
+	buf_->advise_sequential_read(pos, count);
+}
+
 std::size_t input_virtual_buffer::size()
 {
 	return buf_->size() + additional_virtual_size_;
@@ -17,10 +17,11 @@ std::size_t output_memory_buffer::size()
 
 void output_memory_buffer::write(std::size_t count, const std::byte* data)
 {
-	if (pos_ + count > data_.size())
-		data_.resize(pos_ + count);
-
-	std::copy(data, data + count, data_.data() + pos_);
+	//pos_ never exceeds the size of the data. Bytes past the end are
+	//appended without zero-initializing them first.
+	auto overwritten = (std::min)(count, data_.size() - pos_);
+	std::copy(data, data + overwritten, data_.data() + pos_);
+	data_.insert(data_.end(), data + overwritten, data + count);
 	pos_ += count;
 }
 
@@ -48,4 +49,15 @@ std::size_t output_memory_buffer::wpos()
 	return pos_;
 }
 
+void output_memory_buffer::reserve(std::size_t size)
+{
+	data_.reserve(size);
+}
+
+void output_memory_buffer::reset() noexcept
+{
+	data_.clear();
+	pos_ = 0;
+}
+
 } //namespace buffers
@@ -82,6 +82,17 @@ void ref_buffer::deserialize(const input_buffer_ptr& buffer, bool copy_memory)
 		buffer_.emplace<buffer_ref>(buffer);
 }
 
+bool ref_buffer::deserialize_contiguous(const input_buffer_ptr& buffer)
+{
+	assert(buffer);
+
+	const auto physical_size = buffer->physical_size();
+	const bool copy_memory = physical_size
+		&& !buffer->get_raw_data(0u, physical_size);
+	deserialize(buffer, copy_memory);
+	return copy_memory;
+}
+
 std::size_t ref_buffer::serialize_buffer(const input_buffer_ptr& ref,
 	output_buffer_interface& buffer, std::size_t offset, std::size_t size,
 	bool write_virtual_data) const
@@ -0,0 +1,181 @@
+#include "dumper_options.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace
+{
+
+constexpr std::array stage_names{
+	std::pair{ dump_stage::dos_header, "dos_header" },
+	std::pair{ dump_stage::dos_stub, "dos_stub" },
+	std::pair{ dump_stage::rich_data, "rich" },
+	std::pair{ dump_stage::file_signature, "signature" },
+	std::pair{ dump_stage::file_header, "file_header" },
+	std::pair{ dump_stage::optional_header, "optional_header" },
+	std::pair{ dump_stage::section_table, "sections" },
+	std::pair{ dump_stage::exports, "exports" },
+	std::pair{ dump_stage::imports, "imports" },
+	std::pair{ dump_stage::bound_imports, "bound_imports" },
+	std::pair{ dump_stage::tls, "tls" },
+	std::pair{ dump_stage::relocations, "relocations" },
+	std::pair{ dump_stage::load_config, "load_config" },
+	std::pair{ dump_stage::exceptions, "exceptions" },
+	std::pair{ dump_stage::resources, "resources" },
+	std::pair{ dump_stage::debug, "debug" }
+};
+
+static_assert(stage_names.size() == static_cast<std::size_t>(dump_stage::max_stage));
+
+dump_stage parse_stage(std::string_view name)
+{
+	auto it = std::ranges::find_if(stage_names,
+		[name](const auto& stage) { return stage.second == name; });
+	if (it == stage_names.end())
+		throw std::invalid_argument("Unknown dump stage: " + std::string(name));
+	return it->first;
+}
+
+dumper_options::stage_set parse_stages(std::string_view list)
+{
+	dumper_options::stage_set result;
+	while (!list.empty())
+	{
+		auto comma_pos = list.find(',');
+		auto name = list.substr(0, comma_pos);
+		if (name == "headers")
+		{
+			for (const auto& [stage, stage_name] : stage_names)
+			{
+				if (is_header_stage(stage))
+					result.set(static_cast<std::size_t>(stage));
+			}
+		}
+		else if (name == "all")
+		{
+			result.set();
+		}
+		else
+		{
+			result.set(static_cast<std::size_t>(parse_stage(name)));
+		}
+
+		if (comma_pos == std::string_view::npos)
+			break;
+		list.remove_prefix(comma_pos + 1u);
+	}
+	return result;
+}
+
+output_format parse_format(std::string_view format)
+{
+	if (format == "text")
+		return output_format::text;
+	if (format == "json")
+		return output_format::json;
+	if (format == "ndjson")
+		return output_format::ndjson;
+	throw std::invalid_argument("Unknown output format: " + std::string(format));
+}
+
+std::size_t parse_jobs(std::string_view jobs)
+{
+	std::size_t result{};
+	auto [ptr, ec] = std::from_chars(jobs.data(), jobs.data() + jobs.size(), result);
+	if (ec != std::errc{} || ptr != jobs.data() + jobs.size() || !result)
+		throw std::invalid_argument("Invalid number of jobs: " + std::string(jobs));
+	return result;
+}
+
+bool get_option_value(std::string_view arg, std::string_view name,
+	std::string_view& value)
+{
+	if (!arg.starts_with(name) || arg.size() == name.size()
+		|| arg[name.size()] != '=')
+	{
+		return false;
+	}
+
+	value = arg.substr(name.size() + 1u);
+	return true;
+}
+
+} //namespace
+
+bool is_header_stage(dump_stage stage) noexcept
+{
+	return stage <= dump_stage::section_table;
+}
+
+const char* get_stage_name(dump_stage stage) noexcept
+{
+	return stage_names[static_cast<std::size_t>(stage)].second;
+}
+
+dumper_options parse_dumper_options(int argc, char* argv[])
+{
+	dumper_options result;
+	bool files_only = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg(argv[i]);
+		std::string_view value;
+		if (files_only || !arg.starts_with("--"))
+			result.files.emplace_back(arg);
+		else if (arg == "--")
+			files_only = true;
+		else if (arg == "--headers-only")
+			result.headers_only = true;
+		else if (arg == "--timings")
+			result.print_timings = true;
+		else if (get_option_value(arg, "--dump", value))
+			result.stages = parse_stages(value);
+		else if (get_option_value(arg, "--format", value))
+			result.format = parse_format(value);
+		else if (get_option_value(arg, "--jobs", value))
+			result.jobs = parse_jobs(value);
+		else
+			throw std::invalid_argument("Unknown option: " + std::string(arg));
+	}
+
+	if (result.files.empty())
+		throw std::invalid_argument("No PE files specified");
+
+	if (result.headers_only)
+	{
+		for (const auto& [stage, name] : stage_names)
+		{
+			if (!is_header_stage(stage))
+				result.stages.reset(static_cast<std::size_t>(stage));
+		}
+	}
+
+	if (!result.jobs)
+		result.jobs = (std::max)(1u, std::thread::hardware_concurrency());
+	result.jobs = (std::min)(result.jobs, result.files.size());
+
+	return result;
+}
+
+void print_usage(std::ostream& stream)
+{
+	stream << "Usage: console_dumper.exe [options] pe_file [pe_file...]\n"
+		"Options:\n"
+		"  --dump=stage[,stage...]   Dump only the listed stages. Stages:\n"
+		"                            all, headers";
+	for (const auto& [stage, name] : stage_names)
+		stream << ", " << name;
+	stream << "\n"
+		"  --format=text|json|ndjson Output format (default: text)\n"
+		"                            JSON output contains headers, sections,\n"
+		"                            exports, imports, relocations and resources\n"
+		"  --headers-only            Do not load section data and overlay,\n"
+		"                            dump headers and section table only\n"
+		"  --jobs=N                  Number of files to process in parallel\n"
+		"  --timings                 Print time spent on each stage\n";
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class dump_stage : std::size_t
+{
+	dos_header,
+	dos_stub,
+	rich_data,
+	file_signature,
+	file_header,
+	optional_header,
+	section_table,
+	exports,
+	imports,
+	bound_imports,
+	tls,
+	relocations,
+	load_config,
+	exceptions,
+	resources,
+	debug,
+	max_stage
+};
+
+enum class output_format
+{
+	text,
+	json,
+	ndjson
+};
+
+struct dumper_options
+{
+	using stage_set = std::bitset<static_cast<std::size_t>(dump_stage::max_stage)>;
+
+	std::vector<std::string> files;
+	stage_set stages = stage_set{}.set();
+	output_format format = output_format::text;
+	bool headers_only = false;
+	bool print_timings = false;
+	std::size_t jobs = 0;
+
+	[[nodiscard]]
+	bool is_enabled(dump_stage stage) const
+	{
+		return stages.test(static_cast<std::size_t>(stage));
+	}
+};
+
+[[nodiscard]]
+bool is_header_stage(dump_stage stage) noexcept;
+
+[[nodiscard]]
+const char* get_stage_name(dump_stage stage) noexcept;
+
+//Throws std::invalid_argument with a description of the invalid option
+[[nodiscard]]
+dumper_options parse_dumper_options(int argc, char* argv[]);
+
+void print_usage(std::ostream& stream);
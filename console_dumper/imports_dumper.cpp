@@ -65,9 +65,10 @@ void dump_import_info(formatter& fmt,
 		static_cast<const pe_bliss::imports::imported_function_address<Va>&>(hint_name));
 }
 
-template<typename Va, typename Descriptor>
+template<typename Va, typename Descriptor, typename Allocator>
 void dump_imports(formatter& fmt,
-	const std::vector<pe_bliss::imports::imported_library_details<Va, Descriptor>>& imports) try
+	const std::vector<pe_bliss::imports::imported_library_details<Va, Descriptor>,
+		Allocator>& imports) try
 {
 	for (const auto& lib : imports)
 	{
@@ -79,7 +80,7 @@ void dump_imports(formatter& fmt,
 				std::bind(dump_is_library_bound, std::ref(fmt), lib.is_bound())},
 			value_info{"forwarder_chain"},
 			value_info{"name", true, std::bind(
-				&formatter::print_packed_string<pe_bliss::packed_c_string>, std::ref(fmt),
+				&formatter::print_packed_string<pe_bliss::packed_list_c_string>, std::ref(fmt),
 				std::cref(lib.get_library_name()))},
 			value_info{"address_table"}
 		});
@@ -0,0 +1,508 @@
+#include "json_dumper.h"
+
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+#include "dumper_options.h"
+#include "json_formatter.h"
+#include "stage_timer.h"
+
+#include "buffers/input_buffer_stateful_wrapper.h"
+#include "pe_bliss2/bound_import/bound_import_directory_loader.h"
+#include "pe_bliss2/bound_import/bound_library.h"
+#include "pe_bliss2/core/optional_header.h"
+#include "pe_bliss2/debug/debug_directory.h"
+#include "pe_bliss2/debug/debug_directory_loader.h"
+#include "pe_bliss2/exceptions/exception_directory_loader.h"
+#include "pe_bliss2/exports/export_directory_loader.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/imports/import_directory_loader.h"
+#include "pe_bliss2/load_config/load_config_directory.h"
+#include "pe_bliss2/load_config/load_config_directory_loader.h"
+#include "pe_bliss2/relocations/relocation_directory_loader.h"
+#include "pe_bliss2/resources/resource_directory_loader.h"
+#include "pe_bliss2/rich/compid_database.h"
+#include "pe_bliss2/rich/rich_header.h"
+#include "pe_bliss2/rich/rich_header_loader.h"
+#include "pe_bliss2/tls/tls_directory.h"
+#include "pe_bliss2/tls/tls_directory_loader.h"
+
+namespace
+{
+
+void dump_dos_header(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	fmt.print_structure("dos_header", image.get_dos_header().get_descriptor(), std::array{
+		"e_magic", "e_cblp", "e_cp", "e_crlc", "e_cparhdr", "e_minalloc",
+		"e_maxalloc", "e_ss", "e_sp", "e_csum", "e_ip", "e_cs", "e_lfarlc",
+		"e_ovno", "e_res", "e_oemid", "e_oeminfo", "e_res2", "e_lfanew"
+	});
+}
+
+void dump_dos_stub(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	fmt.begin_object("dos_stub");
+	fmt.print_value("absolute_offset", image.get_dos_stub().data()->absolute_offset());
+	fmt.print_value("size", image.get_dos_stub().data()->size());
+	fmt.end_object();
+}
+
+void dump_rich_data(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	buffers::input_buffer_stateful_wrapper_ref dos_stub_ref(
+		*image.get_dos_stub().data());
+	auto header = pe_bliss::rich::load(dos_stub_ref);
+	if (!header)
+		return;
+
+	fmt.begin_object("rich_header");
+	fmt.print_value("absolute_offset", header->get_absolute_offset());
+	fmt.print_value("checksum", header->get_checksum());
+	buffers::input_buffer_stateful_wrapper_ref full_headers_ref(
+		*image.get_full_headers_buffer().data());
+	fmt.print_value("calculated_checksum", header->calculate_checksum(full_headers_ref));
+	fmt.begin_array("compids");
+	for (const auto& compid : header->get_compids())
+	{
+		using pe_bliss::rich::compid_database;
+		const auto product_info = compid_database::get_product(compid);
+		fmt.begin_object();
+		fmt.print_value("prod_id", compid.prod_id);
+		fmt.print_value("build_number", compid.build_number);
+		fmt.print_value("use_count", compid.use_count);
+		fmt.print_value("tool", compid_database::tool_type_to_string(
+			compid_database::get_tool(compid.prod_id)));
+		fmt.print_value("product", compid_database::product_type_to_string(
+			product_info.type));
+		fmt.print_value("exact_match", product_info.exact);
+		fmt.end_object();
+	}
+	fmt.end_array();
+	fmt.end_object();
+}
+
+void dump_file_signature(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	fmt.print_value("signature", image.get_image_signature().get_signature());
+}
+
+void dump_file_header(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	fmt.print_structure("file_header", image.get_file_header().get_descriptor(), std::array{
+		"machine", "number_of_sections", "time_date_stamp", "pointer_to_symbol_table",
+		"number_of_symbols", "size_of_optional_header", "characteristics"
+	});
+}
+
+void dump_optional_header(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	const auto& header = image.get_optional_header();
+	bool is_pe32 = header.get_magic() == pe_bliss::core::optional_header::magic::pe32;
+	std::visit([&fmt, is_pe32] (const auto& value) {
+		fmt.print_structure("optional_header", value, std::array{
+			"major_linker_version", "minor_linker_version", "size_of_code",
+			"size_of_initialized_data", "size_of_uninitialized_data",
+			"address_of_entry_point", "base_of_code",
+			is_pe32 ? "base_of_data" : nullptr,
+			"image_base", "section_alignment", "file_alignment",
+			"major_operating_system_version", "minor_operating_system_version",
+			"major_image_version", "minor_image_version",
+			"major_subsystem_version", "minor_subsystem_version",
+			"win32_version_value", "size_of_image", "size_of_headers", "checksum",
+			"subsystem", "dll_characteristics", "size_of_stack_reserve",
+			"size_of_stack_commit", "size_of_heap_reserve", "size_of_heap_commit",
+			"loader_flags", "number_of_rva_and_sizes"
+		});
+	}, header.get_descriptor());
+
+	fmt.begin_array("data_directories");
+	for (const auto& dir : image.get_data_directories().get_directories())
+		fmt.print_structure(nullptr, dir, std::array{ "virtual_address", "size" });
+	fmt.end_array();
+}
+
+void dump_section_table(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	fmt.begin_array("sections");
+	for (const auto& header : image.get_section_table().get_section_headers())
+	{
+		fmt.begin_object();
+		fmt.print_value("name", std::string(header.get_name()));
+		fmt.print_value("virtual_size", header.get_descriptor()->virtual_size);
+		fmt.print_value("virtual_address", header.get_descriptor()->virtual_address);
+		fmt.print_value("size_of_raw_data", header.get_descriptor()->size_of_raw_data);
+		fmt.print_value("pointer_to_raw_data", header.get_descriptor()->pointer_to_raw_data);
+		fmt.print_value("characteristics", header.get_descriptor()->characteristics);
+		fmt.end_object();
+	}
+	fmt.end_array();
+}
+
+void dump_exports(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto exports = pe_bliss::exports::load(image, {});
+	if (!exports)
+		return;
+
+	fmt.begin_object("exports");
+	fmt.print_errors(*exports);
+	fmt.print_value("library_name", exports->get_library_name());
+	fmt.print_value("base", exports->get_descriptor()->base);
+	fmt.begin_array("export_list");
+	for (const auto& address : exports->get_export_list())
+	{
+		fmt.begin_object();
+		fmt.print_errors(address);
+		fmt.print_value("rva", address.get_rva().get());
+		fmt.print_value("rva_ordinal", address.get_rva_ordinal());
+		if (address.get_forwarded_name())
+			fmt.print_value("forwarded_name", *address.get_forwarded_name());
+		fmt.begin_array("names");
+		for (const auto& name : address.get_names())
+		{
+			fmt.begin_object();
+			fmt.print_errors(name);
+			if (name.get_name())
+				fmt.print_value("name", *name.get_name());
+			fmt.print_value("name_ordinal", name.get_name_ordinal().get());
+			fmt.end_object();
+		}
+		fmt.end_array();
+		fmt.end_object();
+	}
+	fmt.end_array();
+	fmt.end_object();
+}
+
+template<typename Va>
+struct import_info_dumper
+{
+	void operator()(const pe_bliss::imports::imported_function_address<Va>&) const
+	{
+	}
+
+	void operator()(const pe_bliss::imports::imported_function_ordinal<Va>& ordinal) const
+	{
+		fmt.print_value("ordinal", ordinal.get_ordinal());
+	}
+
+	void operator()(const pe_bliss::imports::imported_function_hint_and_name<Va>& hint_name) const
+	{
+		fmt.print_value("hint", hint_name.get_hint().get());
+		fmt.print_value("name", hint_name.get_name());
+	}
+
+	json_formatter& fmt;
+};
+
+void dump_imports(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto imports = pe_bliss::imports::load(image, {});
+	if (!imports)
+		return;
+
+	fmt.begin_object("imports");
+	fmt.print_errors(*imports);
+	fmt.begin_array("libraries");
+	std::visit([&fmt] (const auto& libraries) {
+		for (const auto& library : libraries)
+		{
+			fmt.begin_object();
+			fmt.print_errors(library);
+			fmt.print_value("name", library.get_library_name());
+			fmt.print_value("is_bound", library.is_bound());
+			fmt.begin_array("imports");
+			for (const auto& imported : library.get_imports())
+			{
+				using va_type = typename std::remove_cvref_t<decltype(imported)>::va_type;
+				fmt.begin_object();
+				fmt.print_errors(imported);
+				fmt.print_value("address", imported.get_address().get());
+				std::visit(import_info_dumper<va_type>{ fmt }, imported.get_import_info());
+				fmt.end_object();
+			}
+			fmt.end_array();
+			fmt.end_object();
+		}
+	}, imports->get_list());
+	fmt.end_array();
+	fmt.end_object();
+}
+
+void dump_relocations(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto relocations = pe_bliss::relocations::load(image, {});
+	if (!relocations)
+		return;
+
+	fmt.begin_object("relocations");
+	fmt.print_errors(relocations->errors);
+	fmt.begin_array("tables");
+	for (const auto& table : relocations->relocations)
+	{
+		fmt.begin_object();
+		fmt.print_errors(table);
+		fmt.print_value("virtual_address", table.get_descriptor()->virtual_address);
+		fmt.begin_array("relocations");
+		for (const auto& reloc : table.get_relocations())
+		{
+			fmt.begin_object();
+			fmt.print_errors(reloc);
+			fmt.print_value("rva", reloc.get_address()
+				+ table.get_descriptor()->virtual_address);
+			fmt.print_value("type", static_cast<std::uint32_t>(reloc.get_type()));
+			fmt.end_object();
+		}
+		fmt.end_array();
+		fmt.end_object();
+	}
+	fmt.end_array();
+	fmt.end_object();
+}
+
+void dump_resource_directory(json_formatter& fmt,
+	const pe_bliss::resources::resource_directory_details& dir)
+{
+	fmt.print_errors(dir);
+	fmt.begin_array("entries");
+	for (const auto& entry : dir.get_entries())
+	{
+		fmt.begin_object();
+		fmt.print_errors(entry);
+		if (entry.has_id())
+			fmt.print_value("id", entry.get_id());
+		else if (entry.is_named())
+			fmt.print_value("name", entry.get_name());
+
+		if (entry.has_directory())
+		{
+			fmt.begin_object("directory");
+			dump_resource_directory(fmt, entry.get_directory());
+			fmt.end_object();
+		}
+		else if (entry.has_data())
+		{
+			const auto& data = entry.get_data();
+			fmt.begin_object("data");
+			fmt.print_errors(data);
+			fmt.print_value("offset_to_data", data.get_descriptor()->offset_to_data);
+			fmt.print_value("size", data.get_descriptor()->size);
+			fmt.print_value("code_page", data.get_descriptor()->code_page);
+			fmt.end_object();
+		}
+		fmt.end_object();
+	}
+	fmt.end_array();
+}
+
+void dump_resources(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto resources = pe_bliss::resources::load(image, {});
+	if (!resources)
+		return;
+
+	fmt.begin_object("resources");
+	dump_resource_directory(fmt, *resources);
+	fmt.end_object();
+}
+
+template<typename Library>
+void dump_bound_library(json_formatter& fmt, const Library& library)
+{
+	fmt.print_errors(library);
+	fmt.print_value("library_name", library.get_library_name());
+	fmt.print_value("time_date_stamp", library.get_descriptor()->time_date_stamp);
+}
+
+void dump_bound_imports(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto bound_imports = pe_bliss::bound_import::load(image, {});
+	if (!bound_imports)
+		return;
+
+	fmt.begin_array("bound_imports");
+	for (const auto& library : *bound_imports)
+	{
+		fmt.begin_object();
+		dump_bound_library(fmt, library);
+		fmt.begin_array("forwarder_refs");
+		for (const auto& ref : library.get_references())
+		{
+			fmt.begin_object();
+			dump_bound_library(fmt, ref);
+			fmt.end_object();
+		}
+		fmt.end_array();
+		fmt.end_object();
+	}
+	fmt.end_array();
+}
+
+void dump_tls(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto tls = pe_bliss::tls::load(image, {});
+	if (!tls)
+		return;
+
+	fmt.begin_object("tls");
+	std::visit([&fmt] (const auto& directory) {
+		fmt.print_errors(directory);
+		fmt.print_structure("descriptor", directory.get_descriptor(), std::array{
+			"start_address_of_raw_data", "end_address_of_raw_data", "address_of_index",
+			"address_of_callbacks", "size_of_zero_fill", "characteristics"
+		});
+		fmt.begin_array("callbacks");
+		for (const auto& cb : directory.get_callbacks())
+		{
+			fmt.begin_object();
+			fmt.print_errors(cb);
+			fmt.print_value("va", cb.get());
+			fmt.end_object();
+		}
+		fmt.end_array();
+		fmt.print_value("raw_data_size", directory.get_raw_data().size());
+	}, *tls);
+	fmt.end_object();
+}
+
+void dump_load_config(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto load_config = pe_bliss::load_config::load(image, {});
+	if (!load_config)
+		return;
+
+	fmt.begin_object("load_config");
+	std::visit([&fmt] (const auto& directory) {
+		fmt.print_errors(directory);
+		fmt.print_value("version", pe_bliss::load_config
+			::version_to_min_required_windows_version(directory.get_version()));
+		fmt.print_value("version_exactly_matches", directory.version_exactly_matches());
+		fmt.print_value("size", directory.get_size().get());
+		fmt.print_value("descriptor_size", directory.get_descriptor_size());
+		if (const auto& table = directory.get_safeseh_handler_table(); table)
+		{
+			fmt.begin_array("safeseh_handlers");
+			for (const auto& rva : table->get_handler_list())
+				fmt.print_value(nullptr, rva.get());
+			fmt.end_array();
+		}
+		if (const auto& table = directory.get_guard_cf_function_table(); table)
+		{
+			fmt.begin_array("guard_cf_functions");
+			for (const auto& func : *table)
+				fmt.print_value(nullptr, func.get_rva().get());
+			fmt.end_array();
+		}
+		if (const auto& targets = directory.get_eh_continuation_targets(); targets)
+		{
+			fmt.begin_array("eh_continuation_targets");
+			for (const auto& rva : *targets)
+				fmt.print_value(nullptr, rva.get());
+			fmt.end_array();
+		}
+	}, load_config->get_value());
+	fmt.end_object();
+}
+
+void dump_exceptions(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto exceptions = pe_bliss::exceptions::load(image, {});
+	if (exceptions.get_directories().empty())
+		return;
+
+	fmt.begin_object("exceptions");
+	fmt.print_errors(exceptions);
+	fmt.begin_array("directories");
+	for (const auto& directory : exceptions.get_directories())
+	{
+		std::visit([&fmt] (const auto& dir) {
+			fmt.begin_object();
+			fmt.print_errors(dir);
+			fmt.begin_array("runtime_functions");
+			for (const auto& func : dir.get_runtime_function_list())
+			{
+				fmt.begin_object();
+				fmt.print_errors(func);
+				fmt.print_value("begin_address", func.get_descriptor()->begin_address);
+				fmt.end_object();
+			}
+			fmt.end_array();
+			fmt.end_object();
+		}, directory);
+	}
+	fmt.end_array();
+	fmt.end_object();
+}
+
+void dump_debug(json_formatter& fmt, const pe_bliss::image::image& image)
+{
+	auto debug_entries = pe_bliss::debug::load(image, {});
+	if (!debug_entries)
+		return;
+
+	fmt.begin_object("debug");
+	fmt.print_errors(*debug_entries);
+	fmt.begin_array("entries");
+	for (const auto& dir : debug_entries->get_entries())
+	{
+		fmt.begin_object();
+		fmt.print_errors(dir);
+		fmt.print_structure("descriptor", dir.get_descriptor(), std::array{
+			"characteristics", "time_date_stamp", "major_version", "minor_version",
+			"type", "size_of_data", "address_of_raw_data", "pointer_to_raw_data"
+		});
+		fmt.end_object();
+	}
+	fmt.end_array();
+	fmt.end_object();
+}
+
+template<typename Func>
+void dump_stage_json(json_formatter& fmt, const pe_bliss::image::image& image,
+	const dumper_options& options, stage_timer& timer, dump_stage stage, Func&& func)
+{
+	if (!options.is_enabled(stage))
+		return;
+
+	const char* name = get_stage_name(stage);
+	timer.measure(name, [&fmt, &image, &func, name] {
+		auto depth = fmt.get_depth();
+		try
+		{
+			func(fmt, image);
+		}
+		catch (const std::exception& e)
+		{
+			fmt.close_to_depth(depth);
+			fmt.print_error((std::string(name) + "_error").c_str(), e);
+		}
+	});
+}
+
+} //namespace
+
+void dump_pe_json(json_formatter& fmt, const pe_bliss::image::image& image,
+	const dumper_options& options, stage_timer& timer)
+{
+	using enum dump_stage;
+	dump_stage_json(fmt, image, options, timer, dos_header, dump_dos_header);
+	dump_stage_json(fmt, image, options, timer, dos_stub, dump_dos_stub);
+	dump_stage_json(fmt, image, options, timer, rich_data, dump_rich_data);
+	dump_stage_json(fmt, image, options, timer, file_signature, dump_file_signature);
+	dump_stage_json(fmt, image, options, timer, file_header, dump_file_header);
+	dump_stage_json(fmt, image, options, timer, optional_header, dump_optional_header);
+	dump_stage_json(fmt, image, options, timer, section_table, dump_section_table);
+	dump_stage_json(fmt, image, options, timer, exports, dump_exports);
+	dump_stage_json(fmt, image, options, timer, imports, dump_imports);
+	dump_stage_json(fmt, image, options, timer, bound_imports, dump_bound_imports);
+	dump_stage_json(fmt, image, options, timer, tls, dump_tls);
+	dump_stage_json(fmt, image, options, timer, relocations, dump_relocations);
+	dump_stage_json(fmt, image, options, timer, load_config, dump_load_config);
+	dump_stage_json(fmt, image, options, timer, exceptions, dump_exceptions);
+	dump_stage_json(fmt, image, options, timer, resources, dump_resources);
+	dump_stage_json(fmt, image, options, timer, debug, dump_debug);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+class json_formatter;
+class stage_timer;
+struct dumper_options;
+namespace pe_bliss::image { class image; }
+
+void dump_pe_json(json_formatter& fmt, const pe_bliss::image::image& image,
+	const dumper_options& options, stage_timer& timer);
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <boost/pfr/core.hpp>
+
+#include "formatter.h"
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/packed_c_string.h"
+#include "pe_bliss2/packed_utf16_string.h"
+
+class json_formatter
+{
+public:
+	explicit json_formatter(std::ostream& stream) noexcept
+		: stream_(stream)
+	{
+	}
+
+	void begin_object(const char* key = nullptr)
+	{
+		begin_value(key);
+		stream_ << '{';
+		scopes_.push_back({ '}' });
+	}
+
+	void end_object()
+	{
+		end_scope();
+	}
+
+	void begin_array(const char* key = nullptr)
+	{
+		begin_value(key);
+		stream_ << '[';
+		scopes_.push_back({ ']' });
+	}
+
+	void end_array()
+	{
+		end_scope();
+	}
+
+	[[nodiscard]]
+	std::size_t get_depth() const noexcept
+	{
+		return scopes_.size();
+	}
+
+	//Closes all objects and arrays opened after the depth was obtained,
+	//keeps the output valid if dumping was interrupted by an exception
+	void close_to_depth(std::size_t depth)
+	{
+		while (scopes_.size() > depth)
+			end_scope();
+	}
+
+	template<typename T>
+		requires(std::is_arithmetic_v<T>)
+	void print_value(const char* key, T value)
+	{
+		begin_value(key);
+		if constexpr (std::is_same_v<T, bool>)
+			stream_ << (value ? "true" : "false");
+		else if constexpr (sizeof(T) == 1u)
+			stream_ << static_cast<std::int32_t>(value);
+		else
+			stream_ << value;
+	}
+
+	void print_value(const char* key, std::string_view value)
+	{
+		begin_value(key);
+		print_escaped(value);
+	}
+
+	void print_value(const char* key, const char* value)
+	{
+		print_value(key, std::string_view(value));
+	}
+
+	template<typename String>
+	void print_value(const char* key, const pe_bliss::packed_c_string_base<String>& value)
+	{
+		print_value(key, std::string_view(value.value()));
+	}
+
+	template<typename String>
+	void print_value(const char* key, const pe_bliss::packed_utf16_string_base<String>& value)
+	{
+		static constexpr char32_t replacement_character = 0xfffdu;
+
+		std::string result;
+		const auto& str = value.value();
+		for (std::size_t i = 0; i != str.size(); ++i)
+		{
+			char32_t ch = str[i];
+			if (ch >= 0xd800u && ch <= 0xdbffu && i + 1u != str.size()
+				&& str[i + 1u] >= 0xdc00u && str[i + 1u] <= 0xdfffu)
+			{
+				ch = 0x10000u + ((ch - 0xd800u) << 10u) + (str[++i] - 0xdc00u);
+			}
+			else if (ch >= 0xd800u && ch <= 0xdfffu)
+			{
+				//Unpaired surrogate
+				ch = replacement_character;
+			}
+			append_utf8(result, ch);
+		}
+		print_value(key, std::string_view(result));
+	}
+
+	void print_errors(const pe_bliss::error_list& errors, const char* key = "errors")
+	{
+		if (!errors.has_errors())
+			return;
+
+		begin_array(key);
+		for (const auto& error : *errors.get_errors())
+		{
+			print_value(nullptr, std::string(error.first.code.category().name())
+				+ ": " + error.first.code.message());
+		}
+		end_array();
+	}
+
+	void print_error(const char* key, const std::exception& e)
+	{
+		if (const auto* system_error = dynamic_cast<const std::system_error*>(&e); system_error)
+		{
+			print_value(key, std::string(system_error->code().category().name())
+				+ ": " + system_error->code().message());
+		}
+		else
+		{
+			print_value(key, e.what());
+		}
+	}
+
+	//Names with nullptr values are skipped, as in value_info lists
+	template<typename Struct, std::size_t N>
+	void print_structure(const char* key,
+		const Struct& obj, const std::array<const char*, N>& names)
+	{
+		begin_object(key);
+		std::size_t field_index = 0;
+		print_structure_impl(obj.get(), names, field_index);
+		end_object();
+	}
+
+	[[nodiscard]]
+	std::ostream& get_stream() noexcept
+	{
+		return stream_;
+	}
+
+private:
+	struct scope
+	{
+		char closing_bracket{};
+		bool has_values = false;
+	};
+
+	void end_scope()
+	{
+		stream_ << scopes_.back().closing_bracket;
+		scopes_.pop_back();
+	}
+
+	void begin_value(const char* key)
+	{
+		if (!scopes_.empty())
+		{
+			if (scopes_.back().has_values)
+				stream_ << ',';
+			scopes_.back().has_values = true;
+		}
+
+		if (key)
+		{
+			print_escaped(key);
+			stream_ << ':';
+		}
+	}
+
+	//Returns the length of the valid UTF-8 sequence at the beginning
+	//of the value, or zero if the sequence is invalid
+	[[nodiscard]]
+	static std::size_t get_utf8_sequence_length(std::string_view value) noexcept
+	{
+		const auto lead = static_cast<unsigned char>(value[0]);
+		std::size_t length{};
+		unsigned char min_second = 0x80u, max_second = 0xbfu;
+		if (lead >= 0xc2u && lead <= 0xdfu)
+			length = 2u;
+		else if (lead >= 0xe0u && lead <= 0xefu)
+		{
+			length = 3u;
+			if (lead == 0xe0u)
+				min_second = 0xa0u; //Overlong encoding
+			else if (lead == 0xedu)
+				max_second = 0x9fu; //Surrogates
+		}
+		else if (lead >= 0xf0u && lead <= 0xf4u)
+		{
+			length = 4u;
+			if (lead == 0xf0u)
+				min_second = 0x90u; //Overlong encoding
+			else if (lead == 0xf4u)
+				max_second = 0x8fu; //Above U+10FFFF
+		}
+		else
+			return 0u;
+
+		if (value.size() < length)
+			return 0u;
+
+		for (std::size_t i = 1; i != length; ++i)
+		{
+			const auto code = static_cast<unsigned char>(value[i]);
+			if (code < (i == 1u ? min_second : 0x80u) || code > (i == 1u ? max_second : 0xbfu))
+				return 0u;
+		}
+		return length;
+	}
+
+	//Strings from the image are not necessarily valid UTF-8:
+	//bytes which are not a part of a valid UTF-8 sequence are escaped
+	void print_escaped(std::string_view value)
+	{
+		constexpr const char* digits = "0123456789abcdef";
+		stream_ << '"';
+		while (!value.empty())
+		{
+			const char ch = value[0];
+			const auto code = static_cast<unsigned char>(ch);
+			std::size_t length = 1u;
+			if (ch == '"' || ch == '\\')
+				stream_ << '\\' << ch;
+			else if (code < 0x20u)
+				stream_ << "\\u00" << digits[code >> 4u] << digits[code & 0xfu];
+			else if (code < 0x80u)
+				stream_ << ch;
+			else if (length = get_utf8_sequence_length(value); length)
+				stream_ << value.substr(0, length);
+			else
+			{
+				length = 1u;
+				stream_ << "\\u00" << digits[code >> 4u] << digits[code & 0xfu];
+			}
+			value.remove_prefix(length);
+		}
+		stream_ << '"';
+	}
+
+	//Code point must not be a surrogate
+	static void append_utf8(std::string& result, char32_t ch)
+	{
+		if (ch < 0x80u)
+		{
+			result.push_back(static_cast<char>(ch));
+			return;
+		}
+
+		if (ch < 0x800u)
+		{
+			result.push_back(static_cast<char>(0xc0u | (ch >> 6u)));
+		}
+		else if (ch < 0x10000u)
+		{
+			result.push_back(static_cast<char>(0xe0u | (ch >> 12u)));
+			result.push_back(static_cast<char>(0x80u | ((ch >> 6u) & 0x3fu)));
+		}
+		else
+		{
+			result.push_back(static_cast<char>(0xf0u | (ch >> 18u)));
+			result.push_back(static_cast<char>(0x80u | ((ch >> 12u) & 0x3fu)));
+			result.push_back(static_cast<char>(0x80u | ((ch >> 6u) & 0x3fu)));
+		}
+		result.push_back(static_cast<char>(0x80u | (ch & 0x3fu)));
+	}
+
+	template<typename T>
+	void print_field_value(const char* key, const T& value)
+	{
+		if constexpr (std::is_arithmetic_v<T>)
+		{
+			print_value(key, value);
+		}
+		else
+		{
+			begin_array(key);
+			for (const auto& elem : value)
+				print_field_value(nullptr, elem);
+			end_array();
+		}
+	}
+
+	template<typename Struct, std::size_t N>
+	void print_structure_impl(const Struct& obj,
+		const std::array<const char*, N>& names, std::size_t& field_index)
+	{
+		boost::pfr::for_each_field(obj, [this, &names, &field_index] (const auto& value) {
+			using type = std::remove_cvref_t<decltype(value)>;
+			if constexpr (std::is_class_v<type> && !impl::is_array<type>::value)
+			{
+				print_structure_impl(value, names, field_index);
+			}
+			else
+			{
+				while (!names.at(field_index))
+					++field_index;
+
+				print_field_value(names.at(field_index), value);
+				++field_index;
+			}
+		});
+	}
+
+private:
+	std::ostream& stream_;
+	std::vector<scope> scopes_;
+};
@@ -1,11 +1,22 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <exception>
+#include <future>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "color_provider.h"
 #include "bound_imports_dumper.h"
 #include "debug_dumper.h"
 #include "dos_header_dumper.h"
 #include "dos_stub_dumper.h"
+#include "dumper_options.h"
 #include "exceptions_dumper.h"
 #include "exports_dumper.h"
 #include "file_header_dumper.h"
@@ -13,62 +24,129 @@
 #include "formatter.h"
 #include "image_factory.h"
 #include "imports_dumper.h"
+#include "json_dumper.h"
+#include "json_formatter.h"
 #include "load_config_dumper.h"
 #include "optional_header_dumper.h"
 #include "relocations_dumper.h"
 #include "resources_dumper.h"
 #include "rich_data_dumper.h"
 #include "section_table_dumper.h"
+#include "stage_timer.h"
 #include "tls_dumper.h"
 
 #include "pe_bliss2/error_list.h"
 #include "pe_bliss2/image/image.h"
 
-//TODO: configuration flags, output options
-void dump_pe(const pe_bliss::image::image& image)
+namespace
 {
-	//escape_sequence_color_provider color_provider;
-	empty_color_provider color_provider;
-	formatter fmt(color_provider, std::cout, std::cerr);
-	dump_dos_header(fmt, image.get_dos_header());
-	dump_dos_stub(fmt, image.get_dos_stub());
-	dump_rich_data(fmt, image);
-	dump_file_signature(fmt, image.get_image_signature());
-	dump_file_header(fmt, image.get_file_header());
-	dump_optional_header(fmt, image.get_optional_header());
-	dump_section_table(fmt, image.get_section_table());
-	dump_exports(fmt, image);
-	dump_imports(fmt, image);
-	dump_bound_imports(fmt, image);
-	dump_tls(fmt, image);
-	dump_relocations(fmt, image);
-	dump_load_config(fmt, image);
-	dump_exceptions(fmt, image);
-	dump_resources(fmt, image);
-	dump_debug(fmt, image);
+
+struct file_dump_result
+{
+	std::string output;
+	std::string errors;
+	bool loaded = false;
+};
+
+template<typename Func>
+void dump_if_enabled(const dumper_options& options, stage_timer& timer,
+	dump_stage stage, Func&& func)
+{
+	if (options.is_enabled(stage))
+		timer.measure(get_stage_name(stage), std::forward<Func>(func));
 }
 
-int main(int argc, char* argv[]) try
+void dump_pe(formatter& fmt, const pe_bliss::image::image& image,
+	const dumper_options& options, stage_timer& timer)
 {
-	if (argc < 2)
+	using enum dump_stage;
+	dump_if_enabled(options, timer, dos_header,
+		[&] { dump_dos_header(fmt, image.get_dos_header()); });
+	dump_if_enabled(options, timer, dos_stub,
+		[&] { dump_dos_stub(fmt, image.get_dos_stub()); });
+	dump_if_enabled(options, timer, rich_data,
+		[&] { dump_rich_data(fmt, image); });
+	dump_if_enabled(options, timer, file_signature,
+		[&] { dump_file_signature(fmt, image.get_image_signature()); });
+	dump_if_enabled(options, timer, file_header,
+		[&] { dump_file_header(fmt, image.get_file_header()); });
+	dump_if_enabled(options, timer, optional_header,
+		[&] { dump_optional_header(fmt, image.get_optional_header()); });
+	dump_if_enabled(options, timer, section_table,
+		[&] { dump_section_table(fmt, image.get_section_table()); });
+	dump_if_enabled(options, timer, exports, [&] { dump_exports(fmt, image); });
+	dump_if_enabled(options, timer, imports, [&] { dump_imports(fmt, image); });
+	dump_if_enabled(options, timer, bound_imports, [&] { dump_bound_imports(fmt, image); });
+	dump_if_enabled(options, timer, tls, [&] { dump_tls(fmt, image); });
+	dump_if_enabled(options, timer, relocations, [&] { dump_relocations(fmt, image); });
+	dump_if_enabled(options, timer, load_config, [&] { dump_load_config(fmt, image); });
+	dump_if_enabled(options, timer, exceptions, [&] { dump_exceptions(fmt, image); });
+	dump_if_enabled(options, timer, resources, [&] { dump_resources(fmt, image); });
+	dump_if_enabled(options, timer, debug, [&] { dump_debug(fmt, image); });
+}
+
+std::chrono::microseconds::rep to_microseconds(std::chrono::steady_clock::duration duration)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void print_timings(formatter& fmt, const stage_timer& timer)
+{
+	fmt.get_stream() << "===== ";
+	fmt.print_structure_name("Timings");
+	fmt.get_stream() << " =====\n\n";
+
+	for (const auto& timing : timer.get_timings())
 	{
-		std::cout << "Usage: console_dumper.exe [pe_file]\n";
-		return -1;
+		fmt.print_field_name(timing.name);
+		fmt.get_stream() << ' ';
+		fmt.print_value(to_microseconds(timing.duration), false);
+		fmt.get_stream() << " us\n";
 	}
-	const char* filename = argv[1];
+	fmt.get_stream() << '\n';
+}
 
-	auto result = load_image(filename, {});
-	if (result.warnings.has_errors())
+void print_timings(json_formatter& fmt, const stage_timer& timer)
+{
+	fmt.begin_object("timings_us");
+	for (const auto& timing : timer.get_timings())
+		fmt.print_value(timing.name, to_microseconds(timing.duration));
+	fmt.end_object();
+}
+
+pe_bliss::image::image_load_options get_load_options(const dumper_options& options)
+{
+	pe_bliss::image::image_load_options result;
+	if (options.headers_only)
 	{
-		empty_color_provider color_provider;
-		formatter fmt(color_provider, std::cout, std::cerr);
-		fmt.print_errors(result.warnings);
+		result.load_section_data = false;
+		result.load_overlay = false;
+		result.load_full_sections_buffer = false;
 	}
+	return result;
+}
+
+void dump_text(const std::string& filename, const dumper_options& options,
+	const pe_bliss::image::image_load_result& result, stage_timer& timer,
+	std::ostream& output, std::ostream& errors)
+{
+	//escape_sequence_color_provider color_provider;
+	empty_color_provider color_provider;
+	formatter fmt(color_provider, output, errors);
+	if (options.files.size() > 1u)
+	{
+		output << "===== ";
+		fmt.print_structure_name("File");
+		output << ' ';
+		fmt.print_string(filename);
+		output << " =====\n\n";
+	}
+
+	if (result.warnings.has_errors())
+		fmt.print_errors(result.warnings);
 
 	if (!result)
 	{
-		empty_color_provider color_provider;
-		formatter fmt(color_provider, std::cout, std::cerr);
 		try
 		{
 			std::rethrow_exception(result.fatal_error);
@@ -81,11 +159,147 @@ int main(int argc, char* argv[]) try
 		{
 			fmt.print_error("Error loading PE: ", e);
 		}
+	}
+	else
+	{
+		dump_pe(fmt, result.image, options, timer);
+	}
+
+	if (options.print_timings)
+		print_timings(fmt, timer);
+}
 
-		return -2;
+void dump_json(const std::string& filename, const dumper_options& options,
+	const pe_bliss::image::image_load_result& result, stage_timer& timer,
+	std::ostream& output)
+{
+	json_formatter fmt(output);
+	fmt.begin_object();
+	fmt.print_value("file", filename);
+	fmt.print_value("loaded", static_cast<bool>(result));
+	fmt.print_errors(result.warnings, "warnings");
+	if (!result)
+	{
+		try
+		{
+			std::rethrow_exception(result.fatal_error);
+		}
+		catch (const std::exception& e)
+		{
+			fmt.print_error("error", e);
+		}
+	}
+	else
+	{
+		dump_pe_json(fmt, result.image, options, timer);
+	}
+
+	if (options.print_timings)
+		print_timings(fmt, timer);
+	fmt.end_object();
+}
+
+file_dump_result dump_file(const std::string& filename, const dumper_options& options)
+{
+	stage_timer timer;
+	auto result = timer.measure("load", [&filename, &options] {
+		try
+		{
+			return load_image(filename.c_str(), get_load_options(options));
+		}
+		catch (...)
+		{
+			pe_bliss::image::image_load_result result;
+			result.fatal_error = std::current_exception();
+			return result;
+		}
+	});
+
+	std::ostringstream output, errors;
+	if (options.format == output_format::text)
+		dump_text(filename, options, result, timer, output, errors);
+	else
+		dump_json(filename, options, result, timer, output);
+
+	return { output.str(), errors.str(), static_cast<bool>(result) };
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) try
+{
+	dumper_options options;
+	try
+	{
+		options = parse_dumper_options(argc, argv);
+	}
+	catch (const std::invalid_argument& e)
+	{
+		std::cerr << e.what() << '\n';
+		print_usage(std::cout);
+		return -1;
+	}
+
+	const auto& files = options.files;
+	std::vector<std::promise<file_dump_result>> results(files.size());
+	std::vector<std::future<file_dump_result>> result_futures;
+	result_futures.reserve(results.size());
+	for (auto& result : results)
+		result_futures.emplace_back(result.get_future());
+
+	std::atomic<std::size_t> next_file_index{};
+	std::vector<std::jthread> workers;
+	workers.reserve(options.jobs);
+	for (std::size_t i = 0; i != options.jobs; ++i)
+	{
+		workers.emplace_back([&files, &options, &results, &next_file_index] {
+			for (auto index = next_file_index++; index < files.size();
+				index = next_file_index++)
+			{
+				try
+				{
+					results[index].set_value(dump_file(files[index], options));
+				}
+				catch (...)
+				{
+					results[index].set_exception(std::current_exception());
+				}
+			}
+		});
+	}
+
+	//Results are printed in the order of files on the command line,
+	//each one as soon as it is ready
+	int exit_code = 0;
+	bool has_output = false;
+	if (options.format == output_format::json)
+		std::cout << '[';
+	for (std::size_t i = 0; i != result_futures.size(); ++i)
+	{
+		try
+		{
+			auto result = result_futures[i].get();
+			if (options.format == output_format::json && has_output)
+				std::cout << ',';
+			has_output = true;
+			std::cout << result.output;
+			if (options.format != output_format::text)
+				std::cout << '\n';
+			std::cout.flush();
+			std::cerr << result.errors;
+			if (!result.loaded)
+				exit_code = -2;
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << files[i] << ": error: " << e.what() << '\n';
+			exit_code = -3;
+		}
 	}
+	if (options.format == output_format::json)
+		std::cout << "]\n";
 
-	dump_pe(result.image);
+	return exit_code;
 }
 catch (const std::system_error& e)
 {
@@ -34,7 +34,7 @@ public:
 		fmt_.print_value(id, true);
 	}
 
-	void operator()(const pe_bliss::packed_utf16_string& name) const
+	void operator()(const pe_bliss::resources::resource_name_type& name) const
 	{
 		fmt_.print_field_name("Name");
 		fmt_.get_stream() << ' ';
@@ -104,7 +104,7 @@ void dump_name_or_id(formatter& fmt,
 }
 
 void dump_entries(std::size_t level, formatter& fmt,
-	const std::vector<pe_bliss::resources::resource_directory_entry_details>& entries)
+	const pe_bliss::resources::resource_directory_details::entry_list_type& entries)
 {
 	fmt.get_stream() << std::string(level, '>') << "===== ";
 	fmt.print_structure_name("Resource directory entries");
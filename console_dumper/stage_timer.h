@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+struct stage_timing
+{
+	const char* name = nullptr;
+	std::chrono::steady_clock::duration duration{};
+};
+
+class stage_timer
+{
+public:
+	template<typename Func>
+	decltype(auto) measure(const char* name, Func&& func)
+	{
+		struct guard
+		{
+			~guard() noexcept
+			{
+				try
+				{
+					timings.push_back({ name, std::chrono::steady_clock::now() - start });
+				}
+				catch (...)
+				{
+					//Timings are diagnostic only, the stage result is more important
+				}
+			}
+
+			std::vector<stage_timing>& timings;
+			const char* name;
+			std::chrono::steady_clock::time_point start;
+		} measure_guard{ timings_, name, std::chrono::steady_clock::now() };
+
+		return std::forward<Func>(func)();
+	}
+
+	[[nodiscard]]
+	const std::vector<stage_timing>& get_timings() const noexcept
+	{
+		return timings_;
+	}
+
+private:
+	std::vector<stage_timing> timings_;
+};
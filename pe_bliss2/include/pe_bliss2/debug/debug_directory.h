@@ -17,6 +17,7 @@
 #include "pe_bliss2/packed_byte_vector.h"
 #include "pe_bliss2/packed_struct.h"
 #include "pe_bliss2/packed_c_string.h"
+#include "utilities/list_allocator.h"
 
 namespace buffers
 {
@@ -895,7 +896,8 @@ template<typename... Bases>
 class [[nodiscard]] debug_directory_list_base : public Bases...
 {
 public:
-	using list_type = std::vector<debug_directory_base<Bases...>>;
+	using list_type = std::vector<debug_directory_base<Bases...>,
+		utilities::list_allocator<debug_directory_base<Bases...>>>;
 
 public:
 	[[nodiscard]]
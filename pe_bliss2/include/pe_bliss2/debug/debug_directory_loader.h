@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <system_error>
 #include <type_traits>
@@ -38,6 +39,10 @@ struct [[nodiscard]] loader_options
 	bool copy_raw_data = false;
 	std::uint32_t max_debug_directories = 0xffu;
 	std::uint32_t max_raw_data_size = 10'000'000;
+	//If set, the list of loaded entries and the error lists
+	//are allocated from this resource, which must outlive the list.
+	//Used only if the library is built with PE_BLISS_ENABLE_PMR_LISTS
+	std::pmr::memory_resource* memory_resource = nullptr;
 };
 
 [[nodiscard]]
@@ -105,6 +105,17 @@ public:
 			"Specified field was not found in provided structure");
 		return result;
 	}
+
+	//True if the in-memory representation of T has no padding bytes,
+	//i.e. it is byte-identical to the packed representation
+	//(assuming native endianness)
+	template<standard_layout T>
+	[[nodiscard]] static consteval bool is_padding_free() noexcept
+	{
+		using type = std::remove_cvref_t<T>;
+		return std::is_trivially_copyable_v<type>
+			&& sizeof(type) == get_type_size<type>();
+	}
 };
 
 } //namespace pe_bliss::detail
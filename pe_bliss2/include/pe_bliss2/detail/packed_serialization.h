@@ -22,12 +22,23 @@ template<boost::endian::order StructureFieldsEndianness
 	= boost::endian::order::native>
 class packed_serialization : utilities::static_class
 {
+private:
+	template<typename T>
+	static constexpr bool is_bulk_copyable
+		= StructureFieldsEndianness == boost::endian::order::native
+		&& packed_reflection::is_padding_free<T>();
+
 public:
 	template<standard_layout T, byte_pointer BytePointer>
 	static BytePointer deserialize(T& result, BytePointer data) noexcept
 	{
 		using type = std::remove_cvref_t<T>;
-		if constexpr (impl::is_array<type>::value)
+		if constexpr (std::is_class_v<type> && is_bulk_copyable<type>)
+		{
+			std::memcpy(&result, data, sizeof(type));
+			data += sizeof(type);
+		}
+		else if constexpr (impl::is_array<type>::value)
 		{
 			if constexpr (std::is_class_v<typename type::value_type>
 				|| StructureFieldsEndianness != boost::endian::order::native)
@@ -85,7 +96,12 @@ public:
 	static std::byte* serialize(const T& value, std::byte* data) noexcept
 	{
 		using type = std::remove_cvref_t<T>;
-		if constexpr (impl::is_array<type>::value)
+		if constexpr (std::is_class_v<type> && is_bulk_copyable<type>)
+		{
+			std::memcpy(data, &value, sizeof(type));
+			data += sizeof(type);
+		}
+		else if constexpr (impl::is_array<type>::value)
 		{
 			if constexpr (std::is_class_v<typename type::value_type>
 				|| StructureFieldsEndianness != boost::endian::order::native)
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <boost/endian/conversion.hpp>
+
+#include "buffers/input_buffer_interface.h"
+#include "buffers/input_buffer_state.h"
+#include "buffers/input_buffer_stateful_wrapper.h"
+#include "pe_bliss2/detail/packed_serialization.h"
+#include "pe_bliss2/packed_c_string.h"
+#include "pe_bliss2/packed_struct.h"
+#include "utilities/list_allocator.h"
+
+namespace buffers
+{
+class output_buffer_interface;
+class ref_buffer;
+} //namespace buffers
+
+namespace pe_bliss
+{
+template<typename String>
+class packed_utf16_string_base;
+using packed_utf16_string = packed_utf16_string_base<std::u16string>;
+using packed_list_utf16_string = packed_utf16_string_base<utilities::list_u16string>;
+} //namespace pe_bliss
+
+namespace pe_bliss::detail::snapshot
+{
+
+class [[nodiscard]] snapshot_writer
+{
+public:
+	explicit snapshot_writer(buffers::output_buffer_interface& buf) noexcept
+		: buf_(buf)
+	{
+	}
+
+	template<std::integral T>
+	void write(T value)
+	{
+		std::array<std::byte, sizeof(T)> data{};
+		packed_serialization<boost::endian::order::little>::serialize(value, data.data());
+		write_bytes(data.data(), data.size());
+	}
+
+	void write(bool value)
+	{
+		write<std::uint8_t>(value ? 1u : 0u);
+	}
+
+	void write_bytes(const std::byte* data, std::size_t size);
+	void write_string(std::string_view value);
+	void write_string(std::u16string_view value);
+	void write_state(const buffers::input_buffer_state& state);
+	void write_buffer(const buffers::ref_buffer& buffer);
+	void write_c_string(const packed_c_string& str);
+	void write_utf16_string(const packed_utf16_string& str);
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+	void write_c_string(const packed_list_c_string& str);
+	void write_utf16_string(const packed_list_utf16_string& str);
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
+	template<typename T, boost::endian::order Endianness>
+	void write_packed(const packed_struct<T, Endianness>& value)
+	{
+		auto data = value.serialize();
+		write_bytes(data.data(), data.size());
+		write<std::uint64_t>(value.physical_size());
+		write_state(value.get_state());
+	}
+
+	template<typename T, boost::endian::order Endianness>
+	void write_packed(const std::optional<packed_struct<T, Endianness>>& value)
+	{
+		write(value.has_value());
+		if (value)
+			write_packed(*value);
+	}
+
+	void write_c_string(const std::optional<packed_c_string>& str);
+
+private:
+	buffers::output_buffer_interface& buf_;
+};
+
+class [[nodiscard]] snapshot_reader
+{
+public:
+	explicit snapshot_reader(const buffers::input_buffer_ptr& buf) noexcept
+		: buf_(buf)
+		, wrapper_(*buf)
+	{
+	}
+
+	template<std::integral T>
+	[[nodiscard]]
+	T read()
+	{
+		std::array<std::byte, sizeof(T)> data;
+		read_bytes(data.data(), data.size());
+		T result{};
+		packed_serialization<boost::endian::order::little>::deserialize(result, data.data());
+		return result;
+	}
+
+	[[nodiscard]]
+	bool read_bool()
+	{
+		return read<std::uint8_t>() != 0u;
+	}
+
+	[[nodiscard]]
+	std::size_t read_size();
+
+	void read_bytes(std::byte* data, std::size_t size);
+	[[nodiscard]]
+	std::string read_string();
+	[[nodiscard]]
+	std::u16string read_utf16_string();
+	void read_state(buffers::input_buffer_state& state);
+	void read_buffer(buffers::ref_buffer& buffer);
+	void read_c_string(packed_c_string& str);
+	void read_c_string(std::optional<packed_c_string>& str);
+	void read_utf16_string(packed_utf16_string& str);
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+	void read_c_string(packed_list_c_string& str);
+	void read_utf16_string(packed_list_utf16_string& str);
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
+	template<typename T, boost::endian::order Endianness>
+	void read_packed(packed_struct<T, Endianness>& value)
+	{
+		using packed_type = packed_struct<T, Endianness>;
+		std::array<std::byte, packed_type::packed_size> data;
+		read_bytes(data.data(), data.size());
+		packed_serialization<Endianness>::deserialize(value.get(), data.data());
+		value.set_physical_size(read_size());
+		read_state(value.get_state());
+	}
+
+	template<typename T, boost::endian::order Endianness>
+	void read_packed(std::optional<packed_struct<T, Endianness>>& value)
+	{
+		if (read_bool())
+			read_packed(value.emplace());
+		else
+			value.reset();
+	}
+
+	[[nodiscard]]
+	std::size_t rpos() const noexcept
+	{
+		return wrapper_.rpos();
+	}
+
+	[[nodiscard]]
+	std::size_t size()
+	{
+		return wrapper_.size();
+	}
+
+private:
+	buffers::input_buffer_ptr buf_;
+	buffers::input_buffer_stateful_wrapper_ref wrapper_;
+};
+
+} //namespace pe_bliss::detail::snapshot
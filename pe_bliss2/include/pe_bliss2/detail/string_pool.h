@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "utilities/safe_uint.h"
+
+namespace pe_bliss::detail
+{
+
+//Assigns offsets to strings written one after another.
+//Each unique string is stored once if deduplication is enabled.
+template<typename Key, typename Hash = std::hash<Key>>
+class [[nodiscard]] string_pool
+{
+public:
+	explicit string_pool(bool deduplicate) noexcept
+		: deduplicate_(deduplicate)
+	{
+	}
+
+	std::uint32_t add(const Key& key, std::size_t size)
+	{
+		if (deduplicate_)
+		{
+			auto [it, inserted] = offsets_.try_emplace(key, size_.value());
+			if (!inserted)
+				return it->second;
+		}
+
+		auto offset = size_.value();
+		keys_.push_back(key);
+		size_ += size;
+		return offset;
+	}
+
+	[[nodiscard]]
+	const std::vector<Key>& get_keys() const noexcept
+	{
+		return keys_;
+	}
+
+	[[nodiscard]]
+	std::uint32_t size() const noexcept
+	{
+		return size_.value();
+	}
+
+private:
+	bool deduplicate_;
+	std::unordered_map<Key, std::uint32_t, Hash> offsets_;
+	std::vector<Key> keys_;
+	utilities::safe_uint<std::uint32_t> size_;
+};
+
+} //namespace pe_bliss::detail
@@ -44,6 +44,18 @@ public:
 	//When deserializing, buf should point to DOS stub start (right after DOS header)
 	void deserialize(buffers::input_buffer_stateful_wrapper& buffer,
 		const dos_stub_load_options& options);
+
+	[[nodiscard]]
+	buffers::ref_buffer& get_buffer() noexcept
+	{
+		return static_cast<buffers::ref_buffer&>(*this);
+	}
+
+	[[nodiscard]]
+	const buffers::ref_buffer& get_buffer() const noexcept
+	{
+		return static_cast<const buffers::ref_buffer&>(*this);
+	}
 };
 
 } //namespace pe_bliss::dos
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <compare>
 #include <cstddef>
 #include <exception>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -12,6 +14,9 @@
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
+
+#include "utilities/list_allocator.h"
 
 namespace pe_bliss
 {
@@ -24,6 +29,10 @@ concept is_convertible_to_error_code = requires(ErrorCode ec) {
 };
 } //namespace detail
 
+//Errors are stored in a flat vector, which is allocated on the first error only.
+//Error lists usually contain few errors, so short lists are searched linearly.
+//Longer lists get a hash index, so deduplication does not become quadratic.
+//The error map returned by get_errors() is built on demand from the vector.
 class [[nodiscard]] error_list
 {
 public:
@@ -82,26 +91,39 @@ public:
 	using error_map_type = std::unordered_map<error_context, error_info, 
 		error_context_hash>;
 
+public:
+	error_list() noexcept = default;
+	error_list(const error_list& other);
+	error_list(error_list&& other) noexcept;
+	error_list& operator=(const error_list& other);
+	error_list& operator=(error_list&& other) noexcept;
+	~error_list();
+
 public:
 	void add_error(std::error_code error);
 	void add_error(std::error_code error, std::string context);
 	void add_error(std::error_code error, std::size_t context);
 
+	//Returns nullptr if there are no errors. The map is built on the first call
+	//and is valid until the error list is changed.
 	[[nodiscard]]
-	const error_map_type* get_errors() const noexcept
-	{
-		return errors_.get();
-	}
+	const error_map_type* get_errors() const;
 
 	[[nodiscard]]
 	bool has_errors() const noexcept
 	{
-		return errors_ && !errors_->empty();
+		return !errors_.empty();
 	}
 
-	void clear_errors()
+	void clear_errors() noexcept;
+
+	//Makes the empty error list allocate errors from the resource.
+	//Does nothing if the resource is nullptr or the library is built
+	//without PE_BLISS_ENABLE_PMR_LISTS (see utilities::list_allocator).
+	//String contexts are always allocated using the default allocator.
+	void use_error_memory_resource(std::pmr::memory_resource* resource) noexcept
 	{
-		errors_.reset();
+		utilities::use_memory_resource(errors_, resource);
 	}
 
 	[[nodiscard]]
@@ -141,10 +163,25 @@ public:
 	}
 
 private:
-	void create_error_map();
+	using error_vector_type = std::vector<std::pair<error_context, error_info>,
+		utilities::list_allocator<std::pair<error_context, error_info>>>;
+	//Maps error context hashes to the indexes of errors_ elements
+	using index_type = std::unordered_multimap<std::size_t, std::size_t,
+		std::hash<std::size_t>, std::equal_to<std::size_t>,
+		utilities::list_allocator<std::pair<const std::size_t, std::size_t>>>;
+
+	template<typename Context>
+	[[nodiscard]]
+	const error_vector_type::value_type* find(std::error_code error,
+		const Context& context) const noexcept;
+
+	void add_error_impl(error_context&& context);
+	void reset_error_map() noexcept;
 
 private:
-	std::unique_ptr<error_map_type> errors_;
+	error_vector_type errors_;
+	std::unique_ptr<index_type> index_;
+	mutable std::atomic<error_map_type*> error_map_{};
 };
 
 } //namespace pe_bliss
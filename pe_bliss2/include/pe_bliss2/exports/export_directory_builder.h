@@ -23,12 +23,19 @@ struct builder_options
 	rva_type directory_rva = 0;
 	bool write_virtual_part = false;
 	bool update_data_directory = true;
+	//Write identical names and forwarded names once
+	bool deduplicate_names = true;
 };
 
 void build_in_place(image::image& instance, const export_directory_details& directory,
 	const builder_options& options);
 void build_in_place(image::image& instance, const export_directory& directory,
 	const builder_options& options);
+//The layout is planned before writing, then the directory is written
+//sequentially: descriptor, library name, functions table, forwarded names,
+//name ordinals table, name RVAs table, names.
+//Exported symbols are sorted by ordinal. Descriptor, symbol RVAs,
+//name RVAs and name ordinals are updated.
 std::uint32_t build_new(image::image& instance, export_directory& directory,
 	const builder_options& options);
 std::uint32_t build_new(image::image& instance, export_directory_details& directory,
@@ -39,8 +46,10 @@ std::uint32_t build_new(buffers::output_buffer_interface& buf, export_directory_
 	const builder_options& options);
 
 [[nodiscard]]
-std::uint32_t get_built_size(const export_directory& table);
+std::uint32_t get_built_size(const export_directory& table,
+	const builder_options& options = {});
 [[nodiscard]]
-std::uint32_t get_built_size(const export_directory_details& table);
+std::uint32_t get_built_size(const export_directory_details& table,
+	const builder_options& options = {});
 
 } //namespace pe_bliss::exports
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <system_error>
 #include <type_traits>
 
@@ -32,8 +33,16 @@ struct [[nodiscard]] image_builder_options
 class image_builder : public utilities::static_class
 {
 public:
+	//Gaps between headers and sections are filled with zeros, so a buffer
+	//can be reused across builds without clearing it.
 	static void build(const image& instance, buffers::output_buffer_interface& buffer,
 		const image_builder_options& options = {});
+
+	//Returns the number of bytes build() writes for the image, which can be used
+	//to reserve memory or to size a file mapping before building.
+	[[nodiscard]]
+	static std::size_t get_built_size(const image& instance,
+		const image_builder_options& options = {});
 };
 
 } //namespace pe_bliss::image
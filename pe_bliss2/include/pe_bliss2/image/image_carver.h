@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "buffers/input_buffer_interface.h"
+#include "pe_bliss2/image/format_detector.h"
+#include "utilities/static_class.h"
+
+namespace pe_bliss::image
+{
+
+struct [[nodiscard]] carved_image
+{
+	//Offset of the image DOS header in the scanned buffer
+	std::size_t offset{};
+	//Estimated image size, limited by the end of the scanned buffer.
+	//For file layout images, this is the end of the headers or of the last
+	//section raw data, whichever is larger. For images loaded to memory,
+	//this is the size of image from the optional header.
+	std::size_t size{};
+	detected_format format{};
+};
+
+struct [[nodiscard]] carver_options
+{
+	//Number of bytes searched for DOS header signatures at once
+	std::size_t chunk_size = 0x100000u;
+	//Candidates with larger e_lfanew values are skipped
+	std::uint32_t max_e_lfanew = 0x1000u;
+	//Continue the search after the end of each found image
+	//instead of searching inside found images
+	bool skip_found_images = false;
+	//Images use the in-memory layout (for example, in memory dumps),
+	//same as image_load_options::image_loaded_to_memory
+	bool image_loaded_to_memory = false;
+};
+
+//Finds PE images embedded into arbitrary data (memory dumps, firmware, archives).
+//The buffer is searched chunk by chunk, so its size may exceed the available memory.
+//Each candidate image is validated by its DOS header, e_lfanew, PE signature
+//and optional header magic, and its extent is estimated from the section table.
+//Found images can be loaded using buffers::reduce(buffer, offset, size).
+class image_carver final : public utilities::static_class
+{
+public:
+	//Return false from the callback to stop the search
+	using callback_type = std::function<bool(const carved_image&)>;
+
+public:
+	static void scan(const buffers::input_buffer_ptr& buffer,
+		const callback_type& on_image, const carver_options& options = {});
+
+	[[nodiscard]]
+	static std::vector<carved_image> scan(const buffers::input_buffer_ptr& buffer,
+		const carver_options& options = {});
+};
+
+} //namespace pe_bliss::image
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "buffers/input_buffer_interface.h"
+#include "pe_bliss2/image/image_loader.h"
+#include "utilities/static_class.h"
+
+namespace pe_bliss::image
+{
+
+enum class memory_dump_loader_errc
+{
+	invalid_module_index_entry = 1,
+	module_is_out_of_dump_bounds
+};
+
+std::error_code make_error_code(memory_dump_loader_errc) noexcept;
+
+struct [[nodiscard]] dump_module
+{
+	std::string name;
+	//Offset of the module image in the dump
+	std::size_t offset{};
+	std::size_t size{};
+};
+
+using dump_module_list = std::vector<dump_module>;
+
+struct [[nodiscard]] memory_dump_load_options
+{
+	image_load_options image_options{ .image_loaded_to_memory = true };
+	//Modules are loaded concurrently if the dump buffer is stateless
+	std::uint32_t max_threads = 1u;
+};
+
+class memory_dump_loader final : public utilities::static_class
+{
+public:
+	//Parses a module index: one module per line in the form
+	//"<offset> <size> <name>", offsets and sizes are decimal or 0x-prefixed hex.
+	//Empty lines and lines starting with '#' are skipped.
+	[[nodiscard]]
+	static dump_module_list parse_module_index(std::istream& index);
+
+	//Loads each module as a view on the dump buffer, no module data is copied
+	//unless requested by options.image_options. Results are in the module order.
+	//Modules outside the dump have their fatal_error set.
+	[[nodiscard]]
+	static std::vector<image_load_result> load(const buffers::input_buffer_ptr& dump,
+		std::span<const dump_module> modules,
+		const memory_dump_load_options& options = {});
+
+	//Maps the dump file once (see buffers::input_file_mapping_buffer) and loads
+	//the modules from the mapping, which is shared by all loader threads.
+	//Loaded images keep the mapping alive.
+	//Throws std::system_error if the file can not be opened or mapped.
+	[[nodiscard]]
+	static std::vector<image_load_result> load(const std::filesystem::path& dump_path,
+		std::span<const dump_module> modules,
+		const memory_dump_load_options& options = {});
+};
+
+} //namespace pe_bliss::image
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::image::memory_dump_loader_errc> : true_type {};
+} //namespace std
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "pe_bliss2/bound_import/bound_import_directory_builder.h"
+#include "pe_bliss2/exports/export_directory_builder.h"
+#include "pe_bliss2/imports/import_directory_builder.h"
+#include "pe_bliss2/pe_types.h"
+#include "pe_bliss2/relocations/relocation_directory_builder.h"
+#include "pe_bliss2/section/section_header.h"
+#include "pe_bliss2/tls/tls_directory_builder.h"
+
+namespace pe_bliss::image
+{
+
+class image;
+
+enum class rebuild_planner_errc
+{
+	invalid_directory_alignment = 1,
+	invalid_section_index,
+	section_is_not_last,
+	no_room_for_section_header
+};
+
+std::error_code make_error_code(rebuild_planner_errc) noexcept;
+
+enum class rebuild_directory_type
+{
+	exports,
+	imports,
+	import_address_table,
+	relocations,
+	tls,
+	bound_imports
+};
+
+struct [[nodiscard]] rebuild_options final
+{
+	//If set, directories are placed after the data of this existing section,
+	//which must be the last one in the image. Otherwise, a new section is added.
+	std::optional<std::size_t> section_index;
+	std::string section_name{ ".rebuilt" };
+	section::section_header::characteristics::value section_characteristics{
+		static_cast<section::section_header::characteristics::value>(
+			section::section_header::characteristics::mem_read
+			| section::section_header::characteristics::cnt_initialized_data) };
+	//Power of two, not less than the size of a 64-bit pointer
+	std::uint32_t directory_alignment{ 16u };
+};
+
+struct [[nodiscard]] rebuild_plan_entry final
+{
+	rebuild_directory_type type{};
+	rva_type rva{};
+	std::uint32_t size{};
+};
+
+struct [[nodiscard]] rebuild_plan final
+{
+	std::vector<rebuild_plan_entry> entries;
+	std::size_t section_index{};
+	bool new_section{};
+	rva_type section_rva{};
+	std::uint32_t pointer_to_raw_data{};
+	//Section data size (aligned to file alignment) after the rebuild
+	std::uint32_t section_raw_size{};
+	std::uint32_t section_virtual_size{};
+	//Size of headers after the rebuild (may grow when a new section is added)
+	std::uint32_t size_of_headers{};
+};
+
+namespace impl
+{
+class rebuild_item;
+} //namespace impl
+
+//Rebuilds several directories at once. Sizes of all added directories
+//are calculated once, then the directories are laid out one after another
+//in a new or the last existing section, section headers, number of sections and
+//size of image are updated, and all directories are written in a single pass.
+//Directory RVAs in the builder options are set by the planner,
+//other builder options are preserved. Directories must outlive the planner.
+class [[nodiscard]] rebuild_planner final
+{
+public:
+	explicit rebuild_planner(image& instance) noexcept;
+	~rebuild_planner();
+
+	rebuild_planner(const rebuild_planner&) = delete;
+	rebuild_planner& operator=(const rebuild_planner&) = delete;
+	rebuild_planner(rebuild_planner&&) noexcept;
+	rebuild_planner& operator=(rebuild_planner&&) = delete;
+
+public:
+	rebuild_planner& add(exports::export_directory& directory,
+		const exports::builder_options& options = {});
+	rebuild_planner& add(exports::export_directory_details& directory,
+		const exports::builder_options& options = {});
+	//If options.iat_rva is set, the IAT is placed separately before the directory
+	rebuild_planner& add(imports::import_directory& directory,
+		const imports::builder_options& options = {});
+	rebuild_planner& add(imports::import_directory_details& directory,
+		const imports::builder_options& options = {});
+	rebuild_planner& add(relocations::base_relocation_list& directory,
+		const relocations::builder_options& options = {});
+	rebuild_planner& add(relocations::base_relocation_details_list& directory,
+		const relocations::builder_options& options = {});
+	rebuild_planner& add(tls::tls_directory& directory,
+		const tls::builder_options& options = {});
+	rebuild_planner& add(tls::tls_directory_details& directory,
+		const tls::builder_options& options = {});
+	rebuild_planner& add(bound_import::bound_library_list& directory,
+		const bound_import::builder_options& options = {});
+	rebuild_planner& add(bound_import::bound_library_details_list& directory,
+		const bound_import::builder_options& options = {});
+
+public:
+	//Calculates directory sizes and layout. Does not change the image.
+	const rebuild_plan& plan(const rebuild_options& options = {});
+
+	//Applies the plan (calls plan() with default options, if it was not called)
+	//to the image and writes all directories. The plan is consumed.
+	rebuild_plan build();
+
+	[[nodiscard]]
+	const std::optional<rebuild_plan>& get_plan() const noexcept
+	{
+		return plan_;
+	}
+
+private:
+	void add_item(std::unique_ptr<impl::rebuild_item> item);
+
+private:
+	image& instance_;
+	std::vector<std::unique_ptr<impl::rebuild_item>> items_;
+	std::optional<rebuild_options> options_;
+	std::optional<rebuild_plan> plan_;
+};
+
+} //namespace pe_bliss::image
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::image::rebuild_planner_errc> : true_type {};
+} //namespace std
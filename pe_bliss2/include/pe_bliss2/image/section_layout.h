@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+
+#include "pe_bliss2/section/section_data.h"
+#include "pe_bliss2/section/section_header.h"
+
+namespace pe_bliss::image
+{
+
+class image;
+
+enum class section_layout_errc
+{
+	invalid_section_index = 1,
+	invalid_section_size
+};
+
+std::error_code make_error_code(section_layout_errc) noexcept;
+
+struct [[nodiscard]] section_layout_options final
+{
+	//Update data directories, entry point and base of code/data
+	//which point to moved sections. Data directories which point
+	//to a removed section are cleared.
+	bool update_references = true;
+};
+
+//All functions below keep the image layout consistent: RVAs of the edited
+//section and all subsequent sections are laid out contiguously (with section
+//alignment), raw data of these sections is moved forward if it overlaps
+//the previous section data, size of headers is extended if the section table
+//does not fit (moving all sections, if necessary), number of sections and
+//size of image are updated.
+//Section data is never copied, except for the section which raw size grows:
+//untouched sections keep referencing the original buffers.
+//RVAs inside section data (e.g., code or directory contents) are not updated.
+
+//Inserts the section before the section with the specified index.
+//Index may be equal to the number of sections to append the section.
+//Section raw size is the section data physical size aligned to file alignment.
+//Section virtual size is the header virtual size (if it is larger than the
+//section data size) or the section data size.
+//Returns the inserted section header.
+section::section_header& insert_section(image& instance, std::size_t index,
+	section::section_header header, section::section_data data,
+	const section_layout_options& options = {});
+
+section::section_header& add_section(image& instance,
+	section::section_header header, section::section_data data,
+	const section_layout_options& options = {});
+
+//Changes raw and virtual sizes of the section. Section data is truncated
+//or extended with zeros.
+void resize_section(image& instance, std::size_t index,
+	std::uint32_t raw_size, std::uint32_t virtual_size,
+	const section_layout_options& options = {});
+
+void remove_section(image& instance, std::size_t index,
+	const section_layout_options& options = {});
+
+} //namespace pe_bliss::image
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::image::section_layout_errc> : true_type {};
+} //namespace std
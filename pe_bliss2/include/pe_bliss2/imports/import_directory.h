@@ -12,6 +12,7 @@
 #include "pe_bliss2/detail/imports/image_import_descriptor.h"
 #include "pe_bliss2/detail/packed_struct_base.h"
 #include "pe_bliss2/imports/imported_address.h"
+#include "utilities/list_allocator.h"
 
 namespace pe_bliss::imports
 {
@@ -69,19 +70,19 @@ public:
 
 public:
 	[[nodiscard]]
-	const packed_c_string& get_library_name() const & noexcept
+	const packed_list_c_string& get_library_name() const & noexcept
 	{
 		return library_name_;
 	}
 
 	[[nodiscard]]
-	packed_c_string& get_library_name() & noexcept
+	packed_list_c_string& get_library_name() & noexcept
 	{
 		return library_name_;
 	}
 
 	[[nodiscard]]
-	packed_c_string get_library_name() && noexcept
+	packed_list_c_string get_library_name() && noexcept
 	{
 		return std::move(library_name_);
 	}
@@ -105,7 +106,7 @@ public:
 	}
 
 public:
-	packed_c_string library_name_;
+	packed_list_c_string library_name_;
 	imported_address_list imports_;
 };
 
@@ -133,9 +134,13 @@ public:
 	using imported_library64_type = ImportedLibrary<std::uint64_t, Descriptor>;
 
 public:
+	using imported_library32_list_type = std::vector<imported_library32_type,
+		utilities::list_allocator<imported_library32_type>>;
+	using imported_library64_list_type = std::vector<imported_library64_type,
+		utilities::list_allocator<imported_library64_type>>;
 	using imported_library_list_type = std::variant<
-		std::vector<imported_library32_type>,
-		std::vector<imported_library64_type>
+		imported_library32_list_type,
+		imported_library64_list_type
 	>;
 
 public:
@@ -27,6 +27,8 @@ struct builder_options
 	bool update_import_data_directory = true;
 	bool update_delayed_import_data_directory = false;
 	bool update_iat_data_directory = true;
+	//Write identical library names and identical hint/name entries once
+	bool deduplicate_names = true;
 };
 
 struct build_result
@@ -47,6 +49,10 @@ void build_in_place(image::image& instance, const import_directory_details& dire
 	const builder_options& options);
 void build_in_place(image::image& instance, const import_directory& directory,
 	const builder_options& options);
+
+//The layout is planned once (thunk counts, interned names and all RVAs),
+//then the directory is written sequentially: descriptors, lookup tables,
+//address tables (when options.iat_rva is not set), library names, hints with names.
 build_result build_new(image::image& instance, import_directory_details& directory,
 	const builder_options& options);
 build_result build_new(image::image& instance, import_directory& directory,
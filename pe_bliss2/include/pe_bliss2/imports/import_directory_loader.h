@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <optional>
 #include <system_error>
 #include <type_traits>
@@ -40,6 +41,10 @@ struct [[nodiscard]] loader_options
 	bool allow_virtual_data = false;
 	core::data_directories::directory_type target_directory
 		= core::data_directories::directory_type::imports;
+	//If set, lists, library and function names and error lists of the loaded
+	//directory are allocated from this resource, which must outlive the directory.
+	//Used only if the library is built with PE_BLISS_ENABLE_PMR_LISTS
+	std::pmr::memory_resource* memory_resource = nullptr;
 };
 
 [[nodiscard]]
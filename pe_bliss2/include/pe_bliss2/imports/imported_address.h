@@ -13,6 +13,7 @@
 #include "pe_bliss2/packed_c_string.h"
 #include "pe_bliss2/packed_struct.h"
 #include "pe_bliss2/pe_types.h"
+#include "utilities/list_allocator.h"
 
 namespace pe_bliss::imports
 {
@@ -77,7 +78,7 @@ class [[nodiscard]] imported_function_hint_and_name : public imported_function_a
 {
 public:
 	using hint_type = packed_struct<std::uint16_t>;
-	using name_type = packed_c_string;
+	using name_type = packed_list_c_string;
 
 public:
 	[[nodiscard]]
@@ -205,6 +206,7 @@ class [[nodiscard]] imported_address_details
 template<detail::executable_pointer Va, bool HasUnloadIat>
 using imported_address_list = std::vector<imported_address<Va, HasUnloadIat>>;
 template<detail::executable_pointer Va, bool HasUnloadIat>
-using imported_address_details_list = std::vector<imported_address_details<Va, HasUnloadIat>>;
+using imported_address_details_list = std::vector<imported_address_details<Va, HasUnloadIat>,
+	utilities::list_allocator<imported_address_details<Va, HasUnloadIat>>>;
 
 } //namespace pe_bliss::imports
@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "buffers/input_buffer_state.h"
+#include "utilities/list_allocator.h"
 
 namespace buffers
 {
@@ -122,5 +123,9 @@ private:
 
 using packed_c_string = packed_c_string_base<std::string>;
 using packed_utf16_c_string = packed_c_string_base<std::u16string>;
+//Names of loaded directory entries, which loaders can allocate from
+//a memory resource (see utilities::list_allocator).
+//Same as packed_c_string unless the library is built with PE_BLISS_ENABLE_PMR_LISTS.
+using packed_list_c_string = packed_c_string_base<utilities::list_string>;
 
 } //namespace pe_bliss
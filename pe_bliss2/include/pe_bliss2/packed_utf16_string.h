@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "buffers/input_buffer_state.h"
+#include "utilities/list_allocator.h"
 
 namespace buffers
 {
@@ -18,25 +19,26 @@ class output_buffer_interface;
 namespace pe_bliss
 {
 
-class [[nodiscard]] packed_utf16_string
+template<typename String>
+class [[nodiscard]] packed_utf16_string_base
 {
 public:
-	using string_type = std::u16string;
+	using string_type = String;
 
 public:
 	template<typename... Args>
 		requires(std::constructible_from<string_type, Args...>)
-	explicit packed_utf16_string(Args&&... args)
+	explicit packed_utf16_string_base(Args&&... args)
 		noexcept(noexcept(string_type(std::forward<Args>(args)...)))
 		: value_(std::forward<Args>(args)...)
 	{
 	}
 
-	packed_utf16_string() = default;
+	packed_utf16_string_base() = default;
 
 	template<typename Other>
 		requires(std::convertible_to<Other, string_type> )
-	packed_utf16_string& operator=(Other&& str)
+	packed_utf16_string_base& operator=(Other&& str)
 		noexcept(noexcept(std::declval<string_type&>() = std::forward<Other>(str)))
 	{
 		value_ = std::forward<Other>(str);
@@ -116,13 +118,15 @@ public:
 	void sync_physical_size() noexcept;
 
 	[[nodiscard]]
-	friend auto operator<=>(const packed_utf16_string& l, const packed_utf16_string& r) noexcept
+	friend auto operator<=>(const packed_utf16_string_base& l,
+		const packed_utf16_string_base& r) noexcept
 	{
 		return l.value() <=> r.value();
 	}
 
 	[[nodiscard]]
-	friend bool operator==(const packed_utf16_string& l, const packed_utf16_string& r) noexcept
+	friend bool operator==(const packed_utf16_string_base& l,
+		const packed_utf16_string_base& r) noexcept
 	{
 		return l.value() == r.value();
 	}
@@ -140,4 +144,10 @@ private:
 	buffers::serialized_data_state state_;
 };
 
+using packed_utf16_string = packed_utf16_string_base<std::u16string>;
+//Names of loaded resource directory entries, which the loader can allocate
+//from a memory resource (see utilities::list_allocator).
+//Same as packed_utf16_string unless the library is built with PE_BLISS_ENABLE_PMR_LISTS.
+using packed_list_utf16_string = packed_utf16_string_base<utilities::list_u16string>;
+
 } //namespace pe_bliss
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <vector>
 
 #include "pe_bliss2/relocations/base_relocation.h"
+#include "pe_bliss2/relocations/relocation_entry.h"
 #include "pe_bliss2/pe_types.h"
 
 namespace buffers
@@ -18,6 +23,14 @@ class image;
 namespace pe_bliss::relocations
 {
 
+enum class relocation_directory_builder_errc
+{
+	invalid_relocation_type = 1,
+	unsorted_fixups
+};
+
+std::error_code make_error_code(relocation_directory_builder_errc) noexcept;
+
 struct builder_options
 {
 	rva_type directory_rva = 0;
@@ -26,6 +39,18 @@ struct builder_options
 	bool align_base_relocation_structures = true;
 };
 
+struct [[nodiscard]] relocation_fixup
+{
+	rva_type rva{};
+	relocation_type type{};
+	//Used by highadj relocations only
+	std::uint16_t param{};
+
+	[[nodiscard]]
+	friend bool operator==(const relocation_fixup&,
+		const relocation_fixup&) noexcept = default;
+};
+
 void build_in_place(image::image& instance, const base_relocation_details_list& directory,
 	const builder_options& options);
 void build_in_place(image::image& instance, const base_relocation_list& directory,
@@ -46,4 +71,50 @@ std::uint32_t get_built_size(const base_relocation_details_list& directory,
 std::uint32_t get_built_size(const base_relocation_list& directory,
 	const builder_options& options) noexcept;
 
+//Sorts fixups by RVA (radix sort, stable)
+void sort_fixups(std::span<relocation_fixup> fixups);
+
+//Appends relocations of the directory (except absolute ones,
+//which are used for padding) to the fixup list
+void append_fixups(const base_relocation_details_list& directory,
+	std::vector<relocation_fixup>& fixups);
+void append_fixups(const base_relocation_list& directory,
+	std::vector<relocation_fixup>& fixups);
+
+//Builds the relocation directory directly from the fixup list,
+//grouping the fixups by 4K pages. The fixups are sorted in place.
+//Absolute and duplicate fixups are skipped.
+//Throws pe_error if a fixup type does not fit into 4 bits.
+std::uint32_t build_new(image::image& instance, std::span<relocation_fixup> fixups,
+	const builder_options& options);
+std::uint32_t build_new(buffers::output_buffer_interface& buf,
+	std::span<relocation_fixup> fixups, const builder_options& options);
+
+//Builds the relocation directory which contains both the relocations
+//of the directory and the fixups
+std::uint32_t build_merged(image::image& instance,
+	const base_relocation_details_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options);
+std::uint32_t build_merged(image::image& instance,
+	const base_relocation_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options);
+std::uint32_t build_merged(buffers::output_buffer_interface& buf,
+	const base_relocation_details_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options);
+std::uint32_t build_merged(buffers::output_buffer_interface& buf,
+	const base_relocation_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options);
+
+//Fixups must be sorted (see sort_fixups).
+//Throws pe_error if fixups are not sorted or a fixup type does not fit into 4 bits.
+[[nodiscard]]
+std::uint32_t get_built_size(std::span<const relocation_fixup> fixups,
+	const builder_options& options);
+
 } //namespace pe_bliss::relocations
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::relocations::relocation_directory_builder_errc> : true_type {};
+} //namespace std
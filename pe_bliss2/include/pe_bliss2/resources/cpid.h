@@ -168,4 +168,7 @@ enum class code_page : cpid_type
 [[nodiscard]]
 std::optional<std::string_view> get_cpid_name(code_page cpid) noexcept;
 
+[[nodiscard]]
+std::optional<code_page> get_cpid_by_name(std::string_view name) noexcept;
+
 } //namespace pe_bliss::resources
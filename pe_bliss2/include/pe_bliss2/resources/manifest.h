@@ -105,6 +105,10 @@ enum class assembly_processor_architecture
 	unknown
 };
 
+[[nodiscard]]
+std::optional<std::string_view> processor_architecture_to_string(
+	assembly_processor_architecture arch) noexcept;
+
 struct [[nodiscard]] assembly_version : public full_version
 {
 	[[nodiscard]]
@@ -192,6 +196,10 @@ enum class assembly_supported_os
 	unsupported
 };
 
+[[nodiscard]]
+std::optional<std::string_view> supported_os_to_guid(
+	assembly_supported_os os) noexcept;
+
 template<typename... Bases>
 class [[nodiscard]] assembly_supported_os_list_base : public Bases...
 {
@@ -230,6 +238,10 @@ enum class com_threading_model
 	unknown
 };
 
+[[nodiscard]]
+std::optional<std::string_view> threading_model_to_string(
+	com_threading_model model) noexcept;
+
 // https://learn.microsoft.com/en-us/windows/win32/com/-progid--key
 class [[nodiscard]] com_progid
 {
@@ -308,6 +320,9 @@ struct ole_misc final
 	};
 };
 
+[[nodiscard]]
+std::optional<std::string_view> ole_misc_to_string(ole_misc::value flag) noexcept;
+
 // https://learn.microsoft.com/en-us/windows/win32/sbscs/assembly-manifests
 template<typename... Bases>
 class [[nodiscard]] com_class_base : public Bases...
@@ -439,6 +454,10 @@ struct com_typelib_flags final
 	};
 };
 
+[[nodiscard]]
+std::optional<std::string_view> typelib_flag_to_string(
+	com_typelib_flags::value flag) noexcept;
+
 template<typename... Bases>
 class [[nodiscard]] com_typelib_base : public Bases...
 {
@@ -610,6 +629,10 @@ enum class assembly_file_hash_algorithm
 	unknown
 };
 
+[[nodiscard]]
+std::optional<std::string_view> hash_algorithm_to_string(
+	assembly_file_hash_algorithm algorithm) noexcept;
+
 template<typename... Bases>
 class [[nodiscard]] assembly_file_base : public Bases...
 {
@@ -746,6 +769,9 @@ enum class dpi_aware_value
 	dpi_aware_per_monitor,
 };
 
+[[nodiscard]]
+std::optional<std::string_view> dpi_aware_to_string(dpi_aware_value value) noexcept;
+
 //Windows 10, version 1607 or newer
 enum class dpi_awareness_value
 {
@@ -767,6 +793,10 @@ enum class dpi_awareness_value
 	dpi_unaware
 };
 
+[[nodiscard]]
+std::optional<std::string_view> dpi_awareness_to_string(
+	dpi_awareness_value value) noexcept;
+
 class [[nodiscard]] dpi_awareness
 {
 public:
@@ -823,6 +853,10 @@ enum class requested_execution_level
 	highest_available
 };
 
+[[nodiscard]]
+std::optional<std::string_view> execution_level_to_string(
+	requested_execution_level level) noexcept;
+
 class [[nodiscard]] requested_privileges
 {
 public:
@@ -13,6 +13,7 @@
 #include "pe_bliss2/detail/resources/image_resource_directory.h"
 #include "pe_bliss2/pe_types.h"
 #include "pe_bliss2/resources/resource_types.h"
+#include "utilities/list_allocator.h"
 
 namespace pe_bliss::resources
 {
@@ -44,7 +45,8 @@ class [[nodiscard]] resource_directory_base
 {
 public:
 	using entry_type = resource_directory_entry_base<Bases...>;
-	using entry_list_type = std::vector<entry_type>;
+	using entry_list_type = std::vector<entry_type,
+		utilities::list_allocator<entry_type>>;
 
 public:
 	[[nodiscard]]
@@ -53,9 +55,12 @@ public:
 		return entries_;
 	}
 
+	//Entries may be added, renamed or reordered,
+	//so the directory is no longer considered sorted
 	[[nodiscard]]
 	entry_list_type& get_entries() & noexcept
 	{
+		sorted_entries_ = false;
 		return entries_;
 	}
 
@@ -98,8 +103,29 @@ public:
 	entry_type& try_emplace_entry_by_name(directory_entry_contents contents,
 		std::u16string&& name);
 
+	//Entries of a sorted directory are looked up using a binary search.
+	//Sorted entries are unique, named entries go first (ordered by name),
+	//then ID entries (ordered by ID). The loader marks directories it has
+	//validated as sorted, and try_emplace_* keep such directories sorted.
+	//Non-const get_entries() resets the flag. The flag must also be reset
+	//if an entry returned by a lookup is renamed.
+	[[nodiscard]]
+	bool has_sorted_entries() const noexcept
+	{
+		return sorted_entries_;
+	}
+
+	void set_sorted_entries(bool sorted) noexcept
+	{
+		sorted_entries_ = sorted;
+	}
+
+	//Sorts entries and marks the directory as sorted
+	void sort_entries();
+
 private:
 	entry_list_type entries_;
+	bool sorted_entries_ = false;
 };
 
 template<typename... Bases>
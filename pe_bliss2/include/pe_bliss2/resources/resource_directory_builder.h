@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+
+#include "pe_bliss2/pe_types.h"
+#include "pe_bliss2/resources/resource_directory.h"
+
+namespace buffers
+{
+class output_buffer_interface;
+} //namespace buffers
+
+namespace pe_bliss::image
+{
+class image;
+} //namespace pe_bliss::image
+
+namespace pe_bliss::resources
+{
+
+enum class resource_directory_builder_errc
+{
+	invalid_data_alignment = 1,
+	invalid_directory_entry,
+	directory_is_too_large
+};
+
+std::error_code make_error_code(resource_directory_builder_errc) noexcept;
+
+struct [[nodiscard]] builder_options
+{
+	rva_type directory_rva = 0;
+	bool update_data_directory = true;
+	//Write identical resource data blobs once and point all
+	//corresponding data entries to the single copy
+	bool deduplicate_data = true;
+	//Write identical entry names once
+	bool deduplicate_names = true;
+	//Alignment of each resource data blob, must be a power of 2
+	//and not less than 4
+	std::uint32_t data_alignment = 8u;
+};
+
+//The directory is laid out in a single pass in the same order
+//the resource compiler uses: all directory tables (breadth-first),
+//then data entries, then entry names, then resource data.
+//Directory entries are sorted before building. Directory,
+//directory entry and data entry descriptors are updated.
+//Directories must not contain empty entries or looped directory references.
+std::uint32_t build_new(image::image& instance, resource_directory& directory,
+	const builder_options& options);
+std::uint32_t build_new(image::image& instance, resource_directory_details& directory,
+	const builder_options& options);
+//options.directory_rva is the RVA the directory will be placed at
+//(resource data entries contain RVAs of resource data)
+std::uint32_t build_new(buffers::output_buffer_interface& buf, resource_directory& directory,
+	const builder_options& options);
+std::uint32_t build_new(buffers::output_buffer_interface& buf,
+	resource_directory_details& directory, const builder_options& options);
+
+[[nodiscard]]
+std::uint32_t get_built_size(const resource_directory& directory,
+	const builder_options& options = {});
+[[nodiscard]]
+std::uint32_t get_built_size(const resource_directory_details& directory,
+	const builder_options& options = {});
+
+} //namespace pe_bliss::resources
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::resources::resource_directory_builder_errc> : true_type {};
+} //namespace std
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <optional>
 #include <system_error>
 #include <type_traits>
@@ -33,6 +34,10 @@ struct [[nodiscard]] loader_options
 	bool include_headers = true;
 	bool allow_virtual_data = false;
 	bool copy_raw_data = false;
+	//If set, entry lists, entry names and error lists of the loaded directory
+	//are allocated from this resource, which must outlive the directory.
+	//Used only if the library is built with PE_BLISS_ENABLE_PMR_LISTS
+	std::pmr::memory_resource* memory_resource = nullptr;
 };
 
 std::error_code make_error_code(resource_directory_loader_errc) noexcept;
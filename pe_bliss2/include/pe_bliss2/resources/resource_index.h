@@ -0,0 +1,118 @@
+#pragma once
+
+#include <compare>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/resources/resource_directory.h"
+#include "pe_bliss2/resources/resource_types.h"
+
+namespace pe_bliss::resources
+{
+
+struct [[nodiscard]] resource_name_or_id_view
+{
+	resource_name_or_id_view() noexcept = default;
+
+	resource_name_or_id_view(resource_id_type id) noexcept
+		: id(id)
+	{
+	}
+
+	resource_name_or_id_view(resource_type type) noexcept
+		: id(static_cast<resource_id_type>(type))
+	{
+	}
+
+	resource_name_or_id_view(std::u16string_view name) noexcept
+		: is_named(true)
+		, name(name)
+	{
+	}
+
+	resource_name_or_id_view(const char16_t* name) noexcept
+		: resource_name_or_id_view(std::u16string_view(name))
+	{
+	}
+
+	//Named entries go first, as in the on-disk directory
+	bool is_named = false;
+	std::u16string_view name;
+	resource_id_type id{};
+
+	[[nodiscard]]
+	friend std::strong_ordering operator<=>(const resource_name_or_id_view& l,
+		const resource_name_or_id_view& r) noexcept
+	{
+		if (l.is_named != r.is_named)
+			return l.is_named ? std::strong_ordering::less : std::strong_ordering::greater;
+		if (l.is_named)
+			return l.name.compare(r.name) <=> 0;
+		return l.id <=> r.id;
+	}
+
+	[[nodiscard]]
+	friend bool operator==(const resource_name_or_id_view& l,
+		const resource_name_or_id_view& r) noexcept
+	{
+		return (l <=> r) == 0;
+	}
+};
+
+//Flat (type, name or ID, language) -> data entry index of the resource directory.
+//Resources which are not three levels deep (or have looped directories) are skipped.
+//The index references the directory, which must outlive the index
+//and must not be modified while the index is in use.
+template<typename... Bases>
+class [[nodiscard]] resource_index_base
+{
+public:
+	using directory_type = resource_directory_base<Bases...>;
+	using data_entry_type = resource_data_entry_base<Bases...>;
+
+	struct [[nodiscard]] index_entry
+	{
+		resource_name_or_id_view type;
+		resource_name_or_id_view name_or_id;
+		resource_id_type language{};
+		const data_entry_type* data = nullptr;
+	};
+
+	using index_entry_list_type = std::vector<index_entry>;
+
+public:
+	explicit resource_index_base(const directory_type& root);
+
+	//Entries are sorted by type, then name or ID, then language
+	[[nodiscard]]
+	const index_entry_list_type& get_entries() const noexcept
+	{
+		return entries_;
+	}
+
+	[[nodiscard]]
+	const data_entry_type* try_get_data(resource_name_or_id_view type,
+		resource_name_or_id_view name_or_id, resource_id_type language) const noexcept;
+	[[nodiscard]]
+	const data_entry_type& get_data(resource_name_or_id_view type,
+		resource_name_or_id_view name_or_id, resource_id_type language) const;
+
+	//Returns all languages of the resource, ordered by language
+	[[nodiscard]]
+	std::span<const index_entry> get_languages(resource_name_or_id_view type,
+		resource_name_or_id_view name_or_id) const noexcept;
+	//Returns all resources of the type, ordered by name or ID, then language
+	[[nodiscard]]
+	std::span<const index_entry> get_resources(
+		resource_name_or_id_view type) const noexcept;
+
+private:
+	index_entry_list_type entries_;
+};
+
+using resource_index = resource_index_base<>;
+using resource_index_details = resource_index_base<error_list>;
+
+} //namespace pe_bliss::resources
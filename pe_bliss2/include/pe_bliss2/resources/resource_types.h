@@ -46,7 +46,7 @@ enum class manifest_resource_id : std::uint32_t
 using resource_type_list_type = std::vector<resource_type>;
 using resource_id_type = std::uint32_t;
 using resource_id_list_type = std::vector<resource_id_type>;
-using resource_name_type = packed_utf16_string;
+using resource_name_type = packed_list_utf16_string;
 using resource_name_list_type = std::vector<resource_name_type>;
 using resource_language_list_type = std::vector<lcid_type>;
 
@@ -13,6 +13,7 @@
 #include "pe_bliss2/security/signature_verifier.h"
 #include "pe_bliss2/security/x509/x509_certificate.h"
 #include "pe_bliss2/security/x509/x509_certificate_store.h"
+#include "pe_bliss2/security/x509/x509_lazy_certificate_store.h"
 
 namespace pe_bliss::security
 {
@@ -43,6 +44,8 @@ struct [[nodiscard]] authenticode_check_status_base
 
 	std::optional<x509::x509_certificate_store<
 		x509::x509_certificate<RangeType>>> cert_store;
+	//Set instead of cert_store if the raw signature data is available
+	std::optional<x509::x509_lazy_certificate_store> lazy_cert_store;
 	std::optional<authenticode_pkcs7<RangeType>> signature;
 
 	std::optional<authenticode_timestamp_signature_check_status_ex<RangeType>>
@@ -6,9 +6,12 @@
 #include <vector>
 
 #include "buffers/input_buffer_interface.h"
+#include "buffers/ref_buffer.h"
 
 #include "pe_bliss2/detail/security/image_security_directory.h"
 #include "pe_bliss2/security/authenticode_pkcs7.h"
+#include "pe_bliss2/security/authenticode_unauthenticated_attributes.h"
+#include "pe_bliss2/security/byte_range_types.h"
 #include "pe_bliss2/security/pkcs7/attribute_map.h"
 
 namespace pe_bliss::security
@@ -25,7 +28,8 @@ enum class authenticode_loader_errc
 std::error_code make_error_code(authenticode_loader_errc) noexcept;
 
 // authenticode_span_range_type is safe to use as RangeType only
-// if the buffer is fully copied to memory (otherwise the function will throw).
+// if the buffer data is contiguous in memory (otherwise the function will throw).
+// This is the case for copied buffers and for memory (or memory-mapped) image buffers.
 template<typename RangeType>
 [[nodiscard]]
 authenticode_pkcs7<RangeType> load_authenticode_signature(
@@ -37,12 +41,25 @@ authenticode_pkcs7<RangeType> load_authenticode_signature(
 	buffers::input_buffer_interface& buffer,
 	const detail::security::win_certificate& certificate_info);
 
+// Parses the signature in place if the buffer data is contiguous in memory,
+// otherwise copies the buffer data first. signature_data references or owns
+// the data, which is referenced by the result.
+[[nodiscard]]
+authenticode_pkcs7<span_range_type> load_authenticode_signature(
+	const buffers::input_buffer_ptr& buffer,
+	buffers::ref_buffer& signature_data);
+
 // Double-signing support
 template<typename TargetRangeType, typename RangeType>
 [[nodiscard]]
 std::vector<authenticode_pkcs7<TargetRangeType>> load_nested_signatures(
 	const pkcs7::attribute_map<RangeType>& unauthenticated_attributes);
 
+template<typename TargetRangeType>
+[[nodiscard]]
+std::vector<authenticode_pkcs7<TargetRangeType>> load_nested_signatures(
+	const authenticode_unauthenticated_attributes& unauthenticated_attributes);
+
 } //namespace pe_bliss::security
 
 namespace std
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+
+namespace pe_bliss::image { class image; }
+
+namespace pe_bliss::security
+{
+
+enum class authenticode_signer_errc
+{
+	unsupported_digest_algorithm = 1,
+	invalid_private_key,
+	invalid_signer_certificate,
+	invalid_signature,
+	invalid_security_directory,
+	unable_to_sign,
+	unsupported_page_hash_algorithm
+};
+
+std::error_code make_error_code(authenticode_signer_errc) noexcept;
+
+struct [[nodiscard]] authenticode_signing_options final
+{
+	//SHA-1, SHA-256, SHA-384 and SHA-512 are supported
+	digest_algorithm digest_alg{ digest_algorithm::sha256 };
+	//DER-encoded signer certificate
+	span_range_type signer_certificate;
+	//DER-encoded RSA private key (PKCS#8 PrivateKeyInfo or PKCS#1 RSAPrivateKey)
+	span_range_type private_key;
+	//DER-encoded certificates to include into the signature (e.g., intermediate CAs)
+	std::vector<span_range_type> additional_certificates;
+	//Page hashes are supported for SHA-1 and SHA-256 digests only
+	bool add_page_hashes = false;
+	std::optional<std::u16string> program_name;
+	std::optional<std::string> more_info_url;
+	std::optional<std::chrono::sys_seconds> signing_time;
+	//If the image is already signed, the signature is added as a nested one
+	//to the existing primary signature. Otherwise, existing signatures are replaced.
+	bool nested = false;
+	bool update_checksum = true;
+};
+
+//Creates the DER-encoded Authenticode signature (PKCS#7 ContentInfo
+//with SignedData containing SpcIndirectDataContent).
+//page_hashes must be calculated using options.digest_alg.
+[[nodiscard]]
+std::vector<std::byte> create_authenticode_signature(span_range_type image_hash,
+	const std::optional<span_range_type>& page_hashes,
+	const authenticode_signing_options& options);
+
+//Adds nested_signature to the unauthenticated attributes
+//of the first signer of the signature
+[[nodiscard]]
+std::vector<std::byte> add_nested_signature(span_range_type signature,
+	span_range_type nested_signature);
+
+//Replaces the security directory at the end of the image overlay
+//with the single WIN_CERTIFICATE containing the signature,
+//and updates the security data directory and the image checksum
+//(also inside the full headers buffer, if it is present).
+void write_authenticode_signature(image::image& instance,
+	span_range_type signature, bool update_checksum = true);
+
+//Calculates the image hash (and page hashes), creates the signature
+//and writes it to the image
+void sign_image(image::image& instance, const authenticode_signing_options& options);
+
+} //namespace pe_bliss::security
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::security::authenticode_signer_errc> : true_type {};
+} //namespace std
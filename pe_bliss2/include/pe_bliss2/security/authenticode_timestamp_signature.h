@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <variant>
 
+#include "pe_bliss2/security/authenticode_unauthenticated_attributes.h"
 #include "pe_bliss2/security/pkcs7/pkcs7.h"
 #include "pe_bliss2/security/pkcs7/signer_info.h"
 
@@ -66,6 +67,14 @@ template<typename TargetRangeType, typename RangeType>
 std::optional<authenticode_timestamp_signature<TargetRangeType>> load_timestamp_signature(
 	const pkcs7::attribute_map<RangeType>& unauthenticated_attrs);
 
+//Loads the RFC3161 timestamp, the Authenticode timestamp or
+//the countersignature (whichever is present first, in this order).
+//Throws pe_error with timestamp_errc if it is set.
+template<typename TargetRangeType>
+[[nodiscard]]
+std::optional<authenticode_timestamp_signature<TargetRangeType>> load_timestamp_signature(
+	const authenticode_unauthenticated_attributes& unauthenticated_attrs);
+
 } //namespace pe_bliss::security
 
 namespace std
@@ -13,6 +13,7 @@
 #include "pe_bliss2/security/authenticode_timestamp_signature.h"
 #include "pe_bliss2/security/authenticode_timestamp_signature_check_status.h"
 #include "pe_bliss2/security/authenticode_timestamp_signature_format_validator.h"
+#include "pe_bliss2/security/authenticode_unauthenticated_attributes.h"
 #include "pe_bliss2/security/buffer_hash.h"
 #include "pe_bliss2/security/byte_range_types.h"
 #include "pe_bliss2/security/crypto_algorithms.h"
@@ -20,6 +21,7 @@
 #include "pe_bliss2/security/pkcs7/message_digest.h"
 #include "pe_bliss2/security/pkcs7/pkcs7_format_validator.h"
 #include "pe_bliss2/security/pkcs7/signer_info.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
 #include "pe_bliss2/security/signature_verifier.h"
 #include "pe_bliss2/security/x509/x509_certificate.h"
 #include "pe_bliss2/security/x509/x509_certificate_store.h"
@@ -35,14 +37,15 @@ namespace pe_bliss::security
 namespace impl
 {
 template<typename Signature, typename RangeType1, typename RangeType2,
-	typename RangeType3, typename Cert, typename RangeType5>
+	typename RangeType3, typename CertStore, typename RangeType5>
 void verify_valid_format_timestamp_signature_impl(
 	const Signature& signature,
 	const pkcs7::signer_info_ref_cms<RangeType1>& signer,
 	const pkcs7::attribute_map<RangeType2>& authenticated_attributes,
 	const RangeType3& authenticode_encrypted_digest,
-	const x509::x509_certificate_store<Cert>& cert_store,
-	authenticode_timestamp_signature_check_status<RangeType5>& result)
+	const CertStore& cert_store,
+	authenticode_timestamp_signature_check_status<RangeType5>& result,
+	signature_verification_cache* cache)
 {
 	auto& digest_alg = result.digest_alg.emplace();
 	auto& digest_encryption_alg = result.digest_encryption_alg.emplace();
@@ -79,14 +82,15 @@ void verify_valid_format_timestamp_signature_impl(
 		return;
 	}
 
-	result.signature_result = verify_signature(signer, cert_store);
+	result.signature_result = verify_signature(signer, cert_store, cache);
 }
 
 template<typename RangeType2, typename Signature, typename RangeType1>
 void verify_timestamp_signature_impl(
 	const RangeType2& authenticode_encrypted_digest,
 	const Signature& signature,
-	authenticode_timestamp_signature_check_status<RangeType1>& result)
+	authenticode_timestamp_signature_check_status<RangeType1>& result,
+	signature_verification_cache* cache)
 {
 	validate_autenticode_timestamp_format(signature, result.authenticode_format_errors);
 	if (result.authenticode_format_errors.has_errors())
@@ -116,7 +120,7 @@ void verify_timestamp_signature_impl(
 	verify_valid_format_timestamp_signature_impl(
 		signature, signer, authenticated_attributes,
 		authenticode_encrypted_digest,
-		*result.cert_store, result);
+		*result.cert_store, result, cache);
 
 	// signature.data.content_info.tsa points to attribute_certificate_v2_type
 	result.signing_time = signature.get_content_info().data.content_info.info.value.gen_time;
@@ -125,23 +129,25 @@ void verify_timestamp_signature_impl(
 template<typename RangeType1, typename RangeType2, typename Signature>
 authenticode_timestamp_signature_check_status<RangeType1> verify_timestamp_signature_impl(
 	const RangeType2& authenticode_encrypted_digest,
-	const Signature& signature)
+	const Signature& signature,
+	signature_verification_cache* cache)
 {
 	authenticode_timestamp_signature_check_status<RangeType1> result;
-	verify_timestamp_signature_impl(authenticode_encrypted_digest, signature, result);
+	verify_timestamp_signature_impl(authenticode_encrypted_digest, signature, result, cache);
 	return result;
 }
 } //namespace impl
 
 template<typename RangeType2,
-	typename RangeType3, typename RangeType4, typename Cert,
+	typename RangeType3, typename RangeType4, typename CertStore,
 	typename RangeType1>
 void verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const pkcs7::signer_info_ref_pkcs7<RangeType3>& timestamp_signer,
 	const pkcs7::attribute_map<RangeType4>& timestamp_authenticated_attributes,
-	const x509::x509_certificate_store<Cert>& cert_store,
-	authenticode_timestamp_signature_check_status<RangeType1>& result)
+	const CertStore& cert_store,
+	authenticode_timestamp_signature_check_status<RangeType1>& result,
+	signature_verification_cache* cache = nullptr)
 {
 	auto& digest_alg = result.digest_alg.emplace();
 	auto& digest_encryption_alg = result.digest_encryption_alg.emplace();
@@ -172,72 +178,78 @@ void verify_timestamp_signature(
 		return;
 	}
 
-	result.signature_result = verify_signature(timestamp_signer, cert_store);
+	result.signature_result = verify_signature(timestamp_signer, cert_store, cache);
 }
 
 template<typename RangeType1 = span_range_type, typename RangeType2,
-	typename RangeType3, typename RangeType4, typename Cert>
+	typename RangeType3, typename RangeType4, typename CertStore>
 authenticode_timestamp_signature_check_status<RangeType1> verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const pkcs7::signer_info_ref_pkcs7<RangeType3>& timestamp_signer,
 	const pkcs7::attribute_map<RangeType4>& timestamp_authenticated_attributes,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
 	authenticode_timestamp_signature_check_status<RangeType1> result;
 	verify_timestamp_signature(authenticode_encrypted_digest, timestamp_signer,
-		timestamp_authenticated_attributes, cert_store, result);
+		timestamp_authenticated_attributes, cert_store, result, cache);
 	return result;
 }
 
 template<typename RangeType1 = span_range_type, typename RangeType2,
-	typename RangeType3, typename RangeType4, typename Cert>
+	typename RangeType3, typename RangeType4, typename CertStore>
 authenticode_timestamp_signature_check_status<RangeType1> verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const pkcs7::signer_info_pkcs7<RangeType3>& timestamp_signer,
 	const pkcs7::attribute_map<RangeType4>& timestamp_authenticated_attributes,
-	const x509::x509_certificate_store<Cert>& cert_store) {
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr) {
 	return verify_timestamp_signature<RangeType1>(authenticode_encrypted_digest,
 		pkcs7::signer_info_ref_pkcs7(timestamp_signer),
 		timestamp_authenticated_attributes,
-		cert_store);
+		cert_store, cache);
 }
 
 template<typename RangeType2, typename RangeType1>
 void verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const authenticode_signature_cms_info_ms_bug_workaround_type<RangeType1>& signature,
-	authenticode_timestamp_signature_check_status<RangeType1>& result)
+	authenticode_timestamp_signature_check_status<RangeType1>& result,
+	signature_verification_cache* cache = nullptr)
 {
 	impl::verify_timestamp_signature_impl(
-		authenticode_encrypted_digest, signature, result);
+		authenticode_encrypted_digest, signature, result, cache);
 }
 
 template<typename RangeType2, typename RangeType1>
 void verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const authenticode_signature_cms_info_type<RangeType1>& signature,
-	authenticode_timestamp_signature_check_status<RangeType1>& result)
+	authenticode_timestamp_signature_check_status<RangeType1>& result,
+	signature_verification_cache* cache = nullptr)
 {
 	impl::verify_timestamp_signature_impl(
-		authenticode_encrypted_digest, signature, result);
+		authenticode_encrypted_digest, signature, result, cache);
 }
 
 template<typename RangeType1 = span_range_type, typename RangeType2>
 authenticode_timestamp_signature_check_status<RangeType1> verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
-	const authenticode_signature_cms_info_ms_bug_workaround_type<RangeType1>& signature)
+	const authenticode_signature_cms_info_ms_bug_workaround_type<RangeType1>& signature,
+	signature_verification_cache* cache = nullptr)
 {
 	return impl::verify_timestamp_signature_impl<RangeType1>(
-		authenticode_encrypted_digest, signature);
+		authenticode_encrypted_digest, signature, cache);
 }
 
 template<typename RangeType1 = span_range_type, typename RangeType2>
 authenticode_timestamp_signature_check_status<RangeType1> verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
-	const authenticode_signature_cms_info_type<RangeType1>& signature)
+	const authenticode_signature_cms_info_type<RangeType1>& signature,
+	signature_verification_cache* cache = nullptr)
 {
 	return impl::verify_timestamp_signature_impl<RangeType1>(
-		authenticode_encrypted_digest, signature);
+		authenticode_encrypted_digest, signature, cache);
 }
 
 template<typename RangeType>
@@ -247,11 +259,12 @@ void verify_valid_format_timestamp_signature(
 	const pkcs7::attribute_map<RangeType>& authenticated_attributes,
 	const RangeType& authenticode_encrypted_digest,
 	const x509::x509_certificate_store<x509::x509_certificate<RangeType>>& cert_store,
-	authenticode_timestamp_signature_check_status<RangeType>& result)
+	authenticode_timestamp_signature_check_status<RangeType>& result,
+	signature_verification_cache* cache = nullptr)
 {
 	impl::verify_valid_format_timestamp_signature_impl(signature,
 		signer, authenticated_attributes, authenticode_encrypted_digest,
-		cert_store, result);
+		cert_store, result, cache);
 }
 
 template<typename RangeType>
@@ -261,35 +274,37 @@ void verify_valid_format_timestamp_signature(
 	const pkcs7::attribute_map<RangeType>& authenticated_attributes,
 	const RangeType& authenticode_encrypted_digest,
 	const x509::x509_certificate_store<x509::x509_certificate<RangeType>>& cert_store,
-	authenticode_timestamp_signature_check_status<RangeType>& result)
+	authenticode_timestamp_signature_check_status<RangeType>& result,
+	signature_verification_cache* cache = nullptr)
 {
 	impl::verify_valid_format_timestamp_signature_impl(signature,
 		signer, authenticated_attributes, authenticode_encrypted_digest,
-		cert_store, result);
+		cert_store, result, cache);
 }
 
 namespace impl
 {
 template<typename Result, typename RangeType2, typename RangeType3,
-	typename Cert>
+	typename CertStore>
 Result verify_timestamp_signature_ex(
 	const RangeType2& authenticode_encrypted_digest,
 	const authenticode_timestamp_signature<RangeType3>& signature,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache)
 {
 	Result result;
 	using ts_sign_type = authenticode_timestamp_signature<RangeType3>;
 	std::visit(utilities::overloaded{
-			[&authenticode_encrypted_digest, &cert_store, &result](
+			[&authenticode_encrypted_digest, &cert_store, &result, cache](
 				const typename ts_sign_type::signer_info_type& sign) {
 				verify_timestamp_signature(
 					authenticode_encrypted_digest,
 					pkcs7::signer_info_ref_pkcs7(sign),
-					sign.get_authenticated_attributes(), cert_store, result);
+					sign.get_authenticated_attributes(), cert_store, result, cache);
 			},
-			[&authenticode_encrypted_digest, &result](const auto& sign) {
+			[&authenticode_encrypted_digest, &result, cache](const auto& sign) {
 				return verify_timestamp_signature(
-					authenticode_encrypted_digest, sign, result);
+					authenticode_encrypted_digest, sign, result, cache);
 			}
 		}, signature.get_underlying_type());
 	return result;
@@ -297,37 +312,40 @@ Result verify_timestamp_signature_ex(
 } //namespace impl
 
 template<typename RangeType1, typename RangeType2, typename RangeType3,
-	typename Cert>
+	typename CertStore>
 authenticode_timestamp_signature_check_status<RangeType1> verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const authenticode_timestamp_signature<RangeType3>& signature,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
 	return impl::verify_timestamp_signature_ex<
 		authenticode_timestamp_signature_check_status<RangeType1>>(
-			authenticode_encrypted_digest, signature, cert_store);
+			authenticode_encrypted_digest, signature, cert_store, cache);
 }
 
 template<typename RangeType1, typename RangeType2, typename RangeType3,
-	typename Cert>
+	typename CertStore>
 authenticode_timestamp_signature_check_status_ex<RangeType1> verify_timestamp_signature_ex(
 	const RangeType2& authenticode_encrypted_digest,
 	authenticode_timestamp_signature<RangeType3>&& signature,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
 	auto result = impl::verify_timestamp_signature_ex<
 		authenticode_timestamp_signature_check_status_ex<RangeType1>>(
-			authenticode_encrypted_digest, signature, cert_store);
+			authenticode_encrypted_digest, signature, cert_store, cache);
 	result.signature = std::move(signature);
 	return result;
 }
 
 template<typename RangeType1, typename RangeType2, typename RangeType3,
-	typename Cert>
+	typename CertStore>
 std::optional<authenticode_timestamp_signature_check_status<RangeType1>> verify_timestamp_signature(
 	const RangeType2& authenticode_encrypted_digest,
 	const pkcs7::attribute_map<RangeType3>& unauthenticated_attributes,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
 	const auto signature = pe_bliss::security::load_timestamp_signature<RangeType1>(
 		unauthenticated_attributes);
@@ -335,15 +353,48 @@ std::optional<authenticode_timestamp_signature_check_status<RangeType1>> verify_
 		return {};
 
 	return verify_timestamp_signature<RangeType1>(authenticode_encrypted_digest,
-		*signature, cert_store);
+		*signature, cert_store, cache);
 }
 
 template<typename RangeType1, typename RangeType2, typename RangeType3,
-	typename Cert>
+	typename CertStore>
 std::optional<authenticode_timestamp_signature_check_status_ex<RangeType1>> verify_timestamp_signature_ex(
 	const RangeType2& authenticode_encrypted_digest,
 	const pkcs7::attribute_map<RangeType3>& unauthenticated_attributes,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
+{
+	auto signature = pe_bliss::security::load_timestamp_signature<RangeType1>(
+		unauthenticated_attributes);
+	if (!signature)
+		return {};
+
+	return verify_timestamp_signature_ex<RangeType1>(authenticode_encrypted_digest,
+		std::move(*signature), cert_store, cache);
+}
+
+template<typename RangeType1, typename RangeType2, typename CertStore>
+std::optional<authenticode_timestamp_signature_check_status<RangeType1>> verify_timestamp_signature(
+	const RangeType2& authenticode_encrypted_digest,
+	const authenticode_unauthenticated_attributes& unauthenticated_attributes,
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
+{
+	const auto signature = pe_bliss::security::load_timestamp_signature<RangeType1>(
+		unauthenticated_attributes);
+	if (!signature)
+		return {};
+
+	return verify_timestamp_signature<RangeType1>(authenticode_encrypted_digest,
+		*signature, cert_store, cache);
+}
+
+template<typename RangeType1, typename RangeType2, typename CertStore>
+std::optional<authenticode_timestamp_signature_check_status_ex<RangeType1>> verify_timestamp_signature_ex(
+	const RangeType2& authenticode_encrypted_digest,
+	const authenticode_unauthenticated_attributes& unauthenticated_attributes,
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
 	auto signature = pe_bliss::security::load_timestamp_signature<RangeType1>(
 		unauthenticated_attributes);
@@ -351,17 +402,18 @@ std::optional<authenticode_timestamp_signature_check_status_ex<RangeType1>> veri
 		return {};
 
 	return verify_timestamp_signature_ex<RangeType1>(authenticode_encrypted_digest,
-		std::move(*signature), cert_store);
+		std::move(*signature), cert_store, cache);
 }
 
-template<typename RangeType1, typename RangeType2, typename Cert>
+template<typename RangeType1, typename RangeType2, typename CertStore>
 std::optional<authenticode_timestamp_signature_check_status<RangeType1>> verify_timestamp_signature(
 	const authenticode_pkcs7<RangeType2>& authenticode,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
 	const auto& signer = authenticode.get_signer(0);
 	return verify_timestamp_signature<RangeType1>(signer.get_encrypted_digest(),
-		signer.get_unauthenticated_attributes(), cert_store);
+		signer.get_unauthenticated_attributes(), cert_store, cache);
 }
 
 } //namespace pe_bliss::security
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/pkcs7/attribute_map.h"
+
+namespace pe_bliss::security
+{
+
+//Authenticode signer unauthenticated attributes, which are required
+//to verify nested signatures and timestamps. All values reference
+//the signature data.
+struct [[nodiscard]] authenticode_unauthenticated_attributes final
+{
+	//Double-signing support
+	std::vector<span_range_type> nested_signatures;
+	//Set if the nested signature attribute has no values
+	std::error_code nested_signatures_errc;
+	//RFC3161 timestamp token (CMS)
+	std::optional<span_range_type> rfc3161_timestamp;
+	//Authenticode timestamp token (CMS)
+	std::optional<span_range_type> authenticode_timestamp;
+	//PKCS9 countersignature (signer info)
+	std::optional<span_range_type> countersignature;
+	//Set if a timestamp or countersignature attribute has no values
+	//or multiple values. Reported when the timestamp is loaded.
+	std::error_code timestamp_errc;
+};
+
+//Collects all relevant attributes in a single pass over the map.
+//Does not throw if an attribute has an invalid number of values,
+//sets nested_signatures_errc or timestamp_errc (attribute_map_errc) instead,
+//so that the signature itself can still be verified.
+template<typename RangeType>
+[[nodiscard]]
+authenticode_unauthenticated_attributes decode_unauthenticated_attributes(
+	const pkcs7::attribute_map<RangeType>& unauthenticated_attributes);
+
+} //namespace pe_bliss::security
@@ -5,10 +5,16 @@
 namespace pe_bliss::security
 {
 
+class signature_verification_cache;
+
 struct [[nodiscard]] authenticode_verification_options final
 {
 	page_hash_options page_hash_opts;
 	bool verify_timestamp_signature = true;
+	//Optional cache of decoded public keys and signature verification results,
+	//which can be shared between verifications of many images (also from many threads).
+	//Must outlive the verification.
+	signature_verification_cache* verification_cache = nullptr;
 };
 
 } //namespace pe_bliss::security
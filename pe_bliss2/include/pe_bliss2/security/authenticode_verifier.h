@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <optional>
+#include <type_traits>
 #include <utility>
 
 #include "pe_bliss2/pe_error.h"
@@ -11,8 +14,10 @@
 #include "pe_bliss2/security/authenticode_pkcs7.h"
 #include "pe_bliss2/security/authenticode_timestamp_signature_format_validator.h"
 #include "pe_bliss2/security/authenticode_timestamp_signature_verifier.h"
+#include "pe_bliss2/security/authenticode_unauthenticated_attributes.h"
 #include "pe_bliss2/security/authenticode_verification_options.h"
 #include "pe_bliss2/security/buffer_hash.h"
+#include "pe_bliss2/security/byte_range_types.h"
 #include "pe_bliss2/security/crypto_algorithms.h"
 #include "pe_bliss2/security/image_hash.h"
 #include "pe_bliss2/security/pkcs7/pkcs7.h"
@@ -20,6 +25,7 @@
 #include "pe_bliss2/security/pkcs7/pkcs7_format_validator.h"
 #include "pe_bliss2/security/pkcs7/pkcs7_signature.h"
 #include "pe_bliss2/security/signature_verifier.h"
+#include "pe_bliss2/security/x509/x509_lazy_certificate_store.h"
 
 #include "simple_asn1/types.h"
 
@@ -28,17 +34,32 @@ namespace pe_bliss::image { class image; }
 namespace pe_bliss::security
 {
 
-// Requires cert_store to be set inside authenticode_check_status_base
+namespace impl
+{
+template<typename RangeType, typename Func>
+decltype(auto) visit_certificate_store(
+	const authenticode_check_status_base<RangeType>& result, Func&& func)
+{
+	if (result.lazy_cert_store)
+		return std::forward<Func>(func)(*result.lazy_cert_store);
+	return std::forward<Func>(func)(result.cert_store.value());
+}
+} //namespace impl
+
+// Requires cert_store or lazy_cert_store to be set inside authenticode_check_status_base.
+// Image is either image::image or image_hash_stream_result
+// (hashes calculated in a single pass over the image file).
+// If unauthenticated_attributes is null, they are decoded from the signer.
 template<typename RangeType1, typename RangeType2,
-	typename RangeType3, typename RangeType4, typename RangeType5 = span_range_type>
+	typename RangeType3, typename Image, typename RangeType4>
 void verify_valid_format_authenticode(
 	const authenticode_pkcs7<RangeType1>& authenticode,
 	const pkcs7::signer_info_ref_pkcs7<RangeType2>& signer,
 	const pkcs7::attribute_map<RangeType3>& authenticated_attributes,
-	const image::image& instance,
+	const Image& instance,
 	const authenticode_verification_options& opts,
 	authenticode_check_status_base<RangeType4>& result,
-	const pkcs7::attribute_map<RangeType5>* unauthenticated_attributes = nullptr)
+	const authenticode_unauthenticated_attributes* unauthenticated_attributes = nullptr)
 {
 	auto& digest_alg = result.image_digest_alg.emplace();
 	auto& digest_encryption_alg = result.digest_encryption_alg.emplace();
@@ -104,26 +125,30 @@ void verify_valid_format_authenticode(
 		return;
 	}
 
-	result.signature_result = verify_signature(signer, result.cert_store.value());
+	result.signature_result = impl::visit_certificate_store(result,
+		[&signer, &opts](const auto& cert_store) {
+			return verify_signature(signer, cert_store, opts.verification_cache);
+		});
 
 	if (!opts.verify_timestamp_signature)
 		return;
 
 	try
 	{
-		if (unauthenticated_attributes)
-		{
-			result.timestamp_signature_result = verify_timestamp_signature_ex<RangeType4>(
-				authenticode.get_signer(0).get_encrypted_digest(),
-				*unauthenticated_attributes, result.cert_store.value());
-		}
-		else
+		std::optional<authenticode_unauthenticated_attributes> decoded_attributes;
+		if (!unauthenticated_attributes)
 		{
-			result.timestamp_signature_result = verify_timestamp_signature_ex<RangeType4>(
-				authenticode.get_signer(0).get_encrypted_digest(),
-				signer.get_unauthenticated_attributes(),
-				result.cert_store.value());
+			unauthenticated_attributes = &decoded_attributes.emplace(
+				decode_unauthenticated_attributes(signer.get_unauthenticated_attributes()));
 		}
+
+		result.timestamp_signature_result = impl::visit_certificate_store(result,
+			[&authenticode, unauthenticated_attributes, &opts](const auto& cert_store) {
+				return verify_timestamp_signature_ex<RangeType4>(
+					authenticode.get_signer(0).get_encrypted_digest(),
+					*unauthenticated_attributes, cert_store,
+					opts.verification_cache);
+			});
 	}
 	catch (const pe_error& e)
 	{
@@ -131,12 +156,16 @@ void verify_valid_format_authenticode(
 	}
 }
 
-template<typename Authenticode, typename RangeType, typename RangeType2 = span_range_type>
+// If raw_signature (DER-encoded authenticode signature data, which must
+// outlive the result) is not empty, certificates are indexed without decoding,
+// and only the signing certificates are parsed (lazy_cert_store is set).
+template<typename Authenticode, typename Image, typename RangeType>
 void verify_authenticode(Authenticode&& authenticode,
-	const image::image& instance,
+	const Image& instance,
 	const authenticode_verification_options& opts,
 	authenticode_check_status_base<RangeType>& result,
-	const pkcs7::attribute_map<RangeType2>* unauthenticated_attributes = nullptr)
+	const authenticode_unauthenticated_attributes* unauthenticated_attributes = nullptr,
+	span_range_type raw_signature = {})
 {
 	validate_autenticode_format(authenticode, result.authenticode_format_errors);
 	if (result.authenticode_format_errors.has_errors())
@@ -160,32 +189,59 @@ void verify_authenticode(Authenticode&& authenticode,
 	if (result.authenticode_format_errors.has_errors())
 		return;
 
-	result.cert_store = build_certificate_store(
-		authenticode, &result.certificate_store_warnings);
+	if (!raw_signature.empty())
+	{
+		try
+		{
+			result.lazy_cert_store = x509::build_lazy_certificate_store(
+				raw_signature, &result.certificate_store_warnings);
+		}
+		catch (const pe_error& e)
+		{
+			result.authenticode_format_errors.add_error(e.code());
+			return;
+		}
+	}
+	else
+	{
+		result.cert_store = build_certificate_store(
+			authenticode, &result.certificate_store_warnings);
+	}
+
 	verify_valid_format_authenticode(
 		authenticode, signer, authenticated_attributes,
 		instance, opts, result, unauthenticated_attributes);
 	result.signature = std::forward<Authenticode>(authenticode);
 }
 
-template<typename Authenticode>
+// See verify_authenticode for raw_signature description.
+// Nested signatures are verified using the lazy certificate store
+// if raw_signature is not empty and the signature references it (span_range_type).
+template<typename Authenticode, typename Image>
 [[nodiscard]]
 authenticode_check_status<typename std::remove_cvref_t<Authenticode>::range_type> verify_authenticode_full(
 	Authenticode&& authenticode,
-	const image::image& instance,
-	const authenticode_verification_options& opts = {})
+	const Image& instance,
+	const authenticode_verification_options& opts = {},
+	span_range_type raw_signature = {})
 {
 	using range_type = typename std::remove_cvref_t<Authenticode>::range_type;
 	authenticode_check_status<range_type> result;
 
+	//Nested signatures and timestamps are collected in a single pass
+	//over the root signer unauthenticated attributes. Nested signature
+	//attributes are decoded once by verify_authenticode.
+	//Invalid timestamp and nested signature attributes are reported
+	//by the corresponding stages and do not prevent the root signature check.
 	const auto& content_info = authenticode.get_content_info();
-	pkcs7::attribute_map<range_type> unauthenticated_attributes;
+	authenticode_unauthenticated_attributes unauthenticated_attributes;
 	if (content_info.data.signer_infos.size() == 1u)
 	{
 		const auto& signer = authenticode.get_signer(0u);
 		try
 		{
-			unauthenticated_attributes = signer.get_unauthenticated_attributes();
+			unauthenticated_attributes = decode_unauthenticated_attributes(
+				signer.get_unauthenticated_attributes());
 		}
 		catch (const pe_error& e)
 		{
@@ -196,14 +252,27 @@ authenticode_check_status<typename std::remove_cvref_t<Authenticode>::range_type
 
 	auto nested_signatures = load_nested_signatures<range_type>(unauthenticated_attributes);
 	result.nested.reserve(nested_signatures.size());
-	for (auto& nested_signature : nested_signatures)
+	for (std::size_t i = 0; i != nested_signatures.size(); ++i)
+	{
+		span_range_type raw_nested_signature;
+		if constexpr (std::is_same_v<range_type, span_range_type>)
+		{
+			if (!raw_signature.empty())
+				raw_nested_signature = unauthenticated_attributes.nested_signatures[i];
+		}
+
+		verify_authenticode(std::move(nested_signatures[i]),
+			instance, opts, result.nested.emplace_back(), nullptr, raw_nested_signature);
+	}
+
+	if (unauthenticated_attributes.nested_signatures_errc)
 	{
-		verify_authenticode(std::move(nested_signature),
-			instance, opts, result.nested.emplace_back());
+		result.nested.emplace_back().authenticode_format_errors.add_error(
+			unauthenticated_attributes.nested_signatures_errc);
 	}
 
 	verify_authenticode(std::forward<Authenticode>(authenticode), instance, opts,
-		result.root, &unauthenticated_attributes);
+		result.root, &unauthenticated_attributes, raw_signature);
 
 	return result;
 }
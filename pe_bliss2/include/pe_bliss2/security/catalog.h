@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "buffers/input_buffer_interface.h"
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+#include "pe_bliss2/security/pkcs7/signer_info.h"
+#include "pe_bliss2/security/signature_verifier.h"
+#include "pe_bliss2/security/x509/x509_lazy_certificate_store.h"
+
+namespace pe_bliss::security
+{
+
+enum class catalog_errc
+{
+	invalid_catalog_format = 1,
+	unsupported_content_type,
+	absent_signers,
+	invalid_signer_info,
+	invalid_member,
+	absent_member_digest,
+	absent_content_type,
+	invalid_content_type,
+	invalid_authenticated_attributes,
+	invalid_message_digest
+};
+
+std::error_code make_error_code(catalog_errc) noexcept;
+
+struct [[nodiscard]] catalog_member final
+{
+	//CTL subject identifier (usually the upper-case hex string of the digest
+	//in UTF-16LE, or the file name)
+	span_range_type tag;
+	digest_algorithm digest_alg{ digest_algorithm::unknown };
+	//Authenticode digest of the member file from SpcIndirectDataContent.
+	//Empty if the member does not have the SpcIndirectDataContent attribute.
+	span_range_type digest;
+};
+
+//Security catalog (.cat) file: PKCS#7 SignedData
+//with the CertificateTrustList content.
+//All ranges reference the catalog data, which is owned by the catalog.
+class [[nodiscard]] catalog final
+{
+public:
+	using signer_type = pkcs7::signer_info_pkcs7<span_range_type>;
+
+public:
+	[[nodiscard]]
+	const buffers::input_buffer_ptr& get_data() const noexcept
+	{
+		return data_;
+	}
+
+	[[nodiscard]]
+	buffers::input_buffer_ptr& get_data() noexcept
+	{
+		return data_;
+	}
+
+	//Contents of the CertificateTrustList SEQUENCE,
+	//which are covered by the signer message digest
+	[[nodiscard]]
+	span_range_type get_raw_signed_content() const noexcept
+	{
+		return raw_signed_content_;
+	}
+
+	void set_raw_signed_content(span_range_type raw_signed_content) noexcept
+	{
+		raw_signed_content_ = raw_signed_content;
+	}
+
+	[[nodiscard]]
+	const std::vector<signer_type>& get_signers() const noexcept
+	{
+		return signers_;
+	}
+
+	[[nodiscard]]
+	std::vector<signer_type>& get_signers() noexcept
+	{
+		return signers_;
+	}
+
+	[[nodiscard]]
+	const std::vector<catalog_member>& get_members() const noexcept
+	{
+		return members_;
+	}
+
+	[[nodiscard]]
+	std::vector<catalog_member>& get_members() noexcept
+	{
+		return members_;
+	}
+
+	[[nodiscard]]
+	const x509::x509_lazy_certificate_store& get_certificate_store() const noexcept
+	{
+		return cert_store_;
+	}
+
+	[[nodiscard]]
+	x509::x509_lazy_certificate_store& get_certificate_store() noexcept
+	{
+		return cert_store_;
+	}
+
+private:
+	buffers::input_buffer_ptr data_;
+	span_range_type raw_signed_content_;
+	std::vector<signer_type> signers_;
+	std::vector<catalog_member> members_;
+	x509::x509_lazy_certificate_store cert_store_;
+};
+
+//Parses the catalog in place if the buffer data is contiguous in memory,
+//otherwise copies the buffer data first. Certificates are indexed, but
+//not decoded. Members which can not be parsed are skipped
+//and reported as invalid_member warnings.
+//Throws pe_error if the catalog can not be parsed.
+[[nodiscard]]
+catalog load_catalog(const buffers::input_buffer_ptr& buffer,
+	error_list* warnings = nullptr);
+
+struct [[nodiscard]] catalog_check_status final
+{
+	error_list format_errors;
+	bool message_digest_valid{};
+	signature_verification_result signature_result;
+
+	[[nodiscard]]
+	explicit operator bool() const noexcept
+	{
+		return !format_errors.has_errors()
+			&& message_digest_valid
+			&& signature_result;
+	}
+};
+
+//Verifies the first catalog signer: content type and message digest
+//authenticated attributes, and the signature using the catalog certificates.
+//The signing certificate chain is not checked.
+[[nodiscard]]
+catalog_check_status verify_catalog(const catalog& instance,
+	signature_verification_cache* cache = nullptr);
+
+} //namespace pe_bliss::security
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::security::catalog_errc> : true_type {};
+} //namespace std
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/catalog.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+#include "pe_bliss2/security/image_hash.h"
+
+namespace pe_bliss::image { class image; }
+
+namespace pe_bliss::security
+{
+
+struct [[nodiscard]] catalog_lookup_result final
+{
+	const catalog* owner{};
+	const catalog_member* member{};
+
+	[[nodiscard]]
+	explicit operator bool() const noexcept
+	{
+		return member != nullptr;
+	}
+};
+
+//Hash index of member digests of many catalogs. Looking up an image
+//requires one image digest calculation and one hash table lookup
+//for each digest algorithm used by the catalogs.
+//Catalogs are expected to be verified (see verify_catalog) before they are added.
+//Lookup results are invalidated when a catalog is added.
+class [[nodiscard]] catalog_store final
+{
+public:
+	//If the same digest is present in several catalogs,
+	//the first added catalog is returned by lookups.
+	//Returns the number of added digests.
+	std::size_t add_catalog(catalog&& instance);
+
+	[[nodiscard]]
+	const std::vector<catalog>& get_catalogs() const noexcept
+	{
+		return catalogs_;
+	}
+
+	//Digest algorithms of the indexed members
+	[[nodiscard]]
+	const std::vector<digest_algorithm>& get_digest_algorithms() const noexcept
+	{
+		return digest_algorithms_;
+	}
+
+	[[nodiscard]]
+	std::size_t get_digest_count() const noexcept
+	{
+		return members_.size();
+	}
+
+	[[nodiscard]]
+	catalog_lookup_result find_member(digest_algorithm algorithm,
+		span_range_type digest) const;
+
+private:
+	struct member_key final
+	{
+		digest_algorithm algorithm;
+		span_range_type digest;
+	};
+
+	struct member_key_equal final
+	{
+		[[nodiscard]]
+		bool operator()(const member_key& l, const member_key& r) const noexcept;
+	};
+
+	struct member_key_hash final
+	{
+		[[nodiscard]]
+		std::size_t operator()(const member_key& key) const noexcept;
+	};
+
+	struct member_ref final
+	{
+		std::size_t catalog_index;
+		std::size_t member_index;
+	};
+
+private:
+	std::vector<catalog> catalogs_;
+	std::vector<digest_algorithm> digest_algorithms_;
+	std::unordered_map<member_key, member_ref,
+		member_key_hash, member_key_equal> members_;
+};
+
+//Calculates the image Authenticode digest for each of the catalog store
+//digest algorithms and looks it up in the store
+[[nodiscard]]
+catalog_lookup_result find_image_in_catalogs(const catalog_store& store,
+	const image::image& instance);
+
+//Same as above, but uses the digests calculated in a single pass
+//(see calculate_stream_hash). Algorithms which were not calculated are skipped.
+[[nodiscard]]
+catalog_lookup_result find_image_in_catalogs(const catalog_store& store,
+	const image_hash_stream_result& hashes);
+
+} //namespace pe_bliss::security
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+#include "pe_bliss2/security/byte_range_types.h"
+
+//Minimal DER reading and writing helpers for the structures which
+//are produced by the library itself (e.g., Authenticode signatures)
+//or are too small to be decoded using ASN.1 specifications.
+//Only definite-length single-byte tags are supported.
+namespace pe_bliss::security::der
+{
+
+namespace tag
+{
+inline constexpr std::byte boolean{ 0x01u };
+inline constexpr std::byte integer{ 0x02u };
+inline constexpr std::byte bit_string{ 0x03u };
+inline constexpr std::byte octet_string{ 0x04u };
+inline constexpr std::byte null{ 0x05u };
+inline constexpr std::byte object_identifier{ 0x06u };
+inline constexpr std::byte utc_time{ 0x17u };
+inline constexpr std::byte generalized_time{ 0x18u };
+inline constexpr std::byte sequence{ 0x30u };
+inline constexpr std::byte set{ 0x31u };
+
+[[nodiscard]]
+constexpr std::byte context_specific(std::uint8_t number, bool constructed) noexcept
+{
+	return std::byte{ static_cast<std::uint8_t>(0x80u
+		| (constructed ? 0x20u : 0u) | (number & 0x1fu)) };
+}
+} //namespace tag
+
+struct [[nodiscard]] element final
+{
+	std::byte tag{};
+	//Element contents
+	span_range_type value;
+	//Full element encoding, including the tag and the length
+	span_range_type raw;
+};
+
+//Reads the next element from data and advances data past it.
+//Returns false if the element is malformed.
+[[nodiscard]]
+bool read_element(span_range_type& data, element& result) noexcept;
+
+//Same as above, but also returns false if the element tag is not expected_tag
+[[nodiscard]]
+bool read_element(span_range_type& data, std::byte expected_tag,
+	element& result) noexcept;
+
+//Reads all child elements of the constructed element value.
+//Returns false if any of the elements is malformed.
+[[nodiscard]]
+bool read_children(span_range_type value, std::vector<element>& result);
+
+//Reads the serial number and issuer elements of the DER-encoded X.509 certificate
+//without decoding the rest of the certificate.
+//Returns false if the certificate is malformed.
+[[nodiscard]]
+bool read_certificate_issuer_and_serial_number(span_range_type certificate,
+	element& issuer, element& serial_number);
+
+//Decodes the object identifier element contents.
+//Returns false if the contents are malformed.
+[[nodiscard]]
+bool decode_oid(span_range_type value, std::vector<std::uint32_t>& result);
+
+void append_header(std::vector<std::byte>& result, std::byte tag, std::size_t length);
+
+[[nodiscard]]
+std::vector<std::byte> encode(std::byte tag,
+	std::initializer_list<span_range_type> contents);
+
+[[nodiscard]]
+std::vector<std::byte> encode(std::byte tag,
+	std::span<const span_range_type> contents);
+
+//Sorts the elements as required by DER for SET OF
+[[nodiscard]]
+std::vector<std::byte> encode_set_of(std::vector<std::vector<std::byte>> elements);
+
+[[nodiscard]]
+std::vector<std::byte> encode_oid(std::span<const std::uint32_t> oid);
+
+[[nodiscard]]
+std::vector<std::byte> encode_unsigned_integer(std::uint64_t value);
+
+//value is an unsigned big-endian integer
+[[nodiscard]]
+std::vector<std::byte> encode_unsigned_integer(span_range_type value);
+
+[[nodiscard]]
+std::vector<std::byte> encode_null();
+
+} //namespace pe_bliss::security::der
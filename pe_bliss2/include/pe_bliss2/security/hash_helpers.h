@@ -16,17 +16,37 @@ class HashTransformation;
 namespace pe_bliss::security
 {
 
+class page_hash_engine;
+
 enum class hash_helpers_errc
 {
 	unable_to_read_data = 1
 };
 
+struct [[nodiscard]] hash_read_options final
+{
+	//Data which can not be accessed directly is read in chunks of this size.
+	//The chunk buffer is allocated once per thread and reused.
+	std::size_t chunk_size{ 1024u * 1024u }; //1 Mb
+	//Advise the OS that contiguous data of at least chunk_size bytes
+	//will be read sequentially (see advise_sequential_read).
+	//Only file-mapped inputs (buffers::input_file_mapping_buffer) act on the hint,
+	//stream-backed data gets no read-ahead hint.
+	bool prefetch{ true };
+};
+
 class page_hash_state final
 {
 public:
 	explicit page_hash_state(CryptoPP::HashTransformation& hash,
 		std::size_t page_size) noexcept;
 
+	//If the engine is multi-buffer, pages are buffered and hashed
+	//in batches of page_hash_engine::max_lanes pages.
+	//Otherwise, pages are hashed in place by the generic engine hash.
+	explicit page_hash_state(page_hash_engine& engine,
+		std::size_t page_size);
+
 	void update(const std::byte* data, std::size_t offset, std::size_t size);
 
 	void next_page();
@@ -34,17 +54,26 @@ public:
 	void add_skipped_bytes(std::size_t skipped_bytes);
 
 	[[nodiscard]]
-	std::vector<std::byte> get_page_hashes() && noexcept;
+	std::vector<std::byte> get_page_hashes() &&;
 
 	void reserve(std::size_t size);
 
 private:
 	std::byte* add_blank_page(std::size_t offset);
+	void append(const std::byte* data, std::size_t size);
+	void flush_batch();
+
+	[[nodiscard]]
+	std::size_t get_digest_size() const;
 
 private:
-	CryptoPP::HashTransformation& hash_;
+	CryptoPP::HashTransformation* hash_{};
+	page_hash_engine* engine_{};
 	std::vector<std::byte> page_hashes_;
 	const std::size_t page_size_;
+	std::vector<std::byte> batch_;
+	std::vector<std::size_t> batch_page_sizes_;
+	std::size_t batch_first_page_pos_{};
 	std::size_t current_size_{};
 	std::size_t next_page_offset_{};
 	std::size_t skipped_bytes_{};
@@ -54,13 +83,16 @@ private:
 std::error_code make_error_code(hash_helpers_errc) noexcept;
 
 void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	CryptoPP::HashTransformation& hash);
+	CryptoPP::HashTransformation& hash,
+	const hash_read_options& options = {});
 
 void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	page_hash_state& state);
+	page_hash_state& state,
+	const hash_read_options& options = {});
 
 void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	CryptoPP::HashTransformation& hash, std::optional<page_hash_state>& state);
+	CryptoPP::HashTransformation& hash, std::optional<page_hash_state>& state,
+	const hash_read_options& options = {});
 
 } //namespace pe_bliss::security
 
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <exception>
+#include <istream>
 #include <optional>
 
+#include "buffers/input_buffer_interface.h"
 #include "pe_bliss2/security/authenticode_check_status.h"
 #include "pe_bliss2/security/authenticode_verification_options.h"
 #include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/image_hash.h"
 #include "pe_bliss2/security/security_directory.h"
 
 namespace pe_bliss::image { class image; }
@@ -17,6 +20,18 @@ struct [[nodiscard]] image_authenticode_check_status
 {
 	authenticode_check_status<span_range_type> authenticode_status;
 	std::exception_ptr error;
+	//Signature data referenced by authenticode_status: either the original
+	//image buffer section, or the copy of the signature if the image buffer
+	//is not contiguous in memory
+	buffers::input_buffer_ptr signature_data;
+};
+
+struct [[nodiscard]] image_authenticode_stream_check_status
+{
+	//Owns the security directory data referenced by check_status
+	image_hash_stream_result hashes;
+	//Empty if the image is not signed
+	std::optional<image_authenticode_check_status> check_status;
 };
 
 [[nodiscard]]
@@ -31,4 +46,19 @@ std::optional<image_authenticode_check_status> verify_authenticode(
 	const security_directory_base<Bases...>& sec_dir,
 	const authenticode_verification_options& opts = {});
 
+//Verifies the signature reading the image file sequentially exactly once,
+//without loading the image (see calculate_stream_hash). The signature digest
+//algorithm must be one of stream_opts.algorithms, otherwise
+//invalid_image_format_for_hashing error is reported.
+[[nodiscard]]
+image_authenticode_stream_check_status verify_authenticode(std::istream& stream,
+	const authenticode_verification_options& opts = {},
+	const image_hash_stream_options& stream_opts = {});
+
+[[nodiscard]]
+image_authenticode_stream_check_status verify_authenticode(
+	buffers::input_buffer_interface& buffer,
+	const authenticode_verification_options& opts = {},
+	const image_hash_stream_options& stream_opts = {});
+
 } //namespace pe_bliss::security
@@ -1,13 +1,20 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
 #include <optional>
 #include <system_error>
 #include <type_traits>
 #include <vector>
 
+#include "buffers/input_buffer_interface.h"
+#include "buffers/input_container_buffer.h"
 #include "pe_bliss2/security/byte_range_types.h"
 #include "pe_bliss2/security/crypto_algorithms.h"
+#include "pe_bliss2/security/hash_helpers.h"
+#include "pe_bliss2/security/page_hash_engine.h"
 
 namespace pe_bliss::image { class image; }
 
@@ -21,7 +28,19 @@ enum class hash_calculator_errc
 	page_hashes_data_too_big
 };
 
+enum class image_hash_stream_errc
+{
+	headers_too_big = 1,
+	security_directory_too_big,
+	security_directory_not_at_end,
+	overlapping_sections,
+	page_hashes_not_calculated,
+	digest_not_calculated,
+	page_size_mismatch
+};
+
 std::error_code make_error_code(hash_calculator_errc) noexcept;
+std::error_code make_error_code(image_hash_stream_errc) noexcept;
 
 struct [[nodiscard]] image_hash_result
 {
@@ -34,12 +53,16 @@ struct [[nodiscard]] page_hash_options final
 {
 	digest_algorithm algorithm{ digest_algorithm::unknown };
 	std::size_t max_page_hashes_size { 10u * 1024u * 1024u }; //10 Mb
+	//Zero means the memory page size of the image machine type
+	std::size_t page_size{};
+	page_hash_engine_type engine_type{ page_hash_engine_type::automatic };
 };
 
 [[nodiscard]]
 image_hash_result calculate_hash(digest_algorithm algorithm,
 	const pe_bliss::image::image& instance,
-	const page_hash_options* page_hash_opts = nullptr);
+	const page_hash_options* page_hash_opts = nullptr,
+	const hash_read_options& read_opts = {});
 
 struct [[nodiscard]] image_hash_verification_result
 {
@@ -62,10 +85,75 @@ image_hash_verification_result verify_image_hash(span_range_type image_hash,
 	const std::optional<span_range_type>& page_hashes,
 	const std::optional<page_hash_options>& page_hash_options);
 
+struct [[nodiscard]] image_hash_stream_options final
+{
+	//The signature digest algorithm is not known until the security directory
+	//(which is usually at the end of the file) is read, so all digests
+	//which may be required are calculated in a single pass
+	std::vector<digest_algorithm> algorithms{
+		digest_algorithm::sha1, digest_algorithm::sha256 };
+	bool calculate_page_hashes = true;
+	std::size_t max_page_hashes_size{ 10u * 1024u * 1024u }; //10 Mb
+	//Zero means the memory page size of the image machine type
+	std::size_t page_size{};
+	page_hash_engine_type engine_type{ page_hash_engine_type::automatic };
+	//The section table is not counted, so that images with
+	//many sections are not rejected
+	std::size_t max_headers_size{ 1024u * 1024u }; //1 Mb
+	std::size_t max_security_directory_size{ 16u * 1024u * 1024u }; //16 Mb
+	std::size_t read_buffer_size{ 64u * 1024u }; //64 Kb
+};
+
+struct [[nodiscard]] image_hash_stream_digest final
+{
+	digest_algorithm algorithm{ digest_algorithm::unknown };
+	image_hash_result hash;
+};
+
+struct [[nodiscard]] image_hash_stream_result final
+{
+	std::vector<image_hash_stream_digest> digests;
+	//Security directory data. Buffer absolute offset is equal to
+	//the security directory file offset. Null if the image has no security directory.
+	std::shared_ptr<buffers::input_container_buffer> security_directory;
+	//Page size used to calculate page hashes
+	std::size_t page_size{};
+
+	[[nodiscard]]
+	const image_hash_stream_digest* find_digest(
+		digest_algorithm algorithm) const noexcept;
+};
+
+//Calculates image digests and page hashes reading the image file sequentially
+//exactly once: headers, then section data in raw offset order, then overlay.
+//Only the headers and the security directory are kept in memory.
+//Works with non-seekable streams (pipes). The security directory
+//must be the last one in the file. If the image has no security directory,
+//the digest is calculated up to the end of file.
+[[nodiscard]]
+image_hash_stream_result calculate_stream_hash(std::istream& stream,
+	const image_hash_stream_options& options = {});
+
+//Same as above, but reads the buffer. Contiguous buffers (e.g. memory mapped files)
+//are hashed without copying.
+[[nodiscard]]
+image_hash_stream_result calculate_stream_hash(buffers::input_buffer_interface& buffer,
+	const image_hash_stream_options& options = {});
+
+//Page hashes can not be recalculated, so page_hash_options are checked
+//against the options the stream hashes were calculated with
+[[nodiscard]]
+image_hash_verification_result verify_image_hash(span_range_type image_hash,
+	digest_algorithm digest_alg, const image_hash_stream_result& hashes,
+	const std::optional<span_range_type>& page_hashes,
+	const std::optional<page_hash_options>& page_hash_options);
+
 } //namespace pe_bliss::security
 
 namespace std
 {
 template<>
 struct is_error_code_enum<pe_bliss::security::hash_calculator_errc> : true_type {};
+template<>
+struct is_error_code_enum<pe_bliss::security::image_hash_stream_errc> : true_type {};
 } //namespace std
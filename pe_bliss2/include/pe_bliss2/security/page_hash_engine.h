@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+
+namespace CryptoPP
+{
+class HashTransformation;
+} //namespace CryptoPP
+
+namespace pe_bliss::security
+{
+
+enum class page_hash_engine_type
+{
+	//Multi-buffer implementation is used if it is supported and
+	//is expected to be faster than the generic one
+	automatic,
+	//CryptoPP, one message at a time
+	//(uses SHA extensions, if they are supported by the CPU)
+	generic,
+	//Hashes up to max_lanes messages of the same size simultaneously
+	//(AVX2, SHA-1 and SHA-256 only). Falls back to generic if not supported.
+	multi_buffer
+};
+
+//Calculates digests of many independent messages (e.g., image pages)
+class [[nodiscard]] page_hash_engine final
+{
+public:
+	static constexpr std::size_t max_lanes = 8u;
+
+public:
+	//Throws pe_error with buffer_hash_errc::unsupported_hash_algorithm
+	//if the algorithm is not supported
+	explicit page_hash_engine(digest_algorithm algorithm,
+		page_hash_engine_type type = page_hash_engine_type::automatic);
+	~page_hash_engine();
+
+	page_hash_engine(const page_hash_engine&) = delete;
+	page_hash_engine& operator=(const page_hash_engine&) = delete;
+
+	[[nodiscard]]
+	digest_algorithm get_algorithm() const noexcept
+	{
+		return algorithm_;
+	}
+
+	[[nodiscard]]
+	std::size_t get_digest_size() const noexcept
+	{
+		return digest_size_;
+	}
+
+	[[nodiscard]]
+	bool is_multi_buffer() const noexcept
+	{
+		return multi_buffer_;
+	}
+
+	//Hash used for messages, which are not hashed by the multi-buffer implementation
+	[[nodiscard]]
+	CryptoPP::HashTransformation& get_generic_hash() noexcept
+	{
+		return *hash_;
+	}
+
+	//Writes the digest of messages[i] to digests + i * digest_stride.
+	//Messages of the same size are hashed together by the multi-buffer implementation.
+	void calculate(std::span<const span_range_type> messages,
+		std::byte* digests, std::size_t digest_stride);
+
+	[[nodiscard]]
+	static bool is_multi_buffer_supported(digest_algorithm algorithm) noexcept;
+
+private:
+	digest_algorithm algorithm_;
+	std::unique_ptr<CryptoPP::HashTransformation> hash_;
+	std::size_t digest_size_{};
+	bool multi_buffer_{};
+};
+
+} //namespace pe_bliss::security
@@ -8,6 +8,11 @@
 
 #include "pe_bliss2/security/crypto_algorithms.h"
 
+namespace pe_bliss::security
+{
+class signature_verification_cache;
+} //namespace pe_bliss::security
+
 namespace pe_bliss::security::pkcs7
 {
 
@@ -64,13 +69,16 @@ struct signature_verification_result
 	bool operator==(const signature_verification_result&) const noexcept = default;
 };
 
+//If cache is not null, decoded public keys and verification results
+//are looked up in and stored to the cache.
 [[nodiscard]]
 signature_verification_result verify_signature(std::span<const std::byte> raw_public_key,
 	std::span<const std::byte> message_digest,
 	std::span<const std::byte> encrypted_digest,
 	digest_algorithm digest_alg,
 	digest_encryption_algorithm encryption_alg,
-	std::span<const std::byte> signature_algorithm_parameters);
+	std::span<const std::byte> signature_algorithm_parameters,
+	signature_verification_cache* cache = nullptr);
 
 } //namespace pe_bliss::security::pkcs7
 
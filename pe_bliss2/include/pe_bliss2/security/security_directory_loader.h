@@ -5,6 +5,8 @@
 #include <system_error>
 #include <type_traits>
 
+#include "buffers/input_buffer_interface.h"
+
 #include "pe_bliss2/security/security_directory.h"
 
 namespace pe_bliss::image
@@ -31,6 +33,11 @@ std::error_code make_error_code(security_directory_loader_errc) noexcept;
 struct [[nodiscard]] loader_options
 {
 	bool copy_raw_data = false;
+	//If copy_raw_data is false, certificates which are not contiguous in memory
+	//(e.g., when the image is read from a stream) are still copied,
+	//so that they can be parsed in place without copying the whole overlay
+	//(see load_authenticode_signature).
+	bool copy_non_contiguous_raw_data = true;
 	std::uint32_t max_entries = 10u;
 };
 
@@ -38,6 +45,14 @@ struct [[nodiscard]] loader_options
 std::optional<security_directory_details> load(const image::image& instance,
 	const loader_options& options = {});
 
+//Loads the security directory from the buffer which contains
+//the directory data only (for example, read separately from the image file,
+//see calculate_stream_hash in image_hash.h). The buffer absolute offset must be equal to
+//the security directory file offset.
+[[nodiscard]]
+security_directory_details load(const buffers::input_buffer_ptr& directory_data,
+	const loader_options& options = {});
+
 } //namespace pe_bliss::security
 
 namespace std
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "pe_bliss2/security/pkcs7/pkcs7_signature.h"
+
+namespace pe_bliss::security
+{
+
+namespace pkcs7
+{
+struct decoded_public_key;
+} //namespace pkcs7
+
+//Thread-safe cache of decoded signer public keys and
+//signature verification results, which can be shared
+//across many verified files (see authenticode_verification_options).
+//Entries are keyed by SHA-256 hashes of the public key (and algorithm parameters)
+//and of the (public key, message digest, encrypted digest, digest algorithm) tuple.
+//When a map grows past max_entries, it is cleared.
+class [[nodiscard]] signature_verification_cache final
+{
+public:
+	using hash_type = std::array<std::byte, 32u>;
+	using public_key_ptr_type = std::shared_ptr<const pkcs7::decoded_public_key>;
+
+	static constexpr std::size_t default_max_entries = 4096u;
+
+	struct [[nodiscard]] statistics final
+	{
+		std::size_t public_key_hits{};
+		std::size_t public_key_misses{};
+		std::size_t result_hits{};
+		std::size_t result_misses{};
+	};
+
+public:
+	explicit signature_verification_cache(
+		std::size_t max_entries = default_max_entries) noexcept;
+
+	signature_verification_cache(const signature_verification_cache&) = delete;
+	signature_verification_cache& operator=(const signature_verification_cache&) = delete;
+
+	[[nodiscard]]
+	public_key_ptr_type find_public_key(const hash_type& key_hash) const;
+	void add_public_key(const hash_type& key_hash, public_key_ptr_type key);
+
+	[[nodiscard]]
+	std::optional<pkcs7::signature_verification_result> find_result(
+		const hash_type& signature_hash) const;
+	void add_result(const hash_type& signature_hash,
+		const pkcs7::signature_verification_result& result);
+
+	[[nodiscard]]
+	statistics get_statistics() const noexcept;
+
+	void clear();
+
+	[[nodiscard]]
+	std::size_t get_max_entries() const noexcept
+	{
+		return max_entries_;
+	}
+
+private:
+	struct hash_hasher final
+	{
+		[[nodiscard]]
+		std::size_t operator()(const hash_type& hash) const noexcept;
+	};
+
+	template<typename Value>
+	using map_type = std::unordered_map<hash_type, Value, hash_hasher>;
+
+private:
+	std::size_t max_entries_;
+	mutable std::shared_mutex mutex_;
+	map_type<public_key_ptr_type> public_keys_;
+	map_type<pkcs7::signature_verification_result> results_;
+	mutable std::atomic<std::size_t> public_key_hits_{};
+	mutable std::atomic<std::size_t> public_key_misses_{};
+	mutable std::atomic<std::size_t> result_hits_{};
+	mutable std::atomic<std::size_t> result_misses_{};
+};
+
+} //namespace pe_bliss::security
@@ -8,8 +8,10 @@
 #include "pe_bliss2/security/pkcs7/pkcs7.h"
 #include "pe_bliss2/security/pkcs7/pkcs7_signature.h"
 #include "pe_bliss2/security/pkcs7/signer_info.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
 #include "pe_bliss2/security/x509/x509_certificate.h"
 #include "pe_bliss2/security/x509/x509_certificate_store.h"
+#include "pe_bliss2/security/x509/x509_lazy_certificate_store.h"
 
 namespace pe_bliss::security
 {
@@ -52,10 +54,11 @@ struct [[nodiscard]] signature_verification_result
 
 namespace impl
 {
-template<typename Signer, typename Cert>
+template<typename Signer, typename CertStore>
 signature_verification_result verify_signature_impl(
 	const Signer& signer,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const CertStore& cert_store,
+	signature_verification_cache* cache)
 {
 	signature_verification_result result;
 
@@ -67,17 +70,18 @@ signature_verification_result verify_signature_impl(
 		return result;
 	}
 
-	const auto* signing_cert = cert_store.find_certificate(
-		*issuer_and_sn.serial_number,
-		*issuer_and_sn.issuer);
-	if (!signing_cert)
-	{
-		result.errors.add_error(signature_verifier_errc::absent_signing_cert);
-		return result;
-	}
-
 	try
 	{
+		//Lazy certificate store may throw if the certificate can not be decoded
+		const auto* signing_cert = cert_store.find_certificate(
+			*issuer_and_sn.serial_number,
+			*issuer_and_sn.issuer);
+		if (!signing_cert)
+		{
+			result.errors.add_error(signature_verifier_errc::absent_signing_cert);
+			return result;
+		}
+
 		span_range_type signature_algorithm_parameters;
 		if (const auto& params = signing_cert->get_signature_algorithm_parameters(); params)
 			signature_algorithm_parameters = *params;
@@ -88,7 +92,7 @@ signature_verification_result verify_signature_impl(
 			signer.get_encrypted_digest(),
 			signer.get_digest_algorithm(),
 			signer.get_digest_encryption_algorithm().encryption_alg,
-			signature_algorithm_parameters);
+			signature_algorithm_parameters, cache);
 	}
 	catch (const std::exception&)
 	{
@@ -102,17 +106,37 @@ signature_verification_result verify_signature_impl(
 template<typename RangeType1, typename Cert>
 signature_verification_result verify_signature(
 	const pkcs7::signer_info_ref_pkcs7<RangeType1>& signer,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const x509::x509_certificate_store<Cert>& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
-	return impl::verify_signature_impl(signer, cert_store);
+	return impl::verify_signature_impl(signer, cert_store, cache);
 }
 
 template<typename RangeType1, typename Cert>
 signature_verification_result verify_signature(
 	const pkcs7::signer_info_ref_cms<RangeType1>& signer,
-	const x509::x509_certificate_store<Cert>& cert_store)
+	const x509::x509_certificate_store<Cert>& cert_store,
+	signature_verification_cache* cache = nullptr)
+{
+	return impl::verify_signature_impl(signer, cert_store, cache);
+}
+
+template<typename RangeType1>
+signature_verification_result verify_signature(
+	const pkcs7::signer_info_ref_pkcs7<RangeType1>& signer,
+	const x509::x509_lazy_certificate_store& cert_store,
+	signature_verification_cache* cache = nullptr)
+{
+	return impl::verify_signature_impl(signer, cert_store, cache);
+}
+
+template<typename RangeType1>
+signature_verification_result verify_signature(
+	const pkcs7::signer_info_ref_cms<RangeType1>& signer,
+	const x509::x509_lazy_certificate_store& cert_store,
+	signature_verification_cache* cache = nullptr)
 {
-	return impl::verify_signature_impl(signer, cert_store);
+	return impl::verify_signature_impl(signer, cert_store, cache);
 }
 
 } //namespace pe_bliss::security
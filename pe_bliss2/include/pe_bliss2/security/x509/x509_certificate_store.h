@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <ranges>
 #include <unordered_map>
 #include <utility>
 
@@ -59,6 +60,13 @@ public:
 		return &it->second;
 	}
 
+	//Returns a view of all certificates in the store (in unspecified order)
+	[[nodiscard]]
+	auto get_certificates() const noexcept
+	{
+		return std::views::values(serial_number_to_certificate_);
+	}
+
 	[[nodiscard]]
 	std::size_t size() const noexcept
 	{
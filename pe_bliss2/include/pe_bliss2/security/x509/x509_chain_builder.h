@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/buffer_hash.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/pkcs7/pkcs7_signature.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
+#include "pe_bliss2/security/x509/x509_certificate_store.h"
+#include "pe_bliss2/security/x509/x509_extensions.h"
+
+namespace pe_bliss::security::x509
+{
+
+enum class x509_chain_errc
+{
+	issuer_not_found = 1,
+	untrusted_root,
+	chain_too_long,
+	certificate_not_yet_valid,
+	certificate_expired,
+	invalid_certificate_signature,
+	unable_to_verify_certificate_signature,
+	issuer_is_not_ca,
+	path_length_exceeded
+};
+
+} //namespace pe_bliss::security::x509
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::security::x509::x509_chain_errc> : true_type {};
+} //namespace std
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_chain_errc) noexcept;
+
+struct [[nodiscard]] x509_chain_options final
+{
+	//Validity periods of all chain certificates are checked against this time
+	//(usually, the timestamp or signing time). Not checked if absent.
+	std::optional<std::chrono::sys_seconds> validation_time;
+	std::size_t max_length = 16u;
+	signature_verification_cache* verification_cache = nullptr;
+};
+
+template<typename Certificate, typename TrustedCertificate>
+struct [[nodiscard]] x509_chain final
+{
+	//Starts with the leaf certificate, does not include the trusted root
+	std::vector<const Certificate*> certificates;
+	const TrustedCertificate* root = nullptr;
+	//Error contexts are indexes of the certificates in the chain,
+	//the root has index certificates.size()
+	error_list errors;
+
+	[[nodiscard]]
+	bool is_trusted() const noexcept
+	{
+		return root && !errors.has_errors();
+	}
+};
+
+namespace impl
+{
+enum class link_status
+{
+	valid,
+	invalid,
+	unable_to_verify
+};
+
+template<typename Certificate, typename Issuer>
+[[nodiscard]]
+bool is_issuer(const Certificate& cert, const Issuer& issuer)
+{
+	if (!std::ranges::equal(cert.get_raw_issuer(), issuer.get_raw_subject()))
+		return false;
+
+	const auto authority_key_id = cert.get_authority_key_identifier();
+	if (!authority_key_id)
+		return true;
+
+	const auto subject_key_id = issuer.get_subject_key_identifier();
+	return !subject_key_id || std::ranges::equal(*authority_key_id, *subject_key_id);
+}
+
+//Checks that the issuer is a CA certificate which may sign certificates
+//(basicConstraints cA=TRUE, keyUsage keyCertSign if present), and that
+//its pathLenConstraint allows ca_count intermediate CA certificates below it.
+//Trust anchors without basicConstraints (X.509 v1 roots) are accepted.
+template<typename Issuer>
+[[nodiscard]]
+std::optional<x509_chain_errc> check_ca(const Issuer& issuer,
+	std::size_t ca_count, bool is_anchor)
+{
+	const auto& constraints = issuer.get_basic_constraints();
+	if (constraints ? !constraints->ca : !is_anchor)
+		return x509_chain_errc::issuer_is_not_ca;
+
+	if (const auto usage = issuer.get_key_usage();
+		usage && !(*usage & key_usage::key_cert_sign))
+	{
+		return x509_chain_errc::issuer_is_not_ca;
+	}
+
+	if (constraints && constraints->path_length
+		&& *constraints->path_length < ca_count)
+	{
+		return x509_chain_errc::path_length_exceeded;
+	}
+
+	return {};
+}
+
+template<typename Certificate, typename Issuer>
+[[nodiscard]]
+link_status verify_link(const Certificate& cert, const Issuer& issuer,
+	signature_verification_cache* cache)
+{
+	try
+	{
+		const auto tbs_certificate = cert.get_raw_tbs_certificate();
+		const auto hash_alg = cert.get_signature_algorithm().hash_alg;
+		if (!tbs_certificate || !hash_alg)
+			return link_status::unable_to_verify;
+
+		const auto digest = calculate_hash(*hash_alg,
+			std::array<span_range_type, 1u>{ *tbs_certificate });
+
+		span_range_type public_key_parameters;
+		if (const auto& params = issuer.get_signature_algorithm_parameters(); params)
+			public_key_parameters = *params;
+
+		return pkcs7::verify_signature(issuer.get_public_key(), digest,
+			cert.get_signature_value(), *hash_alg,
+			issuer.get_public_key_algorithm().encryption_alg,
+			public_key_parameters, cache)
+			? link_status::valid : link_status::invalid;
+	}
+	catch (const std::exception&)
+	{
+		return link_status::unable_to_verify;
+	}
+}
+
+template<typename Candidate>
+struct [[nodiscard]] issuer_search_result final
+{
+	const Candidate* issuer = nullptr;
+	link_status status = link_status::unable_to_verify;
+	//Set if there is no issuer, but some candidates were rejected by check_ca
+	std::optional<x509_chain_errc> rejection;
+};
+
+//Returns the first CA candidate with a valid signature link,
+//or the first CA candidate with a matching name if there is none
+template<typename Certificate, typename Candidates, typename Chain>
+[[nodiscard]]
+auto find_issuer(const Certificate& cert, const Candidates& candidates,
+	const Chain& chain, bool is_anchor, signature_verification_cache* cache)
+{
+	using candidate_type = std::remove_cvref_t<decltype(*std::ranges::begin(candidates))>;
+	issuer_search_result<candidate_type> result;
+	//Intermediate CA certificates below the issuer (the leaf is not counted)
+	const auto ca_count = std::ranges::size(chain) - 1u;
+	for (const auto& candidate : candidates)
+	{
+		if constexpr (std::is_same_v<candidate_type, Certificate>)
+		{
+			if (std::ranges::find(chain, &candidate) != std::ranges::end(chain))
+				continue;
+		}
+
+		if (!is_issuer(cert, candidate))
+			continue;
+
+		if (const auto rejection = check_ca(candidate, ca_count, is_anchor); rejection)
+		{
+			if (!result.rejection)
+				result.rejection = rejection;
+			continue;
+		}
+
+		const auto status = verify_link(cert, candidate, cache);
+		if (status == link_status::valid)
+			return issuer_search_result<candidate_type>{ .issuer = &candidate, .status = status };
+
+		if (!result.issuer)
+			result = { .issuer = &candidate, .status = status };
+	}
+
+	if (result.issuer)
+		result.rejection.reset();
+	return result;
+}
+
+inline void add_link_errors(link_status status, std::size_t index, error_list& errors)
+{
+	if (status == link_status::invalid)
+		errors.add_error(x509_chain_errc::invalid_certificate_signature, index);
+	else if (status == link_status::unable_to_verify)
+		errors.add_error(x509_chain_errc::unable_to_verify_certificate_signature, index);
+}
+
+template<typename Certificate>
+void check_validity(const Certificate& cert, std::size_t index,
+	const x509_chain_options& options, error_list& errors)
+{
+	if (!options.validation_time)
+		return;
+
+	if (*options.validation_time < cert.get_not_before())
+		errors.add_error(x509_chain_errc::certificate_not_yet_valid, index);
+	else if (cert.get_not_after() < *options.validation_time)
+		errors.add_error(x509_chain_errc::certificate_expired, index);
+}
+} //namespace impl
+
+//Builds the chain from the leaf certificate up to one of the trusted anchors.
+//Issuers are looked up by raw subject name (and key identifiers, if present)
+//among the anchors first, then among the intermediate certificates
+//(which usually come from the signature certificate store).
+//Issuers must be CA certificates (see impl::check_ca).
+//Each link signature is verified with the issuer public key.
+template<typename Certificate, typename TrustedCertificate>
+[[nodiscard]]
+x509_chain<Certificate, TrustedCertificate> build_certificate_chain(
+	const Certificate& leaf,
+	const x509_certificate_store<Certificate>& intermediates,
+	const x509_certificate_store<TrustedCertificate>& anchors,
+	const x509_chain_options& options = {})
+{
+	x509_chain<Certificate, TrustedCertificate> result;
+	const Certificate* current = &leaf;
+	while (true)
+	{
+		const auto index = result.certificates.size();
+		result.certificates.push_back(current);
+		impl::check_validity(*current, index, options, result.errors);
+
+		const auto root = impl::find_issuer(*current, anchors.get_certificates(),
+			result.certificates, true, options.verification_cache);
+		if (root.issuer)
+		{
+			result.root = root.issuer;
+			impl::add_link_errors(root.status, index, result.errors);
+			impl::check_validity(*root.issuer, index + 1u, options, result.errors);
+			return result;
+		}
+
+		if (std::ranges::equal(current->get_raw_issuer(), current->get_raw_subject()))
+		{
+			result.errors.add_error(x509_chain_errc::untrusted_root, index);
+			return result;
+		}
+
+		const auto issuer = impl::find_issuer(*current, intermediates.get_certificates(),
+			result.certificates, false, options.verification_cache);
+		if (!issuer.issuer)
+		{
+			result.errors.add_error(root.rejection ? *root.rejection
+				: issuer.rejection.value_or(x509_chain_errc::issuer_not_found), index);
+			return result;
+		}
+
+		impl::add_link_errors(issuer.status, index, result.errors);
+		if (result.certificates.size() >= options.max_length)
+		{
+			result.errors.add_error(x509_chain_errc::chain_too_long);
+			return result;
+		}
+
+		current = issuer.issuer;
+	}
+}
+
+} //namespace pe_bliss::security::x509
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+#include "pe_bliss2/security/x509/x509_extensions.h"
+
+namespace pe_bliss::security::x509
+{
+
+enum class x509_der_certificate_errc
+{
+	invalid_certificate = 1,
+	invalid_validity,
+	invalid_extension
+};
+
+} //namespace pe_bliss::security::x509
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::security::x509::x509_der_certificate_errc> : true_type {};
+} //namespace std
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_der_certificate_errc) noexcept;
+
+//X.509 certificate fields which are required to look up the certificate
+//and to build and verify certificate chains. The fields are read from
+//the DER-encoded certificate with a shallow DER scan (only the extensions
+//used by the chain builder are decoded).
+//Certificate data is referenced and must outlive the certificate.
+class [[nodiscard]] x509_der_certificate final
+{
+public:
+	using range_type = span_range_type;
+
+public:
+	//Throws pe_error if the certificate is malformed
+	explicit x509_der_certificate(span_range_type data);
+
+	[[nodiscard]]
+	span_range_type get_raw_data() const noexcept
+	{
+		return data_;
+	}
+
+	//DER-encoded TBSCertificate, which is signed by the issuer
+	[[nodiscard]]
+	std::optional<span_range_type> get_raw_tbs_certificate() const noexcept
+	{
+		return raw_tbs_certificate_;
+	}
+
+	[[nodiscard]]
+	const range_type& get_serial_number() const noexcept
+	{
+		return serial_number_;
+	}
+
+	[[nodiscard]]
+	const range_type& get_raw_issuer() const noexcept
+	{
+		return raw_issuer_;
+	}
+
+	[[nodiscard]]
+	const range_type& get_raw_subject() const noexcept
+	{
+		return raw_subject_;
+	}
+
+	[[nodiscard]]
+	std::chrono::sys_seconds get_not_before() const noexcept
+	{
+		return not_before_;
+	}
+
+	[[nodiscard]]
+	std::chrono::sys_seconds get_not_after() const noexcept
+	{
+		return not_after_;
+	}
+
+	//Algorithm the issuer used to sign this certificate
+	[[nodiscard]]
+	encryption_and_hash_algorithm get_signature_algorithm() const noexcept
+	{
+		return signature_algorithm_;
+	}
+
+	[[nodiscard]]
+	const range_type& get_signature_value() const noexcept
+	{
+		return signature_value_;
+	}
+
+	[[nodiscard]]
+	const range_type& get_public_key() const noexcept
+	{
+		return public_key_;
+	}
+
+	//DER-encoded parameters of the subject public key algorithm
+	[[nodiscard]]
+	const std::optional<range_type>& get_signature_algorithm_parameters() const noexcept
+	{
+		return public_key_parameters_;
+	}
+
+	[[nodiscard]]
+	encryption_and_hash_algorithm get_public_key_algorithm() const noexcept
+	{
+		return public_key_algorithm_;
+	}
+
+	//Empty if the certificate has no basicConstraints extension
+	[[nodiscard]]
+	const std::optional<x509_basic_constraints>& get_basic_constraints() const noexcept
+	{
+		return basic_constraints_;
+	}
+
+	//Combination of key_usage flags.
+	//Empty if the certificate has no keyUsage extension.
+	[[nodiscard]]
+	std::optional<std::uint32_t> get_key_usage() const noexcept
+	{
+		return key_usage_;
+	}
+
+	[[nodiscard]]
+	std::optional<span_range_type> get_subject_key_identifier() const noexcept
+	{
+		return subject_key_identifier_;
+	}
+
+	[[nodiscard]]
+	std::optional<span_range_type> get_authority_key_identifier() const noexcept
+	{
+		return authority_key_identifier_;
+	}
+
+private:
+	void read_extensions(span_range_type extensions);
+
+private:
+	span_range_type data_;
+	span_range_type raw_tbs_certificate_;
+	range_type serial_number_;
+	range_type raw_issuer_;
+	range_type raw_subject_;
+	std::chrono::sys_seconds not_before_{};
+	std::chrono::sys_seconds not_after_{};
+	encryption_and_hash_algorithm signature_algorithm_;
+	range_type signature_value_;
+	range_type public_key_;
+	std::optional<range_type> public_key_parameters_;
+	encryption_and_hash_algorithm public_key_algorithm_;
+	std::optional<x509_basic_constraints> basic_constraints_;
+	std::optional<std::uint32_t> key_usage_;
+	std::optional<span_range_type> subject_key_identifier_;
+	std::optional<span_range_type> authority_key_identifier_;
+};
+
+} //namespace pe_bliss::security::x509
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "pe_bliss2/security/byte_range_types.h"
+
+namespace pe_bliss::security::x509
+{
+
+inline constexpr std::array<std::uint32_t, 4u> oid_key_usage{ 2, 5, 29, 15 };
+inline constexpr std::array<std::uint32_t, 4u> oid_basic_constraints{ 2, 5, 29, 19 };
+
+struct [[nodiscard]] x509_basic_constraints final
+{
+	bool ca = false;
+	std::optional<std::uint32_t> path_length;
+
+	friend bool operator==(const x509_basic_constraints&,
+		const x509_basic_constraints&) noexcept = default;
+};
+
+//Named bits of the keyUsage extension
+namespace key_usage
+{
+inline constexpr std::uint32_t digital_signature = 1u << 0u;
+inline constexpr std::uint32_t non_repudiation = 1u << 1u;
+inline constexpr std::uint32_t key_encipherment = 1u << 2u;
+inline constexpr std::uint32_t data_encipherment = 1u << 3u;
+inline constexpr std::uint32_t key_agreement = 1u << 4u;
+inline constexpr std::uint32_t key_cert_sign = 1u << 5u;
+inline constexpr std::uint32_t crl_sign = 1u << 6u;
+inline constexpr std::uint32_t encipher_only = 1u << 7u;
+inline constexpr std::uint32_t decipher_only = 1u << 8u;
+} //namespace key_usage
+
+//Decodes the value of the basicConstraints extension
+//(SEQUENCE { cA BOOLEAN DEFAULT FALSE, pathLenConstraint INTEGER OPTIONAL }).
+//Returns empty optional if the value is malformed.
+[[nodiscard]]
+std::optional<x509_basic_constraints> decode_basic_constraints(
+	span_range_type extension_value);
+
+//Decodes the value of the keyUsage extension (BIT STRING) to
+//the combination of key_usage flags.
+//Returns empty optional if the value is malformed.
+[[nodiscard]]
+std::optional<std::uint32_t> decode_key_usage(
+	span_range_type extension_value) noexcept;
+
+} //namespace pe_bliss::security::x509
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "pe_bliss2/security/byte_range_types.h"
+
+namespace pe_bliss::security::x509
+{
+
+inline constexpr std::array<std::uint32_t, 4u> oid_subject_key_identifier{ 2, 5, 29, 14 };
+inline constexpr std::array<std::uint32_t, 4u> oid_authority_key_identifier{ 2, 5, 29, 35 };
+
+//Decodes the value of the subjectKeyIdentifier extension (OCTET STRING).
+//Returns empty optional if the value is malformed.
+[[nodiscard]]
+std::optional<span_range_type> decode_subject_key_identifier(
+	span_range_type extension_value) noexcept;
+
+//Decodes the keyIdentifier of the authorityKeyIdentifier extension
+//(SEQUENCE { keyIdentifier [0] IMPLICIT OCTET STRING OPTIONAL, ... }).
+//Returns empty optional if the value is malformed or has no keyIdentifier.
+[[nodiscard]]
+std::optional<span_range_type> decode_authority_key_identifier(
+	span_range_type extension_value) noexcept;
+
+} //namespace pe_bliss::security::x509
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/x509/x509_der_certificate.h"
+
+namespace pe_bliss::security::x509
+{
+
+enum class x509_lazy_certificate_store_errc
+{
+	invalid_certificate = 1,
+	invalid_signature_format,
+	absent_certificates,
+	duplicate_certificate
+};
+
+std::error_code make_error_code(x509_lazy_certificate_store_errc) noexcept;
+
+//Certificate store which indexes DER-encoded certificates by
+//(serial number, raw issuer) using a shallow DER scan, and parses
+//only the certificates which are looked up using find_certificate.
+//Certificate data is referenced and must outlive the store.
+//Lookups cache decoded certificates, so the store is not thread-safe.
+class [[nodiscard]] x509_lazy_certificate_store final
+{
+public:
+	using range_type = span_range_type;
+	using certificate_type = x509_der_certificate;
+
+public:
+	void reserve(std::size_t count)
+	{
+		certificates_.reserve(count);
+	}
+
+	//Returns false if a certificate with the same serial number
+	//and issuer is already present. Throws pe_error if the certificate
+	//serial number or issuer can not be read.
+	bool add_certificate(span_range_type data);
+
+	//Throws pe_error if the found certificate can not be parsed
+	[[nodiscard]]
+	const certificate_type* find_certificate(span_range_type serial_number,
+		span_range_type raw_issuer) const;
+
+	[[nodiscard]]
+	std::size_t size() const noexcept
+	{
+		return certificates_.size();
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return certificates_.empty();
+	}
+
+	[[nodiscard]]
+	std::size_t get_decoded_count() const noexcept
+	{
+		return decoded_count_;
+	}
+
+private:
+	struct sn_with_issuer final
+	{
+		span_range_type serial_number;
+		span_range_type raw_issuer;
+	};
+
+	struct sn_with_issuer_equal final
+	{
+		[[nodiscard]]
+		bool operator()(const sn_with_issuer& l, const sn_with_issuer& r) const noexcept;
+	};
+
+	struct sn_with_issuer_hash final
+	{
+		[[nodiscard]]
+		std::size_t operator()(const sn_with_issuer& data) const noexcept;
+	};
+
+	struct certificate_entry final
+	{
+		span_range_type data;
+		std::unique_ptr<certificate_type> certificate;
+	};
+
+private:
+	mutable std::unordered_map<sn_with_issuer, certificate_entry,
+		sn_with_issuer_hash, sn_with_issuer_equal> certificates_;
+	mutable std::size_t decoded_count_{};
+};
+
+//Indexes certificates of the DER-encoded PKCS#7 ContentInfo with SignedData
+//(e.g., the Authenticode signature) without decoding them.
+//Reports absent_certificates and duplicate_certificate warnings.
+//Throws pe_error if the signature or a certificate can not be scanned.
+[[nodiscard]]
+x509_lazy_certificate_store build_lazy_certificate_store(span_range_type signature,
+	error_list* warnings = nullptr);
+
+} //namespace pe_bliss::security::x509
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::security::x509::x509_lazy_certificate_store_errc>
+	: true_type {};
+} //namespace std
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
+#include "pe_bliss2/security/x509/x509_certificate_store.h"
+#include "pe_bliss2/security/x509/x509_chain_builder.h"
+#include "pe_bliss2/security/x509/x509_der_certificate.h"
+
+namespace pe_bliss::security::x509
+{
+
+enum class x509_trust_store_errc
+{
+	unable_to_read_certificate = 1,
+	invalid_certificate,
+	duplicate_certificate
+};
+
+} //namespace pe_bliss::security::x509
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::security::x509::x509_trust_store_errc> : true_type {};
+} //namespace std
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_trust_store_errc) noexcept;
+
+//Set of trusted root certificates. Intended to be loaded once
+//and then shared (read-only) between threads. Certificate link
+//verification results are memoized in the verification cache.
+class [[nodiscard]] x509_trust_store final
+{
+public:
+	using certificate_type = x509_der_certificate;
+	using store_type = x509_certificate_store<certificate_type>;
+
+public:
+	x509_trust_store() = default;
+	x509_trust_store(const x509_trust_store&) = delete;
+	x509_trust_store& operator=(const x509_trust_store&) = delete;
+
+	//Adds a DER-encoded certificate or one or more PEM-encoded certificates
+	//(the data is copied). Invalid and duplicate certificates are skipped
+	//and reported to warnings (with the index of the certificate in data as a context).
+	//Returns the number of added certificates.
+	std::size_t add_certificates(std::span<const std::byte> data,
+		error_list* warnings = nullptr);
+
+	//Loads all *.cer, *.crt, *.der and *.pem files from the directory.
+	//Invalid certificates are skipped and reported to warnings
+	//(with the file name and the index of the certificate in the file as a context).
+	void load_directory(const std::filesystem::path& path, error_list* warnings = nullptr);
+
+	[[nodiscard]]
+	const store_type& get_store() const noexcept
+	{
+		return store_;
+	}
+
+	[[nodiscard]]
+	signature_verification_cache& get_verification_cache() const noexcept
+	{
+		return verification_cache_;
+	}
+
+private:
+	template<typename Reporter>
+	std::size_t add_certificates(std::span<const std::byte> data,
+		const Reporter& report);
+	template<typename Reporter>
+	bool add_der_certificate(std::vector<std::byte>&& data,
+		std::size_t index, const Reporter& report);
+
+private:
+	//Certificates reference this data
+	std::list<std::vector<std::byte>> certificate_data_;
+	store_type store_;
+	mutable signature_verification_cache verification_cache_;
+};
+
+//Process-wide trust store. Published stores are immutable,
+//so readers may use the returned store without locking.
+[[nodiscard]]
+std::shared_ptr<const x509_trust_store> get_global_trust_store() noexcept;
+void set_global_trust_store(std::shared_ptr<const x509_trust_store> store) noexcept;
+
+//Uses the trust store verification cache if options do not specify one
+template<typename Certificate>
+[[nodiscard]]
+x509_chain<Certificate, x509_trust_store::certificate_type> build_certificate_chain(
+	const Certificate& leaf,
+	const x509_certificate_store<Certificate>& intermediates,
+	const x509_trust_store& trust_store,
+	x509_chain_options options = {})
+{
+	if (!options.verification_cache)
+		options.verification_cache = &trust_store.get_verification_cache();
+	return build_certificate_chain(leaf, intermediates, trust_store.get_store(), options);
+}
+
+} //namespace pe_bliss::security::x509
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+
+#include "buffers/input_buffer_interface.h"
+#include "pe_bliss2/exports/export_directory.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/imports/import_directory.h"
+#include "pe_bliss2/resources/resource_directory.h"
+
+namespace buffers
+{
+class output_buffer_interface;
+} //namespace buffers
+
+namespace pe_bliss::snapshot
+{
+
+enum class image_snapshot_errc
+{
+	invalid_snapshot_signature = 1,
+	unsupported_snapshot_version,
+	invalid_snapshot_data,
+	snapshot_hash_mismatch,
+	content_hash_mismatch,
+	directory_has_errors
+};
+
+std::error_code make_error_code(image_snapshot_errc) noexcept;
+
+inline constexpr std::uint32_t image_snapshot_version = 2u;
+
+//SHA-256 of the original image file contents
+using content_hash_type = std::array<std::byte, 32u>;
+
+struct [[nodiscard]] image_snapshot
+{
+	pe_bliss::image::image image;
+	std::optional<imports::import_directory_details> imports;
+	std::optional<exports::export_directory_details> exports;
+	std::optional<resources::resource_directory_details> resources;
+};
+
+struct [[nodiscard]] snapshot_write_options
+{
+	//Directories with any errors or warnings are not stored,
+	//as error codes can not be persisted. Such directories will
+	//be missing from the loaded snapshot, and should be reloaded
+	//from the image.
+	bool skip_directories_with_errors = true;
+};
+
+struct [[nodiscard]] snapshot_load_options
+{
+	bool verify_snapshot_hash = true;
+};
+
+//Snapshot contains all image headers and data (section data, overlay, etc.),
+//which are loaded back as references to the snapshot buffer without copying.
+void write_snapshot(const image_snapshot& snapshot,
+	const content_hash_type& content_hash,
+	buffers::output_buffer_interface& buffer,
+	const snapshot_write_options& options = {});
+
+[[nodiscard]]
+image_snapshot load_snapshot(const buffers::input_buffer_ptr& buffer,
+	const content_hash_type& expected_content_hash,
+	const snapshot_load_options& options = {});
+
+[[nodiscard]]
+content_hash_type calculate_content_hash(buffers::input_buffer_interface& buffer);
+
+} //namespace pe_bliss::snapshot
+
+namespace std
+{
+template<>
+struct is_error_code_enum<pe_bliss::snapshot::image_snapshot_errc> : true_type {};
+} //namespace std
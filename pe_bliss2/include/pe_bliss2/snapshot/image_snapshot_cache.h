@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+#include "pe_bliss2/snapshot/image_snapshot.h"
+
+namespace pe_bliss::snapshot
+{
+
+//Stores image snapshots in a directory, one file per image,
+//keyed by the image content hash.
+class [[nodiscard]] image_snapshot_cache
+{
+public:
+	explicit image_snapshot_cache(std::filesystem::path directory) noexcept
+		: directory_(std::move(directory))
+	{
+	}
+
+	[[nodiscard]]
+	const std::filesystem::path& get_directory() const noexcept
+	{
+		return directory_;
+	}
+
+	[[nodiscard]]
+	std::filesystem::path get_snapshot_path(const content_hash_type& content_hash) const;
+
+	//Returns nullopt if there is no snapshot for the content hash,
+	//or if the snapshot is invalid or corrupted.
+	[[nodiscard]]
+	std::optional<image_snapshot> try_load(const content_hash_type& content_hash,
+		const snapshot_load_options& options = {}) const;
+
+	//Writes the snapshot to a temporary file, which is then renamed,
+	//so concurrent readers never observe partially written snapshots.
+	void store(const image_snapshot& snapshot,
+		const content_hash_type& content_hash,
+		const snapshot_write_options& options = {}) const;
+
+private:
+	std::filesystem::path directory_;
+};
+
+} //namespace pe_bliss::snapshot
@@ -11,6 +11,7 @@
 #include "pe_bliss2/image/section_data_from_va.h"
 #include "pe_bliss2/image/struct_from_va.h"
 #include "pe_bliss2/pe_types.h"
+#include "utilities/list_allocator.h"
 #include "utilities/safe_uint.h"
 
 namespace
@@ -149,6 +150,8 @@ std::optional<debug_directory_list_details> load(const image::image& instance,
 	const auto& dir = instance.get_data_directories().get_directory(
 		core::data_directories::directory_type::debug).get();
 	auto& list = result.emplace();
+	list.use_error_memory_resource(options.memory_resource);
+	utilities::use_memory_resource(list.get_entries(), options.memory_resource);
 
 	utilities::safe_uint start_rva = dir.virtual_address;
 	auto end_rva = start_rva;
@@ -174,6 +177,7 @@ std::optional<debug_directory_list_details> load(const image::image& instance,
 		}
 
 		auto& entry = list.get_entries().emplace_back();
+		entry.use_error_memory_resource(options.memory_resource);
 		try
 		{
 			struct_from_rva(instance, start_rva.value(), entry.get_descriptor(),
@@ -0,0 +1,236 @@
+#include "pe_bliss2/detail/snapshot/snapshot_stream.h"
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "buffers/input_buffer_section.h"
+#include "buffers/input_virtual_buffer.h"
+#include "buffers/output_buffer_interface.h"
+#include "buffers/ref_buffer.h"
+#include "pe_bliss2/packed_utf16_string.h"
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/snapshot/image_snapshot.h"
+#include "utilities/math.h"
+
+namespace pe_bliss::detail::snapshot
+{
+
+namespace
+{
+
+template<typename String>
+void write_c_string_impl(snapshot_writer& writer, const packed_c_string_base<String>& str)
+{
+	writer.write_string(str.value());
+	writer.write(str.is_virtual());
+	writer.write_state(str.get_state());
+}
+
+template<typename String>
+void write_utf16_string_impl(snapshot_writer& writer,
+	const packed_utf16_string_base<String>& str)
+{
+	writer.write_string(str.value());
+	writer.write<std::uint64_t>(str.physical_size());
+	writer.write<std::uint64_t>(str.data_size());
+	writer.write_state(str.get_state());
+}
+
+template<typename String>
+void read_c_string_impl(snapshot_reader& reader, packed_c_string_base<String>& str)
+{
+	str.value() = reader.read_string();
+	str.set_virtual_nullbyte(reader.read_bool());
+	reader.read_state(str.get_state());
+}
+
+template<typename String>
+void read_utf16_string_impl(snapshot_reader& reader, packed_utf16_string_base<String>& str)
+{
+	str.value() = reader.read_utf16_string();
+	auto physical_size = reader.read_size();
+	auto data_size = reader.read_size();
+	str.set_physical_size(physical_size);
+	str.set_data_size(data_size);
+	reader.read_state(str.get_state());
+}
+
+} //namespace
+
+void snapshot_writer::write_bytes(const std::byte* data, std::size_t size)
+{
+	if (size)
+		buf_.write(size, data);
+}
+
+void snapshot_writer::write_string(std::string_view value)
+{
+	write<std::uint64_t>(value.size());
+	write_bytes(reinterpret_cast<const std::byte*>(value.data()), value.size());
+}
+
+void snapshot_writer::write_string(std::u16string_view value)
+{
+	write<std::uint64_t>(value.size());
+	for (auto ch : value)
+		write<std::uint16_t>(static_cast<std::uint16_t>(ch));
+}
+
+void snapshot_writer::write_state(const buffers::input_buffer_state& state)
+{
+	write<std::uint64_t>(state.buffer_pos());
+	write<std::uint64_t>(state.absolute_offset());
+	write<std::uint64_t>(state.relative_offset());
+}
+
+void snapshot_writer::write_buffer(const buffers::ref_buffer& buffer)
+{
+	auto data = buffer.data();
+	write<std::uint64_t>(buffer.physical_size());
+	write<std::uint64_t>(buffer.virtual_size());
+	write<std::uint64_t>(data->absolute_offset());
+	write<std::uint64_t>(data->relative_offset());
+	buffer.serialize(buf_, false);
+}
+
+void snapshot_writer::write_c_string(const packed_c_string& str)
+{
+	write_c_string_impl(*this, str);
+}
+
+void snapshot_writer::write_c_string(const std::optional<packed_c_string>& str)
+{
+	write(str.has_value());
+	if (str)
+		write_c_string(*str);
+}
+
+void snapshot_writer::write_utf16_string(const packed_utf16_string& str)
+{
+	write_utf16_string_impl(*this, str);
+}
+
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+void snapshot_writer::write_c_string(const packed_list_c_string& str)
+{
+	write_c_string_impl(*this, str);
+}
+
+void snapshot_writer::write_utf16_string(const packed_list_utf16_string& str)
+{
+	write_utf16_string_impl(*this, str);
+}
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
+std::size_t snapshot_reader::read_size()
+{
+	auto value = read<std::uint64_t>();
+	if (value > (std::numeric_limits<std::size_t>::max)())
+		throw pe_error(pe_bliss::snapshot::image_snapshot_errc::invalid_snapshot_data);
+	return static_cast<std::size_t>(value);
+}
+
+void snapshot_reader::read_bytes(std::byte* data, std::size_t size)
+{
+	if (!size)
+		return;
+
+	if (size > wrapper_.size() - wrapper_.rpos()
+		|| wrapper_.read(size, data) != size)
+	{
+		throw pe_error(pe_bliss::snapshot::image_snapshot_errc::invalid_snapshot_data);
+	}
+}
+
+std::string snapshot_reader::read_string()
+{
+	auto length = read_size();
+	if (length > wrapper_.size() - wrapper_.rpos())
+		throw pe_error(pe_bliss::snapshot::image_snapshot_errc::invalid_snapshot_data);
+
+	std::string result(length, '\0');
+	read_bytes(reinterpret_cast<std::byte*>(result.data()), length);
+	return result;
+}
+
+std::u16string snapshot_reader::read_utf16_string()
+{
+	auto length = read_size();
+	if (length > (wrapper_.size() - wrapper_.rpos()) / sizeof(std::uint16_t))
+		throw pe_error(pe_bliss::snapshot::image_snapshot_errc::invalid_snapshot_data);
+
+	std::u16string result;
+	result.reserve(length);
+	while (length--)
+		result.push_back(static_cast<char16_t>(read<std::uint16_t>()));
+	return result;
+}
+
+void snapshot_reader::read_state(buffers::input_buffer_state& state)
+{
+	state.set_buffer_pos(read_size());
+	state.set_absolute_offset(read_size());
+	state.set_relative_offset(read_size());
+}
+
+void snapshot_reader::read_buffer(buffers::ref_buffer& buffer)
+{
+	auto physical_size = read_size();
+	auto virtual_size = read_size();
+	auto absolute_offset = read_size();
+	auto relative_offset = read_size();
+
+	auto pos = wrapper_.rpos();
+	if (!utilities::math::is_sum_safe(pos, physical_size)
+		|| pos + physical_size > wrapper_.size())
+	{
+		throw pe_error(pe_bliss::snapshot::image_snapshot_errc::invalid_snapshot_data);
+	}
+
+	buffers::input_buffer_ptr data = std::make_shared<buffers::input_buffer_section>(
+		buf_, pos, physical_size);
+	data->set_absolute_offset(absolute_offset);
+	data->set_relative_offset(relative_offset);
+	if (virtual_size)
+	{
+		data = std::make_shared<buffers::input_virtual_buffer>(
+			std::move(data), virtual_size);
+	}
+
+	buffer.deserialize(data, false);
+	wrapper_.set_rpos(pos + physical_size);
+}
+
+void snapshot_reader::read_c_string(packed_c_string& str)
+{
+	read_c_string_impl(*this, str);
+}
+
+void snapshot_reader::read_c_string(std::optional<packed_c_string>& str)
+{
+	if (read_bool())
+		read_c_string(str.emplace());
+	else
+		str.reset();
+}
+
+void snapshot_reader::read_utf16_string(packed_utf16_string& str)
+{
+	read_utf16_string_impl(*this, str);
+}
+
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+void snapshot_reader::read_c_string(packed_list_c_string& str)
+{
+	read_c_string_impl(*this, str);
+}
+
+void snapshot_reader::read_utf16_string(packed_list_utf16_string& str)
+{
+	read_utf16_string_impl(*this, str);
+}
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
+} //namespace pe_bliss::detail::snapshot
@@ -1,81 +1,244 @@
 #include "pe_bliss2/error_list.h"
 
 #include <algorithm>
+#include <exception>
+#include <functional>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+#include "utilities/hash.h"
+
+namespace
+{
+
+//Lists with more errors than this get a hash index
+constexpr std::size_t index_threshold = 16u;
+
+template<typename Context>
+std::size_t get_context_hash(std::error_code error, const Context& context) noexcept
+{
+	auto hash = std::hash<std::error_code>{}(error);
+	if constexpr (std::is_same_v<Context, std::size_t>)
+		utilities::hash_combine(hash, std::hash<std::size_t>{}(context));
+	else if constexpr (std::is_same_v<Context, std::string_view>)
+		utilities::hash_combine(hash, std::hash<std::string_view>{}(context));
+	return hash;
+}
+
+template<typename Func>
+decltype(auto) visit_context(const pe_bliss::error_list::context_type& context,
+	Func&& func)
+{
+	return std::visit([&func](const auto& value) {
+		if constexpr (std::is_same_v<std::remove_cvref_t<decltype(value)>, std::string>)
+			return func(std::string_view(value));
+		else
+			return func(value);
+	}, context);
+}
+
+template<typename Context>
+bool context_equals(const pe_bliss::error_list::error_context& stored,
+	std::error_code error, const Context& context) noexcept
+{
+	if (stored.code != error)
+		return false;
+
+	if constexpr (std::is_same_v<Context, std::monostate>)
+	{
+		return std::holds_alternative<std::monostate>(stored.context);
+	}
+	else if constexpr (std::is_same_v<Context, std::size_t>)
+	{
+		const auto* value = std::get_if<std::size_t>(&stored.context);
+		return value && *value == context;
+	}
+	else
+	{
+		const auto* value = std::get_if<std::string>(&stored.context);
+		return value && *value == context;
+	}
+}
+
+} //namespace
+
 namespace pe_bliss
 {
 
-void error_list::create_error_map()
+error_list::error_list(const error_list& other)
+	: errors_(other.errors_)
+	, index_(other.index_ ? std::make_unique<index_type>(*other.index_) : nullptr)
 {
-	if (!errors_)
-		errors_ = std::make_unique<error_map_type>();
 }
 
-void error_list::add_error(std::error_code error)
+error_list::error_list(error_list&& other) noexcept
+	: errors_(std::move(other.errors_))
+	, index_(std::move(other.index_))
+	, error_map_(other.error_map_.exchange(nullptr))
 {
-	create_error_map();
-	auto it = errors_->find({ error });
-	if (it == errors_->end())
+	other.errors_.clear();
+}
+
+error_list& error_list::operator=(const error_list& other)
+{
+	if (this != &other)
 	{
-		errors_->emplace(error_context{ error },
-			std::current_exception());
+		error_list copy(other);
+		*this = std::move(copy);
 	}
+	return *this;
 }
 
-void error_list::add_error(std::error_code error, std::string context)
+error_list& error_list::operator=(error_list&& other) noexcept
 {
-	create_error_map();
-	auto ctx = error_context{ error, std::move(context) };
-	auto it = errors_->find(ctx);
-	if (it == errors_->end())
+	if (this != &other)
 	{
-		errors_->emplace(std::move(ctx),
-			std::current_exception());
+		reset_error_map();
+		errors_ = std::move(other.errors_);
+		index_ = std::move(other.index_);
+		error_map_ = other.error_map_.exchange(nullptr);
+		other.errors_.clear();
 	}
+	return *this;
 }
 
-void error_list::add_error(std::error_code error, std::size_t context)
+error_list::~error_list()
+{
+	reset_error_map();
+}
+
+void error_list::reset_error_map() noexcept
+{
+	delete error_map_.exchange(nullptr);
+}
+
+const error_list::error_map_type* error_list::get_errors() const
+{
+	if (errors_.empty())
+		return nullptr;
+
+	if (const auto* map = error_map_.load(std::memory_order_acquire))
+		return map;
+
+	auto map = std::make_unique<error_map_type>(errors_.begin(), errors_.end());
+	error_map_type* expected = nullptr;
+	//Another thread may have built the map concurrently
+	if (!error_map_.compare_exchange_strong(expected, map.get(),
+		std::memory_order_acq_rel, std::memory_order_acquire))
+	{
+		return expected;
+	}
+	return map.release();
+}
+
+void error_list::clear_errors() noexcept
+{
+	errors_ = {};
+	index_.reset();
+	reset_error_map();
+}
+
+template<typename Context>
+const error_list::error_vector_type::value_type* error_list::find(
+	std::error_code error, const Context& context) const noexcept
 {
-	create_error_map();
-	auto ctx = error_context{ error, context };
-	auto it = errors_->find(ctx);
-	if (it == errors_->end())
+	if (index_)
+	{
+		auto [it, end] = index_->equal_range(get_context_hash(error, context));
+		for (; it != end; ++it)
+		{
+			const auto& elem = errors_[it->second];
+			if (context_equals(elem.first, error, context))
+				return &elem;
+		}
+		return nullptr;
+	}
+
+	auto it = std::find_if(errors_.cbegin(), errors_.cend(),
+		[error, &context](const auto& elem) {
+			return context_equals(elem.first, error, context);
+		});
+	return it == errors_.cend() ? nullptr : &*it;
+}
+
+void error_list::add_error_impl(error_context&& context)
+{
+	const auto code = context.code;
+	const bool exists = visit_context(context.context,
+		[this, code](const auto& value) { return find(code, value) != nullptr; });
+	if (exists)
+		return;
+
+	reset_error_map();
+	errors_.emplace_back(std::move(context), std::current_exception());
+	try
+	{
+		if (index_)
+		{
+			index_->emplace(visit_context(errors_.back().first.context,
+				[code](const auto& value) { return get_context_hash(code, value); }),
+				errors_.size() - 1u);
+		}
+		else if (errors_.size() > index_threshold)
+		{
+			//The index is allocated in the same way as the errors
+			auto index = std::make_unique<index_type>(errors_.get_allocator());
+			index->reserve(errors_.size());
+			for (std::size_t i = 0; i != errors_.size(); ++i)
+			{
+				const auto& stored = errors_[i].first;
+				index->emplace(visit_context(stored.context,
+					[&stored](const auto& value) {
+						return get_context_hash(stored.code, value);
+					}), i);
+			}
+			index_ = std::move(index);
+		}
+	}
+	catch (...)
 	{
-		errors_->emplace(std::move(ctx),
-			std::current_exception());
+		errors_.pop_back();
+		throw;
 	}
 }
 
+void error_list::add_error(std::error_code error)
+{
+	add_error_impl({ error });
+}
+
+void error_list::add_error(std::error_code error, std::string context)
+{
+	add_error_impl({ error, std::move(context) });
+}
+
+void error_list::add_error(std::error_code error, std::size_t context)
+{
+	add_error_impl({ error, context });
+}
+
 bool error_list::has_error(std::error_code error) const noexcept
 {
-	return errors_ && errors_->contains({ error });
+	return find(error, std::monostate{}) != nullptr;
 }
 
 bool error_list::has_error(std::error_code error,
 	std::string_view context) const noexcept
 {
-	return errors_ && errors_->contains({ error, std::string(context) });
+	return find(error, context) != nullptr;
 }
 
 bool error_list::has_error(std::error_code error,
 	std::size_t context) const noexcept
 {
-	return errors_ && errors_->contains({ error, context });
+	return find(error, context) != nullptr;
 }
 
 bool error_list::has_any_error(std::error_code error) const noexcept
 {
-	if (!errors_)
-		return false;
-
-	for (const auto& [key, val] : *errors_)
-	{
-		if (key.code == error)
-			return true;
-	}
-
-	return false;
+	return std::any_of(errors_.cbegin(), errors_.cend(),
+		[error](const auto& elem) { return elem.first.code == error; });
 }
 
 } //namespace pe_bliss
@@ -2,14 +2,19 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <boost/endian/conversion.hpp>
+
 #include "buffers/output_buffer_interface.h"
 #include "buffers/output_memory_ref_buffer.h"
 #include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/detail/string_pool.h"
 #include "pe_bliss2/image/image.h"
 #include "pe_bliss2/image/section_data_from_va.h"
 #include "pe_bliss2/image/string_to_va.h"
@@ -39,12 +44,14 @@ void update_data_directory(image::image& instance,
 template<typename ExportedNamePtr>
 struct symbol_ref
 {
-	explicit symbol_ref(ExportedNamePtr name) noexcept
+	explicit symbol_ref(ExportedNamePtr name, ordinal_type rva_ordinal) noexcept
 		: name(name)
+		, rva_ordinal(rva_ordinal)
 	{
 	}
 
 	ExportedNamePtr name;
+	ordinal_type rva_ordinal;
 	friend bool operator<(const symbol_ref& left, const symbol_ref& right) noexcept
 	{
 		return left.name->get_name()->value() < right.name->get_name()->value();
@@ -62,7 +69,7 @@ auto sort_symbols(ExportList& export_list)
 		for (auto& name : symbol.get_names())
 		{
 			if (name.get_name())
-				symbol_names.emplace_back(&name);
+				symbol_names.emplace_back(&name, symbol.get_rva_ordinal());
 		}
 	}
 
@@ -70,109 +77,109 @@ auto sort_symbols(ExportList& export_list)
 	return symbol_names;
 }
 
-template<typename Directory>
-utilities::safe_uint<rva_type> build_new_functions_impl(buffers::output_buffer_interface& buf,
-	Directory& directory, utilities::safe_uint<rva_type> current_rva)
+template<typename T>
+void write_table(buffers::output_buffer_interface& buf, std::vector<T>& table)
 {
-	auto& descriptor = directory.get_descriptor();
-	descriptor->address_of_functions = current_rva.value();
-
-	auto& export_list = directory.get_export_list();
-	if (export_list.empty())
-	{
-		descriptor->number_of_functions = 0u;
-		return current_rva;
-	}
-
-	descriptor->number_of_functions = static_cast<std::uint32_t>(export_list.back().get_rva_ordinal() + 1u);
-	current_rva += sizeof(rva_type) * descriptor->number_of_functions;
-	auto forwarded_name_rva = current_rva;
-	std::uint32_t prev_ordinal = 0;
-	for (auto& symbol : export_list)
-	{
-		while (prev_ordinal < symbol.get_rva_ordinal())
-		{
-			packed_struct<rva_type>{}.serialize(buf, true);
-			++prev_ordinal;
-		}
-		prev_ordinal = symbol.get_rva_ordinal() + 1;
+	for (auto& value : table)
+		boost::endian::native_to_little_inplace(value);
 
-		if (symbol.get_forwarded_name())
-		{
-			symbol.get_rva() = forwarded_name_rva.value();
-			forwarded_name_rva += 
-				symbol.get_forwarded_name()->value().size() + 1u; //nullbyte
-		}
-		symbol.get_rva().serialize(buf, true);
-	}
+	buf.write(table.size() * sizeof(T), reinterpret_cast<const std::byte*>(table.data()));
+}
 
-	for (const auto& symbol : export_list)
+void write_strings(buffers::output_buffer_interface& buf,
+	const std::vector<std::string_view>& strings)
+{
+	for (auto str : strings)
 	{
-		if (symbol.get_forwarded_name())
-			current_rva += symbol.get_forwarded_name()->serialize(buf, true);
+		//Strings reference std::string values, which are null-terminated
+		buf.write(str.size() + 1u, reinterpret_cast<const std::byte*>(str.data()));
 	}
-
-	return current_rva;
 }
 
+//Export directory layout: descriptor, library name, functions table,
+//forwarded names, name ordinals table, name RVAs table, names.
+//All offsets are calculated before anything is written.
 template<typename Directory>
-void build_new_names_impl(buffers::output_buffer_interface& buf,
-	Directory& directory, utilities::safe_uint<rva_type> current_rva)
+std::size_t build_new_impl(buffers::output_buffer_interface& buf, Directory& directory,
+	const builder_options& options)
 {
-	auto& descriptor = directory.get_descriptor();
-	descriptor->address_of_name_ordinals = current_rva.value();
-	if (directory.get_export_list().empty())
+	auto& export_list = directory.get_export_list();
+	std::sort(export_list.begin(), export_list.end(), [](const auto& l, const auto& r)
 	{
-		descriptor->address_of_names = current_rva.value();
-		return;
-	}
-
-	auto symbol_names = sort_symbols(directory.get_export_list());
-
-	for (const auto& sym : symbol_names)
-		current_rva += sym.name->get_name_ordinal().serialize(buf, true);
-
-	descriptor->address_of_names = current_rva.value();
+		return l.get_rva_ordinal() < r.get_rva_ordinal();
+	});
+	const auto symbol_names = sort_symbols(export_list);
 
-	current_rva += sizeof(rva_type) * symbol_names.size();
-	auto name_rva = current_rva;
-	for (auto& sym : symbol_names)
+	detail::string_pool<std::string_view> forwarded_names(options.deduplicate_names);
+	std::vector<std::uint32_t> forwarded_name_offsets;
+	for (const auto& symbol : export_list)
 	{
-		sym.name->get_name_rva() = name_rva.value();
-		sym.name->get_name_rva().serialize(buf, true);
-		name_rva += sym.name->get_name()->value().size() + 1u; // nullbyte
+		if (const auto& forwarded_name = symbol.get_forwarded_name(); forwarded_name)
+		{
+			forwarded_name_offsets.push_back(forwarded_names.add(forwarded_name->value(),
+				forwarded_name->value().size() + 1u)); //nullbyte
+		}
 	}
 
+	detail::string_pool<std::string_view> names(options.deduplicate_names);
+	std::vector<std::uint32_t> name_offsets;
+	name_offsets.reserve(symbol_names.size());
 	for (const auto& sym : symbol_names)
-		sym.name->get_name()->serialize(buf, true);
-}
+	{
+		const auto& name = sym.name->get_name()->value();
+		name_offsets.push_back(names.add(name, name.size() + 1u)); //nullbyte
+	}
 
-template<typename Directory>
-std::size_t build_new_impl(buffers::output_buffer_interface& buf, Directory& directory,
-	const builder_options& options)
-{
 	auto& descriptor = directory.get_descriptor();
+	descriptor->number_of_functions = export_list.empty()
+		? 0u : static_cast<std::uint32_t>(export_list.back().get_rva_ordinal() + 1u);
+	descriptor->number_of_names = static_cast<std::uint32_t>(symbol_names.size());
+
 	utilities::safe_uint current_rva(options.directory_rva);
 	current_rva += descriptor.packed_size;
 	descriptor->name = current_rva.value();
+	current_rva += directory.get_library_name().value().size() + 1u; //nullbyte
+	descriptor->address_of_functions = current_rva.value();
+	current_rva += sizeof(rva_type) * static_cast<std::uint64_t>(descriptor->number_of_functions);
+	const auto forwarded_names_rva = current_rva;
+	current_rva += forwarded_names.size();
+	descriptor->address_of_name_ordinals = current_rva.value();
+	current_rva += sizeof(ordinal_type) * symbol_names.size();
+	descriptor->address_of_names = current_rva.value();
+	current_rva += sizeof(rva_type) * symbol_names.size();
+	const auto names_rva = current_rva;
 
-	auto buf_start_pos = buf.wpos();
-	buf.advance_wpos(descriptor.packed_size);
-	current_rva += directory.get_library_name().serialize(buf, true);
-
-	auto& export_list = directory.get_export_list();
-	std::sort(export_list.begin(), export_list.end(), [](const auto& l, const auto& r)
+	std::vector<rva_type> functions(descriptor->number_of_functions);
+	auto forwarded_name_offset = forwarded_name_offsets.cbegin();
+	for (auto& symbol : export_list)
 	{
-		return l.get_rva_ordinal() < r.get_rva_ordinal();
-	});
+		if (symbol.get_forwarded_name())
+			symbol.get_rva() = (forwarded_names_rva + *forwarded_name_offset++).value();
+		functions[symbol.get_rva_ordinal()] = symbol.get_rva().get();
+	}
 
-	current_rva = build_new_functions_impl(buf, directory, current_rva);
-	build_new_names_impl(buf, directory, current_rva);
+	std::vector<ordinal_type> name_ordinals;
+	std::vector<rva_type> name_rvas;
+	name_ordinals.reserve(symbol_names.size());
+	name_rvas.reserve(symbol_names.size());
+	auto name_offset = name_offsets.cbegin();
+	for (const auto& sym : symbol_names)
+	{
+		sym.name->get_name_rva() = (names_rva + *name_offset++).value();
+		sym.name->get_name_ordinal() = sym.rva_ordinal;
+		name_ordinals.push_back(sym.name->get_name_ordinal().get());
+		name_rvas.push_back(sym.name->get_name_rva().get());
+	}
 
-	auto size = buf.wpos() - buf_start_pos;
-	buf.set_wpos(buf_start_pos);
+	auto buf_start_pos = buf.wpos();
 	descriptor.serialize(buf, true);
-	return size;
+	write_strings(buf, { directory.get_library_name().value() });
+	write_table(buf, functions);
+	write_strings(buf, forwarded_names.get_keys());
+	write_table(buf, name_ordinals);
+	write_table(buf, name_rvas);
+	write_strings(buf, names.get_keys());
+	return buf.wpos() - buf_start_pos;
 }
 
 template<typename Directory>
@@ -187,7 +194,7 @@ std::uint32_t build_new_impl(image::image& instance, Directory& directory,
 }
 
 template<typename Directory>
-std::uint32_t get_built_size_impl(const Directory& directory)
+std::uint32_t get_built_size_impl(const Directory& directory, const builder_options& options)
 {
 	utilities::safe_uint result(static_cast<std::uint32_t>(directory.get_descriptor().packed_size));
 	result += directory.get_library_name().value().size() + 1; /* nullbyte */
@@ -195,10 +202,15 @@ std::uint32_t get_built_size_impl(const Directory& directory)
 	//Size of table of functions
 	result += directory.get_last_free_ordinal() * sizeof(rva_type);
 
+	detail::string_pool<std::string_view> forwarded_names(options.deduplicate_names);
+	detail::string_pool<std::string_view> names(options.deduplicate_names);
 	for (const auto& symbol : directory.get_export_list())
 	{
-		if (symbol.get_forwarded_name())
-			result += symbol.get_forwarded_name()->value().size() + 1u; /* nullbyte */
+		if (const auto& forwarded_name = symbol.get_forwarded_name(); forwarded_name)
+		{
+			(void)forwarded_names.add(forwarded_name->value(),
+				forwarded_name->value().size() + 1u); /* nullbyte */
+		}
 
 		for (const auto& name_info : symbol.get_names())
 		{
@@ -207,10 +219,13 @@ std::uint32_t get_built_size_impl(const Directory& directory)
 
 			//Entry of names and name ordinals tables
 			result += sizeof(rva_type) + sizeof(ordinal_type);
-			result += name_info.get_name()->value().size() + 1u; /* nullbyte */
+			(void)names.add(name_info.get_name()->value(),
+				name_info.get_name()->value().size() + 1u); /* nullbyte */
 		}
 	}
 
+	result += forwarded_names.size();
+	result += names.size();
 	return result.value();
 }
 
@@ -313,14 +328,16 @@ std::uint32_t build_new(buffers::output_buffer_interface& buf, export_directory_
 	return static_cast<std::uint32_t>(build_new_impl(buf, directory, options));
 }
 
-std::uint32_t get_built_size(const export_directory& directory)
+std::uint32_t get_built_size(const export_directory& directory,
+	const builder_options& options)
 {
-	return get_built_size_impl(directory);
+	return get_built_size_impl(directory, options);
 }
 
-std::uint32_t get_built_size(const export_directory_details& directory)
+std::uint32_t get_built_size(const export_directory_details& directory,
+	const builder_options& options)
 {
-	return get_built_size_impl(directory);
+	return get_built_size_impl(directory, options);
 }
 
 } //namespace pe_bliss::exports
@@ -1,8 +1,11 @@
 #include "pe_bliss2/image/image_builder.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstddef>
 #include <system_error>
+#include <variant>
 
 #include "buffers/output_buffer_interface.h"
 #include "pe_bliss2/image/image.h"
@@ -35,6 +38,35 @@ struct image_builder_error_category : std::error_category
 
 const image_builder_error_category image_builder_error_category_instance;
 
+//Moves the write position. Gaps after the already written data are filled with zeros
+//explicitly, as the buffer may contain data left from a previous build.
+void seek(buffers::output_buffer_interface& buffer, std::size_t pos,
+	std::size_t& written_end)
+{
+	written_end = (std::max)(written_end, buffer.wpos());
+	if (pos <= written_end)
+	{
+		buffer.set_wpos(pos);
+		return;
+	}
+
+	static constexpr std::array<std::byte, 0x1000u> zeros{};
+	buffer.set_wpos(written_end);
+	for (auto gap = pos - written_end; gap;)
+	{
+		auto count = (std::min)(gap, zeros.size());
+		buffer.write(count, zeros.data());
+		gap -= count;
+	}
+	written_end = pos;
+}
+
+template<typename PackedStruct>
+std::size_t get_written_size(const PackedStruct& obj, bool write_virtual_part) noexcept
+{
+	return write_virtual_part ? obj.packed_size : obj.physical_size();
+}
+
 } //namespace
 
 namespace pe_bliss::image
@@ -89,8 +121,9 @@ void image_builder::build(const image& instance, buffers::output_buffer_interfac
 	instance.get_dos_header().serialize(buffer, options.write_structure_virtual_parts);
 
 	instance.get_dos_stub().serialize(buffer);
+	auto written_end = buffer.wpos();
 	if (buffer.wpos() - buffer_start_pos != dos_hdr->e_lfanew)
-		buffer.set_wpos(buffer_start_pos + dos_hdr->e_lfanew);
+		seek(buffer, buffer_start_pos + dos_hdr->e_lfanew, written_end);
 
 	image_signature.serialize(buffer, options.write_structure_virtual_parts);
 	file_header.serialize(buffer, options.write_structure_virtual_parts);
@@ -108,18 +141,79 @@ void image_builder::build(const image& instance, buffers::output_buffer_interfac
 	if (sections.empty())
 		return;
 
-	buffer.set_wpos(section_table_offset.value());
+	seek(buffer, section_table_offset.value(), written_end);
 	section_tbl.serialize(buffer, options.write_structure_virtual_parts);
 
 	auto section_hdr = section_tbl.get_section_headers().cbegin();
 	for (const auto& section : sections)
 	{
 		//Checked for overflow earlier
-		buffer.set_wpos(section_hdr->get_pointer_to_raw_data()
-			+ buffer_start_pos);
+		seek(buffer, section_hdr->get_pointer_to_raw_data()
+			+ buffer_start_pos, written_end);
 		section.serialize(buffer);
 		++section_hdr;
 	}
 }
 
+std::size_t image_builder::get_built_size(const image& instance,
+	const image_builder_options& options)
+{
+	const auto& section_tbl = instance.get_section_table();
+	const auto& sections = instance.get_section_data_list();
+	if (section_tbl.get_section_headers().size() != sections.size())
+		throw pe_error(image_builder_errc::inconsistent_section_headers_and_data);
+
+	const auto write_virtual_part = options.write_structure_virtual_parts;
+	const auto& dos_hdr = instance.get_dos_header().get_descriptor();
+	const auto& file_header = instance.get_file_header();
+	try
+	{
+		utilities::safe_uint<std::size_t> dos_end
+			= get_written_size(dos_hdr, write_virtual_part);
+		dos_end += instance.get_dos_stub().physical_size();
+
+		utilities::safe_uint<std::size_t> headers_end = dos_hdr->e_lfanew;
+		headers_end += get_written_size(instance.get_image_signature().get_descriptor(),
+			write_virtual_part);
+		headers_end += get_written_size(file_header.get_descriptor(), write_virtual_part);
+		headers_end += sizeof(core::optional_header::magic_type);
+		headers_end += std::visit([write_virtual_part] (const auto& obj) {
+			return get_written_size(obj, write_virtual_part);
+		}, instance.get_optional_header().get_descriptor());
+		for (const auto& dir : instance.get_data_directories().get_directories())
+			headers_end += get_written_size(dir, write_virtual_part);
+
+		auto result = (std::max)(dos_end.value(), headers_end.value());
+		if (options.fill_full_headers_data_gaps)
+			result = (std::max)(result, instance.get_full_headers_buffer().physical_size());
+
+		if (sections.empty())
+			return result;
+
+		utilities::safe_uint<std::size_t> section_table_end = dos_hdr->e_lfanew;
+		section_table_end += core::image_signature::descriptor_type::packed_size;
+		section_table_end += core::file_header::descriptor_type::packed_size;
+		section_table_end += file_header.get_descriptor()->size_of_optional_header;
+		for (const auto& header : section_tbl.get_section_headers())
+			section_table_end += get_written_size(header.get_descriptor(), write_virtual_part);
+		result = (std::max)(result, section_table_end.value());
+
+		auto section_hdr = section_tbl.get_section_headers().cbegin();
+		for (const auto& section : sections)
+		{
+			utilities::safe_uint<std::size_t> section_end
+				= section_hdr->get_pointer_to_raw_data();
+			section_end += section.physical_size();
+			result = (std::max)(result, section_end.value());
+			++section_hdr;
+		}
+
+		return result;
+	}
+	catch (const std::system_error&)
+	{
+		std::throw_with_nested(pe_error(image_builder_errc::invalid_section_table_offset));
+	}
+}
+
 } //namespace pe_bliss::image
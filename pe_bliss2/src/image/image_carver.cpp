@@ -0,0 +1,195 @@
+#include "pe_bliss2/image/image_carver.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include "buffers/input_buffer_section.h"
+#include "buffers/input_buffer_stateful_wrapper.h"
+#include "pe_bliss2/core/file_header.h"
+#include "pe_bliss2/core/image_signature.h"
+#include "pe_bliss2/core/image_signature_validator.h"
+#include "pe_bliss2/core/optional_header.h"
+#include "pe_bliss2/dos/dos_header.h"
+#include "pe_bliss2/dos/dos_header_validator.h"
+#include "pe_bliss2/section/section_table.h"
+#include "utilities/safe_uint.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define PE_BLISS_CARVER_SSE2 1
+#	include <emmintrin.h>
+#endif
+
+namespace pe_bliss::image
+{
+
+namespace
+{
+
+constexpr std::byte mz_first{ 'M' };
+constexpr std::byte mz_second{ 'Z' };
+
+//Returns the position of the next "MZ" pair starting at pos or later,
+//or size - 1 if there is none
+std::size_t find_mz(const std::byte* data, std::size_t size, std::size_t pos) noexcept
+{
+	assert(size);
+#ifdef PE_BLISS_CARVER_SSE2
+	const auto first = _mm_set1_epi8('M');
+	const auto second = _mm_set1_epi8('Z');
+	//Compares 16 positions at once: bytes at p with 'M' and bytes at p + 1 with 'Z'
+	for (; pos + sizeof(__m128i) < size; pos += sizeof(__m128i))
+	{
+		const auto current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		const auto next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 1u));
+		const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+			_mm_cmpeq_epi8(current, first), _mm_cmpeq_epi8(next, second))));
+		if (mask)
+			return pos + std::countr_zero(mask);
+	}
+#endif //PE_BLISS_CARVER_SSE2
+
+	for (; pos + 1u < size; ++pos)
+	{
+		if (data[pos] == mz_first && data[pos + 1u] == mz_second)
+			return pos;
+	}
+	return size - 1u;
+}
+
+std::optional<carved_image> check_candidate(const buffers::input_buffer_ptr& buffer,
+	std::size_t offset, const carver_options& options)
+{
+	try
+	{
+		buffers::input_buffer_section section(buffer, offset, buffer->size() - offset);
+		buffers::input_buffer_stateful_wrapper_ref wrapper(section);
+
+		dos::dos_header dos_hdr;
+		dos_hdr.deserialize(wrapper);
+		if (dos::validate_magic(dos_hdr).has_error()
+			|| dos::validate_e_lfanew(dos_hdr).has_error())
+		{
+			return {};
+		}
+
+		const auto e_lfanew = dos_hdr.get_descriptor()->e_lfanew;
+		if (e_lfanew > options.max_e_lfanew)
+			return {};
+
+		wrapper.set_rpos(e_lfanew);
+		core::image_signature signature;
+		signature.deserialize(wrapper);
+		if (core::validate(signature).has_error())
+			return {};
+
+		core::file_header file_hdr;
+		file_hdr.deserialize(wrapper);
+		core::optional_header optional_hdr;
+		optional_hdr.deserialize(wrapper, true);
+
+		utilities::safe_uint<std::size_t> section_table_offset = e_lfanew;
+		section_table_offset += core::image_signature::descriptor_type::packed_size;
+		section_table_offset += core::file_header::descriptor_type::packed_size;
+		section_table_offset += file_hdr.get_descriptor()->size_of_optional_header;
+		wrapper.set_rpos(section_table_offset.value());
+
+		section::section_table sections;
+		sections.deserialize(wrapper, file_hdr.get_descriptor()->number_of_sections, true);
+
+		std::size_t image_end = (std::max)(wrapper.rpos(),
+			static_cast<std::size_t>(optional_hdr.get_raw_size_of_headers()));
+		if (options.image_loaded_to_memory)
+		{
+			image_end = (std::max)(image_end,
+				static_cast<std::size_t>(optional_hdr.get_raw_size_of_image()));
+		}
+		else
+		{
+			const auto section_alignment = optional_hdr.get_raw_section_alignment();
+			for (const auto& header : sections.get_section_headers())
+			{
+				utilities::safe_uint<std::size_t> section_end = header.get_pointer_to_raw_data();
+				section_end += header.get_raw_size(section_alignment);
+				image_end = (std::max)(image_end, section_end.value());
+			}
+		}
+
+		return carved_image{
+			.offset = offset,
+			.size = (std::min)(image_end, section.size()),
+			.format = optional_hdr.get_magic() == core::optional_header::magic::pe32
+				? detected_format::pe32 : detected_format::pe64
+		};
+	}
+	catch (const std::system_error&)
+	{
+		return {};
+	}
+}
+
+} //namespace
+
+void image_carver::scan(const buffers::input_buffer_ptr& buffer,
+	const callback_type& on_image, const carver_options& options)
+{
+	assert(buffer);
+	assert(options.chunk_size);
+
+	const auto buffer_size = buffer->size();
+	std::vector<std::byte> chunk;
+	std::size_t chunk_start = 0;
+	//Chunks overlap by one byte, so that signatures
+	//crossing chunk boundaries are found
+	while (chunk_start + 1u < buffer_size)
+	{
+		const auto chunk_size = (std::min)(options.chunk_size + 1u,
+			buffer_size - chunk_start);
+		const auto* data = buffer->get_raw_data(chunk_start, chunk_size);
+		if (!data)
+		{
+			chunk.resize(chunk_size);
+			if (buffer->read(chunk_start, chunk_size, chunk.data()) != chunk_size)
+				return;
+			data = chunk.data();
+		}
+
+		std::size_t next_chunk_start = chunk_start + chunk_size - 1u;
+		for (auto pos = find_mz(data, chunk_size, 0u); pos + 1u < chunk_size;
+			pos = find_mz(data, chunk_size, pos + 1u))
+		{
+			auto image = check_candidate(buffer, chunk_start + pos, options);
+			if (!image)
+				continue;
+
+			if (!on_image(*image))
+				return;
+
+			if (options.skip_found_images && image->size > 1u)
+			{
+				next_chunk_start = image->offset + image->size;
+				break;
+			}
+		}
+
+		chunk_start = next_chunk_start;
+	}
+}
+
+std::vector<carved_image> image_carver::scan(const buffers::input_buffer_ptr& buffer,
+	const carver_options& options)
+{
+	std::vector<carved_image> result;
+	scan(buffer, [&result](const carved_image& image) {
+		result.push_back(image);
+		return true;
+	}, options);
+	return result;
+}
+
+} //namespace pe_bliss::image
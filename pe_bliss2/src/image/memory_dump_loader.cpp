@@ -0,0 +1,163 @@
+#include "pe_bliss2/image/memory_dump_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "buffers/input_buffer_section.h"
+#include "buffers/input_file_mapping_buffer.h"
+#include "pe_bliss2/pe_error.h"
+#include "utilities/math.h"
+
+namespace
+{
+
+struct memory_dump_loader_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "memory_dump_loader";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::image::memory_dump_loader_errc;
+		switch (static_cast<pe_bliss::image::memory_dump_loader_errc>(ev))
+		{
+		case invalid_module_index_entry:
+			return "Invalid module index entry";
+		case module_is_out_of_dump_bounds:
+			return "Module is out of memory dump bounds";
+		default:
+			return {};
+		}
+	}
+};
+
+const memory_dump_loader_error_category memory_dump_loader_error_category_instance;
+
+void load_module(const buffers::input_buffer_ptr& dump, std::size_t dump_size,
+	const pe_bliss::image::dump_module& module,
+	const pe_bliss::image::image_load_options& options,
+	pe_bliss::image::image_load_result& result)
+{
+	using namespace pe_bliss;
+	try
+	{
+		auto end = module.offset;
+		if (!utilities::math::add_if_safe(end, module.size) || end > dump_size)
+			throw pe_error(image::memory_dump_loader_errc::module_is_out_of_dump_bounds);
+
+		result = image::image_loader::load(
+			buffers::reduce(dump, module.offset, module.size), options);
+	}
+	catch (...)
+	{
+		result.fatal_error = std::current_exception();
+	}
+}
+
+} //namespace
+
+namespace pe_bliss::image
+{
+
+std::error_code make_error_code(memory_dump_loader_errc e) noexcept
+{
+	return { static_cast<int>(e), memory_dump_loader_error_category_instance };
+}
+
+dump_module_list memory_dump_loader::parse_module_index(std::istream& index)
+{
+	dump_module_list result;
+	std::string line;
+	while (std::getline(index, line))
+	{
+		auto first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+
+		std::istringstream stream(line);
+		std::string offset, size;
+		auto& module = result.emplace_back();
+		stream >> offset >> size >> std::ws;
+		std::getline(stream, module.name);
+		while (!module.name.empty() && module.name.back() == '\r')
+			module.name.pop_back();
+
+		try
+		{
+			std::size_t offset_end{}, size_end{};
+			module.offset = std::stoull(offset, &offset_end, 0);
+			module.size = std::stoull(size, &size_end, 0);
+			if (offset_end != offset.size() || size_end != size.size())
+				throw pe_error(memory_dump_loader_errc::invalid_module_index_entry);
+		}
+		catch (const std::logic_error&)
+		{
+			throw pe_error(memory_dump_loader_errc::invalid_module_index_entry);
+		}
+	}
+	return result;
+}
+
+std::vector<image_load_result> memory_dump_loader::load(
+	const buffers::input_buffer_ptr& dump, std::span<const dump_module> modules,
+	const memory_dump_load_options& options)
+{
+	assert(dump);
+
+	std::vector<image_load_result> result(modules.size());
+	const auto dump_size = dump->size();
+	auto thread_count = static_cast<std::size_t>((std::max)(options.max_threads, 1u));
+	thread_count = (std::min)(thread_count, modules.size());
+	if (thread_count <= 1u || !dump->is_stateless())
+	{
+		for (std::size_t i = 0; i != modules.size(); ++i)
+			load_module(dump, dump_size, modules[i], options.image_options, result[i]);
+		return result;
+	}
+
+	std::atomic<std::size_t> next_module{};
+	auto worker = [&] {
+		for (auto i = next_module++; i < modules.size(); i = next_module++)
+			load_module(dump, dump_size, modules[i], options.image_options, result[i]);
+	};
+
+	//jthread joins on destruction, so a failure to start a thread
+	//never leaves joinable threads behind
+	std::vector<std::jthread> threads;
+	threads.reserve(thread_count - 1u);
+	try
+	{
+		for (std::size_t i = 1; i != thread_count; ++i)
+			threads.emplace_back(worker);
+	}
+	catch (const std::system_error&)
+	{
+		//Unable to start more threads: the threads which are already
+		//running and the current thread load the remaining modules
+	}
+	worker();
+	threads.clear();
+
+	return result;
+}
+
+std::vector<image_load_result> memory_dump_loader::load(
+	const std::filesystem::path& dump_path, std::span<const dump_module> modules,
+	const memory_dump_load_options& options)
+{
+	return load(std::make_shared<buffers::input_file_mapping_buffer>(dump_path),
+		modules, options);
+}
+
+} //namespace pe_bliss::image
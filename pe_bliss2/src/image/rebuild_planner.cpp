@@ -0,0 +1,508 @@
+#include "pe_bliss2/image/rebuild_planner.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pe_bliss2/core/file_header.h"
+#include "pe_bliss2/core/image_signature.h"
+#include "pe_bliss2/detail/image_file_header.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_builder.h"
+#include "pe_bliss2/image/image_errc.h"
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/section/section_header.h"
+#include "utilities/generic_error.h"
+#include "utilities/math.h"
+#include "utilities/safe_uint.h"
+
+namespace
+{
+
+struct rebuild_planner_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "rebuild_planner";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::image::rebuild_planner_errc;
+		switch (static_cast<pe_bliss::image::rebuild_planner_errc>(ev))
+		{
+		case invalid_directory_alignment:
+			return "Invalid directory alignment";
+		case invalid_section_index:
+			return "Invalid section index";
+		case section_is_not_last:
+			return "Only the last section can be extended";
+		case no_room_for_section_header:
+			return "No room for a new section header";
+		default:
+			return {};
+		}
+	}
+};
+
+const rebuild_planner_error_category rebuild_planner_error_category_instance;
+
+} //namespace
+
+namespace pe_bliss::image::impl
+{
+
+class rebuild_item
+{
+public:
+	virtual ~rebuild_item() = default;
+
+	//rva is aligned to the directory alignment. Returns the directory data end RVA.
+	[[nodiscard]]
+	virtual rva_type layout(rva_type rva, std::uint32_t alignment,
+		std::vector<rebuild_plan_entry>& entries) = 0;
+
+	virtual void build(image& instance) = 0;
+};
+
+} //namespace pe_bliss::image::impl
+
+namespace
+{
+
+using namespace pe_bliss;
+using namespace pe_bliss::image;
+
+template<typename Options>
+constexpr rebuild_directory_type get_directory_type() noexcept
+{
+	if constexpr (std::is_same_v<Options, exports::builder_options>)
+		return rebuild_directory_type::exports;
+	else if constexpr (std::is_same_v<Options, relocations::builder_options>)
+		return rebuild_directory_type::relocations;
+	else if constexpr (std::is_same_v<Options, tls::builder_options>)
+		return rebuild_directory_type::tls;
+	else
+		return rebuild_directory_type::bound_imports;
+}
+
+rva_type add_size(rva_type rva, std::uint32_t size)
+{
+	utilities::safe_uint result = rva;
+	result += size;
+	return result.value();
+}
+
+template<typename Directory, typename Options>
+class directory_rebuild_item final : public impl::rebuild_item
+{
+public:
+	directory_rebuild_item(Directory& directory, const Options& options) noexcept
+		: directory_(directory)
+		, options_(options)
+	{
+	}
+
+	virtual rva_type layout(rva_type rva, std::uint32_t /* alignment */,
+		std::vector<rebuild_plan_entry>& entries) override
+	{
+		options_.directory_rva = rva;
+		auto size = get_size();
+		entries.push_back({
+			.type = get_directory_type<Options>(),
+			.rva = rva,
+			.size = size
+		});
+		return add_size(rva, size);
+	}
+
+	virtual void build(image::image& instance) override
+	{
+		if constexpr (std::is_same_v<Options, exports::builder_options>)
+			(void)exports::build_new(instance, directory_, options_);
+		else if constexpr (std::is_same_v<Options, relocations::builder_options>)
+			(void)relocations::build_new(instance, directory_, options_);
+		else if constexpr (std::is_same_v<Options, tls::builder_options>)
+			(void)tls::build_new(instance, directory_, options_);
+		else
+			(void)bound_import::build_new(instance, directory_, options_);
+	}
+
+private:
+	std::uint32_t get_size() const
+	{
+		if constexpr (std::is_same_v<Options, exports::builder_options>)
+			return exports::get_built_size(directory_, options_);
+		else if constexpr (std::is_same_v<Options, relocations::builder_options>)
+			return relocations::get_built_size(directory_, options_);
+		else if constexpr (std::is_same_v<Options, tls::builder_options>)
+			return tls::get_built_size(directory_, options_).full_size;
+		else
+			return bound_import::get_built_size(directory_);
+	}
+
+private:
+	Directory& directory_;
+	Options options_;
+};
+
+template<typename Directory>
+class import_rebuild_item final : public impl::rebuild_item
+{
+public:
+	import_rebuild_item(Directory& directory,
+		const imports::builder_options& options) noexcept
+		: directory_(directory)
+		, options_(options)
+	{
+	}
+
+	virtual rva_type layout(rva_type rva, std::uint32_t alignment,
+		std::vector<rebuild_plan_entry>& entries) override
+	{
+		if (!options_.iat_rva)
+		{
+			options_.directory_rva = rva;
+			auto size = imports::get_built_size(directory_, options_).directory_size;
+			entries.push_back({
+				.type = rebuild_directory_type::imports,
+				.rva = rva,
+				.size = size
+			});
+			return add_size(rva, size);
+		}
+
+		//The directory alignment is a multiple of the thunk size, so the
+		//directory size does not depend on the final (aligned) directory RVA
+		options_.iat_rva = rva;
+		options_.directory_rva = 0;
+		auto size = imports::get_built_size(directory_, options_);
+		entries.push_back({
+			.type = rebuild_directory_type::import_address_table,
+			.rva = rva,
+			.size = size.iat_size
+		});
+
+		utilities::safe_uint directory_rva = add_size(rva, size.iat_size);
+		directory_rva.align_up(alignment);
+		options_.directory_rva = directory_rva.value();
+		entries.push_back({
+			.type = rebuild_directory_type::imports,
+			.rva = options_.directory_rva,
+			.size = size.directory_size
+		});
+		return add_size(options_.directory_rva, size.directory_size);
+	}
+
+	virtual void build(image::image& instance) override
+	{
+		(void)imports::build_new(instance, directory_, options_);
+	}
+
+private:
+	Directory& directory_;
+	imports::builder_options options_;
+};
+
+std::uint32_t get_section_table_end(const image::image& instance,
+	std::size_t number_of_sections)
+{
+	utilities::safe_uint<std::uint32_t> result
+		= instance.get_dos_header().get_descriptor()->e_lfanew;
+	result += core::image_signature::descriptor_type::packed_size;
+	result += core::file_header::descriptor_type::packed_size;
+	result += instance.get_file_header().get_descriptor()->size_of_optional_header;
+	result += static_cast<std::uint64_t>(number_of_sections)
+		* section::section_header::descriptor_type::packed_size;
+	return result.value();
+}
+
+std::uint32_t get_raw_data_end(const image::image& instance,
+	std::uint32_t size_of_headers)
+{
+	const auto& optional_header = instance.get_optional_header();
+	auto raw_data_end = (std::max)(static_cast<std::uint64_t>(size_of_headers),
+		instance.get_section_table().get_raw_data_end_offset(
+			optional_header.get_raw_section_alignment()));
+	if (!utilities::math::align_up_if_safe(raw_data_end,
+		optional_header.get_raw_file_alignment())
+		|| raw_data_end > (std::numeric_limits<std::uint32_t>::max)())
+	{
+		throw pe_error(utilities::generic_errc::integer_overflow);
+	}
+	return static_cast<std::uint32_t>(raw_data_end);
+}
+
+std::uint32_t get_new_size_of_headers(const image::image& instance)
+{
+	const auto& optional_header = instance.get_optional_header();
+	const auto& headers = instance.get_section_table().get_section_headers();
+	using number_of_sections_type = decltype(
+		pe_bliss::detail::image_file_header::number_of_sections);
+	if (headers.size() >= (std::numeric_limits<number_of_sections_type>::max)())
+		throw pe_error(image_errc::too_many_sections);
+
+	auto size_of_headers = optional_header.get_raw_size_of_headers();
+	auto section_table_end = get_section_table_end(instance, headers.size() + 1u);
+	if (section_table_end <= size_of_headers)
+		return size_of_headers;
+
+	if (!utilities::math::align_up_if_safe(section_table_end,
+		optional_header.get_raw_file_alignment()))
+	{
+		throw pe_error(utilities::generic_errc::integer_overflow);
+	}
+
+	//Headers can not be extended without moving section data
+	for (const auto& header : headers)
+	{
+		if (header.get_rva() < section_table_end
+			|| (header.get_descriptor()->pointer_to_raw_data
+				&& header.get_pointer_to_raw_data() < section_table_end))
+		{
+			throw pe_error(rebuild_planner_errc::no_room_for_section_header);
+		}
+	}
+	return section_table_end;
+}
+
+} //namespace
+
+namespace pe_bliss::image
+{
+
+std::error_code make_error_code(rebuild_planner_errc e) noexcept
+{
+	return { static_cast<int>(e), rebuild_planner_error_category_instance };
+}
+
+rebuild_planner::rebuild_planner(image& instance) noexcept
+	: instance_(instance)
+{
+}
+
+rebuild_planner::~rebuild_planner() = default;
+
+rebuild_planner::rebuild_planner(rebuild_planner&&) noexcept = default;
+
+void rebuild_planner::add_item(std::unique_ptr<impl::rebuild_item> item)
+{
+	items_.emplace_back(std::move(item));
+	plan_.reset();
+}
+
+rebuild_planner& rebuild_planner::add(exports::export_directory& directory,
+	const exports::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		exports::export_directory, exports::builder_options>>(directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(exports::export_directory_details& directory,
+	const exports::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		exports::export_directory_details, exports::builder_options>>(directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(imports::import_directory& directory,
+	const imports::builder_options& options)
+{
+	add_item(std::make_unique<import_rebuild_item<
+		imports::import_directory>>(directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(imports::import_directory_details& directory,
+	const imports::builder_options& options)
+{
+	add_item(std::make_unique<import_rebuild_item<
+		imports::import_directory_details>>(directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(relocations::base_relocation_list& directory,
+	const relocations::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		relocations::base_relocation_list, relocations::builder_options>>(
+			directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(relocations::base_relocation_details_list& directory,
+	const relocations::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		relocations::base_relocation_details_list, relocations::builder_options>>(
+			directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(tls::tls_directory& directory,
+	const tls::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		tls::tls_directory, tls::builder_options>>(directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(tls::tls_directory_details& directory,
+	const tls::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		tls::tls_directory_details, tls::builder_options>>(directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(bound_import::bound_library_list& directory,
+	const bound_import::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		bound_import::bound_library_list, bound_import::builder_options>>(
+			directory, options));
+	return *this;
+}
+
+rebuild_planner& rebuild_planner::add(bound_import::bound_library_details_list& directory,
+	const bound_import::builder_options& options)
+{
+	add_item(std::make_unique<directory_rebuild_item<
+		bound_import::bound_library_details_list, bound_import::builder_options>>(
+			directory, options));
+	return *this;
+}
+
+const rebuild_plan& rebuild_planner::plan(const rebuild_options& options)
+{
+	plan_.reset();
+
+	if (!std::has_single_bit(options.directory_alignment)
+		|| options.directory_alignment < sizeof(std::uint64_t))
+	{
+		throw pe_error(rebuild_planner_errc::invalid_directory_alignment);
+	}
+
+	const auto& optional_header = instance_.get_optional_header();
+	const auto section_alignment = optional_header.get_raw_section_alignment();
+	const auto file_alignment = optional_header.get_raw_file_alignment();
+	const auto& headers = instance_.get_section_table().get_section_headers();
+	const auto& sections = instance_.get_section_data_list();
+	if (headers.size() != sections.size())
+		throw pe_error(image_builder_errc::inconsistent_section_headers_and_data);
+
+	rebuild_plan result;
+	result.size_of_headers = optional_header.get_raw_size_of_headers();
+	std::uint32_t data_offset = 0;
+	if (options.section_index)
+	{
+		result.section_index = *options.section_index;
+		if (result.section_index >= headers.size())
+			throw pe_error(rebuild_planner_errc::invalid_section_index);
+		if (result.section_index != headers.size() - 1u)
+			throw pe_error(rebuild_planner_errc::section_is_not_last);
+
+		const auto& header = headers[result.section_index];
+		result.section_rva = header.get_rva();
+		result.pointer_to_raw_data = header.get_descriptor()->pointer_to_raw_data
+			? header.get_pointer_to_raw_data()
+			: get_raw_data_end(instance_, result.size_of_headers);
+		data_offset = static_cast<std::uint32_t>(sections[result.section_index].size());
+		result.section_virtual_size = header.get_descriptor()->virtual_size;
+	}
+	else
+	{
+		//Throws if the name is too long
+		(void)section::section_header{}.set_name(options.section_name);
+		result.new_section = true;
+		result.section_index = headers.size();
+		result.size_of_headers = get_new_size_of_headers(instance_);
+		result.pointer_to_raw_data = get_raw_data_end(instance_, result.size_of_headers);
+
+		utilities::safe_uint<rva_type> section_rva = result.size_of_headers;
+		if (!headers.empty())
+		{
+			section_rva = headers.back().get_rva();
+			section_rva += headers.back().get_virtual_size(section_alignment);
+		}
+		section_rva.align_up(section_alignment);
+		result.section_rva = section_rva.value();
+	}
+
+	utilities::safe_uint<rva_type> current_rva = result.section_rva;
+	current_rva += data_offset;
+	for (auto& item : items_)
+	{
+		current_rva.align_up(options.directory_alignment);
+		current_rva = item->layout(current_rva.value(),
+			options.directory_alignment, result.entries);
+	}
+
+	auto data_size = current_rva - result.section_rva;
+	result.section_virtual_size = (std::max)(result.section_virtual_size,
+		data_size.value());
+	data_size.align_up(file_alignment);
+	result.section_raw_size = data_size.value();
+
+	options_ = options;
+	return plan_.emplace(std::move(result));
+}
+
+rebuild_plan rebuild_planner::build()
+{
+	if (!plan_)
+		plan();
+
+	auto result = std::move(*plan_);
+	plan_.reset();
+	if (result.entries.empty())
+		return result;
+
+	auto& headers = instance_.get_section_table().get_section_headers();
+	auto& sections = instance_.get_section_data_list();
+	if (result.new_section)
+	{
+		section::section_header header;
+		header.set_name(options_->section_name)
+			.set_characteristics(options_->section_characteristics)
+			.set_rva(result.section_rva)
+			.set_pointer_to_raw_data(result.pointer_to_raw_data)
+			.set_raw_size(result.section_raw_size)
+			.set_virtual_size(result.section_virtual_size);
+		headers.emplace_back(std::move(header));
+		sections.emplace_back().copied_data().resize(result.section_raw_size);
+		instance_.update_number_of_sections();
+		instance_.get_optional_header().set_raw_size_of_headers(result.size_of_headers);
+	}
+	else
+	{
+		auto& header = headers[result.section_index];
+		header.set_pointer_to_raw_data(result.pointer_to_raw_data)
+			.set_raw_size(result.section_raw_size)
+			.set_virtual_size(result.section_virtual_size);
+		//Virtual part of the section data (if any) becomes physical
+		auto& data = sections[result.section_index];
+		auto container = std::move(data.copied_data());
+		container.resize(result.section_raw_size);
+		data = {};
+		data.copied_data() = std::move(container);
+	}
+	instance_.update_image_size();
+
+	for (auto& item : items_)
+		item->build(instance_);
+
+	return result;
+}
+
+} //namespace pe_bliss::image
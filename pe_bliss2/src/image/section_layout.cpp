@@ -0,0 +1,411 @@
+#include "pe_bliss2/image/section_layout.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "buffers/input_buffer_section.h"
+#include "buffers/input_container_buffer.h"
+#include "buffers/input_virtual_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/core/file_header.h"
+#include "pe_bliss2/core/image_signature.h"
+#include "pe_bliss2/detail/image_file_header.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_builder.h"
+#include "pe_bliss2/image/image_errc.h"
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/pe_types.h"
+#include "utilities/generic_error.h"
+#include "utilities/safe_uint.h"
+
+namespace
+{
+
+struct section_layout_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "section_layout";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::image::section_layout_errc;
+		switch (static_cast<pe_bliss::image::section_layout_errc>(ev))
+		{
+		case invalid_section_index:
+			return "Invalid section index";
+		case invalid_section_size:
+			return "Section raw and virtual sizes can not be zero at the same time";
+		default:
+			return {};
+		}
+	}
+};
+
+const section_layout_error_category section_layout_error_category_instance;
+
+using namespace pe_bliss;
+using namespace pe_bliss::image;
+
+struct old_section_info
+{
+	rva_type rva{};
+	std::uint32_t virtual_size{};
+	std::optional<std::size_t> new_index;
+};
+
+struct old_layout
+{
+	std::vector<old_section_info> sections;
+	std::uint64_t raw_data_end{};
+};
+
+std::uint64_t get_raw_data_end(const image::image& instance)
+{
+	const auto& optional_header = instance.get_optional_header();
+	return (std::max)(
+		static_cast<std::uint64_t>(optional_header.get_raw_size_of_headers()),
+		instance.get_section_table().get_raw_data_end_offset(
+			optional_header.get_raw_section_alignment()));
+}
+
+void check_consistency(const image::image& instance)
+{
+	if (instance.get_section_table().get_section_headers().size()
+		!= instance.get_section_data_list().size())
+	{
+		throw pe_error(image_builder_errc::inconsistent_section_headers_and_data);
+	}
+}
+
+old_layout save_layout(const image::image& instance)
+{
+	check_consistency(instance);
+
+	old_layout result;
+	const auto section_alignment
+		= instance.get_optional_header().get_raw_section_alignment();
+	std::size_t index = 0;
+	for (const auto& header : instance.get_section_table().get_section_headers())
+	{
+		result.sections.push_back({
+			.rva = header.get_rva(),
+			.virtual_size = header.get_virtual_size(section_alignment),
+			.new_index = index++
+		});
+	}
+	result.raw_data_end = get_raw_data_end(instance);
+	return result;
+}
+
+std::uint32_t get_section_table_end(const image::image& instance)
+{
+	utilities::safe_uint<std::uint32_t> result
+		= instance.get_dos_header().get_descriptor()->e_lfanew;
+	result += core::image_signature::descriptor_type::packed_size;
+	result += core::file_header::descriptor_type::packed_size;
+	result += instance.get_file_header().get_descriptor()->size_of_optional_header;
+	result += static_cast<std::uint64_t>(
+		instance.get_section_table().get_section_headers().size())
+		* section::section_header::descriptor_type::packed_size;
+	return result.value();
+}
+
+//Returns the index of the first section to lay out
+std::size_t update_size_of_headers(image::image& instance, std::size_t first_index)
+{
+	auto& optional_header = instance.get_optional_header();
+	utilities::safe_uint size_of_headers = get_section_table_end(instance);
+	if (size_of_headers <= optional_header.get_raw_size_of_headers())
+		return first_index;
+
+	size_of_headers.align_up(optional_header.get_raw_file_alignment());
+	optional_header.set_raw_size_of_headers(size_of_headers.value());
+	for (const auto& header : instance.get_section_table().get_section_headers())
+	{
+		if (header.get_rva() < size_of_headers.value()
+			|| (header.get_descriptor()->pointer_to_raw_data
+				&& header.get_pointer_to_raw_data() < size_of_headers.value()))
+		{
+			return 0u;
+		}
+	}
+	return first_index;
+}
+
+void relayout(image::image& instance, std::size_t first_index)
+{
+	first_index = update_size_of_headers(instance, first_index);
+
+	const auto& optional_header = instance.get_optional_header();
+	const auto section_alignment = optional_header.get_raw_section_alignment();
+	const auto file_alignment = optional_header.get_raw_file_alignment();
+	auto& headers = instance.get_section_table().get_section_headers();
+
+	utilities::safe_uint<std::uint32_t> raw_pos
+		= optional_header.get_raw_size_of_headers();
+	utilities::safe_uint<rva_type> rva_pos = raw_pos;
+	for (std::size_t i = 0; i != first_index && i != headers.size(); ++i)
+	{
+		const auto& header = headers[i];
+		if (header.get_descriptor()->pointer_to_raw_data
+			&& header.get_descriptor()->size_of_raw_data)
+		{
+			raw_pos = (std::max)(raw_pos, utilities::safe_uint<std::uint32_t>(
+				header.get_pointer_to_raw_data()) + header.get_descriptor()->size_of_raw_data);
+		}
+		rva_pos = header.get_rva();
+		rva_pos += header.get_virtual_size(section_alignment);
+	}
+
+	for (std::size_t i = first_index; i < headers.size(); ++i)
+	{
+		auto& header = headers[i];
+		rva_pos.align_up(section_alignment);
+		header.set_rva(rva_pos.value());
+		rva_pos += header.get_virtual_size(section_alignment);
+
+		if (header.get_descriptor()->size_of_raw_data)
+		{
+			//Raw data is moved only if it overlaps the previous section data
+			raw_pos.align_up(file_alignment);
+			if (header.get_descriptor()->pointer_to_raw_data < raw_pos.value())
+				header.set_pointer_to_raw_data(raw_pos.value());
+			raw_pos = header.get_descriptor()->pointer_to_raw_data;
+			raw_pos += header.get_descriptor()->size_of_raw_data;
+		}
+	}
+
+	instance.update_number_of_sections();
+	instance.update_image_size();
+}
+
+std::optional<rva_type> map_rva(rva_type rva, const old_layout& layout,
+	const section::section_table::header_list& headers)
+{
+	for (const auto& section : layout.sections)
+	{
+		if (rva < section.rva || rva - section.rva >= section.virtual_size)
+			continue;
+
+		if (!section.new_index)
+			return {};
+
+		return headers[*section.new_index].get_rva() + (rva - section.rva);
+	}
+	return rva;
+}
+
+void update_references(image::image& instance, const old_layout& layout,
+	const section_layout_options& options)
+{
+	if (!options.update_references)
+		return;
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	auto& optional_header = instance.get_optional_header();
+	if (auto entry_point = optional_header.get_raw_address_of_entry_point(); entry_point)
+	{
+		optional_header.set_raw_address_of_entry_point(
+			map_rva(entry_point, layout, headers).value_or(entry_point));
+	}
+	if (auto base_of_code = optional_header.get_raw_base_of_code(); base_of_code)
+	{
+		optional_header.set_raw_base_of_code(
+			map_rva(base_of_code, layout, headers).value_or(base_of_code));
+	}
+	if (!instance.is_64bit())
+	{
+		if (auto base_of_data = optional_header.get_raw_base_of_data(); base_of_data)
+		{
+			optional_header.set_raw_base_of_data(
+				map_rva(base_of_data, layout, headers).value_or(base_of_data));
+		}
+	}
+
+	const auto new_raw_data_end = get_raw_data_end(instance);
+	auto& directories = instance.get_data_directories().get_directories();
+	for (std::size_t i = 0; i != directories.size(); ++i)
+	{
+		auto& dir = directories[i].get();
+		if (!dir.virtual_address)
+			continue;
+
+		if (i == static_cast<std::size_t>(
+			core::data_directories::directory_type::security))
+		{
+			//Security directory contains the file offset. The overlay
+			//follows the section data.
+			if (dir.virtual_address >= layout.raw_data_end)
+			{
+				auto offset = dir.virtual_address - layout.raw_data_end
+					+ new_raw_data_end;
+				if (offset > (std::numeric_limits<std::uint32_t>::max)())
+					throw pe_error(utilities::generic_errc::integer_overflow);
+				dir.virtual_address = static_cast<std::uint32_t>(offset);
+			}
+			continue;
+		}
+
+		if (auto rva = map_rva(dir.virtual_address, layout, headers); rva)
+			dir.virtual_address = *rva;
+		else
+			dir = {};
+	}
+}
+
+void set_section_sizes(section::section_header& header,
+	std::uint32_t raw_size, std::uint32_t virtual_size, std::uint32_t file_alignment)
+{
+	if (!raw_size && !virtual_size)
+		throw pe_error(section_layout_errc::invalid_section_size);
+
+	utilities::safe_uint aligned_raw_size = raw_size;
+	aligned_raw_size.align_up(file_alignment);
+	header.set_raw_size(aligned_raw_size.value());
+	if (!raw_size)
+		header.set_pointer_to_raw_data(0u);
+	header.set_virtual_size(virtual_size);
+}
+
+void resize_section_data(section::section_data& data,
+	std::uint32_t physical_size, std::uint32_t full_size)
+{
+	buffers::input_buffer_ptr physical;
+	if (!data.is_copied() && physical_size <= data.physical_size())
+	{
+		//Keep referencing the original buffer
+		physical = buffers::reduce(data.data(), 0u, physical_size);
+	}
+	else
+	{
+		auto container = std::make_shared<buffers::input_container_buffer>();
+		container->get_container() = std::move(data.copied_data());
+		container->get_container().resize(physical_size);
+		physical = std::move(container);
+	}
+
+	if (full_size > physical_size)
+	{
+		physical = std::make_shared<buffers::input_virtual_buffer>(
+			std::move(physical), full_size - physical_size);
+	}
+	data.get_buffer().deserialize(physical, false);
+}
+
+section::section_table::header_list& get_headers(image::image& instance,
+	std::size_t index, bool allow_end)
+{
+	check_consistency(instance);
+	auto& headers = instance.get_section_table().get_section_headers();
+	if (index > headers.size() || (!allow_end && index == headers.size()))
+		throw pe_error(section_layout_errc::invalid_section_index);
+	return headers;
+}
+
+} //namespace
+
+namespace pe_bliss::image
+{
+
+std::error_code make_error_code(section_layout_errc e) noexcept
+{
+	return { static_cast<int>(e), section_layout_error_category_instance };
+}
+
+section::section_header& insert_section(image& instance, std::size_t index,
+	section::section_header header, section::section_data data,
+	const section_layout_options& options)
+{
+	auto& headers = get_headers(instance, index, true);
+	using number_of_sections_type = decltype(
+		pe_bliss::detail::image_file_header::number_of_sections);
+	if (headers.size() >= (std::numeric_limits<number_of_sections_type>::max)())
+		throw pe_error(image_errc::too_many_sections);
+
+	auto physical_size = data.physical_size();
+	auto data_size = data.size();
+	if (data_size > (std::numeric_limits<std::uint32_t>::max)())
+		throw pe_error(utilities::generic_errc::integer_overflow);
+
+	header.set_pointer_to_raw_data(0u);
+	set_section_sizes(header, static_cast<std::uint32_t>(physical_size),
+		(std::max)(header.get_descriptor()->virtual_size,
+			static_cast<std::uint32_t>(data_size)),
+		instance.get_optional_header().get_raw_file_alignment());
+
+	auto layout = save_layout(instance);
+	for (auto& section : layout.sections)
+	{
+		if (*section.new_index >= index)
+			++*section.new_index;
+	}
+
+	headers.insert(headers.begin() + index, std::move(header));
+	auto& sections = instance.get_section_data_list();
+	sections.insert(sections.begin() + index, std::move(data));
+	relayout(instance, index);
+	update_references(instance, layout, options);
+	return headers[index];
+}
+
+section::section_header& add_section(image& instance,
+	section::section_header header, section::section_data data,
+	const section_layout_options& options)
+{
+	return insert_section(instance,
+		instance.get_section_table().get_section_headers().size(),
+		std::move(header), std::move(data), options);
+}
+
+void resize_section(image& instance, std::size_t index,
+	std::uint32_t raw_size, std::uint32_t virtual_size,
+	const section_layout_options& options)
+{
+	auto& headers = get_headers(instance, index, false);
+	auto layout = save_layout(instance);
+
+	auto& header = headers[index];
+	set_section_sizes(header, raw_size, virtual_size,
+		instance.get_optional_header().get_raw_file_alignment());
+	//Same as the section loader does
+	const auto section_alignment
+		= instance.get_optional_header().get_raw_section_alignment();
+	resize_section_data(instance.get_section_data_list()[index],
+		(std::min)(raw_size, header.get_virtual_size(section_alignment)),
+		header.get_virtual_size(section_alignment));
+
+	relayout(instance, index);
+	update_references(instance, layout, options);
+}
+
+void remove_section(image& instance, std::size_t index,
+	const section_layout_options& options)
+{
+	auto& headers = get_headers(instance, index, false);
+	auto layout = save_layout(instance);
+	for (auto& section : layout.sections)
+	{
+		if (*section.new_index == index)
+			section.new_index.reset();
+		else if (*section.new_index > index)
+			--*section.new_index;
+	}
+
+	headers.erase(headers.begin() + index);
+	auto& sections = instance.get_section_data_list();
+	sections.erase(sections.begin() + index);
+	relayout(instance, index);
+	update_references(instance, layout, options);
+}
+
+} //namespace pe_bliss::image
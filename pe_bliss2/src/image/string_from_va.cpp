@@ -106,4 +106,50 @@ template void string_from_va<packed_utf16_string>(
 	packed_utf16_string& str, bool include_headers,
 	bool allow_virtual_data);
 
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+template packed_list_c_string string_from_rva<packed_list_c_string>(
+	const image& instance, rva_type rva,
+	bool include_headers, bool allow_virtual_data);
+template void string_from_rva<packed_list_c_string>(
+	const image& instance, rva_type rva,
+	packed_list_c_string& str, bool include_headers,
+	bool allow_virtual_data);
+template packed_list_c_string string_from_va<packed_list_c_string>(
+	const image& instance, std::uint32_t va,
+	bool include_headers, bool allow_virtual_data);
+template void string_from_va<packed_list_c_string>(
+	const image& instance, std::uint32_t va,
+	packed_list_c_string& str, bool include_headers,
+	bool allow_virtual_data);
+template packed_list_c_string string_from_va<packed_list_c_string>(
+	const image& instance, std::uint64_t va,
+	bool include_headers, bool allow_virtual_data);
+template void string_from_va<packed_list_c_string>(
+	const image& instance, std::uint64_t va,
+	packed_list_c_string& str, bool include_headers,
+	bool allow_virtual_data);
+
+template packed_list_utf16_string string_from_rva<packed_list_utf16_string>(
+	const image& instance, rva_type rva,
+	bool include_headers, bool allow_virtual_data);
+template void string_from_rva<packed_list_utf16_string>(
+	const image& instance, rva_type rva,
+	packed_list_utf16_string& str, bool include_headers,
+	bool allow_virtual_data);
+template packed_list_utf16_string string_from_va<packed_list_utf16_string>(
+	const image& instance, std::uint32_t va,
+	bool include_headers, bool allow_virtual_data);
+template void string_from_va<packed_list_utf16_string>(
+	const image& instance, std::uint32_t va,
+	packed_list_utf16_string& str, bool include_headers,
+	bool allow_virtual_data);
+template packed_list_utf16_string string_from_va<packed_list_utf16_string>(
+	const image& instance, std::uint64_t va,
+	bool include_headers, bool allow_virtual_data);
+template void string_from_va<packed_list_utf16_string>(
+	const image& instance, std::uint64_t va,
+	packed_list_utf16_string& str, bool include_headers,
+	bool allow_virtual_data);
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
 } //namespace pe_bliss::image
@@ -78,4 +78,32 @@ template rva_type string_to_file_offset<packed_utf16_string>(
 	image& instance, const packed_utf16_string& str,
 	bool include_headers, bool write_virtual_part);
 
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+template rva_type string_to_rva<packed_list_c_string>(
+	image& instance, rva_type rva, const packed_list_c_string& str,
+	bool include_headers, bool write_virtual_part);
+template std::uint32_t string_to_va<packed_list_c_string>(
+	image& instance, std::uint32_t va, const packed_list_c_string& str,
+	bool include_headers, bool write_virtual_part);
+template std::uint64_t string_to_va<packed_list_c_string>(
+	image& instance, std::uint64_t va, const packed_list_c_string& str,
+	bool include_headers, bool write_virtual_part);
+template rva_type string_to_file_offset<packed_list_c_string>(
+	image& instance, const packed_list_c_string& str,
+	bool include_headers, bool write_virtual_part);
+
+template rva_type string_to_rva<packed_list_utf16_string>(
+	image& instance, rva_type rva, const packed_list_utf16_string& str,
+	bool include_headers, bool write_virtual_part);
+template std::uint32_t string_to_va<packed_list_utf16_string>(
+	image& instance, std::uint32_t va, const packed_list_utf16_string& str,
+	bool include_headers, bool write_virtual_part);
+template std::uint64_t string_to_va<packed_list_utf16_string>(
+	image& instance, std::uint64_t va, const packed_list_utf16_string& str,
+	bool include_headers, bool write_virtual_part);
+template rva_type string_to_file_offset<packed_list_utf16_string>(
+	image& instance, const packed_list_utf16_string& str,
+	bool include_headers, bool write_virtual_part);
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
 } //namespace pe_bliss::image
@@ -1,23 +1,31 @@
 #include "pe_bliss2/imports/import_directory_builder.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
-#include <list>
+#include <optional>
+#include <string_view>
 #include <type_traits>
 #include <variant>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
 
 #include "buffers/output_buffer_interface.h"
 #include "buffers/output_memory_ref_buffer.h"
 #include "pe_bliss2/core/data_directories.h"
 #include "pe_bliss2/detail/concepts.h"
+#include "pe_bliss2/detail/string_pool.h"
 #include "pe_bliss2/image/image.h"
 #include "pe_bliss2/image/section_data_from_va.h"
 #include "pe_bliss2/image/string_to_va.h"
 #include "pe_bliss2/image/struct_to_va.h"
 #include "pe_bliss2/packed_struct.h"
+#include "utilities/hash.h"
 #include "utilities/safe_uint.h"
 
 namespace
@@ -26,53 +34,124 @@ namespace
 using namespace pe_bliss;
 using namespace pe_bliss::imports;
 
-struct thunk_count_names_size
+struct hint_name_key
 {
-	std::uint32_t iat_thunk_count{};
+	ordinal_type hint{};
+	std::string_view name;
+
+	[[nodiscard]]
+	friend bool operator==(const hint_name_key&, const hint_name_key&) noexcept = default;
+};
+
+struct hint_name_key_hash
+{
+	std::size_t operator()(const hint_name_key& key) const noexcept
+	{
+		auto result = std::hash<std::string_view>{}(key.name);
+		utilities::hash_combine(result, key.hint);
+		return result;
+	}
+};
+
+//Import directory layout: descriptors, lookup tables (ILT),
+//address tables (IAT, if not placed separately), library names, hints with names.
+struct import_layout
+{
+	explicit import_layout(bool deduplicate_names) noexcept
+		: library_names(deduplicate_names)
+		, hint_names(deduplicate_names)
+	{
+	}
+
+	detail::string_pool<std::string_view> library_names;
+	detail::string_pool<hint_name_key, hint_name_key_hash> hint_names;
+	//Name offset of each library
+	std::vector<std::uint32_t> library_name_offsets;
+	//Hint/name offset of each import by name, in the library order
+	std::vector<std::uint32_t> hint_name_offsets;
 	std::uint32_t ilt_thunk_count{};
-	std::uint32_t names_size{};
+	std::uint32_t iat_thunk_count{};
+	std::uint32_t descriptors_size{};
+	rva_type ilt_rva{};
+	rva_type iat_rva{};
+	rva_type library_names_rva{};
+	rva_type hint_names_rva{};
+	std::uint32_t directory_size{};
 };
 
-template<template <typename, typename> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
-thunk_count_names_size get_thunk_count_and_names_size(
-	const std::vector<ImportedLibrary<Va, Descriptor>>& libraries)
+using safe_rva_type = utilities::safe_uint<rva_type>;
+
+template<template <detail::executable_pointer, typename> typename ImportedLibrary,
+	detail::executable_pointer Va, typename Descriptor, typename Allocator>
+import_layout plan_layout(
+	const std::vector<ImportedLibrary<Va, Descriptor>, Allocator>& libraries,
+	const builder_options& options)
 {
+	import_layout layout(options.deduplicate_names);
+	layout.library_name_offsets.reserve(libraries.size());
+
 	utilities::safe_uint<std::uint32_t> iat_thunk_count;
 	utilities::safe_uint<std::uint32_t> ilt_thunk_count;
-	utilities::safe_uint<std::uint32_t> names_size;
 	for (const auto& library : libraries)
 	{
+		const auto& library_name = library.get_library_name().value();
+		layout.library_name_offsets.push_back(layout.library_names.add(
+			library_name, library_name.size() + 1u)); //nullbyte
+
 		for (const auto& symbol : library.get_imports())
 		{
 			const auto& info = symbol.get_import_info();
 			using symbol_type = std::remove_cvref_t<decltype(symbol)>;
 			if (const auto* ptr = std::get_if<typename symbol_type::hint_name_type>(&info))
 			{
-				names_size += std::remove_pointer_t<std::remove_cvref_t<decltype(ptr)>>
-					::hint_type::packed_size;
-				names_size += ptr->get_name().value().size() + 1; //nullbyte
+				const auto& name = ptr->get_name().value();
+				layout.hint_name_offsets.push_back(layout.hint_names.add(
+					{ ptr->get_hint().get(), name },
+					sizeof(ordinal_type) + name.size() + 1u)); //nullbyte
 			}
 		}
 
-		utilities::safe_uint<std::uint32_t> library_iat_thunk_count;
-		utilities::safe_uint<std::uint32_t> library_ilt_thunk_count;
-		library_iat_thunk_count += library.get_imports().size();
-
+		//Both tables are terminated by a zero thunk
+		utilities::safe_uint<std::uint32_t> library_thunk_count;
+		library_thunk_count += library.get_imports().size();
+		library_thunk_count += 1u;
+		iat_thunk_count += library_thunk_count;
 		if (library.has_lookup_table())
-			library_ilt_thunk_count += library_iat_thunk_count + 1u; //Terminator
-		else
-			library_iat_thunk_count += 1u; //Terminator
+			ilt_thunk_count += library_thunk_count;
+	}
+
+	layout.iat_thunk_count = iat_thunk_count.value();
+	layout.ilt_thunk_count = ilt_thunk_count.value();
+
+	utilities::safe_uint<std::uint32_t> descriptors_size;
+	descriptors_size += static_cast<std::uint64_t>(
+		ImportedLibrary<Va, Descriptor>::descriptor_type::packed_size)
+		* (libraries.size() + 1u); //Terminating descriptor
+	layout.descriptors_size = descriptors_size.value();
+
+	safe_rva_type rva = options.directory_rva;
+	rva += layout.descriptors_size;
+	if (layout.ilt_thunk_count || !options.iat_rva)
+		rva.align_up(sizeof(Va));
 
-		iat_thunk_count += library_iat_thunk_count;
-		ilt_thunk_count += library_ilt_thunk_count;
+	layout.ilt_rva = rva.value();
+	rva += static_cast<std::uint64_t>(layout.ilt_thunk_count) * sizeof(Va);
+	if (options.iat_rva)
+	{
+		layout.iat_rva = *options.iat_rva;
+	}
+	else
+	{
+		layout.iat_rva = rva.value();
+		rva += static_cast<std::uint64_t>(layout.iat_thunk_count) * sizeof(Va);
 	}
 
-	return {
-		.iat_thunk_count = iat_thunk_count.value(),
-		.ilt_thunk_count = ilt_thunk_count.value(),
-		.names_size = names_size.value()
-	};
+	layout.library_names_rva = rva.value();
+	rva += layout.library_names.size();
+	layout.hint_names_rva = rva.value();
+	rva += layout.hint_names.size();
+	layout.directory_size = rva.value() - options.directory_rva;
+	return layout;
 }
 
 template<typename Va>
@@ -86,36 +165,19 @@ std::uint32_t get_aligned_thunk_offset(std::uint32_t base, std::uint32_t offset)
 }
 
 template<template <detail::executable_pointer, typename> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
-built_size get_lib_built_size_impl(const std::vector<ImportedLibrary<Va, Descriptor>>& libraries,
+	detail::executable_pointer Va, typename Descriptor, typename Allocator>
+built_size get_lib_built_size_impl(
+	const std::vector<ImportedLibrary<Va, Descriptor>, Allocator>& libraries,
 	const builder_options& options)
 {
-	static constexpr auto descriptor_size
-		= ImportedLibrary<Va, Descriptor>::descriptor_type::packed_size;
-	auto descriptors_size = static_cast<std::uint64_t>(descriptor_size)
-		* (libraries.size() + 1u); //Terminating descriptor
-
-	utilities::safe_uint<std::uint32_t> directory_size;
-	directory_size += descriptors_size;
-
-	auto size_info = get_thunk_count_and_names_size(libraries);
-	directory_size += size_info.names_size;
-	directory_size += static_cast<std::uint64_t>(size_info.ilt_thunk_count) * sizeof(Va);
-	if (!options.iat_rva) //No separate IAT
-		directory_size += static_cast<std::uint64_t>(size_info.iat_thunk_count) * sizeof(Va);
-	for (const auto& library : libraries)
-		directory_size += library.get_library_name().value().size() + 1u; //nullbyte
-	
-	if (!options.iat_rva || size_info.ilt_thunk_count)
-		directory_size += get_aligned_thunk_offset<Va>(options.directory_rva, descriptor_size);
-
-	auto iat_size = static_cast<std::uint32_t>(size_info.iat_thunk_count * sizeof(Va));
+	auto layout = plan_layout(libraries, options);
+	auto iat_size = static_cast<std::uint32_t>(layout.iat_thunk_count * sizeof(Va));
 	if (options.iat_rva)
 		iat_size += get_aligned_thunk_offset<Va>(*options.iat_rva, 0u);
 
 	return built_size
 	{
-		.directory_size = directory_size.value(),
+		.directory_size = layout.directory_size,
 		.iat_size = iat_size
 	};
 }
@@ -155,9 +217,9 @@ void update_data_directory(image::image& instance, const builder_options& option
 }
 
 template<template <detail::executable_pointer, typename Descriptor> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
+	detail::executable_pointer Va, typename Descriptor, typename Allocator>
 void build_in_place_impl(image::image& instance,
-	const std::vector<ImportedLibrary<Va, Descriptor>>& libraries,
+	const std::vector<ImportedLibrary<Va, Descriptor>, Allocator>& libraries,
 	const builder_options& options)
 {
 	auto last_descriptor_rva = options.directory_rva;
@@ -242,201 +304,138 @@ void build_in_place_impl(image::image& instance, const Directory& directory,
 	}, directory.get_list());
 }
 
-using safe_rva_type = utilities::safe_uint<rva_type>;
+void write_padding(buffers::output_buffer_interface& buf, std::size_t size)
+{
+	static constexpr std::array<std::byte, 8u> zeros{};
+	assert(size <= zeros.size());
+	buf.write(size, zeros.data());
+}
 
-template<template <detail::executable_pointer, typename> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
-safe_rva_type build_library_names(buffers::output_buffer_interface& buf,
-	std::vector<ImportedLibrary<Va, Descriptor>>& libraries, safe_rva_type strings_rva)
+template<typename Va>
+void write_thunks(buffers::output_buffer_interface& buf, std::vector<Va>& thunks)
 {
-	for (auto& library : libraries)
-	{
-		library.get_descriptor()->name = strings_rva.value();
-		strings_rva += library.get_library_name().serialize(buf, true);
-	}
+	for (auto& thunk : thunks)
+		boost::endian::native_to_little_inplace(thunk);
 
-	return strings_rva;
+	buf.write(thunks.size() * sizeof(Va),
+		reinterpret_cast<const std::byte*>(thunks.data()));
 }
 
-template<template <detail::executable_pointer, typename> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
-safe_rva_type build_address_tables(buffers::output_buffer_interface& buf,
-	std::vector<ImportedLibrary<Va, Descriptor>>& libraries,
-	safe_rva_type strings_rva, safe_rva_type thunk_rva)
+void write_library_names(buffers::output_buffer_interface& buf,
+	const std::vector<std::string_view>& names)
 {
-	packed_struct<Va> thunk;
-	for (auto& library : libraries)
+	for (auto name : names)
 	{
-		bool has_lookup = library.has_lookup_table();
-		bool is_bound = library.is_bound();
-		library.get_descriptor()->address_table = thunk_rva.value();
-		if (!has_lookup)
-			library.get_descriptor()->lookup_table = 0u;
-		for (const auto& symbol : library.get_imports())
-		{
-			const auto& info = symbol.get_import_info();
-			using symbol_type = std::remove_cvref_t<decltype(symbol)>;
-			if (const auto* hint_name = std::get_if<typename symbol_type::hint_name_type>(&info); hint_name)
-			{
-				if (has_lookup && is_bound && hint_name->get_imported_va())
-				{
-					thunk = hint_name->get_imported_va()->get();
-				}
-				else
-				{
-					thunk = strings_rva.value();
-					strings_rva += sizeof(ordinal_type)
-						+ hint_name->get_name().value().size() + 1u; //nullbyte
-				}
-			}
-			else if (const auto* ordinal = std::get_if<typename symbol_type::ordinal_type>(&info); ordinal)
-			{
-				if (has_lookup && is_bound && ordinal->get_imported_va())
-					thunk = ordinal->get_imported_va()->get();
-				else
-					thunk = ordinal->to_thunk();
-			}
-			else if (const auto* imported_function_address = std::get_if<
-				typename symbol_type::imported_function_address_type>(&info); imported_function_address)
-			{
-				if (imported_function_address->get_imported_va())
-					thunk = imported_function_address->get_imported_va()->get();
-				else
-					thunk = 0u;
-			}
-
-			thunk_rva += thunk.serialize(buf, true);
-		}
-
-		if (!has_lookup)
-		{
-			thunk = 0u;
-			thunk_rva += thunk.serialize(buf, true);
-		}
+		//Names reference std::string values, which are null-terminated
+		buf.write(name.size() + 1u, reinterpret_cast<const std::byte*>(name.data()));
 	}
+}
 
-	return thunk_rva;
+void write_hint_names(buffers::output_buffer_interface& buf,
+	const std::vector<hint_name_key>& names)
+{
+	for (const auto& [hint, name] : names)
+	{
+		auto hint_le = boost::endian::native_to_little(hint);
+		buf.write(sizeof(hint_le), reinterpret_cast<const std::byte*>(&hint_le));
+		buf.write(name.size() + 1u, reinterpret_cast<const std::byte*>(name.data()));
+	}
 }
 
 template<template <detail::executable_pointer, typename> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
-safe_rva_type build_lookup_tables(buffers::output_buffer_interface& buf,
-	std::vector<ImportedLibrary<Va, Descriptor>>& libraries,
-	safe_rva_type strings_rva, safe_rva_type thunk_rva)
+	detail::executable_pointer Va, typename Descriptor, typename Allocator>
+void fill_thunks(std::vector<ImportedLibrary<Va, Descriptor>, Allocator>& libraries,
+	const import_layout& layout, std::vector<Va>& ilt, std::vector<Va>& iat)
 {
-	packed_struct<Va> thunk;
+	ilt.reserve(layout.ilt_thunk_count);
+	iat.reserve(layout.iat_thunk_count);
+	auto hint_name_offset = layout.hint_name_offsets.cbegin();
+	auto library_name_offset = layout.library_name_offsets.cbegin();
 	for (auto& library : libraries)
 	{
-		if (!library.has_lookup_table())
-			continue;
-		
-		library.get_descriptor()->lookup_table = thunk_rva.value();
+		bool has_lookup = library.has_lookup_table();
+		bool is_bound = library.is_bound();
+		auto& descriptor = library.get_descriptor();
+		descriptor->name = layout.library_names_rva + *library_name_offset++;
+		descriptor->address_table = static_cast<rva_type>(
+			layout.iat_rva + iat.size() * sizeof(Va));
+		descriptor->lookup_table = has_lookup ? static_cast<rva_type>(
+			layout.ilt_rva + ilt.size() * sizeof(Va)) : 0u;
+
 		for (const auto& symbol : library.get_imports())
 		{
 			const auto& info = symbol.get_import_info();
 			using symbol_type = std::remove_cvref_t<decltype(symbol)>;
+			Va lookup_thunk{};
+			std::optional<Va> bound_va;
 			if (const auto* hint_name = std::get_if<typename symbol_type::hint_name_type>(&info); hint_name)
 			{
-				thunk = strings_rva.value();
-				strings_rva += sizeof(ordinal_type)
-					+ hint_name->get_name().value().size() + 1u; //nullbyte
+				lookup_thunk = layout.hint_names_rva + *hint_name_offset++;
+				if (hint_name->get_imported_va())
+					bound_va = hint_name->get_imported_va()->get();
 			}
 			else if (const auto* ordinal = std::get_if<typename symbol_type::ordinal_type>(&info); ordinal)
 			{
-				thunk = ordinal->to_thunk();
+				lookup_thunk = ordinal->to_thunk();
+				if (ordinal->get_imported_va())
+					bound_va = ordinal->get_imported_va()->get();
 			}
 			else if (const auto* imported_function_address = std::get_if<
 				typename symbol_type::imported_function_address_type>(&info); imported_function_address)
 			{
 				if (imported_function_address->get_imported_va())
-					thunk = imported_function_address->get_imported_va()->get();
-				else
-					thunk = 0u;
+					lookup_thunk = imported_function_address->get_imported_va()->get();
+				bound_va = lookup_thunk;
 			}
 
-			thunk_rva += thunk.serialize(buf, true);
+			if (has_lookup)
+				ilt.push_back(lookup_thunk);
+			iat.push_back(has_lookup && is_bound && bound_va ? *bound_va : lookup_thunk);
 		}
 
-		thunk = 0u;
-		thunk_rva += thunk.serialize(buf, true);
-	}
-
-	return thunk_rva;
-}
-
-template<template <detail::executable_pointer, typename> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
-void build_hints_with_names(buffers::output_buffer_interface& buf,
-	const std::vector<ImportedLibrary<Va, Descriptor>>& libraries, safe_rva_type strings_rva)
-{
-	for (auto& library : libraries)
-	{
-		for (auto& symbol : library.get_imports())
-		{
-			const auto& info = symbol.get_import_info();
-			using symbol_type = std::remove_cvref_t<decltype(symbol)>;
-			if (const auto* ptr = std::get_if<typename symbol_type::hint_name_type>(&info))
-			{
-				strings_rva += ptr->get_hint().serialize(buf, true);
-				strings_rva += ptr->get_name().serialize(buf, true);
-			}
-		}
+		//Terminators
+		if (has_lookup)
+			ilt.push_back(0u);
+		iat.push_back(0u);
 	}
 }
 
 template<template <detail::executable_pointer, typename Descriptor> typename ImportedLibrary,
-	detail::executable_pointer Va, typename Descriptor>
+	detail::executable_pointer Va, typename Descriptor, typename Allocator>
 build_result build_new_impl(buffers::output_buffer_interface& buf,
 	buffers::output_buffer_interface* iat_buf,
-	std::vector<ImportedLibrary<Va, Descriptor>>& libraries,
+	std::vector<ImportedLibrary<Va, Descriptor>, Allocator>& libraries,
 	const builder_options& options)
 {
-	build_result result{};
-	utilities::safe_uint<std::size_t> base_wpos = buf.wpos();
-	auto size_info = get_thunk_count_and_names_size(libraries);
+	auto layout = plan_layout(libraries, options);
+	std::vector<Va> ilt, iat;
+	fill_thunks(libraries, layout, ilt, iat);
 
-	auto descriptor_rva = options.directory_rva;
-	safe_rva_type thunk_rva = descriptor_rva;
-	thunk_rva += (libraries.size() + 1u)
-		* ImportedLibrary<Va, Descriptor>::descriptor_type::packed_size;
-
-	bool has_thunks_together_with_descriptors = size_info.ilt_thunk_count || !options.iat_rva;
-	if (has_thunks_together_with_descriptors)
-		thunk_rva.align_up(sizeof(Va));
-
-	auto strings_rva = thunk_rva + size_info.ilt_thunk_count * sizeof(Va);
-	if (!options.iat_rva)
-		strings_rva += size_info.iat_thunk_count * sizeof(Va);
-
-	buf.set_wpos((base_wpos + strings_rva - descriptor_rva).value());
-	strings_rva = build_library_names(buf, libraries, strings_rva);
-
-	if (has_thunks_together_with_descriptors)
-	{
-		buf.set_wpos((base_wpos + thunk_rva - descriptor_rva).value());
-		thunk_rva = build_lookup_tables(buf, libraries, strings_rva, thunk_rva);
-	}
+	auto base_wpos = buf.wpos();
+	for (const auto& library : libraries)
+		library.get_descriptor().serialize(buf, true);
 
-	if (options.iat_rva)
-		thunk_rva = *options.iat_rva;
-	auto prev_thunk_rva = thunk_rva.value();
-	thunk_rva = build_address_tables(iat_buf ? *iat_buf : buf, libraries, strings_rva, thunk_rva);
-	result.iat_rva = thunk_rva.value();
-	result.iat_size = thunk_rva.value() - prev_thunk_rva;
+	//Terminator
+	typename ImportedLibrary<Va, Descriptor>::descriptor_type{}.serialize(buf, true);
+	write_padding(buf, layout.ilt_rva - options.directory_rva - layout.descriptors_size);
 
-	buf.set_wpos((base_wpos + strings_rva - descriptor_rva).value());
-	build_hints_with_names(buf, libraries, strings_rva);
+	build_result result{
+		.iat_rva = layout.iat_rva,
+		.iat_size = static_cast<std::uint32_t>(iat.size() * sizeof(Va)),
+		.descriptors_size = layout.descriptors_size
+	};
 
-	result.full_size = static_cast<std::uint32_t>(buf.wpos() - base_wpos.value());
-	buf.set_wpos(base_wpos.value());
-	for (auto& library : libraries)
-		library.get_descriptor().serialize(buf, true);
+	write_thunks(buf, ilt);
+	if (!options.iat_rva)
+		write_thunks(buf, iat);
+	else if (iat_buf)
+		write_thunks(*iat_buf, iat);
 
-	//Terminator
-	packed_struct<detail::imports::image_import_descriptor>{}.serialize(buf, true);
-	result.descriptors_size = static_cast<std::uint32_t>((libraries.size() + 1u)
-		* ImportedLibrary<Va, Descriptor>::descriptor_type::packed_size);
+	write_library_names(buf, layout.library_names.get_keys());
+	write_hint_names(buf, layout.hint_names.get_keys());
 
+	result.full_size = static_cast<std::uint32_t>(buf.wpos() - base_wpos);
+	assert(result.full_size == layout.directory_size);
 	return result;
 }
 
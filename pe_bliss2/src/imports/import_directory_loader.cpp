@@ -13,6 +13,7 @@
 #include "pe_bliss2/image/struct_from_va.h"
 #include "pe_bliss2/pe_error.h"
 #include "pe_bliss2/pe_types.h"
+#include "utilities/list_allocator.h"
 #include "utilities/safe_uint.h"
 
 namespace
@@ -72,6 +73,10 @@ rva_type load_library(const image::image& instance, const loader_options& option
 	rva_type current_descriptor_rva, ImportList& import_list, Directory& directory)
 {
 	auto& library = import_list.emplace_back();
+	library.use_error_memory_resource(options.memory_resource);
+	utilities::use_memory_resource(library.get_imports(), options.memory_resource);
+	utilities::use_memory_resource(library.get_library_name().value(),
+		options.memory_resource);
 	auto& descriptor = library.get_descriptor();
 
 	try
@@ -156,6 +161,7 @@ bool load_import(const image::image& instance, const loader_options& options,
 {
 	auto& imports = library.get_imports();
 	auto& new_import = imports.emplace_back();
+	new_import.use_error_memory_resource(options.memory_resource);
 
 	try
 	{
@@ -235,6 +241,7 @@ bool load_import(const image::image& instance, const loader_options& options,
 
 	auto& info = new_import.get_import_info()
 		.template emplace<imported_function_hint_and_name<Va>>();
+	utilities::use_memory_resource(info.get_name().value(), options.memory_resource);
 	add_imported_va(instance, new_import, library);
 	utilities::safe_uint<rva_type> hint_name_rva;
 	try
@@ -274,10 +281,10 @@ bool load_import(const image::image& instance, const loader_options& options,
 	return true;
 }
 
-template<typename Va, typename Directory, typename Descriptor>
+template<typename Va, typename Directory, typename Descriptor, typename Allocator>
 void load_impl(const image::image& instance, const loader_options& options,
 	rva_type current_descriptor_rva,
-	std::vector<imported_library_details<Va, Descriptor>>& import_list,
+	std::vector<imported_library_details<Va, Descriptor>, Allocator>& import_list,
 	Directory& directory)
 {
 	while ((current_descriptor_rva = load_library(
@@ -339,19 +346,20 @@ std::optional<Directory> load_generic(const image::image& instance,
 		return result;
 
 	auto& directory = result.emplace();
+	directory.use_error_memory_resource(options.memory_resource);
 	if (instance.is_64bit())
 	{
-		load_impl(instance, options, imports_rva,
-			directory.get_list().template emplace<
-				std::vector<typename Directory::imported_library64_type>>(),
-			directory);
+		auto& list = directory.get_list().template emplace<
+			typename Directory::imported_library64_list_type>();
+		utilities::use_memory_resource(list, options.memory_resource);
+		load_impl(instance, options, imports_rva, list, directory);
 	}
 	else
 	{
-		load_impl(instance, options, imports_rva,
-			directory.get_list().template emplace<
-				std::vector<typename Directory::imported_library32_type>>(),
-			directory);
+		auto& list = directory.get_list().template emplace<
+			typename Directory::imported_library32_list_type>();
+		utilities::use_memory_resource(list, options.memory_resource);
+		load_impl(instance, options, imports_rva, list, directory);
 	}
 
 	return result;
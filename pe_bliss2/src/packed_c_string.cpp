@@ -9,6 +9,7 @@
 #include "buffers/output_buffer_interface.h"
 #include "pe_bliss2/pe_error.h"
 #include "utilities/generic_error.h"
+#include "utilities/list_allocator.h"
 
 namespace pe_bliss
 {
@@ -23,7 +24,7 @@ void packed_c_string_base<String>::deserialize(
 	
 	typename string_type::value_type ch{};
 	static constexpr typename string_type::value_type nullbyte{};
-	string_type value;
+	string_type value(value_.get_allocator());
 	std::size_t read_bytes{};
 	while ((read_bytes = buf.read(sizeof(ch),
 		reinterpret_cast<std::byte*>(&ch))) == sizeof(ch))
@@ -92,5 +93,8 @@ std::size_t packed_c_string_base<String>::serialize(std::byte* buf,
 
 template class packed_c_string_base<std::string>;
 template class packed_c_string_base<std::u16string>;
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+template class packed_c_string_base<utilities::list_string>;
+#endif //PE_BLISS_ENABLE_PMR_LISTS
 
 } //namespace pe_bliss
@@ -12,17 +12,18 @@
 #include "buffers/output_buffer_interface.h"
 #include "pe_bliss2/pe_error.h"
 #include "utilities/generic_error.h"
+#include "utilities/list_allocator.h"
 
 namespace pe_bliss
 {
 
-static_assert(sizeof(packed_utf16_string::string_type::value_type)
-	== sizeof(std::uint16_t),
-	"This facility only supports strings with size of a character equal to 2 bytes");
-
-void packed_utf16_string::deserialize(buffers::input_buffer_stateful_wrapper_ref& buf,
-	bool allow_virtual_data)
+template<typename String>
+void packed_utf16_string_base<String>::deserialize(
+	buffers::input_buffer_stateful_wrapper_ref& buf, bool allow_virtual_data)
 {
+	static_assert(sizeof(typename string_type::value_type) == sizeof(std::uint16_t),
+		"This facility only supports strings with size of a character equal to 2 bytes");
+
 	buffers::serialized_data_state state(buf);
 
 	std::uint16_t string_length{};
@@ -33,12 +34,12 @@ void packed_utf16_string::deserialize(buffers::input_buffer_stateful_wrapper_ref
 
 	boost::endian::little_to_native_inplace(string_length);
 	auto virtual_size = sizeof(string_length)
-		+ string_length * sizeof(string_type::value_type);
+		+ string_length * sizeof(typename string_type::value_type);
 	auto physical_size = size_bytes_read;
 
-	string_type::value_type ch{};
+	typename string_type::value_type ch{};
 	std::size_t index = 0;
-	string_type value(string_length, u'\0');
+	string_type value(string_length, u'\0', value_.get_allocator());
 	while (string_length && (size_bytes_read = buf.read(sizeof(ch),
 		reinterpret_cast<std::byte*>(&ch))) != 0)
 	{
@@ -59,8 +60,9 @@ void packed_utf16_string::deserialize(buffers::input_buffer_stateful_wrapper_ref
 	virtual_size_ = virtual_size;
 }
 
+template<typename String>
 template<typename WriteChar, typename WriteRemaining>
-std::size_t packed_utf16_string::serialize(WriteChar&& write_part,
+std::size_t packed_utf16_string_base<String>::serialize(WriteChar&& write_part,
 	WriteRemaining&& write_remaining, bool write_virtual_part) const
 {
 	auto remaining_size = physical_size_;
@@ -95,7 +97,9 @@ std::size_t packed_utf16_string::serialize(WriteChar&& write_part,
 	return write_virtual_part ? virtual_size_ : physical_size_;
 }
 
-std::size_t packed_utf16_string::serialize(buffers::output_buffer_interface& buf,
+template<typename String>
+std::size_t packed_utf16_string_base<String>::serialize(
+	buffers::output_buffer_interface& buf,
 	bool write_virtual_part) const
 {
 	return serialize([&buf] (std::size_t bytes_to_write, const std::byte* data) {
@@ -107,7 +111,8 @@ std::size_t packed_utf16_string::serialize(buffers::output_buffer_interface& buf
 	}, write_virtual_part);
 }
 
-std::size_t packed_utf16_string::serialize(std::byte* buf,
+template<typename String>
+std::size_t packed_utf16_string_base<String>::serialize(std::byte* buf,
 	std::size_t max_size, bool write_virtual_part) const
 {
 	std::size_t total_size = write_virtual_part
@@ -123,30 +128,39 @@ std::size_t packed_utf16_string::serialize(std::byte* buf,
 	}, write_virtual_part);
 }
 
-void packed_utf16_string::set_data_size(std::size_t size) noexcept
+template<typename String>
+void packed_utf16_string_base<String>::set_data_size(std::size_t size) noexcept
 {
 	virtual_size_ = size;
 	if (virtual_size_ < physical_size_)
 		virtual_size_ = physical_size_;
 }
 
-void packed_utf16_string::set_physical_size(std::size_t size) noexcept
+template<typename String>
+void packed_utf16_string_base<String>::set_physical_size(std::size_t size) noexcept
 {
 	physical_size_ = (std::min)(size, sizeof(std::uint16_t)
-		+ value_.size() * sizeof(string_type::value_type));
+		+ value_.size() * sizeof(typename string_type::value_type));
 	if (virtual_size_ < physical_size_)
 		virtual_size_ = physical_size_;
 }
 
-void packed_utf16_string::sync_physical_size() noexcept
+template<typename String>
+void packed_utf16_string_base<String>::sync_physical_size() noexcept
 {
 	set_physical_size((std::numeric_limits<std::size_t>::max)());
 }
 
-std::size_t packed_utf16_string::virtual_string_length() const noexcept
+template<typename String>
+std::size_t packed_utf16_string_base<String>::virtual_string_length() const noexcept
 {
 	return (virtual_size_ - sizeof(std::uint16_t))
-		/ sizeof(string_type::value_type);
+		/ sizeof(typename string_type::value_type);
 }
 
+template class packed_utf16_string_base<std::u16string>;
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+template class packed_utf16_string_base<utilities::list_u16string>;
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
 } //namespace pe_bliss
@@ -1,9 +1,17 @@
 #include "pe_bliss2/relocations/relocation_directory_builder.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
 
 #include "buffers/output_buffer_interface.h"
 #include "buffers/output_memory_ref_buffer.h"
@@ -13,12 +21,37 @@
 #include "pe_bliss2/image/image.h"
 #include "pe_bliss2/image/section_data_from_va.h"
 #include "pe_bliss2/image/struct_to_va.h"
+#include "pe_bliss2/pe_error.h"
 #include "utilities/generic_error.h"
 #include "utilities/safe_uint.h"
 
 namespace
 {
 
+struct relocation_directory_builder_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "relocation_directory_builder";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::relocations::relocation_directory_builder_errc;
+		switch (static_cast<pe_bliss::relocations::relocation_directory_builder_errc>(ev))
+		{
+		case invalid_relocation_type:
+			return "Relocation type does not fit into 4 bits";
+		case unsorted_fixups:
+			return "Fixups are not sorted by RVA";
+		default:
+			return {};
+		}
+	}
+};
+
+const relocation_directory_builder_error_category relocation_directory_builder_error_category_instance;
+
 using namespace pe_bliss;
 using namespace pe_bliss::relocations;
 
@@ -143,11 +176,178 @@ std::uint32_t build_new_impl(image::image& instance, Directory& directory,
 	return result;
 }
 
+//Fixups are sorted using std::stable_sort if there are less of them
+constexpr std::size_t min_radix_sort_size = 256u;
+constexpr rva_type page_mask = 0xfffu;
+constexpr unsigned type_shift = 12u;
+constexpr std::uint16_t max_type = 0xfu;
+
+using block_entry_list = std::vector<detail::relocations::type_or_offset_entry>;
+
+//Fixups are sorted by RVA only, so duplicates are not necessarily adjacent:
+//the fixup is compared against all preceding fixups with the same RVA.
+[[nodiscard]]
+bool skip_fixup(std::span<const relocation_fixup> same_rva_fixups,
+	const relocation_fixup& fixup) noexcept
+{
+	return fixup.type == relocation_type::absolute
+		|| std::find(same_rva_fixups.begin(), same_rva_fixups.end(), fixup)
+			!= same_rva_fixups.end();
+}
+
+//Calls func(page_rva, fixups_of_page) for each page which has fixups
+template<typename Func>
+void for_each_page(std::span<const relocation_fixup> fixups, Func&& func)
+{
+	auto it = fixups.begin();
+	while (it != fixups.end())
+	{
+		auto page_rva = it->rva & ~page_mask;
+		auto page_end = std::find_if(it, fixups.end(), [page_rva](const auto& fixup) {
+			return (fixup.rva & ~page_mask) != page_rva;
+		});
+		func(page_rva, std::span<const relocation_fixup>(it, page_end));
+		it = page_end;
+	}
+}
+
+void get_page_entries(std::span<const relocation_fixup> fixups,
+	block_entry_list& entries)
+{
+	entries.clear();
+	std::size_t same_rva_begin = 0;
+	for (std::size_t i = 0; i != fixups.size(); ++i)
+	{
+		const auto& fixup = fixups[i];
+		if (static_cast<std::uint16_t>(fixup.type) > max_type)
+			throw pe_error(relocation_directory_builder_errc::invalid_relocation_type);
+		if (fixup.rva != fixups[same_rva_begin].rva)
+			same_rva_begin = i;
+		if (skip_fixup(fixups.subspan(same_rva_begin, i - same_rva_begin), fixup))
+			continue;
+
+		entries.push_back(static_cast<detail::relocations::type_or_offset_entry>(
+			(static_cast<std::uint16_t>(fixup.type) << type_shift) | (fixup.rva & page_mask)));
+		if (fixup.type == relocation_type::highadj)
+			entries.push_back(fixup.param);
+	}
+}
+
+std::uint32_t get_fixups_built_size(std::span<const relocation_fixup> fixups,
+	const builder_options& options)
+{
+	if (!std::is_sorted(fixups.begin(), fixups.end(), [](const auto& l, const auto& r) {
+		return l.rva < r.rva; }))
+	{
+		throw pe_error(relocation_directory_builder_errc::unsorted_fixups);
+	}
+
+	utilities::safe_uint<std::uint32_t> result;
+	block_entry_list entries;
+	for_each_page(fixups, [&](rva_type, std::span<const relocation_fixup> page_fixups) {
+		get_page_entries(page_fixups, entries);
+		if (entries.empty())
+			return;
+
+		auto elem_count = entries.size();
+		if (options.align_base_relocation_structures && (elem_count % 2))
+			++elem_count;
+
+		result += base_relocation::descriptor_type::packed_size;
+		result += elem_count * sizeof(detail::relocations::type_or_offset_entry);
+	});
+	return result.value();
+}
+
+std::uint32_t build_fixups_impl(buffers::output_buffer_interface& buf,
+	std::span<const relocation_fixup> fixups, const builder_options& options)
+{
+	assert(options.directory_rva);
+
+	auto base_wpos = buf.wpos();
+	packed_struct<detail::relocations::image_base_relocation> descriptor;
+	block_entry_list entries;
+	for_each_page(fixups, [&](rva_type page_rva, std::span<const relocation_fixup> page_fixups) {
+		get_page_entries(page_fixups, entries);
+		if (entries.empty())
+			return;
+
+		if (options.align_base_relocation_structures && (entries.size() % 2))
+			entries.push_back(static_cast<std::uint16_t>(relocation_type::absolute));
+
+		utilities::safe_uint<std::uint32_t> size;
+		size += descriptor.packed_size;
+		size += entries.size() * sizeof(detail::relocations::type_or_offset_entry);
+		descriptor->virtual_address = page_rva;
+		descriptor->size_of_block = size.value();
+		descriptor.serialize(buf, true);
+
+		for (auto& entry : entries)
+			boost::endian::native_to_little_inplace(entry);
+		buf.write(entries.size() * sizeof(detail::relocations::type_or_offset_entry),
+			reinterpret_cast<const std::byte*>(entries.data()));
+	});
+
+	return static_cast<std::uint32_t>(buf.wpos() - base_wpos);
+}
+
+std::uint32_t build_fixups_impl(image::image& instance,
+	std::span<const relocation_fixup> fixups, const builder_options& options)
+{
+	assert(options.directory_rva);
+	auto buf = buffers::output_memory_ref_buffer(section_data_from_rva(instance, options.directory_rva, true));
+	auto result = build_fixups_impl(buf, fixups, options);
+	update_data_directory(instance, options, result);
+	return result;
+}
+
+template<typename Directory>
+void append_fixups_impl(const Directory& directory, std::vector<relocation_fixup>& fixups)
+{
+	for (const auto& basereloc : directory)
+	{
+		auto page_rva = basereloc.get_descriptor()->virtual_address;
+		for (const auto& entry : basereloc.get_relocations())
+		{
+			if (entry.get_type() == relocation_type::absolute)
+				continue;
+
+			utilities::safe_uint rva = page_rva;
+			rva += entry.get_address();
+			fixups.push_back({
+				.rva = rva.value(),
+				.type = entry.get_type(),
+				.param = entry.get_param() ? entry.get_param()->get() : std::uint16_t{}
+			});
+		}
+	}
+}
+
+template<typename Directory>
+std::vector<relocation_fixup> merge_fixups(const Directory& directory,
+	std::span<const relocation_fixup> fixups)
+{
+	std::vector<relocation_fixup> result;
+	std::size_t directory_fixup_count = 0;
+	for (const auto& basereloc : directory)
+		directory_fixup_count += basereloc.get_relocations().size();
+	result.reserve(directory_fixup_count + fixups.size());
+	append_fixups_impl(directory, result);
+	result.insert(result.end(), fixups.begin(), fixups.end());
+	sort_fixups(result);
+	return result;
+}
+
 } //namespace
 
 namespace pe_bliss::relocations
 {
 
+std::error_code make_error_code(relocation_directory_builder_errc e) noexcept
+{
+	return { static_cast<int>(e), relocation_directory_builder_error_category_instance };
+}
+
 void build_in_place(image::image& instance, const base_relocation_details_list& directory,
 	const builder_options& options)
 {
@@ -196,4 +396,105 @@ std::uint32_t get_built_size(const base_relocation_list& directory,
 	return get_built_size_impl(directory, options);
 }
 
+void sort_fixups(std::span<relocation_fixup> fixups)
+{
+	static constexpr auto rva_less = [](const auto& l, const auto& r) {
+		return l.rva < r.rva;
+	};
+
+	if (fixups.size() < min_radix_sort_size)
+	{
+		std::stable_sort(fixups.begin(), fixups.end(), rva_less);
+		return;
+	}
+
+	//LSD radix sort, one byte of the RVA per pass
+	static constexpr std::size_t bits_per_pass = 8u;
+	std::vector<relocation_fixup> temp(fixups.size());
+	std::span<relocation_fixup> from = fixups;
+	std::span<relocation_fixup> to = temp;
+	for (std::size_t shift = 0; shift != sizeof(rva_type) * 8u; shift += bits_per_pass)
+	{
+		std::array<std::size_t, 1u << bits_per_pass> offsets{};
+		for (const auto& fixup : from)
+			++offsets[(fixup.rva >> shift) & 0xffu];
+
+		//All fixups have the same digit
+		if (offsets[(from.front().rva >> shift) & 0xffu] == from.size())
+			continue;
+
+		std::size_t offset = 0;
+		for (auto& count : offsets)
+			offset += std::exchange(count, offset);
+
+		for (const auto& fixup : from)
+			to[offsets[(fixup.rva >> shift) & 0xffu]++] = fixup;
+
+		std::swap(from, to);
+	}
+
+	if (from.data() != fixups.data())
+		std::copy(from.begin(), from.end(), fixups.begin());
+}
+
+void append_fixups(const base_relocation_details_list& directory,
+	std::vector<relocation_fixup>& fixups)
+{
+	append_fixups_impl(directory, fixups);
+}
+
+void append_fixups(const base_relocation_list& directory,
+	std::vector<relocation_fixup>& fixups)
+{
+	append_fixups_impl(directory, fixups);
+}
+
+std::uint32_t build_new(image::image& instance, std::span<relocation_fixup> fixups,
+	const builder_options& options)
+{
+	sort_fixups(fixups);
+	return build_fixups_impl(instance, fixups, options);
+}
+
+std::uint32_t build_new(buffers::output_buffer_interface& buf,
+	std::span<relocation_fixup> fixups, const builder_options& options)
+{
+	sort_fixups(fixups);
+	return build_fixups_impl(buf, fixups, options);
+}
+
+std::uint32_t build_merged(image::image& instance,
+	const base_relocation_details_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options)
+{
+	return build_fixups_impl(instance, merge_fixups(directory, fixups), options);
+}
+
+std::uint32_t build_merged(image::image& instance,
+	const base_relocation_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options)
+{
+	return build_fixups_impl(instance, merge_fixups(directory, fixups), options);
+}
+
+std::uint32_t build_merged(buffers::output_buffer_interface& buf,
+	const base_relocation_details_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options)
+{
+	return build_fixups_impl(buf, merge_fixups(directory, fixups), options);
+}
+
+std::uint32_t build_merged(buffers::output_buffer_interface& buf,
+	const base_relocation_list& directory,
+	std::span<const relocation_fixup> fixups, const builder_options& options)
+{
+	return build_fixups_impl(buf, merge_fixups(directory, fixups), options);
+}
+
+std::uint32_t get_built_size(std::span<const relocation_fixup> fixups,
+	const builder_options& options)
+{
+	return get_fixups_built_size(fixups, options);
+}
+
 } //namespace pe_bliss::relocations
@@ -1,5 +1,12 @@
 #include "pe_bliss2/resources/cpid.h"
 
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "utilities/sorted_table.h"
+#include "utilities/string.h"
+
 namespace pe_bliss::resources
 {
 
@@ -8,176 +15,187 @@ namespace
 //See https://docs.microsoft.com/en-us/windows/win32/intl/code-page-identifiers,
 //https://docs.microsoft.com/en-us/windows/win32/menurc/varfileinfo-block
 
-std::string_view get_cpid_name_impl(code_page cpid) noexcept
-{
-	using enum code_page;
-	switch (cpid)
+constexpr auto cpid_to_name = utilities::make_sorted_table<
+	code_page, std::string_view>({
+	{ code_page::ibm037, "IBM037" },
+	{ code_page::ibm437, "IBM437" },
+	{ code_page::ibm500, "IBM500" },
+	{ code_page::asmo_708, "ASMO-708" },
+	{ code_page::arabic_asmo_449, "Arabic(ASMO-449+, BCON V4)" },
+	{ code_page::arabic_transparent_arabic, "Arabic - Transparent Arabic" },
+	{ code_page::dos_720, "DOS-720" },
+	{ code_page::ibm737, "ibm737" },
+	{ code_page::ibm775, "ibm775" },
+	{ code_page::ibm850, "ibm850" },
+	{ code_page::ibm852, "ibm852" },
+	{ code_page::ibm855, "IBM855" },
+	{ code_page::ibm857, "ibm857" },
+	{ code_page::ibm00858, "IBM00858" },
+	{ code_page::ibm860, "IBM860" },
+	{ code_page::ibm861, "ibm861" },
+	{ code_page::dos_862, "DOS-862" },
+	{ code_page::ibm863, "IBM863" },
+	{ code_page::ibm864, "IBM864" },
+	{ code_page::ibm865, "IBM865" },
+	{ code_page::cp866, "cp866" },
+	{ code_page::ibm869, "ibm869" },
+	{ code_page::ibm870, "IBM870" },
+	{ code_page::windows_874, "windows-874" },
+	{ code_page::cp875, "cp875" },
+	{ code_page::shift_jis, "shift_jis" },
+	{ code_page::gb2312, "gb2312" },
+	{ code_page::ks_c_5601_1987, "ks_c_5601-1987" },
+	{ code_page::big5, "big5" },
+	{ code_page::ibm1026, "IBM1026" },
+	{ code_page::ibm01047, "IBM01047" },
+	{ code_page::ibm01140, "IBM01140" },
+	{ code_page::ibm01141, "IBM01141" },
+	{ code_page::ibm01142, "IBM01142" },
+	{ code_page::ibm01143, "IBM01143" },
+	{ code_page::ibm01144, "IBM01144" },
+	{ code_page::ibm01145, "IBM01145" },
+	{ code_page::ibm01146, "IBM01146" },
+	{ code_page::ibm01147, "IBM01147" },
+	{ code_page::ibm01148, "IBM01148" },
+	{ code_page::ibm01149, "IBM01149" },
+	{ code_page::utf_16, "utf-16" },
+	{ code_page::unicodefffe, "unicodeFFFE" },
+	{ code_page::windows_1250, "windows-1250" },
+	{ code_page::windows_1251, "windows-1251" },
+	{ code_page::windows_1252, "windows-1252" },
+	{ code_page::windows_1253, "windows-1253" },
+	{ code_page::windows_1254, "windows-1254" },
+	{ code_page::windows_1255, "windows-1255" },
+	{ code_page::windows_1256, "windows-1256" },
+	{ code_page::windows_1257, "windows-1257" },
+	{ code_page::windows_1258, "windows-1258" },
+	{ code_page::johab, "Johab" },
+	{ code_page::macintosh, "macintosh" },
+	{ code_page::x_mac_japanese, "x-mac-japanese" },
+	{ code_page::x_mac_chinesetrad, "x-mac-chinesetrad" },
+	{ code_page::x_mac_korean, "x-mac-korean" },
+	{ code_page::x_mac_arabic, "x-mac-arabic" },
+	{ code_page::x_mac_hebrew, "x-mac-hebrew" },
+	{ code_page::x_mac_greek, "x-mac-greek" },
+	{ code_page::x_mac_cyrillic, "x-mac-cyrillic" },
+	{ code_page::x_mac_chinesesimp, "x-mac-chinesesimp" },
+	{ code_page::x_mac_romanian, "x-mac-romanian" },
+	{ code_page::x_mac_ukrainian, "x-mac-ukrainian" },
+	{ code_page::x_mac_thai, "x-mac-thai" },
+	{ code_page::x_mac_ce, "x-mac-ce" },
+	{ code_page::x_mac_icelandic, "x-mac-icelandic" },
+	{ code_page::x_mac_turkish, "x-mac-turkish" },
+	{ code_page::x_mac_croatian, "x-mac-croatian" },
+	{ code_page::utf_32, "utf-32" },
+	{ code_page::utf_32be, "utf-32BE" },
+	{ code_page::x_chinese_cns, "x-Chinese_CNS" },
+	{ code_page::x_cp20001, "x-cp20001" },
+	{ code_page::x_chinese_eten, "x-Chinese-Eten" },
+	{ code_page::x_cp20003, "x-cp20003" },
+	{ code_page::x_cp20004, "x-cp20004" },
+	{ code_page::x_cp20005, "x-cp20005" },
+	{ code_page::x_ia5, "x-IA5" },
+	{ code_page::x_ia5_german, "x-IA5-German" },
+	{ code_page::x_ia5_swedish, "x-IA5-Swedish" },
+	{ code_page::x_ia5_norwegian, "x-IA5-Norwegian" },
+	{ code_page::us_ascii, "us-ascii" },
+	{ code_page::x_cp20261, "x-cp20261" },
+	{ code_page::x_cp20269, "x-cp20269" },
+	{ code_page::ibm273, "IBM273" },
+	{ code_page::ibm277, "IBM277" },
+	{ code_page::ibm278, "IBM278" },
+	{ code_page::ibm280, "IBM280" },
+	{ code_page::ibm284, "IBM284" },
+	{ code_page::ibm285, "IBM285" },
+	{ code_page::ibm290, "IBM290" },
+	{ code_page::ibm297, "IBM297" },
+	{ code_page::ibm420, "IBM420" },
+	{ code_page::ibm423, "IBM423" },
+	{ code_page::ibm424, "IBM424" },
+	{ code_page::x_ebcdic_koreanextended, "x-EBCDIC-KoreanExtended" },
+	{ code_page::ibm_thai, "IBM-Thai" },
+	{ code_page::koi8_r, "koi8-r" },
+	{ code_page::ibm871, "IBM871" },
+	{ code_page::ibm880, "IBM880" },
+	{ code_page::ibm905, "IBM905" },
+	{ code_page::ibm00924, "IBM00924" },
+	{ code_page::euc_jp_jis_0208_1990_0212_1990, "EUC-JP" },
+	{ code_page::x_cp20936, "x-cp20936" },
+	{ code_page::x_cp20949, "x-cp20949" },
+	{ code_page::cp1025, "cp1025" },
+	{ code_page::koi8_u, "koi8-u" },
+	{ code_page::iso_8859_1, "iso-8859-1" },
+	{ code_page::iso_8859_2, "iso-8859-2" },
+	{ code_page::iso_8859_3, "iso-8859-3" },
+	{ code_page::iso_8859_4, "iso-8859-4" },
+	{ code_page::iso_8859_5, "iso-8859-5" },
+	{ code_page::iso_8859_6, "iso-8859-6" },
+	{ code_page::iso_8859_7, "iso-8859-7" },
+	{ code_page::iso_8859_8, "iso-8859-8" },
+	{ code_page::iso_8859_9, "iso-8859-9" },
+	{ code_page::iso_8859_13, "iso-8859-13" },
+	{ code_page::iso_8859_15, "iso-8859-15" },
+	{ code_page::x_europa, "x-Europa" },
+	{ code_page::iso_8859_8_i, "iso-8859-8-i" },
+	{ code_page::csiso2022jp, "csISO2022JP" },
+	{ code_page::iso_2022_kr, "iso-2022-kr" },
+	{ code_page::x_cp50227, "x-cp50227" },
+	{ code_page::iso_2022_traditional_chinese, "ISO 2022 Traditional Chinese" },
+	{ code_page::ebcdic_japanese_katakana_extended, "EBCDIC Japanese(Katakana) Extended" },
+	{ code_page::ebcdic_us_canada_and_japanese, "EBCDIC US - Canada and Japanese" },
+	{ code_page::ebcdic_korean_extended_and_korean, "EBCDIC Korean Extended and Korean" },
+	{ code_page::ebcdic_simplified_chinese, "EBCDIC Simplified Chinese" },
+	{ code_page::euc_jp, "euc-jp" },
+	{ code_page::euc_cn, "EUC-CN" },
+	{ code_page::euc_kr, "euc-kr" },
+	{ code_page::euc_traditional_chinese, "EUC Traditional Chinese" },
+	{ code_page::hz_gb_2312, "hz-gb-2312" },
+	{ code_page::gb18030, "GB18030" },
+	{ code_page::x_iscii_de, "x-iscii-de" },
+	{ code_page::x_iscii_be, "x-iscii-be" },
+	{ code_page::x_iscii_ta, "x-iscii-ta" },
+	{ code_page::x_iscii_te, "x-iscii-te" },
+	{ code_page::x_iscii_as, "x-iscii-as" },
+	{ code_page::x_iscii_or, "x-iscii-or" },
+	{ code_page::x_iscii_ka, "x-iscii-ka" },
+	{ code_page::x_iscii_ma, "x-iscii-ma" },
+	{ code_page::x_iscii_gu, "x-iscii-gu" },
+	{ code_page::x_iscii_pa, "x-iscii-pa" },
+	{ code_page::utf_7, "utf-7" },
+	{ code_page::utf_8, "utf-8" }
+});
+
+//"EUC-JP" name is shared by two code pages, the reverse lookup resolves it
+//to the EUC Japanese code page (51932)
+constexpr auto name_to_cpid = []() consteval {
+	constexpr std::size_t size = cpid_to_name.get_entries().size() - 1u;
+	std::array<std::pair<std::string_view, code_page>, size> entries{};
+	auto it = entries.begin();
+	for (const auto& [cpid, name] : cpid_to_name.get_entries())
 	{
-	case ibm037: return "IBM037";
-	case ibm437: return "IBM437";
-	case ibm500: return "IBM500";
-	case asmo_708: return "ASMO-708";
-	case arabic_asmo_449: return "Arabic(ASMO-449+, BCON V4)";
-	case arabic_transparent_arabic: return "Arabic - Transparent Arabic";
-	case dos_720: return "DOS-720";
-	case ibm737: return "ibm737";
-	case ibm775: return "ibm775";
-	case ibm850: return "ibm850";
-	case ibm852: return "ibm852";
-	case ibm855: return "IBM855";
-	case ibm857: return "ibm857";
-	case ibm00858: return "IBM00858";
-	case ibm860: return "IBM860";
-	case ibm861: return "ibm861";
-	case dos_862: return "DOS-862";
-	case ibm863: return "IBM863";
-	case ibm864: return "IBM864";
-	case ibm865: return "IBM865";
-	case cp866: return "cp866";
-	case ibm869: return "ibm869";
-	case ibm870: return "IBM870";
-	case windows_874: return "windows-874";
-	case cp875: return "cp875";
-	case shift_jis: return "shift_jis";
-	case gb2312: return "gb2312";
-	case ks_c_5601_1987: return "ks_c_5601-1987";
-	case big5: return "big5";
-	case ibm1026: return "IBM1026";
-	case ibm01047: return "IBM01047";
-	case ibm01140: return "IBM01140";
-	case ibm01141: return "IBM01141";
-	case ibm01142: return "IBM01142";
-	case ibm01143: return "IBM01143";
-	case ibm01144: return "IBM01144";
-	case ibm01145: return "IBM01145";
-	case ibm01146: return "IBM01146";
-	case ibm01147: return "IBM01147";
-	case ibm01148: return "IBM01148";
-	case ibm01149: return "IBM01149";
-	case utf_16: return "utf-16";
-	case unicodefffe: return "unicodeFFFE";
-	case windows_1250: return "windows-1250";
-	case windows_1251: return "windows-1251";
-	case windows_1252: return "windows-1252";
-	case windows_1253: return "windows-1253";
-	case windows_1254: return "windows-1254";
-	case windows_1255: return "windows-1255";
-	case windows_1256: return "windows-1256";
-	case windows_1257: return "windows-1257";
-	case windows_1258: return "windows-1258";
-	case johab: return "Johab";
-	case macintosh: return "macintosh";
-	case x_mac_japanese: return "x-mac-japanese";
-	case x_mac_chinesetrad: return "x-mac-chinesetrad";
-	case x_mac_korean: return "x-mac-korean";
-	case x_mac_arabic: return "x-mac-arabic";
-	case x_mac_hebrew: return "x-mac-hebrew";
-	case x_mac_greek: return "x-mac-greek";
-	case x_mac_cyrillic: return "x-mac-cyrillic";
-	case x_mac_chinesesimp: return "x-mac-chinesesimp";
-	case x_mac_romanian: return "x-mac-romanian";
-	case x_mac_ukrainian: return "x-mac-ukrainian";
-	case x_mac_thai: return "x-mac-thai";
-	case x_mac_ce: return "x-mac-ce";
-	case x_mac_icelandic: return "x-mac-icelandic";
-	case x_mac_turkish: return "x-mac-turkish";
-	case x_mac_croatian: return "x-mac-croatian";
-	case utf_32: return "utf-32";
-	case utf_32be: return "utf-32BE";
-	case x_chinese_cns: return "x-Chinese_CNS";
-	case x_cp20001: return "x-cp20001";
-	case x_chinese_eten: return "x-Chinese-Eten";
-	case x_cp20003: return "x-cp20003";
-	case x_cp20004: return "x-cp20004";
-	case x_cp20005: return "x-cp20005";
-	case x_ia5: return "x-IA5";
-	case x_ia5_german: return "x-IA5-German";
-	case x_ia5_swedish: return "x-IA5-Swedish";
-	case x_ia5_norwegian: return "x-IA5-Norwegian";
-	case us_ascii: return "us-ascii";
-	case x_cp20261: return "x-cp20261";
-	case x_cp20269: return "x-cp20269";
-	case ibm273: return "IBM273";
-	case ibm277: return "IBM277";
-	case ibm278: return "IBM278";
-	case ibm280: return "IBM280";
-	case ibm284: return "IBM284";
-	case ibm285: return "IBM285";
-	case ibm290: return "IBM290";
-	case ibm297: return "IBM297";
-	case ibm420: return "IBM420";
-	case ibm423: return "IBM423";
-	case ibm424: return "IBM424";
-	case x_ebcdic_koreanextended: return "x-EBCDIC-KoreanExtended";
-	case ibm_thai: return "IBM-Thai";
-	case koi8_r: return "koi8-r";
-	case ibm871: return "IBM871";
-	case ibm880: return "IBM880";
-	case ibm905: return "IBM905";
-	case ibm00924: return "IBM00924";
-	case euc_jp_jis_0208_1990_0212_1990: return "EUC-JP";
-	case x_cp20936: return "x-cp20936";
-	case x_cp20949: return "x-cp20949";
-	case cp1025: return "cp1025";
-	case koi8_u: return "koi8-u";
-	case iso_8859_1: return "iso-8859-1";
-	case iso_8859_2: return "iso-8859-2";
-	case iso_8859_3: return "iso-8859-3";
-	case iso_8859_4: return "iso-8859-4";
-	case iso_8859_5: return "iso-8859-5";
-	case iso_8859_6: return "iso-8859-6";
-	case iso_8859_7: return "iso-8859-7";
-	case iso_8859_8: return "iso-8859-8";
-	case iso_8859_9: return "iso-8859-9";
-	case iso_8859_13: return "iso-8859-13";
-	case iso_8859_15: return "iso-8859-15";
-	case x_europa: return "x-Europa";
-	case iso_8859_8_i: return "iso-8859-8-i";
-	case iso_2022_jp_no_halfwidth: [[fallthrough]];
-	case iso_2022_jp_jis_x_0201_1989:
-		return "iso-2022-jp";
-	case csiso2022jp: return "csISO2022JP";
-	case iso_2022_kr: return "iso-2022-kr";
-	case x_cp50227: return "x-cp50227";
-	case iso_2022_traditional_chinese: return "ISO 2022 Traditional Chinese";
-	case ebcdic_japanese_katakana_extended: return "EBCDIC Japanese(Katakana) Extended";
-	case ebcdic_us_canada_and_japanese: return "EBCDIC US - Canada and Japanese";
-	case ebcdic_korean_extended_and_korean: return "EBCDIC Korean Extended and Korean";
-	case ebcdic_simplified_chinese_extendedand_simplified_chinese:
-		return "EBCDIC Simplified Chinese Extended and Simplified Chinese";
-	case ebcdic_simplified_chinese: return "EBCDIC Simplified Chinese";
-	case ebcdic_us_canada_and_traditional_chinese:
-		return "EBCDIC US - Canada and Traditional Chinese";
-	case ebcdic_japanese_latin_extendedand_japanese:
-		return "EBCDIC Japanese(Latin) Extended and Japanese";
-	case euc_jp: return "euc-jp";
-	case euc_cn: return "EUC-CN";
-	case euc_kr: return "euc-kr";
-	case euc_traditional_chinese: return "EUC Traditional Chinese";
-	case hz_gb_2312: return "hz-gb-2312";
-	case gb18030: return "GB18030";
-	case x_iscii_de: return "x-iscii-de";
-	case x_iscii_be: return "x-iscii-be";
-	case x_iscii_ta: return "x-iscii-ta";
-	case x_iscii_te: return "x-iscii-te";
-	case x_iscii_as: return "x-iscii-as";
-	case x_iscii_or : return "x-iscii-or";
-	case x_iscii_ka: return "x-iscii-ka";
-	case x_iscii_ma: return "x-iscii-ma";
-	case x_iscii_gu: return "x-iscii-gu";
-	case x_iscii_pa: return "x-iscii-pa";
-	case utf_7: return "utf-7";
-	case utf_8: return "utf-8";
-	default: return {};
+		if (cpid != code_page::euc_jp_jis_0208_1990_0212_1990)
+			*it++ = { name, cpid };
 	}
-}
+	return utilities::sorted_table<std::string_view,
+		code_page, size, utilities::ci_less>(entries);
+}();
 
 } //namespace
 
 std::optional<std::string_view> get_cpid_name(code_page cpid) noexcept
 {
-	auto name = get_cpid_name_impl(cpid);
-	return name.empty() ? std::optional<std::string_view>{} : name;
+	const auto* name = cpid_to_name.find(cpid);
+	if (!name)
+		return {};
+	return *name;
+}
+
+std::optional<code_page> get_cpid_by_name(std::string_view name) noexcept
+{
+	const auto* cpid = name_to_cpid.find(name);
+	if (!cpid)
+		return {};
+	return *cpid;
 }
 
 } //namespace pe_bliss::resources
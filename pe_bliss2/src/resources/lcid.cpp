@@ -2,7 +2,9 @@
 
 #include <array>
 #include <string_view>
-#include <unordered_map>
+
+#include "utilities/sorted_table.h"
+#include "utilities/string.h"
 
 namespace pe_bliss::resources
 {
@@ -618,434 +620,438 @@ std::optional<lcid_info> get_lcid_info(lcid_type lcid) noexcept
 	return {};
 }
 
-std::optional<lcid_info> get_lcid_info(std::string_view lang_code) noexcept
+namespace
 {
-	static const std::unordered_map<std::string_view, lcid_type> lang_to_lcid{
-		{ "af", 0x0036u },
-		{ "af-za", 0x0436u },
-		{ "sq", 0x001cu },
-		{ "sq-al", 0x041cu },
-		{ "gsw", 0x0084u },
-		{ "gsw-fr", 0x0484u },
-		{ "am", 0x005eu },
-		{ "am-et", 0x045eu },
-		{ "ar", 0x0001u },
-		{ "ar-dz", 0x1401u },
-		{ "ar-bh", 0x3c01u },
-		{ "ar-eg", 0x0c01u },
-		{ "ar-iq", 0x0801u },
-		{ "ar-jo", 0x2c01u },
-		{ "ar-kw", 0x3401u },
-		{ "ar-lb", 0x3001u },
-		{ "ar-ly", 0x1001u },
-		{ "ar-ma", 0x1801u },
-		{ "ar-om", 0x2001u },
-		{ "ar-qa", 0x4001u },
-		{ "ar-sa", 0x0401u },
-		{ "ar-sy", 0x2801u },
-		{ "ar-tn", 0x1c01u },
-		{ "ar-ae", 0x3801u },
-		{ "ar-ye", 0x2401u },
-		{ "hy", 0x002bu },
-		{ "hy-am", 0x042bu },
-		{ "as", 0x004du },
-		{ "as-in", 0x044du },
-		{ "az-cyrl", 0x742cu },
-		{ "az-cyrl-az", 0x082cu },
-		{ "az", 0x002cu },
-		{ "az-latn", 0x782cu },
-		{ "az-latn-az", 0x042cu },
-		{ "bn", 0x0045u },
-		{ "bn-bd", 0x0845u },
-		{ "bn-in", 0x0445u },
-		{ "ba", 0x006du },
-		{ "ba-ru", 0x046du },
-		{ "eu", 0x002du },
-		{ "eu-es", 0x042du },
-		{ "be", 0x0023u },
-		{ "be-by", 0x0423u },
-		{ "bs-cyrl", 0x641au },
-		{ "bs-cyrl-ba", 0x201au },
-		{ "bs-latn", 0x681au },
-		{ "bs", 0x781au },
-		{ "bs-latn-ba", 0x141au },
-		{ "br", 0x007eu },
-		{ "br-fr", 0x047eu },
-		{ "bg", 0x0002u },
-		{ "bg-bg", 0x0402u },
-		{ "my", 0x0055u },
-		{ "my-mm", 0x0455u },
-		{ "ca", 0x0003u },
-		{ "ca-es", 0x0403u },
-		{ "tzm-arabma", 0x045fu },
-		{ "ku", 0x0092u },
-		{ "ku-arab", 0x7c92u },
-		{ "ku-arab-iq", 0x0492u },
-		{ "chr", 0x005cu },
-		{ "chr-cher", 0x7c5cu },
-		{ "chr-cher-us", 0x045cu },
-		{ "zh-hans", 0x0004u },
-		{ "zh", 0x7804u },
-		{ "zh-cn", 0x0804u },
-		{ "zh-sg", 0x1004u },
-		{ "zh-hant", 0x7c04u },
-		{ "zh-hk", 0x0c04u },
-		{ "zh-mo", 0x1404u },
-		{ "zh-tw", 0x0404u },
-		{ "co", 0x0083u },
-		{ "co-fr", 0x0483u },
-		{ "hr", 0x001au },
-		{ "hr-hr", 0x041au },
-		{ "hr-ba", 0x101au },
-		{ "cs", 0x0005u },
-		{ "cs-cz", 0x0405u },
-		{ "da", 0x0006u },
-		{ "da-dk", 0x0406u },
-		{ "prs", 0x008cu },
-		{ "prs-af", 0x048cu },
-		{ "dv", 0x0065u },
-		{ "dv-mv", 0x0465u },
-		{ "nl", 0x0013u },
-		{ "nl-be", 0x0813u },
-		{ "nl-nl", 0x0413u },
-		{ "dz-bt", 0x0c51u },
-		{ "en", 0x0009u },
-		{ "en-au", 0x0c09u },
-		{ "en-bz", 0x2809u },
-		{ "en-ca", 0x1009u },
-		{ "en-029", 0x2409u },
-		{ "en-hk", 0x3c09u },
-		{ "en-in", 0x4009u },
-		{ "en-ie", 0x1809u },
-		{ "en-jm", 0x2009u },
-		{ "en-my", 0x4409u },
-		{ "en-nz", 0x1409u },
-		{ "en-ph", 0x3409u },
-		{ "en-sg", 0x4809u },
-		{ "en-za", 0x1c09u },
-		{ "en-tt", 0x2c09u },
-		{ "en-ae", 0x4c09u },
-		{ "en-gb", 0x0809u },
-		{ "en-us", 0x0409u },
-		{ "en-zw", 0x3009u },
-		{ "et", 0x0025u },
-		{ "et-ee", 0x0425u },
-		{ "fo", 0x0038u },
-		{ "fo-fo", 0x0438u },
-		{ "fil", 0x0064u },
-		{ "fil-ph", 0x0464u },
-		{ "fi", 0x000bu },
-		{ "fi-fi", 0x040bu },
-		{ "fr", 0x000cu },
-		{ "fr-be", 0x080cu },
-		{ "fr-cm", 0x2c0cu },
-		{ "fr-ca", 0x0c0cu },
-		{ "fr-029", 0x1c0cu },
-		{ "fr-cd", 0x240cu },
-		{ "fr-ci", 0x300cu },
-		{ "fr-fr", 0x040cu },
-		{ "fr-ht", 0x3c0cu },
-		{ "fr-lu", 0x140cu },
-		{ "fr-ml", 0x340cu },
-		{ "fr-ma", 0x380cu },
-		{ "fr-mc", 0x180cu },
-		{ "fr-re", 0x200cu },
-		{ "fr-sn", 0x280cu },
-		{ "fr-ch", 0x100cu },
-		{ "fy", 0x0062u },
-		{ "fy-nl", 0x0462u },
-		{ "ff", 0x0067u },
-		{ "ff-latn", 0x7c67u },
-		{ "ff-ng", 0x0467u },
-		{ "ff-latn-sn", 0x0867u },
-		{ "gl", 0x0056u },
-		{ "gl-es", 0x0456u },
-		{ "ka", 0x0037u },
-		{ "ka-ge", 0x0437u },
-		{ "de", 0x0007u },
-		{ "de-at", 0x0c07u },
-		{ "de-de", 0x0407u },
-		{ "de-li", 0x1407u },
-		{ "de-lu", 0x1007u },
-		{ "de-ch", 0x0807u },
-		{ "el", 0x0008u },
-		{ "el-gr", 0x0408u },
-		{ "kl", 0x006fu },
-		{ "kl-gl", 0x046fu },
-		{ "gn", 0x0074u },
-		{ "gn-py", 0x0474u },
-		{ "gu", 0x0047u },
-		{ "gu-in", 0x0447u },
-		{ "ha", 0x0068u },
-		{ "ha-latn", 0x7c68u },
-		{ "ha-latn-ng", 0x0468u },
-		{ "haw", 0x0075u },
-		{ "haw-us", 0x0475u },
-		{ "he", 0x000du },
-		{ "he-il", 0x040du },
-		{ "hi", 0x0039u },
-		{ "hi-in", 0x0439u },
-		{ "hu", 0x000eu },
-		{ "hu-hu", 0x040eu },
-		{ "is", 0x000fu },
-		{ "is-is", 0x040fu },
-		{ "ig", 0x0070u },
-		{ "ig-ng", 0x0470u },
-		{ "id", 0x0021u },
-		{ "id-id", 0x0421u },
-		{ "iu", 0x005du },
-		{ "iu-latn", 0x7c5du },
-		{ "iu-latn-ca", 0x085du },
-		{ "iu-cans", 0x785du },
-		{ "iu-cans-ca", 0x045du },
-		{ "ga", 0x003cu },
-		{ "ga-ie", 0x083cu },
-		{ "it", 0x0010u },
-		{ "it-it", 0x0410u },
-		{ "it-ch", 0x0810u },
-		{ "ja", 0x0011u },
-		{ "ja-jp", 0x0411u },
-		{ "kn", 0x004bu },
-		{ "kn-in", 0x044bu },
-		{ "kr-latn-ng", 0x0471u },
-		{ "ks", 0x0060u },
-		{ "ks-arab", 0x0460u },
-		{ "ks-deva-in", 0x0860u },
-		{ "kk", 0x003fu },
-		{ "kk-kz", 0x043fu },
-		{ "km", 0x0053u },
-		{ "km-kh", 0x0453u },
-		{ "quc", 0x0086u },
-		{ "quc-latn-gt", 0x0486u },
-		{ "rw", 0x0087u },
-		{ "rw-rw", 0x0487u },
-		{ "sw", 0x0041u },
-		{ "sw-ke", 0x0441u },
-		{ "kok", 0x0057u },
-		{ "kok-in", 0x0457u },
-		{ "ko", 0x0012u },
-		{ "ko-kr", 0x0412u },
-		{ "ky", 0x0040u },
-		{ "ky-kg", 0x0440u },
-		{ "lo", 0x0054u },
-		{ "lo-la", 0x0454u },
-		{ "la-va", 0x0476u },
-		{ "lv", 0x0026u },
-		{ "lv-lv", 0x0426u },
-		{ "lt", 0x0027u },
-		{ "lt-lt", 0x0427u },
-		{ "dsb", 0x7c2eu },
-		{ "dsb-de", 0x082eu },
-		{ "lb", 0x006eu },
-		{ "lb-lu", 0x046eu },
-		{ "mk", 0x002fu },
-		{ "mk-mk", 0x042fu },
-		{ "ms", 0x003eu },
-		{ "ms-bn", 0x083eu },
-		{ "ms-my", 0x043eu },
-		{ "ml", 0x004cu },
-		{ "ml-in", 0x044cu },
-		{ "mt", 0x003au },
-		{ "mt-mt", 0x043au },
-		{ "mi", 0x0081u },
-		{ "mi-nz", 0x0481u },
-		{ "arn", 0x007au },
-		{ "arn-cl", 0x047au },
-		{ "mr", 0x004eu },
-		{ "mr-in", 0x044eu },
-		{ "moh", 0x007cu },
-		{ "moh-ca", 0x047cu },
-		{ "mn", 0x0050u },
-		{ "mn-cyrl", 0x7850u },
-		{ "mn-mn", 0x0450u },
-		{ "mn-mong", 0x7c50u },
-		{ "mn-mongcn", 0x0850u },
-		{ "mn-mongmn", 0x0c50u },
-		{ "ne", 0x0061u },
-		{ "ne-in", 0x0861u },
-		{ "ne-np", 0x0461u },
-		{ "no", 0x0014u },
-		{ "nb", 0x7c14u },
-		{ "nb-no", 0x0414u },
-		{ "nn", 0x7814u },
-		{ "nn-no", 0x0814u },
-		{ "oc", 0x0082u },
-		{ "oc-fr", 0x0482u },
-		{ "or", 0x0048u },
-		{ "or-in", 0x0448u },
-		{ "om", 0x0072u },
-		{ "om-et", 0x0472u },
-		{ "ps", 0x0063u },
-		{ "ps-af", 0x0463u },
-		{ "fa", 0x0029u },
-		{ "fa-ir", 0x0429u },
-		{ "pl", 0x0015u },
-		{ "pl-pl", 0x0415u },
-		{ "pt", 0x0016u },
-		{ "pt-br", 0x0416u },
-		{ "pt-pt", 0x0816u },
-		{ "qps-ploca", 0x05feu },
-		{ "qps-ploc", 0x0501u },
-		{ "qps-plocm", 0x09ffu },
-		{ "pa", 0x0046u },
-		{ "pa-arab", 0x7c46u },
-		{ "pa-in", 0x0446u },
-		{ "pa-arab-pk", 0x0846u },
-		{ "quz", 0x006bu },
-		{ "quz-bo", 0x046bu },
-		{ "quz-ec", 0x086bu },
-		{ "quz-pe", 0x0c6bu },
-		{ "ro", 0x0018u },
-		{ "ro-md", 0x0818u },
-		{ "ro-ro", 0x0418u },
-		{ "rm", 0x0017u },
-		{ "rm-ch", 0x0417u },
-		{ "ru", 0x0019u },
-		{ "ru-md", 0x0819u },
-		{ "ru-ru", 0x0419u },
-		{ "sah", 0x0085u },
-		{ "sah-ru", 0x0485u },
-		{ "smn", 0x703bu },
-		{ "smn-fi", 0x243bu },
-		{ "smj", 0x7c3bu },
-		{ "smj-no", 0x103bu },
-		{ "smj-se", 0x143bu },
-		{ "se", 0x003bu },
-		{ "se-fi", 0x0c3bu },
-		{ "se-no", 0x043bu },
-		{ "se-se", 0x083bu },
-		{ "sms", 0x743bu },
-		{ "sms-fi", 0x203bu },
-		{ "sma", 0x783bu },
-		{ "sma-no", 0x183bu },
-		{ "sma-se", 0x1c3bu },
-		{ "sa", 0x004fu },
-		{ "sa-in", 0x044fu },
-		{ "gd", 0x0091u },
-		{ "gd-gb", 0x0491u },
-		{ "sr-cyrl", 0x6c1au },
-		{ "sr-cyrl-ba", 0x1c1au },
-		{ "sr-cyrl-me", 0x301au },
-		{ "sr-cyrl-rs", 0x281au },
-		{ "sr-cyrl-cs", 0x0c1au },
-		{ "sr-latn", 0x701au },
-		{ "sr", 0x7c1au },
-		{ "sr-latn-ba", 0x181au },
-		{ "sr-latn-me", 0x2c1au },
-		{ "sr-latn-rs", 0x241au },
-		{ "sr-latn-cs", 0x081au },
-		{ "nso", 0x006cu },
-		{ "nso-za", 0x046cu },
-		{ "tn", 0x0032u },
-		{ "tn-bw", 0x0832u },
-		{ "tn-za", 0x0432u },
-		{ "sd", 0x0059u },
-		{ "sd-arab", 0x7c59u },
-		{ "sd-arab-pk", 0x0859u },
-		{ "si", 0x005bu },
-		{ "si-lk", 0x045bu },
-		{ "sk", 0x001bu },
-		{ "sk-sk", 0x041bu },
-		{ "sl", 0x0024u },
-		{ "sl-si", 0x0424u },
-		{ "so", 0x0077u },
-		{ "so-so", 0x0477u },
-		{ "st", 0x0030u },
-		{ "st-za", 0x0430u },
-		{ "es", 0x000au },
-		{ "es-ar", 0x2c0au },
-		{ "es-ve", 0x200au },
-		{ "es-bo", 0x400au },
-		{ "es-cl", 0x340au },
-		{ "es-co", 0x240au },
-		{ "es-cr", 0x140au },
-		{ "es-cu", 0x5c0au },
-		{ "es-do", 0x1c0au },
-		{ "es-ec", 0x300au },
-		{ "es-sv", 0x440au },
-		{ "es-gt", 0x100au },
-		{ "es-hn", 0x480au },
-		{ "es-419", 0x580au },
-		{ "es-mx", 0x080au },
-		{ "es-ni", 0x4c0au },
-		{ "es-pa", 0x180au },
-		{ "es-py", 0x3c0au },
-		{ "es-pe", 0x280au },
-		{ "es-pr", 0x500au },
-		{ "es-es_tradnl", 0x040au },
-		{ "es-es", 0x0c0au },
-		{ "es-us", 0x540au },
-		{ "es-uy", 0x380au },
-		{ "sv", 0x001du },
-		{ "sv-fi", 0x081du },
-		{ "sv-se", 0x041du },
-		{ "syr", 0x005au },
-		{ "syr-sy", 0x045au },
-		{ "tg", 0x0028u },
-		{ "tg-cyrl", 0x7c28u },
-		{ "tg-cyrl-tj", 0x0428u },
-		{ "tzm", 0x005fu },
-		{ "tzm-latn", 0x7c5fu },
-		{ "tzm-latn-dz", 0x085fu },
-		{ "ta", 0x0049u },
-		{ "ta-in", 0x0449u },
-		{ "ta-lk", 0x0849u },
-		{ "tt", 0x0044u },
-		{ "tt-ru", 0x0444u },
-		{ "te", 0x004au },
-		{ "te-in", 0x044au },
-		{ "th", 0x001eu },
-		{ "th-th", 0x041eu },
-		{ "bo", 0x0051u },
-		{ "bo-cn", 0x0451u },
-		{ "ti", 0x0073u },
-		{ "ti-er", 0x0873u },
-		{ "ti-et", 0x0473u },
-		{ "ts", 0x0031u },
-		{ "ts-za", 0x0431u },
-		{ "tr", 0x001fu },
-		{ "tr-tr", 0x041fu },
-		{ "tk", 0x0042u },
-		{ "tk-tm", 0x0442u },
-		{ "uk", 0x0022u },
-		{ "uk-ua", 0x0422u },
-		{ "hsb", 0x002eu },
-		{ "hsb-de", 0x042eu },
-		{ "ur", 0x0020u },
-		{ "ur-in", 0x0820u },
-		{ "ur-pk", 0x0420u },
-		{ "ug", 0x0080u },
-		{ "ug-cn", 0x0480u },
-		{ "uz-cyrl", 0x7843u },
-		{ "uz-cyrl-uz", 0x0843u },
-		{ "uz", 0x0043u },
-		{ "uz-latn", 0x7c43u },
-		{ "uz-latn-uz", 0x0443u },
-		{ "ca-esvalencia", 0x0803u },
-		{ "ve", 0x0033u },
-		{ "ve-za", 0x0433u },
-		{ "vi", 0x002au },
-		{ "vi-vn", 0x042au },
-		{ "cy", 0x0052u },
-		{ "cy-gb", 0x0452u },
-		{ "wo", 0x0088u },
-		{ "wo-sn", 0x0488u },
-		{ "xh", 0x0034u },
-		{ "xh-za", 0x0434u },
-		{ "ii", 0x0078u },
-		{ "ii-cn", 0x0478u },
-		{ "yi-001", 0x043du },
-		{ "yo", 0x006au },
-		{ "yo-ng", 0x046au },
-		{ "zu", 0x0035u },
-		{ "zu-za", 0x0435u }
-	};
+constexpr auto lang_to_lcid = utilities::make_sorted_table<
+	std::string_view, lcid_type, utilities::ci_less>({
+	{ "af", 0x0036u },
+	{ "af-za", 0x0436u },
+	{ "sq", 0x001cu },
+	{ "sq-al", 0x041cu },
+	{ "gsw", 0x0084u },
+	{ "gsw-fr", 0x0484u },
+	{ "am", 0x005eu },
+	{ "am-et", 0x045eu },
+	{ "ar", 0x0001u },
+	{ "ar-dz", 0x1401u },
+	{ "ar-bh", 0x3c01u },
+	{ "ar-eg", 0x0c01u },
+	{ "ar-iq", 0x0801u },
+	{ "ar-jo", 0x2c01u },
+	{ "ar-kw", 0x3401u },
+	{ "ar-lb", 0x3001u },
+	{ "ar-ly", 0x1001u },
+	{ "ar-ma", 0x1801u },
+	{ "ar-om", 0x2001u },
+	{ "ar-qa", 0x4001u },
+	{ "ar-sa", 0x0401u },
+	{ "ar-sy", 0x2801u },
+	{ "ar-tn", 0x1c01u },
+	{ "ar-ae", 0x3801u },
+	{ "ar-ye", 0x2401u },
+	{ "hy", 0x002bu },
+	{ "hy-am", 0x042bu },
+	{ "as", 0x004du },
+	{ "as-in", 0x044du },
+	{ "az-cyrl", 0x742cu },
+	{ "az-cyrl-az", 0x082cu },
+	{ "az", 0x002cu },
+	{ "az-latn", 0x782cu },
+	{ "az-latn-az", 0x042cu },
+	{ "bn", 0x0045u },
+	{ "bn-bd", 0x0845u },
+	{ "bn-in", 0x0445u },
+	{ "ba", 0x006du },
+	{ "ba-ru", 0x046du },
+	{ "eu", 0x002du },
+	{ "eu-es", 0x042du },
+	{ "be", 0x0023u },
+	{ "be-by", 0x0423u },
+	{ "bs-cyrl", 0x641au },
+	{ "bs-cyrl-ba", 0x201au },
+	{ "bs-latn", 0x681au },
+	{ "bs", 0x781au },
+	{ "bs-latn-ba", 0x141au },
+	{ "br", 0x007eu },
+	{ "br-fr", 0x047eu },
+	{ "bg", 0x0002u },
+	{ "bg-bg", 0x0402u },
+	{ "my", 0x0055u },
+	{ "my-mm", 0x0455u },
+	{ "ca", 0x0003u },
+	{ "ca-es", 0x0403u },
+	{ "tzm-arabma", 0x045fu },
+	{ "ku", 0x0092u },
+	{ "ku-arab", 0x7c92u },
+	{ "ku-arab-iq", 0x0492u },
+	{ "chr", 0x005cu },
+	{ "chr-cher", 0x7c5cu },
+	{ "chr-cher-us", 0x045cu },
+	{ "zh-hans", 0x0004u },
+	{ "zh", 0x7804u },
+	{ "zh-cn", 0x0804u },
+	{ "zh-sg", 0x1004u },
+	{ "zh-hant", 0x7c04u },
+	{ "zh-hk", 0x0c04u },
+	{ "zh-mo", 0x1404u },
+	{ "zh-tw", 0x0404u },
+	{ "co", 0x0083u },
+	{ "co-fr", 0x0483u },
+	{ "hr", 0x001au },
+	{ "hr-hr", 0x041au },
+	{ "hr-ba", 0x101au },
+	{ "cs", 0x0005u },
+	{ "cs-cz", 0x0405u },
+	{ "da", 0x0006u },
+	{ "da-dk", 0x0406u },
+	{ "prs", 0x008cu },
+	{ "prs-af", 0x048cu },
+	{ "dv", 0x0065u },
+	{ "dv-mv", 0x0465u },
+	{ "nl", 0x0013u },
+	{ "nl-be", 0x0813u },
+	{ "nl-nl", 0x0413u },
+	{ "dz-bt", 0x0c51u },
+	{ "en", 0x0009u },
+	{ "en-au", 0x0c09u },
+	{ "en-bz", 0x2809u },
+	{ "en-ca", 0x1009u },
+	{ "en-029", 0x2409u },
+	{ "en-hk", 0x3c09u },
+	{ "en-in", 0x4009u },
+	{ "en-ie", 0x1809u },
+	{ "en-jm", 0x2009u },
+	{ "en-my", 0x4409u },
+	{ "en-nz", 0x1409u },
+	{ "en-ph", 0x3409u },
+	{ "en-sg", 0x4809u },
+	{ "en-za", 0x1c09u },
+	{ "en-tt", 0x2c09u },
+	{ "en-ae", 0x4c09u },
+	{ "en-gb", 0x0809u },
+	{ "en-us", 0x0409u },
+	{ "en-zw", 0x3009u },
+	{ "et", 0x0025u },
+	{ "et-ee", 0x0425u },
+	{ "fo", 0x0038u },
+	{ "fo-fo", 0x0438u },
+	{ "fil", 0x0064u },
+	{ "fil-ph", 0x0464u },
+	{ "fi", 0x000bu },
+	{ "fi-fi", 0x040bu },
+	{ "fr", 0x000cu },
+	{ "fr-be", 0x080cu },
+	{ "fr-cm", 0x2c0cu },
+	{ "fr-ca", 0x0c0cu },
+	{ "fr-029", 0x1c0cu },
+	{ "fr-cd", 0x240cu },
+	{ "fr-ci", 0x300cu },
+	{ "fr-fr", 0x040cu },
+	{ "fr-ht", 0x3c0cu },
+	{ "fr-lu", 0x140cu },
+	{ "fr-ml", 0x340cu },
+	{ "fr-ma", 0x380cu },
+	{ "fr-mc", 0x180cu },
+	{ "fr-re", 0x200cu },
+	{ "fr-sn", 0x280cu },
+	{ "fr-ch", 0x100cu },
+	{ "fy", 0x0062u },
+	{ "fy-nl", 0x0462u },
+	{ "ff", 0x0067u },
+	{ "ff-latn", 0x7c67u },
+	{ "ff-ng", 0x0467u },
+	{ "ff-latn-sn", 0x0867u },
+	{ "gl", 0x0056u },
+	{ "gl-es", 0x0456u },
+	{ "ka", 0x0037u },
+	{ "ka-ge", 0x0437u },
+	{ "de", 0x0007u },
+	{ "de-at", 0x0c07u },
+	{ "de-de", 0x0407u },
+	{ "de-li", 0x1407u },
+	{ "de-lu", 0x1007u },
+	{ "de-ch", 0x0807u },
+	{ "el", 0x0008u },
+	{ "el-gr", 0x0408u },
+	{ "kl", 0x006fu },
+	{ "kl-gl", 0x046fu },
+	{ "gn", 0x0074u },
+	{ "gn-py", 0x0474u },
+	{ "gu", 0x0047u },
+	{ "gu-in", 0x0447u },
+	{ "ha", 0x0068u },
+	{ "ha-latn", 0x7c68u },
+	{ "ha-latn-ng", 0x0468u },
+	{ "haw", 0x0075u },
+	{ "haw-us", 0x0475u },
+	{ "he", 0x000du },
+	{ "he-il", 0x040du },
+	{ "hi", 0x0039u },
+	{ "hi-in", 0x0439u },
+	{ "hu", 0x000eu },
+	{ "hu-hu", 0x040eu },
+	{ "is", 0x000fu },
+	{ "is-is", 0x040fu },
+	{ "ig", 0x0070u },
+	{ "ig-ng", 0x0470u },
+	{ "id", 0x0021u },
+	{ "id-id", 0x0421u },
+	{ "iu", 0x005du },
+	{ "iu-latn", 0x7c5du },
+	{ "iu-latn-ca", 0x085du },
+	{ "iu-cans", 0x785du },
+	{ "iu-cans-ca", 0x045du },
+	{ "ga", 0x003cu },
+	{ "ga-ie", 0x083cu },
+	{ "it", 0x0010u },
+	{ "it-it", 0x0410u },
+	{ "it-ch", 0x0810u },
+	{ "ja", 0x0011u },
+	{ "ja-jp", 0x0411u },
+	{ "kn", 0x004bu },
+	{ "kn-in", 0x044bu },
+	{ "kr-latn-ng", 0x0471u },
+	{ "ks", 0x0060u },
+	{ "ks-arab", 0x0460u },
+	{ "ks-deva-in", 0x0860u },
+	{ "kk", 0x003fu },
+	{ "kk-kz", 0x043fu },
+	{ "km", 0x0053u },
+	{ "km-kh", 0x0453u },
+	{ "quc", 0x0086u },
+	{ "quc-latn-gt", 0x0486u },
+	{ "rw", 0x0087u },
+	{ "rw-rw", 0x0487u },
+	{ "sw", 0x0041u },
+	{ "sw-ke", 0x0441u },
+	{ "kok", 0x0057u },
+	{ "kok-in", 0x0457u },
+	{ "ko", 0x0012u },
+	{ "ko-kr", 0x0412u },
+	{ "ky", 0x0040u },
+	{ "ky-kg", 0x0440u },
+	{ "lo", 0x0054u },
+	{ "lo-la", 0x0454u },
+	{ "la-va", 0x0476u },
+	{ "lv", 0x0026u },
+	{ "lv-lv", 0x0426u },
+	{ "lt", 0x0027u },
+	{ "lt-lt", 0x0427u },
+	{ "dsb", 0x7c2eu },
+	{ "dsb-de", 0x082eu },
+	{ "lb", 0x006eu },
+	{ "lb-lu", 0x046eu },
+	{ "mk", 0x002fu },
+	{ "mk-mk", 0x042fu },
+	{ "ms", 0x003eu },
+	{ "ms-bn", 0x083eu },
+	{ "ms-my", 0x043eu },
+	{ "ml", 0x004cu },
+	{ "ml-in", 0x044cu },
+	{ "mt", 0x003au },
+	{ "mt-mt", 0x043au },
+	{ "mi", 0x0081u },
+	{ "mi-nz", 0x0481u },
+	{ "arn", 0x007au },
+	{ "arn-cl", 0x047au },
+	{ "mr", 0x004eu },
+	{ "mr-in", 0x044eu },
+	{ "moh", 0x007cu },
+	{ "moh-ca", 0x047cu },
+	{ "mn", 0x0050u },
+	{ "mn-cyrl", 0x7850u },
+	{ "mn-mn", 0x0450u },
+	{ "mn-mong", 0x7c50u },
+	{ "mn-mongcn", 0x0850u },
+	{ "mn-mongmn", 0x0c50u },
+	{ "ne", 0x0061u },
+	{ "ne-in", 0x0861u },
+	{ "ne-np", 0x0461u },
+	{ "no", 0x0014u },
+	{ "nb", 0x7c14u },
+	{ "nb-no", 0x0414u },
+	{ "nn", 0x7814u },
+	{ "nn-no", 0x0814u },
+	{ "oc", 0x0082u },
+	{ "oc-fr", 0x0482u },
+	{ "or", 0x0048u },
+	{ "or-in", 0x0448u },
+	{ "om", 0x0072u },
+	{ "om-et", 0x0472u },
+	{ "ps", 0x0063u },
+	{ "ps-af", 0x0463u },
+	{ "fa", 0x0029u },
+	{ "fa-ir", 0x0429u },
+	{ "pl", 0x0015u },
+	{ "pl-pl", 0x0415u },
+	{ "pt", 0x0016u },
+	{ "pt-br", 0x0416u },
+	{ "pt-pt", 0x0816u },
+	{ "qps-ploca", 0x05feu },
+	{ "qps-ploc", 0x0501u },
+	{ "qps-plocm", 0x09ffu },
+	{ "pa", 0x0046u },
+	{ "pa-arab", 0x7c46u },
+	{ "pa-in", 0x0446u },
+	{ "pa-arab-pk", 0x0846u },
+	{ "quz", 0x006bu },
+	{ "quz-bo", 0x046bu },
+	{ "quz-ec", 0x086bu },
+	{ "quz-pe", 0x0c6bu },
+	{ "ro", 0x0018u },
+	{ "ro-md", 0x0818u },
+	{ "ro-ro", 0x0418u },
+	{ "rm", 0x0017u },
+	{ "rm-ch", 0x0417u },
+	{ "ru", 0x0019u },
+	{ "ru-md", 0x0819u },
+	{ "ru-ru", 0x0419u },
+	{ "sah", 0x0085u },
+	{ "sah-ru", 0x0485u },
+	{ "smn", 0x703bu },
+	{ "smn-fi", 0x243bu },
+	{ "smj", 0x7c3bu },
+	{ "smj-no", 0x103bu },
+	{ "smj-se", 0x143bu },
+	{ "se", 0x003bu },
+	{ "se-fi", 0x0c3bu },
+	{ "se-no", 0x043bu },
+	{ "se-se", 0x083bu },
+	{ "sms", 0x743bu },
+	{ "sms-fi", 0x203bu },
+	{ "sma", 0x783bu },
+	{ "sma-no", 0x183bu },
+	{ "sma-se", 0x1c3bu },
+	{ "sa", 0x004fu },
+	{ "sa-in", 0x044fu },
+	{ "gd", 0x0091u },
+	{ "gd-gb", 0x0491u },
+	{ "sr-cyrl", 0x6c1au },
+	{ "sr-cyrl-ba", 0x1c1au },
+	{ "sr-cyrl-me", 0x301au },
+	{ "sr-cyrl-rs", 0x281au },
+	{ "sr-cyrl-cs", 0x0c1au },
+	{ "sr-latn", 0x701au },
+	{ "sr", 0x7c1au },
+	{ "sr-latn-ba", 0x181au },
+	{ "sr-latn-me", 0x2c1au },
+	{ "sr-latn-rs", 0x241au },
+	{ "sr-latn-cs", 0x081au },
+	{ "nso", 0x006cu },
+	{ "nso-za", 0x046cu },
+	{ "tn", 0x0032u },
+	{ "tn-bw", 0x0832u },
+	{ "tn-za", 0x0432u },
+	{ "sd", 0x0059u },
+	{ "sd-arab", 0x7c59u },
+	{ "sd-arab-pk", 0x0859u },
+	{ "si", 0x005bu },
+	{ "si-lk", 0x045bu },
+	{ "sk", 0x001bu },
+	{ "sk-sk", 0x041bu },
+	{ "sl", 0x0024u },
+	{ "sl-si", 0x0424u },
+	{ "so", 0x0077u },
+	{ "so-so", 0x0477u },
+	{ "st", 0x0030u },
+	{ "st-za", 0x0430u },
+	{ "es", 0x000au },
+	{ "es-ar", 0x2c0au },
+	{ "es-ve", 0x200au },
+	{ "es-bo", 0x400au },
+	{ "es-cl", 0x340au },
+	{ "es-co", 0x240au },
+	{ "es-cr", 0x140au },
+	{ "es-cu", 0x5c0au },
+	{ "es-do", 0x1c0au },
+	{ "es-ec", 0x300au },
+	{ "es-sv", 0x440au },
+	{ "es-gt", 0x100au },
+	{ "es-hn", 0x480au },
+	{ "es-419", 0x580au },
+	{ "es-mx", 0x080au },
+	{ "es-ni", 0x4c0au },
+	{ "es-pa", 0x180au },
+	{ "es-py", 0x3c0au },
+	{ "es-pe", 0x280au },
+	{ "es-pr", 0x500au },
+	{ "es-es_tradnl", 0x040au },
+	{ "es-es", 0x0c0au },
+	{ "es-us", 0x540au },
+	{ "es-uy", 0x380au },
+	{ "sv", 0x001du },
+	{ "sv-fi", 0x081du },
+	{ "sv-se", 0x041du },
+	{ "syr", 0x005au },
+	{ "syr-sy", 0x045au },
+	{ "tg", 0x0028u },
+	{ "tg-cyrl", 0x7c28u },
+	{ "tg-cyrl-tj", 0x0428u },
+	{ "tzm", 0x005fu },
+	{ "tzm-latn", 0x7c5fu },
+	{ "tzm-latn-dz", 0x085fu },
+	{ "ta", 0x0049u },
+	{ "ta-in", 0x0449u },
+	{ "ta-lk", 0x0849u },
+	{ "tt", 0x0044u },
+	{ "tt-ru", 0x0444u },
+	{ "te", 0x004au },
+	{ "te-in", 0x044au },
+	{ "th", 0x001eu },
+	{ "th-th", 0x041eu },
+	{ "bo", 0x0051u },
+	{ "bo-cn", 0x0451u },
+	{ "ti", 0x0073u },
+	{ "ti-er", 0x0873u },
+	{ "ti-et", 0x0473u },
+	{ "ts", 0x0031u },
+	{ "ts-za", 0x0431u },
+	{ "tr", 0x001fu },
+	{ "tr-tr", 0x041fu },
+	{ "tk", 0x0042u },
+	{ "tk-tm", 0x0442u },
+	{ "uk", 0x0022u },
+	{ "uk-ua", 0x0422u },
+	{ "hsb", 0x002eu },
+	{ "hsb-de", 0x042eu },
+	{ "ur", 0x0020u },
+	{ "ur-in", 0x0820u },
+	{ "ur-pk", 0x0420u },
+	{ "ug", 0x0080u },
+	{ "ug-cn", 0x0480u },
+	{ "uz-cyrl", 0x7843u },
+	{ "uz-cyrl-uz", 0x0843u },
+	{ "uz", 0x0043u },
+	{ "uz-latn", 0x7c43u },
+	{ "uz-latn-uz", 0x0443u },
+	{ "ca-esvalencia", 0x0803u },
+	{ "ve", 0x0033u },
+	{ "ve-za", 0x0433u },
+	{ "vi", 0x002au },
+	{ "vi-vn", 0x042au },
+	{ "cy", 0x0052u },
+	{ "cy-gb", 0x0452u },
+	{ "wo", 0x0088u },
+	{ "wo-sn", 0x0488u },
+	{ "xh", 0x0034u },
+	{ "xh-za", 0x0434u },
+	{ "ii", 0x0078u },
+	{ "ii-cn", 0x0478u },
+	{ "yi-001", 0x043du },
+	{ "yo", 0x006au },
+	{ "yo-ng", 0x046au },
+	{ "zu", 0x0035u },
+	{ "zu-za", 0x0435u }
+});
+} //namespace
 
-	auto it = lang_to_lcid.find(lang_code);
-	if (it == lang_to_lcid.cend())
+std::optional<lcid_info> get_lcid_info(std::string_view lang_code) noexcept
+{
+	const auto* lcid = lang_to_lcid.find(lang_code);
+	if (!lcid)
 		return {};
 
-	return get_lcid_info(it->second);
+	return get_lcid_info(*lcid);
 }
 
 } //namespace pe_bliss::resources
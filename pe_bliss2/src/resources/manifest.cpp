@@ -11,12 +11,12 @@
 #include <string_view>
 #include <system_error>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 
 #include "pe_bliss2/error_list.h"
 #include "pe_bliss2/pe_error.h"
 #include "pe_bliss2/resources/manifest_accessor_interface.h"
+#include "utilities/sorted_table.h"
 #include "utilities/string.h"
 
 namespace
@@ -165,9 +165,6 @@ struct manifest_category : std::error_category
 
 const manifest_category manifest_category_instance;
 
-using guid_version_type = std::pair<std::string_view,
-	pe_bliss::resources::assembly_supported_os>;
-
 //We use this helper instead of std::views::split
 //to support older versions of gcc
 template<typename Func>
@@ -217,11 +214,196 @@ auto parse_version_impl(std::string_view version_string)
 namespace pe_bliss::resources
 {
 
+namespace
+{
+constexpr auto processor_architectures = utilities::make_sorted_table<
+	std::string_view, assembly_processor_architecture>({
+	{ "x86", assembly_processor_architecture::x86 },
+	{ "amd64", assembly_processor_architecture::amd64 },
+	{ "arm", assembly_processor_architecture::arm },
+	{ "arm64", assembly_processor_architecture::arm64 },
+	{ "*", assembly_processor_architecture::any }
+});
+
+constexpr auto supported_os_guids = utilities::make_sorted_table<
+	std::string_view, assembly_supported_os, utilities::ci_less>({
+	{ "{e2011457-1546-43c5-a5fe-008deee3d3f0}",
+		assembly_supported_os::win_vista_server2008 },
+	{ "{35138b9a-5d96-4fbd-8e2d-a2440225f93a}",
+		assembly_supported_os::win7_server2008_r2 },
+	{ "{4a2f28e3-53b9-4441-ba9c-d69d4a4a6e38}",
+		assembly_supported_os::win8_server2012 },
+	{ "{1f676c76-80e1-4239-95bb-83d0f6d0da78}",
+		assembly_supported_os::win8_1_server2012_r2 },
+	{ "{8e0f7a12-bfb3-4fe8-b9a5-48fd50a15a9a}",
+		assembly_supported_os::win10_win11_server2016_server2019_server2022 }
+});
+
+constexpr auto hash_algorithms = utilities::make_sorted_table<
+	std::string_view, assembly_file_hash_algorithm, utilities::ci_less>({
+	{ "sha1", assembly_file_hash_algorithm::sha1 },
+	{ "sha256", assembly_file_hash_algorithm::sha256 }
+});
+
+constexpr auto threading_models = utilities::make_sorted_table<
+	std::string_view, com_threading_model, utilities::ci_less>({
+	{ "Neutral", com_threading_model::neutral },
+	{ "Apartment", com_threading_model::apartment },
+	{ "Free", com_threading_model::free },
+	{ "Both", com_threading_model::both }
+});
+
+constexpr auto ole_misc_flags = utilities::make_sorted_table<
+	std::string_view, ole_misc::value, utilities::ci_less>({
+	{ "recomposeonresize", ole_misc::recomposeonresize },
+	{ "onlyiconic", ole_misc::onlyiconic },
+	{ "insertnotreplace", ole_misc::insertnotreplace },
+	{ "static", ole_misc::static_value },
+	{ "cantlinkinside", ole_misc::cantlinkinside },
+	{ "canlinkbyole1", ole_misc::canlinkbyole1 },
+	{ "islinkobject", ole_misc::islinkobject },
+	{ "insideout", ole_misc::insideout },
+	{ "activatewhenvisible", ole_misc::activatewhenvisible },
+	{ "renderingisdeviceindependent", ole_misc::renderingisdeviceindependent },
+	{ "invisibleatruntime", ole_misc::invisibleatruntime },
+	{ "alwaysrun", ole_misc::alwaysrun },
+	{ "actslikebutton", ole_misc::actslikebutton },
+	{ "actslikelabel", ole_misc::actslikelabel },
+	{ "nouiactivate", ole_misc::nouiactivate },
+	{ "alignable", ole_misc::alignable },
+	{ "simpleframe", ole_misc::simpleframe },
+	{ "setclientsitefirst", ole_misc::setclientsitefirst },
+	{ "imemode", ole_misc::imemode },
+	{ "ignoreativatewhenvisible", ole_misc::ignoreativatewhenvisible },
+	{ "wantstomenumerge", ole_misc::wantstomenumerge },
+	{ "supportsmultilevelundo", ole_misc::supportsmultilevelundo }
+});
+
+constexpr auto typelib_flags = utilities::make_sorted_table<
+	std::string_view, com_typelib_flags::value, utilities::ci_less>({
+	{ "RESTRICTED", com_typelib_flags::restricted },
+	{ "CONTROL", com_typelib_flags::control },
+	{ "HIDDEN", com_typelib_flags::hidden },
+	{ "HASDISKIMAGE", com_typelib_flags::has_disk_image }
+});
+
+constexpr auto dpi_aware_values = utilities::make_sorted_table<
+	std::string_view, dpi_aware_value, utilities::ci_less>({
+	{ "true", dpi_aware_value::dpi_aware },
+	{ "false", dpi_aware_value::dpi_unaware },
+	{ "true/pm", dpi_aware_value::dpi_aware_true_per_monitor },
+	{ "per monitor", dpi_aware_value::dpi_aware_per_monitor }
+});
+
+constexpr auto dpi_awareness_values = utilities::make_sorted_table<
+	std::string_view, dpi_awareness_value, utilities::ci_less>({
+	{ "system", dpi_awareness_value::dpi_aware_system },
+	{ "permonitor", dpi_awareness_value::dpi_aware_per_monitor },
+	{ "permonitorv2", dpi_awareness_value::dpi_aware_per_monitor_v2 },
+	{ "unaware", dpi_awareness_value::dpi_unaware }
+});
+
+constexpr auto execution_levels = utilities::make_sorted_table<
+	std::string_view, requested_execution_level>({
+	{ "asInvoker", requested_execution_level::as_invoker },
+	{ "requireAdministrator", requested_execution_level::require_administrator },
+	{ "highestAvailable", requested_execution_level::highest_available }
+});
+
+template<typename Table, typename Value>
+Value find_value(const Table& values, std::string_view name,
+	Value not_found) noexcept
+{
+	const auto* value = values.find(name);
+	return value ? *value : not_found;
+}
+
+template<typename Table, typename Value>
+std::optional<std::string_view> find_name(const Table& names, Value value) noexcept
+{
+	const auto* name = names.find(value);
+	if (!name)
+		return {};
+	return *name;
+}
+
+constexpr auto processor_architecture_names
+	= utilities::make_reverse_sorted_table(processor_architectures);
+constexpr auto supported_os_names
+	= utilities::make_reverse_sorted_table(supported_os_guids);
+constexpr auto hash_algorithm_names
+	= utilities::make_reverse_sorted_table(hash_algorithms);
+constexpr auto threading_model_names
+	= utilities::make_reverse_sorted_table(threading_models);
+constexpr auto ole_misc_names
+	= utilities::make_reverse_sorted_table(ole_misc_flags);
+constexpr auto typelib_flag_names
+	= utilities::make_reverse_sorted_table(typelib_flags);
+constexpr auto dpi_aware_names
+	= utilities::make_reverse_sorted_table(dpi_aware_values);
+constexpr auto dpi_awareness_names
+	= utilities::make_reverse_sorted_table(dpi_awareness_values);
+constexpr auto execution_level_names
+	= utilities::make_reverse_sorted_table(execution_levels);
+} //namespace
+
 std::error_code make_error_code(manifest_errc e) noexcept
 {
 	return { static_cast<int>(e), manifest_category_instance };
 }
 
+std::optional<std::string_view> processor_architecture_to_string(
+	assembly_processor_architecture arch) noexcept
+{
+	return find_name(processor_architecture_names, arch);
+}
+
+std::optional<std::string_view> supported_os_to_guid(
+	assembly_supported_os os) noexcept
+{
+	return find_name(supported_os_names, os);
+}
+
+std::optional<std::string_view> hash_algorithm_to_string(
+	assembly_file_hash_algorithm algorithm) noexcept
+{
+	return find_name(hash_algorithm_names, algorithm);
+}
+
+std::optional<std::string_view> threading_model_to_string(
+	com_threading_model model) noexcept
+{
+	return find_name(threading_model_names, model);
+}
+
+std::optional<std::string_view> ole_misc_to_string(ole_misc::value flag) noexcept
+{
+	return find_name(ole_misc_names, flag);
+}
+
+std::optional<std::string_view> typelib_flag_to_string(
+	com_typelib_flags::value flag) noexcept
+{
+	return find_name(typelib_flag_names, flag);
+}
+
+std::optional<std::string_view> dpi_aware_to_string(dpi_aware_value value) noexcept
+{
+	return find_name(dpi_aware_names, value);
+}
+
+std::optional<std::string_view> dpi_awareness_to_string(
+	dpi_awareness_value value) noexcept
+{
+	return find_name(dpi_awareness_names, value);
+}
+
+std::optional<std::string_view> execution_level_to_string(
+	requested_execution_level level) noexcept
+{
+	return find_name(execution_level_names, level);
+}
+
 full_version parse_full_version(std::string_view version_string)
 {
 	auto version_numbers = parse_version_impl<4u>(version_string);
@@ -262,9 +444,7 @@ std::optional<lcid_info> assembly_identity_base<Bases...>
 	if (*language_ == "*")
 		return get_lcid_info(0u); //neutral
 
-	auto language_lower = *language_;
-	utilities::to_lower_inplace(language_lower);
-	return get_lcid_info(language_lower);
+	return get_lcid_info(*language_);
 }
 
 template<typename... Bases>
@@ -274,18 +454,8 @@ assembly_processor_architecture assembly_identity_base<Bases...>
 	if (!processor_architecture_)
 		return assembly_processor_architecture::unspecified;
 
-	if (*processor_architecture_ == "x86")
-		return assembly_processor_architecture::x86;
-	if (*processor_architecture_ == "amd64")
-		return assembly_processor_architecture::amd64;
-	if (*processor_architecture_ == "arm")
-		return assembly_processor_architecture::arm;
-	if (*processor_architecture_ == "arm64")
-		return assembly_processor_architecture::arm64;
-	if (*processor_architecture_ == "*")
-		return assembly_processor_architecture::any;
-
-	return assembly_processor_architecture::unknown;
+	return find_value(processor_architectures, *processor_architecture_,
+		assembly_processor_architecture::unknown);
 }
 
 template<typename... Bases>
@@ -322,40 +492,15 @@ template<typename... Bases>
 std::unordered_set<assembly_supported_os> assembly_supported_os_list_base<Bases...>
 	::get_list() const
 {
-	static constexpr guid_version_type guid_vista{
-		"{e2011457-1546-43c5-a5fe-008deee3d3f0}",
-		assembly_supported_os::win_vista_server2008 };
-	static constexpr guid_version_type guid_7{
-		"{35138b9a-5d96-4fbd-8e2d-a2440225f93a}",
-		assembly_supported_os::win7_server2008_r2 };
-	static constexpr guid_version_type guid_8{
-		"{4a2f28e3-53b9-4441-ba9c-d69d4a4a6e38}",
-		assembly_supported_os::win8_server2012 };
-	static constexpr guid_version_type guid_8_1{
-		"{1f676c76-80e1-4239-95bb-83d0f6d0da78}",
-		assembly_supported_os::win8_1_server2012_r2 };
-	static constexpr guid_version_type guid_10{
-		"{8e0f7a12-bfb3-4fe8-b9a5-48fd50a15a9a}",
-		assembly_supported_os::win10_win11_server2016_server2019_server2022 };
-
 	std::unordered_set<assembly_supported_os> result;
 	result.reserve(supported_os_.size());
 	bool all_os_found = true;
 	for (const auto& guid : supported_os_)
 	{
-		bool os_found = false;
-		for (const auto& [target_guid, version] : {
-			guid_vista, guid_7, guid_8, guid_8_1, guid_10 })
-		{
-			if (utilities::iequal(target_guid, guid))
-			{
-				os_found = true;
-				result.insert(version);
-				break;
-			}
-		}
-
-		if (!os_found)
+		const auto* os = supported_os_guids.find(guid);
+		if (os)
+			result.insert(*os);
+		else
 			all_os_found = false;
 	}
 
@@ -383,9 +528,7 @@ active_code_page_type active_code_page::get_code_page() const noexcept
 	if (utilities::iequal(name_, "Legacy"))
 		return legacy_code_page_tag{};
 
-	auto name = name_;
-	utilities::to_lower_inplace(name);
-	auto info = get_lcid_info(name);
+	auto info = get_lcid_info(name_);
 	if (info)
 		return *info;
 
@@ -397,19 +540,7 @@ dpi_aware_value dpi_awareness::get_dpi_aware_value() const noexcept
 	if (!dpi_aware_)
 		return dpi_aware_value::absent;
 
-	if (utilities::iequal(*dpi_aware_, "true"))
-		return dpi_aware_value::dpi_aware;
-
-	if (utilities::iequal(*dpi_aware_, "false"))
-		return dpi_aware_value::dpi_unaware;
-
-	if (utilities::iequal(*dpi_aware_, "true/pm"))
-		return dpi_aware_value::dpi_aware_true_per_monitor;
-
-	if (utilities::iequal(*dpi_aware_, "per monitor"))
-		return dpi_aware_value::dpi_aware_per_monitor;
-
-	return dpi_aware_value::absent;
+	return find_value(dpi_aware_values, *dpi_aware_, dpi_aware_value::absent);
 }
 
 dpi_awareness_value dpi_awareness::get_dpi_awareness_value() const noexcept
@@ -422,17 +553,11 @@ dpi_awareness_value dpi_awareness::get_dpi_awareness_value() const noexcept
 	for_each_part(*dpi_awareness_, delim, [&](std::string_view elem) {
 		utilities::trim(elem);
 
-		if (utilities::iequal(elem, "system"))
-			value = dpi_awareness_value::dpi_aware_system;
-		else if (utilities::iequal(elem, "permonitor"))
-			value = dpi_awareness_value::dpi_aware_per_monitor;
-		else if (utilities::iequal(elem, "permonitorv2"))
-			value = dpi_awareness_value::dpi_aware_per_monitor_v2;
-		else if (utilities::iequal(elem, "unaware"))
-			value = dpi_awareness_value::dpi_unaware;
-		else
+		const auto* known_value = dpi_awareness_values.find(elem);
+		if (!known_value)
 			return true;
 
+		value = *known_value;
 		return false;
 	});
 
@@ -449,14 +574,8 @@ heap_type_value heap_type::get_heap_type() const noexcept
 
 requested_execution_level requested_privileges::get_level() const noexcept
 {
-	if (level_ == "asInvoker")
-		return requested_execution_level::as_invoker;
-	if (level_ == "requireAdministrator")
-		return requested_execution_level::require_administrator;
-	if (level_ == "highestAvailable")
-		return requested_execution_level::highest_available;
-
-	return requested_execution_level::unknown;
+	return find_value(execution_levels, level_,
+		requested_execution_level::unknown);
 }
 
 std::optional<bool> requested_privileges::get_ui_access() const noexcept
@@ -478,16 +597,8 @@ com_threading_model string_to_threading_model(
 	if (!threading_model)
 		return com_threading_model::unspecified;
 
-	if (utilities::iequal(*threading_model, "Neutral"))
-		return com_threading_model::neutral;
-	if (utilities::iequal(*threading_model, "Apartment"))
-		return com_threading_model::apartment;
-	if (utilities::iequal(*threading_model, "Free"))
-		return com_threading_model::free;
-	if (utilities::iequal(*threading_model, "Both"))
-		return com_threading_model::both;
-
-	return com_threading_model::unknown;
+	return find_value(threading_models, *threading_model,
+		com_threading_model::unknown);
 }
 } //namespace
 
@@ -545,42 +656,11 @@ ole_misc::value misc_status_string_to_value(const std::optional<std::string>& st
 	if (!str)
 		return {};
 
-	static const std::unordered_map<std::string_view, ole_misc::value> value_map{
-		{ "recomposeonresize", ole_misc::recomposeonresize },
-		{ "onlyiconic", ole_misc::onlyiconic },
-		{ "insertnotreplace", ole_misc::insertnotreplace },
-		{ "static", ole_misc::static_value },
-		{ "cantlinkinside", ole_misc::cantlinkinside },
-		{ "canlinkbyole1", ole_misc::canlinkbyole1 },
-		{ "islinkobject", ole_misc::islinkobject },
-		{ "insideout", ole_misc::insideout },
-		{ "activatewhenvisible", ole_misc::activatewhenvisible },
-		{ "renderingisdeviceindependent", ole_misc::renderingisdeviceindependent },
-		{ "invisibleatruntime", ole_misc::invisibleatruntime },
-		{ "alwaysrun", ole_misc::alwaysrun },
-		{ "actslikebutton", ole_misc::actslikebutton },
-		{ "actslikelabel", ole_misc::actslikelabel },
-		{ "nouiactivate", ole_misc::nouiactivate },
-		{ "alignable", ole_misc::alignable },
-		{ "simpleframe", ole_misc::simpleframe },
-		{ "setclientsitefirst", ole_misc::setclientsitefirst },
-		{ "imemode", ole_misc::imemode },
-		{ "ignoreativatewhenvisible", ole_misc::ignoreativatewhenvisible },
-		{ "wantstomenumerge", ole_misc::wantstomenumerge },
-		{ "supportsmultilevelundo", ole_misc::supportsmultilevelundo }
-	};
-
 	std::uint32_t result{};
 	static constexpr std::string_view delim{ "," };
 	for_each_part(*str, delim, [&](std::string_view elem) {
 		utilities::trim(elem);
-		std::string elem_copy(elem);
-		utilities::to_lower_inplace(elem_copy);
-		auto it = value_map.find(elem_copy);
-		if (it != value_map.cend())
-			result |= it->second;
-		else
-			result |= ole_misc::unknown;
+		result |= find_value(ole_misc_flags, elem, ole_misc::unknown);
 		return true;
 	});
 
@@ -713,16 +793,7 @@ std::optional<com_typelib_flags::value> com_typelib_base<Bases...>::get_flags()
 	static constexpr std::string_view delim{ "," };
 	for_each_part(*flags_, delim, [&](std::string_view elem) {
 		utilities::trim(elem);
-		if (utilities::iequal(elem, "RESTRICTED"))
-			result |= com_typelib_flags::restricted;
-		else if (utilities::iequal(elem, "CONTROL"))
-			result |= com_typelib_flags::control;
-		else if (utilities::iequal(elem, "HIDDEN"))
-			result |= com_typelib_flags::hidden;
-		else if (utilities::iequal(elem, "HASDISKIMAGE"))
-			result |= com_typelib_flags::has_disk_image;
-		else
-			result |= com_typelib_flags::unknown;
+		result |= find_value(typelib_flags, elem, com_typelib_flags::unknown);
 		return true;
 	});
 
@@ -832,12 +903,8 @@ assembly_file_hash_algorithm assembly_file_base<Bases...>
 	if (!hash_algorithm_)
 		return assembly_file_hash_algorithm::unspecified;
 
-	if (utilities::iequal(*hash_algorithm_, "sha1"))
-		return assembly_file_hash_algorithm::sha1;
-	if (utilities::iequal(*hash_algorithm_, "sha256"))
-		return assembly_file_hash_algorithm::sha256;
-
-	return assembly_file_hash_algorithm::unknown;
+	return find_value(hash_algorithms, *hash_algorithm_,
+		assembly_file_hash_algorithm::unknown);
 }
 
 template<typename... Bases>
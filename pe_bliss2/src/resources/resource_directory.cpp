@@ -76,7 +76,7 @@ public:
 	template<typename Entry>
 	bool operator()(const Entry& entry) noexcept
 	{
-		const auto* name = std::get_if<pe_bliss::packed_utf16_string>(
+		const auto* name = std::get_if<pe_bliss::resources::resource_name_type>(
 			&entry.get_name_or_id());
 		return name && name->value() == name_;
 	}
@@ -85,6 +85,50 @@ private:
 	std::u16string_view name_;
 };
 
+//Named entries go first, as in the on-disk directory
+struct entry_less
+{
+	template<typename Entry>
+	bool operator()(const Entry& l, const Entry& r) const noexcept
+	{
+		if (l.is_named() == r.is_named())
+			return l.get_name_or_id() < r.get_name_or_id();
+		else
+			return l.is_named();
+	}
+};
+
+template<typename Entries>
+auto find_entry_by_id(Entries& entries, resource_id_type id, bool sorted) noexcept
+{
+	if (!sorted)
+		return std::find_if(entries.begin(), entries.end(), id_entry_finder(id));
+
+	auto it = std::lower_bound(entries.begin(), entries.end(), id,
+		[](const auto& entry, resource_id_type id) {
+			const auto* entry_id = std::get_if<resource_id_type>(&entry.get_name_or_id());
+			return !entry_id || *entry_id < id;
+		});
+	if (it != entries.end() && !id_entry_finder(id)(*it))
+		it = entries.end();
+	return it;
+}
+
+template<typename Entries>
+auto find_entry_by_name(Entries& entries, std::u16string_view name, bool sorted) noexcept
+{
+	if (!sorted)
+		return std::find_if(entries.begin(), entries.end(), name_entry_finder(name));
+
+	auto it = std::lower_bound(entries.begin(), entries.end(), name,
+		[](const auto& entry, std::u16string_view name) {
+			return entry.is_named() && entry.get_name().value() < name;
+		});
+	if (it != entries.end() && !name_entry_finder(name)(*it))
+		it = entries.end();
+	return it;
+}
+
 } //namespace
 
 namespace pe_bliss::resources
@@ -99,28 +143,28 @@ template<typename... Bases>
 typename resource_directory_base<Bases...>::entry_list_type::const_iterator
 resource_directory_base<Bases...>::entry_iterator_by_id(resource_id_type id) const noexcept
 {
-	return std::find_if(entries_.begin(), entries_.end(), id_entry_finder(id));
+	return find_entry_by_id(entries_, id, sorted_entries_);
 }
 
 template<typename... Bases>
 typename resource_directory_base<Bases...>::entry_list_type::iterator
 resource_directory_base<Bases...>::entry_iterator_by_id(resource_id_type id) noexcept
 {
-	return std::find_if(entries_.begin(), entries_.end(), id_entry_finder(id));
+	return find_entry_by_id(entries_, id, sorted_entries_);
 }
 
 template<typename... Bases>
 typename resource_directory_base<Bases...>::entry_list_type::const_iterator
 resource_directory_base<Bases...>::entry_iterator_by_name(std::u16string_view name) const noexcept
 {
-	return std::find_if(entries_.begin(), entries_.end(), name_entry_finder(name));
+	return find_entry_by_name(entries_, name, sorted_entries_);
 }
 
 template<typename... Bases>
 typename resource_directory_base<Bases...>::entry_list_type::iterator
 resource_directory_base<Bases...>::entry_iterator_by_name(std::u16string_view name) noexcept
 {
-	return std::find_if(entries_.begin(), entries_.end(), name_entry_finder(name));
+	return find_entry_by_name(entries_, name, sorted_entries_);
 }
 
 template<typename... Bases>
@@ -286,6 +330,7 @@ typename resource_directory_base<Bases...>::entry_type& try_emplace_entry(
 	NameOrId&& name_or_id, directory_entry_contents contents,
 	resource_directory_base<Bases...>& dir)
 {
+	const bool sorted = dir.has_sorted_entries();
 	typename resource_directory_base<Bases...>::entry_list_type::iterator it;
 	static constexpr bool is_id = std::is_same_v<
 		std::remove_cvref_t<NameOrId>, resource_id_type>;
@@ -294,7 +339,7 @@ typename resource_directory_base<Bases...>::entry_type& try_emplace_entry(
 	else
 		it = dir.entry_iterator_by_name(name_or_id);
 
-	if (it == dir.get_entries().end())
+	if (it == std::as_const(dir).get_entries().end())
 	{
 		auto& entry = dir.get_entries().emplace_back();
 		if constexpr (is_id)
@@ -303,11 +348,21 @@ typename resource_directory_base<Bases...>::entry_type& try_emplace_entry(
 		}
 		else
 		{
-			entry.get_name_or_id() = packed_utf16_string(
-				std::forward<NameOrId>(name_or_id));
+			//The name is allocated in the same way as the entry list
+			entry.get_name_or_id() = resource_name_type(
+				std::forward<NameOrId>(name_or_id),
+				dir.get_entries().get_allocator());
 		}
 
-		it = std::prev(dir.get_entries().end());
+		auto& entries = dir.get_entries();
+		it = std::prev(entries.end());
+		if (sorted)
+		{
+			auto pos = std::upper_bound(entries.begin(), it, *it, entry_less{});
+			std::rotate(pos, it, entries.end());
+			it = pos;
+			dir.set_sorted_entries(true);
+		}
 	}
 
 	auto& data_or_directory = it->get_data_or_directory();
@@ -366,6 +421,13 @@ typename resource_directory_base<Bases...>::entry_type& resource_directory_base<
 	return try_emplace_entry(std::move(name), contents, *this);
 }
 
+template<typename... Bases>
+void resource_directory_base<Bases...>::sort_entries()
+{
+	std::stable_sort(entries_.begin(), entries_.end(), entry_less{});
+	sorted_entries_ = true;
+}
+
 template class resource_directory_entry_base<>;
 template class resource_directory_entry_base<error_list>;
 template class resource_directory_base<>;
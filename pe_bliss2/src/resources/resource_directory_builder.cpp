@@ -0,0 +1,491 @@
+#include "pe_bliss2/resources/resource_directory_builder.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include "buffers/output_buffer_interface.h"
+#include "buffers/output_memory_ref_buffer.h"
+#include "buffers/ref_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/detail/resources/image_resource_directory.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/section_data_from_va.h"
+#include "pe_bliss2/pe_error.h"
+#include "utilities/generic_error.h"
+#include "utilities/hash.h"
+#include "utilities/math.h"
+#include "utilities/safe_uint.h"
+
+namespace
+{
+
+struct resource_directory_builder_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "resource_directory_builder";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::resources::resource_directory_builder_errc;
+		switch (static_cast<pe_bliss::resources::resource_directory_builder_errc>(ev))
+		{
+		case invalid_data_alignment:
+			return "Invalid resource data alignment";
+		case invalid_directory_entry:
+			return "Resource directory entry does not have name, ID, data or directory";
+		case directory_is_too_large:
+			return "Resource directory is too large";
+		default:
+			return {};
+		}
+	}
+};
+
+const resource_directory_builder_error_category resource_directory_builder_error_category_instance;
+
+using namespace pe_bliss;
+using namespace pe_bliss::resources;
+
+//Directory and name offsets have the highest bit reserved
+constexpr std::uint32_t max_offset = ~detail::resources::data_is_directory_flag;
+constexpr std::uint32_t min_data_alignment = sizeof(std::uint32_t);
+constexpr std::uint32_t data_entry_size
+	= resource_data_entry::descriptor_type::packed_size;
+
+//Resource data with the trailing zero bytes stripped (virtual part
+//of the data is zero-filled, too). Two blobs are identical if they
+//have the same size and the same stripped data.
+struct blob_key
+{
+	const std::byte* data{};
+	std::size_t stripped_size{};
+	std::size_t size{};
+	std::size_t hash{};
+};
+
+struct blob_key_hash
+{
+	std::size_t operator()(const blob_key& key) const noexcept
+	{
+		return key.hash;
+	}
+};
+
+struct blob_key_equal
+{
+	bool operator()(const blob_key& l, const blob_key& r) const noexcept
+	{
+		return l.size == r.size && l.stripped_size == r.stripped_size
+			&& std::equal(l.data, l.data + l.stripped_size, r.data);
+	}
+};
+
+using blob_storage_type = std::vector<std::vector<std::byte>>;
+
+blob_key make_blob_key(const buffers::ref_buffer& data, blob_storage_type& storage)
+{
+	blob_key key{ .size = data.size() };
+	auto physical_size = data.physical_size();
+	if (physical_size)
+	{
+		auto buffer = data.data();
+		const auto* ptr = buffer->get_raw_data(0u, physical_size);
+		if (!ptr)
+		{
+			auto& copy = storage.emplace_back(physical_size);
+			if (buffer->read(0u, physical_size, copy.data()) != physical_size)
+				throw pe_error(buffers::ref_buffer_errc::unable_to_read_data);
+			ptr = copy.data();
+		}
+
+		while (physical_size && ptr[physical_size - 1u] == std::byte{})
+			--physical_size;
+
+		key.data = ptr;
+		key.stripped_size = physical_size;
+	}
+
+	key.hash = std::hash<std::string_view>{}(std::string_view(
+		reinterpret_cast<const char*>(key.data), key.stripped_size));
+	utilities::hash_combine(key.hash, key.size);
+	return key;
+}
+
+//Non-const get_entries() resets the sorted flag of the directory.
+//The builder does not add, rename or reorder entries, so the flag is kept.
+template<typename Directory>
+auto& get_entries(Directory& dir) noexcept
+{
+	if constexpr (std::is_const_v<Directory>)
+	{
+		return dir.get_entries();
+	}
+	else
+	{
+		const bool sorted = dir.has_sorted_entries();
+		auto& entries = dir.get_entries();
+		dir.set_sorted_entries(sorted);
+		return entries;
+	}
+}
+
+template<typename Directory>
+struct directory_layout
+{
+	using data_entry_ptr = decltype(&std::declval<Directory&>()
+		.get_entries().front().get_data());
+
+	//All directories, breadth-first
+	std::vector<Directory*> directories;
+	std::vector<std::uint32_t> directory_offsets;
+	std::vector<data_entry_ptr> data_entries;
+	//Offsets of data of each data entry
+	std::vector<std::uint32_t> data_offsets;
+	//Offsets of names of each named entry, in the directory order
+	std::vector<std::uint32_t> name_offsets;
+	//Unique names and data blobs to write
+	std::vector<std::u16string_view> names;
+	std::vector<const buffers::ref_buffer*> blobs;
+	std::uint32_t data_entries_offset{};
+	std::uint32_t names_offset{};
+	std::uint32_t data_offset{};
+	std::uint32_t size{};
+};
+
+template<typename Directory>
+void plan_directories(Directory& root, directory_layout<Directory>& layout,
+	utilities::safe_uint<std::uint32_t>& offset)
+{
+	layout.directories.push_back(&root);
+	for (std::size_t i = 0; i != layout.directories.size(); ++i)
+	{
+		auto& dir = *layout.directories[i];
+		//The sorted flag may be stale if entries returned by lookups
+		//have been renamed, so entries are always sorted before writing
+		if constexpr (!std::is_const_v<Directory>)
+			dir.sort_entries();
+
+		layout.directory_offsets.push_back(offset.value());
+		offset += dir.get_descriptor().packed_size;
+		for (auto& entry : get_entries(dir))
+		{
+			offset += entry.get_descriptor().packed_size;
+			if (std::holds_alternative<std::monostate>(entry.get_name_or_id()))
+				throw pe_error(resource_directory_builder_errc::invalid_directory_entry);
+
+			if (entry.has_directory())
+				layout.directories.push_back(&entry.get_directory());
+			else if (entry.has_data())
+				layout.data_entries.push_back(&entry.get_data());
+			else
+				throw pe_error(resource_directory_builder_errc::invalid_directory_entry);
+		}
+	}
+}
+
+template<typename Directory>
+void plan_names(directory_layout<Directory>& layout,
+	utilities::safe_uint<std::uint32_t>& offset, const builder_options& options)
+{
+	std::unordered_map<std::u16string_view, std::uint32_t> name_offsets;
+	for (const auto* dir : layout.directories)
+	{
+		for (const auto& entry : get_entries(*dir))
+		{
+			if (!entry.is_named())
+				continue;
+
+			const auto& name = entry.get_name().value();
+			if (name.size() > (std::numeric_limits<std::uint16_t>::max)())
+				throw pe_error(utilities::generic_errc::integer_overflow);
+
+			if (options.deduplicate_names)
+			{
+				auto [it, inserted] = name_offsets.try_emplace(name, offset.value());
+				layout.name_offsets.push_back(it->second);
+				if (!inserted)
+					continue;
+			}
+			else
+			{
+				layout.name_offsets.push_back(offset.value());
+			}
+
+			layout.names.push_back(name);
+			offset += sizeof(std::uint16_t);
+			offset += name.size() * sizeof(char16_t);
+		}
+	}
+}
+
+template<typename Directory>
+void plan_data(directory_layout<Directory>& layout,
+	utilities::safe_uint<std::uint32_t>& offset, const builder_options& options)
+{
+	blob_storage_type storage;
+	std::unordered_map<blob_key, std::uint32_t, blob_key_hash, blob_key_equal> blob_offsets;
+	for (const auto* data_entry : layout.data_entries)
+	{
+		const auto& data = data_entry->get_raw_data();
+		if (data.size() > (std::numeric_limits<std::uint32_t>::max)())
+			throw pe_error(resource_directory_builder_errc::directory_is_too_large);
+
+		if (options.deduplicate_data)
+		{
+			auto [it, inserted] = blob_offsets.try_emplace(
+				make_blob_key(data, storage), offset.value());
+			layout.data_offsets.push_back(it->second);
+			if (!inserted)
+				continue;
+		}
+		else
+		{
+			layout.data_offsets.push_back(offset.value());
+		}
+
+		layout.blobs.push_back(&data);
+		//Each blob is padded to the alignment, which makes the size
+		//of the directory independent of the blob order
+		offset += data.size();
+		offset.align_up(options.data_alignment);
+	}
+}
+
+template<typename Directory>
+directory_layout<Directory> plan_layout(Directory& root, const builder_options& options)
+{
+	if (options.data_alignment < min_data_alignment
+		|| !std::has_single_bit(options.data_alignment))
+	{
+		throw pe_error(resource_directory_builder_errc::invalid_data_alignment);
+	}
+
+	directory_layout<Directory> layout;
+	utilities::safe_uint<std::uint32_t> offset;
+	plan_directories(root, layout, offset);
+
+	layout.data_entries_offset = offset.value();
+	offset += static_cast<std::uint64_t>(layout.data_entries.size())
+		* data_entry_size;
+
+	layout.names_offset = offset.value();
+	plan_names(layout, offset, options);
+	if (offset.value() > max_offset)
+		throw pe_error(resource_directory_builder_errc::directory_is_too_large);
+
+	offset.align_up(options.data_alignment);
+	layout.data_offset = offset.value();
+	plan_data(layout, offset, options);
+	layout.size = offset.value();
+	return layout;
+}
+
+void write_padding(buffers::output_buffer_interface& buf, std::size_t size)
+{
+	static constexpr std::array<std::byte, 16u> zeros{};
+	while (size)
+	{
+		auto count = (std::min)(size, zeros.size());
+		buf.write(count, zeros.data());
+		size -= count;
+	}
+}
+
+void write_name(buffers::output_buffer_interface& buf, std::u16string_view name)
+{
+	auto length = boost::endian::native_to_little(
+		static_cast<std::uint16_t>(name.size()));
+	buf.write(sizeof(length), reinterpret_cast<const std::byte*>(&length));
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		buf.write(name.size() * sizeof(char16_t),
+			reinterpret_cast<const std::byte*>(name.data()));
+	}
+	else
+	{
+		for (auto ch : name)
+		{
+			boost::endian::native_to_little_inplace(ch);
+			buf.write(sizeof(ch), reinterpret_cast<const std::byte*>(&ch));
+		}
+	}
+}
+
+template<typename Directory>
+void write_directories(buffers::output_buffer_interface& buf,
+	const directory_layout<Directory>& layout)
+{
+	std::size_t next_directory = 1u, next_data_entry = 0u, next_name = 0u;
+	for (auto* dir : layout.directories)
+	{
+		std::size_t number_of_named_entries = 0;
+		for (const auto& entry : get_entries(*dir))
+			number_of_named_entries += entry.is_named();
+
+		auto number_of_id_entries = get_entries(*dir).size() - number_of_named_entries;
+		if (number_of_named_entries > (std::numeric_limits<std::uint16_t>::max)()
+			|| number_of_id_entries > (std::numeric_limits<std::uint16_t>::max)())
+		{
+			throw pe_error(resource_directory_builder_errc::directory_is_too_large);
+		}
+
+		auto& descriptor = dir->get_descriptor();
+		descriptor->number_of_named_entries
+			= static_cast<std::uint16_t>(number_of_named_entries);
+		descriptor->number_of_id_entries
+			= static_cast<std::uint16_t>(number_of_id_entries);
+		descriptor.serialize(buf, true);
+
+		for (auto& entry : get_entries(*dir))
+		{
+			auto& entry_descriptor = entry.get_descriptor();
+			if (entry.is_named())
+			{
+				entry_descriptor->name_or_id = detail::resources::name_is_string_flag
+					| layout.name_offsets[next_name++];
+			}
+			else
+			{
+				entry_descriptor->name_or_id = entry.get_id();
+			}
+
+			if (entry.has_directory())
+			{
+				entry_descriptor->offset_to_data_or_directory
+					= detail::resources::data_is_directory_flag
+					| layout.directory_offsets[next_directory++];
+			}
+			else
+			{
+				entry_descriptor->offset_to_data_or_directory = static_cast<std::uint32_t>(
+					layout.data_entries_offset + next_data_entry++
+					* data_entry_size);
+			}
+			entry_descriptor.serialize(buf, true);
+		}
+	}
+}
+
+template<typename Directory>
+std::uint32_t build_new_impl(buffers::output_buffer_interface& buf,
+	Directory& directory, const builder_options& options)
+{
+	auto layout = plan_layout(directory, options);
+	//Check that RVAs of all resource data fit
+	(void)(utilities::safe_uint<rva_type>(options.directory_rva) + layout.size);
+
+	auto start_pos = buf.wpos();
+	write_directories(buf, layout);
+
+	for (std::size_t i = 0; i != layout.data_entries.size(); ++i)
+	{
+		auto& descriptor = layout.data_entries[i]->get_descriptor();
+		descriptor->offset_to_data = options.directory_rva + layout.data_offsets[i];
+		descriptor->size = static_cast<std::uint32_t>(
+			layout.data_entries[i]->get_raw_data().size());
+		descriptor.serialize(buf, true);
+	}
+
+	for (auto name : layout.names)
+		write_name(buf, name);
+
+	write_padding(buf, layout.data_offset - (buf.wpos() - start_pos));
+	for (const auto* blob : layout.blobs)
+	{
+		blob->serialize(buf, true);
+		write_padding(buf, utilities::math::align_up(blob->size(),
+			options.data_alignment) - blob->size());
+	}
+
+	assert(buf.wpos() - start_pos == layout.size);
+	return layout.size;
+}
+
+void update_data_directory(image::image& instance,
+	const builder_options& options, std::uint32_t size)
+{
+	if (options.update_data_directory)
+	{
+		auto& dir = instance.get_data_directories().get_directory(
+			core::data_directories::directory_type::resource);
+		dir->virtual_address = options.directory_rva;
+		dir->size = size;
+	}
+}
+
+template<typename Directory>
+std::uint32_t build_new_impl(image::image& instance, Directory& directory,
+	const builder_options& options)
+{
+	assert(options.directory_rva);
+	auto buf = buffers::output_memory_ref_buffer(
+		section_data_from_rva(instance, options.directory_rva, true));
+	auto size = build_new_impl(buf, directory, options);
+	update_data_directory(instance, options, size);
+	return size;
+}
+
+} //namespace
+
+namespace pe_bliss::resources
+{
+
+std::error_code make_error_code(resource_directory_builder_errc e) noexcept
+{
+	return { static_cast<int>(e), resource_directory_builder_error_category_instance };
+}
+
+std::uint32_t build_new(image::image& instance, resource_directory& directory,
+	const builder_options& options)
+{
+	return build_new_impl(instance, directory, options);
+}
+
+std::uint32_t build_new(image::image& instance, resource_directory_details& directory,
+	const builder_options& options)
+{
+	return build_new_impl(instance, directory, options);
+}
+
+std::uint32_t build_new(buffers::output_buffer_interface& buf, resource_directory& directory,
+	const builder_options& options)
+{
+	return build_new_impl(buf, directory, options);
+}
+
+std::uint32_t build_new(buffers::output_buffer_interface& buf,
+	resource_directory_details& directory, const builder_options& options)
+{
+	return build_new_impl(buf, directory, options);
+}
+
+std::uint32_t get_built_size(const resource_directory& directory,
+	const builder_options& options)
+{
+	return plan_layout(directory, options).size;
+}
+
+std::uint32_t get_built_size(const resource_directory_details& directory,
+	const builder_options& options)
+{
+	return plan_layout(directory, options).size;
+}
+
+} //namespace pe_bliss::resources
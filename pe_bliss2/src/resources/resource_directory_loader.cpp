@@ -17,6 +17,7 @@
 #include "pe_bliss2/packed_utf16_string.h"
 #include "pe_bliss2/pe_error.h"
 #include "pe_bliss2/pe_types.h"
+#include "utilities/list_allocator.h"
 #include "utilities/math.h"
 #include "utilities/safe_uint.h"
 #include "utilities/scoped_guard.h"
@@ -70,7 +71,7 @@ using namespace pe_bliss::resources;
 using safe_rva_type = utilities::safe_uint<rva_type>;
 using visited_directories_set = std::unordered_set<rva_type>;
 
-bool is_sorted(const std::vector<resource_directory_entry_details>& entries)
+bool is_sorted(const resource_directory_details::entry_list_type& entries)
 {
 	return std::is_sorted(entries.cbegin(), entries.cend(),
 		[](const auto& l, const auto& r)
@@ -82,7 +83,7 @@ bool is_sorted(const std::vector<resource_directory_entry_details>& entries)
 	});
 }
 
-bool has_duplicates(const std::vector<resource_directory_entry_details>& entries)
+bool has_duplicates(const resource_directory_details::entry_list_type& entries)
 {
 	return std::adjacent_find(entries.cbegin(), entries.cend(),
 		[](const auto& l, const auto& r)
@@ -152,7 +153,8 @@ bool load_resource_directory_entry(const image::image& instance, const loader_op
 
 	if (entry_descriptor->name_or_id & detail::resources::name_is_string_flag)
 	{
-		auto& name = entry.get_name_or_id().emplace<packed_utf16_string>();
+		auto& name = entry.get_name_or_id().emplace<resource_name_type>();
+		utilities::use_memory_resource(name.value(), options.memory_resource);
 
 		safe_rva_type name_rva;
 		try
@@ -194,6 +196,7 @@ bool load_resource_directory_entry(const image::image& instance, const loader_op
 		{
 			auto& directory = entry.get_data_or_directory().emplace<
 				resource_directory_details>();
+			directory.use_error_memory_resource(options.memory_resource);
 			directory.add_error(
 				resource_directory_loader_errc::invalid_resource_directory);
 			return true;
@@ -215,6 +218,7 @@ bool load_resource_directory_entry(const image::image& instance, const loader_op
 	{
 		auto& data_entry = entry.get_data_or_directory()
 			.emplace<resource_data_entry_details>();
+		data_entry.use_error_memory_resource(options.memory_resource);
 		try
 		{
 			auto data_entry_rva = resource_dir_rva
@@ -239,6 +243,8 @@ void load_resource_directory(const image::image& instance, const loader_options&
 	utilities::scoped_guard guard([&visited_directories, current_rva] {
 		visited_directories.erase(current_rva.value());
 	});
+	directory.use_error_memory_resource(options.memory_resource);
+	utilities::use_memory_resource(directory.get_entries(), options.memory_resource);
 
 	auto& descriptor = directory.get_descriptor();
 	try
@@ -269,6 +275,7 @@ void load_resource_directory(const image::image& instance, const loader_options&
 	for (std::uint32_t i = 0; i != entry_count; ++i)
 	{
 		auto& entry = directory.get_entries().emplace_back();
+		entry.use_error_memory_resource(options.memory_resource);
 		if (!load_resource_directory_entry(instance, options, resource_dir_rva,
 			current_rva, max_rva, entry, visited_directories))
 		{
@@ -300,6 +307,10 @@ void load_resource_directory(const image::image& instance, const loader_options&
 		directory.add_error(
 			resource_directory_loader_errc::duplicate_entries);
 	}
+	else
+	{
+		directory.set_sorted_entries(true);
+	}
 
 	if (number_of_named_entries != descriptor->number_of_named_entries)
 	{
@@ -0,0 +1,136 @@
+#include "pe_bliss2/resources/resource_index.h"
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+
+#include "pe_bliss2/pe_error.h"
+
+namespace
+{
+
+using namespace pe_bliss::resources;
+
+template<typename Entry>
+bool to_name_or_id_view(const Entry& entry, resource_name_or_id_view& result) noexcept
+{
+	if (entry.has_id())
+		result = resource_name_or_id_view(entry.get_id());
+	else if (entry.is_named())
+		result = resource_name_or_id_view(std::u16string_view(entry.get_name().value()));
+	else
+		return false;
+	return true;
+}
+
+template<typename IndexEntry>
+auto to_tuple(const IndexEntry& entry) noexcept
+{
+	return std::tie(entry.type, entry.name_or_id, entry.language);
+}
+
+} //namespace
+
+namespace pe_bliss::resources
+{
+
+template<typename... Bases>
+resource_index_base<Bases...>::resource_index_base(const directory_type& root)
+{
+	index_entry entry;
+	for (const auto& type_entry : root.get_entries())
+	{
+		if (!type_entry.has_directory() || !to_name_or_id_view(type_entry, entry.type))
+			continue;
+
+		for (const auto& name_entry : type_entry.get_directory().get_entries())
+		{
+			if (!name_entry.has_directory()
+				|| !to_name_or_id_view(name_entry, entry.name_or_id))
+			{
+				continue;
+			}
+
+			for (const auto& language_entry : name_entry.get_directory().get_entries())
+			{
+				if (!language_entry.has_data() || !language_entry.has_id())
+					continue;
+
+				entry.language = language_entry.get_id();
+				entry.data = &language_entry.get_data();
+				entries_.emplace_back(entry);
+			}
+		}
+	}
+
+	//Entries of loaded directories are already sorted,
+	//stable sort keeps the first entry of duplicates first
+	if (!std::is_sorted(entries_.cbegin(), entries_.cend(),
+		[](const auto& l, const auto& r) { return to_tuple(l) < to_tuple(r); }))
+	{
+		std::stable_sort(entries_.begin(), entries_.end(),
+			[](const auto& l, const auto& r) { return to_tuple(l) < to_tuple(r); });
+	}
+}
+
+template<typename... Bases>
+const typename resource_index_base<Bases...>::data_entry_type*
+resource_index_base<Bases...>::try_get_data(resource_name_or_id_view type,
+	resource_name_or_id_view name_or_id, resource_id_type language) const noexcept
+{
+	auto key = std::tie(type, name_or_id, language);
+	auto it = std::lower_bound(entries_.cbegin(), entries_.cend(), key,
+		[](const auto& entry, const auto& key) { return to_tuple(entry) < key; });
+	if (it == entries_.cend() || to_tuple(*it) != key)
+		return nullptr;
+
+	return it->data;
+}
+
+template<typename... Bases>
+const typename resource_index_base<Bases...>::data_entry_type&
+resource_index_base<Bases...>::get_data(resource_name_or_id_view type,
+	resource_name_or_id_view name_or_id, resource_id_type language) const
+{
+	const auto* data = try_get_data(type, name_or_id, language);
+	if (!data)
+		throw pe_error(resource_directory_errc::entry_does_not_exist);
+
+	return *data;
+}
+
+template<typename... Bases>
+std::span<const typename resource_index_base<Bases...>::index_entry>
+resource_index_base<Bases...>::get_languages(resource_name_or_id_view type,
+	resource_name_or_id_view name_or_id) const noexcept
+{
+	auto key = std::tie(type, name_or_id);
+	auto [first, last] = std::equal_range(entries_.cbegin(), entries_.cend(), key,
+		[](const auto& l, const auto& r) {
+			if constexpr (std::is_same_v<std::remove_cvref_t<decltype(l)>, index_entry>)
+				return std::tie(l.type, l.name_or_id) < r;
+			else
+				return l < std::tie(r.type, r.name_or_id);
+		});
+	return { first, last };
+}
+
+template<typename... Bases>
+std::span<const typename resource_index_base<Bases...>::index_entry>
+resource_index_base<Bases...>::get_resources(
+	resource_name_or_id_view type) const noexcept
+{
+	auto [first, last] = std::equal_range(entries_.cbegin(), entries_.cend(), type,
+		[](const auto& l, const auto& r) {
+			if constexpr (std::is_same_v<std::remove_cvref_t<decltype(l)>, index_entry>)
+				return l.type < r;
+			else
+				return l < r.type;
+		});
+	return { first, last };
+}
+
+template class resource_index_base<>;
+template class resource_index_base<error_list>;
+
+} //namespace pe_bliss::resources
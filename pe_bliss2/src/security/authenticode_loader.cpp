@@ -61,11 +61,20 @@ std::error_code make_error_code(authenticode_loader_errc e) noexcept
 template<typename TargetRangeType, typename RangeType>
 std::vector<authenticode_pkcs7<TargetRangeType>> load_nested_signatures(
 	const pkcs7::attribute_map<RangeType>& unauthenticated_attributes)
+{
+	authenticode_unauthenticated_attributes attributes;
+	attributes.nested_signatures = unauthenticated_attributes.get_attributes(
+		asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute);
+	return load_nested_signatures<TargetRangeType>(attributes);
+}
+
+template<typename TargetRangeType>
+std::vector<authenticode_pkcs7<TargetRangeType>> load_nested_signatures(
+	const authenticode_unauthenticated_attributes& unauthenticated_attributes)
 {
 	std::vector<authenticode_pkcs7<TargetRangeType>> result;
 
-	const auto nested_signatures = unauthenticated_attributes.get_attributes(
-		asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute);
+	const auto& nested_signatures = unauthenticated_attributes.nested_signatures;
 	result.reserve(nested_signatures.size());
 	for (const auto& nested_signature : nested_signatures)
 	{
@@ -124,6 +133,14 @@ authenticode_pkcs7<RangeType> load_authenticode_signature(
 	return load_authenticode_signature<RangeType>(buffer);
 }
 
+authenticode_pkcs7<span_range_type> load_authenticode_signature(
+	const buffers::input_buffer_ptr& buffer,
+	buffers::ref_buffer& signature_data)
+{
+	signature_data.deserialize_contiguous(buffer);
+	return load_authenticode_signature<span_range_type>(*signature_data.data());
+}
+
 template authenticode_pkcs7<span_range_type> load_authenticode_signature(
 	buffers::input_buffer_interface& buffer);
 template authenticode_pkcs7<vector_range_type> load_authenticode_signature(
@@ -148,5 +165,9 @@ template std::vector<authenticode_pkcs7<vector_range_type>> load_nested_signatur
 template std::vector<authenticode_pkcs7<vector_range_type>> load_nested_signatures<
 	vector_range_type, vector_range_type>(
 		const pkcs7::attribute_map<vector_range_type>& unauthenticated_attributes);
+template std::vector<authenticode_pkcs7<span_range_type>> load_nested_signatures<
+	span_range_type>(const authenticode_unauthenticated_attributes& unauthenticated_attributes);
+template std::vector<authenticode_pkcs7<vector_range_type>> load_nested_signatures<
+	vector_range_type>(const authenticode_unauthenticated_attributes& unauthenticated_attributes);
 
 } //namespace pe_bliss::security
@@ -0,0 +1,679 @@
+#include "pe_bliss2/security/authenticode_signer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "cryptopp/cryptlib.h"
+#include "cryptopp/osrng.h"
+#include "cryptopp/queue.h"
+#include "cryptopp/rsa.h"
+#include "cryptopp/sha.h"
+
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/core/file_header.h"
+#include "pe_bliss2/core/image_signature.h"
+#include "pe_bliss2/core/optional_header.h"
+#include "pe_bliss2/detail/packed_reflection.h"
+#include "pe_bliss2/detail/packed_serialization.h"
+#include "pe_bliss2/detail/security/image_security_directory.h"
+#include "pe_bliss2/image/checksum.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/buffer_hash.h"
+#include "pe_bliss2/security/der_helpers.h"
+#include "pe_bliss2/security/image_hash.h"
+#include "pe_bliss2/security/security_directory_loader.h"
+
+#include "utilities/math.h"
+#include "utilities/safe_uint.h"
+
+namespace
+{
+struct authenticode_signer_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "authenticode_signer";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::authenticode_signer_errc;
+		switch (static_cast<pe_bliss::security::authenticode_signer_errc>(ev))
+		{
+		case unsupported_digest_algorithm:
+			return "Unsupported signature digest algorithm";
+		case invalid_private_key:
+			return "Invalid RSA private key";
+		case invalid_signer_certificate:
+			return "Invalid signer certificate";
+		case invalid_signature:
+			return "Invalid existing Authenticode signature";
+		case invalid_security_directory:
+			return "Image security directory is absent or is not located at the end of the image";
+		case unable_to_sign:
+			return "Unable to sign the image";
+		case unsupported_page_hash_algorithm:
+			return "Page hashes are supported for SHA-1 and SHA-256 digests only";
+		default:
+			return {};
+		}
+	}
+};
+
+const authenticode_signer_error_category authenticode_signer_error_category_instance;
+} //namespace
+
+namespace pe_bliss::security
+{
+
+std::error_code make_error_code(authenticode_signer_errc e) noexcept
+{
+	return { static_cast<int>(e), authenticode_signer_error_category_instance };
+}
+
+namespace
+{
+
+template<std::size_t N>
+using oid_type = std::array<std::uint32_t, N>;
+
+constexpr oid_type<7u> oid_signed_data{ 1, 2, 840, 113549, 1, 7, 2 };
+constexpr oid_type<7u> oid_content_type{ 1, 2, 840, 113549, 1, 9, 3 };
+constexpr oid_type<7u> oid_message_digest{ 1, 2, 840, 113549, 1, 9, 4 };
+constexpr oid_type<7u> oid_signing_time{ 1, 2, 840, 113549, 1, 9, 5 };
+constexpr oid_type<7u> oid_rsa_encryption{ 1, 2, 840, 113549, 1, 1, 1 };
+constexpr oid_type<10u> oid_spc_indirect_data{ 1, 3, 6, 1, 4, 1, 311, 2, 1, 4 };
+constexpr oid_type<10u> oid_spc_statement_type{ 1, 3, 6, 1, 4, 1, 311, 2, 1, 11 };
+constexpr oid_type<10u> oid_spc_sp_opus_info{ 1, 3, 6, 1, 4, 1, 311, 2, 1, 12 };
+constexpr oid_type<10u> oid_spc_pe_image_data{ 1, 3, 6, 1, 4, 1, 311, 2, 1, 15 };
+constexpr oid_type<10u> oid_spc_individual_sp_key_purpose{ 1, 3, 6, 1, 4, 1, 311, 2, 1, 21 };
+constexpr oid_type<10u> oid_spc_page_hash_v1{ 1, 3, 6, 1, 4, 1, 311, 2, 3, 1 };
+constexpr oid_type<10u> oid_spc_page_hash_v2{ 1, 3, 6, 1, 4, 1, 311, 2, 3, 2 };
+constexpr oid_type<10u> oid_spc_nested_signature{ 1, 3, 6, 1, 4, 1, 311, 2, 4, 1 };
+constexpr oid_type<6u> oid_sha1{ 1, 3, 14, 3, 2, 26 };
+constexpr oid_type<9u> oid_sha256{ 2, 16, 840, 1, 101, 3, 4, 2, 1 };
+constexpr oid_type<9u> oid_sha384{ 2, 16, 840, 1, 101, 3, 4, 2, 2 };
+constexpr oid_type<9u> oid_sha512{ 2, 16, 840, 1, 101, 3, 4, 2, 3 };
+
+constexpr std::array page_hashes_class_id{
+	std::byte{ 0xa6u }, std::byte{ 0xb5u }, std::byte{ 0x86u }, std::byte{ 0xd5u },
+	std::byte{ 0xb4u }, std::byte{ 0xa1u }, std::byte{ 0x24u }, std::byte{ 0x66u },
+	std::byte{ 0xaeu }, std::byte{ 0x05u }, std::byte{ 0xa2u }, std::byte{ 0x17u },
+	std::byte{ 0xdau }, std::byte{ 0x8eu }, std::byte{ 0x60u }, std::byte{ 0xd6u }
+};
+
+constexpr std::byte context_0 = der::tag::context_specific(0u, true);
+constexpr std::byte context_1 = der::tag::context_specific(1u, true);
+constexpr std::byte context_2 = der::tag::context_specific(2u, true);
+constexpr std::byte context_0_primitive = der::tag::context_specific(0u, false);
+
+std::vector<std::byte> encode_algorithm_identifier(std::span<const std::uint32_t> oid)
+{
+	return der::encode(der::tag::sequence, { der::encode_oid(oid), der::encode_null() });
+}
+
+std::vector<std::byte> encode_digest_algorithm(digest_algorithm algorithm)
+{
+	switch (algorithm)
+	{
+	case digest_algorithm::sha1:
+		return encode_algorithm_identifier(oid_sha1);
+	case digest_algorithm::sha256:
+		return encode_algorithm_identifier(oid_sha256);
+	case digest_algorithm::sha384:
+		return encode_algorithm_identifier(oid_sha384);
+	case digest_algorithm::sha512:
+		return encode_algorithm_identifier(oid_sha512);
+	default:
+		throw pe_error(authenticode_signer_errc::unsupported_digest_algorithm);
+	}
+}
+
+std::vector<std::byte> encode_attribute(std::span<const std::uint32_t> oid,
+	span_range_type value)
+{
+	return der::encode(der::tag::sequence, {
+		der::encode_oid(oid), der::encode(der::tag::set, { value }) });
+}
+
+std::vector<std::byte> encode_bmp_string(std::byte tag, const std::u16string& str)
+{
+	std::vector<std::byte> contents;
+	contents.reserve(str.size() * 2u);
+	for (auto c : str)
+	{
+		contents.push_back(static_cast<std::byte>(c >> 8u));
+		contents.push_back(static_cast<std::byte>(c & 0xffu));
+	}
+	return der::encode(tag, { contents });
+}
+
+void append_digits(std::string& result, unsigned value, std::size_t count)
+{
+	result.resize(result.size() + count);
+	for (auto it = result.rbegin(); count; --count, ++it, value /= 10u)
+		*it = static_cast<char>('0' + value % 10u);
+}
+
+std::vector<std::byte> encode_time(std::chrono::sys_seconds time)
+{
+	const auto days = std::chrono::floor<std::chrono::days>(time);
+	const std::chrono::year_month_day date(days);
+	const std::chrono::hh_mm_ss hms(time - days);
+	const auto year = static_cast<int>(date.year());
+	if (year < 0 || year > 9999)
+		throw pe_error(authenticode_signer_errc::unable_to_sign);
+
+	//UTCTime is used for dates before 2050, as required by RFC 5280
+	const auto use_utc_time = year >= 1950 && year < 2050;
+	std::string str;
+	append_digits(str, static_cast<unsigned>(use_utc_time ? year % 100 : year),
+		use_utc_time ? 2u : 4u);
+	append_digits(str, static_cast<unsigned>(date.month()), 2u);
+	append_digits(str, static_cast<unsigned>(date.day()), 2u);
+	append_digits(str, static_cast<unsigned>(hms.hours().count()), 2u);
+	append_digits(str, static_cast<unsigned>(hms.minutes().count()), 2u);
+	append_digits(str, static_cast<unsigned>(hms.seconds().count()), 2u);
+	str.push_back('Z');
+	return der::encode(use_utc_time ? der::tag::utc_time : der::tag::generalized_time,
+		{ span_range_type(reinterpret_cast<const std::byte*>(str.data()), str.size()) });
+}
+
+std::span<const std::uint32_t> get_page_hashes_oid(digest_algorithm algorithm)
+{
+	switch (algorithm)
+	{
+	case digest_algorithm::sha1:
+		return oid_spc_page_hash_v1;
+	case digest_algorithm::sha256:
+		return oid_spc_page_hash_v2;
+	default:
+		throw pe_error(authenticode_signer_errc::unsupported_page_hash_algorithm);
+	}
+}
+
+std::vector<std::byte> encode_spc_link(
+	const std::optional<span_range_type>& page_hashes,
+	digest_algorithm algorithm)
+{
+	if (!page_hashes)
+	{
+		//SpcLink file [2] EXPLICIT SpcString unicode [0] IMPLICIT BMPString,
+		//which is always written by signing tools
+		return der::encode(context_2, {
+			encode_bmp_string(context_0_primitive, u"<<<Obsolete>>>") });
+	}
+
+	const auto page_hashes_attribute = der::encode(der::tag::set, {
+		der::encode(der::tag::sequence, {
+			der::encode_oid(get_page_hashes_oid(algorithm)),
+			der::encode(der::tag::set, {
+				der::encode(der::tag::octet_string, { *page_hashes }) })
+		})
+	});
+
+	//SpcLink moniker [1] IMPLICIT SpcSerializedObject
+	return der::encode(context_1, {
+		der::encode(der::tag::octet_string, { page_hashes_class_id }),
+		der::encode(der::tag::octet_string, { page_hashes_attribute })
+	});
+}
+
+std::vector<std::byte> encode_indirect_data_content(span_range_type image_hash,
+	const std::optional<span_range_type>& page_hashes, digest_algorithm algorithm)
+{
+	static constexpr std::array empty_bit_string{
+		der::tag::bit_string, std::byte{ 1u }, std::byte{} };
+
+	const auto pe_image_data = der::encode(der::tag::sequence, {
+		empty_bit_string,
+		der::encode(context_0, { encode_spc_link(page_hashes, algorithm) })
+	});
+
+	return der::encode(der::tag::sequence, {
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_spc_pe_image_data), pe_image_data }),
+		der::encode(der::tag::sequence, {
+			encode_digest_algorithm(algorithm),
+			der::encode(der::tag::octet_string, { image_hash })
+		})
+	});
+}
+
+std::vector<std::byte> encode_authenticated_attributes(
+	span_range_type indirect_data_content, const authenticode_signing_options& options)
+{
+	der::element content;
+	if (!der::read_element(indirect_data_content, content))
+		throw pe_error(authenticode_signer_errc::unable_to_sign);
+
+	const auto message_digest = calculate_hash(options.digest_alg,
+		std::array<span_range_type, 1u>{ content.value });
+
+	std::vector<std::byte> opus_info_contents;
+	if (options.program_name)
+	{
+		const auto program_name = der::encode(context_0, {
+			encode_bmp_string(context_0_primitive, *options.program_name) });
+		opus_info_contents.insert(opus_info_contents.end(),
+			program_name.begin(), program_name.end());
+	}
+	if (options.more_info_url)
+	{
+		const auto more_info = der::encode(context_1, {
+			der::encode(context_0_primitive, { span_range_type(
+				reinterpret_cast<const std::byte*>(options.more_info_url->data()),
+				options.more_info_url->size()) }) });
+		opus_info_contents.insert(opus_info_contents.end(),
+			more_info.begin(), more_info.end());
+	}
+
+	std::vector<std::vector<std::byte>> attributes;
+	attributes.emplace_back(encode_attribute(oid_content_type,
+		der::encode_oid(oid_spc_indirect_data)));
+	attributes.emplace_back(encode_attribute(oid_spc_statement_type,
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_spc_individual_sp_key_purpose) })));
+	attributes.emplace_back(encode_attribute(oid_spc_sp_opus_info,
+		der::encode(der::tag::sequence, { opus_info_contents })));
+	if (options.signing_time)
+	{
+		attributes.emplace_back(encode_attribute(oid_signing_time,
+			encode_time(*options.signing_time)));
+	}
+	attributes.emplace_back(encode_attribute(oid_message_digest,
+		der::encode(der::tag::octet_string, { message_digest })));
+	return der::encode_set_of(std::move(attributes));
+}
+
+CryptoPP::RSA::PrivateKey load_private_key(span_range_type private_key)
+{
+	CryptoPP::RSA::PrivateKey result;
+	try
+	{
+		CryptoPP::ByteQueue queue;
+		queue.Put(reinterpret_cast<const CryptoPP::byte*>(private_key.data()),
+			private_key.size());
+		queue.MessageEnd();
+		try
+		{
+			result.BERDecode(queue);
+		}
+		catch (const CryptoPP::Exception&)
+		{
+			queue.Clear();
+			queue.Put(reinterpret_cast<const CryptoPP::byte*>(private_key.data()),
+				private_key.size());
+			queue.MessageEnd();
+			result.BERDecodePrivateKey(queue, false, queue.MaxRetrievable());
+		}
+	}
+	catch (const CryptoPP::Exception&)
+	{
+		std::throw_with_nested(pe_error(authenticode_signer_errc::invalid_private_key));
+	}
+	return result;
+}
+
+template<typename Hash>
+std::vector<std::byte> sign_rsa_pkcs1v15(const CryptoPP::RSA::PrivateKey& private_key,
+	span_range_type message)
+{
+	CryptoPP::AutoSeededRandomPool rng;
+	typename CryptoPP::RSASS<CryptoPP::PKCS1v15, Hash>::Signer signer(private_key);
+	std::vector<std::byte> result(signer.MaxSignatureLength());
+	result.resize(signer.SignMessage(rng,
+		reinterpret_cast<const CryptoPP::byte*>(message.data()), message.size(),
+		reinterpret_cast<CryptoPP::byte*>(result.data())));
+	return result;
+}
+
+std::vector<std::byte> sign(span_range_type private_key, digest_algorithm algorithm,
+	span_range_type message)
+{
+	const auto key = load_private_key(private_key);
+	try
+	{
+		switch (algorithm)
+		{
+		case digest_algorithm::sha1:
+			return sign_rsa_pkcs1v15<CryptoPP::SHA1>(key, message);
+		case digest_algorithm::sha256:
+			return sign_rsa_pkcs1v15<CryptoPP::SHA256>(key, message);
+		case digest_algorithm::sha384:
+			return sign_rsa_pkcs1v15<CryptoPP::SHA384>(key, message);
+		case digest_algorithm::sha512:
+			return sign_rsa_pkcs1v15<CryptoPP::SHA512>(key, message);
+		default:
+			throw pe_error(authenticode_signer_errc::unsupported_digest_algorithm);
+		}
+	}
+	catch (const CryptoPP::Exception&)
+	{
+		std::throw_with_nested(pe_error(authenticode_signer_errc::unable_to_sign));
+	}
+}
+
+std::size_t get_overlay_offset(const image::image& instance)
+{
+	const auto& optional_hdr = instance.get_optional_header();
+	return static_cast<std::size_t>((std::max<std::uint64_t>)(
+		instance.get_section_table().get_raw_data_end_offset(
+			optional_hdr.get_raw_section_alignment()),
+		optional_hdr.get_raw_size_of_headers()));
+}
+
+//Returns the overlay size without the security directory
+std::size_t get_unsigned_overlay_size(const image::image& instance,
+	std::size_t overlay_offset, std::size_t overlay_size)
+{
+	const auto& directories = instance.get_data_directories();
+	if (!directories.has_directory(core::data_directories::directory_type::security))
+		throw pe_error(authenticode_signer_errc::invalid_security_directory);
+
+	if (!directories.has_security())
+		return overlay_size;
+
+	const auto& security_dir_info = directories.get_directory(
+		core::data_directories::directory_type::security);
+	const std::size_t security_dir_offset = security_dir_info->virtual_address;
+	if (security_dir_offset < overlay_offset
+		|| security_dir_offset - overlay_offset + security_dir_info->size != overlay_size)
+	{
+		throw pe_error(authenticode_signer_errc::invalid_security_directory);
+	}
+
+	return security_dir_offset - overlay_offset;
+}
+
+std::uint32_t get_security_directory_entry_offset(const image::image& instance)
+{
+	utilities::safe_uint offset = instance.get_dos_header().get_descriptor()->e_lfanew;
+	try
+	{
+		offset += core::image_signature::descriptor_type::packed_size;
+		offset += core::file_header::descriptor_type::packed_size;
+		offset += instance.get_optional_header().get_size_of_structure();
+		offset += core::data_directories::directory_packed_size
+			* static_cast<std::uint32_t>(core::data_directories::directory_type::security);
+	}
+	catch (const std::system_error&)
+	{
+		throw pe_error(authenticode_signer_errc::invalid_security_directory);
+	}
+	return offset.value();
+}
+
+void update_full_headers(image::image& instance, std::size_t offset,
+	std::uint32_t value)
+{
+	auto& headers = instance.get_full_headers_buffer();
+	if (headers.physical_size() < offset + sizeof(value))
+		return;
+
+	detail::packed_serialization<boost::endian::order::little>::serialize(value,
+		headers.copied_data().data() + offset);
+}
+
+std::vector<std::byte> get_existing_signature(const image::image& instance)
+{
+	auto directory = load(instance);
+	if (!directory || directory->get_entries().empty())
+		return {};
+
+	if (directory->has_errors() || directory->get_entries()[0].has_errors())
+		throw pe_error(authenticode_signer_errc::invalid_security_directory);
+
+	return std::move(directory->get_entries()[0].get_certificate().copied_data());
+}
+
+[[noreturn]] void throw_invalid_signature()
+{
+	throw pe_error(authenticode_signer_errc::invalid_signature);
+}
+
+} //namespace
+
+std::vector<std::byte> create_authenticode_signature(span_range_type image_hash,
+	const std::optional<span_range_type>& page_hashes,
+	const authenticode_signing_options& options)
+{
+	const auto digest_algorithm_id = encode_digest_algorithm(options.digest_alg);
+	der::element issuer, serial_number;
+	if (!der::read_certificate_issuer_and_serial_number(
+		options.signer_certificate, issuer, serial_number))
+	{
+		throw pe_error(authenticode_signer_errc::invalid_signer_certificate);
+	}
+
+	const auto indirect_data_content = encode_indirect_data_content(
+		image_hash, page_hashes, options.digest_alg);
+	auto authenticated_attributes = encode_authenticated_attributes(
+		indirect_data_content, options);
+	//Signature is calculated over the DER encoding of the attributes SET,
+	//but the attributes are stored with the [0] IMPLICIT tag
+	const auto encrypted_digest = sign(options.private_key,
+		options.digest_alg, authenticated_attributes);
+	authenticated_attributes[0] = context_0;
+
+	const auto signer_info = der::encode(der::tag::sequence, {
+		der::encode_unsigned_integer(1u),
+		der::encode(der::tag::sequence, { issuer.raw, serial_number.raw }),
+		digest_algorithm_id,
+		authenticated_attributes,
+		encode_algorithm_identifier(oid_rsa_encryption),
+		der::encode(der::tag::octet_string, { encrypted_digest })
+	});
+
+	std::vector<span_range_type> certificates{ options.signer_certificate };
+	certificates.insert(certificates.end(), options.additional_certificates.begin(),
+		options.additional_certificates.end());
+
+	const auto signed_data = der::encode(der::tag::sequence, {
+		der::encode_unsigned_integer(1u),
+		der::encode(der::tag::set, { digest_algorithm_id }),
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_spc_indirect_data),
+			der::encode(context_0, { indirect_data_content })
+		}),
+		der::encode(context_0, certificates),
+		der::encode(der::tag::set, { signer_info })
+	});
+
+	return der::encode(der::tag::sequence, {
+		der::encode_oid(oid_signed_data),
+		der::encode(context_0, { signed_data })
+	});
+}
+
+std::vector<std::byte> add_nested_signature(span_range_type signature,
+	span_range_type nested_signature)
+{
+	der::element content_info, signed_data_content, signed_data;
+	std::vector<der::element> content_info_fields;
+	if (!der::read_element(signature, der::tag::sequence, content_info)
+		|| !der::read_children(content_info.value, content_info_fields)
+		|| content_info_fields.size() != 2u
+		|| content_info_fields[1].tag != context_0)
+	{
+		throw_invalid_signature();
+	}
+
+	signed_data_content = content_info_fields[1];
+	std::vector<der::element> signed_data_fields, signer_infos, signer_info_fields;
+	if (!der::read_element(signed_data_content.value, der::tag::sequence, signed_data)
+		|| !der::read_children(signed_data.value, signed_data_fields)
+		|| signed_data_fields.empty()
+		|| signed_data_fields.back().tag != der::tag::set
+		|| !der::read_children(signed_data_fields.back().value, signer_infos)
+		|| signer_infos.empty()
+		|| signer_infos[0].tag != der::tag::sequence
+		|| !der::read_children(signer_infos[0].value, signer_info_fields)
+		|| signer_info_fields.empty())
+	{
+		throw_invalid_signature();
+	}
+
+	const auto nested_signature_oid = der::encode_oid(oid_spc_nested_signature);
+	std::vector<std::vector<std::byte>> attributes;
+	bool nested_signature_added = false;
+	if (signer_info_fields.back().tag == context_1)
+	{
+		std::vector<der::element> existing_attributes;
+		if (!der::read_children(signer_info_fields.back().value, existing_attributes))
+			throw_invalid_signature();
+
+		for (const auto& attribute : existing_attributes)
+		{
+			std::vector<der::element> attribute_fields;
+			if (!der::read_children(attribute.value, attribute_fields)
+				|| attribute_fields.size() != 2u
+				|| attribute_fields[1].tag != der::tag::set)
+			{
+				throw_invalid_signature();
+			}
+
+			if (nested_signature_added
+				|| !std::ranges::equal(attribute_fields[0].raw, nested_signature_oid))
+			{
+				attributes.emplace_back(attribute.raw.begin(), attribute.raw.end());
+				continue;
+			}
+
+			attributes.emplace_back(der::encode(der::tag::sequence, {
+				attribute_fields[0].raw,
+				der::encode(der::tag::set, {
+					attribute_fields[1].value, nested_signature })
+			}));
+			nested_signature_added = true;
+		}
+
+		signer_info_fields.pop_back();
+	}
+
+	if (!nested_signature_added)
+		attributes.emplace_back(encode_attribute(oid_spc_nested_signature, nested_signature));
+
+	const std::vector<span_range_type> attribute_list(attributes.begin(), attributes.end());
+	const auto unauthenticated_attributes = der::encode(context_1, attribute_list);
+
+	std::vector<span_range_type> parts;
+	for (const auto& field : signer_info_fields)
+		parts.emplace_back(field.raw);
+	parts.emplace_back(unauthenticated_attributes);
+	const auto signer_info = der::encode(der::tag::sequence, parts);
+
+	parts.clear();
+	parts.emplace_back(signer_info);
+	for (auto it = signer_infos.begin() + 1; it != signer_infos.end(); ++it)
+		parts.emplace_back(it->raw);
+	const auto signer_info_set = der::encode(der::tag::set, parts);
+
+	parts.clear();
+	for (auto it = signed_data_fields.begin(); it != signed_data_fields.end() - 1; ++it)
+		parts.emplace_back(it->raw);
+	parts.emplace_back(signer_info_set);
+	const auto new_signed_data = der::encode(der::tag::sequence, parts);
+
+	return der::encode(der::tag::sequence, {
+		content_info_fields[0].raw,
+		der::encode(context_0, { new_signed_data })
+	});
+}
+
+void write_authenticode_signature(image::image& instance,
+	span_range_type signature, bool update_checksum)
+{
+	static constexpr auto descriptor_size = detail::packed_reflection
+		::get_type_size<detail::security::win_certificate>();
+	static constexpr std::size_t alignment = sizeof(std::uint64_t);
+
+	const auto overlay_offset = get_overlay_offset(instance);
+	auto& overlay = instance.get_overlay();
+	auto& data = overlay.copied_data();
+	data.resize(get_unsigned_overlay_size(instance, overlay_offset, data.size()));
+	data.resize(utilities::math::align_up(overlay_offset + data.size(), alignment)
+		- overlay_offset);
+	overlay.data()->set_absolute_offset(overlay_offset);
+
+	const auto security_dir_offset = overlay_offset + data.size();
+	const auto certificate_length = descriptor_size + signature.size();
+	const auto security_dir_size = utilities::math::align_up(certificate_length, alignment);
+	if (security_dir_offset + security_dir_size > (std::numeric_limits<std::uint32_t>::max)())
+		throw pe_error(authenticode_signer_errc::unable_to_sign);
+
+	const detail::security::win_certificate descriptor{
+		.length = static_cast<std::uint32_t>(certificate_length),
+		.revision = detail::security::win_cert_revision_2_0,
+		.certificate_type = detail::security::win_cert_type_pkcs_signed_data
+	};
+	data.resize(security_dir_offset - overlay_offset + descriptor_size);
+	detail::packed_serialization<boost::endian::order::little>::serialize(descriptor,
+		data.data() + data.size() - descriptor_size);
+	data.insert(data.end(), signature.begin(), signature.end());
+	data.resize(security_dir_offset - overlay_offset + security_dir_size);
+
+	auto& security_dir_info = instance.get_data_directories().get_directory(
+		core::data_directories::directory_type::security);
+	security_dir_info->virtual_address = static_cast<std::uint32_t>(security_dir_offset);
+	security_dir_info->size = static_cast<std::uint32_t>(security_dir_size);
+
+	const auto cert_table_entry_offset = get_security_directory_entry_offset(instance);
+	update_full_headers(instance, cert_table_entry_offset,
+		security_dir_info->virtual_address);
+	update_full_headers(instance, cert_table_entry_offset + sizeof(std::uint32_t),
+		security_dir_info->size);
+
+	if (!update_checksum)
+		return;
+
+	const auto checksum = image::calculate_checksum(instance);
+	instance.get_optional_header().set_raw_checksum(checksum);
+	update_full_headers(instance, image::get_checksum_offset(instance), checksum);
+}
+
+void sign_image(image::image& instance, const authenticode_signing_options& options)
+{
+	std::optional<page_hash_options> page_hash_opts;
+	if (options.add_page_hashes)
+	{
+		//Fail before existing signatures are stripped
+		(void)get_page_hashes_oid(options.digest_alg);
+		page_hash_opts.emplace().algorithm = options.digest_alg;
+	}
+
+	std::vector<std::byte> existing_signature;
+	if (options.nested)
+		existing_signature = get_existing_signature(instance);
+
+	//Write an empty certificate first to strip existing signatures
+	//and to align the security directory
+	if (existing_signature.empty())
+		write_authenticode_signature(instance, {}, false);
+
+	const auto hash = calculate_hash(options.digest_alg, instance,
+		page_hash_opts ? &*page_hash_opts : nullptr);
+	if (page_hash_opts && hash.page_hash_errc)
+		throw pe_error(hash.page_hash_errc);
+
+	std::optional<span_range_type> page_hashes;
+	if (page_hash_opts)
+		page_hashes = hash.page_hashes;
+
+	auto signature = create_authenticode_signature(hash.image_hash,
+		page_hashes, options);
+	if (!existing_signature.empty())
+		signature = add_nested_signature(existing_signature, signature);
+
+	write_authenticode_signature(instance, signature, options.update_checksum);
+}
+
+} //namespace pe_bliss::security
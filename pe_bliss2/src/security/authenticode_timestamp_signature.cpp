@@ -52,16 +52,36 @@ template<typename TargetRangeType, typename RangeType>
 std::optional<authenticode_timestamp_signature<TargetRangeType>> load_timestamp_signature(
 	const pkcs7::attribute_map<RangeType>& unauthenticated_attrs)
 {
-	std::optional<authenticode_timestamp_signature<TargetRangeType>> result;
-
-	auto raw_signature = unauthenticated_attrs.get_attribute(
+	authenticode_unauthenticated_attributes attributes;
+	attributes.rfc3161_timestamp = unauthenticated_attrs.get_attribute(
 		asn1::crypto::pkcs9::oid_timestamp_token);
-	if (!raw_signature)
+	if (!attributes.rfc3161_timestamp)
 	{
-		raw_signature = unauthenticated_attrs.get_attribute(
+		attributes.authenticode_timestamp = unauthenticated_attrs.get_attribute(
 			asn1::crypto::pkcs7::authenticode::oid_spc_time_stamp_token);
+		if (!attributes.authenticode_timestamp)
+		{
+			attributes.countersignature = unauthenticated_attrs.get_attribute(
+				asn1::crypto::pkcs9::oid_counter_signature);
+		}
 	}
 
+	return load_timestamp_signature<TargetRangeType>(attributes);
+}
+
+template<typename TargetRangeType>
+std::optional<authenticode_timestamp_signature<TargetRangeType>> load_timestamp_signature(
+	const authenticode_unauthenticated_attributes& unauthenticated_attrs)
+{
+	if (unauthenticated_attrs.timestamp_errc)
+		throw pe_error(unauthenticated_attrs.timestamp_errc);
+
+	std::optional<authenticode_timestamp_signature<TargetRangeType>> result;
+
+	auto raw_signature = unauthenticated_attrs.rfc3161_timestamp;
+	if (!raw_signature)
+		raw_signature = unauthenticated_attrs.authenticode_timestamp;
+
 	if (raw_signature)
 	{
 		using cms_info_spec_ms_bug_workaround_type = asn1::spec::crypto::pkcs7::cms
@@ -93,17 +113,14 @@ std::optional<authenticode_timestamp_signature<TargetRangeType>> load_timestamp_
 		return result;
 	}
 
-	raw_signature = unauthenticated_attrs.get_attribute(
-			asn1::crypto::pkcs9::oid_counter_signature);
-
-	if (raw_signature)
+	if (unauthenticated_attrs.countersignature)
 	{
 		auto& underlying_variant = result.emplace().get_underlying_type();
 
 		decode_asn1_check_tail<
 			timestamp_signature_loader_errc::invalid_timestamp_signature_asn1_der,
 			asn1::spec::crypto::pkcs7::signer_info>(
-				*raw_signature, underlying_variant
+				*unauthenticated_attrs.countersignature, underlying_variant
 				.template emplace<typename authenticode_timestamp_signature<TargetRangeType>
 				::signer_info_type>().get_underlying());
 	}
@@ -125,5 +142,11 @@ template std::optional<authenticode_timestamp_signature<span_range_type>> load_t
 template std::optional<authenticode_timestamp_signature<vector_range_type>> load_timestamp_signature<
 	vector_range_type>(
 		const pkcs7::attribute_map<span_range_type>& unauthenticated_attrs);
+template std::optional<authenticode_timestamp_signature<span_range_type>> load_timestamp_signature<
+	span_range_type>(
+		const authenticode_unauthenticated_attributes& unauthenticated_attrs);
+template std::optional<authenticode_timestamp_signature<vector_range_type>> load_timestamp_signature<
+	vector_range_type>(
+		const authenticode_unauthenticated_attributes& unauthenticated_attrs);
 
 } //namespace pe_bliss::security
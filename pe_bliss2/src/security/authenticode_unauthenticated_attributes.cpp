@@ -0,0 +1,91 @@
+#include "pe_bliss2/security/authenticode_unauthenticated_attributes.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#include "simple_asn1/crypto/pkcs7/authenticode/oids.h"
+#include "simple_asn1/crypto/pkcs9/oids.h"
+
+namespace pe_bliss::security
+{
+
+namespace
+{
+template<typename RangeType>
+void get_single_value(const std::vector<RangeType>& values,
+	std::optional<span_range_type>& value, std::error_code& errc)
+{
+	if (values.empty())
+	{
+		if (!errc)
+			errc = pkcs7::attribute_map_errc::absent_attribute_value;
+		return;
+	}
+
+	if (values.size() != 1u)
+	{
+		if (!errc)
+			errc = pkcs7::attribute_map_errc::multiple_attribute_values;
+		return;
+	}
+
+	value.emplace(values[0]);
+}
+} //namespace
+
+template<typename RangeType>
+authenticode_unauthenticated_attributes decode_unauthenticated_attributes(
+	const pkcs7::attribute_map<RangeType>& unauthenticated_attributes)
+{
+	authenticode_unauthenticated_attributes result;
+	for (const auto& [oid, values_ref] : unauthenticated_attributes.get_map())
+	{
+		const auto& values = values_ref.get();
+		if (std::ranges::equal(oid,
+			asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute))
+		{
+			if (values.empty())
+			{
+				result.nested_signatures_errc
+					= pkcs7::attribute_map_errc::absent_attribute_value;
+				continue;
+			}
+
+			result.nested_signatures.assign(values.begin(), values.end());
+			continue;
+		}
+
+		std::optional<span_range_type>* single_value = nullptr;
+		if (std::ranges::equal(oid, asn1::crypto::pkcs9::oid_timestamp_token))
+		{
+			single_value = &result.rfc3161_timestamp;
+		}
+		else if (std::ranges::equal(oid,
+			asn1::crypto::pkcs7::authenticode::oid_spc_time_stamp_token))
+		{
+			single_value = &result.authenticode_timestamp;
+		}
+		else if (std::ranges::equal(oid, asn1::crypto::pkcs9::oid_counter_signature))
+		{
+			single_value = &result.countersignature;
+		}
+		else
+		{
+			continue;
+		}
+
+		get_single_value(values, *single_value, result.timestamp_errc);
+	}
+
+	return result;
+}
+
+template authenticode_unauthenticated_attributes decode_unauthenticated_attributes<
+	span_range_type>(const pkcs7::attribute_map<span_range_type>& unauthenticated_attributes);
+template authenticode_unauthenticated_attributes decode_unauthenticated_attributes<
+	vector_range_type>(const pkcs7::attribute_map<vector_range_type>& unauthenticated_attributes);
+
+} //namespace pe_bliss::security
@@ -0,0 +1,419 @@
+#include "pe_bliss2/security/catalog.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "buffers/ref_buffer.h"
+
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/asn1_decode_helper.h"
+#include "pe_bliss2/security/der_helpers.h"
+#include "pe_bliss2/security/pkcs7/attribute_map.h"
+
+#include "simple_asn1/crypto/pkcs7/spec.h"
+#include "simple_asn1/der_decode.h"
+
+namespace
+{
+
+struct catalog_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "catalog";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::catalog_errc;
+		switch (static_cast<pe_bliss::security::catalog_errc>(ev))
+		{
+		case invalid_catalog_format:
+			return "Invalid catalog format";
+		case unsupported_content_type:
+			return "Unsupported catalog content type, CertificateTrustList is expected";
+		case absent_signers:
+			return "Catalog has no signers";
+		case invalid_signer_info:
+			return "Invalid catalog signer info";
+		case invalid_member:
+			return "Invalid catalog member";
+		case absent_member_digest:
+			return "Catalog member does not have the SpcIndirectDataContent digest";
+		case absent_content_type:
+			return "Absent content type authenticated attribute";
+		case invalid_content_type:
+			return "Invalid content type authenticated attribute";
+		case invalid_authenticated_attributes:
+			return "Invalid authenticated attributes";
+		case invalid_message_digest:
+			return "Unable to calculate or verify the message digest";
+		default:
+			return {};
+		}
+	}
+};
+
+const catalog_error_category catalog_error_category_instance;
+
+template<std::size_t N>
+using oid_type = std::array<std::uint32_t, N>;
+
+constexpr oid_type<7u> oid_signed_data{ 1, 2, 840, 113549, 1, 7, 2 };
+constexpr oid_type<9u> oid_ctl{ 1, 3, 6, 1, 4, 1, 311, 10, 1 };
+constexpr oid_type<10u> oid_spc_indirect_data{ 1, 3, 6, 1, 4, 1, 311, 2, 1, 4 };
+
+constexpr std::byte context_0 = pe_bliss::security::der::tag::context_specific(0u, true);
+
+[[noreturn]] void throw_invalid_catalog_format()
+{
+	throw pe_bliss::pe_error(pe_bliss::security::catalog_errc::invalid_catalog_format);
+}
+
+bool read_oid(pe_bliss::security::span_range_type& data, std::vector<std::uint32_t>& oid)
+{
+	pe_bliss::security::der::element element;
+	return pe_bliss::security::der::read_element(data,
+		pe_bliss::security::der::tag::object_identifier, element)
+		&& pe_bliss::security::der::decode_oid(element.value, oid);
+}
+
+} //namespace
+
+namespace pe_bliss::security
+{
+
+std::error_code make_error_code(catalog_errc e) noexcept
+{
+	return { static_cast<int>(e), catalog_error_category_instance };
+}
+
+namespace
+{
+
+//ContentInfo ::= SEQUENCE { contentType, content [0] EXPLICIT ANY }
+//Returns the content, which is the only [0] element contents.
+bool read_content_info(span_range_type data, std::vector<std::uint32_t>& content_type,
+	span_range_type& content)
+{
+	der::element content_info, explicit_content;
+	if (!der::read_element(data, der::tag::sequence, content_info)
+		|| !read_oid(content_info.value, content_type)
+		|| !der::read_element(content_info.value, context_0, explicit_content)
+		|| !content_info.value.empty())
+	{
+		return false;
+	}
+
+	content = explicit_content.value;
+	return true;
+}
+
+//SpcIndirectDataContent ::= SEQUENCE {
+//    data SpcAttributeTypeAndOptionalValue,
+//    messageDigest DigestInfo }
+bool read_indirect_data_digest(span_range_type data, catalog_member& member)
+{
+	der::element indirect_data, type_and_value, digest_info,
+		algorithm_id, digest;
+	std::vector<std::uint32_t> algorithm;
+	if (!der::read_element(data, der::tag::sequence, indirect_data)
+		|| !der::read_element(indirect_data.value, der::tag::sequence, type_and_value)
+		|| !der::read_element(indirect_data.value, der::tag::sequence, digest_info)
+		|| !der::read_element(digest_info.value, der::tag::sequence, algorithm_id)
+		|| !read_oid(algorithm_id.value, algorithm)
+		|| !der::read_element(digest_info.value, der::tag::octet_string, digest))
+	{
+		return false;
+	}
+
+	member.digest_alg = get_digest_algorithm(algorithm);
+	member.digest = digest.value;
+	return true;
+}
+
+//TrustedSubject ::= SEQUENCE {
+//    subjectIdentifier OCTET STRING,
+//    subjectAttributes SET OF Attribute OPTIONAL }
+bool read_member(span_range_type data, catalog_member& member,
+	std::vector<std::uint32_t>& oid, error_list* warnings)
+{
+	der::element subject, identifier, subject_attributes;
+	if (!der::read_element(data, der::tag::sequence, subject)
+		|| !der::read_element(subject.value, der::tag::octet_string, identifier))
+	{
+		return false;
+	}
+
+	member.tag = identifier.value;
+	if (!subject.value.empty()
+		&& !der::read_element(subject.value, der::tag::set, subject_attributes))
+	{
+		return false;
+	}
+
+	auto attributes = subject_attributes.value;
+	bool has_digest = false;
+	while (!attributes.empty())
+	{
+		der::element attribute, values;
+		if (!der::read_element(attributes, der::tag::sequence, attribute)
+			|| !read_oid(attribute.value, oid)
+			|| !der::read_element(attribute.value, der::tag::set, values))
+		{
+			return false;
+		}
+
+		if (has_digest || !std::ranges::equal(oid, oid_spc_indirect_data))
+			continue;
+
+		if (!read_indirect_data_digest(values.value, member))
+			return false;
+
+		has_digest = true;
+	}
+
+	if (!has_digest && warnings)
+		warnings->add_error(catalog_errc::absent_member_digest);
+
+	return true;
+}
+
+//CertificateTrustList ::= SEQUENCE {
+//    subjectUsage SEQUENCE OF OBJECT IDENTIFIER,
+//    listIdentifier OCTET STRING OPTIONAL,
+//    sequenceNumber INTEGER OPTIONAL,
+//    ctlThisUpdate ChoiceOfTime,
+//    ctlNextUpdate ChoiceOfTime OPTIONAL,
+//    subjectAlgorithm AlgorithmIdentifier,
+//    trustedSubjects SEQUENCE OF TrustedSubject OPTIONAL,
+//    ctlExtensions [0] EXPLICIT Extensions OPTIONAL }
+void read_certificate_trust_list(span_range_type data,
+	catalog& result, error_list* warnings)
+{
+	der::element ctl, field;
+	if (!der::read_element(data, der::tag::sequence, ctl))
+		throw_invalid_catalog_format();
+
+	result.set_raw_signed_content(ctl.value);
+
+	auto fields = ctl.value;
+	if (!der::read_element(fields, der::tag::sequence, field))
+		throw_invalid_catalog_format();
+
+	//Skip optional fields and times up to subjectAlgorithm
+	do
+	{
+		if (!der::read_element(fields, field))
+			throw_invalid_catalog_format();
+	}
+	while (field.tag != der::tag::sequence);
+
+	if (fields.empty() || fields[0] != der::tag::sequence)
+		return;
+
+	der::element trusted_subjects;
+	if (!der::read_element(fields, trusted_subjects))
+		throw_invalid_catalog_format();
+
+	auto subjects = trusted_subjects.value;
+	std::vector<std::uint32_t> oid;
+	while (!subjects.empty())
+	{
+		der::element subject;
+		if (!der::read_element(subjects, subject))
+			throw_invalid_catalog_format();
+
+		catalog_member member;
+		if (!read_member(subject.raw, member, oid, warnings))
+		{
+			if (warnings)
+				warnings->add_error(catalog_errc::invalid_member);
+			continue;
+		}
+
+		result.get_members().emplace_back(member);
+	}
+}
+
+//SignedData ::= SEQUENCE {
+//    version INTEGER,
+//    digestAlgorithms SET OF AlgorithmIdentifier,
+//    contentInfo ContentInfo,
+//    certificates [0] IMPLICIT CertificateSet OPTIONAL,
+//    crls [1] IMPLICIT CertificateRevocationLists OPTIONAL,
+//    signerInfos SET OF SignerInfo }
+void read_signed_data(span_range_type data, catalog& result, error_list* warnings)
+{
+	der::element signed_data, version, digest_algorithms, content_info, field;
+	if (!der::read_element(data, der::tag::sequence, signed_data)
+		|| !der::read_element(signed_data.value, der::tag::integer, version)
+		|| !der::read_element(signed_data.value, der::tag::set, digest_algorithms)
+		|| !der::read_element(signed_data.value, der::tag::sequence, content_info))
+	{
+		throw_invalid_catalog_format();
+	}
+
+	std::vector<std::uint32_t> content_type;
+	span_range_type content;
+	if (!read_content_info(content_info.raw, content_type, content))
+		throw_invalid_catalog_format();
+	if (!std::ranges::equal(content_type, oid_ctl))
+		throw pe_error(catalog_errc::unsupported_content_type);
+
+	read_certificate_trust_list(content, result, warnings);
+
+	std::vector<der::element> certificates;
+	der::element signer_infos;
+	auto fields = signed_data.value;
+	while (!fields.empty())
+	{
+		if (!der::read_element(fields, field))
+			throw_invalid_catalog_format();
+
+		if (field.tag == context_0)
+		{
+			if (!der::read_children(field.value, certificates))
+				throw_invalid_catalog_format();
+		}
+		else if (field.tag == der::tag::set)
+		{
+			signer_infos = field;
+		}
+	}
+
+	auto& cert_store = result.get_certificate_store();
+	cert_store.reserve(certificates.size());
+	for (const auto& certificate : certificates)
+	{
+		//Other certificate choices (e.g., attribute certificates) are skipped
+		if (certificate.tag != der::tag::sequence)
+			continue;
+
+		try
+		{
+			if (!cert_store.add_certificate(certificate.raw) && warnings)
+			{
+				warnings->add_error(
+					x509::x509_lazy_certificate_store_errc::duplicate_certificate);
+			}
+		}
+		catch (const pe_error& e)
+		{
+			if (!warnings)
+				throw;
+			warnings->add_error(e.code());
+		}
+	}
+
+	if (cert_store.empty() && warnings)
+		warnings->add_error(x509::x509_lazy_certificate_store_errc::absent_certificates);
+
+	std::vector<der::element> signers;
+	if (!der::read_children(signer_infos.value, signers))
+		throw_invalid_catalog_format();
+	if (signers.empty())
+		throw pe_error(catalog_errc::absent_signers);
+
+	result.get_signers().reserve(signers.size());
+	for (const auto& signer : signers)
+	{
+		decode_asn1_check_tail<catalog_errc::invalid_signer_info,
+			asn1::spec::crypto::pkcs7::signer_info>(signer.raw,
+				result.get_signers().emplace_back().get_underlying());
+	}
+}
+
+} //namespace
+
+catalog load_catalog(const buffers::input_buffer_ptr& buffer, error_list* warnings)
+{
+	catalog result;
+
+	buffers::ref_buffer data;
+	data.deserialize_contiguous(buffer);
+	result.get_data() = data.data();
+
+	const auto size = result.get_data()->physical_size();
+	const auto* raw_data = size ? result.get_data()->get_raw_data(0u, size) : nullptr;
+	if (!raw_data)
+		throw_invalid_catalog_format();
+
+	std::vector<std::uint32_t> content_type;
+	span_range_type content;
+	if (!read_content_info(span_range_type(raw_data, size), content_type, content))
+		throw_invalid_catalog_format();
+	if (!std::ranges::equal(content_type, oid_signed_data))
+		throw pe_error(catalog_errc::unsupported_content_type);
+
+	read_signed_data(content, result, warnings);
+	return result;
+}
+
+catalog_check_status verify_catalog(const catalog& instance,
+	signature_verification_cache* cache)
+{
+	catalog_check_status result;
+	if (instance.get_signers().empty())
+	{
+		result.format_errors.add_error(catalog_errc::absent_signers);
+		return result;
+	}
+
+	const pkcs7::signer_info_ref_pkcs7 signer(instance.get_signers().front());
+	digest_algorithm digest_alg{};
+	digest_encryption_algorithm digest_encryption_alg{};
+	if (!get_hash_and_signature_algorithms(signer, digest_alg,
+		digest_encryption_alg, result.format_errors))
+	{
+		return result;
+	}
+
+	pkcs7::attribute_map<span_range_type> authenticated_attributes;
+	try
+	{
+		authenticated_attributes = signer.get_authenticated_attributes();
+	}
+	catch (const pe_error&)
+	{
+		result.format_errors.add_error(catalog_errc::invalid_authenticated_attributes);
+		return result;
+	}
+
+	if (auto content_type = authenticated_attributes.get_content_type(); !content_type)
+	{
+		result.format_errors.add_error(catalog_errc::absent_content_type);
+	}
+	else
+	{
+		std::vector<std::uint32_t> oid;
+		if (!read_oid(*content_type, oid) || !content_type->empty()
+			|| !std::ranges::equal(oid, oid_ctl))
+		{
+			result.format_errors.add_error(catalog_errc::invalid_content_type);
+		}
+	}
+
+	try
+	{
+		const std::array raw_signed_content{ instance.get_raw_signed_content() };
+		result.message_digest_valid = pkcs7::verify_message_digest_attribute(
+			signer.calculate_message_digest(raw_signed_content),
+			authenticated_attributes);
+	}
+	catch (const std::exception&)
+	{
+		result.format_errors.add_error(catalog_errc::invalid_message_digest);
+		return result;
+	}
+
+	result.signature_result = verify_signature(signer,
+		instance.get_certificate_store(), cache);
+	return result;
+}
+
+} //namespace pe_bliss::security
@@ -0,0 +1,109 @@
+#include "pe_bliss2/security/catalog_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "pe_bliss2/image/image.h"
+
+#include "utilities/range_helpers.h"
+
+namespace pe_bliss::security
+{
+
+bool catalog_store::member_key_equal::operator()(
+	const member_key& l, const member_key& r) const noexcept
+{
+	return l.algorithm == r.algorithm
+		&& std::ranges::equal(l.digest, r.digest);
+}
+
+std::size_t catalog_store::member_key_hash::operator()(
+	const member_key& key) const noexcept
+{
+	//Digests are uniformly distributed, so their leading bytes
+	//are used as the hash value
+	if (key.digest.size() >= sizeof(std::size_t))
+	{
+		std::size_t hash;
+		std::memcpy(&hash, key.digest.data(), sizeof(hash));
+		return hash;
+	}
+
+	return utilities::range_hash{}(key.digest);
+}
+
+std::size_t catalog_store::add_catalog(catalog&& instance)
+{
+	const auto catalog_index = catalogs_.size();
+	const auto& members = catalogs_.emplace_back(std::move(instance)).get_members();
+
+	std::size_t added_count = 0;
+	members_.reserve(members_.size() + members.size());
+	for (std::size_t i = 0; i != members.size(); ++i)
+	{
+		const auto& member = members[i];
+		if (member.digest.empty() || member.digest_alg == digest_algorithm::unknown)
+			continue;
+
+		if (!members_.try_emplace(member_key{ member.digest_alg, member.digest },
+			member_ref{ catalog_index, i }).second)
+		{
+			continue;
+		}
+
+		++added_count;
+		if (std::ranges::find(digest_algorithms_, member.digest_alg)
+			== digest_algorithms_.end())
+		{
+			digest_algorithms_.emplace_back(member.digest_alg);
+		}
+	}
+
+	return added_count;
+}
+
+catalog_lookup_result catalog_store::find_member(digest_algorithm algorithm,
+	span_range_type digest) const
+{
+	const auto it = members_.find(member_key{ algorithm, digest });
+	if (it == members_.end())
+		return {};
+
+	const auto& owner = catalogs_[it->second.catalog_index];
+	return {
+		.owner = &owner,
+		.member = &owner.get_members()[it->second.member_index]
+	};
+}
+
+catalog_lookup_result find_image_in_catalogs(const catalog_store& store,
+	const image::image& instance)
+{
+	for (auto algorithm : store.get_digest_algorithms())
+	{
+		const auto hash = calculate_hash(algorithm, instance);
+		if (auto result = store.find_member(algorithm, hash.image_hash); result)
+			return result;
+	}
+
+	return {};
+}
+
+catalog_lookup_result find_image_in_catalogs(const catalog_store& store,
+	const image_hash_stream_result& hashes)
+{
+	for (auto algorithm : store.get_digest_algorithms())
+	{
+		const auto* digest = hashes.find_digest(algorithm);
+		if (!digest)
+			continue;
+
+		if (auto result = store.find_member(algorithm, digest->hash.image_hash); result)
+			return result;
+	}
+
+	return {};
+}
+
+} //namespace pe_bliss::security
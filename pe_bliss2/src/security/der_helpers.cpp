@@ -0,0 +1,223 @@
+#include "pe_bliss2/security/der_helpers.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace pe_bliss::security::der
+{
+
+bool read_element(span_range_type& data, element& result) noexcept
+{
+	if (data.size() < 2u)
+		return false;
+
+	std::size_t length = std::to_integer<std::size_t>(data[1]);
+	std::size_t header_length = 2u;
+	if (length & 0x80u)
+	{
+		const auto length_bytes = length & 0x7fu;
+		if (!length_bytes || length_bytes > sizeof(std::uint32_t)
+			|| data.size() < header_length + length_bytes)
+		{
+			return false;
+		}
+
+		length = 0u;
+		for (std::size_t i = 0; i != length_bytes; ++i)
+			length = (length << 8u) | std::to_integer<std::size_t>(data[header_length + i]);
+		header_length += length_bytes;
+	}
+
+	if (data.size() - header_length < length)
+		return false;
+
+	result.tag = data[0];
+	result.value = data.subspan(header_length, length);
+	result.raw = data.subspan(0u, header_length + length);
+	data = data.subspan(header_length + length);
+	return true;
+}
+
+bool read_element(span_range_type& data, std::byte expected_tag,
+	element& result) noexcept
+{
+	return !data.empty() && data[0] == expected_tag
+		&& read_element(data, result);
+}
+
+bool read_children(span_range_type value, std::vector<element>& result)
+{
+	while (!value.empty())
+	{
+		if (!read_element(value, result.emplace_back()))
+			return false;
+	}
+	return true;
+}
+
+bool read_certificate_issuer_and_serial_number(span_range_type certificate,
+	element& issuer, element& serial_number)
+{
+	element cert, tbs_cert;
+	if (!read_element(certificate, tag::sequence, cert)
+		|| !read_element(cert.value, tag::sequence, tbs_cert))
+	{
+		return false;
+	}
+
+	//version [0] EXPLICIT is optional
+	auto fields = tbs_cert.value;
+	if (!fields.empty() && fields[0] == tag::context_specific(0u, true)
+		&& !read_element(fields, issuer))
+	{
+		return false;
+	}
+
+	element signature;
+	return read_element(fields, tag::integer, serial_number)
+		&& read_element(fields, tag::sequence, signature)
+		&& read_element(fields, tag::sequence, issuer);
+}
+
+bool decode_oid(span_range_type value, std::vector<std::uint32_t>& result)
+{
+	result.clear();
+	std::uint64_t arc = 0u;
+	for (std::size_t i = 0; i != value.size(); ++i)
+	{
+		const auto part = std::to_integer<std::uint8_t>(value[i]);
+		//Leading 0x80 bytes are not allowed in DER
+		if (part == 0x80u && !arc)
+			return false;
+
+		arc = (arc << 7u) | (part & 0x7fu);
+		if (arc > (std::numeric_limits<std::uint32_t>::max)())
+			return false;
+
+		if (part & 0x80u)
+			continue;
+
+		if (result.empty())
+		{
+			const auto first = (std::min)(arc / 40u, std::uint64_t{ 2u });
+			result.push_back(static_cast<std::uint32_t>(first));
+			arc -= first * 40u;
+		}
+		result.push_back(static_cast<std::uint32_t>(arc));
+		arc = 0u;
+	}
+
+	return !value.empty()
+		&& !(std::to_integer<std::uint8_t>(value.back()) & 0x80u);
+}
+
+void append_header(std::vector<std::byte>& result, std::byte tag, std::size_t length)
+{
+	result.push_back(tag);
+	if (length < 0x80u)
+	{
+		result.push_back(static_cast<std::byte>(length));
+		return;
+	}
+
+	const auto length_bytes = static_cast<std::size_t>(
+		(std::bit_width(length) + 7u) / 8u);
+	result.push_back(static_cast<std::byte>(0x80u | length_bytes));
+	for (auto i = length_bytes; i; --i)
+		result.push_back(static_cast<std::byte>(length >> ((i - 1u) * 8u)));
+}
+
+namespace
+{
+template<typename Contents>
+std::vector<std::byte> encode_impl(std::byte tag, const Contents& contents)
+{
+	std::size_t length = 0;
+	for (const auto& content : contents)
+		length += content.size();
+
+	std::vector<std::byte> result;
+	result.reserve(length + 6u);
+	append_header(result, tag, length);
+	for (const auto& content : contents)
+		result.insert(result.end(), content.begin(), content.end());
+	return result;
+}
+} //namespace
+
+std::vector<std::byte> encode(std::byte tag,
+	std::initializer_list<span_range_type> contents)
+{
+	return encode_impl(tag, contents);
+}
+
+std::vector<std::byte> encode(std::byte tag,
+	std::span<const span_range_type> contents)
+{
+	return encode_impl(tag, contents);
+}
+
+std::vector<std::byte> encode_set_of(std::vector<std::vector<std::byte>> elements)
+{
+	std::ranges::sort(elements);
+	const std::vector<span_range_type> contents(elements.begin(), elements.end());
+	return encode(tag::set, contents);
+}
+
+std::vector<std::byte> encode_oid(std::span<const std::uint32_t> oid)
+{
+	std::vector<std::byte> contents;
+	const auto append_arc = [&contents](std::uint64_t arc) {
+		std::size_t groups = 1u;
+		for (auto value = arc >> 7u; value; value >>= 7u)
+			++groups;
+		for (auto i = groups; i; --i)
+		{
+			auto part = static_cast<std::uint8_t>((arc >> ((i - 1u) * 7u)) & 0x7fu);
+			if (i != 1u)
+				part |= 0x80u;
+			contents.push_back(std::byte{ part });
+		}
+	};
+
+	if (oid.size() >= 2u)
+	{
+		append_arc(static_cast<std::uint64_t>(oid[0]) * 40u + oid[1]);
+		for (auto arc : oid.subspan(2u))
+			append_arc(arc);
+	}
+
+	return encode(tag::object_identifier, { contents });
+}
+
+std::vector<std::byte> encode_unsigned_integer(std::uint64_t value)
+{
+	std::vector<std::byte> bytes;
+	do
+	{
+		bytes.insert(bytes.begin(), static_cast<std::byte>(value & 0xffu));
+		value >>= 8u;
+	}
+	while (value);
+	return encode_unsigned_integer(bytes);
+}
+
+std::vector<std::byte> encode_unsigned_integer(span_range_type value)
+{
+	while (value.size() > 1u && value[0] == std::byte{})
+		value = value.subspan(1u);
+
+	static constexpr std::byte zero[]{ std::byte{} };
+	if (value.empty() || (value[0] & std::byte{ 0x80u }) != std::byte{})
+		return encode(tag::integer, { span_range_type(zero), value });
+
+	return encode(tag::integer, { value });
+}
+
+std::vector<std::byte> encode_null()
+{
+	return { tag::null, std::byte{} };
+}
+
+} //namespace pe_bliss::security::der
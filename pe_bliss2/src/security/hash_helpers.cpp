@@ -4,10 +4,14 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <cstdint>
 #include <exception>
+#include <span>
 #include <string>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include "buffers/input_buffer_stateful_wrapper.h"
 
@@ -15,6 +19,7 @@
 
 #include "pe_bliss2/detail/packed_serialization.h"
 #include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/page_hash_engine.h"
 
 #include "utilities/generic_error.h"
 
@@ -49,9 +54,17 @@ namespace pe_bliss::security
 namespace
 {
 
+std::span<std::byte> get_read_buffer(std::size_t size)
+{
+	thread_local std::vector<std::byte> buffer;
+	if (buffer.size() < size)
+		buffer.resize(size);
+	return { buffer.data(), size };
+}
+
 template<typename UpdateFunc>
 void update_hash_impl(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	UpdateFunc&& update_func)
+	const hash_read_options& options, UpdateFunc&& update_func)
 {
 	if (from > to)
 		throw pe_error(hash_helpers_errc::unable_to_read_data);
@@ -60,8 +73,12 @@ void update_hash_impl(buffers::input_buffer_interface& buf, std::size_t from, st
 	{
 		auto absolute_offset = buf.absolute_offset() + from;
 		auto physical_size = to - from;
+		const auto chunk_size = (std::max)(options.chunk_size, std::size_t{ 1u });
 		if (const auto* data = buf.get_raw_data(from, physical_size); data)
 		{
+			if (options.prefetch && physical_size >= chunk_size)
+				buf.advise_sequential_read(from, physical_size);
+
 			update_func(reinterpret_cast<const CryptoPP::byte*>(data),
 				physical_size, absolute_offset);
 			return;
@@ -69,11 +86,10 @@ void update_hash_impl(buffers::input_buffer_interface& buf, std::size_t from, st
 
 		buffers::input_buffer_stateful_wrapper_ref ref(buf);
 		ref.set_rpos(from);
-		static constexpr std::size_t temp_buffer_size = 512u;
-		std::array<std::byte, temp_buffer_size> temp;
+		const auto temp = get_read_buffer((std::min)(physical_size, chunk_size));
 		while (physical_size)
 		{
-			auto read_bytes = std::min(physical_size, temp_buffer_size);
+			auto read_bytes = (std::min)(physical_size, temp.size());
 			physical_size -= read_bytes;
 			ref.read(read_bytes, temp.data());
 			update_func(reinterpret_cast<const CryptoPP::byte*>(temp.data()),
@@ -95,27 +111,28 @@ std::error_code make_error_code(hash_helpers_errc e) noexcept
 }
 
 void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	CryptoPP::HashTransformation& hash)
+	CryptoPP::HashTransformation& hash, const hash_read_options& options)
 {
-	update_hash_impl(buf, from, to, [&hash](const CryptoPP::byte* data, std::size_t size,
-		std::size_t /* offset */) {
+	update_hash_impl(buf, from, to, options, [&hash](
+		const CryptoPP::byte* data, std::size_t size, std::size_t /* offset */) {
 		hash.Update(data, size);
 	});
 }
 
 void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	page_hash_state& state)
+	page_hash_state& state, const hash_read_options& options)
 {
-	update_hash_impl(buf, from, to, [&state](
+	update_hash_impl(buf, from, to, options, [&state](
 		const CryptoPP::byte* data, std::size_t size, std::size_t offset) {
 		state.update(reinterpret_cast<const std::byte*>(data), offset, size);
 	});
 }
 
 void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::size_t to,
-	CryptoPP::HashTransformation& hash, std::optional<page_hash_state>& state)
+	CryptoPP::HashTransformation& hash, std::optional<page_hash_state>& state,
+	const hash_read_options& options)
 {
-	update_hash_impl(buf, from, to, [&state, &hash](
+	update_hash_impl(buf, from, to, options, [&state, &hash](
 		const CryptoPP::byte* data, std::size_t size, std::size_t offset) {
 		hash.Update(data, size);
 		if (state)
@@ -125,12 +142,41 @@ void update_hash(buffers::input_buffer_interface& buf, std::size_t from, std::si
 
 page_hash_state::page_hash_state(CryptoPP::HashTransformation& hash,
 	std::size_t page_size) noexcept
-	: hash_(hash)
+	: hash_(&hash)
 	, page_size_(page_size)
 {
 	assert(page_size);
 }
 
+page_hash_state::page_hash_state(page_hash_engine& engine,
+	std::size_t page_size)
+	: page_size_(page_size)
+{
+	assert(page_size);
+	if (!engine.is_multi_buffer())
+	{
+		hash_ = &engine.get_generic_hash();
+		return;
+	}
+
+	engine_ = &engine;
+	batch_.resize(page_size * page_hash_engine::max_lanes);
+	batch_page_sizes_.reserve(page_hash_engine::max_lanes);
+}
+
+void page_hash_state::append(const std::byte* data, std::size_t size)
+{
+	if (engine_)
+	{
+		std::memcpy(batch_.data() + batch_page_sizes_.size() * page_size_
+			+ current_size_, data, size);
+	}
+	else
+	{
+		hash_->Update(reinterpret_cast<const CryptoPP::byte*>(data), size);
+	}
+}
+
 void page_hash_state::update(const std::byte* data,
 	std::size_t offset, std::size_t size)
 {
@@ -145,12 +191,12 @@ void page_hash_state::update(const std::byte* data,
 		const auto remaining_bytes = page_size_ - current_size_ - skipped_bytes_;
 		if (size < remaining_bytes)
 		{
-			hash_.Update(reinterpret_cast<const CryptoPP::byte*>(data + data_offset), size);
+			append(data + data_offset, size);
 			current_size_ += size;
 			return;
 		}
 
-		hash_.Update(reinterpret_cast<const CryptoPP::byte*>(data + data_offset), remaining_bytes);
+		append(data + data_offset, remaining_bytes);
 		current_size_ += remaining_bytes;
 		offset += remaining_bytes;
 		data_offset += remaining_bytes;
@@ -160,11 +206,16 @@ void page_hash_state::update(const std::byte* data,
 	}
 }
 
+std::size_t page_hash_state::get_digest_size() const
+{
+	return engine_ ? engine_->get_digest_size() : hash_->DigestSize();
+}
+
 std::byte* page_hash_state::add_blank_page(std::size_t offset)
 {
 	const auto pos = page_hashes_.size();
 	page_hashes_.resize(page_hashes_.size()
-		+ hash_.DigestSize() + sizeof(std::uint32_t));
+		+ get_digest_size() + sizeof(std::uint32_t));
 	return detail::packed_serialization<>::serialize<std::uint32_t>(
 		static_cast<std::uint32_t>(offset),
 		page_hashes_.data() + pos);
@@ -181,27 +232,54 @@ void page_hash_state::add_skipped_bytes(std::size_t skipped_bytes)
 void page_hash_state::next_page()
 {
 	static constexpr std::array<CryptoPP::byte, 512> empty_space{};
-	if (current_size_)
+	if (current_size_ && engine_)
+	{
+		const auto page_size = page_size_ - skipped_bytes_;
+		std::memset(batch_.data() + batch_page_sizes_.size() * page_size_
+			+ current_size_, 0, page_size - current_size_);
+		if (batch_page_sizes_.empty())
+			batch_first_page_pos_ = page_hashes_.size();
+		batch_page_sizes_.emplace_back(page_size);
+		add_blank_page(next_page_offset_);
+		if (batch_page_sizes_.size() == page_hash_engine::max_lanes)
+			flush_batch();
+		current_size_ = 0u;
+	}
+	else if (current_size_)
 	{
 		const auto page_size = page_size_ - skipped_bytes_;
 		while (current_size_ < page_size)
 		{
 			const auto update_size = (std::min)(page_size - current_size_,
 				empty_space.size());
-			hash_.Update(empty_space.data(), update_size);
+			hash_->Update(empty_space.data(), update_size);
 			current_size_ += update_size;
 		}
 		
-		hash_.Final(reinterpret_cast<CryptoPP::byte*>(
+		hash_->Final(reinterpret_cast<CryptoPP::byte*>(
 			add_blank_page(next_page_offset_)));
 		current_size_ = 0u;
 	}
 	skipped_bytes_ = 0u;
 }
 
-std::vector<std::byte> page_hash_state::get_page_hashes() && noexcept
+void page_hash_state::flush_batch()
+{
+	std::array<span_range_type, page_hash_engine::max_lanes> pages;
+	for (std::size_t i = 0; i != batch_page_sizes_.size(); ++i)
+		pages[i] = { batch_.data() + i * page_size_, batch_page_sizes_[i] };
+
+	engine_->calculate({ pages.data(), batch_page_sizes_.size() },
+		page_hashes_.data() + batch_first_page_pos_ + sizeof(std::uint32_t),
+		engine_->get_digest_size() + sizeof(std::uint32_t));
+	batch_page_sizes_.clear();
+}
+
+std::vector<std::byte> page_hash_state::get_page_hashes() &&
 {
 	next_page();
+	if (!batch_page_sizes_.empty())
+		flush_batch();
 	add_blank_page(last_offset_);
 	return std::move(page_hashes_);
 }
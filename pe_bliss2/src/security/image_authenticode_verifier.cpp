@@ -1,6 +1,9 @@
 #include "pe_bliss2/security/image_authenticode_verifier.h"
 
 #include <type_traits>
+#include <utility>
+
+#include "buffers/ref_buffer.h"
 
 #include "pe_bliss2/error_list.h"
 #include "pe_bliss2/security/authenticode_loader.h"
@@ -12,20 +15,11 @@
 namespace pe_bliss::security
 {
 
-std::optional<image_authenticode_check_status> verify_authenticode(
-	const image::image& instance,
-	const authenticode_verification_options& opts)
+namespace
 {
-	const auto sec_dir = load(instance);
-	if (!sec_dir)
-		return {};
-
-	return verify_authenticode(instance, *sec_dir, opts);
-}
-
-template<typename... Bases>
-std::optional<image_authenticode_check_status> verify_authenticode(
-	const image::image& instance,
+template<typename Image, typename... Bases>
+std::optional<image_authenticode_check_status> verify_authenticode_impl(
+	const Image& instance,
 	const security_directory_base<Bases...>& sec_dir,
 	const authenticode_verification_options& opts)
 {
@@ -51,11 +45,13 @@ std::optional<image_authenticode_check_status> verify_authenticode(
 
 	try
 	{
-		//This will not load the signature if sec_dir.get_entries()[0].get_certificate().data()
-		//is not copied. Data needs to be copied by calling `copied_data()` or by setting
-		//the `eager_overlay_data_copy` option to `true` when loading the image.
-		authenticode = load_authenticode_signature<span_range_type>(
-			*sec_dir.get_entries()[0].get_certificate().data());
+		//The signature is parsed in place if the certificate data is contiguous
+		//in memory (the image is loaded from a memory or memory-mapped buffer,
+		//or the data is copied). Otherwise, only the signature is copied.
+		buffers::ref_buffer signature_data;
+		authenticode = load_authenticode_signature(
+			sec_dir.get_entries()[0].get_certificate().data(), signature_data);
+		result.signature_data = signature_data.data();
 	}
 	catch (const asn1::parse_error&)
 	{
@@ -72,11 +68,65 @@ std::optional<image_authenticode_check_status> verify_authenticode(
 		return optional_result;
 	}
 
+	//Signature is loaded in place, so the lazy certificate store
+	//can reference the same data
+	const auto signature_size = result.signature_data->size();
+	const auto* raw_signature = result.signature_data->get_raw_data(0, signature_size);
 	result.authenticode_status = verify_authenticode_full(
-		std::move(authenticode), instance, opts);
+		std::move(authenticode), instance, opts,
+		span_range_type(raw_signature, signature_size));
 	return optional_result;
 }
 
+image_authenticode_stream_check_status verify_authenticode_stream(
+	image_hash_stream_result&& hashes,
+	const authenticode_verification_options& opts)
+{
+	image_authenticode_stream_check_status result{ .hashes = std::move(hashes) };
+	if (result.hashes.security_directory)
+	{
+		result.check_status = verify_authenticode_impl(result.hashes,
+			load(result.hashes.security_directory), opts);
+	}
+	return result;
+}
+} //namespace
+
+std::optional<image_authenticode_check_status> verify_authenticode(
+	const image::image& instance,
+	const authenticode_verification_options& opts)
+{
+	const auto sec_dir = load(instance);
+	if (!sec_dir)
+		return {};
+
+	return verify_authenticode(instance, *sec_dir, opts);
+}
+
+template<typename... Bases>
+std::optional<image_authenticode_check_status> verify_authenticode(
+	const image::image& instance,
+	const security_directory_base<Bases...>& sec_dir,
+	const authenticode_verification_options& opts)
+{
+	return verify_authenticode_impl(instance, sec_dir, opts);
+}
+
+image_authenticode_stream_check_status verify_authenticode(std::istream& stream,
+	const authenticode_verification_options& opts,
+	const image_hash_stream_options& stream_opts)
+{
+	return verify_authenticode_stream(calculate_stream_hash(stream, stream_opts), opts);
+}
+
+image_authenticode_stream_check_status verify_authenticode(
+	buffers::input_buffer_interface& buffer,
+	const authenticode_verification_options& opts,
+	const image_hash_stream_options& stream_opts)
+{
+	return verify_authenticode_stream(calculate_stream_hash(buffer, stream_opts), opts);
+}
+
 template std::optional<image_authenticode_check_status>
 verify_authenticode<>(
 	const image::image& instance,
@@ -4,9 +4,15 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <bit>
 #include <cstdint>
+#include <deque>
 #include <exception>
+#include <istream>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <variant>
@@ -14,6 +20,8 @@
 
 #include "buffers/input_buffer_interface.h"
 #include "buffers/input_buffer_stateful_wrapper.h"
+#include "buffers/input_container_buffer.h"
+#include "buffers/input_memory_buffer.h"
 
 #define CRYPTOPP_ENABLE_NAMESPACE_WEAK 1
 #include "cryptopp/md5.h"
@@ -21,11 +29,20 @@
 
 #include "pe_bliss2/core/data_directories.h"
 #include "pe_bliss2/core/file_header.h"
+#include "pe_bliss2/core/image_signature.h"
 #include "pe_bliss2/core/optional_header.h"
+#include "pe_bliss2/detail/image_dos_header.h"
+#include "pe_bliss2/detail/image_file_header.h"
 #include "pe_bliss2/detail/image_optional_header.h"
 #include "pe_bliss2/detail/packed_reflection.h"
+#include "pe_bliss2/detail/packed_serialization.h"
+#include "pe_bliss2/dos/dos_header.h"
+#include "pe_bliss2/error_list.h"
 #include "pe_bliss2/image/checksum.h"
 #include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_loader.h"
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/section/section_header.h"
 #include "pe_bliss2/security/buffer_hash.h"
 #include "pe_bliss2/security/byte_range_types.h"
 #include "pe_bliss2/security/hash_helpers.h"
@@ -60,7 +77,40 @@ struct hash_calculator_error_category : std::error_category
 	}
 };
 
+struct image_hash_stream_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "image_hash_stream";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::image_hash_stream_errc;
+		switch (static_cast<pe_bliss::security::image_hash_stream_errc>(ev))
+		{
+		case headers_too_big:
+			return "Image headers are too big";
+		case security_directory_too_big:
+			return "Security directory is too big";
+		case security_directory_not_at_end:
+			return "Security directory is not located at the end of the image";
+		case overlapping_sections:
+			return "Image sections overlap, unable to calculate page hashes in a single pass";
+		case page_hashes_not_calculated:
+			return "Page hashes were not calculated";
+		case digest_not_calculated:
+			return "Image digest was not calculated for the requested algorithm";
+		case page_size_mismatch:
+			return "Page hashes were calculated using a different page size";
+		default:
+			return {};
+		}
+	}
+};
+
 const hash_calculator_error_category hash_calculator_error_category_instance;
+const image_hash_stream_error_category image_hash_stream_error_category_instance;
 } //namespace
 
 namespace pe_bliss::security
@@ -71,6 +121,11 @@ std::error_code make_error_code(hash_calculator_errc e) noexcept
 	return { static_cast<int>(e), hash_calculator_error_category_instance };
 }
 
+std::error_code make_error_code(image_hash_stream_errc e) noexcept
+{
+	return { static_cast<int>(e), image_hash_stream_error_category_instance };
+}
+
 namespace
 {
 std::uint32_t get_cert_table_entry_offset(const image::image& instance)
@@ -107,14 +162,20 @@ std::size_t get_memory_page_size(const image::image& instance)
 	}
 }
 
+std::size_t get_page_size(const image::image& instance, std::size_t page_size)
+{
+	return page_size ? page_size : get_memory_page_size(instance);
+}
+
 void try_init_page_hash_state(
 	const image::image& instance,
 	const page_hash_options& options,
-	CryptoPP::HashTransformation& page_hash,
+	page_hash_engine& page_hash,
 	image_hash_result& result,
 	std::optional<page_hash_state>& state)
 {
-	const std::size_t memory_page_size = get_memory_page_size(instance);
+	const std::size_t memory_page_size = get_page_size(
+		instance, options.page_size);
 
 	std::size_t page_count = 1u + (instance.get_full_headers_buffer().physical_size()
 		+ memory_page_size - 1u) / memory_page_size;
@@ -124,7 +185,7 @@ void try_init_page_hash_state(
 			/ memory_page_size;
 	}
 
-	const std::size_t single_page_hash_size = page_hash.DigestSize() + sizeof(std::uint32_t);
+	const std::size_t single_page_hash_size = page_hash.get_digest_size() + sizeof(std::uint32_t);
 	const std::size_t total_page_hashes_size = page_count * single_page_hash_size;
 	if (total_page_hashes_size > options.max_page_hashes_size
 		|| total_page_hashes_size / page_count != single_page_hash_size)
@@ -140,7 +201,8 @@ void try_init_page_hash_state(
 void calculate_hash_impl(const image::image& instance,
 	CryptoPP::HashTransformation& hash, image_hash_result& result,
 	const page_hash_options* page_hashes,
-	CryptoPP::HashTransformation* page_hash)
+	page_hash_engine* page_hash,
+	const hash_read_options& read_options)
 {
 	std::optional<page_hash_state> state;
 	if (page_hash && page_hashes)
@@ -160,19 +222,19 @@ void calculate_hash_impl(const image::image& instance,
 		throw pe_error(hash_calculator_errc::invalid_security_directory_offset);
 	}
 
-	update_hash(*headers_buffer, 0u, checksum_offset, hash, state);
+	update_hash(*headers_buffer, 0u, checksum_offset, hash, state, read_options);
 	if (state)
 		state->add_skipped_bytes(sizeof(std::uint32_t)); //sizeof checksum
 
 	update_hash(*headers_buffer,
 		checksum_offset + sizeof(image::image_checksum_type),
-		cert_table_entry_offset, hash, state);
+		cert_table_entry_offset, hash, state, read_options);
 	if (state)
 		state->add_skipped_bytes(core::data_directories::directory_packed_size);
 
 	update_hash(*headers_buffer,
 		cert_table_entry_offset + core::data_directories::directory_packed_size,
-		headers_buffer->physical_size(), hash, state);
+		headers_buffer->physical_size(), hash, state, read_options);
 
 	auto full_sections_buffer = instance.get_full_sections_buffer().data();
 	const bool has_full_sections_data = full_sections_buffer->size() != 0u;
@@ -209,14 +271,17 @@ void calculate_hash_impl(const image::image& instance,
 			if (state)
 			{
 				if (has_full_sections_data)
-					update_hash(*section_buf, 0u, section_buf->physical_size(), *state);
+					update_hash(*section_buf, 0u, section_buf->physical_size(), *state,
+						read_options);
 				else
-					update_hash(*section_buf, 0u, section_buf->physical_size(), hash, state);
+					update_hash(*section_buf, 0u, section_buf->physical_size(), hash, state,
+						read_options);
 				state->next_page();
 			}
 			else
 			{
-				update_hash(*section_buf, 0u, section_buf->physical_size(), hash);
+				update_hash(*section_buf, 0u, section_buf->physical_size(), hash,
+					read_options);
 			}
 		}
 	}
@@ -224,16 +289,25 @@ void calculate_hash_impl(const image::image& instance,
 	if (has_full_sections_data)
 	{
 		update_hash(*full_sections_buffer, 0u,
-			full_sections_buffer->physical_size(), hash);
+			full_sections_buffer->physical_size(), hash, read_options);
 	}
 
 	std::size_t remaining_size = instance.get_overlay().physical_size();
 
-	if (!instance.get_data_directories().has_security())
+	if (!instance.get_data_directories().has_directory(
+		core::data_directories::directory_type::security))
+	{
 		throw pe_error(hash_helpers_errc::unable_to_read_data);
+	}
 
-	const auto security_dir_size = instance.get_data_directories()
-		.get_directory(core::data_directories::directory_type::security)->size;
+	//Images without the embedded signature (e.g., catalog-signed ones)
+	//are hashed up to the end of the overlay
+	std::uint32_t security_dir_size = 0u;
+	if (instance.get_data_directories().has_security())
+	{
+		security_dir_size = instance.get_data_directories()
+			.get_directory(core::data_directories::directory_type::security)->size;
+	}
 	if (security_dir_size > remaining_size)
 		throw pe_error(hash_helpers_errc::unable_to_read_data);
 
@@ -241,7 +315,7 @@ void calculate_hash_impl(const image::image& instance,
 	if (remaining_size)
 	{
 		auto overlay_buf = instance.get_overlay().data();
-		update_hash(*overlay_buf, 0u, remaining_size, hash);
+		update_hash(*overlay_buf, 0u, remaining_size, hash, read_options);
 	}
 
 	result.image_hash.resize(hash.DigestSize());
@@ -285,22 +359,539 @@ CryptoPP::HashTransformation* get_hash(hash_variant_type& hash)
 		[](std::monostate) -> CryptoPP::HashTransformation* { return nullptr; }
 	}, hash);
 }
+
+class image_stream_source
+{
+public:
+	virtual ~image_stream_source() = default;
+
+	//Returns at most max_size (which is not zero) next bytes,
+	//or an empty span if there is no more data
+	[[nodiscard]]
+	virtual std::span<const std::byte> read(std::size_t max_size) = 0;
+};
+
+class istream_source final : public image_stream_source
+{
+public:
+	istream_source(std::istream& stream, std::size_t buffer_size)
+		: stream_(stream)
+		, buffer_((std::max)(buffer_size, std::size_t{ 1u }))
+	{
+	}
+
+	virtual std::span<const std::byte> read(std::size_t max_size) override
+	{
+		if (!stream_.good())
+			return {};
+
+		stream_.read(reinterpret_cast<char*>(buffer_.data()),
+			static_cast<std::streamsize>((std::min)(max_size, buffer_.size())));
+		if (stream_.bad())
+			throw pe_error(hash_helpers_errc::unable_to_read_data);
+
+		return { buffer_.data(), static_cast<std::size_t>(stream_.gcount()) };
+	}
+
+private:
+	std::istream& stream_;
+	std::vector<std::byte> buffer_;
+};
+
+class buffer_source final : public image_stream_source
+{
+public:
+	buffer_source(buffers::input_buffer_interface& buffer, std::size_t buffer_size)
+		: buffer_(buffer)
+		, size_(buffer.physical_size())
+	{
+		if (size_ && !buffer_.get_raw_data(0u, size_))
+			temp_.resize((std::max)(buffer_size, std::size_t{ 1u }));
+	}
+
+	virtual std::span<const std::byte> read(std::size_t max_size) override
+	{
+		const auto count = (std::min)(max_size, size_ - pos_);
+		if (!count)
+			return {};
+
+		if (temp_.empty())
+		{
+			const auto* data = buffer_.get_raw_data(pos_, count);
+			pos_ += count;
+			return { data, count };
+		}
+
+		const auto read_bytes = buffer_.read(pos_,
+			(std::min)(count, temp_.size()), temp_.data());
+		pos_ += read_bytes;
+		return { temp_.data(), read_bytes };
+	}
+
+private:
+	buffers::input_buffer_interface& buffer_;
+	std::size_t size_;
+	std::size_t pos_{};
+	std::vector<std::byte> temp_;
+};
+
+struct stream_digest_state
+{
+	explicit stream_digest_state(image_hash_stream_digest& digest) noexcept
+		: digest(digest)
+	{
+	}
+
+	image_hash_stream_digest& digest;
+	hash_variant_type image_hash;
+	std::optional<page_hash_engine> page_hash;
+	std::optional<page_hash_state> page_state;
+};
+
+struct section_data_range
+{
+	std::size_t from;
+	std::size_t to;
+};
+
+class image_stream_hasher final
+{
+public:
+	image_stream_hasher(image_stream_source& source,
+		const image_hash_stream_options& options,
+		image_hash_stream_result& result)
+		: source_(source)
+		, options_(options)
+		, result_(result)
+	{
+	}
+
+	void calculate()
+	{
+		init_digests();
+		load_headers();
+		init_sections();
+		init_page_hashes();
+		hash_headers();
+		hash_sections();
+		hash_overlay();
+		finalize();
+	}
+
+private:
+	void init_digests()
+	{
+		for (auto algorithm : options_.algorithms)
+		{
+			if (!result_.find_digest(algorithm))
+				result_.digests.emplace_back().algorithm = algorithm;
+		}
+
+		for (auto& digest : result_.digests)
+			init_hash(states_.emplace_back(digest).image_hash, digest.algorithm);
+	}
+
+	void read_headers(std::uint64_t size)
+	{
+		if (size > options_.max_headers_size
+			&& size - options_.max_headers_size > section_table_size_)
+		{
+			throw pe_error(image_hash_stream_errc::headers_too_big);
+		}
+
+		while (headers_.size() < size)
+		{
+			const auto data = source_.read(static_cast<std::size_t>(size) - headers_.size());
+			if (data.empty())
+				break;
+			headers_.insert(headers_.end(), data.begin(), data.end());
+		}
+	}
+
+	template<typename T>
+	[[nodiscard]]
+	T read_header_field(std::uint64_t offset) const noexcept
+	{
+		T result{};
+		detail::packed_serialization<>::deserialize(result,
+			headers_.data() + offset);
+		return result;
+	}
+
+	void load_headers()
+	{
+		static constexpr auto e_lfanew_offset = detail::packed_reflection
+			::get_field_offset<&detail::image_dos_header::e_lfanew>();
+		static constexpr auto size_of_optional_header_offset = detail::packed_reflection
+			::get_field_offset<&detail::image_file_header::size_of_optional_header>();
+		static constexpr auto number_of_sections_offset = detail::packed_reflection
+			::get_field_offset<&detail::image_file_header::number_of_sections>();
+		static constexpr auto max_optional_header_size
+			= sizeof(core::optional_header::magic_type)
+			+ detail::packed_reflection::get_type_size<detail::image_optional_header_64>()
+			+ core::data_directories::directory_packed_size
+			* (static_cast<std::uint32_t>(core::data_directories::directory_type::com_descriptor) + 2u);
+
+		read_headers(dos::dos_header::descriptor_type::packed_size);
+		if (headers_.size() == dos::dos_header::descriptor_type::packed_size)
+		{
+			const std::uint64_t file_header_offset
+				= read_header_field<std::uint32_t>(e_lfanew_offset)
+				+ core::image_signature::descriptor_type::packed_size;
+			const std::uint64_t optional_header_offset = file_header_offset
+				+ core::file_header::descriptor_type::packed_size;
+			read_headers(optional_header_offset);
+			if (headers_.size() == optional_header_offset)
+			{
+				section_table_size_ = static_cast<std::size_t>(
+					read_header_field<std::uint16_t>(
+						file_header_offset + number_of_sections_offset))
+					* section::section_header::descriptor_type::packed_size;
+				const std::uint64_t section_table_end = optional_header_offset
+					+ read_header_field<std::uint16_t>(
+						file_header_offset + size_of_optional_header_offset)
+					+ section_table_size_;
+				read_headers((std::max)(section_table_end,
+					optional_header_offset + max_optional_header_size));
+			}
+		}
+
+		error_list warnings;
+		std::exception_ptr fatal_error;
+		image::image_loader::load(instance_, warnings, fatal_error,
+			std::make_shared<buffers::input_memory_buffer>(headers_.data(), headers_.size()), {
+				.allow_virtual_headers = true,
+				.validate_sections = false,
+				.load_section_data = false,
+				.validate_size_of_image = false,
+				.eager_dos_stub_data_copy = true,
+				.validate_image_base = false,
+				.validate_size_of_optional_header = false,
+				.load_overlay = false,
+				.load_full_headers_buffer = false,
+				.load_full_sections_buffer = false
+			});
+		if (fatal_error)
+			std::rethrow_exception(fatal_error);
+	}
+
+	void init_sections()
+	{
+		const auto& optional_hdr = instance_.get_optional_header();
+		const auto section_alignment = optional_hdr.get_raw_section_alignment();
+		const auto& section_headers = instance_.get_section_table().get_section_headers();
+		for (const auto& header : section_headers)
+		{
+			const auto raw_size = header.get_raw_size(section_alignment);
+			if (header.get_pointer_to_raw_data())
+			{
+				first_section_data_offset_ = (std::min<std::size_t>)(
+					first_section_data_offset_, header.get_pointer_to_raw_data());
+				last_section_data_offset_ = (std::max)(last_section_data_offset_,
+					static_cast<std::size_t>(header.get_pointer_to_raw_data()) + raw_size);
+			}
+
+			if (header.get_descriptor()->size_of_raw_data && raw_size)
+			{
+				sections_.push_back({ header.get_pointer_to_raw_data(),
+					static_cast<std::size_t>(header.get_pointer_to_raw_data()) + raw_size });
+			}
+		}
+
+		std::sort(sections_.begin(), sections_.end(),
+			[](const section_data_range& l, const section_data_range& r) {
+			return l.from < r.from;
+		});
+
+		headers_size_ = optional_hdr.get_raw_size_of_headers();
+		if (last_section_data_offset_)
+		{
+			if (section_alignment && std::has_single_bit(section_alignment))
+				(void)utilities::math::align_up_if_safe(headers_size_, section_alignment);
+			headers_size_ = (std::min)(headers_size_, first_section_data_offset_);
+		}
+
+		read_headers(headers_size_);
+		headers_size_ = (std::min)(headers_size_, headers_.size());
+		position_ = headers_size_;
+		leftover_pos_ = headers_size_;
+	}
+
+	void init_page_hashes()
+	{
+		std::error_code page_hash_errc;
+		if (!options_.calculate_page_hashes)
+			page_hash_errc = image_hash_stream_errc::page_hashes_not_calculated;
+
+		std::size_t last_offset = headers_size_;
+		for (const auto& section : sections_)
+		{
+			if (section.from < last_offset)
+				page_hash_errc = image_hash_stream_errc::overlapping_sections;
+			last_offset = section.to;
+		}
+
+		const std::size_t memory_page_size = get_page_size(
+			instance_, options_.page_size);
+		result_.page_size = memory_page_size;
+		std::size_t page_count = 1u + (headers_size_ + memory_page_size - 1u)
+			/ memory_page_size;
+		for (const auto& section : sections_)
+		{
+			page_count += (section.to - section.from + memory_page_size - 1u)
+				/ memory_page_size;
+		}
+
+		for (auto& state : states_)
+		{
+			if (page_hash_errc)
+			{
+				state.digest.hash.page_hash_errc = page_hash_errc;
+				continue;
+			}
+
+			const std::size_t single_page_hash_size
+				= get_hash(state.image_hash)->DigestSize() + sizeof(std::uint32_t);
+			const std::size_t total_page_hashes_size = page_count * single_page_hash_size;
+			if (total_page_hashes_size > options_.max_page_hashes_size
+				|| total_page_hashes_size / page_count != single_page_hash_size)
+			{
+				state.digest.hash.page_hash_errc = hash_calculator_errc::page_hashes_data_too_big;
+				continue;
+			}
+
+			state.page_state.emplace(state.page_hash.emplace(
+				state.digest.algorithm, options_.engine_type), memory_page_size)
+				.reserve(total_page_hashes_size);
+		}
+	}
+
+	void update_image_hash(std::span<const std::byte> data)
+	{
+		for (auto& state : states_)
+		{
+			get_hash(state.image_hash)->Update(
+				reinterpret_cast<const CryptoPP::byte*>(data.data()), data.size());
+		}
+	}
+
+	void update_page_hashes(std::span<const std::byte> data, std::size_t offset)
+	{
+		for (auto& state : states_)
+		{
+			if (state.page_state)
+				state.page_state->update(data.data(), offset, data.size());
+		}
+	}
+
+	void next_page()
+	{
+		for (auto& state : states_)
+		{
+			if (state.page_state)
+				state.page_state->next_page();
+		}
+	}
+
+	void add_skipped_bytes(std::size_t skipped_bytes)
+	{
+		for (auto& state : states_)
+		{
+			if (state.page_state)
+				state.page_state->add_skipped_bytes(skipped_bytes);
+		}
+	}
+
+	void hash_headers()
+	{
+		const auto checksum_offset = image::get_checksum_offset(instance_);
+		const auto cert_table_entry_offset = get_cert_table_entry_offset(instance_);
+		if (headers_size_ < cert_table_entry_offset
+			+ core::data_directories::directory_packed_size
+			|| cert_table_entry_offset < checksum_offset)
+		{
+			throw pe_error(hash_calculator_errc::invalid_security_directory_offset);
+		}
+
+		const std::span<const std::byte> headers(headers_.data(), headers_size_);
+		const auto hash_headers_part = [this, &headers](std::size_t from, std::size_t to) {
+			update_image_hash(headers.subspan(from, to - from));
+			update_page_hashes(headers.subspan(from, to - from), from);
+		};
+
+		hash_headers_part(0u, checksum_offset);
+		add_skipped_bytes(sizeof(image::image_checksum_type));
+		hash_headers_part(checksum_offset + sizeof(image::image_checksum_type),
+			cert_table_entry_offset);
+		add_skipped_bytes(core::data_directories::directory_packed_size);
+		hash_headers_part(cert_table_entry_offset
+			+ core::data_directories::directory_packed_size, headers_size_);
+		next_page();
+	}
+
+	[[nodiscard]]
+	std::span<const std::byte> next_chunk(std::size_t max_size)
+	{
+		if (leftover_pos_ < headers_.size())
+		{
+			const auto size = (std::min)(max_size, headers_.size() - leftover_pos_);
+			const std::span<const std::byte> result(headers_.data() + leftover_pos_, size);
+			leftover_pos_ += size;
+			return result;
+		}
+
+		return source_.read(max_size);
+	}
+
+	//Returns false if there is not enough data
+	template<typename Handler>
+	[[nodiscard]]
+	bool read_until(std::size_t offset, Handler&& handler)
+	{
+		while (position_ < offset)
+		{
+			const auto data = next_chunk(offset - position_);
+			if (data.empty())
+				return false;
+
+			handler(data, position_);
+			position_ += data.size();
+		}
+		return true;
+	}
+
+	void hash_section_data(std::span<const std::byte> data, std::size_t offset)
+	{
+		update_image_hash(data);
+
+		const auto end = offset + data.size();
+		while (current_section_ != sections_.size())
+		{
+			const auto& range = sections_[current_section_];
+			if (end <= range.from)
+				return;
+
+			const auto from = (std::max)(offset, range.from);
+			const auto to = (std::min)(end, range.to);
+			if (from < to)
+				update_page_hashes(data.subspan(from - offset, to - from), from);
+
+			if (end < range.to)
+				return;
+
+			next_page();
+			++current_section_;
+		}
+	}
+
+	void hash_sections()
+	{
+		if (!last_section_data_offset_)
+			return;
+
+		if (!read_until(first_section_data_offset_, [](auto&&...) {})
+			|| !read_until(last_section_data_offset_,
+				[this](std::span<const std::byte> data, std::size_t offset) {
+					hash_section_data(data, offset);
+				}))
+		{
+			throw pe_error(hash_calculator_errc::invalid_section_data);
+		}
+	}
+
+	void hash_overlay()
+	{
+		const auto overlay_offset = (std::max<std::size_t>)(last_section_data_offset_,
+			instance_.get_optional_header().get_raw_size_of_headers());
+		const auto hash_overlay_part = [this](std::span<const std::byte> data, std::size_t) {
+			update_image_hash(data);
+		};
+
+		if (!instance_.get_data_directories().has_security())
+		{
+			if (read_until(overlay_offset, [](auto&&...) {}))
+			{
+				(void)read_until((std::numeric_limits<std::size_t>::max)(),
+					hash_overlay_part);
+			}
+			return;
+		}
+
+		const auto& security_dir_info = instance_.get_data_directories().get_directory(
+			core::data_directories::directory_type::security);
+		const std::size_t security_dir_offset = security_dir_info->virtual_address;
+		const std::size_t security_dir_size = security_dir_info->size;
+		if (security_dir_offset < overlay_offset)
+			throw pe_error(hash_calculator_errc::invalid_security_directory_offset);
+		if (security_dir_size > options_.max_security_directory_size)
+			throw pe_error(image_hash_stream_errc::security_directory_too_big);
+
+		auto security_directory = std::make_shared<buffers::input_container_buffer>(
+			security_dir_offset);
+		auto& container = security_directory->get_container();
+		container.reserve(security_dir_size);
+		if (!read_until(overlay_offset, [](auto&&...) {})
+			|| !read_until(security_dir_offset, hash_overlay_part)
+			|| !read_until(security_dir_offset + security_dir_size,
+				[&container](std::span<const std::byte> data, std::size_t) {
+					container.insert(container.end(), data.begin(), data.end());
+				}))
+		{
+			throw pe_error(hash_helpers_errc::unable_to_read_data);
+		}
+
+		if (!next_chunk(1u).empty())
+			throw pe_error(image_hash_stream_errc::security_directory_not_at_end);
+
+		result_.security_directory = std::move(security_directory);
+	}
+
+	void finalize()
+	{
+		for (auto& state : states_)
+		{
+			auto& hash = *get_hash(state.image_hash);
+			auto& result = state.digest.hash;
+			result.image_hash.resize(hash.DigestSize());
+			hash.Final(reinterpret_cast<CryptoPP::byte*>(result.image_hash.data()));
+			if (state.page_state)
+				result.page_hashes = std::move(*state.page_state).get_page_hashes();
+		}
+	}
+
+private:
+	image_stream_source& source_;
+	const image_hash_stream_options& options_;
+	image_hash_stream_result& result_;
+	std::deque<stream_digest_state> states_;
+	std::vector<std::byte> headers_;
+	image::image instance_;
+	std::vector<section_data_range> sections_;
+	std::size_t first_section_data_offset_{ (std::numeric_limits<std::size_t>::max)() };
+	std::size_t last_section_data_offset_{};
+	std::size_t headers_size_{};
+	std::size_t section_table_size_{};
+	std::size_t position_{};
+	std::size_t leftover_pos_{};
+	std::size_t current_section_{};
+};
 } //namespace
 
 image_hash_result calculate_hash(digest_algorithm algorithm,
 	const pe_bliss::image::image& instance,
-	const page_hash_options* page_hash_opts)
+	const page_hash_options* page_hash_opts,
+	const hash_read_options& read_opts)
 {
 	image_hash_result result;
 
 	hash_variant_type image_hash;
-	hash_variant_type page_hash;
+	std::optional<page_hash_engine> page_hash;
 	init_hash(image_hash, algorithm);
 	if (page_hash_opts)
 	{
 		try
 		{
-			init_hash(page_hash, page_hash_opts->algorithm);
+			page_hash.emplace(page_hash_opts->algorithm, page_hash_opts->engine_type);
 		}
 		catch (const pe_error& e)
 		{
@@ -310,7 +901,7 @@ image_hash_result calculate_hash(digest_algorithm algorithm,
 	}
 
 	calculate_hash_impl(instance, *get_hash(image_hash),
-		result, page_hash_opts, get_hash(page_hash));
+		result, page_hash_opts, page_hash ? &*page_hash : nullptr, read_opts);
 	return result;
 }
 
@@ -339,4 +930,75 @@ image_hash_verification_result verify_image_hash(span_range_type image_hash,
 	return result;
 }
 
+const image_hash_stream_digest* image_hash_stream_result::find_digest(
+	digest_algorithm algorithm) const noexcept
+{
+	const auto it = std::ranges::find(digests, algorithm,
+		&image_hash_stream_digest::algorithm);
+	return it == digests.end() ? nullptr : &*it;
+}
+
+image_hash_stream_result calculate_stream_hash(std::istream& stream,
+	const image_hash_stream_options& options)
+{
+	image_hash_stream_result result;
+	istream_source source(stream, options.read_buffer_size);
+	image_stream_hasher(source, options, result).calculate();
+	return result;
+}
+
+image_hash_stream_result calculate_stream_hash(buffers::input_buffer_interface& buffer,
+	const image_hash_stream_options& options)
+{
+	image_hash_stream_result result;
+	buffer_source source(buffer, options.read_buffer_size);
+	image_stream_hasher(source, options, result).calculate();
+	return result;
+}
+
+image_hash_verification_result verify_image_hash(span_range_type image_hash,
+	digest_algorithm digest_alg, const image_hash_stream_result& hashes,
+	const std::optional<span_range_type>& page_hashes,
+	const std::optional<page_hash_options>& page_hash_options)
+{
+	assert(!!page_hashes == !!page_hash_options);
+
+	const auto* digest = hashes.find_digest(digest_alg);
+	if (!digest)
+		throw pe_error(image_hash_stream_errc::digest_not_calculated);
+
+	image_hash_verification_result result;
+	if (page_hashes && page_hash_options)
+	{
+		const auto* page_digest = hashes.find_digest(page_hash_options->algorithm);
+		if (!page_digest)
+		{
+			result.page_hashes_check_errc = image_hash_stream_errc::digest_not_calculated;
+			result.page_hashes_valid = false;
+		}
+		else
+		{
+			const auto& calculated = page_digest->hash.page_hashes;
+			if (page_hash_options->page_size
+				&& page_hash_options->page_size != hashes.page_size)
+			{
+				result.page_hashes_check_errc = image_hash_stream_errc::page_size_mismatch;
+			}
+			else if (calculated.size() > page_hash_options->max_page_hashes_size)
+			{
+				result.page_hashes_check_errc = hash_calculator_errc::page_hashes_data_too_big;
+			}
+			else
+			{
+				result.page_hashes_check_errc = page_digest->hash.page_hash_errc;
+			}
+			result.page_hashes_valid = !result.page_hashes_check_errc
+				&& std::ranges::equal(calculated, *page_hashes);
+		}
+	}
+
+	result.image_hash_valid = std::ranges::equal(digest->hash.image_hash, image_hash);
+	return result;
+}
+
 } //namespace pe_bliss::security
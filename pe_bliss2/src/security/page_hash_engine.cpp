@@ -0,0 +1,461 @@
+#include "pe_bliss2/security/page_hash_engine.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#define CRYPTOPP_ENABLE_NAMESPACE_WEAK 1
+#include "cryptopp/md5.h"
+#include "cryptopp/sha.h"
+
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/buffer_hash.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#	define PE_BLISS_PAGE_HASH_X86 1
+#	include <immintrin.h>
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+#if defined(PE_BLISS_PAGE_HASH_X86) && (defined(__GNUC__) || defined(__clang__))
+#	define PE_BLISS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#	define PE_BLISS_TARGET_AVX2
+#endif
+
+namespace pe_bliss::security
+{
+
+namespace
+{
+
+struct cpu_features
+{
+	bool avx2{};
+	bool sha{};
+};
+
+cpu_features detect_cpu_features() noexcept
+{
+	cpu_features result;
+#ifdef PE_BLISS_PAGE_HASH_X86
+#	ifdef _MSC_VER
+	int regs[4]{};
+	__cpuid(regs, 0);
+	if (regs[0] < 7)
+		return result;
+
+	__cpuid(regs, 1);
+	const bool os_saves_ymm = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28))
+		&& (_xgetbv(0) & 6u) == 6u;
+	__cpuidex(regs, 7, 0);
+	const auto ebx = static_cast<unsigned>(regs[1]);
+#	else
+	unsigned eax{}, ebx{}, ecx{}, edx{};
+	if (__get_cpuid_max(0u, nullptr) < 7u)
+		return result;
+
+	__cpuid(1u, eax, ebx, ecx, edx);
+	bool os_saves_ymm = (ecx & (1u << 27u)) && (ecx & (1u << 28u));
+	if (os_saves_ymm)
+	{
+		unsigned xcr0_low{}, xcr0_high{};
+		__asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0u));
+		os_saves_ymm = (xcr0_low & 6u) == 6u;
+	}
+	__cpuid_count(7u, 0u, eax, ebx, ecx, edx);
+#	endif
+	result.avx2 = os_saves_ymm && (ebx & (1u << 5u));
+	result.sha = (ebx & (1u << 29u)) != 0u;
+#endif //PE_BLISS_PAGE_HASH_X86
+	return result;
+}
+
+const cpu_features& get_cpu_features() noexcept
+{
+	static const cpu_features features = detect_cpu_features();
+	return features;
+}
+
+#ifdef PE_BLISS_PAGE_HASH_X86
+
+constexpr std::size_t block_size = 64u;
+constexpr std::size_t lane_count = page_hash_engine::max_lanes;
+
+//Provides message blocks, including the final padded ones
+class lane_blocks
+{
+public:
+	void init(span_range_type message) noexcept
+	{
+		message_ = message.data();
+		full_blocks_ = message.size() / block_size;
+		const auto remaining = message.size() % block_size;
+		tail_.fill({});
+		if (remaining)
+			std::memcpy(tail_.data(), message_ + full_blocks_ * block_size, remaining);
+		tail_[remaining] = std::byte{ 0x80u };
+		tail_blocks_ = remaining + 9u <= block_size ? 1u : 2u;
+
+		auto bit_length = static_cast<std::uint64_t>(message.size()) * 8u;
+		for (std::size_t i = tail_blocks_ * block_size; bit_length; bit_length >>= 8u)
+			tail_[--i] = static_cast<std::byte>(bit_length & 0xffu);
+	}
+
+	[[nodiscard]]
+	std::size_t get_block_count() const noexcept
+	{
+		return full_blocks_ + tail_blocks_;
+	}
+
+	[[nodiscard]]
+	const std::byte* get_block(std::size_t index) const noexcept
+	{
+		return index < full_blocks_ ? message_ + index * block_size
+			: tail_.data() + (index - full_blocks_) * block_size;
+	}
+
+private:
+	const std::byte* message_{};
+	std::size_t full_blocks_{};
+	std::size_t tail_blocks_{};
+	std::array<std::byte, block_size * 2u> tail_{};
+};
+
+using lane_block_pointers = std::array<const std::byte*, lane_count>;
+
+template<int N>
+PE_BLISS_TARGET_AVX2 inline __m256i rotr(__m256i x) noexcept
+{
+	return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+template<int N>
+PE_BLISS_TARGET_AVX2 inline __m256i rotl(__m256i x) noexcept
+{
+	return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+}
+
+PE_BLISS_TARGET_AVX2 inline __m256i add(__m256i a, __m256i b) noexcept
+{
+	return _mm256_add_epi32(a, b);
+}
+
+PE_BLISS_TARGET_AVX2 inline __m256i bitwise_xor(__m256i a, __m256i b, __m256i c) noexcept
+{
+	return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+//Loads big-endian words [first_word, first_word + 8) of each lane block,
+//so that words[i] contains word (first_word + i) of all lanes
+PE_BLISS_TARGET_AVX2 void load_message_words(const lane_block_pointers& blocks,
+	std::size_t first_word, __m256i* words) noexcept
+{
+	std::array<__m256i, lane_count> rows;
+	for (std::size_t i = 0; i != lane_count; ++i)
+	{
+		rows[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+			blocks[i] + first_word * sizeof(std::uint32_t)));
+	}
+
+	//8x8 32-bit matrix transposition
+	const auto t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+	const auto t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+	const auto t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+	const auto t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+	const auto t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+	const auto t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+	const auto t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+	const auto t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+	const auto u0 = _mm256_unpacklo_epi64(t0, t2);
+	const auto u1 = _mm256_unpackhi_epi64(t0, t2);
+	const auto u2 = _mm256_unpacklo_epi64(t1, t3);
+	const auto u3 = _mm256_unpackhi_epi64(t1, t3);
+	const auto u4 = _mm256_unpacklo_epi64(t4, t6);
+	const auto u5 = _mm256_unpackhi_epi64(t4, t6);
+	const auto u6 = _mm256_unpacklo_epi64(t5, t7);
+	const auto u7 = _mm256_unpackhi_epi64(t5, t7);
+	words[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	words[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	words[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	words[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	words[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	words[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	words[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	words[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+
+	const auto byte_swap_mask = _mm256_setr_epi8(
+		3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+		3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	for (std::size_t i = 0; i != lane_count; ++i)
+		words[i] = _mm256_shuffle_epi8(words[i], byte_swap_mask);
+}
+
+struct sha1_multi_buffer
+{
+	static constexpr std::size_t state_words = 5u;
+	static constexpr std::array<std::uint32_t, state_words> initial_state{
+		0x67452301u, 0xefcdab89u, 0x98badcfeu, 0x10325476u, 0xc3d2e1f0u };
+
+	PE_BLISS_TARGET_AVX2 static void compress(__m256i* state,
+		const lane_block_pointers& blocks) noexcept
+	{
+		__m256i w[16];
+		load_message_words(blocks, 0u, w);
+		load_message_words(blocks, 8u, w + 8);
+
+		auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+		for (std::size_t t = 0; t != 80u; ++t)
+		{
+			if (t >= 16u)
+			{
+				w[t & 15u] = rotl<1>(_mm256_xor_si256(
+					bitwise_xor(w[(t - 3u) & 15u], w[(t - 8u) & 15u], w[(t - 14u) & 15u]),
+					w[t & 15u]));
+			}
+
+			__m256i f, k;
+			if (t < 20u)
+			{
+				f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+				k = _mm256_set1_epi32(0x5a827999);
+			}
+			else if (t < 40u)
+			{
+				f = bitwise_xor(b, c, d);
+				k = _mm256_set1_epi32(0x6ed9eba1);
+			}
+			else if (t < 60u)
+			{
+				f = _mm256_or_si256(_mm256_and_si256(b, c),
+					_mm256_and_si256(d, _mm256_or_si256(b, c)));
+				k = _mm256_set1_epi32(static_cast<int>(0x8f1bbcdcu));
+			}
+			else
+			{
+				f = bitwise_xor(b, c, d);
+				k = _mm256_set1_epi32(static_cast<int>(0xca62c1d6u));
+			}
+
+			const auto temp = add(add(rotl<5>(a), f), add(add(e, k), w[t & 15u]));
+			e = d;
+			d = c;
+			c = rotl<30>(b);
+			b = a;
+			a = temp;
+		}
+
+		state[0] = add(state[0], a);
+		state[1] = add(state[1], b);
+		state[2] = add(state[2], c);
+		state[3] = add(state[3], d);
+		state[4] = add(state[4], e);
+	}
+};
+
+struct sha256_multi_buffer
+{
+	static constexpr std::size_t state_words = 8u;
+	static constexpr std::array<std::uint32_t, state_words> initial_state{
+		0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au,
+		0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u };
+
+	static constexpr std::array<std::uint32_t, 64u> round_constants{
+		0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u,
+		0x923f82a4u, 0xab1c5ed5u, 0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u,
+		0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u, 0xe49b69c1u, 0xefbe4786u,
+		0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+		0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u,
+		0x06ca6351u, 0x14292967u, 0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u,
+		0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u, 0xa2bfe8a1u, 0xa81a664bu,
+		0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+		0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au,
+		0x5b9cca4fu, 0x682e6ff3u, 0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u,
+		0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u
+	};
+
+	PE_BLISS_TARGET_AVX2 static void compress(__m256i* state,
+		const lane_block_pointers& blocks) noexcept
+	{
+		__m256i w[16];
+		load_message_words(blocks, 0u, w);
+		load_message_words(blocks, 8u, w + 8);
+
+		auto a = state[0], b = state[1], c = state[2], d = state[3];
+		auto e = state[4], f = state[5], g = state[6], h = state[7];
+		for (std::size_t t = 0; t != 64u; ++t)
+		{
+			if (t >= 16u)
+			{
+				const auto w15 = w[(t - 15u) & 15u];
+				const auto w2 = w[(t - 2u) & 15u];
+				const auto s0 = bitwise_xor(rotr<7>(w15), rotr<18>(w15),
+					_mm256_srli_epi32(w15, 3));
+				const auto s1 = bitwise_xor(rotr<17>(w2), rotr<19>(w2),
+					_mm256_srli_epi32(w2, 10));
+				w[t & 15u] = add(add(w[t & 15u], s0), add(w[(t - 7u) & 15u], s1));
+			}
+
+			const auto sum1 = bitwise_xor(rotr<6>(e), rotr<11>(e), rotr<25>(e));
+			const auto ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+			const auto t1 = add(add(add(h, sum1), add(ch, w[t & 15u])),
+				_mm256_set1_epi32(static_cast<int>(round_constants[t])));
+			const auto sum0 = bitwise_xor(rotr<2>(a), rotr<13>(a), rotr<22>(a));
+			const auto maj = _mm256_or_si256(_mm256_and_si256(a, b),
+				_mm256_and_si256(c, _mm256_or_si256(a, b)));
+			h = g;
+			g = f;
+			f = e;
+			e = add(d, t1);
+			d = c;
+			c = b;
+			b = a;
+			a = add(t1, add(sum0, maj));
+		}
+
+		state[0] = add(state[0], a);
+		state[1] = add(state[1], b);
+		state[2] = add(state[2], c);
+		state[3] = add(state[3], d);
+		state[4] = add(state[4], e);
+		state[5] = add(state[5], f);
+		state[6] = add(state[6], g);
+		state[7] = add(state[7], h);
+	}
+};
+
+//All messages must have the same size
+template<typename Algorithm>
+PE_BLISS_TARGET_AVX2 void calculate_multi_buffer(std::span<const span_range_type> messages,
+	std::byte* digests, std::size_t digest_stride) noexcept
+{
+	//Unused lanes hash the first message
+	std::array<lane_blocks, lane_count> lanes;
+	for (std::size_t i = 0; i != lane_count; ++i)
+		lanes[i].init(messages[i < messages.size() ? i : 0u]);
+
+	__m256i state[Algorithm::state_words];
+	for (std::size_t i = 0; i != Algorithm::state_words; ++i)
+		state[i] = _mm256_set1_epi32(static_cast<int>(Algorithm::initial_state[i]));
+
+	lane_block_pointers blocks;
+	const auto block_count = lanes[0].get_block_count();
+	for (std::size_t block = 0; block != block_count; ++block)
+	{
+		for (std::size_t i = 0; i != lane_count; ++i)
+			blocks[i] = lanes[i].get_block(block);
+		Algorithm::compress(state, blocks);
+	}
+
+	alignas(32) std::array<std::uint32_t, lane_count> words;
+	for (std::size_t word = 0; word != Algorithm::state_words; ++word)
+	{
+		_mm256_store_si256(reinterpret_cast<__m256i*>(words.data()), state[word]);
+		for (std::size_t i = 0; i != messages.size(); ++i)
+		{
+			auto* digest = digests + i * digest_stride + word * sizeof(std::uint32_t);
+			digest[0] = static_cast<std::byte>(words[i] >> 24u);
+			digest[1] = static_cast<std::byte>(words[i] >> 16u);
+			digest[2] = static_cast<std::byte>(words[i] >> 8u);
+			digest[3] = static_cast<std::byte>(words[i]);
+		}
+	}
+}
+
+#endif //PE_BLISS_PAGE_HASH_X86
+
+std::unique_ptr<CryptoPP::HashTransformation> create_hash(digest_algorithm algorithm)
+{
+	switch (algorithm)
+	{
+	case digest_algorithm::md5:
+		return std::make_unique<CryptoPP::Weak::MD5>();
+	case digest_algorithm::sha1:
+		return std::make_unique<CryptoPP::SHA1>();
+	case digest_algorithm::sha256:
+		return std::make_unique<CryptoPP::SHA256>();
+	case digest_algorithm::sha384:
+		return std::make_unique<CryptoPP::SHA384>();
+	case digest_algorithm::sha512:
+		return std::make_unique<CryptoPP::SHA512>();
+	default:
+		throw pe_error(buffer_hash_errc::unsupported_hash_algorithm);
+	}
+}
+
+} //namespace
+
+page_hash_engine::page_hash_engine(digest_algorithm algorithm,
+	page_hash_engine_type type)
+	: algorithm_(algorithm)
+	, hash_(create_hash(algorithm))
+	, digest_size_(hash_->DigestSize())
+{
+	switch (type)
+	{
+	case page_hash_engine_type::automatic:
+		//Single-buffer SHA extensions are on par with or faster
+		//than the multi-buffer AVX2 implementation
+		multi_buffer_ = is_multi_buffer_supported(algorithm)
+			&& !get_cpu_features().sha;
+		break;
+	case page_hash_engine_type::multi_buffer:
+		multi_buffer_ = is_multi_buffer_supported(algorithm);
+		break;
+	default:
+		break;
+	}
+}
+
+page_hash_engine::~page_hash_engine() = default;
+
+bool page_hash_engine::is_multi_buffer_supported(digest_algorithm algorithm) noexcept
+{
+	return (algorithm == digest_algorithm::sha1 || algorithm == digest_algorithm::sha256)
+		&& get_cpu_features().avx2;
+}
+
+void page_hash_engine::calculate(std::span<const span_range_type> messages,
+	std::byte* digests, std::size_t digest_stride)
+{
+	std::size_t index = 0;
+	while (index != messages.size())
+	{
+		std::size_t count = 1u;
+		if (multi_buffer_)
+		{
+			while (count != max_lanes && index + count != messages.size()
+				&& messages[index + count].size() == messages[index].size())
+			{
+				++count;
+			}
+		}
+
+		auto* digest = digests + index * digest_stride;
+#ifdef PE_BLISS_PAGE_HASH_X86
+		if (count > 1u)
+		{
+			const auto lanes = messages.subspan(index, count);
+			if (algorithm_ == digest_algorithm::sha1)
+				calculate_multi_buffer<sha1_multi_buffer>(lanes, digest, digest_stride);
+			else
+				calculate_multi_buffer<sha256_multi_buffer>(lanes, digest, digest_stride);
+			index += count;
+			continue;
+		}
+#endif //PE_BLISS_PAGE_HASH_X86
+
+		const auto& message = messages[index];
+		hash_->Update(reinterpret_cast<const CryptoPP::byte*>(message.data()),
+			message.size());
+		hash_->Final(reinterpret_cast<CryptoPP::byte*>(digest));
+		++index;
+	}
+}
+
+} //namespace pe_bliss::security
@@ -8,7 +8,9 @@
 #include <exception>
 #include <iterator>
 #include <string>
+#include <memory>
 #include <system_error>
+#include <variant>
 
 #define CRYPTOPP_ENABLE_NAMESPACE_WEAK 1
 #include "cryptopp/asn.h"
@@ -23,6 +25,7 @@
 #include "cryptopp/sha.h"
 
 #include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
 
 namespace
 {
@@ -162,6 +165,17 @@ template<> const unsigned int CryptoPP::PKCS_DigestDecoration<IdentityMD5NoIdent
 namespace pe_bliss::security::pkcs7
 {
 
+struct ecdsa_public_key
+{
+	CryptoPP::DL_Keys_ECDSA<CryptoPP::ECP>::PublicKey key;
+	ecc_curve curve{};
+};
+
+struct decoded_public_key
+{
+	std::variant<CryptoPP::RSA::PublicKey, ecdsa_public_key> key;
+};
+
 namespace
 {
 
@@ -184,16 +198,12 @@ std::size_t get_expected_digest_size(digest_algorithm digest_alg) noexcept
 	}
 }
 
-signature_verification_result verify_rsa_signature(CryptoPP::ArraySource& key_bytes,
+signature_verification_result verify_rsa_signature(
+	const CryptoPP::RSA::PublicKey& public_key,
 	std::span<const std::byte> message_digest,
 	std::span<const std::byte> encrypted_digest,
 	digest_algorithm digest_alg)
 {
-	if (get_expected_digest_size(digest_alg) != message_digest.size())
-		throw pe_error(signature_validator_errc::invalid_signature);
-
-	CryptoPP::RSA::PublicKey public_key;
-	public_key.BERDecodePublicKey(key_bytes, false, 0u);
 	signature_verification_result result;
 	result.key_size = public_key.GetModulus().BitCount();
 	switch (digest_alg)
@@ -314,14 +324,48 @@ bool vericy_ecdsa_signature(const CryptoPP::DL_Keys_ECDSA<CryptoPP::ECP>::Public
 
 } //namespace
 
-signature_verification_result verify_ecdsa_signature(CryptoPP::ArraySource& key_bytes,
+signature_verification_result verify_ecdsa_signature(
+	const ecdsa_public_key& public_key,
 	std::span<const std::byte> message_digest,
 	std::span<const std::byte> encrypted_digest,
-	digest_algorithm digest_alg,
-	std::span<const std::byte> signature_algorithm_parameters)
+	digest_algorithm digest_alg)
 {
-	if (get_expected_digest_size(digest_alg) != message_digest.size())
+	signature_verification_result result;
+	result.curve = public_key.curve;
+
+	switch (digest_alg)
+	{
+	case digest_algorithm::sha1:
+		result.valid = vericy_ecdsa_signature<IdentitySHA1>(public_key.key,
+			message_digest, encrypted_digest);
+		break;
+	case digest_algorithm::sha256:
+		result.valid = vericy_ecdsa_signature<IdentitySHA256>(public_key.key,
+			message_digest, encrypted_digest);
+		break;
+	default:
 		throw pe_error(signature_validator_errc::invalid_signature);
+	}
+
+	return result;
+}
+
+std::shared_ptr<const decoded_public_key> decode_public_key(
+	std::span<const std::byte> raw_public_key,
+	digest_encryption_algorithm encryption_alg,
+	std::span<const std::byte> signature_algorithm_parameters)
+{
+	CryptoPP::ArraySource key_bytes(
+		reinterpret_cast<const CryptoPP::byte*>(raw_public_key.data()),
+		raw_public_key.size(), true);
+
+	auto result = std::make_shared<decoded_public_key>();
+	if (encryption_alg == digest_encryption_algorithm::rsa)
+	{
+		auto& public_key = result->key.emplace<CryptoPP::RSA::PublicKey>();
+		public_key.BERDecodePublicKey(key_bytes, false, 0u);
+		return result;
+	}
 
 	if (signature_algorithm_parameters.empty())
 		throw pe_error(signature_validator_errc::invalid_signature);
@@ -332,29 +376,45 @@ signature_verification_result verify_ecdsa_signature(CryptoPP::ArraySource& key_
 		signature_algorithm_parameters.size(), true);
 	oid.BERDecode(signature_algorithm_parameters_bytes);
 
-	CryptoPP::DL_Keys_ECDSA<CryptoPP::ECP>::PublicKey pk;
 	CryptoPP::ECP::Point q;
 	CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> params(oid);
 	if (!params.GetCurve().DecodePoint(q, key_bytes, key_bytes.TotalBytesRetrievable()))
 		throw pe_error(signature_validator_errc::invalid_signature);
 
-	pk.Initialize(params, q);
+	auto& public_key = result->key.emplace<ecdsa_public_key>();
+	public_key.key.Initialize(params, q);
+	public_key.curve = get_ecc_curve(oid);
+	return result;
+}
 
-	signature_verification_result result;
-	result.curve = get_ecc_curve(oid);
+template<typename... Spans>
+signature_verification_cache::hash_type calculate_cache_hash(const Spans&... data)
+{
+	signature_verification_cache::hash_type result;
+	static_assert(std::tuple_size_v<decltype(result)> == CryptoPP::SHA256::DIGESTSIZE);
+	CryptoPP::SHA256 hash;
+	(hash.Update(reinterpret_cast<const CryptoPP::byte*>(data.data()), data.size()), ...);
+	hash.Final(reinterpret_cast<CryptoPP::byte*>(result.data()));
+	return result;
+}
 
-	switch (digest_alg)
+std::shared_ptr<const decoded_public_key> get_public_key(
+	std::span<const std::byte> raw_public_key,
+	digest_encryption_algorithm encryption_alg,
+	std::span<const std::byte> signature_algorithm_parameters,
+	const signature_verification_cache::hash_type* key_hash,
+	signature_verification_cache* cache)
+{
+	if (!cache)
+		return decode_public_key(raw_public_key, encryption_alg, signature_algorithm_parameters);
+
+	auto result = cache->find_public_key(*key_hash);
+	if (!result)
 	{
-	case digest_algorithm::sha1:
-		result.valid = vericy_ecdsa_signature<IdentitySHA1>(pk, message_digest, encrypted_digest);
-		break;
-	case digest_algorithm::sha256:
-		result.valid = vericy_ecdsa_signature<IdentitySHA256>(pk, message_digest, encrypted_digest);
-		break;
-	default:
-		throw pe_error(signature_validator_errc::invalid_signature);
+		result = decode_public_key(raw_public_key, encryption_alg,
+			signature_algorithm_parameters);
+		cache->add_public_key(*key_hash, result);
 	}
-
 	return result;
 }
 
@@ -370,28 +430,65 @@ signature_verification_result verify_signature(std::span<const std::byte> raw_pu
 	std::span<const std::byte> encrypted_digest,
 	digest_algorithm digest_alg,
 	digest_encryption_algorithm encryption_alg,
-	std::span<const std::byte> signature_algorithm_parameters)
+	std::span<const std::byte> signature_algorithm_parameters,
+	signature_verification_cache* cache)
 {
 	if (message_digest.empty() || encrypted_digest.empty() || raw_public_key.empty())
 		throw pe_error(signature_validator_errc::invalid_signature);
 
+	if (encryption_alg != digest_encryption_algorithm::rsa
+		&& encryption_alg != digest_encryption_algorithm::ecdsa)
+	{
+		throw pe_error(signature_validator_errc::unsupported_signature_algorithm);
+	}
+
+	if (get_expected_digest_size(digest_alg) != message_digest.size())
+		throw pe_error(signature_validator_errc::invalid_signature);
+
+	signature_verification_cache::hash_type key_hash, signature_hash;
+	if (cache)
+	{
+		//Algorithm parameters are only relevant for ECDSA keys
+		const std::array key_header{ static_cast<std::byte>(encryption_alg) };
+		if (encryption_alg == digest_encryption_algorithm::ecdsa)
+		{
+			const std::array params_size{
+				static_cast<std::byte>(signature_algorithm_parameters.size() & 0xffu),
+				static_cast<std::byte>((signature_algorithm_parameters.size() >> 8u) & 0xffu),
+				static_cast<std::byte>((signature_algorithm_parameters.size() >> 16u) & 0xffu),
+				static_cast<std::byte>((signature_algorithm_parameters.size() >> 24u) & 0xffu)
+			};
+			key_hash = calculate_cache_hash(key_header, params_size,
+				signature_algorithm_parameters, raw_public_key);
+		}
+		else
+		{
+			key_hash = calculate_cache_hash(key_header, raw_public_key);
+		}
+
+		//Message digest size is defined by the digest algorithm
+		const std::array digest_header{ static_cast<std::byte>(digest_alg) };
+		signature_hash = calculate_cache_hash(key_hash, digest_header,
+			message_digest, encrypted_digest);
+		if (auto result = cache->find_result(signature_hash); result)
+			return *result;
+	}
+
+	signature_verification_result result;
 	try
 	{
-		CryptoPP::ArraySource key_bytes(
-			reinterpret_cast<const CryptoPP::byte*>(raw_public_key.data()),
-			raw_public_key.size(), true);
+		const auto public_key = get_public_key(raw_public_key, encryption_alg,
+			signature_algorithm_parameters, &key_hash, cache);
 
-		if (encryption_alg == digest_encryption_algorithm::rsa)
+		if (const auto* rsa_key = std::get_if<CryptoPP::RSA::PublicKey>(&public_key->key))
 		{
-			return verify_rsa_signature(key_bytes,
+			result = verify_rsa_signature(*rsa_key,
 				message_digest, encrypted_digest, digest_alg);
 		}
-
-		if (encryption_alg == digest_encryption_algorithm::ecdsa)
+		else
 		{
-			return verify_ecdsa_signature(key_bytes,
-				message_digest, encrypted_digest, digest_alg,
-				signature_algorithm_parameters);
+			result = verify_ecdsa_signature(std::get<ecdsa_public_key>(public_key->key),
+				message_digest, encrypted_digest, digest_alg);
 		}
 	}
 	catch (const CryptoPP::Exception&)
@@ -399,7 +496,10 @@ signature_verification_result verify_signature(std::span<const std::byte> raw_pu
 		std::throw_with_nested(pe_error(signature_validator_errc::invalid_signature));
 	}
 
-	throw pe_error(signature_validator_errc::unsupported_signature_algorithm);
+	if (cache)
+		cache->add_result(signature_hash, result);
+
+	return result;
 }
 
 } //namespace pe_bliss::security::pkcs7
@@ -56,41 +56,14 @@ std::error_code make_error_code(security_directory_loader_errc e) noexcept
 	return { static_cast<int>(e), security_directory_loader_error_category_instance };
 }
 
-std::optional<security_directory_details> load(const image::image& instance,
-	const loader_options& options)
+namespace
 {
-	std::optional<security_directory_details> result;
-	if (!instance.get_data_directories().has_security())
-		return result;
-
-	const auto& security_dir_info = instance.get_data_directories().get_directory(
-		core::data_directories::directory_type::security);
-
-	auto& directory = result.emplace();
-
-	auto overlay_data = instance.get_overlay().data();
-	utilities::safe_uint overlay_offset = overlay_data->absolute_offset();
-	if (!overlay_data->size() || security_dir_info->virtual_address < overlay_offset)
-	{
-		directory.add_error(security_directory_loader_errc::invalid_directory);
-		return result;
-	}
-
-	buffers::input_buffer_stateful_wrapper_ref ref(*overlay_data);
-	try
-	{
-		ref.set_rpos(security_dir_info->virtual_address - overlay_offset.value());
-	}
-	catch (const std::system_error&)
-	{
-		directory.add_error(security_directory_loader_errc::invalid_directory);
-		return result;
-	}
-
-	if (!utilities::math::is_aligned<sizeof(std::uint64_t)>(security_dir_info->virtual_address))
-		directory.add_error(security_directory_loader_errc::unaligned_directory);
+void load_entries(const buffers::input_buffer_ptr& data,
+	buffers::input_buffer_stateful_wrapper_ref& ref, std::size_t size,
+	security_directory_details& directory, const loader_options& options)
+{
+	utilities::safe_uint data_offset = data->absolute_offset();
 
-	std::size_t size = security_dir_info->size;
 	static constexpr auto descriptor_size = security_directory_details
 		::certificate_entry_list_type::value_type::descriptor_type::packed_size;
 	auto max_entries = options.max_entries;
@@ -99,19 +72,19 @@ std::optional<security_directory_details> load(const image::image& instance,
 		if (!max_entries--)
 		{
 			directory.add_error(security_directory_loader_errc::too_many_entries);
-			return result;
+			return;
 		}
 
 		auto& entry = directory.get_entries().emplace_back();
 		try
 		{
 			entry.get_descriptor().deserialize(ref, false);
-			overlay_offset += descriptor_size;
+			data_offset += descriptor_size;
 		}
 		catch (const std::system_error&)
 		{
 			entry.add_error(security_directory_loader_errc::invalid_entry);
-			return result;
+			return;
 		}
 
 		size -= descriptor_size;
@@ -119,7 +92,7 @@ std::optional<security_directory_details> load(const image::image& instance,
 		if (!entry_size)
 		{
 			directory.get_entries().pop_back();
-			return result;
+			return;
 		}
 
 		if (entry_size < descriptor_size)
@@ -134,19 +107,22 @@ std::optional<security_directory_details> load(const image::image& instance,
 			if (certificate_size > size)
 			{
 				entry.add_error(security_directory_loader_errc::invalid_entry_size);
-				return result;
+				return;
 			}
 
 			try
 			{
-				entry.get_certificate().deserialize(buffers::reduce(overlay_data,
-					ref.rpos(), certificate_size), options.copy_raw_data);
+				auto certificate = buffers::reduce(data, ref.rpos(), certificate_size);
+				if (!options.copy_raw_data && options.copy_non_contiguous_raw_data)
+					entry.get_certificate().deserialize_contiguous(certificate);
+				else
+					entry.get_certificate().deserialize(certificate, options.copy_raw_data);
 				ref.advance_rpos(static_cast<std::int32_t>(certificate_size));
 			}
 			catch (const std::system_error&)
 			{
 				entry.add_error(security_directory_loader_errc::invalid_certificate_data);
-				return result;
+				return;
 			}
 		}
 
@@ -156,10 +132,10 @@ std::optional<security_directory_details> load(const image::image& instance,
 		{
 			try
 			{
-				overlay_offset += certificate_size;
-				auto old_offset = overlay_offset.value();
-				overlay_offset.align_up(sizeof(std::uint64_t));
-				std::size_t alignment_size = overlay_offset.value() - old_offset;
+				data_offset += certificate_size;
+				auto old_offset = data_offset.value();
+				data_offset.align_up(sizeof(std::uint64_t));
+				std::size_t alignment_size = data_offset.value() - old_offset;
 				if (size < alignment_size)
 					break;
 				ref.advance_rpos(static_cast<std::int32_t>(alignment_size));
@@ -168,15 +144,64 @@ std::optional<security_directory_details> load(const image::image& instance,
 			catch (const std::system_error&)
 			{
 				entry.add_error(security_directory_loader_errc::invalid_entry);
-				return result;
+				return;
 			}
 		}
 	}
 
 	if (size)
 		directory.add_error(security_directory_loader_errc::invalid_directory_size);
+}
+} //namespace
+
+std::optional<security_directory_details> load(const image::image& instance,
+	const loader_options& options)
+{
+	std::optional<security_directory_details> result;
+	if (!instance.get_data_directories().has_security())
+		return result;
+
+	const auto& security_dir_info = instance.get_data_directories().get_directory(
+		core::data_directories::directory_type::security);
+
+	auto& directory = result.emplace();
+
+	auto overlay_data = instance.get_overlay().data();
+	const auto overlay_offset = overlay_data->absolute_offset();
+	if (!overlay_data->size() || security_dir_info->virtual_address < overlay_offset)
+	{
+		directory.add_error(security_directory_loader_errc::invalid_directory);
+		return result;
+	}
+
+	buffers::input_buffer_stateful_wrapper_ref ref(*overlay_data);
+	try
+	{
+		ref.set_rpos(security_dir_info->virtual_address - overlay_offset);
+	}
+	catch (const std::system_error&)
+	{
+		directory.add_error(security_directory_loader_errc::invalid_directory);
+		return result;
+	}
 
+	if (!utilities::math::is_aligned<sizeof(std::uint64_t)>(security_dir_info->virtual_address))
+		directory.add_error(security_directory_loader_errc::unaligned_directory);
+
+	load_entries(overlay_data, ref, security_dir_info->size, directory, options);
 	return result;
 }
 
+security_directory_details load(const buffers::input_buffer_ptr& directory_data,
+	const loader_options& options)
+{
+	security_directory_details directory;
+	if (!utilities::math::is_aligned<sizeof(std::uint64_t)>(directory_data->absolute_offset()))
+		directory.add_error(security_directory_loader_errc::unaligned_directory);
+
+	buffers::input_buffer_stateful_wrapper_ref ref(*directory_data);
+	load_entries(directory_data, ref, directory_data->size(), directory, options);
+	return directory;
+}
+
 } //namespace pe_bliss::security
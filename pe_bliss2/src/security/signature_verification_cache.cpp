@@ -0,0 +1,98 @@
+#include "pe_bliss2/security/signature_verification_cache.h"
+
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+namespace pe_bliss::security
+{
+
+std::size_t signature_verification_cache::hash_hasher::operator()(
+	const hash_type& hash) const noexcept
+{
+	//Keys are cryptographic hashes already
+	std::size_t result;
+	static_assert(sizeof(result) <= std::tuple_size_v<hash_type>);
+	std::memcpy(&result, hash.data(), sizeof(result));
+	return result;
+}
+
+signature_verification_cache::signature_verification_cache(
+	std::size_t max_entries) noexcept
+	: max_entries_(max_entries)
+{
+}
+
+signature_verification_cache::public_key_ptr_type
+signature_verification_cache::find_public_key(const hash_type& key_hash) const
+{
+	{
+		std::shared_lock lock(mutex_);
+		if (auto it = public_keys_.find(key_hash); it != public_keys_.end())
+		{
+			++public_key_hits_;
+			return it->second;
+		}
+	}
+
+	++public_key_misses_;
+	return {};
+}
+
+void signature_verification_cache::add_public_key(
+	const hash_type& key_hash, public_key_ptr_type key)
+{
+	std::unique_lock lock(mutex_);
+	if (public_keys_.size() >= max_entries_)
+		public_keys_.clear();
+	public_keys_.try_emplace(key_hash, std::move(key));
+}
+
+std::optional<pkcs7::signature_verification_result>
+signature_verification_cache::find_result(const hash_type& signature_hash) const
+{
+	{
+		std::shared_lock lock(mutex_);
+		if (auto it = results_.find(signature_hash); it != results_.end())
+		{
+			++result_hits_;
+			return it->second;
+		}
+	}
+
+	++result_misses_;
+	return {};
+}
+
+void signature_verification_cache::add_result(const hash_type& signature_hash,
+	const pkcs7::signature_verification_result& result)
+{
+	std::unique_lock lock(mutex_);
+	if (results_.size() >= max_entries_)
+		results_.clear();
+	results_.try_emplace(signature_hash, result);
+}
+
+signature_verification_cache::statistics
+signature_verification_cache::get_statistics() const noexcept
+{
+	return {
+		.public_key_hits = public_key_hits_,
+		.public_key_misses = public_key_misses_,
+		.result_hits = result_hits_,
+		.result_misses = result_misses_
+	};
+}
+
+void signature_verification_cache::clear()
+{
+	std::unique_lock lock(mutex_);
+	public_keys_.clear();
+	results_.clear();
+	public_key_hits_ = 0u;
+	public_key_misses_ = 0u;
+	result_hits_ = 0u;
+	result_misses_ = 0u;
+}
+
+} //namespace pe_bliss::security
@@ -0,0 +1,56 @@
+#include "pe_bliss2/security/x509/x509_chain_builder.h"
+
+#include <string>
+
+namespace
+{
+
+struct x509_chain_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "x509_chain";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::x509::x509_chain_errc;
+		switch (static_cast<pe_bliss::security::x509::x509_chain_errc>(ev))
+		{
+		case issuer_not_found:
+			return "Certificate issuer was not found";
+		case untrusted_root:
+			return "Certificate chain ends with an untrusted root certificate";
+		case chain_too_long:
+			return "Certificate chain is too long";
+		case certificate_not_yet_valid:
+			return "Certificate is not yet valid";
+		case certificate_expired:
+			return "Certificate has expired";
+		case invalid_certificate_signature:
+			return "Invalid certificate signature";
+		case unable_to_verify_certificate_signature:
+			return "Unable to verify certificate signature";
+		case issuer_is_not_ca:
+			return "Certificate issuer is not a CA certificate or is not allowed to sign certificates";
+		case path_length_exceeded:
+			return "Certificate issuer path length constraint is exceeded";
+		default:
+			return {};
+		}
+	}
+};
+
+const x509_chain_error_category x509_chain_error_category_instance;
+
+} //namespace
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_chain_errc e) noexcept
+{
+	return { static_cast<int>(e), x509_chain_error_category_instance };
+}
+
+} //namespace pe_bliss::security::x509
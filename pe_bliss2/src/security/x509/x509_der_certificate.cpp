@@ -0,0 +1,287 @@
+#include "pe_bliss2/security/x509/x509_der_certificate.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/der_helpers.h"
+#include "pe_bliss2/security/x509/x509_key_identifiers.h"
+
+namespace
+{
+
+struct x509_der_certificate_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "x509_der_certificate";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::x509::x509_der_certificate_errc;
+		switch (static_cast<pe_bliss::security::x509::x509_der_certificate_errc>(ev))
+		{
+		case invalid_certificate:
+			return "Invalid certificate";
+		case invalid_validity:
+			return "Invalid certificate validity period";
+		case invalid_extension:
+			return "Invalid certificate extension";
+		default:
+			return {};
+		}
+	}
+};
+
+const x509_der_certificate_error_category x509_der_certificate_error_category_instance;
+
+using pe_bliss::security::span_range_type;
+using pe_bliss::security::x509::x509_der_certificate_errc;
+namespace der = pe_bliss::security::der;
+
+[[noreturn]] void throw_error(x509_der_certificate_errc errc)
+{
+	throw pe_bliss::pe_error(errc);
+}
+
+void read_required(span_range_type& data, std::byte tag, der::element& result)
+{
+	if (!der::read_element(data, tag, result))
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+}
+
+//Skips the element if it has the specified tag
+void skip_optional(span_range_type& data, std::byte tag)
+{
+	der::element element;
+	if (!data.empty() && data[0] == tag)
+		read_required(data, tag, element);
+}
+
+//BIT STRING value without the unused bits byte (must be zero)
+span_range_type read_bit_string_bytes(const der::element& bit_string)
+{
+	if (bit_string.value.empty() || bit_string.value[0] != std::byte{})
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+	return bit_string.value.subspan(1u);
+}
+
+pe_bliss::security::encryption_and_hash_algorithm read_algorithm_identifier(
+	span_range_type algorithm_identifier,
+	std::optional<span_range_type>* parameters = nullptr)
+{
+	der::element algorithm;
+	std::vector<std::uint32_t> oid;
+	read_required(algorithm_identifier, der::tag::object_identifier, algorithm);
+	if (!der::decode_oid(algorithm.value, oid))
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+
+	if (!algorithm_identifier.empty())
+	{
+		der::element algorithm_parameters;
+		if (!der::read_element(algorithm_identifier, algorithm_parameters)
+			|| !algorithm_identifier.empty())
+		{
+			throw_error(x509_der_certificate_errc::invalid_certificate);
+		}
+
+		if (parameters)
+			*parameters = algorithm_parameters.raw;
+	}
+
+	return pe_bliss::security::get_digest_encryption_algorithm(oid);
+}
+
+bool read_digits(span_range_type& text, std::size_t count, int& result) noexcept
+{
+	if (text.size() < count)
+		return false;
+
+	result = 0;
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		const auto digit = std::to_integer<char>(text[i]);
+		if (digit < '0' || digit > '9')
+			return false;
+		result = result * 10 + (digit - '0');
+	}
+	text = text.subspan(count);
+	return true;
+}
+
+//UTCTime (YYMMDDHHMMSSZ) or GeneralizedTime (YYYYMMDDHHMMSSZ), as required by RFC 5280
+std::chrono::sys_seconds read_time(span_range_type& data)
+{
+	der::element time;
+	if (!der::read_element(data, time)
+		|| (time.tag != der::tag::utc_time && time.tag != der::tag::generalized_time))
+	{
+		throw_error(x509_der_certificate_errc::invalid_validity);
+	}
+
+	auto text = time.value;
+	int year{}, month{}, day{}, hour{}, minute{}, second{};
+	bool valid{};
+	if (time.tag == der::tag::utc_time)
+	{
+		valid = read_digits(text, 2u, year);
+		year += year < 50 ? 2000 : 1900;
+	}
+	else
+	{
+		valid = read_digits(text, 4u, year);
+	}
+
+	valid = valid
+		&& read_digits(text, 2u, month)
+		&& read_digits(text, 2u, day)
+		&& read_digits(text, 2u, hour)
+		&& read_digits(text, 2u, minute)
+		&& read_digits(text, 2u, second)
+		&& text.size() == 1u && text[0] == std::byte{ 'Z' };
+
+	const std::chrono::year_month_day date{ std::chrono::year(year),
+		std::chrono::month(static_cast<unsigned>(month)),
+		std::chrono::day(static_cast<unsigned>(day)) };
+	if (!valid || !date.ok() || hour > 23 || minute > 59 || second > 59)
+		throw_error(x509_der_certificate_errc::invalid_validity);
+
+	return std::chrono::sys_days(date) + std::chrono::hours(hour)
+		+ std::chrono::minutes(minute) + std::chrono::seconds(second);
+}
+
+} //namespace
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_der_certificate_errc e) noexcept
+{
+	return { static_cast<int>(e), x509_der_certificate_error_category_instance };
+}
+
+x509_der_certificate::x509_der_certificate(span_range_type data)
+	: data_(data)
+{
+	der::element certificate, tbs_certificate, signature_algorithm, signature_value;
+	read_required(data, der::tag::sequence, certificate);
+	if (!data.empty())
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+
+	auto fields = certificate.value;
+	read_required(fields, der::tag::sequence, tbs_certificate);
+	read_required(fields, der::tag::sequence, signature_algorithm);
+	read_required(fields, der::tag::bit_string, signature_value);
+	if (!fields.empty())
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+
+	raw_tbs_certificate_ = tbs_certificate.raw;
+	signature_algorithm_ = read_algorithm_identifier(signature_algorithm.value);
+	signature_value_ = read_bit_string_bytes(signature_value);
+
+	der::element serial_number, tbs_signature, issuer, validity, subject,
+		public_key_info, public_key_algorithm, public_key;
+	auto tbs_fields = tbs_certificate.value;
+	//version [0] EXPLICIT Version DEFAULT v1
+	skip_optional(tbs_fields, der::tag::context_specific(0u, true));
+	read_required(tbs_fields, der::tag::integer, serial_number);
+	read_required(tbs_fields, der::tag::sequence, tbs_signature);
+	read_required(tbs_fields, der::tag::sequence, issuer);
+	read_required(tbs_fields, der::tag::sequence, validity);
+	read_required(tbs_fields, der::tag::sequence, subject);
+	read_required(tbs_fields, der::tag::sequence, public_key_info);
+	serial_number_ = serial_number.value;
+	raw_issuer_ = issuer.raw;
+	raw_subject_ = subject.raw;
+
+	auto validity_fields = validity.value;
+	not_before_ = read_time(validity_fields);
+	not_after_ = read_time(validity_fields);
+	if (!validity_fields.empty())
+		throw_error(x509_der_certificate_errc::invalid_validity);
+
+	auto public_key_fields = public_key_info.value;
+	read_required(public_key_fields, der::tag::sequence, public_key_algorithm);
+	read_required(public_key_fields, der::tag::bit_string, public_key);
+	if (!public_key_fields.empty())
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+	public_key_algorithm_ = read_algorithm_identifier(public_key_algorithm.value,
+		&public_key_parameters_);
+	public_key_ = read_bit_string_bytes(public_key);
+
+	//issuerUniqueID [1] IMPLICIT, subjectUniqueID [2] IMPLICIT
+	skip_optional(tbs_fields, der::tag::context_specific(1u, false));
+	skip_optional(tbs_fields, der::tag::context_specific(2u, false));
+
+	//extensions [3] EXPLICIT Extensions OPTIONAL
+	if (!tbs_fields.empty())
+	{
+		der::element extensions_field, extensions;
+		read_required(tbs_fields, der::tag::context_specific(3u, true), extensions_field);
+		read_required(extensions_field.value, der::tag::sequence, extensions);
+		if (!extensions_field.value.empty())
+			throw_error(x509_der_certificate_errc::invalid_extension);
+		read_extensions(extensions.value);
+	}
+
+	if (!tbs_fields.empty())
+		throw_error(x509_der_certificate_errc::invalid_certificate);
+}
+
+void x509_der_certificate::read_extensions(span_range_type extensions)
+{
+	std::vector<std::vector<std::uint32_t>> oids;
+	std::vector<der::element> fields;
+	while (!extensions.empty())
+	{
+		//Extension ::= SEQUENCE { extnID OBJECT IDENTIFIER,
+		//	critical BOOLEAN DEFAULT FALSE, extnValue OCTET STRING }
+		der::element extension;
+		fields.clear();
+		if (!der::read_element(extensions, der::tag::sequence, extension)
+			|| !der::read_children(extension.value, fields)
+			|| fields.size() < 2u || fields.size() > 3u
+			|| fields.front().tag != der::tag::object_identifier
+			|| fields.back().tag != der::tag::octet_string
+			|| (fields.size() == 3u && fields[1].tag != der::tag::boolean))
+		{
+			throw_error(x509_der_certificate_errc::invalid_extension);
+		}
+
+		auto& oid = oids.emplace_back();
+		if (!der::decode_oid(fields.front().value, oid))
+			throw_error(x509_der_certificate_errc::invalid_extension);
+
+		//RFC 5280: a certificate must not include more than one instance
+		//of a particular extension
+		if (std::ranges::find(oids.cbegin(), oids.cend() - 1, oid) != oids.cend() - 1)
+			throw_error(x509_der_certificate_errc::invalid_extension);
+
+		const auto value = fields.back().value;
+		if (std::ranges::equal(oid, oid_basic_constraints))
+		{
+			basic_constraints_ = decode_basic_constraints(value);
+			if (!basic_constraints_)
+				throw_error(x509_der_certificate_errc::invalid_extension);
+		}
+		else if (std::ranges::equal(oid, oid_key_usage))
+		{
+			key_usage_ = decode_key_usage(value);
+			if (!key_usage_)
+				throw_error(x509_der_certificate_errc::invalid_extension);
+		}
+		else if (std::ranges::equal(oid, oid_subject_key_identifier))
+		{
+			subject_key_identifier_ = decode_subject_key_identifier(value);
+		}
+		else if (std::ranges::equal(oid, oid_authority_key_identifier))
+		{
+			authority_key_identifier_ = decode_authority_key_identifier(value);
+		}
+	}
+}
+
+} //namespace pe_bliss::security::x509
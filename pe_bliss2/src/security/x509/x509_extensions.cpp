@@ -0,0 +1,89 @@
+#include "pe_bliss2/security/x509/x509_extensions.h"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "pe_bliss2/security/der_helpers.h"
+
+namespace
+{
+constexpr std::size_t max_key_usage_bits = 9u;
+} //namespace
+
+namespace pe_bliss::security::x509
+{
+
+std::optional<x509_basic_constraints> decode_basic_constraints(
+	span_range_type extension_value)
+{
+	der::element sequence;
+	std::vector<der::element> fields;
+	if (!der::read_element(extension_value, der::tag::sequence, sequence)
+		|| !extension_value.empty()
+		|| !der::read_children(sequence.value, fields)
+		|| fields.size() > 2u)
+	{
+		return {};
+	}
+
+	x509_basic_constraints result;
+	auto field = fields.cbegin();
+	if (field != fields.cend() && field->tag == der::tag::boolean)
+	{
+		if (field->value.size() != 1u)
+			return {};
+		result.ca = field->value[0] != std::byte{};
+		++field;
+	}
+
+	if (field != fields.cend())
+	{
+		//pathLenConstraint INTEGER (0..MAX)
+		const auto value = field->value;
+		if (field->tag != der::tag::integer || value.empty()
+			|| (value[0] & std::byte{ 0x80u }) != std::byte{})
+		{
+			return {};
+		}
+
+		std::uint64_t path_length{};
+		for (auto byte : value)
+		{
+			path_length = (path_length << 8u) | std::to_integer<std::uint64_t>(byte);
+			if (path_length > (std::numeric_limits<std::uint32_t>::max)())
+				return {};
+		}
+		result.path_length = static_cast<std::uint32_t>(path_length);
+		++field;
+	}
+
+	if (field != fields.cend())
+		return {};
+
+	return result;
+}
+
+std::optional<std::uint32_t> decode_key_usage(
+	span_range_type extension_value) noexcept
+{
+	der::element bit_string;
+	if (!der::read_element(extension_value, der::tag::bit_string, bit_string)
+		|| !extension_value.empty() || bit_string.value.empty()
+		|| std::to_integer<std::uint8_t>(bit_string.value[0]) > 7u)
+	{
+		return {};
+	}
+
+	//Bit 0 is the most significant bit of the first byte
+	const auto bits = bit_string.value.subspan(1u);
+	std::uint32_t result{};
+	for (std::size_t bit = 0; bit != max_key_usage_bits && bit / 8u < bits.size(); ++bit)
+	{
+		if ((bits[bit / 8u] & (std::byte{ 0x80u } >> (bit % 8u))) != std::byte{})
+			result |= 1u << bit;
+	}
+	return result;
+}
+
+} //namespace pe_bliss::security::x509
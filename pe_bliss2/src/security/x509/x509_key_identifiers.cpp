@@ -0,0 +1,45 @@
+#include "pe_bliss2/security/x509/x509_key_identifiers.h"
+
+#include <cstddef>
+
+#include "pe_bliss2/security/der_helpers.h"
+
+namespace
+{
+constexpr std::byte key_identifier_tag
+	= pe_bliss::security::der::tag::context_specific(0u, false);
+} //namespace
+
+namespace pe_bliss::security::x509
+{
+
+std::optional<span_range_type> decode_subject_key_identifier(
+	span_range_type extension_value) noexcept
+{
+	der::element value;
+	if (!der::read_element(extension_value, der::tag::octet_string, value)
+		|| !extension_value.empty())
+	{
+		return {};
+	}
+
+	return value.value;
+}
+
+std::optional<span_range_type> decode_authority_key_identifier(
+	span_range_type extension_value) noexcept
+{
+	der::element sequence, value;
+	if (!der::read_element(extension_value, der::tag::sequence, sequence)
+		|| !extension_value.empty())
+	{
+		return {};
+	}
+
+	if (!der::read_element(sequence.value, key_identifier_tag, value))
+		return {};
+
+	return value.value;
+}
+
+} //namespace pe_bliss::security::x509
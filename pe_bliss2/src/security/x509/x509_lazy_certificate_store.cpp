@@ -0,0 +1,164 @@
+#include "pe_bliss2/security/x509/x509_lazy_certificate_store.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/der_helpers.h"
+
+#include "utilities/hash.h"
+#include "utilities/range_helpers.h"
+
+namespace
+{
+
+struct x509_lazy_certificate_store_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "x509_lazy_certificate_store";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::x509::x509_lazy_certificate_store_errc;
+		switch (static_cast<pe_bliss::security::x509::x509_lazy_certificate_store_errc>(ev))
+		{
+		case invalid_certificate:
+			return "Invalid certificate";
+		case invalid_signature_format:
+			return "Invalid PKCS7 signature format";
+		case absent_certificates:
+			return "No certificates are present in the signature";
+		case duplicate_certificate:
+			return "Duplicate certificate";
+		default:
+			return {};
+		}
+	}
+};
+
+const x509_lazy_certificate_store_error_category x509_lazy_certificate_store_error_category_instance;
+
+[[noreturn]] void throw_invalid_signature_format()
+{
+	throw pe_bliss::pe_error(pe_bliss::security::x509
+		::x509_lazy_certificate_store_errc::invalid_signature_format);
+}
+
+} //namespace
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_lazy_certificate_store_errc e) noexcept
+{
+	return { static_cast<int>(e), x509_lazy_certificate_store_error_category_instance };
+}
+
+bool x509_lazy_certificate_store::sn_with_issuer_equal::operator()(
+	const sn_with_issuer& l, const sn_with_issuer& r) const noexcept
+{
+	return std::ranges::equal(l.serial_number, r.serial_number)
+		&& std::ranges::equal(l.raw_issuer, r.raw_issuer);
+}
+
+std::size_t x509_lazy_certificate_store::sn_with_issuer_hash::operator()(
+	const sn_with_issuer& data) const noexcept
+{
+	std::size_t hash = utilities::range_hash{}(data.serial_number);
+	utilities::hash_combine(hash, utilities::range_hash{}(data.raw_issuer));
+	return hash;
+}
+
+bool x509_lazy_certificate_store::add_certificate(span_range_type data)
+{
+	der::element issuer, serial_number;
+	if (!der::read_certificate_issuer_and_serial_number(data, issuer, serial_number))
+		throw pe_error(x509_lazy_certificate_store_errc::invalid_certificate);
+
+	return certificates_.try_emplace(
+		sn_with_issuer{ serial_number.value, issuer.raw },
+		certificate_entry{ .data = data }).second;
+}
+
+const x509_lazy_certificate_store::certificate_type*
+x509_lazy_certificate_store::find_certificate(span_range_type serial_number,
+	span_range_type raw_issuer) const
+{
+	auto it = certificates_.find(sn_with_issuer{ serial_number, raw_issuer });
+	if (it == certificates_.end())
+		return nullptr;
+
+	auto& entry = it->second;
+	if (!entry.certificate)
+	{
+		try
+		{
+			entry.certificate = std::make_unique<certificate_type>(entry.data);
+		}
+		catch (const pe_error&)
+		{
+			std::throw_with_nested(pe_error(
+				x509_lazy_certificate_store_errc::invalid_certificate));
+		}
+		++decoded_count_;
+	}
+
+	return entry.certificate.get();
+}
+
+x509_lazy_certificate_store build_lazy_certificate_store(span_range_type signature,
+	error_list* warnings)
+{
+	static constexpr auto context_0 = der::tag::context_specific(0u, true);
+
+	der::element content_info, signed_data;
+	std::vector<der::element> content_info_fields, signed_data_fields;
+	if (!der::read_element(signature, der::tag::sequence, content_info)
+		|| !der::read_children(content_info.value, content_info_fields)
+		|| content_info_fields.size() != 2u
+		|| content_info_fields[1].tag != context_0)
+	{
+		throw_invalid_signature_format();
+	}
+
+	auto signed_data_content = content_info_fields[1].value;
+	if (!der::read_element(signed_data_content, der::tag::sequence, signed_data)
+		|| !der::read_children(signed_data.value, signed_data_fields))
+	{
+		throw_invalid_signature_format();
+	}
+
+	//certificates [0] IMPLICIT CertificateSet OPTIONAL
+	std::vector<der::element> certificates;
+	const auto certificate_set = std::ranges::find(signed_data_fields,
+		context_0, &der::element::tag);
+	if (certificate_set != signed_data_fields.end()
+		&& !der::read_children(certificate_set->value, certificates))
+	{
+		throw_invalid_signature_format();
+	}
+
+	x509_lazy_certificate_store store;
+	store.reserve(certificates.size());
+	for (const auto& certificate : certificates)
+	{
+		//Other certificate choices (e.g., attribute certificates) are skipped
+		if (certificate.tag != der::tag::sequence)
+			continue;
+
+		if (!store.add_certificate(certificate.raw) && warnings)
+			warnings->add_error(x509_lazy_certificate_store_errc::duplicate_certificate);
+	}
+
+	if (store.empty() && warnings)
+		warnings->add_error(x509_lazy_certificate_store_errc::absent_certificates);
+
+	return store;
+}
+
+} //namespace pe_bliss::security::x509
@@ -0,0 +1,190 @@
+#include "pe_bliss2/security/x509/x509_trust_store.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cryptopp/base64.h"
+#include "cryptopp/filters.h"
+
+#include "pe_bliss2/pe_error.h"
+
+namespace
+{
+
+struct x509_trust_store_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "x509_trust_store";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::security::x509::x509_trust_store_errc;
+		switch (static_cast<pe_bliss::security::x509::x509_trust_store_errc>(ev))
+		{
+		case unable_to_read_certificate:
+			return "Unable to read certificate file";
+		case invalid_certificate:
+			return "Invalid certificate";
+		case duplicate_certificate:
+			return "Duplicate certificate";
+		default:
+			return {};
+		}
+	}
+};
+
+const x509_trust_store_error_category x509_trust_store_error_category_instance;
+
+constexpr std::string_view pem_begin = "-----BEGIN CERTIFICATE-----";
+constexpr std::string_view pem_end = "-----END CERTIFICATE-----";
+
+std::vector<std::byte> decode_base64(std::string_view text)
+{
+	std::string decoded;
+	CryptoPP::StringSource source(reinterpret_cast<const CryptoPP::byte*>(text.data()),
+		text.size(), true, new CryptoPP::Base64Decoder(new CryptoPP::StringSink(decoded)));
+	const auto* data = reinterpret_cast<const std::byte*>(decoded.data());
+	return { data, data + decoded.size() };
+}
+
+bool is_certificate_file(const std::filesystem::path& path)
+{
+	auto extension = path.extension().string();
+	std::ranges::transform(extension, extension.begin(),
+		[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return extension == ".cer" || extension == ".crt"
+		|| extension == ".der" || extension == ".pem";
+}
+
+std::mutex global_trust_store_mutex;
+std::shared_ptr<const pe_bliss::security::x509::x509_trust_store> global_trust_store;
+
+} //namespace
+
+namespace pe_bliss::security::x509
+{
+
+std::error_code make_error_code(x509_trust_store_errc e) noexcept
+{
+	return { static_cast<int>(e), x509_trust_store_error_category_instance };
+}
+
+template<typename Reporter>
+bool x509_trust_store::add_der_certificate(std::vector<std::byte>&& data,
+	std::size_t index, const Reporter& report)
+{
+	const auto& stored_data = certificate_data_.emplace_back(std::move(data));
+	try
+	{
+		if (store_.add_certificate(certificate_type(stored_data)))
+			return true;
+
+		report(x509_trust_store_errc::duplicate_certificate, index);
+	}
+	catch (const pe_error& e)
+	{
+		report(e.code(), index);
+	}
+
+	certificate_data_.pop_back();
+	return false;
+}
+
+template<typename Reporter>
+std::size_t x509_trust_store::add_certificates(std::span<const std::byte> data,
+	const Reporter& report)
+{
+	const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+	auto begin = text.find(pem_begin);
+	if (begin == std::string_view::npos)
+		return add_der_certificate(std::vector<std::byte>(data.begin(), data.end()),
+			0u, report) ? 1u : 0u;
+
+	std::size_t added_count{};
+	for (std::size_t index = 0; begin != std::string_view::npos; ++index)
+	{
+		begin += pem_begin.size();
+		const auto end = text.find(pem_end, begin);
+		if (end == std::string_view::npos)
+		{
+			report(x509_trust_store_errc::invalid_certificate, index);
+			break;
+		}
+
+		std::vector<std::byte> der;
+		bool decoded = true;
+		try
+		{
+			der = decode_base64(text.substr(begin, end - begin));
+		}
+		catch (const CryptoPP::Exception&)
+		{
+			decoded = false;
+			report(x509_trust_store_errc::invalid_certificate, index);
+		}
+
+		if (decoded && add_der_certificate(std::move(der), index, report))
+			++added_count;
+		begin = text.find(pem_begin, end + pem_end.size());
+	}
+	return added_count;
+}
+
+std::size_t x509_trust_store::add_certificates(std::span<const std::byte> data,
+	error_list* warnings)
+{
+	return add_certificates(data, [warnings](std::error_code code, std::size_t index) {
+		if (warnings)
+			warnings->add_error(code, index);
+	});
+}
+
+void x509_trust_store::load_directory(const std::filesystem::path& path,
+	error_list* warnings)
+{
+	for (const auto& entry : std::filesystem::directory_iterator(path))
+	{
+		if (!entry.is_regular_file() || !is_certificate_file(entry.path()))
+			continue;
+
+		const auto file_name = entry.path().filename().string();
+		std::ifstream file(entry.path(), std::ios::binary);
+		std::vector<char> contents((std::istreambuf_iterator<char>(file)),
+			std::istreambuf_iterator<char>());
+		if (!file && !file.eof())
+		{
+			if (warnings)
+				warnings->add_error(x509_trust_store_errc::unable_to_read_certificate, file_name);
+			continue;
+		}
+
+		(void)add_certificates(std::as_bytes(std::span(contents)),
+			[warnings, &file_name](std::error_code code, std::size_t index) {
+				if (warnings)
+					warnings->add_error(code, file_name + '#' + std::to_string(index));
+			});
+	}
+}
+
+std::shared_ptr<const x509_trust_store> get_global_trust_store() noexcept
+{
+	std::lock_guard lock(global_trust_store_mutex);
+	return global_trust_store;
+}
+
+void set_global_trust_store(std::shared_ptr<const x509_trust_store> store) noexcept
+{
+	std::lock_guard lock(global_trust_store_mutex);
+	global_trust_store.swap(store);
+}
+
+} //namespace pe_bliss::security::x509
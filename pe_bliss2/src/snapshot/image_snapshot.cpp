@@ -0,0 +1,593 @@
+#include "pe_bliss2/snapshot/image_snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+#include "buffers/input_buffer_section.h"
+#include "buffers/output_buffer_interface.h"
+#include "buffers/output_memory_buffer.h"
+
+#include "cryptopp/sha.h"
+
+#include "pe_bliss2/detail/snapshot/snapshot_stream.h"
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/hash_helpers.h"
+
+#include "utilities/variant_helpers.h"
+
+namespace
+{
+
+struct image_snapshot_error_category : std::error_category
+{
+	const char* name() const noexcept override
+	{
+		return "image_snapshot";
+	}
+
+	std::string message(int ev) const override
+	{
+		using enum pe_bliss::snapshot::image_snapshot_errc;
+		switch (static_cast<pe_bliss::snapshot::image_snapshot_errc>(ev))
+		{
+		case invalid_snapshot_signature:
+			return "Invalid image snapshot signature";
+		case unsupported_snapshot_version:
+			return "Unsupported image snapshot version";
+		case invalid_snapshot_data:
+			return "Invalid image snapshot data";
+		case snapshot_hash_mismatch:
+			return "Image snapshot hash does not match snapshot data";
+		case content_hash_mismatch:
+			return "Image snapshot was created for a different image";
+		case directory_has_errors:
+			return "Directory has errors and can not be stored to the snapshot";
+		default:
+			return {};
+		}
+	}
+};
+
+const image_snapshot_error_category image_snapshot_error_category_instance;
+
+using namespace pe_bliss;
+using detail::snapshot::snapshot_reader;
+using detail::snapshot::snapshot_writer;
+
+constexpr std::array<std::byte, 8u> snapshot_signature{
+	std::byte{'P'}, std::byte{'E'}, std::byte{'B'}, std::byte{'S'},
+	std::byte{'N'}, std::byte{'A'}, std::byte{'P'}, std::byte{}
+};
+
+constexpr std::size_t snapshot_hash_size = CryptoPP::SHA256::DIGESTSIZE;
+static_assert(snapshot_hash_size == std::tuple_size_v<snapshot::content_hash_type>);
+
+constexpr std::size_t snapshot_header_size = snapshot_signature.size()
+	+ sizeof(std::uint32_t) /* version */
+	+ sizeof(std::uint32_t) /* flags */
+	+ sizeof(std::uint64_t) /* payload size */
+	+ snapshot_hash_size /* content hash */
+	+ snapshot_hash_size; /* payload hash */
+
+//Max resource directory depth to restore, protects against corrupted snapshots
+constexpr std::uint32_t max_resource_directory_depth = 32u;
+
+std::size_t read_count(snapshot_reader& reader)
+{
+	auto count = reader.read_size();
+	//Each element takes at least one byte
+	if (count > reader.size() - reader.rpos())
+		throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+	return count;
+}
+
+void write_image(snapshot_writer& writer, const image::image& instance)
+{
+	writer.write(instance.is_loaded_to_memory());
+	writer.write_packed(instance.get_dos_header().get_descriptor());
+	writer.write_buffer(instance.get_dos_stub().get_buffer());
+	writer.write_packed(instance.get_image_signature().get_descriptor());
+	writer.write_packed(instance.get_file_header().get_descriptor());
+
+	const auto& optional_header = instance.get_optional_header().get_descriptor();
+	writer.write<std::uint8_t>(static_cast<std::uint8_t>(optional_header.index()));
+	std::visit([&writer](const auto& header) {
+		writer.write_packed(header);
+	}, optional_header);
+
+	const auto& directories = instance.get_data_directories().get_directories();
+	writer.write<std::uint64_t>(directories.size());
+	for (const auto& dir : directories)
+		writer.write_packed(dir);
+
+	const auto& section_headers = instance.get_section_table().get_section_headers();
+	writer.write<std::uint64_t>(section_headers.size());
+	for (const auto& header : section_headers)
+		writer.write_packed(header.get_descriptor());
+
+	const auto& section_data = instance.get_section_data_list();
+	writer.write<std::uint64_t>(section_data.size());
+	for (const auto& data : section_data)
+		writer.write_buffer(data.get_buffer());
+
+	writer.write_buffer(instance.get_overlay().get_buffer());
+	writer.write_buffer(instance.get_full_headers_buffer());
+	writer.write_buffer(instance.get_full_sections_buffer());
+}
+
+void read_image(snapshot_reader& reader, image::image& instance)
+{
+	instance.set_loaded_to_memory(reader.read_bool());
+	reader.read_packed(instance.get_dos_header().get_descriptor());
+	reader.read_buffer(instance.get_dos_stub().get_buffer());
+	reader.read_packed(instance.get_image_signature().get_descriptor());
+	reader.read_packed(instance.get_file_header().get_descriptor());
+
+	auto& optional_header = instance.get_optional_header();
+	switch (reader.read<std::uint8_t>())
+	{
+	case 0u:
+		optional_header.initialize_with<core::optional_header::optional_header_32_type>();
+		break;
+	case 1u:
+		optional_header.initialize_with<core::optional_header::optional_header_64_type>();
+		break;
+	default:
+		throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+	}
+	std::visit([&reader](auto& header) {
+		reader.read_packed(header);
+	}, optional_header.get_descriptor());
+
+	auto& directories = instance.get_data_directories().get_directories();
+	directories.resize(read_count(reader));
+	for (auto& dir : directories)
+		reader.read_packed(dir);
+
+	auto& section_headers = instance.get_section_table().get_section_headers();
+	section_headers.resize(read_count(reader));
+	for (auto& header : section_headers)
+		reader.read_packed(header.get_descriptor());
+
+	auto& section_data = instance.get_section_data_list();
+	section_data.resize(read_count(reader));
+	for (auto& data : section_data)
+		reader.read_buffer(data.get_buffer());
+
+	reader.read_buffer(instance.get_overlay().get_buffer());
+	reader.read_buffer(instance.get_full_headers_buffer());
+	reader.read_buffer(instance.get_full_sections_buffer());
+}
+
+template<typename Library>
+bool has_errors(const Library& library)
+{
+	if (library.has_errors())
+		return true;
+
+	return std::ranges::any_of(library.get_imports(),
+		[](const auto& imported) { return imported.has_errors(); });
+}
+
+bool has_errors(const imports::import_directory_details& dir)
+{
+	if (dir.has_errors())
+		return true;
+
+	return std::visit([](const auto& libraries) {
+		return std::ranges::any_of(libraries,
+			[](const auto& library) { return has_errors(library); });
+	}, dir.get_list());
+}
+
+bool has_errors(const exports::export_directory_details& dir)
+{
+	if (dir.has_errors())
+		return true;
+
+	return std::ranges::any_of(dir.get_export_list(), [](const auto& exported) {
+		return exported.has_errors() || std::ranges::any_of(exported.get_names(),
+			[](const auto& name) { return name.has_errors(); });
+	});
+}
+
+bool has_errors(const resources::resource_directory_details& dir)
+{
+	if (dir.has_errors())
+		return true;
+
+	return std::ranges::any_of(dir.get_entries(), [](const auto& entry) {
+		if (entry.has_errors())
+			return true;
+		if (entry.has_directory())
+			return has_errors(entry.get_directory());
+		if (entry.has_data())
+			return entry.get_data().has_errors();
+		return false;
+	});
+}
+
+template<typename ImportedAddress>
+void write_imported_address(snapshot_writer& writer, const ImportedAddress& imported)
+{
+	writer.write_packed(imported.get_lookup());
+	writer.write_packed(imported.get_address());
+
+	const auto& info = imported.get_import_info();
+	writer.write<std::uint8_t>(static_cast<std::uint8_t>(info.index()));
+	std::visit(utilities::overloaded{
+		[&writer](const typename ImportedAddress::imported_function_address_type& address) {
+			writer.write_packed(address.get_imported_va());
+		},
+		[&writer](const typename ImportedAddress::ordinal_type& ordinal) {
+			writer.write_packed(ordinal.get_imported_va());
+			writer.write<std::uint16_t>(ordinal.get_ordinal());
+		},
+		[&writer](const typename ImportedAddress::hint_name_type& hint_name) {
+			writer.write_packed(hint_name.get_imported_va());
+			writer.write_packed(hint_name.get_hint());
+			writer.write_c_string(hint_name.get_name());
+		}
+	}, info);
+}
+
+template<typename ImportedAddress>
+void read_imported_address(snapshot_reader& reader, ImportedAddress& imported)
+{
+	reader.read_packed(imported.get_lookup());
+	reader.read_packed(imported.get_address());
+
+	auto& info = imported.get_import_info();
+	switch (reader.read<std::uint8_t>())
+	{
+	case 0u:
+		reader.read_packed(info.template emplace<
+			typename ImportedAddress::imported_function_address_type>().get_imported_va());
+		break;
+	case 1u:
+		{
+			auto& ordinal = info.template emplace<typename ImportedAddress::ordinal_type>();
+			reader.read_packed(ordinal.get_imported_va());
+			ordinal.set_ordinal(reader.read<std::uint16_t>());
+		}
+		break;
+	case 2u:
+		{
+			auto& hint_name = info.template emplace<typename ImportedAddress::hint_name_type>();
+			reader.read_packed(hint_name.get_imported_va());
+			reader.read_packed(hint_name.get_hint());
+			reader.read_c_string(hint_name.get_name());
+		}
+		break;
+	default:
+		throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+	}
+}
+
+void write_imports(snapshot_writer& writer, const imports::import_directory_details& dir)
+{
+	const auto& list = dir.get_list();
+	writer.write<std::uint8_t>(static_cast<std::uint8_t>(list.index()));
+	std::visit([&writer](const auto& libraries) {
+		writer.write<std::uint64_t>(libraries.size());
+		for (const auto& library : libraries)
+		{
+			writer.write_packed(library.get_descriptor());
+			writer.write_c_string(library.get_library_name());
+			writer.write<std::uint64_t>(library.get_imports().size());
+			for (const auto& imported : library.get_imports())
+				write_imported_address(writer, imported);
+		}
+	}, list);
+}
+
+template<typename LibraryList>
+void read_imported_libraries(snapshot_reader& reader, LibraryList& libraries)
+{
+	libraries.resize(read_count(reader));
+	for (auto& library : libraries)
+	{
+		reader.read_packed(library.get_descriptor());
+		reader.read_c_string(library.get_library_name());
+		auto& imports = library.get_imports();
+		imports.resize(read_count(reader));
+		for (auto& imported : imports)
+			read_imported_address(reader, imported);
+	}
+}
+
+void read_imports(snapshot_reader& reader, imports::import_directory_details& dir)
+{
+	using directory_type = imports::import_directory_details;
+	auto& list = dir.get_list();
+	switch (reader.read<std::uint8_t>())
+	{
+	case 0u:
+		read_imported_libraries(reader, list.emplace<
+			directory_type::imported_library32_list_type>());
+		break;
+	case 1u:
+		read_imported_libraries(reader, list.emplace<
+			directory_type::imported_library64_list_type>());
+		break;
+	default:
+		throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+	}
+}
+
+void write_exports(snapshot_writer& writer, const exports::export_directory_details& dir)
+{
+	writer.write_packed(dir.get_descriptor());
+	writer.write_c_string(dir.get_library_name());
+	writer.write<std::uint64_t>(dir.get_export_list().size());
+	for (const auto& exported : dir.get_export_list())
+	{
+		writer.write<std::uint16_t>(exported.get_rva_ordinal());
+		writer.write_packed(exported.get_rva());
+		writer.write_c_string(exported.get_forwarded_name());
+		writer.write<std::uint64_t>(exported.get_names().size());
+		for (const auto& name : exported.get_names())
+		{
+			writer.write_c_string(name.get_name());
+			writer.write_packed(name.get_name_rva());
+			writer.write_packed(name.get_name_ordinal());
+		}
+	}
+}
+
+void read_exports(snapshot_reader& reader, exports::export_directory_details& dir)
+{
+	reader.read_packed(dir.get_descriptor());
+	reader.read_c_string(dir.get_library_name());
+	auto& export_list = dir.get_export_list();
+	export_list.resize(read_count(reader));
+	for (auto& exported : export_list)
+	{
+		exported.set_rva_ordinal(reader.read<std::uint16_t>());
+		reader.read_packed(exported.get_rva());
+		reader.read_c_string(exported.get_forwarded_name());
+		auto& names = exported.get_names();
+		names.resize(read_count(reader));
+		for (auto& name : names)
+		{
+			reader.read_c_string(name.get_name());
+			reader.read_packed(name.get_name_rva());
+			reader.read_packed(name.get_name_ordinal());
+		}
+	}
+}
+
+void write_resources(snapshot_writer& writer, const resources::resource_directory_details& dir)
+{
+	writer.write_packed(dir.get_descriptor());
+	writer.write<std::uint8_t>(dir.has_sorted_entries());
+	writer.write<std::uint64_t>(dir.get_entries().size());
+	for (const auto& entry : dir.get_entries())
+	{
+		writer.write_packed(entry.get_descriptor());
+
+		const auto& name_or_id = entry.get_name_or_id();
+		writer.write<std::uint8_t>(static_cast<std::uint8_t>(name_or_id.index()));
+		if (entry.has_id())
+			writer.write<std::uint32_t>(entry.get_id());
+		else if (entry.is_named())
+			writer.write_utf16_string(entry.get_name());
+
+		const auto& data_or_directory = entry.get_data_or_directory();
+		writer.write<std::uint8_t>(static_cast<std::uint8_t>(data_or_directory.index()));
+		std::visit(utilities::overloaded{
+			[](std::monostate) {},
+			[&writer](const resources::resource_directory_details& child) {
+				write_resources(writer, child);
+			},
+			[&writer](const resources::resource_data_entry_details& data) {
+				writer.write_packed(data.get_descriptor());
+				writer.write_buffer(data.get_raw_data());
+			},
+			[&writer](rva_type looped_directory_rva) {
+				writer.write<std::uint32_t>(looped_directory_rva);
+			}
+		}, data_or_directory);
+	}
+}
+
+void read_resources(snapshot_reader& reader,
+	resources::resource_directory_details& dir, std::uint32_t depth)
+{
+	if (depth > max_resource_directory_depth)
+		throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+
+	reader.read_packed(dir.get_descriptor());
+	const bool sorted_entries = reader.read<std::uint8_t>() != 0u;
+	auto& entries = dir.get_entries();
+	entries.resize(read_count(reader));
+	for (auto& entry : entries)
+	{
+		reader.read_packed(entry.get_descriptor());
+
+		auto& name_or_id = entry.get_name_or_id();
+		switch (reader.read<std::uint8_t>())
+		{
+		case 0u:
+			name_or_id.emplace<std::monostate>();
+			break;
+		case 1u:
+			name_or_id.emplace<resources::resource_id_type>(reader.read<std::uint32_t>());
+			break;
+		case 2u:
+			reader.read_utf16_string(name_or_id.emplace<resources::resource_name_type>());
+			break;
+		default:
+			throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+		}
+
+		auto& data_or_directory = entry.get_data_or_directory();
+		switch (reader.read<std::uint8_t>())
+		{
+		case 0u:
+			data_or_directory.emplace<std::monostate>();
+			break;
+		case 1u:
+			read_resources(reader, data_or_directory.emplace<
+				resources::resource_directory_details>(), depth + 1u);
+			break;
+		case 2u:
+			{
+				auto& data = data_or_directory.emplace<resources::resource_data_entry_details>();
+				reader.read_packed(data.get_descriptor());
+				reader.read_buffer(data.get_raw_data());
+			}
+			break;
+		case 3u:
+			data_or_directory.emplace<rva_type>(reader.read<std::uint32_t>());
+			break;
+		default:
+			throw pe_error(snapshot::image_snapshot_errc::invalid_snapshot_data);
+		}
+	}
+
+	dir.set_sorted_entries(sorted_entries);
+}
+
+template<typename Directory, typename WriteFunc>
+void write_directory(snapshot_writer& writer, const std::optional<Directory>& dir,
+	const snapshot::snapshot_write_options& options, WriteFunc&& write_func)
+{
+	bool store = dir.has_value();
+	if (store && options.skip_directories_with_errors)
+		store = !has_errors(*dir);
+
+	writer.write(store);
+	if (store)
+		write_func(writer, *dir);
+}
+
+template<typename Directory, typename ReadFunc>
+void read_directory(snapshot_reader& reader, std::optional<Directory>& dir,
+	ReadFunc&& read_func)
+{
+	if (reader.read_bool())
+		read_func(reader, dir.emplace());
+}
+
+snapshot::content_hash_type calculate_hash(buffers::input_buffer_interface& buffer,
+	std::size_t from, std::size_t to)
+{
+	CryptoPP::SHA256 hash;
+	security::update_hash(buffer, from, to, hash);
+	snapshot::content_hash_type result;
+	hash.Final(reinterpret_cast<CryptoPP::byte*>(result.data()));
+	return result;
+}
+
+} //namespace
+
+namespace pe_bliss::snapshot
+{
+
+std::error_code make_error_code(image_snapshot_errc e) noexcept
+{
+	return { static_cast<int>(e), image_snapshot_error_category_instance };
+}
+
+void write_snapshot(const image_snapshot& snapshot,
+	const content_hash_type& content_hash,
+	buffers::output_buffer_interface& buffer,
+	const snapshot_write_options& options)
+{
+	std::vector<std::byte> payload;
+	buffers::output_memory_buffer payload_buffer(payload);
+	snapshot_writer payload_writer(payload_buffer);
+	write_image(payload_writer, snapshot.image);
+	write_directory(payload_writer, snapshot.imports, options, write_imports);
+	write_directory(payload_writer, snapshot.exports, options, write_exports);
+	write_directory(payload_writer, snapshot.resources, options, write_resources);
+
+	CryptoPP::SHA256 hash;
+	hash.Update(reinterpret_cast<const CryptoPP::byte*>(payload.data()), payload.size());
+	content_hash_type payload_hash;
+	hash.Final(reinterpret_cast<CryptoPP::byte*>(payload_hash.data()));
+
+	snapshot_writer writer(buffer);
+	writer.write_bytes(snapshot_signature.data(), snapshot_signature.size());
+	writer.write<std::uint32_t>(image_snapshot_version);
+	writer.write<std::uint32_t>(0u); //flags, reserved
+	writer.write<std::uint64_t>(payload.size());
+	writer.write_bytes(content_hash.data(), content_hash.size());
+	writer.write_bytes(payload_hash.data(), payload_hash.size());
+	writer.write_bytes(payload.data(), payload.size());
+}
+
+image_snapshot load_snapshot(const buffers::input_buffer_ptr& buffer,
+	const content_hash_type& expected_content_hash,
+	const snapshot_load_options& options)
+{
+	snapshot_reader reader(buffer);
+
+	std::array<std::byte, snapshot_signature.size()> signature;
+	try
+	{
+		reader.read_bytes(signature.data(), signature.size());
+	}
+	catch (const pe_error&)
+	{
+		throw pe_error(image_snapshot_errc::invalid_snapshot_signature);
+	}
+
+	if (signature != snapshot_signature)
+		throw pe_error(image_snapshot_errc::invalid_snapshot_signature);
+
+	if (reader.read<std::uint32_t>() != image_snapshot_version)
+		throw pe_error(image_snapshot_errc::unsupported_snapshot_version);
+
+	(void)reader.read<std::uint32_t>(); //flags, reserved
+	auto payload_size = reader.read_size();
+
+	content_hash_type content_hash;
+	content_hash_type payload_hash;
+	reader.read_bytes(content_hash.data(), content_hash.size());
+	reader.read_bytes(payload_hash.data(), payload_hash.size());
+
+	if (content_hash != expected_content_hash)
+		throw pe_error(image_snapshot_errc::content_hash_mismatch);
+
+	if (reader.size() - snapshot_header_size != payload_size)
+		throw pe_error(image_snapshot_errc::invalid_snapshot_data);
+
+	if (options.verify_snapshot_hash)
+	{
+		if (calculate_hash(*buffer, snapshot_header_size,
+			snapshot_header_size + payload_size) != payload_hash)
+		{
+			throw pe_error(image_snapshot_errc::snapshot_hash_mismatch);
+		}
+	}
+
+	image_snapshot result;
+	read_image(reader, result.image);
+	read_directory(reader, result.imports, read_imports);
+	read_directory(reader, result.exports, read_exports);
+	read_directory(reader, result.resources,
+		[](snapshot_reader& reader, resources::resource_directory_details& dir) {
+			read_resources(reader, dir, 0u);
+		});
+
+	if (reader.rpos() != reader.size())
+		throw pe_error(image_snapshot_errc::invalid_snapshot_data);
+
+	return result;
+}
+
+content_hash_type calculate_content_hash(buffers::input_buffer_interface& buffer)
+{
+	return calculate_hash(buffer, 0u, buffer.physical_size());
+}
+
+} //namespace pe_bliss::snapshot
@@ -0,0 +1,132 @@
+#include "pe_bliss2/snapshot/image_snapshot_cache.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif //NOMINMAX
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif //WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else //_WIN32
+#	include <unistd.h>
+#endif //_WIN32
+
+#include "buffers/input_file_mapping_buffer.h"
+#include "buffers/output_stream_buffer.h"
+#include "pe_bliss2/pe_error.h"
+
+namespace
+{
+
+constexpr const char* snapshot_extension = ".pesnap";
+
+std::string to_hex(const pe_bliss::snapshot::content_hash_type& hash)
+{
+	constexpr const char* digits = "0123456789abcdef";
+	std::string result;
+	result.reserve(hash.size() * 2u);
+	for (auto byte : hash)
+	{
+		result.push_back(digits[static_cast<std::uint8_t>(byte) >> 4u]);
+		result.push_back(digits[static_cast<std::uint8_t>(byte) & 0xfu]);
+	}
+	return result;
+}
+
+std::uint64_t get_process_id() noexcept
+{
+#ifdef _WIN32
+	return ::GetCurrentProcessId();
+#else //_WIN32
+	return static_cast<std::uint64_t>(::getpid());
+#endif //_WIN32
+}
+
+//Process ID makes the name unique across processes,
+//and the random part makes it unique across threads of this process.
+std::string get_temp_file_suffix()
+{
+	thread_local std::mt19937_64 engine(std::random_device{}());
+	return '.' + std::to_string(get_process_id())
+		+ '.' + std::to_string(engine()) + ".tmp";
+}
+
+} //namespace
+
+namespace pe_bliss::snapshot
+{
+
+std::filesystem::path image_snapshot_cache::get_snapshot_path(
+	const content_hash_type& content_hash) const
+{
+	return directory_ / (to_hex(content_hash) + snapshot_extension);
+}
+
+std::optional<image_snapshot> image_snapshot_cache::try_load(
+	const content_hash_type& content_hash,
+	const snapshot_load_options& options) const
+{
+	//The snapshot is mapped rather than read, so loading does not copy it.
+	//The mapping stays alive as long as the loaded snapshot references it.
+	std::shared_ptr<buffers::input_file_mapping_buffer> buffer;
+	try
+	{
+		buffer = std::make_shared<buffers::input_file_mapping_buffer>(
+			get_snapshot_path(content_hash));
+	}
+	catch (const std::system_error&)
+	{
+		return {};
+	}
+
+	if (!buffer->size())
+		return {};
+
+	try
+	{
+		return load_snapshot(buffer, content_hash, options);
+	}
+	catch (const pe_error&)
+	{
+		return {};
+	}
+}
+
+void image_snapshot_cache::store(const image_snapshot& snapshot,
+	const content_hash_type& content_hash,
+	const snapshot_write_options& options) const
+{
+	std::filesystem::create_directories(directory_);
+
+	auto path = get_snapshot_path(content_hash);
+	auto temp_path = path;
+	temp_path += get_temp_file_suffix();
+
+	{
+		std::ofstream stream(temp_path,
+			std::ios::out | std::ios::binary | std::ios::trunc);
+		stream.exceptions(std::ios::badbit | std::ios::failbit);
+		buffers::output_stream_buffer buffer(stream);
+		write_snapshot(snapshot, content_hash, buffer, options);
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temp_path, path, ec);
+	if (ec)
+	{
+		std::error_code remove_ec;
+		std::filesystem::remove(temp_path, remove_ec);
+		throw std::filesystem::filesystem_error("Unable to store image snapshot",
+			temp_path, path, ec);
+	}
+}
+
+} //namespace pe_bliss::snapshot
@@ -0,0 +1,90 @@
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "gtest/gtest.h"
+
+#include "buffers/input_file_mapping_buffer.h"
+#include "tests/buffers/input_buffer_helpers.h"
+
+namespace
+{
+constexpr std::array data{
+	std::byte{1},
+	std::byte{2},
+	std::byte{3},
+	std::byte{4},
+	std::byte{5}
+};
+
+class temp_file final
+{
+public:
+	explicit temp_file(const char* name)
+		: path_(std::filesystem::temp_directory_path() / name)
+	{
+	}
+
+	~temp_file()
+	{
+		std::error_code ec;
+		std::filesystem::remove(path_, ec);
+	}
+
+	void write(const std::byte* ptr, std::size_t size) const
+	{
+		std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(ptr), size);
+	}
+
+	const std::filesystem::path& get_path() const noexcept
+	{
+		return path_;
+	}
+
+private:
+	std::filesystem::path path_;
+};
+} //namespace
+
+TEST(BufferTests, InputFileMappingBufferTest)
+{
+	temp_file file("pe_bliss_input_file_mapping_buffer_test.bin");
+	file.write(data.data(), data.size());
+
+	buffers::input_file_mapping_buffer buffer(file.get_path());
+	test_input_buffer(buffer, data);
+	EXPECT_TRUE(buffer.is_stateless());
+	EXPECT_EQ(buffer.virtual_size(), 0u);
+
+	const std::byte* ptr{};
+	ASSERT_NO_THROW((ptr = buffer.get_raw_data(1u, 2u)));
+	ASSERT_NE(ptr, nullptr);
+	EXPECT_EQ(ptr[0], data[1]);
+	EXPECT_EQ(ptr[1], data[2]);
+	EXPECT_THROW((ptr = buffer.get_raw_data(1u, 5u)), std::system_error);
+
+	//Hints outside the mapping are ignored
+	buffer.advise_sequential_read(1u, 4u);
+	buffer.advise_sequential_read(3u, 100u);
+	buffer.advise_sequential_read(100u, 1u);
+}
+
+TEST(BufferTests, InputFileMappingBufferEmptyTest)
+{
+	temp_file file("pe_bliss_input_file_mapping_buffer_empty_test.bin");
+	file.write(nullptr, 0u);
+
+	buffers::input_file_mapping_buffer buffer(file.get_path());
+	EXPECT_EQ(buffer.size(), 0u);
+	EXPECT_THROW((void)buffer.get_raw_data(0u, 1u), std::system_error);
+}
+
+TEST(BufferTests, InputFileMappingBufferMissingFileTest)
+{
+	EXPECT_THROW(buffers::input_file_mapping_buffer(
+		std::filesystem::temp_directory_path()
+			/ "pe_bliss_input_file_mapping_buffer_missing.bin"), std::system_error);
+}
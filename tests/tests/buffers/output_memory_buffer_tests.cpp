@@ -21,3 +21,24 @@ TEST(BufferTests, OutputMemoryBufferTest)
 
 	test_output_buffer(buffer, data);
 }
+
+TEST(BufferTests, OutputMemoryBufferReset)
+{
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buffer(data);
+	buffer.reserve(10u);
+	auto capacity = data.capacity();
+	EXPECT_GE(capacity, 10u);
+
+	static constexpr std::array source{ std::byte{1}, std::byte{2}, std::byte{3} };
+	buffer.write(source.size(), source.data());
+	buffer.set_wpos(1u);
+	buffer.write(source.size(), source.data());
+	EXPECT_EQ(data, (std::vector{ std::byte{1}, std::byte{1},
+		std::byte{2}, std::byte{3} }));
+
+	buffer.reset();
+	EXPECT_TRUE(data.empty());
+	EXPECT_EQ(buffer.wpos(), 0u);
+	EXPECT_EQ(data.capacity(), capacity);
+}
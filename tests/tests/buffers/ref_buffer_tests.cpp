@@ -180,6 +180,32 @@ TEST(BufferTests, ReferencedRefBufferTest)
 	}
 }
 
+TEST(BufferTests, ContiguousRefBufferTest)
+{
+	auto input_buf = create_input_container_buffer(100u);
+	input_buf->set_absolute_offset(20u);
+	buffers::ref_buffer buf;
+	EXPECT_FALSE(buf.deserialize_contiguous(input_buf));
+	EXPECT_FALSE(buf.is_copied());
+	EXPECT_EQ(buf.data(), input_buf);
+}
+
+TEST(BufferTests, NonContiguousRefBufferTest)
+{
+	auto input_buf = create_input_container_buffer(100u);
+	auto stream = std::make_shared<std::stringstream>();
+	stream->write(reinterpret_cast<const char*>(input_buf->get_container().data()),
+		input_buf->size());
+	auto stream_buf = std::make_shared<buffers::input_stream_buffer>(stream);
+	stream_buf->set_absolute_offset(20u);
+
+	buffers::ref_buffer buf;
+	EXPECT_TRUE(buf.deserialize_contiguous(stream_buf));
+	EXPECT_TRUE(buf.is_copied());
+	EXPECT_EQ(std::as_const(buf).copied_data(), input_buf->get_container());
+	EXPECT_EQ(buf.data()->absolute_offset(), 20u);
+}
+
 TEST_P(RefBufferTestsFixture, MoveRefBufferTest)
 {
 	auto input_buf = create_input_container_buffer(100u);
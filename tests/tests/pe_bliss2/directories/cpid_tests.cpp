@@ -0,0 +1,23 @@
+#include "pe_bliss2/resources/cpid.h"
+
+#include "gtest/gtest.h"
+
+using namespace pe_bliss::resources;
+
+TEST(CpidTests, GetCpidName)
+{
+	EXPECT_EQ(get_cpid_name(code_page::ibm037), "IBM037");
+	EXPECT_EQ(get_cpid_name(code_page::utf_8), "utf-8");
+	EXPECT_EQ(get_cpid_name(code_page::euc_jp), "euc-jp");
+	EXPECT_FALSE(get_cpid_name(static_cast<code_page>(1u)));
+}
+
+TEST(CpidTests, GetCpidByName)
+{
+	EXPECT_EQ(get_cpid_by_name("IBM037"), code_page::ibm037);
+	EXPECT_EQ(get_cpid_by_name("UTF-8"), code_page::utf_8);
+	EXPECT_EQ(get_cpid_by_name("Windows-1251"), code_page::windows_1251);
+	EXPECT_EQ(get_cpid_by_name("EUC-JP"), code_page::euc_jp);
+	EXPECT_FALSE(get_cpid_by_name("utf-9"));
+	EXPECT_FALSE(get_cpid_by_name(""));
+}
@@ -0,0 +1,84 @@
+#include "pe_bliss2/exports/export_directory_builder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/exports/export_directory.h"
+#include "pe_bliss2/exports/export_directory_loader.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::exports;
+
+namespace
+{
+class ExportBuilderTestFixture : public ::testing::Test
+{
+public:
+	ExportBuilderTestFixture()
+	{
+		directory.set_library_name("test.dll");
+		directory.add(3u, "c", "other.fn");
+		directory.add(0u, "b", 0x1100u);
+		directory.add(1u, "a", "other.fn");
+	}
+
+public:
+	export_directory directory;
+};
+
+//Descriptor, library name, 4 functions, 3 name ordinals and name RVAs, 3 names
+constexpr std::uint32_t size_without_forwarded_names
+	= 40u + 9u + 4u * 4u + 3u * 2u + 3u * 4u + 3u * 2u;
+} //namespace
+
+TEST_F(ExportBuilderTestFixture, BuildNew)
+{
+	static constexpr rva_type directory_rva = 0x1000u;
+	static constexpr std::uint32_t expected_size = size_without_forwarded_names + 9u;
+	EXPECT_EQ(get_built_size(directory), expected_size);
+
+	auto instance = create_test_image({});
+	ASSERT_EQ(build_new(instance, directory, { .directory_rva = directory_rva }),
+		expected_size);
+
+	//Identical forwarded names are written once
+	const auto& export_list = directory.get_export_list();
+	ASSERT_EQ(export_list.size(), 3u);
+	EXPECT_EQ(export_list[0].get_rva_ordinal(), 0u);
+	EXPECT_EQ(export_list[1].get_rva().get(), export_list[2].get_rva().get());
+	EXPECT_EQ(directory.get_descriptor()->number_of_names, 3u);
+
+	auto loaded = load(instance);
+	ASSERT_TRUE(loaded);
+	EXPECT_FALSE(loaded->has_errors());
+	EXPECT_EQ(loaded->get_library_name().value(), "test.dll");
+	ASSERT_EQ(loaded->get_export_list().size(), 3u);
+	auto a = loaded->symbol_by_name("a");
+	ASSERT_NE(a, loaded->get_export_list().end());
+	EXPECT_EQ(a->get_rva_ordinal(), 1u);
+	ASSERT_TRUE(a->get_forwarded_name());
+	EXPECT_EQ(a->get_forwarded_name()->value(), "other.fn");
+	auto b = loaded->symbol_by_name("b");
+	ASSERT_NE(b, loaded->get_export_list().end());
+	EXPECT_EQ(b->get_rva().get(), 0x1100u);
+	EXPECT_FALSE(b->get_forwarded_name());
+}
+
+TEST_F(ExportBuilderTestFixture, BuildNoDeduplication)
+{
+	static constexpr std::uint32_t expected_size = size_without_forwarded_names + 2u * 9u;
+	static constexpr builder_options options{ .deduplicate_names = false };
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buf(data);
+	EXPECT_EQ(get_built_size(directory, options), expected_size);
+	EXPECT_EQ(build_new(buf, directory, options), expected_size);
+	EXPECT_EQ(data.size(), expected_size);
+}
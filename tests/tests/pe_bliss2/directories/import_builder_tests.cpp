@@ -0,0 +1,132 @@
+#include "pe_bliss2/imports/import_directory_builder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/imports/import_directory.h"
+#include "pe_bliss2/imports/import_directory_loader.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::imports;
+
+namespace
+{
+class ImportBuilderTestFixture : public ::testing::Test
+{
+public:
+	using library_type = import_directory::imported_library32_type;
+	using symbol_type = library_type::imported_address_list::value_type;
+
+	ImportBuilderTestFixture()
+	{
+		auto& libraries = std::get<import_directory::imported_library32_list_type>(
+			directory.get_list());
+		auto& kernel32 = add_library(libraries, "kernel32.dll", true);
+		add_hint_name(kernel32, 1u, "A");
+		add_hint_name(kernel32, 2u, "B");
+		kernel32.get_imports().emplace_back().get_import_info()
+			.emplace<symbol_type::ordinal_type>().set_ordinal(5u);
+		add_hint_name(add_library(libraries, "kernel32.dll", true), 1u, "A");
+		add_hint_name(add_library(libraries, "user32.dll", false), 3u, "C");
+	}
+
+	static library_type& add_library(
+		import_directory::imported_library32_list_type& libraries,
+		std::string_view name, bool has_lookup)
+	{
+		auto& library = libraries.emplace_back();
+		library.get_library_name().value() = name;
+		library.get_descriptor()->address_table = 2u;
+		library.get_descriptor()->lookup_table = has_lookup ? 1u : 0u;
+		return library;
+	}
+
+	static void add_hint_name(library_type& library,
+		std::uint16_t hint, std::string_view name)
+	{
+		auto& info = library.get_imports().emplace_back().get_import_info()
+			.emplace<symbol_type::hint_name_type>();
+		info.get_hint() = hint;
+		info.get_name().value() = name;
+	}
+
+public:
+	import_directory directory;
+};
+
+//Descriptors (3 + terminator), lookup thunks (3 + 1, 1 + 1),
+//address thunks (3 + 1, 1 + 1, 1 + 1)
+constexpr std::uint32_t thunks_end = 4u * 20u + 6u * 4u + 8u * 4u;
+} //namespace
+
+TEST_F(ImportBuilderTestFixture, BuildNew)
+{
+	static constexpr rva_type directory_rva = 0x1000u;
+	//Names: "kernel32.dll", "user32.dll", hints/names: A, B, C
+	static constexpr std::uint32_t expected_size = thunks_end + 13u + 11u + 3u * 4u;
+	EXPECT_EQ(get_built_size(directory, {}).directory_size, expected_size);
+
+	auto instance = create_test_image({});
+	auto result = build_new(instance, directory, { .directory_rva = directory_rva });
+	EXPECT_EQ(result.full_size, expected_size);
+	EXPECT_EQ(result.descriptors_size, 4u * 20u);
+	EXPECT_EQ(result.iat_rva, directory_rva + 4u * 20u + 6u * 4u);
+	EXPECT_EQ(result.iat_size, 8u * 4u);
+
+	const auto& libraries = std::get<import_directory::imported_library32_list_type>(
+		directory.get_list());
+	EXPECT_EQ(libraries[0].get_descriptor()->name, libraries[1].get_descriptor()->name);
+	EXPECT_EQ(libraries[0].get_descriptor()->lookup_table, directory_rva + 4u * 20u);
+	EXPECT_EQ(libraries[2].get_descriptor()->lookup_table, 0u);
+	EXPECT_EQ(instance.get_data_directories().get_directory(
+		core::data_directories::directory_type::iat)->virtual_address, result.iat_rva);
+
+	auto loaded = load(instance);
+	ASSERT_TRUE(loaded);
+	EXPECT_FALSE(loaded->has_errors());
+	const auto& loaded_libraries = std::get<
+		import_directory_details::imported_library32_list_type>(loaded->get_list());
+	ASSERT_EQ(loaded_libraries.size(), 3u);
+	EXPECT_EQ(loaded_libraries[1].get_library_name().value(), "kernel32.dll");
+	EXPECT_EQ(loaded_libraries[2].get_library_name().value(), "user32.dll");
+
+	const auto& kernel32_imports = loaded_libraries[0].get_imports();
+	ASSERT_EQ(kernel32_imports.size(), 3u);
+	EXPECT_EQ(std::get<symbol_type::ordinal_type>(
+		kernel32_imports[2].get_import_info()).get_ordinal(), 5u);
+	const auto& b = std::get<symbol_type::hint_name_type>(
+		kernel32_imports[1].get_import_info());
+	EXPECT_EQ(b.get_hint().get(), 2u);
+	EXPECT_EQ(b.get_name().value(), "B");
+
+	//Identical hint/name entries are written once
+	ASSERT_EQ(loaded_libraries[1].get_imports().size(), 1u);
+	EXPECT_EQ(loaded_libraries[1].get_imports()[0].get_lookup()->get(),
+		kernel32_imports[0].get_lookup()->get());
+	ASSERT_EQ(loaded_libraries[2].get_imports().size(), 1u);
+	EXPECT_EQ(std::get<symbol_type::hint_name_type>(loaded_libraries[2]
+		.get_imports()[0].get_import_info()).get_name().value(), "C");
+}
+
+TEST_F(ImportBuilderTestFixture, BuildNoDeduplication)
+{
+	static constexpr std::uint32_t expected_size = thunks_end
+		+ 13u + 13u + 11u + 4u * 4u;
+	static constexpr builder_options options{ .deduplicate_names = false };
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buf(data);
+	EXPECT_EQ(get_built_size(directory, options).directory_size, expected_size);
+	EXPECT_EQ(build_new(buf, nullptr, directory, options).full_size, expected_size);
+	EXPECT_EQ(data.size(), expected_size);
+}
@@ -4,6 +4,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -14,6 +15,7 @@
 #include "pe_bliss2/imports/import_directory_loader.h"
 #include "pe_bliss2/image/image.h"
 #include "pe_bliss2/pe_types.h"
+#include "utilities/scoped_guard.h"
 
 #include "tests/pe_bliss2/image_helper.h"
 #include "tests/pe_bliss2/pe_error_helper.h"
@@ -74,9 +76,9 @@ public:
 	template<typename Func>
 	void with_imports(const imports::import_directory_details& dir, Func&& func)
 	{
-		bool is_64bit = !!std::get_if<std::vector<
-			imports::imported_library_details<std::uint64_t,
-			detail::imports::image_import_descriptor>>>(&dir.get_list());
+		bool is_64bit = !!std::get_if<
+			imports::import_directory_details::imported_library64_list_type>(
+				&dir.get_list());
 		ASSERT_EQ(is_64bit, is_x64());
 		std::visit(std::forward<Func>(func), dir.get_list());
 	}
@@ -535,6 +537,52 @@ TEST_P(ImportLoaderTestFixture, LoadZeroAddressesImportDirectory)
 	});
 }
 
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+TEST_P(ImportLoaderTestFixture, LoadWithMemoryResource)
+{
+	add_import_directory();
+	add_import_directory_data();
+	add_library_names();
+	add_ilt();
+	add_hint_name();
+	std::array<std::byte, 0x10000u> buffer{};
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+		std::pmr::null_memory_resource());
+	//Lists, names and error lists must not be allocated from the default resource
+	auto* default_resource = std::pmr::set_default_resource(
+		std::pmr::null_memory_resource());
+	utilities::scoped_guard restore([default_resource] {
+		std::pmr::set_default_resource(default_resource); });
+	auto result = imports::load(instance, { .memory_resource = &arena });
+	ASSERT_TRUE(result);
+	expect_contains_errors(*result);
+	std::visit([&buffer, &arena](const auto& list) {
+		ASSERT_EQ(list.size(), library_count);
+		const auto* data = reinterpret_cast<const std::byte*>(list.data());
+		EXPECT_GE(data, buffer.data());
+		EXPECT_LT(data, buffer.data() + buffer.size());
+		const auto* imports = reinterpret_cast<const std::byte*>(
+			list[1].get_imports().data());
+		EXPECT_GE(imports, buffer.data());
+		EXPECT_LT(imports, buffer.data() + buffer.size());
+		for (const auto& library : list)
+		{
+			EXPECT_EQ(library.get_library_name().value()
+				.get_allocator().resource(), &arena);
+		}
+		EXPECT_EQ(list[1].get_library_name().value(), lib13_name);
+		ASSERT_EQ(list[1].get_imports().size(), 2u);
+		using va_type = typename std::remove_cvref_t<
+			decltype(list[1].get_imports()[1])>::va_type;
+		const auto* hint_name = std::get_if<
+			imports::imported_function_hint_and_name<va_type>>(
+				&list[1].get_imports()[1].get_import_info());
+		ASSERT_NE(hint_name, nullptr);
+		EXPECT_EQ(hint_name->get_name().value().get_allocator().resource(), &arena);
+	}, result->get_list());
+}
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
 TEST_P(ImportLoaderTestFixture, LoadImportDirectoryLibraryNames)
 {
 	add_import_directory();
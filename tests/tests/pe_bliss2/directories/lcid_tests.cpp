@@ -0,0 +1,33 @@
+#include "pe_bliss2/resources/lcid.h"
+
+#include "gtest/gtest.h"
+
+using namespace pe_bliss::resources;
+
+TEST(LcidTests, GetLcidInfoByLcid)
+{
+	auto info = get_lcid_info(0x0419u);
+	ASSERT_TRUE(info);
+	EXPECT_EQ(info->language, lcid_language::russian);
+	EXPECT_EQ(info->language_tag, "ru-RU");
+
+	EXPECT_FALSE(get_lcid_info(0xffffu));
+}
+
+TEST(LcidTests, GetLcidInfoByLanguageTag)
+{
+	auto info = get_lcid_info("ru-ru");
+	ASSERT_TRUE(info);
+	EXPECT_EQ(info->lcid, 0x0419u);
+
+	info = get_lcid_info("EN-us");
+	ASSERT_TRUE(info);
+	EXPECT_EQ(info->lcid, 0x0409u);
+
+	info = get_lcid_info("zu-za");
+	ASSERT_TRUE(info);
+	EXPECT_EQ(info->lcid, 0x0435u);
+
+	EXPECT_FALSE(get_lcid_info("xx-yy"));
+	EXPECT_FALSE(get_lcid_info(""));
+}
@@ -618,6 +618,29 @@ TEST(ManifestTests, RequestedPrivilegesUiAccess)
 	EXPECT_EQ(priv.get_ui_access(), false);
 }
 
+TEST(ManifestTests, EnumToString)
+{
+	EXPECT_EQ(processor_architecture_to_string(
+		assembly_processor_architecture::arm64), "arm64");
+	EXPECT_FALSE(processor_architecture_to_string(
+		assembly_processor_architecture::unknown));
+	EXPECT_EQ(supported_os_to_guid(assembly_supported_os::win7_server2008_r2),
+		"{35138b9a-5d96-4fbd-8e2d-a2440225f93a}");
+	EXPECT_FALSE(supported_os_to_guid(assembly_supported_os::unsupported));
+	EXPECT_EQ(threading_model_to_string(com_threading_model::apartment), "Apartment");
+	EXPECT_EQ(ole_misc_to_string(ole_misc::static_value), "static");
+	EXPECT_FALSE(ole_misc_to_string(ole_misc::unknown));
+	EXPECT_EQ(typelib_flag_to_string(com_typelib_flags::has_disk_image), "HASDISKIMAGE");
+	EXPECT_EQ(hash_algorithm_to_string(assembly_file_hash_algorithm::sha256), "sha256");
+	EXPECT_EQ(dpi_aware_to_string(dpi_aware_value::dpi_aware_true_per_monitor), "true/pm");
+	EXPECT_FALSE(dpi_aware_to_string(dpi_aware_value::absent));
+	EXPECT_EQ(dpi_awareness_to_string(dpi_awareness_value::dpi_aware_per_monitor_v2),
+		"permonitorv2");
+	EXPECT_EQ(execution_level_to_string(requested_execution_level::as_invoker),
+		"asInvoker");
+	EXPECT_FALSE(execution_level_to_string(requested_execution_level::unknown));
+}
+
 namespace
 {
 constexpr std::string_view empty_manifest(
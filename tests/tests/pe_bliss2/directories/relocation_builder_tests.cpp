@@ -0,0 +1,163 @@
+#include "pe_bliss2/relocations/relocation_directory_builder.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/relocations/base_relocation.h"
+#include "pe_bliss2/relocations/relocation_directory_loader.h"
+#include "pe_bliss2/relocations/relocation_entry.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::relocations;
+
+TEST(RelocationBuilderTests, SortFixups)
+{
+	std::vector<relocation_fixup> fixups;
+	std::uint32_t seed = 12345u;
+	for (std::uint16_t i = 0; i != 1000u; ++i)
+	{
+		seed = seed * 1103515245u + 12345u;
+		fixups.push_back({ .rva = (seed >> 8u) % 0x20000u,
+			.type = relocation_type::highlow, .param = i });
+	}
+	//Equal RVAs
+	fixups.push_back({ .rva = 0x100u, .param = 1000u });
+	fixups.push_back({ .rva = 0x100u, .param = 1001u });
+
+	sort_fixups(fixups);
+	EXPECT_TRUE(std::is_sorted(fixups.begin(), fixups.end(),
+		[](const auto& l, const auto& r) {
+			return l.rva < r.rva || (l.rva == r.rva && l.param < r.param);
+		}));
+}
+
+TEST(RelocationBuilderTests, BuildFromFixups)
+{
+	std::vector<relocation_fixup> fixups{
+		{ .rva = 0x1010u, .type = relocation_type::highlow },
+		{ .rva = 0x2008u, .type = relocation_type::dir64 },
+		{ .rva = 0x1004u, .type = relocation_type::highlow },
+		{ .rva = 0x1010u, .type = relocation_type::highlow },
+		{ .rva = 0x1ffeu, .type = relocation_type::absolute },
+		{ .rva = 0x2100u, .type = relocation_type::highadj, .param = 0x1234u }
+	};
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buf(data);
+	ASSERT_EQ(build_new(buf, fixups, { .directory_rva = 0x5000u }), 28u);
+	EXPECT_EQ(get_built_size(fixups, {}), 28u);
+
+	static constexpr std::uint8_t expected[]{
+		0x00u, 0x10u, 0u, 0u, 12u, 0u, 0u, 0u,
+		0x04u, 0x30u, 0x10u, 0x30u,
+		0x00u, 0x20u, 0u, 0u, 16u, 0u, 0u, 0u,
+		0x08u, 0xa0u, 0x00u, 0x41u, 0x34u, 0x12u, 0u, 0u
+	};
+	ASSERT_EQ(data.size(), sizeof(expected));
+	EXPECT_TRUE(std::equal(data.begin(), data.end(), std::begin(expected),
+		[](std::byte l, std::uint8_t r) { return l == std::byte{ r }; }));
+
+	EXPECT_EQ(get_built_size(fixups, { .align_base_relocation_structures = false }), 26u);
+}
+
+TEST(RelocationBuilderTests, BuildFromFixupsNonAdjacentDuplicates)
+{
+	std::vector<relocation_fixup> fixups{
+		{ .rva = 0x1010u, .type = relocation_type::dir64 },
+		{ .rva = 0x1010u, .type = relocation_type::highlow },
+		{ .rva = 0x1010u, .type = relocation_type::dir64 }
+	};
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buf(data);
+	ASSERT_EQ(build_new(buf, fixups, { .directory_rva = 0x5000u }), 12u);
+	EXPECT_EQ(get_built_size(fixups, {}), 12u);
+
+	static constexpr std::uint8_t expected[]{
+		0x00u, 0x10u, 0u, 0u, 12u, 0u, 0u, 0u,
+		0x10u, 0xa0u, 0x10u, 0x30u
+	};
+	ASSERT_EQ(data.size(), sizeof(expected));
+	EXPECT_TRUE(std::equal(data.begin(), data.end(), std::begin(expected),
+		[](std::byte l, std::uint8_t r) { return l == std::byte{ r }; }));
+}
+
+TEST(RelocationBuilderTests, BuiltSizeUnsortedFixups)
+{
+	const std::vector<relocation_fixup> fixups{
+		{ .rva = 0x2008u, .type = relocation_type::dir64 },
+		{ .rva = 0x1004u, .type = relocation_type::highlow }
+	};
+
+	expect_throw_pe_error([&fixups] {
+		(void)get_built_size(fixups, {});
+	}, relocation_directory_builder_errc::unsorted_fixups);
+}
+
+TEST(RelocationBuilderTests, BuildInvalidFixupType)
+{
+	std::vector<relocation_fixup> fixups{
+		{ .rva = 0x1004u, .type = relocation_type::highlow },
+		{ .rva = 0x1008u, .type = static_cast<relocation_type>(16u) }
+	};
+
+	expect_throw_pe_error([&fixups] {
+		(void)get_built_size(fixups, {});
+	}, relocation_directory_builder_errc::invalid_relocation_type);
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buf(data);
+	expect_throw_pe_error([&] {
+		(void)build_new(buf, fixups, { .directory_rva = 0x5000u });
+	}, relocation_directory_builder_errc::invalid_relocation_type);
+}
+
+TEST(RelocationBuilderTests, BuildMerged)
+{
+	base_relocation_list directory;
+	auto& block = directory.emplace_back();
+	block.get_descriptor()->virtual_address = 0x1000u;
+	for (auto [type, address] : { std::pair{ relocation_type::highlow, 0x10u },
+		std::pair{ relocation_type::absolute, 0u } })
+	{
+		auto& entry = block.get_relocations().emplace_back();
+		entry.set_type(type);
+		entry.set_address(static_cast<std::uint16_t>(address));
+	}
+
+	const relocation_fixup fixups[]{
+		{ .rva = 0x3000u, .type = relocation_type::dir64 },
+		{ .rva = 0x1020u, .type = relocation_type::highlow }
+	};
+
+	auto instance = create_test_image({});
+	ASSERT_EQ(build_merged(instance, directory, fixups, { .directory_rva = 0x1000u }), 24u);
+	EXPECT_EQ(instance.get_data_directories().get_directory(
+		core::data_directories::directory_type::basereloc)->size, 24u);
+
+	auto loaded = load(instance);
+	ASSERT_TRUE(loaded);
+	EXPECT_FALSE(loaded->errors.has_errors());
+	ASSERT_EQ(loaded->relocations.size(), 2u);
+	const auto& page1 = loaded->relocations[0];
+	EXPECT_EQ(page1.get_descriptor()->virtual_address, 0x1000u);
+	ASSERT_EQ(page1.get_relocations().size(), 2u);
+	EXPECT_EQ(page1.get_relocations()[0].get_address(), 0x10u);
+	EXPECT_EQ(page1.get_relocations()[1].get_address(), 0x20u);
+	const auto& page2 = loaded->relocations[1];
+	EXPECT_EQ(page2.get_descriptor()->virtual_address, 0x3000u);
+	ASSERT_EQ(page2.get_relocations().size(), 2u);
+	EXPECT_EQ(page2.get_relocations()[0].get_type(), relocation_type::dir64);
+	EXPECT_EQ(page2.get_relocations()[1].get_type(), relocation_type::absolute);
+}
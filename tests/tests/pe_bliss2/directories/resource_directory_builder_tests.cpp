@@ -0,0 +1,183 @@
+#include "pe_bliss2/resources/resource_directory_builder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/resources/resource_directory_loader.h"
+#include "pe_bliss2/resources/resource_reader.h"
+#include "pe_bliss2/resources/resource_types.h"
+#include "pe_bliss2/resources/resource_writer.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::resources;
+
+namespace
+{
+class ResourceDirectoryBuilderTestFixture : public ::testing::Test
+{
+public:
+	ResourceDirectoryBuilderTestFixture()
+	{
+		//Entries are not sorted
+		set_data(try_emplace_resource_data_by_id(root,
+			resource_type::icon, 2u, 1033u), "abc");
+		set_data(try_emplace_resource_data_by_id(root,
+			resource_type::icon, 1u, 1033u), "abc");
+		set_data(try_emplace_resource_data_by_name(root,
+			resource_type::dialog, u"NAME", 0u), std::string_view("xyz\0\0", 5u));
+		set_data(root.try_emplace_entry_by_name(u"CUSTOM",
+			directory_entry_contents::directory).get_directory()
+			.try_emplace_entry_by_name(u"NAME", directory_entry_contents::directory)
+			.get_directory()
+			.try_emplace_entry_by_id(1049u, directory_entry_contents::data)
+			.get_data(), "12345");
+	}
+
+	static void set_data(resource_data_entry& entry, std::string_view data)
+	{
+		auto& container = entry.get_raw_data().copied_data();
+		for (auto ch : data)
+			container.push_back(static_cast<std::byte>(ch));
+	}
+
+	[[nodiscard]]
+	static std::string_view get_data(const buffers::ref_buffer& buf)
+	{
+		const auto& data = buf.copied_data();
+		return { reinterpret_cast<const char*>(data.data()), data.size() };
+	}
+
+public:
+	resource_directory root;
+};
+
+//Directory tables: root (3 entries), 3 name directories (1, 2 and 1 entries),
+//4 language directories (1 entry each)
+constexpr std::uint32_t tables_size = 16u * 8u + 8u * 11u;
+constexpr std::uint32_t data_entries_size = 4u * 16u;
+constexpr std::uint32_t names_size = (2u + 12u) + (2u + 8u);
+constexpr std::uint32_t data_offset = tables_size + data_entries_size + names_size;
+} //namespace
+
+TEST_F(ResourceDirectoryBuilderTestFixture, BuildNew)
+{
+	static_assert(data_offset % 8u == 0u);
+	static constexpr rva_type directory_rva = 0x1000u;
+	auto instance = create_test_image({});
+	EXPECT_EQ(get_built_size(root), data_offset + 3u * 8u);
+	ASSERT_EQ(build_new(instance, root, { .directory_rva = directory_rva }),
+		data_offset + 3u * 8u);
+
+	EXPECT_TRUE(root.has_sorted_entries());
+	ASSERT_EQ(root.get_entries().size(), 3u);
+	EXPECT_TRUE(root.get_entries()[0].is_named());
+	EXPECT_EQ(root.get_entries()[1].get_id(),
+		static_cast<resource_id_type>(resource_type::icon));
+	EXPECT_EQ(root.get_descriptor()->number_of_named_entries, 1u);
+	EXPECT_EQ(root.get_descriptor()->number_of_id_entries, 2u);
+
+	const auto& dirs = instance.get_data_directories();
+	EXPECT_EQ(dirs.get_directory(core::data_directories::directory_type::resource)
+		->virtual_address, directory_rva);
+
+	auto loaded = load(instance, { .copy_raw_data = true });
+	ASSERT_TRUE(loaded);
+	EXPECT_FALSE(loaded->has_errors());
+
+	const auto& icon1 = get_resource_data_by_id(*loaded, resource_type::icon, 1u, 1033u);
+	const auto& icon2 = get_resource_data_by_id(*loaded, resource_type::icon, 2u, 1033u);
+	EXPECT_EQ(get_data(icon1), "abc");
+	EXPECT_EQ(get_data(icon2), "abc");
+	EXPECT_EQ(get_data(get_resource_data_by_name(*loaded,
+		resource_type::dialog, u"NAME", 0u)), std::string_view("xyz\0\0", 5u));
+
+	const auto& custom = loaded->entry_by_name(u"CUSTOM").get_directory()
+		.entry_by_name(u"NAME").get_directory().entry_by_id(1049u).get_data();
+	EXPECT_EQ(get_data(custom.get_raw_data()), "12345");
+	EXPECT_EQ(custom.get_descriptor()->offset_to_data, directory_rva + data_offset);
+
+	//Identical blobs are written once
+	const auto& icon_dir = loaded->entry_by_id(
+		static_cast<resource_id_type>(resource_type::icon)).get_directory();
+	EXPECT_EQ(icon_dir.entry_by_id(1u).get_directory().entry_by_id(1033u)
+		.get_data().get_descriptor()->offset_to_data, directory_rva + data_offset + 8u);
+	EXPECT_EQ(icon_dir.entry_by_id(2u).get_directory().entry_by_id(1033u)
+		.get_data().get_descriptor()->offset_to_data, directory_rva + data_offset + 8u);
+
+	//Identical names are written once
+	EXPECT_EQ(loaded->entry_by_name(u"CUSTOM").get_directory().get_entries()[0]
+		.get_descriptor()->name_or_id,
+		loaded->entry_by_id(static_cast<resource_id_type>(resource_type::dialog))
+		.get_directory().get_entries()[0].get_descriptor()->name_or_id);
+}
+
+TEST_F(ResourceDirectoryBuilderTestFixture, RebuildEditedLoadedDirectory)
+{
+	static constexpr rva_type directory_rva = 0x1000u;
+	auto instance = create_test_image({});
+	(void)build_new(instance, root, { .directory_rva = directory_rva });
+	auto loaded = load(instance, { .copy_raw_data = true });
+	ASSERT_TRUE(loaded);
+
+	//Renaming an entry returned by a lookup does not reset the sorted flag
+	auto& icon_dir = loaded->entry_by_id(
+		static_cast<resource_id_type>(resource_type::icon)).get_directory();
+	ASSERT_TRUE(icon_dir.has_sorted_entries());
+	icon_dir.entry_by_id(1u).get_id() = 3u;
+
+	auto rebuilt_instance = create_test_image({});
+	(void)build_new(rebuilt_instance, *loaded, { .directory_rva = directory_rva });
+	auto rebuilt = load(rebuilt_instance, { .copy_raw_data = true });
+	ASSERT_TRUE(rebuilt);
+	const auto& rebuilt_icon_dir = rebuilt->entry_by_id(
+		static_cast<resource_id_type>(resource_type::icon)).get_directory();
+	EXPECT_FALSE(rebuilt_icon_dir.has_errors());
+	EXPECT_TRUE(rebuilt_icon_dir.has_sorted_entries());
+	EXPECT_EQ(rebuilt_icon_dir.get_entries()[0].get_id(), 2u);
+	EXPECT_EQ(get_data(get_resource_data_by_id(*rebuilt,
+		resource_type::icon, 3u, 1033u)), "abc");
+	EXPECT_EQ(get_data(get_resource_data_by_id(*rebuilt,
+		resource_type::icon, 2u, 1033u)), "abc");
+}
+
+TEST_F(ResourceDirectoryBuilderTestFixture, BuildNoDeduplication)
+{
+	static constexpr builder_options options{
+		.deduplicate_data = false,
+		.deduplicate_names = false,
+		.data_alignment = 4u
+	};
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buf(data);
+	static constexpr std::uint32_t expected_size
+		= data_offset + (2u + 8u) + 2u /* alignment */ + 4u + 4u + 8u + 8u;
+	EXPECT_EQ(get_built_size(root, options), expected_size);
+	EXPECT_EQ(build_new(buf, root, options), expected_size);
+	EXPECT_EQ(data.size(), expected_size);
+}
+
+TEST_F(ResourceDirectoryBuilderTestFixture, Errors)
+{
+	expect_throw_pe_error([this] {
+		(void)get_built_size(root, { .data_alignment = 2u });
+	}, resource_directory_builder_errc::invalid_data_alignment);
+	expect_throw_pe_error([this] {
+		(void)get_built_size(root, { .data_alignment = 12u });
+	}, resource_directory_builder_errc::invalid_data_alignment);
+
+	root.get_entries().emplace_back();
+	expect_throw_pe_error([this] {
+		(void)get_built_size(root);
+	}, resource_directory_builder_errc::invalid_directory_entry);
+}
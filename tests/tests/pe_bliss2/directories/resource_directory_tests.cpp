@@ -2,9 +2,9 @@
 
 #include <utility>
 
-#include "pe_bliss2/packed_utf16_string.h"
 #include "pe_bliss2/pe_types.h"
 #include "pe_bliss2/resources/resource_directory.h"
+#include "pe_bliss2/resources/resource_types.h"
 #include "tests/pe_bliss2/pe_error_helper.h"
 
 using namespace pe_bliss::resources;
@@ -15,7 +15,7 @@ TEST(ResourceDirectoryTests, IsNamed)
 	EXPECT_FALSE(entry.is_named());
 
 	EXPECT_NO_THROW(entry.get_name_or_id().emplace<
-		pe_bliss::packed_utf16_string>(u"abc"));
+		resource_name_type>(u"abc"));
 	EXPECT_TRUE(entry.is_named());
 	EXPECT_EQ(entry.get_name().value(), u"abc");
 	EXPECT_EQ(std::as_const(entry).get_name().value(), u"abc");
@@ -192,3 +192,62 @@ TEST(ResourceDirectoryTests, EmplaceDataEntryByName)
 		(void)dir.try_emplace_entry_by_name(directory_entry_contents::directory, u"abc");
 	}, resource_directory_errc::entry_does_not_contain_directory);
 }
+
+TEST(ResourceDirectoryTests, SortedEntryLookup)
+{
+	resource_directory dir;
+	dir.get_entries().emplace_back().get_name_or_id() = 3u;
+	dir.get_entries().emplace_back().get_name_or_id() = resource_name_type(u"def");
+	dir.get_entries().emplace_back().get_name_or_id() = 1u;
+	dir.get_entries().emplace_back().get_name_or_id() = resource_name_type(u"abc");
+	EXPECT_FALSE(dir.has_sorted_entries());
+	dir.sort_entries();
+	ASSERT_TRUE(dir.has_sorted_entries());
+
+	const auto& entries = std::as_const(dir).get_entries();
+	EXPECT_EQ(dir.entry_iterator_by_name(u"abc"), entries.begin());
+	EXPECT_EQ(dir.entry_iterator_by_name(u"def"), entries.begin() + 1u);
+	EXPECT_EQ(dir.entry_iterator_by_id(1u), entries.begin() + 2u);
+	EXPECT_EQ(std::as_const(dir).entry_iterator_by_id(3u), entries.cbegin() + 3u);
+	EXPECT_EQ(dir.entry_iterator_by_id(2u), entries.end());
+	EXPECT_EQ(dir.entry_iterator_by_id(4u), entries.end());
+	EXPECT_EQ(dir.entry_iterator_by_name(u"aaa"), entries.end());
+	EXPECT_EQ(dir.entry_iterator_by_name(u"xyz"), entries.end());
+	EXPECT_TRUE(dir.has_sorted_entries());
+}
+
+TEST(ResourceDirectoryTests, EditedEntryLookup)
+{
+	resource_directory dir;
+	dir.get_entries().emplace_back().get_name_or_id() = resource_name_type(u"def");
+	dir.get_entries().emplace_back().get_name_or_id() = 3u;
+	dir.sort_entries();
+
+	dir.get_entries().emplace_back().get_name_or_id() = 1u;
+	dir.get_entries().emplace_back().get_name_or_id() = resource_name_type(u"abc");
+	EXPECT_FALSE(dir.has_sorted_entries());
+	EXPECT_EQ(dir.try_entry_by_id(1u), &dir.get_entries()[2]);
+	EXPECT_EQ(dir.try_entry_by_name(u"abc"), &dir.get_entries()[3]);
+	EXPECT_EQ(dir.try_entry_by_id(3u), &dir.get_entries()[1]);
+}
+
+TEST(ResourceDirectoryTests, EmplaceKeepsEntriesSorted)
+{
+	resource_directory dir;
+	dir.set_sorted_entries(true);
+	(void)dir.try_emplace_entry_by_id(5u, directory_entry_contents::data);
+	(void)dir.try_emplace_entry_by_name(u"xyz", directory_entry_contents::data);
+	(void)dir.try_emplace_entry_by_id(2u, directory_entry_contents::data);
+	(void)dir.try_emplace_entry_by_name(directory_entry_contents::data, u"abc");
+	(void)dir.try_emplace_entry_by_id(5u, directory_entry_contents::data);
+	EXPECT_TRUE(dir.has_sorted_entries());
+
+	const auto& entries = std::as_const(dir).get_entries();
+	ASSERT_EQ(entries.size(), 4u);
+	EXPECT_EQ(entries[0].get_name().value(), u"abc");
+	EXPECT_EQ(entries[1].get_name().value(), u"xyz");
+	EXPECT_EQ(entries[2].get_id(), 2u);
+	EXPECT_EQ(entries[3].get_id(), 5u);
+	EXPECT_EQ(dir.try_entry_by_id(2u), &entries[2]);
+	EXPECT_EQ(dir.try_entry_by_name(u"xyz"), &entries[1]);
+}
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include "pe_bliss2/resources/resource_directory.h"
+#include "pe_bliss2/resources/resource_index.h"
+#include "pe_bliss2/resources/resource_reader.h"
+#include "pe_bliss2/resources/resource_writer.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss::resources;
+
+namespace
+{
+resource_directory create_directory()
+{
+	resource_directory root;
+	(void)try_emplace_resource_data_by_id(root, resource_type::string, 2u, 0x409u);
+	(void)try_emplace_resource_data_by_id(root, resource_type::string, 1u, 0x419u);
+	(void)try_emplace_resource_data_by_id(root, resource_type::string, 1u, 0x409u);
+	(void)try_emplace_resource_data_by_name(root, resource_type::string, u"abc", 0x409u);
+	(void)try_emplace_resource_data_by_id(root, resource_type::icon, 1u, 0x409u);
+	(void)root.try_emplace_entry_by_name(u"CUSTOM", directory_entry_contents::directory)
+		.get_directory().try_emplace_entry_by_id(7u, directory_entry_contents::directory)
+		.get_directory().try_emplace_entry_by_id(0u, directory_entry_contents::data);
+	//Skipped: not a three-level resource
+	(void)root.try_emplace_entry_by_id(100u, directory_entry_contents::data);
+	return root;
+}
+} //namespace
+
+TEST(ResourceIndexTests, Empty)
+{
+	resource_directory root;
+	resource_index index(root);
+	EXPECT_TRUE(index.get_entries().empty());
+	EXPECT_EQ(index.try_get_data(resource_type::icon, 1u, 0u), nullptr);
+	EXPECT_TRUE(index.get_resources(resource_type::icon).empty());
+}
+
+TEST(ResourceIndexTests, Lookup)
+{
+	auto root = create_directory();
+	resource_index index(root);
+	ASSERT_EQ(index.get_entries().size(), 6u);
+
+	ASSERT_NE(index.try_get_data(resource_type::string, 1u, 0x409u), nullptr);
+	EXPECT_EQ(&index.try_get_data(resource_type::string, 1u, 0x409u)->get_raw_data(),
+		&get_resource_data_by_id(root, resource_type::string, 1u, 0x409u));
+	ASSERT_NE(index.try_get_data(resource_type::string, u"abc", 0x409u), nullptr);
+	EXPECT_EQ(&index.try_get_data(resource_type::string, u"abc", 0x409u)->get_raw_data(),
+		&get_resource_data_by_name(root, resource_type::string, u"abc", 0x409u));
+	EXPECT_EQ(&index.get_data(u"CUSTOM", 7u, 0u), &root.entry_by_name(u"CUSTOM")
+		.get_directory().entry_by_id(7u).get_directory().entry_by_id(0u).get_data());
+
+	EXPECT_EQ(index.try_get_data(resource_type::string, 3u, 0x409u), nullptr);
+	EXPECT_EQ(index.try_get_data(resource_type::string, u"abd", 0x409u), nullptr);
+	EXPECT_EQ(index.try_get_data(resource_type::icon, 1u, 0x419u), nullptr);
+	EXPECT_EQ(index.try_get_data(100u, 1u, 0u), nullptr);
+	expect_throw_pe_error([&index] {
+		(void)index.get_data(resource_type::bitmap, 1u, 0x409u);
+	}, resource_directory_errc::entry_does_not_exist);
+}
+
+TEST(ResourceIndexTests, Ranges)
+{
+	auto root = create_directory();
+	resource_index index(root);
+
+	auto languages = index.get_languages(resource_type::string, 1u);
+	ASSERT_EQ(languages.size(), 2u);
+	EXPECT_EQ(languages[0].language, 0x409u);
+	EXPECT_EQ(languages[1].language, 0x419u);
+
+	auto strings = index.get_resources(resource_type::string);
+	ASSERT_EQ(strings.size(), 4u);
+	EXPECT_EQ(strings[0].name_or_id, resource_name_or_id_view(u"abc"));
+	EXPECT_EQ(strings[1].name_or_id, resource_name_or_id_view(1u));
+	EXPECT_EQ(strings[3].name_or_id, resource_name_or_id_view(2u));
+
+	EXPECT_EQ(index.get_resources(u"CUSTOM").size(), 1u);
+	EXPECT_TRUE(index.get_languages(resource_type::icon, 2u).empty());
+}
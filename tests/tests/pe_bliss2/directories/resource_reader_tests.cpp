@@ -6,9 +6,9 @@
 #include "gtest/gtest.h"
 
 #include "buffers/ref_buffer.h"
-#include "pe_bliss2/packed_utf16_string.h"
 #include "pe_bliss2/resources/lcid.h"
 #include "pe_bliss2/resources/resource_reader.h"
+#include "pe_bliss2/resources/resource_types.h"
 #include "tests/pe_bliss2/pe_error_helper.h"
 
 using namespace pe_bliss;
@@ -20,7 +20,7 @@ TEST(ResourceReaderTests, ListResourceTypes)
 	EXPECT_TRUE(list_resource_types(dir).empty());
 
 	dir.get_entries().emplace_back().get_name_or_id() = 1u;
-	dir.get_entries().emplace_back().get_name_or_id() = packed_utf16_string(u"abc");
+	dir.get_entries().emplace_back().get_name_or_id() = resource_name_type(u"abc");
 	dir.get_entries().emplace_back().get_name_or_id() = 2u;
 	dir.get_entries().emplace_back().get_name_or_id() = 1u;
 	auto types = list_resource_types(dir);
@@ -69,7 +69,7 @@ TEST(ResourceReaderTests, GetDirectoryByName)
 	}, resource_directory_errc::entry_does_not_exist);
 
 	auto& entry = dir.get_entries().emplace_back();
-	entry.get_name_or_id() = packed_utf16_string(u"abc");
+	entry.get_name_or_id() = resource_name_type(u"abc");
 
 	entry.get_data_or_directory() = resource_data_entry{};
 	expect_throw_pe_error([&dir] {
@@ -107,7 +107,7 @@ resource_directory create_resources(resource_type Type,
 	if constexpr (std::is_same_v<std::remove_cvref_t<
 		std::remove_pointer_t<std::decay_t<NameOrId>>>, char16_t>)
 	{
-		name_entry.get_name_or_id() = packed_utf16_string(name_or_id);
+		name_entry.get_name_or_id() = resource_name_type(name_or_id);
 	}
 	else
 	{
@@ -244,7 +244,7 @@ TEST(ResourceReaderTests, ForEachResource)
 
 	auto& name_dir1 = entry1.get_directory();
 	auto& name_entry1 = name_dir1.get_entries().emplace_back();
-	name_entry1.get_name_or_id() = packed_utf16_string(u"abc");
+	name_entry1.get_name_or_id() = resource_name_type(u"abc");
 	name_entry1.get_data_or_directory() = resource_directory{};
 
 	auto& lang_dir1 = name_entry1.get_directory();
@@ -254,7 +254,7 @@ TEST(ResourceReaderTests, ForEachResource)
 	lang_entry1.get_data().get_raw_data().copied_data() = resource_data;
 
 	auto& lang_entry2 = lang_dir1.get_entries().emplace_back();
-	lang_entry2.get_name_or_id() = packed_utf16_string(u"xxx");
+	lang_entry2.get_name_or_id() = resource_name_type(u"xxx");
 	lang_entry2.get_data_or_directory() = resource_data_entry{};
 	lang_entry2.get_data().get_raw_data().copied_data() = resource_data;
 
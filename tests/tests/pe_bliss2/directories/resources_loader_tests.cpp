@@ -4,6 +4,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <variant>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "pe_bliss2/resources/resource_directory.h"
 #include "pe_bliss2/resources/resource_directory_loader.h"
 #include "pe_bliss2/pe_types.h"
+#include "utilities/scoped_guard.h"
 
 #include "tests/pe_bliss2/image_helper.h"
 #include "tests/pe_bliss2/pe_error_helper.h"
@@ -83,6 +85,7 @@ public:
 	{
 		ASSERT_TRUE(dir0);
 		expect_contains_errors(*dir0, resource_directory_loader_errc::unsorted_entries);
+		EXPECT_FALSE(dir0->has_sorted_entries());
 
 		const auto& dir0_entries = dir0->get_entries();
 		ASSERT_EQ(dir0_entries.size(), number_of_named_entries_0 + number_of_id_entries_0);
@@ -92,7 +95,7 @@ public:
 		ASSERT_NE(dir0_id0, nullptr);
 		EXPECT_EQ(*dir0_id0, dir0_entry0_id);
 		expect_contains_errors(dir0_entries[1]);
-		const auto* dir0_name1 = std::get_if<packed_utf16_string>(
+		const auto* dir0_name1 = std::get_if<resource_name_type>(
 			&dir0_entries[1].get_name_or_id());
 		ASSERT_NE(dir0_name1, nullptr);
 		EXPECT_EQ(dir0_name1->value(), u"abc");
@@ -104,6 +107,7 @@ public:
 		expect_contains_errors(*dir1,
 			resource_directory_loader_errc::invalid_number_of_named_and_id_entries);
 		ASSERT_NE(dir1, nullptr);
+		EXPECT_TRUE(dir1->has_sorted_entries());
 		const auto& dir1_entries = dir1->get_entries();
 		ASSERT_EQ(dir1_entries.size(), number_of_named_entries_1 + number_of_id_entries_1);
 		expect_contains_errors(dir1_entries[0]);
@@ -251,6 +255,31 @@ TEST_F(ResourcesLoaderTestFixture, ValidDirectoryCopyBuffers)
 		{ .copy_raw_data = true }), true);
 }
 
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+TEST_F(ResourcesLoaderTestFixture, ValidDirectoryMemoryResource)
+{
+	add_resource_dir();
+	add_resource_dir_descriptors();
+	std::array<std::byte, 0x10000u> buffer{};
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+		std::pmr::null_memory_resource());
+	//Entries, names and error lists must not be allocated from the default resource
+	auto* default_resource = std::pmr::set_default_resource(
+		std::pmr::null_memory_resource());
+	utilities::scoped_guard restore([default_resource] {
+		std::pmr::set_default_resource(default_resource); });
+	auto dir0 = resources::load(instance, { .memory_resource = &arena });
+	validate_resources(dir0, false);
+	ASSERT_TRUE(dir0);
+	const auto& dir0_entries = dir0->get_entries();
+	EXPECT_EQ(dir0_entries.get_allocator().resource(), &arena);
+	const auto* dir0_name1 = std::get_if<resource_name_type>(
+		&dir0_entries[1].get_name_or_id());
+	ASSERT_NE(dir0_name1, nullptr);
+	EXPECT_EQ(dir0_name1->value().get_allocator().resource(), &arena);
+}
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
 TEST_F(ResourcesLoaderTestFixture, HeaderDirectoryErr)
 {
 	add_resource_dir_to_headers();
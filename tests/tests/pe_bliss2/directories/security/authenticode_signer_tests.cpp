@@ -0,0 +1,469 @@
+#include "pe_bliss2/security/authenticode_signer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cryptopp/queue.h"
+#include "cryptopp/rsa.h"
+#include "cryptopp/sha.h"
+
+#include "buffers/input_memory_buffer.h"
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/detail/security/image_security_directory.h"
+#include "pe_bliss2/image/checksum.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_builder.h"
+#include "pe_bliss2/image/image_loader.h"
+#include "pe_bliss2/security/authenticode_loader.h"
+#include "pe_bliss2/security/der_helpers.h"
+#include "pe_bliss2/security/image_hash.h"
+#include "pe_bliss2/security/image_authenticode_verifier.h"
+#include "pe_bliss2/security/security_directory_loader.h"
+
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss::security;
+
+namespace
+{
+//RSA-1024 PKCS#8 private key
+constexpr std::string_view test_private_key =
+	"30820276020100300d06092a864886f70d0101010500048202603082025c02010002818100ec5f65bc13e36b991f770a"
+	"f347b92690d96c4ba7e86e93d63bc8d5c51fb0b2b47965f6d28453795b389cbab34ad7ae301b7041ed9767f324a79daa"
+	"43d1a0f198df92ba20f761bd731924600419d8ecab775a76130943f4080432c1df89a3ffbf55857b9b23b47ca8ea9b82"
+	"ef42a247ba8125328f365374ce0f1d3f03864aca35020301000102818004118046c470dda13d116776d87d2f54bee946"
+	"44159411a75650169dd5f5cc9d9e994aae44e8cae5ef0b838b2276a3e0e018068a7858a9aeafd3dee25bf151372fe977"
+	"efcf8ea83c4f9841a3921cb80101076cb45a55145e533e449efaeefc9704e3fc5860c27415dc1231a32776d2a896505f"
+	"7f9645174ce080d1f3ee524ee1024100fc300be5701b14c759ba1bc203cdd5a844d25525078d08a8db39a64ffb1cabe1"
+	"8472d5d56b704d32a06f2f49b3cdfeaf22be988c8e2b543c68d1d10d998d14c7024100eff225c5a10aca7e6569fc94c0"
+	"a4ef9606dc2926824c17fd34a3ce1d465dad4899ec3d4aea75ec36b54814b3d530663a5a8d39cae131c1b60198f16be0"
+	"6e752302401e32068a9f44aed53bba1beebc13de3c3a9950969173e2908d4736d1a6c885100892d365ad6a91e3b8eff7"
+	"228503ea35c01c4019bc4015e2f1ce0590f24cc12b024100b6f2a92c1b52effc19750b399bfce6143cdcc69f6eff77d6"
+	"feb8daa1e591ed5a8ac9de1dedd0c5af1cdf7db1741e3803cc211bec7d7183a2336b9abfc6da518302402891b1df7902"
+	"2c41e6982fad9f6c361f435c82022737bd297168786ff49cfdcff8b9b0ab603843a11b8cd8124ae9366be551d281f36c"
+	"69b80b8a7244651dddd1";
+
+//PKCS#1 RSAPrivateKey inside the PKCS#8 key
+constexpr std::size_t pkcs1_private_key_offset = 26u;
+
+//Self-signed certificate, CN=pe_bliss test signer, serial 0x1234
+constexpr std::string_view test_certificate =
+	"3082020830820171a00302010202021234300d06092a864886f70d01010b0500301f311d301b06035504030c1470655f"
+	"626c6973732074657374207369676e6572301e170d3236313031383233353034345a170d333631303135323335303434"
+	"5a301f311d301b06035504030c1470655f626c6973732074657374207369676e657230819f300d06092a864886f70d01"
+	"0101050003818d0030818902818100ec5f65bc13e36b991f770af347b92690d96c4ba7e86e93d63bc8d5c51fb0b2b479"
+	"65f6d28453795b389cbab34ad7ae301b7041ed9767f324a79daa43d1a0f198df92ba20f761bd731924600419d8ecab77"
+	"5a76130943f4080432c1df89a3ffbf55857b9b23b47ca8ea9b82ef42a247ba8125328f365374ce0f1d3f03864aca3502"
+	"03010001a3533051301d0603551d0e04160414c3557e4be37d39359b4a3819b4965866ef9d1730301f0603551d230418"
+	"30168014c3557e4be37d39359b4a3819b4965866ef9d1730300f0603551d130101ff040530030101ff300d06092a8648"
+	"86f70d01010b05000381810061a49b139e4e378652088df835aa986e5daad6cd3d72ca851e8240b7be2bf0251c87650e"
+	"b4c0db1ddc306c537f9cc1f6ba7d51e6d3aceeb5f916ea09d0eaeb9023db4b8b12183caf5f47dd2595d8ca4cfcc65d09"
+	"3b0b0ca6defb2f03a5b7aa17c0f29c441b31dc29549b8ff864ea3ed58329ba38ac6d1bb4da2b89f0c3d9399c";
+
+//1.3.6.1.4.1.311.2.4.1
+constexpr std::string_view nested_signature_oid = "060a2b060104018237020401";
+
+class AuthenticodeSignerTest : public ::testing::Test
+{
+public:
+	AuthenticodeSignerTest()
+		: private_key_(hex_string_to_bytes(test_private_key))
+		, certificate_(hex_string_to_bytes(test_certificate))
+	{
+		options_.signer_certificate = certificate_;
+		options_.private_key = private_key_;
+	}
+
+protected:
+	struct parsed_signature
+	{
+		std::vector<der::element> signed_data_fields;
+		std::vector<der::element> signer_info_fields;
+		span_range_type image_hash;
+		span_range_type indirect_data_content;
+	};
+
+	static pe_bliss::image::image load_test_image(std::vector<std::byte>& data,
+		std::size_t overlay_size = 0u)
+	{
+		auto instance = create_test_image({
+			.sections = { { 0x1000u, 0x1000u }, { 0x600u, 0x600u } } });
+		std::uint8_t value = 1u;
+		for (auto& section : instance.get_section_data_list())
+		{
+			for (auto& byte : section.copied_data())
+				byte = std::byte{ value++ };
+		}
+
+		data.clear();
+		buffers::output_memory_buffer buffer(data);
+		pe_bliss::image::image_builder::build(instance, buffer);
+		data.resize(0x2600u + overlay_size, std::byte{ 0xabu });
+
+		auto load_result = pe_bliss::image::image_loader::load(
+			std::make_shared<buffers::input_memory_buffer>(data.data(), data.size()));
+		EXPECT_TRUE(load_result);
+		return std::move(load_result.image);
+	}
+
+	//Image builder does not write the overlay
+	static std::vector<std::byte> build_signed_image(const pe_bliss::image::image& instance)
+	{
+		std::vector<std::byte> data;
+		buffers::output_memory_buffer buffer(data);
+		pe_bliss::image::image_builder::build(instance, buffer);
+		const auto& overlay = instance.get_overlay().copied_data();
+		data.insert(data.end(), overlay.begin(), overlay.end());
+		return data;
+	}
+
+	static std::vector<std::byte> get_signature(const pe_bliss::image::image& instance)
+	{
+		auto directory = load(instance);
+		EXPECT_TRUE(directory);
+		if (!directory)
+			return {};
+
+		EXPECT_FALSE(directory->has_errors());
+		EXPECT_EQ(directory->get_entries().size(), 1u);
+		if (directory->get_entries().empty())
+			return {};
+
+		auto& entry = directory->get_entries()[0];
+		EXPECT_EQ(entry.get_descriptor()->certificate_type,
+			pe_bliss::detail::security::win_cert_type_pkcs_signed_data);
+		EXPECT_EQ(entry.get_descriptor()->revision,
+			pe_bliss::detail::security::win_cert_revision_2_0);
+		return entry.get_certificate().copied_data();
+	}
+
+	static parsed_signature parse_signature(span_range_type signature)
+	{
+		parsed_signature result;
+		der::element content_info, signed_data;
+		std::vector<der::element> content_info_fields, signer_infos;
+		EXPECT_TRUE(der::read_element(signature, der::tag::sequence, content_info));
+		EXPECT_TRUE(signature.empty());
+		EXPECT_TRUE(der::read_children(content_info.value, content_info_fields));
+		EXPECT_EQ(content_info_fields.size(), 2u);
+		if (content_info_fields.size() != 2u)
+			return result;
+
+		auto signed_data_content = content_info_fields[1].value;
+		EXPECT_TRUE(der::read_element(signed_data_content,
+			der::tag::sequence, signed_data));
+		EXPECT_TRUE(der::read_children(signed_data.value, result.signed_data_fields));
+		EXPECT_EQ(result.signed_data_fields.size(), 5u);
+		if (result.signed_data_fields.size() != 5u)
+			return result;
+
+		EXPECT_TRUE(der::read_children(result.signed_data_fields[4].value, signer_infos));
+		EXPECT_EQ(signer_infos.size(), 1u);
+		if (signer_infos.empty())
+			return result;
+
+		EXPECT_TRUE(der::read_children(signer_infos[0].value, result.signer_info_fields));
+
+		std::vector<der::element> content_fields, indirect_data_fields, digest_info;
+		EXPECT_TRUE(der::read_children(result.signed_data_fields[2].value, content_fields));
+		EXPECT_EQ(content_fields.size(), 2u);
+		if (content_fields.size() != 2u)
+			return result;
+
+		result.indirect_data_content = content_fields[1].value;
+		auto indirect_data_content = result.indirect_data_content;
+		der::element indirect_data;
+		EXPECT_TRUE(der::read_element(indirect_data_content,
+			der::tag::sequence, indirect_data));
+		EXPECT_TRUE(der::read_children(indirect_data.value, indirect_data_fields));
+		EXPECT_EQ(indirect_data_fields.size(), 2u);
+		if (indirect_data_fields.size() != 2u)
+			return result;
+
+		EXPECT_TRUE(der::read_children(indirect_data_fields[1].value, digest_info));
+		EXPECT_EQ(digest_info.size(), 2u);
+		if (digest_info.size() == 2u)
+			result.image_hash = digest_info[1].value;
+		return result;
+	}
+
+	void check_signer_signature(const parsed_signature& signature) const
+	{
+		ASSERT_EQ(signature.signer_info_fields.size(), 6u);
+		const auto& attributes = signature.signer_info_fields[3];
+		ASSERT_EQ(attributes.tag, der::tag::context_specific(0u, true));
+		std::vector<std::byte> signed_attributes(
+			attributes.raw.begin(), attributes.raw.end());
+		signed_attributes[0] = der::tag::set;
+
+		CryptoPP::RSA::PrivateKey key;
+		CryptoPP::ByteQueue queue;
+		queue.Put(reinterpret_cast<const CryptoPP::byte*>(private_key_.data()),
+			private_key_.size());
+		queue.MessageEnd();
+		key.BERDecode(queue);
+		const CryptoPP::RSA::PublicKey public_key(key);
+		CryptoPP::RSASS<CryptoPP::PKCS1v15, CryptoPP::SHA256>::Verifier verifier(public_key);
+		const auto encrypted_digest = signature.signer_info_fields[5].value;
+		EXPECT_TRUE(verifier.VerifyMessage(
+			reinterpret_cast<const CryptoPP::byte*>(signed_attributes.data()),
+			signed_attributes.size(),
+			reinterpret_cast<const CryptoPP::byte*>(encrypted_digest.data()),
+			encrypted_digest.size()));
+	}
+
+	static bool contains(span_range_type data, std::string_view hex)
+	{
+		const auto bytes = hex_string_to_bytes(hex);
+		return !std::ranges::search(data, bytes).empty();
+	}
+
+protected:
+	std::vector<std::byte> private_key_;
+	std::vector<std::byte> certificate_;
+	authenticode_signing_options options_;
+};
+} //namespace
+
+TEST_F(AuthenticodeSignerTest, SignImage)
+{
+	std::vector<std::byte> data;
+	auto instance = load_test_image(data);
+	options_.add_page_hashes = true;
+	options_.program_name = u"Test";
+	options_.more_info_url = "http://example.com";
+	options_.signing_time = std::chrono::sys_days(
+		std::chrono::year_month_day(std::chrono::year(2026), std::chrono::October,
+			std::chrono::day(18)));
+	ASSERT_NO_THROW(sign_image(instance, options_));
+
+	const auto& security_dir = instance.get_data_directories().get_directory(
+		pe_bliss::core::data_directories::directory_type::security);
+	EXPECT_EQ(security_dir->virtual_address, 0x2600u);
+	EXPECT_EQ(security_dir->size % 8u, 0u);
+	EXPECT_EQ(instance.get_overlay().copied_data().size(), security_dir->size);
+	EXPECT_EQ(instance.get_optional_header().get_raw_checksum(),
+		pe_bliss::image::calculate_checksum(instance));
+
+	const auto signature = get_signature(instance);
+	const auto parsed = parse_signature(signature);
+	check_signer_signature(parsed);
+
+	const page_hash_options page_hash_opts{ .algorithm = digest_algorithm::sha256 };
+	const auto hash = calculate_hash(digest_algorithm::sha256, instance, &page_hash_opts);
+	EXPECT_TRUE(std::ranges::equal(parsed.image_hash, hash.image_hash));
+	EXPECT_FALSE(hash.page_hashes.empty());
+	EXPECT_TRUE(contains(parsed.indirect_data_content,
+		//Page hashes class id
+		"a6b586d5b4a12466ae05a217da8e60d6"));
+	EXPECT_TRUE(!std::ranges::search(parsed.indirect_data_content,
+		hash.page_hashes).empty());
+	//UTCTime 261018000000Z
+	EXPECT_TRUE(contains(parsed.signer_info_fields[3].value,
+		"170d3236313031383030303030305a"));
+	//BMPString "Test"
+	EXPECT_TRUE(contains(parsed.signer_info_fields[3].value,
+		"80080054006500730074"));
+	EXPECT_TRUE(std::ranges::equal(parsed.signed_data_fields[3].value, certificate_));
+
+	const auto signed_data = build_signed_image(instance);
+	std::istringstream stream(std::string(
+		reinterpret_cast<const char*>(signed_data.data()), signed_data.size()));
+	const auto stream_hash = calculate_stream_hash(stream);
+	const auto* digest = stream_hash.find_digest(digest_algorithm::sha256);
+	ASSERT_NE(digest, nullptr);
+	EXPECT_TRUE(std::ranges::equal(parsed.image_hash, digest->hash.image_hash));
+	ASSERT_TRUE(stream_hash.security_directory);
+	EXPECT_EQ(stream_hash.security_directory->absolute_offset(), 0x2600u);
+}
+
+TEST_F(AuthenticodeSignerTest, SignAndVerifyImage)
+{
+	for (auto alg : { digest_algorithm::sha1, digest_algorithm::sha256 })
+	{
+		std::vector<std::byte> data;
+		auto instance = load_test_image(data);
+		options_.digest_alg = alg;
+		options_.add_page_hashes = true;
+		ASSERT_NO_THROW(sign_image(instance, options_));
+
+		const auto signature_data = get_signature(instance);
+		buffers::input_memory_buffer signature_buffer(
+			signature_data.data(), signature_data.size());
+		const auto signature = load_authenticode_signature<span_range_type>(
+			signature_buffer);
+		EXPECT_TRUE(std::ranges::equal(signature.get_image_hash(),
+			calculate_hash(alg, instance).image_hash));
+
+		const auto signed_data = build_signed_image(instance);
+		auto load_result = pe_bliss::image::image_loader::load(
+			std::make_shared<buffers::input_memory_buffer>(
+				signed_data.data(), signed_data.size()));
+		ASSERT_TRUE(load_result);
+
+		const auto result = verify_authenticode(load_result.image);
+		ASSERT_TRUE(result);
+		EXPECT_FALSE(result->error);
+		const auto& status = result->authenticode_status;
+		EXPECT_TRUE(status);
+		EXPECT_TRUE(status.nested.empty());
+		EXPECT_EQ(status.root.image_digest_alg, alg);
+		EXPECT_EQ(status.root.image_hash_valid, true);
+		EXPECT_EQ(status.root.page_hashes_valid, true);
+		EXPECT_FALSE(status.root.page_hashes_check_errc);
+		EXPECT_EQ(status.root.message_digest_valid, true);
+		ASSERT_TRUE(status.root.signature_result);
+		EXPECT_TRUE(*status.root.signature_result);
+		EXPECT_FALSE(status.root.cert_store);
+		ASSERT_TRUE(status.root.lazy_cert_store);
+		EXPECT_EQ(status.root.lazy_cert_store->get_decoded_count(), 1u);
+	}
+}
+
+TEST_F(AuthenticodeSignerTest, SignImageNoPageHashes)
+{
+	std::vector<std::byte> data;
+	auto instance = load_test_image(data);
+	options_.digest_alg = digest_algorithm::sha1;
+	options_.update_checksum = false;
+	ASSERT_NO_THROW(sign_image(instance, options_));
+
+	EXPECT_EQ(instance.get_optional_header().get_raw_checksum(), 0u);
+	const auto signature = get_signature(instance);
+	const auto parsed = parse_signature(signature);
+	const auto hash = calculate_hash(digest_algorithm::sha1, instance);
+	EXPECT_TRUE(std::ranges::equal(parsed.image_hash, hash.image_hash));
+	EXPECT_FALSE(contains(parsed.indirect_data_content,
+		"a6b586d5b4a12466ae05a217da8e60d6"));
+}
+
+TEST_F(AuthenticodeSignerTest, PkcsOnePrivateKey)
+{
+	std::vector<std::byte> data;
+	auto instance = load_test_image(data);
+	options_.private_key = span_range_type(private_key_).subspan(pkcs1_private_key_offset);
+	ASSERT_NO_THROW(sign_image(instance, options_));
+	check_signer_signature(parse_signature(get_signature(instance)));
+}
+
+TEST_F(AuthenticodeSignerTest, ResignKeepsOverlay)
+{
+	static constexpr std::size_t overlay_size = 5u;
+	std::vector<std::byte> data;
+	auto instance = load_test_image(data, overlay_size);
+	ASSERT_NO_THROW(sign_image(instance, options_));
+	const auto first_signature_size = instance.get_overlay().copied_data().size();
+	ASSERT_NO_THROW(sign_image(instance, options_));
+	EXPECT_EQ(instance.get_overlay().copied_data().size(), first_signature_size);
+
+	const auto& overlay = instance.get_overlay().copied_data();
+	EXPECT_TRUE(std::all_of(overlay.begin(), overlay.begin() + overlay_size,
+		[](std::byte b) { return b == std::byte{ 0xabu }; }));
+	EXPECT_EQ(instance.get_data_directories().get_directory(
+		pe_bliss::core::data_directories::directory_type::security)->virtual_address,
+		0x2608u);
+	check_signer_signature(parse_signature(get_signature(instance)));
+}
+
+TEST_F(AuthenticodeSignerTest, NestedSignature)
+{
+	std::vector<std::byte> data;
+	auto instance = load_test_image(data);
+	options_.digest_alg = digest_algorithm::sha1;
+	ASSERT_NO_THROW(sign_image(instance, options_));
+	const auto primary_signature = get_signature(instance);
+
+	options_.digest_alg = digest_algorithm::sha256;
+	options_.nested = true;
+	ASSERT_NO_THROW(sign_image(instance, options_));
+	ASSERT_NO_THROW(sign_image(instance, options_));
+
+	const auto signature = get_signature(instance);
+	const auto parsed = parse_signature(signature);
+	ASSERT_EQ(parsed.signer_info_fields.size(), 7u);
+	const auto& unauthenticated_attributes = parsed.signer_info_fields[6];
+	EXPECT_EQ(unauthenticated_attributes.tag, der::tag::context_specific(1u, true));
+
+	std::vector<der::element> attributes, attribute_fields, nested_signatures;
+	ASSERT_TRUE(der::read_children(unauthenticated_attributes.value, attributes));
+	ASSERT_EQ(attributes.size(), 1u);
+	ASSERT_TRUE(der::read_children(attributes[0].value, attribute_fields));
+	ASSERT_EQ(attribute_fields.size(), 2u);
+	EXPECT_TRUE(std::ranges::equal(attribute_fields[0].raw,
+		hex_string_to_bytes(nested_signature_oid)));
+	ASSERT_TRUE(der::read_children(attribute_fields[1].value, nested_signatures));
+	ASSERT_EQ(nested_signatures.size(), 2u);
+
+	const auto hash = calculate_hash(digest_algorithm::sha256, instance);
+	for (const auto& nested : nested_signatures)
+	{
+		const auto nested_parsed = parse_signature(nested.raw);
+		EXPECT_TRUE(std::ranges::equal(nested_parsed.image_hash, hash.image_hash));
+		check_signer_signature(nested_parsed);
+	}
+
+	//The primary signature is kept unchanged
+	const auto primary_parsed = parse_signature(primary_signature);
+	EXPECT_TRUE(std::ranges::equal(primary_parsed.image_hash,
+		parsed.image_hash));
+}
+
+TEST_F(AuthenticodeSignerTest, Errors)
+{
+	std::vector<std::byte> data;
+	auto instance = load_test_image(data);
+
+	auto options = options_;
+	options.digest_alg = digest_algorithm::md5;
+	expect_throw_pe_error([&] { sign_image(instance, options); },
+		authenticode_signer_errc::unsupported_digest_algorithm);
+
+	for (auto alg : { digest_algorithm::sha384, digest_algorithm::sha512 })
+	{
+		options = options_;
+		options.digest_alg = alg;
+		options.add_page_hashes = true;
+		expect_throw_pe_error([&] { sign_image(instance, options); },
+			authenticode_signer_errc::unsupported_page_hash_algorithm);
+	}
+
+	options = options_;
+	options.digest_alg = digest_algorithm::sha384;
+	const std::vector<std::byte> page_hashes(36u);
+	expect_throw_pe_error([&] {
+		(void)create_authenticode_signature(page_hashes, page_hashes, options);
+	}, authenticode_signer_errc::unsupported_page_hash_algorithm);
+
+	options = options_;
+	const auto invalid_data = hex_string_to_bytes("3003020101");
+	options.private_key = invalid_data;
+	expect_throw_pe_error([&] { sign_image(instance, options); },
+		authenticode_signer_errc::invalid_private_key);
+
+	options = options_;
+	options.signer_certificate = invalid_data;
+	expect_throw_pe_error([&] { sign_image(instance, options); },
+		authenticode_signer_errc::invalid_signer_certificate);
+
+	expect_throw_pe_error([&] {
+		(void)add_nested_signature(invalid_data, invalid_data);
+	}, authenticode_signer_errc::invalid_signature);
+
+	ASSERT_NO_THROW(sign_image(instance, options_));
+	instance.get_overlay().copied_data().push_back(std::byte{});
+	expect_throw_pe_error([&] { sign_image(instance, options_); },
+		authenticode_signer_errc::invalid_security_directory);
+}
@@ -0,0 +1,120 @@
+#include "pe_bliss2/security/authenticode_unauthenticated_attributes.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <system_error>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "simple_asn1/crypto/pkcs7/authenticode/oids.h"
+#include "simple_asn1/crypto/pkcs9/oids.h"
+
+using namespace pe_bliss::security;
+
+namespace
+{
+template<typename T>
+class UnauthenticatedAttributesTest : public testing::Test
+{
+public:
+	using range_type = T;
+
+public:
+	template<typename Oid>
+	void add_attribute(const Oid& oid, const std::vector<range_type>& values)
+	{
+		oids.emplace_back(oid.cbegin(), oid.cend());
+		map.get_map().try_emplace(oids.back(), values);
+	}
+
+public:
+	std::deque<std::vector<std::uint32_t>> oids;
+	pkcs7::attribute_map<range_type> map;
+};
+
+using tested_range_types = ::testing::Types<
+	vector_range_type, span_range_type>;
+
+const std::vector<std::byte> value1{ std::byte{1} };
+const std::vector<std::byte> value2{ std::byte{2}, std::byte{3} };
+const std::vector<std::byte> value3{ std::byte{4} };
+} // namespace
+
+TYPED_TEST_SUITE(UnauthenticatedAttributesTest, tested_range_types);
+
+TYPED_TEST(UnauthenticatedAttributesTest, DecodeEmpty)
+{
+	const auto result = decode_unauthenticated_attributes(this->map);
+	EXPECT_TRUE(result.nested_signatures.empty());
+	EXPECT_FALSE(result.rfc3161_timestamp);
+	EXPECT_FALSE(result.authenticode_timestamp);
+	EXPECT_FALSE(result.countersignature);
+}
+
+TYPED_TEST(UnauthenticatedAttributesTest, DecodeAll)
+{
+	using range_type = typename TestFixture::range_type;
+	const std::vector<range_type> nested{ value1, value2 };
+	const std::vector<range_type> rfc3161{ value2 };
+	const std::vector<range_type> authenticode{ value3 };
+	const std::vector<range_type> countersignature{ value1 };
+	const std::vector<range_type> unknown{ value1, value2, value3 };
+	this->add_attribute(asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute,
+		nested);
+	this->add_attribute(asn1::crypto::pkcs9::oid_timestamp_token, rfc3161);
+	this->add_attribute(asn1::crypto::pkcs7::authenticode::oid_spc_time_stamp_token,
+		authenticode);
+	this->add_attribute(asn1::crypto::pkcs9::oid_counter_signature, countersignature);
+	this->add_attribute(std::vector<std::uint32_t>{ 1u, 2u, 3u }, unknown);
+
+	const auto result = decode_unauthenticated_attributes(this->map);
+	ASSERT_EQ(result.nested_signatures.size(), 2u);
+	EXPECT_TRUE(std::ranges::equal(result.nested_signatures[0], value1));
+	EXPECT_TRUE(std::ranges::equal(result.nested_signatures[1], value2));
+	ASSERT_TRUE(result.rfc3161_timestamp);
+	EXPECT_TRUE(std::ranges::equal(*result.rfc3161_timestamp, value2));
+	ASSERT_TRUE(result.authenticode_timestamp);
+	EXPECT_TRUE(std::ranges::equal(*result.authenticode_timestamp, value3));
+	ASSERT_TRUE(result.countersignature);
+	EXPECT_TRUE(std::ranges::equal(*result.countersignature, value1));
+}
+
+TYPED_TEST(UnauthenticatedAttributesTest, DecodeAbsentValue)
+{
+	using range_type = typename TestFixture::range_type;
+	const std::vector<range_type> empty;
+	this->add_attribute(asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute,
+		empty);
+	auto result = decode_unauthenticated_attributes(this->map);
+	EXPECT_TRUE(result.nested_signatures.empty());
+	EXPECT_EQ(result.nested_signatures_errc,
+		pkcs7::attribute_map_errc::absent_attribute_value);
+	EXPECT_FALSE(result.timestamp_errc);
+
+	this->map.get_map().clear();
+	this->oids.clear();
+	const std::vector<range_type> rfc3161{ value2 };
+	this->add_attribute(asn1::crypto::pkcs9::oid_counter_signature, empty);
+	this->add_attribute(asn1::crypto::pkcs9::oid_timestamp_token, rfc3161);
+	result = decode_unauthenticated_attributes(this->map);
+	EXPECT_FALSE(result.nested_signatures_errc);
+	EXPECT_EQ(result.timestamp_errc,
+		pkcs7::attribute_map_errc::absent_attribute_value);
+	EXPECT_FALSE(result.countersignature);
+	ASSERT_TRUE(result.rfc3161_timestamp);
+	EXPECT_TRUE(std::ranges::equal(*result.rfc3161_timestamp, value2));
+}
+
+TYPED_TEST(UnauthenticatedAttributesTest, DecodeMultipleTimestampValues)
+{
+	using range_type = typename TestFixture::range_type;
+	const std::vector<range_type> values{ value1, value2 };
+	this->add_attribute(asn1::crypto::pkcs9::oid_timestamp_token, values);
+	const auto result = decode_unauthenticated_attributes(this->map);
+	EXPECT_FALSE(result.rfc3161_timestamp);
+	EXPECT_EQ(result.timestamp_errc,
+		pkcs7::attribute_map_errc::multiple_attribute_values);
+}
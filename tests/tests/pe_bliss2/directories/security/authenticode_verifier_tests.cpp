@@ -204,15 +204,23 @@ public:
 		static const std::vector<range_type> attr_data{
 			valid_authenticode_copy, valid_authenticode_copy };
 
+		add_unauthenticated_attribute(oid_nested_signature_attribute, attr_data);
+	}
+
+	void add_unauthenticated_attribute(const std::vector<std::uint32_t>& oid,
+		const std::vector<range_type>& values)
+	{
 		auto& unauthenticated_attributes = signature.get_content_info().data.signer_infos
-			.at(0).unauthenticated_attributes.emplace();
+			.at(0).unauthenticated_attributes;
+		if (!unauthenticated_attributes)
+			unauthenticated_attributes.emplace();
 
-		unauthenticated_attributes.emplace_back(
+		unauthenticated_attributes->emplace_back(
 			asn1::crypto::pkcs7::attribute<RangeType>{
 			.type = asn1::decoded_object_identifier<std::vector<std::uint32_t>>{
-				.container = oid_nested_signature_attribute
+				.container = oid
 			},
-			.values = attr_data
+			.values = values
 		});
 	}
 
@@ -236,6 +244,9 @@ public:
 	static const inline std::vector<std::uint32_t> oid_nested_signature_attribute{
 		asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute.cbegin(),
 		asn1::crypto::pkcs7::authenticode::oid_nested_signature_attribute.cend() };
+	static const inline std::vector<std::uint32_t> oid_counter_signature{
+		asn1::crypto::pkcs9::oid_counter_signature.cbegin(),
+		asn1::crypto::pkcs9::oid_counter_signature.cend() };
 	static const inline std::vector<std::byte> page_hashes_class_id{
 		asn1::crypto::pkcs7::authenticode::page_hashes_class_id.cbegin(),
 		asn1::crypto::pkcs7::authenticode::page_hashes_class_id.cend() };
@@ -716,6 +727,66 @@ TYPED_TEST(AuthenticodeVerifierTest, WithValidSignature)
 	ASSERT_TRUE(result.nested.empty());
 }
 
+TYPED_TEST(AuthenticodeVerifierTest, WithValidSignatureMalformedCountersignature)
+{
+	this->add_signed_data_oid();
+	this->add_signed_data_version();
+	this->add_signer_info_and_algorithm();
+	this->add_ms_oids();
+	this->init_authenticated_attributes(this->valid_and_correct_message_digest_data, true);
+	this->init_image();
+	this->add_image_hash_to_signature();
+	this->add_page_hashes_to_signature(true);
+	this->add_message_digest_to_signer();
+	this->add_certificate_to_store();
+	this->add_issuer_and_sn();
+	this->set_rsa1_signer_data(true);
+	const std::vector<typename TestFixture::range_type> countersignatures{
+		this->valid_oid, this->valid_oid };
+	this->add_unauthenticated_attribute(this->oid_counter_signature, countersignatures);
+
+	auto result = verify_authenticode_full(this->signature, this->image_instance);
+
+	ASSERT_FALSE(result);
+	expect_contains_errors(result.root.authenticode_format_errors,
+		pkcs7::attribute_map_errc::multiple_attribute_values);
+	ASSERT_TRUE(result.root.image_hash_valid);
+	ASSERT_TRUE(*result.root.image_hash_valid);
+	ASSERT_TRUE(result.root.message_digest_valid);
+	ASSERT_TRUE(*result.root.message_digest_valid);
+	ASSERT_TRUE(result.root.signature_result);
+	ASSERT_TRUE(*result.root.signature_result);
+	ASSERT_FALSE(result.root.timestamp_signature_result);
+	ASSERT_TRUE(result.nested.empty());
+}
+
+TYPED_TEST(AuthenticodeVerifierTest, WithValidSignatureEmptyNestedSignature)
+{
+	this->add_signed_data_oid();
+	this->add_signed_data_version();
+	this->add_signer_info_and_algorithm();
+	this->add_ms_oids();
+	this->init_authenticated_attributes(this->valid_and_correct_message_digest_data, true);
+	this->init_image();
+	this->add_image_hash_to_signature();
+	this->add_page_hashes_to_signature(true);
+	this->add_message_digest_to_signer();
+	this->add_certificate_to_store();
+	this->add_issuer_and_sn();
+	this->set_rsa1_signer_data(true);
+	this->add_unauthenticated_attribute(this->oid_nested_signature_attribute, {});
+
+	auto result = verify_authenticode_full(this->signature, this->image_instance);
+
+	ASSERT_FALSE(result);
+	ASSERT_TRUE(result.root);
+	ASSERT_TRUE(result.root.signature_result);
+	ASSERT_TRUE(*result.root.signature_result);
+	ASSERT_EQ(result.nested.size(), 1u);
+	expect_contains_errors(result.nested[0].authenticode_format_errors,
+		pkcs7::attribute_map_errc::absent_attribute_value);
+}
+
 TYPED_TEST(AuthenticodeVerifierTest, WithNestedSignature)
 {
 	this->add_signed_data_oid();
@@ -0,0 +1,290 @@
+#include "pe_bliss2/security/catalog.h"
+#include "pe_bliss2/security/catalog_store.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/input_container_buffer.h"
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/buffer_hash.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/der_helpers.h"
+
+#include "tests/pe_bliss2/directories/security/common_authenticode_data.h"
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss::security;
+
+namespace
+{
+constexpr std::array<std::uint32_t, 7u> oid_signed_data{ 1, 2, 840, 113549, 1, 7, 2 };
+constexpr std::array<std::uint32_t, 7u> oid_content_type{ 1, 2, 840, 113549, 1, 9, 3 };
+constexpr std::array<std::uint32_t, 7u> oid_message_digest{ 1, 2, 840, 113549, 1, 9, 4 };
+constexpr std::array<std::uint32_t, 7u> oid_rsa_encryption{ 1, 2, 840, 113549, 1, 1, 1 };
+constexpr std::array<std::uint32_t, 9u> oid_sha256{ 2, 16, 840, 1, 101, 3, 4, 2, 1 };
+constexpr std::array<std::uint32_t, 9u> oid_ctl{ 1, 3, 6, 1, 4, 1, 311, 10, 1 };
+constexpr std::array<std::uint32_t, 10u> oid_catalog_list{ 1, 3, 6, 1, 4, 1, 311, 12, 1, 1 };
+constexpr std::array<std::uint32_t, 10u> oid_catalog_list_member{
+	1, 3, 6, 1, 4, 1, 311, 12, 1, 2 };
+constexpr std::array<std::uint32_t, 10u> oid_spc_indirect_data{
+	1, 3, 6, 1, 4, 1, 311, 2, 1, 4 };
+constexpr std::array<std::uint32_t, 10u> oid_spc_pe_image_data{
+	1, 3, 6, 1, 4, 1, 311, 2, 1, 15 };
+
+constexpr std::byte context_0 = der::tag::context_specific(0u, true);
+
+std::vector<std::byte> digest_of(std::uint8_t value)
+{
+	return std::vector<std::byte>(32u, std::byte{ value });
+}
+
+std::vector<std::byte> encode_sha256_algorithm()
+{
+	return der::encode(der::tag::sequence, {
+		der::encode_oid(oid_sha256), der::encode_null() });
+}
+
+std::vector<std::byte> encode_member(span_range_type tag, span_range_type digest)
+{
+	const auto indirect_data = der::encode(der::tag::sequence, {
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_spc_pe_image_data),
+			hex_string_to_bytes("3000") }),
+		der::encode(der::tag::sequence, {
+			encode_sha256_algorithm(),
+			der::encode(der::tag::octet_string, { digest }) })
+	});
+
+	return der::encode(der::tag::sequence, {
+		der::encode(der::tag::octet_string, { tag }),
+		der::encode(der::tag::set, {
+			der::encode(der::tag::sequence, {
+				der::encode_oid(oid_spc_indirect_data),
+				der::encode(der::tag::set, { indirect_data }) })
+		})
+	});
+}
+
+struct catalog_data
+{
+	std::vector<std::byte> ctl_contents;
+	std::vector<std::byte> der;
+};
+
+catalog_data create_catalog(std::span<const std::vector<std::byte>> members,
+	bool valid_message_digest = true)
+{
+	static constexpr std::array utc_time{
+		der::tag::utc_time, std::byte{ 13u },
+		std::byte{ '2' }, std::byte{ '4' }, std::byte{ '0' }, std::byte{ '1' },
+		std::byte{ '0' }, std::byte{ '1' }, std::byte{ '0' }, std::byte{ '0' },
+		std::byte{ '0' }, std::byte{ '0' }, std::byte{ '0' }, std::byte{ '0' },
+		std::byte{ 'Z' }
+	};
+
+	catalog_data result;
+	const std::vector<span_range_type> member_ranges(members.begin(), members.end());
+	const std::array ctl_fields{
+		der::encode(der::tag::sequence, { der::encode_oid(oid_catalog_list) }),
+		der::encode(der::tag::octet_string, { hex_string_to_bytes("0102") }),
+		std::vector<std::byte>(utc_time.begin(), utc_time.end()),
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_catalog_list_member), der::encode_null() }),
+		der::encode(der::tag::sequence, member_ranges)
+	};
+	for (const auto& field : ctl_fields)
+		result.ctl_contents.insert(result.ctl_contents.end(), field.begin(), field.end());
+
+	auto message_digest = calculate_hash(digest_algorithm::sha256,
+		std::array<span_range_type, 1u>{ result.ctl_contents });
+	if (!valid_message_digest)
+		message_digest[0] ^= std::byte{ 1u };
+
+	const auto authenticated_attributes = der::encode(context_0, {
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_content_type),
+			der::encode(der::tag::set, { der::encode_oid(oid_ctl) }) }),
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_message_digest),
+			der::encode(der::tag::set, {
+				der::encode(der::tag::octet_string, { message_digest }) }) })
+	});
+
+	const auto signer_info = der::encode(der::tag::sequence, {
+		der::encode_unsigned_integer(1u),
+		der::encode(der::tag::sequence, {
+			hex_string_to_bytes("3010310e300c060355040313054d79204341"),
+			der::encode_unsigned_integer(
+				hex_string_to_bytes("23eff072256af4914caeff821ee2924d")) }),
+		encode_sha256_algorithm(),
+		authenticated_attributes,
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_rsa_encryption), der::encode_null() }),
+		der::encode(der::tag::octet_string, { std::vector<std::byte>(128u) })
+	});
+
+	const auto certificate = std::as_bytes(std::span(valid_authenticode))
+		.subspan(141u, 770u);
+	const auto signed_data = der::encode(der::tag::sequence, {
+		der::encode_unsigned_integer(1u),
+		der::encode(der::tag::set, { encode_sha256_algorithm() }),
+		der::encode(der::tag::sequence, {
+			der::encode_oid(oid_ctl),
+			der::encode(context_0, {
+				der::encode(der::tag::sequence, { result.ctl_contents }) }) }),
+		der::encode(context_0, { certificate }),
+		der::encode(der::tag::set, { signer_info })
+	});
+
+	result.der = der::encode(der::tag::sequence, {
+		der::encode_oid(oid_signed_data),
+		der::encode(context_0, { signed_data })
+	});
+	return result;
+}
+
+buffers::input_buffer_ptr to_buffer(std::vector<std::byte> data)
+{
+	auto buffer = std::make_shared<buffers::input_container_buffer>();
+	buffer->get_container() = std::move(data);
+	return buffer;
+}
+
+std::vector<std::vector<std::byte>> create_members()
+{
+	std::vector<std::vector<std::byte>> members;
+	members.emplace_back(encode_member(hex_string_to_bytes("4100"), digest_of(1u)));
+	members.emplace_back(encode_member(hex_string_to_bytes("4200"), digest_of(2u)));
+	return members;
+}
+} //namespace
+
+TEST(CatalogTests, Load)
+{
+	const auto members = create_members();
+	const auto data = create_catalog(members);
+
+	pe_bliss::error_list warnings;
+	const auto instance = load_catalog(to_buffer(data.der), &warnings);
+	EXPECT_FALSE(warnings.has_errors());
+
+	ASSERT_EQ(instance.get_members().size(), 2u);
+	EXPECT_EQ(std::vector(instance.get_members()[0].tag.begin(),
+		instance.get_members()[0].tag.end()), hex_string_to_bytes("4100"));
+	EXPECT_EQ(instance.get_members()[1].digest_alg, digest_algorithm::sha256);
+	EXPECT_TRUE(std::ranges::equal(instance.get_members()[1].digest, digest_of(2u)));
+	EXPECT_TRUE(std::ranges::equal(instance.get_raw_signed_content(), data.ctl_contents));
+	EXPECT_EQ(instance.get_signers().size(), 1u);
+	EXPECT_EQ(instance.get_certificate_store().size(), 1u);
+	EXPECT_EQ(instance.get_certificate_store().get_decoded_count(), 0u);
+}
+
+TEST(CatalogTests, LoadInvalidMember)
+{
+	auto members = create_members();
+	members.emplace_back(hex_string_to_bytes("30030401ff"));
+	const auto data = create_catalog(members);
+
+	pe_bliss::error_list warnings;
+	const auto instance = load_catalog(to_buffer(data.der), &warnings);
+	expect_contains_errors(warnings, catalog_errc::absent_member_digest);
+	EXPECT_EQ(instance.get_members().size(), 3u);
+	EXPECT_TRUE(instance.get_members()[2].digest.empty());
+
+	members.back() = hex_string_to_bytes("30020500");
+	const auto invalid_data = create_catalog(members);
+	warnings.clear_errors();
+	const auto invalid_instance = load_catalog(to_buffer(invalid_data.der), &warnings);
+	expect_contains_errors(warnings, catalog_errc::invalid_member);
+	EXPECT_EQ(invalid_instance.get_members().size(), 2u);
+}
+
+TEST(CatalogTests, LoadInvalid)
+{
+	expect_throw_pe_error([] {
+		(void)load_catalog(to_buffer({}));
+	}, catalog_errc::invalid_catalog_format);
+	expect_throw_pe_error([] {
+		(void)load_catalog(to_buffer(hex_string_to_bytes("3003020101")));
+	}, catalog_errc::invalid_catalog_format);
+	expect_throw_pe_error([] {
+		(void)load_catalog(to_buffer(std::vector<std::byte>(
+			std::as_bytes(std::span(valid_authenticode)).begin(),
+			std::as_bytes(std::span(valid_authenticode)).end())));
+	}, catalog_errc::unsupported_content_type);
+}
+
+TEST(CatalogTests, Verify)
+{
+	const auto members = create_members();
+	const auto instance = load_catalog(to_buffer(create_catalog(members).der));
+	const auto result = verify_catalog(instance);
+	EXPECT_FALSE(result.format_errors.has_errors());
+	EXPECT_TRUE(result.message_digest_valid);
+	//The signature is not valid
+	EXPECT_FALSE(result);
+	EXPECT_FALSE(result.signature_result);
+	EXPECT_EQ(instance.get_certificate_store().get_decoded_count(), 1u);
+
+	const auto invalid_instance = load_catalog(
+		to_buffer(create_catalog(members, false).der));
+	EXPECT_FALSE(verify_catalog(invalid_instance).message_digest_valid);
+}
+
+TEST(CatalogTests, Store)
+{
+	catalog_store store;
+	const auto members = create_members();
+	EXPECT_EQ(store.add_catalog(load_catalog(
+		to_buffer(create_catalog(members).der))), 2u);
+
+	std::vector<std::vector<std::byte>> other_members;
+	other_members.emplace_back(encode_member(hex_string_to_bytes("4300"), digest_of(2u)));
+	other_members.emplace_back(encode_member(hex_string_to_bytes("4400"), digest_of(3u)));
+	EXPECT_EQ(store.add_catalog(load_catalog(
+		to_buffer(create_catalog(other_members).der))), 1u);
+
+	EXPECT_EQ(store.get_catalogs().size(), 2u);
+	EXPECT_EQ(store.get_digest_count(), 3u);
+	ASSERT_EQ(store.get_digest_algorithms().size(), 1u);
+	EXPECT_EQ(store.get_digest_algorithms()[0], digest_algorithm::sha256);
+
+	auto result = store.find_member(digest_algorithm::sha256, digest_of(2u));
+	ASSERT_TRUE(result);
+	EXPECT_EQ(result.owner, &store.get_catalogs()[0]);
+	EXPECT_EQ(result.member, &store.get_catalogs()[0].get_members()[1]);
+
+	result = store.find_member(digest_algorithm::sha256, digest_of(3u));
+	ASSERT_TRUE(result);
+	EXPECT_EQ(result.owner, &store.get_catalogs()[1]);
+
+	EXPECT_FALSE(store.find_member(digest_algorithm::sha256, digest_of(4u)));
+	EXPECT_FALSE(store.find_member(digest_algorithm::sha1, digest_of(1u)));
+}
+
+TEST(CatalogTests, FindStreamHashes)
+{
+	catalog_store store;
+	const auto members = create_members();
+	(void)store.add_catalog(load_catalog(to_buffer(create_catalog(members).der)));
+
+	image_hash_stream_result hashes;
+	hashes.digests.emplace_back().algorithm = digest_algorithm::sha1;
+	hashes.digests.back().hash.image_hash = digest_of(1u);
+	EXPECT_FALSE(find_image_in_catalogs(store, hashes));
+
+	hashes.digests.emplace_back().algorithm = digest_algorithm::sha256;
+	hashes.digests.back().hash.image_hash = digest_of(1u);
+	const auto result = find_image_in_catalogs(store, hashes);
+	ASSERT_TRUE(result);
+	EXPECT_EQ(result.member, &store.get_catalogs()[0].get_members()[0]);
+}
@@ -0,0 +1,125 @@
+#include "pe_bliss2/security/der_helpers.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "tests/pe_bliss2/directories/security/common_authenticode_data.h"
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+
+using namespace pe_bliss::security;
+
+TEST(DerHelpersTest, ReadElement)
+{
+	const auto data = hex_string_to_bytes("3006020101040102");
+	span_range_type range(data);
+	der::element element;
+	ASSERT_TRUE(der::read_element(range, der::tag::sequence, element));
+	EXPECT_TRUE(range.empty());
+	EXPECT_EQ(element.tag, der::tag::sequence);
+	EXPECT_EQ(element.value.size(), 6u);
+	EXPECT_EQ(element.raw.size(), data.size());
+
+	std::vector<der::element> children;
+	ASSERT_TRUE(der::read_children(element.value, children));
+	ASSERT_EQ(children.size(), 2u);
+	EXPECT_EQ(children[0].tag, der::tag::integer);
+	EXPECT_EQ(children[1].value.size(), 1u);
+
+	range = data;
+	EXPECT_FALSE(der::read_element(range, der::tag::set, element));
+}
+
+TEST(DerHelpersTest, ReadMalformedElement)
+{
+	for (const auto* hex : { "30", "3004020101", "3080", "308500000000", "30820100" })
+	{
+		const auto data = hex_string_to_bytes(hex);
+		span_range_type range(data);
+		der::element element;
+		EXPECT_FALSE(der::read_element(range, element));
+	}
+
+	const auto data = hex_string_to_bytes("02010130");
+	std::vector<der::element> children;
+	EXPECT_FALSE(der::read_children(data, children));
+}
+
+TEST(DerHelpersTest, EncodeLongLength)
+{
+	const std::vector<std::byte> contents(0x123u);
+	const auto encoded = der::encode(der::tag::octet_string, { contents });
+	ASSERT_EQ(encoded.size(), contents.size() + 4u);
+	EXPECT_EQ(std::vector(encoded.begin(), encoded.begin() + 4),
+		hex_string_to_bytes("04820123"));
+
+	span_range_type range(encoded);
+	der::element element;
+	ASSERT_TRUE(der::read_element(range, element));
+	EXPECT_EQ(element.value.size(), contents.size());
+}
+
+TEST(DerHelpersTest, EncodeOid)
+{
+	static constexpr std::array<std::uint32_t, 7u> oid{ 1, 2, 840, 113549, 1, 7, 2 };
+	EXPECT_EQ(der::encode_oid(oid), hex_string_to_bytes("06092a864886f70d010702"));
+}
+
+TEST(DerHelpersTest, EncodeUnsignedInteger)
+{
+	EXPECT_EQ(der::encode_unsigned_integer(0u), hex_string_to_bytes("020100"));
+	EXPECT_EQ(der::encode_unsigned_integer(0x7fu), hex_string_to_bytes("02017f"));
+	EXPECT_EQ(der::encode_unsigned_integer(0x80u), hex_string_to_bytes("02020080"));
+	EXPECT_EQ(der::encode_unsigned_integer(hex_string_to_bytes("000001ff")),
+		hex_string_to_bytes("020201ff"));
+}
+
+TEST(DerHelpersTest, EncodeSetOf)
+{
+	std::vector<std::vector<std::byte>> elements{
+		hex_string_to_bytes("020102"), hex_string_to_bytes("0500"),
+		hex_string_to_bytes("020101") };
+	EXPECT_EQ(der::encode_set_of(std::move(elements)),
+		hex_string_to_bytes("3108020101020102" "0500"));
+}
+
+TEST(DerHelpersTest, ReadCertificateIssuerAndSerialNumber)
+{
+	const auto certificate = std::as_bytes(std::span(valid_authenticode))
+		.subspan(141u, 770u);
+	der::element issuer, serial_number;
+	ASSERT_TRUE(der::read_certificate_issuer_and_serial_number(
+		certificate, issuer, serial_number));
+	EXPECT_EQ(std::vector(serial_number.value.begin(), serial_number.value.end()),
+		hex_string_to_bytes("23eff072256af4914caeff821ee2924d"));
+	EXPECT_EQ(std::vector(issuer.raw.begin(), issuer.raw.end()),
+		hex_string_to_bytes("3010310e300c060355040313054d79204341"));
+
+	EXPECT_FALSE(der::read_certificate_issuer_and_serial_number(
+		certificate.subspan(0u, 100u), issuer, serial_number));
+}
+
+TEST(DerHelpersTest, DecodeOid)
+{
+	static constexpr std::array<std::uint32_t, 10u> oid{
+		1, 3, 6, 1, 4, 1, 311, 10, 1, 0xffffffffu };
+	const auto encoded = der::encode_oid(oid);
+	span_range_type range(encoded);
+	der::element element;
+	ASSERT_TRUE(der::read_element(range, der::tag::object_identifier, element));
+
+	std::vector<std::uint32_t> decoded;
+	ASSERT_TRUE(der::decode_oid(element.value, decoded));
+	EXPECT_TRUE(std::ranges::equal(decoded, oid));
+
+	for (const auto* hex : { "", "2b86", "2b80", "8001", "2b9080808000" })
+	{
+		const auto data = hex_string_to_bytes(hex);
+		EXPECT_FALSE(der::decode_oid(data, decoded));
+	}
+}
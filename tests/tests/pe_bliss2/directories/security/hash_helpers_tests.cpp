@@ -73,6 +73,28 @@ TEST(HashHelperTests, HashTransformNonContiguousBuffer)
 	EXPECT_EQ(buf.get_container(), copy);
 }
 
+TEST(HashHelperTests, HashTransformNonContiguousBufferChunks)
+{
+	non_contiguous_buffer buf;
+	buf.get_container().resize(4096);
+	for (std::size_t i = 0; i != buf.get_container().size(); ++i)
+		buf.get_container()[i] = static_cast<std::byte>(i);
+
+	std::vector<std::byte> copy;
+	::testing::StrictMock<hash_transformation_mock> transform;
+	EXPECT_CALL(transform, Update(::testing::_, ::testing::Le(100u)))
+		.Times(41)
+		.WillRepeatedly(
+		[&copy](const CryptoPP::byte* data, std::size_t size) {
+			const auto* bytes = reinterpret_cast<const std::byte*>(data);
+			copy.insert(copy.end(), bytes, bytes + size);
+		});
+
+	update_hash(buf, 0, buf.get_container().size(), transform,
+		{ .chunk_size = 100u });
+	EXPECT_EQ(buf.get_container(), copy);
+}
+
 namespace
 {
 class PageHashHelperTests : public ::testing::Test
@@ -1,14 +1,27 @@
 #include "pe_bliss2/security/image_hash.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
+#include "buffers/input_memory_buffer.h"
+#include "buffers/output_memory_buffer.h"
 #include "pe_bliss2/core/data_directories.h"
 #include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_builder.h"
+#include "pe_bliss2/image/image_loader.h"
 #include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/hash_helpers.h"
 
 #include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+#include "tests/pe_bliss2/directories/security/non_contiguous_buffer.h"
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
 
 using namespace pe_bliss::security;
 
@@ -181,6 +194,24 @@ TEST(ImageHashTest, ValidImageNoPageHashesNoFullSectionsWithExtraOverlay)
 		"29708c2823a15daf2c073"));
 }
 
+TEST(ImageHashTest, ValidImageNoPageHashesEmptySecurityDirWithOverlay)
+{
+	pe_bliss::image::image image;
+	init_headers(image);
+	init_full_section_data(image);
+	image.get_data_directories().get_directory(
+		pe_bliss::core::data_directories::directory_type::security)->virtual_address = 0u;
+	image.get_overlay().copied_data().assign(1u, std::byte{ 0x10u });
+
+	//Same as ValidImageNoPageHashesFullSectionsWithExtraOverlay,
+	//as the whole overlay is hashed
+	auto hash = calculate_hash(digest_algorithm::sha384, image, nullptr);
+	ASSERT_EQ(hash.page_hash_errc, (std::errc{}));
+	ASSERT_EQ(hash.image_hash, hex_string_to_bytes(
+		"aed257a4db567ae6bb4110677b49e57e794797ac6e958618c3fd931cd2e7e8caff6ead3e09a"
+		"29708c2823a15daf2c073"));
+}
+
 TEST(ImageHashTest, InvalidSectionHeaderDataMismatch)
 {
 	pe_bliss::image::image image;
@@ -416,3 +447,256 @@ TEST(ImageHashTest, VerifyImageHashValidWithPageHashes)
 	ASSERT_TRUE(result.page_hashes_valid);
 	ASSERT_FALSE(result.page_hashes_check_errc);
 }
+
+namespace
+{
+constexpr std::uint32_t security_dir_size = 16u;
+
+std::vector<std::byte> create_signed_image_data(std::size_t extra_overlay_size)
+{
+	auto instance = create_test_image({
+		.sections = { { 0x1000u, 0x1000u }, { 0x600u, 0x600u } } });
+	std::uint8_t value = 1u;
+	for (auto& section : instance.get_section_data_list())
+	{
+		for (auto& byte : section.copied_data())
+			byte = std::byte{ value++ };
+	}
+
+	instance.get_optional_header().set_raw_checksum(0x12345678u);
+	auto& security_dir = instance.get_data_directories().get_directory(
+		pe_bliss::core::data_directories::directory_type::security);
+	security_dir->virtual_address = static_cast<std::uint32_t>(
+		0x2600u + extra_overlay_size);
+	security_dir->size = security_dir_size;
+
+	std::vector<std::byte> data;
+	buffers::output_memory_buffer buffer(data);
+	pe_bliss::image::image_builder::build(instance, buffer);
+	data.resize(0x2600u + extra_overlay_size, std::byte{ 0xabu });
+	data.resize(data.size() + security_dir_size, std::byte{ 0xcdu });
+	return data;
+}
+
+image_hash_result calculate_reference_hash(const std::vector<std::byte>& data)
+{
+	const auto load_result = pe_bliss::image::image_loader::load(
+		std::make_shared<buffers::input_memory_buffer>(data.data(), data.size()));
+	EXPECT_TRUE(load_result);
+	const page_hash_options opts{ .algorithm = digest_algorithm::sha256 };
+	return calculate_hash(digest_algorithm::sha256, load_result.image, &opts);
+}
+
+void check_stream_hash(const image_hash_stream_result& result,
+	const image_hash_result& reference, std::size_t security_dir_offset)
+{
+	ASSERT_EQ(result.digests.size(), 2u);
+	ASSERT_NE(result.find_digest(digest_algorithm::sha1), nullptr);
+	const auto* digest = result.find_digest(digest_algorithm::sha256);
+	ASSERT_NE(digest, nullptr);
+	EXPECT_FALSE(digest->hash.page_hash_errc);
+	EXPECT_EQ(digest->hash.image_hash, reference.image_hash);
+	EXPECT_EQ(digest->hash.page_hashes, reference.page_hashes);
+	ASSERT_TRUE(result.security_directory);
+	EXPECT_EQ(result.security_directory->absolute_offset(), security_dir_offset);
+	EXPECT_EQ(result.security_directory->get_container(),
+		std::vector<std::byte>(security_dir_size, std::byte{ 0xcdu }));
+}
+
+std::istringstream to_stream(const std::vector<std::byte>& data)
+{
+	return std::istringstream(std::string(
+		reinterpret_cast<const char*>(data.data()), data.size()));
+}
+} //namespace
+
+TEST(ImageHashTest, StreamHashMatchesImageHash)
+{
+	for (std::size_t extra_overlay_size : { 0u, 0x18u })
+	{
+		const auto data = create_signed_image_data(extra_overlay_size);
+		const auto reference = calculate_reference_hash(data);
+		ASSERT_FALSE(reference.page_hash_errc);
+		const auto security_dir_offset = 0x2600u + extra_overlay_size;
+
+		auto stream = to_stream(data);
+		check_stream_hash(calculate_stream_hash(stream, { .read_buffer_size = 100u }),
+			reference, security_dir_offset);
+
+		buffers::input_memory_buffer memory_buffer(data.data(), data.size());
+		check_stream_hash(calculate_stream_hash(memory_buffer),
+			reference, security_dir_offset);
+
+		non_contiguous_buffer buffer;
+		buffer.get_container() = data;
+		check_stream_hash(calculate_stream_hash(buffer, { .read_buffer_size = 333u }),
+			reference, security_dir_offset);
+	}
+}
+
+TEST(ImageHashTest, PageHashEngineTypesAndPageSize)
+{
+	const auto data = create_signed_image_data(0u);
+	const auto load_result = pe_bliss::image::image_loader::load(
+		std::make_shared<buffers::input_memory_buffer>(data.data(), data.size()));
+	ASSERT_TRUE(load_result);
+
+	const auto reference = calculate_reference_hash(data);
+	page_hash_options opts{ .algorithm = digest_algorithm::sha256,
+		.engine_type = page_hash_engine_type::multi_buffer };
+	EXPECT_EQ(calculate_hash(digest_algorithm::sha256, load_result.image, &opts).page_hashes,
+		reference.page_hashes);
+
+	opts.page_size = 0x200u;
+	const auto multi_buffer_result = calculate_hash(digest_algorithm::sha256,
+		load_result.image, &opts);
+	opts.engine_type = page_hash_engine_type::generic;
+	const auto generic_result = calculate_hash(digest_algorithm::sha256,
+		load_result.image, &opts);
+	ASSERT_FALSE(generic_result.page_hash_errc);
+	EXPECT_GT(generic_result.page_hashes.size(), reference.page_hashes.size());
+	EXPECT_EQ(multi_buffer_result.page_hashes, generic_result.page_hashes);
+
+	auto stream = to_stream(data);
+	const auto stream_result = calculate_stream_hash(stream,
+		{ .page_size = 0x200u, .engine_type = page_hash_engine_type::multi_buffer });
+	const auto* digest = stream_result.find_digest(digest_algorithm::sha256);
+	ASSERT_NE(digest, nullptr);
+	EXPECT_EQ(digest->hash.page_hashes, generic_result.page_hashes);
+}
+
+TEST(ImageHashTest, StreamHashNoPageHashes)
+{
+	const auto data = create_signed_image_data(0u);
+	auto stream = to_stream(data);
+	const auto result = calculate_stream_hash(stream, {
+		.algorithms = { digest_algorithm::md5 },
+		.calculate_page_hashes = false });
+	ASSERT_EQ(result.digests.size(), 1u);
+	ASSERT_EQ(result.digests[0].algorithm, digest_algorithm::md5);
+	ASSERT_EQ(result.digests[0].hash.page_hash_errc,
+		image_hash_stream_errc::page_hashes_not_calculated);
+	ASSERT_TRUE(result.digests[0].hash.page_hashes.empty());
+	ASSERT_EQ(result.digests[0].hash.image_hash.size(), 16u);
+}
+
+TEST(ImageHashTest, StreamHashPageHashesTooBig)
+{
+	const auto data = create_signed_image_data(0u);
+	auto stream = to_stream(data);
+	const auto result = calculate_stream_hash(stream, {
+		.algorithms = { digest_algorithm::sha256 },
+		.max_page_hashes_size = 10u });
+	ASSERT_EQ(result.digests.size(), 1u);
+	ASSERT_EQ(result.digests[0].hash.page_hash_errc,
+		hash_calculator_errc::page_hashes_data_too_big);
+	ASSERT_TRUE(result.digests[0].hash.page_hashes.empty());
+}
+
+TEST(ImageHashTest, StreamHashSecurityDirectoryNotAtEnd)
+{
+	auto data = create_signed_image_data(0u);
+	data.push_back(std::byte{});
+	auto stream = to_stream(data);
+	expect_throw_pe_error([&stream] {
+		return calculate_stream_hash(stream);
+	}, image_hash_stream_errc::security_directory_not_at_end);
+}
+
+TEST(ImageHashTest, StreamHashTruncated)
+{
+	auto data = create_signed_image_data(0u);
+	data.resize(data.size() - 1u);
+	auto stream = to_stream(data);
+	expect_throw_pe_error([&stream] {
+		return calculate_stream_hash(stream);
+	}, hash_helpers_errc::unable_to_read_data);
+
+	data.resize(0x1800u);
+	stream = to_stream(data);
+	expect_throw_pe_error([&stream] {
+		return calculate_stream_hash(stream);
+	}, hash_calculator_errc::invalid_section_data);
+}
+
+TEST(ImageHashTest, StreamHashLimits)
+{
+	const auto data = create_signed_image_data(0u);
+	auto stream = to_stream(data);
+	expect_throw_pe_error([&stream] {
+		return calculate_stream_hash(stream, { .max_headers_size = 0x200u });
+	}, image_hash_stream_errc::headers_too_big);
+
+	stream = to_stream(data);
+	expect_throw_pe_error([&stream] {
+		return calculate_stream_hash(stream, { .max_security_directory_size = 8u });
+	}, image_hash_stream_errc::security_directory_too_big);
+
+	//The section table (two sections) is not counted
+	stream = to_stream(data);
+	EXPECT_NO_THROW((void)calculate_stream_hash(stream, {
+		.max_headers_size = 0x1000u - 2u * 40u }));
+	stream = to_stream(data);
+	expect_throw_pe_error([&stream] {
+		return calculate_stream_hash(stream, {
+			.max_headers_size = 0x1000u - 2u * 40u - 1u });
+	}, image_hash_stream_errc::headers_too_big);
+}
+
+TEST(ImageHashTest, VerifyStreamImageHash)
+{
+	const auto data = create_signed_image_data(0u);
+	const auto reference = calculate_reference_hash(data);
+	auto stream = to_stream(data);
+	const auto hashes = calculate_stream_hash(stream);
+
+	const page_hash_options opts{ .algorithm = digest_algorithm::sha256 };
+	auto result = verify_image_hash(reference.image_hash, digest_algorithm::sha256,
+		hashes, reference.page_hashes, opts);
+	ASSERT_TRUE(result);
+	ASSERT_TRUE(result.image_hash_valid);
+	ASSERT_EQ(result.page_hashes_valid, true);
+
+	result = verify_image_hash(hex_string_to_bytes("1234"),
+		digest_algorithm::sha256, hashes, {}, {});
+	ASSERT_FALSE(result);
+	ASSERT_FALSE(result.page_hashes_valid);
+
+	expect_throw_pe_error([&] {
+		return verify_image_hash(reference.image_hash, digest_algorithm::md5,
+			hashes, {}, {});
+	}, image_hash_stream_errc::digest_not_calculated);
+}
+
+TEST(ImageHashTest, VerifyStreamImageHashPageHashOptions)
+{
+	const auto data = create_signed_image_data(0u);
+	const auto reference = calculate_reference_hash(data);
+	auto stream = to_stream(data);
+	const auto hashes = calculate_stream_hash(stream);
+	EXPECT_EQ(hashes.page_size, 0x1000u);
+
+	auto result = verify_image_hash(reference.image_hash, digest_algorithm::sha256,
+		hashes, reference.page_hashes, page_hash_options{
+			.algorithm = digest_algorithm::sha256, .page_size = 0x1000u });
+	EXPECT_TRUE(result);
+
+	result = verify_image_hash(reference.image_hash, digest_algorithm::sha256,
+		hashes, reference.page_hashes, page_hash_options{
+			.algorithm = digest_algorithm::sha256, .page_size = 0x200u });
+	EXPECT_FALSE(result);
+	EXPECT_EQ(result.page_hashes_check_errc, image_hash_stream_errc::page_size_mismatch);
+	EXPECT_EQ(result.page_hashes_valid, false);
+
+	result = verify_image_hash(reference.image_hash, digest_algorithm::sha256,
+		hashes, reference.page_hashes, page_hash_options{
+			.algorithm = digest_algorithm::sha256, .max_page_hashes_size = 10u });
+	EXPECT_FALSE(result);
+	EXPECT_EQ(result.page_hashes_check_errc, hash_calculator_errc::page_hashes_data_too_big);
+
+	result = verify_image_hash(reference.image_hash, digest_algorithm::sha256,
+		hashes, reference.page_hashes, page_hash_options{
+			.algorithm = digest_algorithm::md5 });
+	EXPECT_FALSE(result);
+	EXPECT_EQ(result.page_hashes_check_errc, image_hash_stream_errc::digest_not_calculated);
+}
@@ -0,0 +1,135 @@
+#include "pe_bliss2/security/page_hash_engine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define CRYPTOPP_ENABLE_NAMESPACE_WEAK 1
+#include "cryptopp/sha.h"
+
+#include "pe_bliss2/security/buffer_hash.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/hash_helpers.h"
+
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss::security;
+
+namespace
+{
+std::vector<std::byte> create_messages_data(std::size_t size)
+{
+	std::vector<std::byte> data(size);
+	for (std::size_t i = 0; i != size; ++i)
+		data[i] = static_cast<std::byte>((i * 7u + (i >> 8u)) & 0xffu);
+	return data;
+}
+
+std::vector<std::byte> calculate(page_hash_engine& engine,
+	const std::vector<span_range_type>& messages)
+{
+	std::vector<std::byte> digests(messages.size() * engine.get_digest_size());
+	engine.calculate(messages, digests.data(), engine.get_digest_size());
+	return digests;
+}
+} //namespace
+
+TEST(PageHashEngineTests, UnsupportedAlgorithm)
+{
+	expect_throw_pe_error([] {
+		page_hash_engine engine(digest_algorithm::unknown);
+	}, buffer_hash_errc::unsupported_hash_algorithm);
+}
+
+TEST(PageHashEngineTests, GenericEngine)
+{
+	page_hash_engine engine(digest_algorithm::sha384,
+		page_hash_engine_type::multi_buffer);
+	EXPECT_EQ(engine.get_algorithm(), digest_algorithm::sha384);
+	EXPECT_EQ(engine.get_digest_size(), 48u);
+	EXPECT_FALSE(engine.is_multi_buffer());
+
+	page_hash_engine sha1_engine(digest_algorithm::sha1,
+		page_hash_engine_type::generic);
+	EXPECT_FALSE(sha1_engine.is_multi_buffer());
+}
+
+TEST(PageHashEngineTests, KnownDigests)
+{
+	const auto abc = hex_string_to_bytes("616263");
+	for (auto type : { page_hash_engine_type::generic,
+		page_hash_engine_type::multi_buffer })
+	{
+		page_hash_engine sha1(digest_algorithm::sha1, type);
+		page_hash_engine sha256(digest_algorithm::sha256, type);
+		const std::vector<span_range_type> messages(3u, abc);
+		EXPECT_EQ(calculate(sha1, messages), hex_string_to_bytes(
+			"a9993e364706816aba3e25717850c26c9cd0d89d"
+			"a9993e364706816aba3e25717850c26c9cd0d89d"
+			"a9993e364706816aba3e25717850c26c9cd0d89d"));
+		EXPECT_EQ(calculate(sha256, messages), hex_string_to_bytes(
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+	}
+}
+
+TEST(PageHashEngineTests, MultiBufferMatchesGeneric)
+{
+	static constexpr std::size_t message_count = 2u * page_hash_engine::max_lanes + 1u;
+	const auto data = create_messages_data(4096u * message_count);
+	for (auto algorithm : { digest_algorithm::sha1, digest_algorithm::sha256 })
+	{
+		page_hash_engine generic(algorithm, page_hash_engine_type::generic);
+		page_hash_engine multi_buffer(algorithm, page_hash_engine_type::multi_buffer);
+		EXPECT_EQ(multi_buffer.is_multi_buffer(),
+			page_hash_engine::is_multi_buffer_supported(algorithm));
+
+		for (std::size_t size : { 0u, 1u, 55u, 56u, 63u, 64u, 65u, 119u, 120u, 4092u, 4096u })
+		{
+			for (std::size_t count = 1u; count <= message_count; ++count)
+			{
+				std::vector<span_range_type> messages;
+				for (std::size_t i = 0; i != count; ++i)
+				{
+					//Splits the messages into groups of the same size
+					const auto message_size = i == page_hash_engine::max_lanes + 2u
+						&& size ? size - 1u : size;
+					messages.emplace_back(data.data() + i * 4096u, message_size);
+				}
+
+				EXPECT_EQ(calculate(multi_buffer, messages), calculate(generic, messages));
+			}
+		}
+	}
+}
+
+TEST(PageHashEngineTests, PageHashStateWithEngine)
+{
+	static constexpr std::size_t page_size = 512u;
+	const auto data = create_messages_data(page_size * 20u);
+
+	CryptoPP::SHA256 hash;
+	page_hash_engine engine(digest_algorithm::sha256,
+		page_hash_engine_type::multi_buffer);
+	page_hash_state reference(hash, page_size);
+	page_hash_state state(engine, page_size);
+	for (auto* current : { &reference, &state })
+	{
+		current->update(data.data(), 0u, 100u);
+		current->add_skipped_bytes(4u);
+		current->update(data.data() + 104u, 104u, page_size * 9u);
+		current->next_page();
+		current->update(data.data() + page_size * 11u, page_size * 11u, 1000u);
+		current->add_skipped_bytes(10u);
+		current->update(data.data() + page_size * 13u, page_size * 13u, page_size * 5u);
+	}
+
+	const auto expected = std::move(reference).get_page_hashes();
+	EXPECT_EQ(expected.size(), 18u * (sizeof(std::uint32_t) + 32u));
+	EXPECT_EQ(std::move(state).get_page_hashes(), expected);
+}
@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 
 #include "pe_bliss2/pe_error.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
 
 #include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
 
@@ -287,3 +288,102 @@ TEST(Pkcs7SignatureTests, EcdsaSecp521r1Sha1Valid)
 		digest_encryption_algorithm::ecdsa, params),
 		(signature_verification_result{ true, 0u, ecc_curve::secp521r1 }));
 }
+
+TEST(Pkcs7SignatureTests, RsaCached)
+{
+	const auto pk = hex_string_to_bytes("30818902818100d184617b5f8034655944839f785a63835555088a"
+		"23d0b34e1a2e6bdf83c49ba2b1ecb398105eed1a21d513ea76f9ad3879843db27e91765885ba33ccf45b14"
+		"61c227205f08bcd07d5a2cf7fa9443cf2ef376f448503630699059002546d2f2eba124478ac34704e3d83c"
+		"d1e041178042a922fa3c541b3fdfeb072c5dc44a00210203010001");
+
+	const auto sha256_message_digest = hex_string_to_bytes(
+		"9834876dcfb05cb167a5c24953eba58c4ac89b1adf57f28f2f9d09af107ee8f0");
+	const auto sha256_encrypted_digest = hex_string_to_bytes("c27ebd5c0193244f7d3f08405b6821c2085ee522"
+		"c630aad3e1a14e4ae2dee034f47e480fb37a729e074f98fb8b70dd387666b4b9def14c3b5e2a814cf13bc6"
+		"fca24f252f396fdcf0aca55c0ca7782e9d07ca887714761ee0bdb8364a1816c2e43b0ceef5a507b8a939d8"
+		"bbad1f38ee5dfdd30f04b21eeeb406b9d2d5478fac87");
+	const auto sha1_message_digest = hex_string_to_bytes(
+		"7e240de74fb1ed08fa08d38063f6a6a91462a815");
+	const auto sha1_encrypted_digest = hex_string_to_bytes(
+		"6f7df91d8f973a0619d525c319337741130b77b21f9667dc7d1d74853b644cbe"
+		"5e6b0e84aacc2faee883d43affb811fc653b67c38203d4f206d1b838c4714b6b"
+		"2cf17cd621303c21bac96090df3883e58784a0576e501c10cdefb12b6bf887e5"
+		"48f6b07b09ae80d8416151d7dab7066d645e2eee57ac5f7af2a70ee0724c8e47");
+
+	signature_verification_cache cache;
+	for (int i = 0; i != 2; ++i)
+	{
+		ASSERT_EQ(verify_signature(pk, sha256_message_digest, sha256_encrypted_digest,
+			digest_algorithm::sha256, digest_encryption_algorithm::rsa, {}, &cache),
+			(signature_verification_result{ true, 1024u }));
+		ASSERT_EQ(verify_signature(pk, sha1_message_digest, sha1_encrypted_digest,
+			digest_algorithm::sha1, digest_encryption_algorithm::rsa, {}, &cache),
+			(signature_verification_result{ true, 1024u }));
+	}
+
+	//Different digest is not taken from the cache
+	auto invalid_digest = sha256_message_digest;
+	invalid_digest[0] = std::byte{};
+	ASSERT_FALSE(verify_signature(pk, invalid_digest, sha256_encrypted_digest,
+		digest_algorithm::sha256, digest_encryption_algorithm::rsa, {}, &cache));
+
+	const auto stats = cache.get_statistics();
+	EXPECT_EQ(stats.public_key_misses, 1u);
+	EXPECT_EQ(stats.public_key_hits, 2u);
+	EXPECT_EQ(stats.result_misses, 3u);
+	EXPECT_EQ(stats.result_hits, 2u);
+}
+
+TEST(Pkcs7SignatureTests, EcdsaCached)
+{
+	const auto pk = hex_string_to_bytes("046318166fd2402430e43df4f385fbe5441d3190baa2a089e2cea630a"
+		"e1969cbe4889fb77d3980cd98d4289ea439f10b6c9dfa8269ab5d6c28b65ca1128f473319");
+	const auto message_digest = hex_string_to_bytes(
+		"9834876dcfb05cb167a5c24953eba58c4ac89b1adf57f28f2f9d09af107ee8f0");
+	const auto encrypted_digest = hex_string_to_bytes(
+		"30450220576b2fe8c39c316b641a0878ed212d4648db0a7a19832dce628006ba382dbeff02210088be0e9b507f"
+		"4761bdb908f33f94cf50bc8a2e50f47b795ea1787622e3ff3157");
+	const auto params = hex_string_to_bytes("06052b8104000a");
+
+	signature_verification_cache cache;
+	for (int i = 0; i != 2; ++i)
+	{
+		ASSERT_EQ(verify_signature(pk, message_digest, encrypted_digest,
+			digest_algorithm::sha256, digest_encryption_algorithm::ecdsa, params, &cache),
+			(signature_verification_result{ true, 0u, ecc_curve::secp256k1 }));
+	}
+
+	//Same key bytes with other curve parameters are decoded separately
+	ASSERT_THROW((void)verify_signature(pk, message_digest, encrypted_digest,
+		digest_algorithm::sha256, digest_encryption_algorithm::ecdsa,
+		hex_string_to_bytes("06052b81040023"), &cache), pe_bliss::pe_error);
+
+	const auto stats = cache.get_statistics();
+	EXPECT_EQ(stats.public_key_misses, 2u);
+	EXPECT_EQ(stats.public_key_hits, 0u);
+	EXPECT_EQ(stats.result_misses, 2u);
+	EXPECT_EQ(stats.result_hits, 1u);
+}
+
+TEST(Pkcs7SignatureTests, InvalidKeyNotCached)
+{
+	const auto pk = hex_string_to_bytes("30838902818100d184617b5f8034655944839f785a63835555088a"
+		"23d0b34e1a2e6bdf83c49ba2b1ecb398105eed1a21d513ea76f9ad3879843db27e91765885ba33ccf45b14"
+		"61c227205f08bcd07d5a2cf7fa9443cf2ef376f448503630699059002546d2f2eba124478ac34704e3d83c"
+		"d1e041178042a922fa3c541b3fdfeb072c5dc44a00210203010001");
+	const auto message_digest = hex_string_to_bytes(
+		"47bce5c74f589f4867dbd57e9ca9f808");
+	const auto encrypted_digest = hex_string_to_bytes(
+		"c22bdae3f670accdbd5f1a7f078cf0fe61077d59c795c9a206b09ad369bb61e1");
+
+	signature_verification_cache cache;
+	for (int i = 0; i != 2; ++i)
+	{
+		ASSERT_THROW((void)verify_signature(pk, message_digest, encrypted_digest,
+			digest_algorithm::md5, digest_encryption_algorithm::rsa, {}, &cache),
+			pe_bliss::pe_error);
+	}
+
+	EXPECT_EQ(cache.get_statistics().public_key_misses, 2u);
+	EXPECT_EQ(cache.get_statistics().result_hits, 0u);
+}
@@ -0,0 +1,54 @@
+#include "pe_bliss2/security/signature_verification_cache.h"
+
+#include "gtest/gtest.h"
+
+using namespace pe_bliss::security;
+
+namespace
+{
+signature_verification_cache::hash_type create_hash(std::byte value)
+{
+	signature_verification_cache::hash_type result{};
+	result.back() = value;
+	return result;
+}
+} //namespace
+
+TEST(SignatureVerificationCacheTests, Results)
+{
+	signature_verification_cache cache;
+	EXPECT_EQ(cache.get_max_entries(), signature_verification_cache::default_max_entries);
+	EXPECT_FALSE(cache.find_result(create_hash(std::byte{ 1 })));
+
+	const pkcs7::signature_verification_result result{ true, 2048u };
+	cache.add_result(create_hash(std::byte{ 1 }), result);
+	EXPECT_EQ(cache.find_result(create_hash(std::byte{ 1 })), result);
+	EXPECT_FALSE(cache.find_result(create_hash(std::byte{ 2 })));
+	EXPECT_EQ(cache.find_public_key(create_hash(std::byte{ 1 })), nullptr);
+
+	auto stats = cache.get_statistics();
+	EXPECT_EQ(stats.result_hits, 1u);
+	EXPECT_EQ(stats.result_misses, 2u);
+	EXPECT_EQ(stats.public_key_hits, 0u);
+	EXPECT_EQ(stats.public_key_misses, 1u);
+
+	cache.clear();
+	EXPECT_FALSE(cache.find_result(create_hash(std::byte{ 1 })));
+	stats = cache.get_statistics();
+	EXPECT_EQ(stats.result_hits, 0u);
+	EXPECT_EQ(stats.result_misses, 1u);
+}
+
+TEST(SignatureVerificationCacheTests, MaxEntries)
+{
+	signature_verification_cache cache(2u);
+	cache.add_result(create_hash(std::byte{ 1 }), {});
+	cache.add_result(create_hash(std::byte{ 2 }), {});
+	EXPECT_TRUE(cache.find_result(create_hash(std::byte{ 1 })));
+	EXPECT_TRUE(cache.find_result(create_hash(std::byte{ 2 })));
+
+	cache.add_result(create_hash(std::byte{ 3 }), {});
+	EXPECT_FALSE(cache.find_result(create_hash(std::byte{ 1 })));
+	EXPECT_FALSE(cache.find_result(create_hash(std::byte{ 2 })));
+	EXPECT_TRUE(cache.find_result(create_hash(std::byte{ 3 })));
+}
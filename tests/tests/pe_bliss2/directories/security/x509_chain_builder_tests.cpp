@@ -0,0 +1,399 @@
+#include "pe_bliss2/security/x509/x509_chain_builder.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+#include "pe_bliss2/security/signature_verification_cache.h"
+#include "pe_bliss2/security/x509/x509_certificate_store.h"
+#include "pe_bliss2/security/x509/x509_extensions.h"
+#include "pe_bliss2/security/x509/x509_key_identifiers.h"
+
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+
+using namespace pe_bliss::security;
+using namespace pe_bliss::security::x509;
+
+namespace
+{
+const auto root_public_key = hex_string_to_bytes(
+	"30818902818100aa1cc8371d19e3bb09efbaabf0158e680263b3c3311fff1d3abf8e75b89408e57b0091"
+	"5f2df72dfa38fa78f61cb6adb4a2bf2df0de5215de475e4d32a5048dc3216a0bd453f79334fcdfb99c99"
+	"8812d24155eb1c4d18e1298c609ad9e0dc9076722371cb75bd924daa0b779dd76d613f5dc71eee78e613"
+	"583b1c4c0f0600e77b0203010001");
+const auto intermediate_public_key = hex_string_to_bytes(
+	"30818902818100c1cfd56895fa86fbdff7d26d2968049e395580ebf9611c861ba018d3336b47c25e55ad"
+	"06bae9311e1dd7ea02cddab3299eda6e0185782bc1183ab8dbad0e14a832d1850963b4d38aa65292fbc6"
+	"72fd1f8124d7e11206a59ea4b8b78abbe768a6e9ebf6e0d981eda110039fda3277a499f2efb89aa4d008"
+	"b82e1c0f2c6e2e1ab90203010001");
+const auto intermediate_tbs = hex_string_to_bytes(
+	"30820175a00302010202144731f879e47517b9c9d1a9235286c94e4194219e300d06092a864886f70d01"
+	"010b050030143112301006035504030c095465737420526f6f74301e170d323631303138323332313534"
+	"5a170d3335303130343233323135345a301c311a301806035504030c115465737420496e7465726d6564"
+	"6961746530819f300d06092a864886f70d010101050003818d0030818902818100c1cfd56895fa86fbdf"
+	"f7d26d2968049e395580ebf9611c861ba018d3336b47c25e55ad06bae9311e1dd7ea02cddab3299eda6e"
+	"0185782bc1183ab8dbad0e14a832d1850963b4d38aa65292fbc672fd1f8124d7e11206a59ea4b8b78abb"
+	"e768a6e9ebf6e0d981eda110039fda3277a499f2efb89aa4d008b82e1c0f2c6e2e1ab90203010001a353"
+	"3051300f0603551d130101ff040530030101ff301d0603551d0e04160414ee12b660af905362b527a5db"
+	"e5f6147f18266608301f0603551d230418301680141bb46bdbe45e179c9d07f6a49345a0f78eb14c22");
+const auto intermediate_signature = hex_string_to_bytes(
+	"787c5d7872cad9c079e056f9415e16c1cd27bdd4a1cdab7c6629184a0667b0ee11ef6e63146e8a25468b"
+	"a4d8c0a37276bd7aab84c37d01ecc282bea7a9f60ae4dda63123a965dce858296773ed798f911089736e"
+	"cb058dac47f37b1da723a6a336bee91b4918882c9edda515ae6fc636363176d7e4bab56a8985cfb71f85"
+	"75f4");
+const auto leaf_tbs = hex_string_to_bytes(
+	"30820164a00302010202142f68e840657d3d6005b0895a84888bdd22ff179e300d06092a864886f70d01"
+	"010b0500301c311a301806035504030c115465737420496e7465726d656469617465301e170d32363130"
+	"31383233323135345a170d3237313031383233323135345a30143112301006035504030c095465737420"
+	"4c65616630819f300d06092a864886f70d010101050003818d0030818902818100dc9ba6852d96c5e026"
+	"a2a7623f75d82bcb45edeb04bffed20050df9125dc3fb6801974cd4db66f56fbde4d9b37375e5435946d"
+	"a5fe1a56f7bea372889d4695bd9606319e85efedfbf93e9415f0202c92de0bdb460f2bc23a3e9508d684"
+	"0a3fee46caefb61b3709abc65b5eeba5a26725239ce984864629761ff8d892bfdb95550203010001a342"
+	"3040301d0603551d0e041604144a01dae62aaf6d0ca9393bf5749e8e13b4e171f1301f0603551d230418"
+	"30168014ee12b660af905362b527a5dbe5f6147f18266608");
+const auto leaf_signature = hex_string_to_bytes(
+	"ab4d9d770cedf219c269b7d22045714b604981ad216a2ef86c0da81e48e707c129c53228d9625be183d8"
+	"1a0a8d4386833ffa0664c115d4e7d1cd24649f2226eccf159ee0660ed875b50125b5309912d999469702"
+	"b60468e54827b44be26712680c6784bbd57e10de6386fe2ace2fbaf853b47b644dcae4e03ce098c55438"
+	"f042");
+
+const auto root_key_id = hex_string_to_bytes("1bb46bdbe45e179c9d07f6a49345a0f78eb14c22");
+const auto intermediate_key_id = hex_string_to_bytes("ee12b660af905362b527a5dbe5f6147f18266608");
+
+constexpr auto create_time(int year)
+{
+	return std::chrono::sys_seconds(std::chrono::sys_days(
+		std::chrono::year(year) / std::chrono::January / 1));
+}
+
+vector_range_type to_range(const std::string& str)
+{
+	return { reinterpret_cast<const std::byte*>(str.data()),
+		reinterpret_cast<const std::byte*>(str.data() + str.size()) };
+}
+
+//Provides the certificate interface the chain builder relies on
+struct test_certificate
+{
+	using range_type = vector_range_type;
+
+	vector_range_type serial_number;
+	std::string issuer, subject;
+	std::optional<vector_range_type> authority_key_id, subject_key_id;
+	std::chrono::sys_seconds not_before = create_time(2026);
+	std::chrono::sys_seconds not_after = create_time(2027);
+	std::optional<vector_range_type> tbs;
+	vector_range_type signature;
+	vector_range_type public_key;
+	std::optional<vector_range_type> public_key_parameters;
+	std::optional<x509_basic_constraints> basic_constraints;
+	std::optional<std::uint32_t> key_usage;
+
+	const range_type& get_serial_number() const noexcept { return serial_number; }
+	const range_type& get_public_key() const noexcept { return public_key; }
+	const range_type& get_signature_value() const noexcept { return signature; }
+	const std::optional<range_type>& get_signature_algorithm_parameters() const noexcept
+	{
+		return public_key_parameters;
+	}
+
+	range_type get_raw_issuer() const { return to_range(issuer); }
+	range_type get_raw_subject() const { return to_range(subject); }
+
+	const std::optional<x509_basic_constraints>& get_basic_constraints() const noexcept
+	{
+		return basic_constraints;
+	}
+
+	std::optional<std::uint32_t> get_key_usage() const noexcept { return key_usage; }
+
+	std::optional<span_range_type> get_authority_key_identifier() const
+	{
+		if (!authority_key_id)
+			return {};
+		return span_range_type(*authority_key_id);
+	}
+
+	std::optional<span_range_type> get_subject_key_identifier() const
+	{
+		if (!subject_key_id)
+			return {};
+		return span_range_type(*subject_key_id);
+	}
+
+	std::optional<span_range_type> get_raw_tbs_certificate() const
+	{
+		if (!tbs)
+			return {};
+		return span_range_type(*tbs);
+	}
+
+	std::chrono::sys_seconds get_not_before() const noexcept { return not_before; }
+	std::chrono::sys_seconds get_not_after() const noexcept { return not_after; }
+
+	encryption_and_hash_algorithm get_signature_algorithm() const noexcept
+	{
+		return { digest_encryption_algorithm::rsa, digest_algorithm::sha256 };
+	}
+
+	encryption_and_hash_algorithm get_public_key_algorithm() const noexcept
+	{
+		return { digest_encryption_algorithm::rsa };
+	}
+};
+
+class X509ChainBuilderTests : public testing::Test
+{
+public:
+	X509ChainBuilderTests()
+	{
+		root.serial_number = { std::byte{ 1 } };
+		root.issuer = root.subject = "Test Root";
+		root.subject_key_id = root_key_id;
+		root.not_after = create_time(2036);
+		root.public_key = root_public_key;
+		root.basic_constraints = x509_basic_constraints{ .ca = true };
+		root.key_usage = key_usage::key_cert_sign | key_usage::crl_sign;
+
+		intermediate.serial_number = { std::byte{ 2 } };
+		intermediate.issuer = "Test Root";
+		intermediate.subject = "Test Intermediate";
+		intermediate.authority_key_id = root_key_id;
+		intermediate.subject_key_id = intermediate_key_id;
+		intermediate.not_after = create_time(2035);
+		intermediate.tbs = intermediate_tbs;
+		intermediate.signature = intermediate_signature;
+		intermediate.public_key = intermediate_public_key;
+		intermediate.basic_constraints = x509_basic_constraints{ .ca = true, .path_length = 0u };
+		intermediate.key_usage = key_usage::key_cert_sign;
+
+		leaf.serial_number = { std::byte{ 3 } };
+		leaf.issuer = "Test Intermediate";
+		leaf.subject = "Test Leaf";
+		leaf.authority_key_id = intermediate_key_id;
+		leaf.tbs = leaf_tbs;
+		leaf.signature = leaf_signature;
+		leaf.basic_constraints = x509_basic_constraints{};
+		leaf.key_usage = key_usage::digital_signature;
+	}
+
+	void fill_stores()
+	{
+		anchors.add_certificate(test_certificate(root));
+		intermediates.add_certificate(test_certificate(intermediate));
+		intermediates.add_certificate(test_certificate(leaf));
+	}
+
+	const test_certificate& get_leaf() const
+	{
+		return *intermediates.find_certificate(leaf.serial_number, leaf.get_raw_issuer());
+	}
+
+public:
+	test_certificate root, intermediate, leaf;
+	x509_certificate_store<test_certificate> anchors, intermediates;
+};
+} //namespace
+
+TEST_F(X509ChainBuilderTests, ValidChain)
+{
+	fill_stores();
+	signature_verification_cache cache;
+	x509_chain_options options;
+	options.validation_time = create_time(2026) + std::chrono::days(300);
+	options.verification_cache = &cache;
+
+	for (int i = 0; i != 2; ++i)
+	{
+		const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors, options);
+		EXPECT_TRUE(chain.is_trusted());
+		EXPECT_FALSE(chain.errors.has_errors());
+		ASSERT_EQ(chain.certificates.size(), 2u);
+		EXPECT_EQ(chain.certificates[0], &get_leaf());
+		EXPECT_EQ(chain.certificates[1]->subject, "Test Intermediate");
+		ASSERT_NE(chain.root, nullptr);
+		EXPECT_EQ(chain.root->subject, "Test Root");
+	}
+
+	EXPECT_EQ(cache.get_statistics().result_hits, 2u);
+}
+
+TEST_F(X509ChainBuilderTests, InvalidSignature)
+{
+	intermediate.signature[5] ^= std::byte{ 1 };
+	fill_stores();
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 2u);
+	EXPECT_NE(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(
+		x509_chain_errc::invalid_certificate_signature, 1u));
+	EXPECT_EQ(chain.errors.get_errors()->size(), 1u);
+}
+
+TEST_F(X509ChainBuilderTests, UnableToVerifySignature)
+{
+	intermediate.tbs.reset();
+	fill_stores();
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_FALSE(chain.is_trusted());
+	EXPECT_TRUE(chain.errors.has_error(
+		x509_chain_errc::unable_to_verify_certificate_signature, 1u));
+}
+
+TEST_F(X509ChainBuilderTests, IssuerNotFound)
+{
+	intermediates.add_certificate(test_certificate(leaf));
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 1u);
+	EXPECT_EQ(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::issuer_not_found, 0u));
+}
+
+TEST_F(X509ChainBuilderTests, KeyIdentifierMismatch)
+{
+	root.subject_key_id = intermediate_key_id;
+	fill_stores();
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_EQ(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::issuer_not_found, 1u));
+}
+
+TEST_F(X509ChainBuilderTests, UntrustedRoot)
+{
+	intermediates.add_certificate(test_certificate(root));
+	intermediates.add_certificate(test_certificate(intermediate));
+	intermediates.add_certificate(test_certificate(leaf));
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 3u);
+	EXPECT_EQ(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::untrusted_root, 2u));
+	EXPECT_EQ(chain.errors.get_errors()->size(), 1u);
+}
+
+TEST_F(X509ChainBuilderTests, Validity)
+{
+	fill_stores();
+	x509_chain_options options;
+	options.validation_time = create_time(2025);
+	auto chain = build_certificate_chain(get_leaf(), intermediates, anchors, options);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::certificate_not_yet_valid, 0u));
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::certificate_not_yet_valid, 1u));
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::certificate_not_yet_valid, 2u));
+
+	options.validation_time = create_time(2030);
+	chain = build_certificate_chain(get_leaf(), intermediates, anchors, options);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::certificate_expired, 0u));
+	EXPECT_EQ(chain.errors.get_errors()->size(), 1u);
+}
+
+TEST_F(X509ChainBuilderTests, ChainTooLong)
+{
+	fill_stores();
+	x509_chain_options options;
+	options.max_length = 1u;
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors, options);
+	EXPECT_EQ(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::chain_too_long));
+}
+
+TEST_F(X509ChainBuilderTests, AnchorWithoutBasicConstraints)
+{
+	root.basic_constraints.reset();
+	root.key_usage.reset();
+	fill_stores();
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_TRUE(chain.is_trusted());
+}
+
+TEST_F(X509ChainBuilderTests, LeafAsIssuer)
+{
+	test_certificate leaf_child;
+	leaf_child.serial_number = { std::byte{ 4 } };
+	leaf_child.issuer = "Test Leaf";
+	leaf_child.subject = "Test Leaf Child";
+	leaf_child.tbs = leaf_tbs;
+	leaf_child.signature = leaf_signature;
+	fill_stores();
+	intermediates.add_certificate(test_certificate(leaf_child));
+
+	const auto& child = *intermediates.find_certificate(
+		leaf_child.serial_number, leaf_child.get_raw_issuer());
+	auto chain = build_certificate_chain(child, intermediates, anchors);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 1u);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::issuer_is_not_ca, 0u));
+	EXPECT_EQ(chain.errors.get_errors()->size(), 1u);
+
+	//CA certificate which is not allowed to sign certificates
+	intermediates.find_certificate(leaf.serial_number, leaf.get_raw_issuer())
+		->basic_constraints = x509_basic_constraints{ .ca = true };
+	intermediates.find_certificate(leaf.serial_number, leaf.get_raw_issuer())
+		->key_usage = key_usage::digital_signature;
+	chain = build_certificate_chain(child, intermediates, anchors);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::issuer_is_not_ca, 0u));
+}
+
+TEST_F(X509ChainBuilderTests, NonCaAnchor)
+{
+	root.basic_constraints = x509_basic_constraints{};
+	fill_stores();
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_EQ(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::issuer_is_not_ca, 1u));
+}
+
+TEST_F(X509ChainBuilderTests, PathLengthExceeded)
+{
+	//Intermediate (pathLenConstraint = 0) -> Sub CA -> Leaf
+	test_certificate sub_ca;
+	sub_ca.serial_number = { std::byte{ 5 } };
+	sub_ca.issuer = "Test Intermediate";
+	sub_ca.subject = "Test Sub CA";
+	sub_ca.basic_constraints = x509_basic_constraints{ .ca = true };
+	leaf.issuer = "Test Sub CA";
+	leaf.authority_key_id.reset();
+	fill_stores();
+	intermediates.add_certificate(test_certificate(sub_ca));
+
+	const auto chain = build_certificate_chain(get_leaf(), intermediates, anchors);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 2u);
+	EXPECT_EQ(chain.certificates[1]->subject, "Test Sub CA");
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::path_length_exceeded, 1u));
+}
+
+TEST(X509KeyIdentifiersTests, Decode)
+{
+	const auto subject_key_id = hex_string_to_bytes(
+		"0414ee12b660af905362b527a5dbe5f6147f18266608");
+	auto decoded = decode_subject_key_identifier(subject_key_id);
+	ASSERT_TRUE(decoded);
+	EXPECT_TRUE(std::ranges::equal(*decoded, intermediate_key_id));
+
+	const auto authority_key_id = hex_string_to_bytes(
+		"301680141bb46bdbe45e179c9d07f6a49345a0f78eb14c22");
+	decoded = decode_authority_key_identifier(authority_key_id);
+	ASSERT_TRUE(decoded);
+	EXPECT_TRUE(std::ranges::equal(*decoded, root_key_id));
+
+	//Truncated
+	EXPECT_FALSE(decode_subject_key_identifier(
+		span_range_type(subject_key_id).first(10u)));
+	//Trailing data
+	auto with_tail = subject_key_id;
+	with_tail.push_back({});
+	EXPECT_FALSE(decode_subject_key_identifier(with_tail));
+	//No keyIdentifier (authorityCertSerialNumber only)
+	EXPECT_FALSE(decode_authority_key_identifier(hex_string_to_bytes("3003820101")));
+	EXPECT_FALSE(decode_authority_key_identifier(subject_key_id));
+}
@@ -0,0 +1,185 @@
+#include "pe_bliss2/security/x509/x509_der_certificate.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/crypto_algorithms.h"
+#include "pe_bliss2/security/x509/x509_extensions.h"
+
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+#include "tests/pe_bliss2/directories/security/x509_test_certificates.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss::security;
+using namespace pe_bliss::security::x509;
+
+namespace
+{
+template<typename Array>
+span_range_type as_range(const Array& data) noexcept
+{
+	return std::as_bytes(std::span(data));
+}
+
+constexpr auto create_time(std::chrono::year_month_day date,
+	int hour, int minute, int second)
+{
+	return std::chrono::sys_days(date) + std::chrono::hours(hour)
+		+ std::chrono::minutes(minute) + std::chrono::seconds(second);
+}
+
+const auto root_key_id = hex_string_to_bytes("ca0e83af7e7dd250f67129db85b51db134de829a");
+const auto intermediate_key_id = hex_string_to_bytes("9c0097f8cb442989981d4db4ffabe1dd1e3730a4");
+} //namespace
+
+TEST(X509DerCertificateTests, Root)
+{
+	const x509_der_certificate cert(as_range(x509_test_root_certificate));
+	EXPECT_EQ(cert.get_raw_data().data(), as_range(x509_test_root_certificate).data());
+	EXPECT_EQ(cert.get_raw_data().size(), x509_test_root_certificate.size());
+	EXPECT_TRUE(std::ranges::equal(cert.get_serial_number(),
+		std::vector{ std::byte{ 1 } }));
+	EXPECT_TRUE(std::ranges::equal(cert.get_raw_issuer(), cert.get_raw_subject()));
+	EXPECT_TRUE(std::ranges::equal(cert.get_raw_subject(),
+		hex_string_to_bytes("30143112301006035504030c095465737420526f6f74")));
+
+	using namespace std::chrono;
+	EXPECT_EQ(cert.get_not_before(),
+		create_time(year(2026) / October / 19, 2, 58, 40));
+	//GeneralizedTime
+	EXPECT_EQ(cert.get_not_after(),
+		create_time(year(2054) / March / 6, 2, 58, 40));
+
+	EXPECT_EQ(cert.get_signature_algorithm(), (encryption_and_hash_algorithm{
+		digest_encryption_algorithm::rsa, digest_algorithm::sha256 }));
+	EXPECT_EQ(cert.get_signature_value().size(), 128u);
+	EXPECT_EQ(cert.get_public_key_algorithm(), (encryption_and_hash_algorithm{
+		digest_encryption_algorithm::rsa }));
+	EXPECT_EQ(cert.get_public_key().size(), 140u);
+	ASSERT_TRUE(cert.get_signature_algorithm_parameters());
+	EXPECT_TRUE(std::ranges::equal(*cert.get_signature_algorithm_parameters(),
+		hex_string_to_bytes("0500")));
+
+	const auto tbs = cert.get_raw_tbs_certificate();
+	ASSERT_TRUE(tbs);
+	EXPECT_EQ(tbs->data(), cert.get_raw_data().data() + 4u);
+	EXPECT_EQ(tbs->size(), 0x14fu);
+
+	EXPECT_EQ(cert.get_basic_constraints(), x509_basic_constraints{ .ca = true });
+	EXPECT_EQ(cert.get_key_usage(), key_usage::key_cert_sign | key_usage::crl_sign);
+	ASSERT_TRUE(cert.get_subject_key_identifier());
+	EXPECT_TRUE(std::ranges::equal(*cert.get_subject_key_identifier(), root_key_id));
+	EXPECT_FALSE(cert.get_authority_key_identifier());
+}
+
+TEST(X509DerCertificateTests, IntermediateAndLeaf)
+{
+	const x509_der_certificate intermediate(as_range(x509_test_intermediate_certificate));
+	EXPECT_EQ(intermediate.get_basic_constraints(),
+		(x509_basic_constraints{ .ca = true, .path_length = 0u }));
+	EXPECT_EQ(intermediate.get_key_usage(), key_usage::key_cert_sign);
+	ASSERT_TRUE(intermediate.get_authority_key_identifier());
+	EXPECT_TRUE(std::ranges::equal(*intermediate.get_authority_key_identifier(),
+		root_key_id));
+
+	const x509_der_certificate root(as_range(x509_test_root_certificate));
+	EXPECT_TRUE(std::ranges::equal(intermediate.get_raw_issuer(), root.get_raw_subject()));
+
+	const x509_der_certificate leaf(as_range(x509_test_leaf_certificate));
+	EXPECT_TRUE(std::ranges::equal(leaf.get_serial_number(),
+		std::vector{ std::byte{ 3 } }));
+	EXPECT_TRUE(std::ranges::equal(leaf.get_raw_issuer(), intermediate.get_raw_subject()));
+	EXPECT_EQ(leaf.get_basic_constraints(), x509_basic_constraints{});
+	EXPECT_EQ(leaf.get_key_usage(), key_usage::digital_signature);
+	ASSERT_TRUE(leaf.get_authority_key_identifier());
+	EXPECT_TRUE(std::ranges::equal(*leaf.get_authority_key_identifier(),
+		intermediate_key_id));
+	EXPECT_EQ(leaf.get_not_after() - leaf.get_not_before(), std::chrono::days(365));
+}
+
+TEST(X509DerCertificateTests, InvalidCertificate)
+{
+	std::vector<std::byte> data(x509_test_root_certificate.size());
+	std::ranges::copy(as_range(x509_test_root_certificate), data.begin());
+
+	expect_throw_pe_error([&] {
+		(void)x509_der_certificate(span_range_type(data).first(data.size() - 1u));
+	}, x509_der_certificate_errc::invalid_certificate);
+
+	auto with_tail = data;
+	with_tail.push_back({});
+	expect_throw_pe_error([&] {
+		(void)x509_der_certificate(with_tail);
+	}, x509_der_certificate_errc::invalid_certificate);
+
+	expect_throw_pe_error([&] {
+		(void)x509_der_certificate(span_range_type{});
+	}, x509_der_certificate_errc::invalid_certificate);
+
+	//notBefore UTCTime with a non-digit character
+	const auto utc_time = hex_string_to_bytes("170d");
+	auto time = std::ranges::search(data, utc_time);
+	ASSERT_FALSE(time.empty());
+	time.end()[0] = std::byte{ 'x' };
+	expect_throw_pe_error([&] {
+		(void)x509_der_certificate(data);
+	}, x509_der_certificate_errc::invalid_validity);
+}
+
+TEST(X509DerCertificateTests, InvalidExtension)
+{
+	std::vector<std::byte> data(x509_test_root_certificate.size());
+	std::ranges::copy(as_range(x509_test_root_certificate), data.begin());
+
+	//basicConstraints with a negative pathLenConstraint instead of cA
+	const auto basic_constraints = hex_string_to_bytes("300301");
+	auto value = std::ranges::search(data, basic_constraints);
+	ASSERT_FALSE(value.empty());
+	value.end()[-1] = std::byte{ 0x02u };
+	expect_throw_pe_error([&] {
+		(void)x509_der_certificate(data);
+	}, x509_der_certificate_errc::invalid_extension);
+}
+
+TEST(X509ExtensionsTests, DecodeBasicConstraints)
+{
+	EXPECT_EQ(decode_basic_constraints(hex_string_to_bytes("3000")),
+		x509_basic_constraints{});
+	EXPECT_EQ(decode_basic_constraints(hex_string_to_bytes("30030101ff")),
+		x509_basic_constraints{ .ca = true });
+	EXPECT_EQ(decode_basic_constraints(hex_string_to_bytes("30060101ff020103")),
+		(x509_basic_constraints{ .ca = true, .path_length = 3u }));
+	EXPECT_EQ(decode_basic_constraints(hex_string_to_bytes("3003020100")),
+		(x509_basic_constraints{ .path_length = 0u }));
+
+	EXPECT_FALSE(decode_basic_constraints({}));
+	//Negative path length
+	EXPECT_FALSE(decode_basic_constraints(hex_string_to_bytes("3003020180")));
+	//Path length does not fit 32 bits
+	EXPECT_FALSE(decode_basic_constraints(hex_string_to_bytes("300702050100000000")));
+	//Trailing data
+	EXPECT_FALSE(decode_basic_constraints(hex_string_to_bytes("300001")));
+	EXPECT_FALSE(decode_basic_constraints(hex_string_to_bytes("30060101ff0101ff")));
+}
+
+TEST(X509ExtensionsTests, DecodeKeyUsage)
+{
+	EXPECT_EQ(decode_key_usage(hex_string_to_bytes("03020780")),
+		key_usage::digital_signature);
+	EXPECT_EQ(decode_key_usage(hex_string_to_bytes("03020106")),
+		key_usage::key_cert_sign | key_usage::crl_sign);
+	EXPECT_EQ(decode_key_usage(hex_string_to_bytes("0303070080")),
+		key_usage::decipher_only);
+	EXPECT_EQ(decode_key_usage(hex_string_to_bytes("030100")), 0u);
+
+	EXPECT_FALSE(decode_key_usage({}));
+	EXPECT_FALSE(decode_key_usage(hex_string_to_bytes("0300")));
+	EXPECT_FALSE(decode_key_usage(hex_string_to_bytes("03020806")));
+	EXPECT_FALSE(decode_key_usage(hex_string_to_bytes("04020106")));
+}
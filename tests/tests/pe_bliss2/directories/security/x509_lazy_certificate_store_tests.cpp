@@ -0,0 +1,108 @@
+#include "pe_bliss2/security/x509/x509_lazy_certificate_store.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/byte_range_types.h"
+
+#include "tests/pe_bliss2/directories/security/common_authenticode_data.h"
+#include "tests/pe_bliss2/directories/security/hex_string_helpers.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss::security;
+using namespace pe_bliss::security::x509;
+
+namespace
+{
+span_range_type get_valid_authenticode() noexcept
+{
+	return std::as_bytes(std::span(valid_authenticode));
+}
+
+constexpr std::size_t first_certificate_offset = 141u;
+constexpr std::size_t first_certificate_size = 770u;
+} //namespace
+
+TEST(X509LazyCertificateStoreTests, Empty)
+{
+	x509_lazy_certificate_store store;
+	EXPECT_TRUE(store.empty());
+	EXPECT_EQ(store.find_certificate({}, {}), nullptr);
+}
+
+TEST(X509LazyCertificateStoreTests, BuildFromSignature)
+{
+	pe_bliss::error_list warnings;
+	const auto store = build_lazy_certificate_store(get_valid_authenticode(), &warnings);
+	expect_contains_errors(warnings);
+	EXPECT_EQ(store.size(), 4u);
+	EXPECT_EQ(store.get_decoded_count(), 0u);
+
+	const auto serial_number = hex_string_to_bytes("23eff072256af4914caeff821ee2924d");
+	const auto issuer = hex_string_to_bytes("3010310e300c060355040313054d79204341");
+	const auto* cert = store.find_certificate(serial_number, issuer);
+	ASSERT_NE(cert, nullptr);
+	EXPECT_EQ(store.get_decoded_count(), 1u);
+	EXPECT_TRUE(std::ranges::equal(cert->get_serial_number(), serial_number));
+	EXPECT_TRUE(std::ranges::equal(cert->get_raw_issuer(), issuer));
+	EXPECT_FALSE(cert->get_public_key().empty());
+
+	EXPECT_EQ(store.find_certificate(serial_number, issuer), cert);
+	EXPECT_EQ(store.get_decoded_count(), 1u);
+
+	EXPECT_EQ(store.find_certificate(issuer, serial_number), nullptr);
+	EXPECT_EQ(store.get_decoded_count(), 1u);
+}
+
+TEST(X509LazyCertificateStoreTests, Duplicate)
+{
+	x509_lazy_certificate_store store;
+	const auto certificate = get_valid_authenticode().subspan(
+		first_certificate_offset, first_certificate_size);
+	EXPECT_TRUE(store.add_certificate(certificate));
+	EXPECT_FALSE(store.add_certificate(certificate));
+	EXPECT_EQ(store.size(), 1u);
+}
+
+TEST(X509LazyCertificateStoreTests, InvalidCertificate)
+{
+	x509_lazy_certificate_store store;
+	const auto invalid_certificate = hex_string_to_bytes("3003020101");
+	expect_throw_pe_error([&] {
+		(void)store.add_certificate(invalid_certificate);
+	}, x509_lazy_certificate_store_errc::invalid_certificate);
+
+	//Serial number and issuer are valid, but the rest of the certificate is not
+	const auto certificate = hex_string_to_bytes(
+		"30193017020101300030" "10310e300c060355040313054d79204341");
+	ASSERT_TRUE(store.add_certificate(certificate));
+	expect_throw_pe_error([&] {
+		(void)store.find_certificate(hex_string_to_bytes("01"),
+			hex_string_to_bytes("3010310e300c060355040313054d79204341"));
+	}, x509_lazy_certificate_store_errc::invalid_certificate);
+}
+
+TEST(X509LazyCertificateStoreTests, InvalidSignature)
+{
+	expect_throw_pe_error([] {
+		(void)build_lazy_certificate_store(
+			get_valid_authenticode().subspan(0u, 100u));
+	}, x509_lazy_certificate_store_errc::invalid_signature_format);
+}
+
+TEST(X509LazyCertificateStoreTests, AbsentCertificates)
+{
+	//ContentInfo with empty SignedData
+	const auto signature = hex_string_to_bytes(
+		"300f06092a864886f70d010702a0023000");
+	pe_bliss::error_list warnings;
+	const auto store = build_lazy_certificate_store(signature, &warnings);
+	EXPECT_TRUE(store.empty());
+	expect_contains_errors(warnings,
+		x509_lazy_certificate_store_errc::absent_certificates);
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+//Certificates with 1024-bit RSA keys and sha256WithRSAEncryption signatures
+
+//Test Root: CA, keyCertSign and cRLSign, notAfter is GeneralizedTime
+constexpr std::array<std::uint8_t, 486u> x509_test_root_certificate{
+	0x30, 0x82, 0x01, 0xe2, 0x30, 0x82, 0x01, 0x4b, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x01,
+	0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+	0x14, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x09, 0x54, 0x65, 0x73, 0x74,
+	0x20, 0x52, 0x6f, 0x6f, 0x74, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x39, 0x30,
+	0x32, 0x35, 0x38, 0x34, 0x30, 0x5a, 0x18, 0x0f, 0x32, 0x30, 0x35, 0x34, 0x30, 0x33, 0x30, 0x36,
+	0x30, 0x32, 0x35, 0x38, 0x34, 0x30, 0x5a, 0x30, 0x14, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55,
+	0x04, 0x03, 0x0c, 0x09, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x6f, 0x6f, 0x74, 0x30, 0x81, 0x9f,
+	0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01, 0x05, 0x00, 0x03,
+	0x81, 0x8d, 0x00, 0x30, 0x81, 0x89, 0x02, 0x81, 0x81, 0x00, 0xc9, 0xcf, 0xa3, 0x2e, 0x26, 0xfc,
+	0x3b, 0x0f, 0xcb, 0x31, 0xb7, 0xf8, 0x8b, 0xfc, 0x4d, 0xda, 0xd0, 0x94, 0xde, 0x8a, 0x22, 0xe0,
+	0x79, 0x34, 0x12, 0x79, 0x32, 0x40, 0xf4, 0xed, 0xbf, 0xcb, 0x52, 0xfc, 0xc4, 0x2f, 0x51, 0x28,
+	0x87, 0x0d, 0xa7, 0xed, 0x2a, 0x52, 0xbb, 0x95, 0xb0, 0x6d, 0xa5, 0xb4, 0xdc, 0xbd, 0x29, 0xc4,
+	0x83, 0xe2, 0x4c, 0x6b, 0xaf, 0xc7, 0x14, 0x02, 0x07, 0x4c, 0xf0, 0xdd, 0xe4, 0xba, 0xb1, 0x94,
+	0x23, 0x7d, 0x35, 0x01, 0x4e, 0xbf, 0xde, 0x60, 0xcb, 0x24, 0x4c, 0xa2, 0x6a, 0xb8, 0x7c, 0xa1,
+	0x5e, 0xb5, 0x96, 0x28, 0xaf, 0x7e, 0x52, 0xed, 0x30, 0x91, 0xb5, 0x41, 0x0e, 0x3e, 0x5e, 0xe2,
+	0x26, 0x27, 0x8c, 0x9d, 0xc6, 0x54, 0x04, 0x6f, 0x44, 0x17, 0xa0, 0x00, 0x83, 0xff, 0x52, 0x01,
+	0xc2, 0xb7, 0x18, 0x11, 0xea, 0xdb, 0x58, 0x92, 0x92, 0xbb, 0x02, 0x03, 0x01, 0x00, 0x01, 0xa3,
+	0x42, 0x30, 0x40, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30,
+	0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+	0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xca,
+	0x0e, 0x83, 0xaf, 0x7e, 0x7d, 0xd2, 0x50, 0xf6, 0x71, 0x29, 0xdb, 0x85, 0xb5, 0x1d, 0xb1, 0x34,
+	0xde, 0x82, 0x9a, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b,
+	0x05, 0x00, 0x03, 0x81, 0x81, 0x00, 0x33, 0xa3, 0xf7, 0xd5, 0x28, 0x7f, 0x80, 0x8b, 0xac, 0x7a,
+	0xd9, 0x63, 0x7e, 0x9a, 0x7a, 0x04, 0x96, 0x01, 0x76, 0x30, 0x73, 0xa7, 0x76, 0x53, 0x87, 0x61,
+	0x6c, 0xa5, 0xc8, 0xee, 0x98, 0x0f, 0x64, 0xe1, 0xcc, 0x80, 0x40, 0x42, 0xf0, 0x80, 0xa9, 0x5d,
+	0x5a, 0x31, 0xdb, 0xae, 0x0b, 0xdb, 0xc0, 0xc9, 0x9d, 0xb5, 0x01, 0x71, 0xdc, 0xb9, 0xf4, 0x3f,
+	0x00, 0x05, 0xb4, 0xff, 0xf4, 0x2e, 0x13, 0x36, 0xaa, 0xb6, 0xa8, 0x58, 0x07, 0xfb, 0x3d, 0xaf,
+	0xf8, 0x62, 0x16, 0x72, 0x3b, 0x7e, 0xfc, 0x8c, 0xa0, 0x43, 0xa8, 0x0b, 0x75, 0xe7, 0x88, 0xf4,
+	0x5d, 0x27, 0xdb, 0x2b, 0xda, 0xd6, 0x05, 0x75, 0x9c, 0xa3, 0x54, 0x91, 0x3b, 0x80, 0x17, 0xe0,
+	0xbd, 0x9e, 0x08, 0x92, 0x32, 0x63, 0xac, 0x33, 0x75, 0x3f, 0x95, 0xd2, 0xd7, 0x9a, 0xf0, 0x93,
+	0x08, 0xd6, 0x8d, 0xcd, 0x77, 0x5d
+};
+
+//Test Intermediate: CA with pathLenConstraint 0, issued by Test Root
+constexpr std::array<std::uint8_t, 528u> x509_test_intermediate_certificate{
+	0x30, 0x82, 0x02, 0x0c, 0x30, 0x82, 0x01, 0x75, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x02,
+	0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+	0x14, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x09, 0x54, 0x65, 0x73, 0x74,
+	0x20, 0x52, 0x6f, 0x6f, 0x74, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x39, 0x30,
+	0x32, 0x35, 0x38, 0x34, 0x30, 0x5a, 0x17, 0x0d, 0x33, 0x35, 0x30, 0x31, 0x30, 0x35, 0x30, 0x32,
+	0x35, 0x38, 0x34, 0x30, 0x5a, 0x30, 0x1c, 0x31, 0x1a, 0x30, 0x18, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0c, 0x11, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69,
+	0x61, 0x74, 0x65, 0x30, 0x81, 0x9f, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d,
+	0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x81, 0x8d, 0x00, 0x30, 0x81, 0x89, 0x02, 0x81, 0x81, 0x00,
+	0xa8, 0x4c, 0xf8, 0xf0, 0xd5, 0x51, 0xa0, 0x41, 0x3d, 0x11, 0xb0, 0xdc, 0x48, 0x1c, 0x8e, 0x17,
+	0x44, 0xef, 0x5f, 0x6a, 0xa8, 0x80, 0x7b, 0xb3, 0x20, 0x85, 0xa6, 0x43, 0x21, 0x0e, 0xb6, 0x15,
+	0xc9, 0x7a, 0xab, 0x29, 0x42, 0xe9, 0xb4, 0x9c, 0x28, 0x7e, 0xf3, 0xc5, 0x0a, 0x60, 0x46, 0x13,
+	0x8d, 0x2e, 0xa2, 0x15, 0x41, 0xd3, 0xa1, 0x81, 0x5e, 0x5d, 0xd8, 0xa7, 0x70, 0x55, 0x55, 0x66,
+	0x1b, 0xf6, 0x26, 0x2e, 0x23, 0x6b, 0xa7, 0x85, 0x1c, 0x2d, 0xc8, 0x01, 0xe0, 0xc2, 0x74, 0xab,
+	0x23, 0xee, 0xcc, 0x4d, 0x36, 0x51, 0x08, 0x91, 0x73, 0x6d, 0xfb, 0x81, 0xcd, 0x3a, 0xc3, 0x92,
+	0xe6, 0x1f, 0x8b, 0xa2, 0x22, 0xa5, 0xa0, 0xf1, 0x1b, 0xc7, 0x94, 0xb1, 0x09, 0x7f, 0xed, 0x46,
+	0x76, 0xc6, 0x91, 0x68, 0x73, 0xb6, 0xac, 0xd2, 0x2d, 0x41, 0xe2, 0xef, 0x22, 0x07, 0x53, 0x61,
+	0x02, 0x03, 0x01, 0x00, 0x01, 0xa3, 0x66, 0x30, 0x64, 0x30, 0x12, 0x06, 0x03, 0x55, 0x1d, 0x13,
+	0x01, 0x01, 0xff, 0x04, 0x08, 0x30, 0x06, 0x01, 0x01, 0xff, 0x02, 0x01, 0x00, 0x30, 0x0e, 0x06,
+	0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x02, 0x04, 0x30, 0x1d, 0x06,
+	0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x9c, 0x00, 0x97, 0xf8, 0xcb, 0x44, 0x29, 0x89,
+	0x98, 0x1d, 0x4d, 0xb4, 0xff, 0xab, 0xe1, 0xdd, 0x1e, 0x37, 0x30, 0xa4, 0x30, 0x1f, 0x06, 0x03,
+	0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0xca, 0x0e, 0x83, 0xaf, 0x7e, 0x7d, 0xd2,
+	0x50, 0xf6, 0x71, 0x29, 0xdb, 0x85, 0xb5, 0x1d, 0xb1, 0x34, 0xde, 0x82, 0x9a, 0x30, 0x0d, 0x06,
+	0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x03, 0x81, 0x81, 0x00,
+	0x11, 0xa7, 0xfc, 0x7f, 0xaf, 0x93, 0xf8, 0x54, 0x6f, 0x36, 0x8f, 0x88, 0x19, 0x93, 0xe2, 0x73,
+	0x65, 0x26, 0x05, 0x9a, 0x47, 0xc9, 0xef, 0xcb, 0xe6, 0x4c, 0x5b, 0x78, 0x31, 0x2f, 0x95, 0x69,
+	0xc9, 0xb8, 0x3d, 0x3a, 0x89, 0x9b, 0xab, 0xc9, 0xfa, 0x97, 0x1f, 0x2e, 0xa5, 0xcb, 0x17, 0x6b,
+	0xbe, 0xac, 0x61, 0xe6, 0x05, 0xa6, 0x7c, 0xe7, 0xb2, 0x4b, 0xd5, 0x41, 0xa4, 0x5e, 0x7b, 0xcf,
+	0x35, 0xfa, 0x5b, 0x92, 0x9a, 0x71, 0x4a, 0x4a, 0xbd, 0x1d, 0x2e, 0xff, 0xd8, 0x4a, 0x46, 0x81,
+	0x5d, 0x26, 0x92, 0xf8, 0xaf, 0xa8, 0x54, 0xa6, 0x86, 0xb3, 0x80, 0xd8, 0x14, 0xbe, 0x17, 0xc7,
+	0xa4, 0xba, 0xa7, 0xf1, 0x34, 0x00, 0x53, 0x82, 0xa4, 0x20, 0x80, 0x26, 0xbc, 0x04, 0x84, 0x79,
+	0xb8, 0x92, 0xa5, 0x7a, 0xe7, 0xc0, 0x46, 0xff, 0x72, 0xf2, 0xbe, 0x10, 0xf1, 0x33, 0xbe, 0x20
+};
+
+//Test Leaf: not a CA, issued by Test Intermediate
+constexpr std::array<std::uint8_t, 519u> x509_test_leaf_certificate{
+	0x30, 0x82, 0x02, 0x03, 0x30, 0x82, 0x01, 0x6c, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x03,
+	0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+	0x1c, 0x31, 0x1a, 0x30, 0x18, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x11, 0x54, 0x65, 0x73, 0x74,
+	0x20, 0x49, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x30, 0x1e, 0x17,
+	0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x39, 0x30, 0x32, 0x35, 0x38, 0x34, 0x30, 0x5a, 0x17, 0x0d,
+	0x32, 0x37, 0x31, 0x30, 0x31, 0x39, 0x30, 0x32, 0x35, 0x38, 0x34, 0x30, 0x5a, 0x30, 0x14, 0x31,
+	0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x09, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4c,
+	0x65, 0x61, 0x66, 0x30, 0x81, 0x9f, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d,
+	0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x81, 0x8d, 0x00, 0x30, 0x81, 0x89, 0x02, 0x81, 0x81, 0x00,
+	0xd6, 0x95, 0x27, 0xba, 0xff, 0x26, 0xda, 0x48, 0x84, 0x29, 0xcd, 0x7c, 0x40, 0xd1, 0x37, 0xb6,
+	0x90, 0x09, 0x12, 0x7b, 0xf5, 0x33, 0x06, 0xa8, 0xb1, 0x3f, 0x5a, 0xdd, 0xba, 0x36, 0x1c, 0x1b,
+	0x90, 0xb0, 0xbe, 0x84, 0x3a, 0x88, 0x52, 0x92, 0xd8, 0xef, 0x0b, 0xac, 0x0e, 0x8c, 0xc7, 0xea,
+	0xe4, 0xc2, 0xa3, 0x57, 0x02, 0x42, 0x55, 0xd1, 0xc7, 0xf6, 0x5d, 0x20, 0xf4, 0x2b, 0xe3, 0x8d,
+	0x66, 0x84, 0xf6, 0x52, 0x90, 0xbc, 0xb1, 0x39, 0x01, 0xa8, 0x9b, 0xeb, 0x49, 0x87, 0xdc, 0xc3,
+	0xce, 0xad, 0xc7, 0xd9, 0x0d, 0xb8, 0x78, 0x3d, 0x1c, 0x5e, 0x50, 0xab, 0x4e, 0x2c, 0xb0, 0xbd,
+	0x1b, 0xb4, 0x8e, 0x56, 0xb0, 0x5b, 0x3b, 0xae, 0x77, 0xae, 0x40, 0xc6, 0x4c, 0x0e, 0xdd, 0x90,
+	0xa6, 0x37, 0x1e, 0x05, 0x7c, 0x88, 0x8c, 0x3f, 0x61, 0x83, 0x83, 0xbe, 0x56, 0x67, 0x5b, 0x79,
+	0x02, 0x03, 0x01, 0x00, 0x01, 0xa3, 0x5d, 0x30, 0x5b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x1d, 0x13,
+	0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+	0x03, 0x02, 0x07, 0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x61,
+	0x92, 0xad, 0x62, 0x26, 0xea, 0xc7, 0xaa, 0x3d, 0x86, 0x39, 0x4e, 0xb1, 0x60, 0x99, 0x89, 0xb2,
+	0x7c, 0xc7, 0x7e, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+	0x9c, 0x00, 0x97, 0xf8, 0xcb, 0x44, 0x29, 0x89, 0x98, 0x1d, 0x4d, 0xb4, 0xff, 0xab, 0xe1, 0xdd,
+	0x1e, 0x37, 0x30, 0xa4, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01,
+	0x0b, 0x05, 0x00, 0x03, 0x81, 0x81, 0x00, 0x14, 0x6b, 0x56, 0x80, 0x3b, 0x4e, 0xc7, 0x22, 0xc0,
+	0xe1, 0x90, 0xe6, 0x1b, 0xc7, 0x45, 0x0e, 0x5b, 0xb6, 0x4c, 0xc0, 0xca, 0x61, 0x8f, 0x62, 0xd1,
+	0x52, 0x20, 0x41, 0x46, 0x18, 0xff, 0x71, 0x89, 0x6d, 0xaa, 0x4a, 0xe6, 0x8f, 0x8d, 0x08, 0x33,
+	0x34, 0x6b, 0x94, 0x45, 0x30, 0x33, 0xc0, 0x81, 0x50, 0x28, 0x15, 0x3e, 0xf6, 0xcc, 0xc7, 0x74,
+	0x31, 0x9f, 0xf5, 0x33, 0xbb, 0x3c, 0x4c, 0xe7, 0x86, 0x6d, 0xd5, 0x18, 0xda, 0xe3, 0xb3, 0x18,
+	0xa1, 0xe0, 0x28, 0x15, 0x35, 0x4f, 0xa2, 0xa6, 0x17, 0x21, 0x1d, 0xe5, 0xbc, 0x41, 0x32, 0x54,
+	0xd2, 0xa8, 0x67, 0x6e, 0x20, 0x51, 0x44, 0x10, 0x91, 0x7b, 0x75, 0xdb, 0xe2, 0x90, 0x9d, 0x71,
+	0xb4, 0xc4, 0x7d, 0x7f, 0x18, 0xed, 0xee, 0x18, 0x85, 0x58, 0x80, 0x02, 0x43, 0x44, 0x02, 0x4c,
+	0xc9, 0x16, 0x63, 0x65, 0x91, 0xef, 0xd5
+};
+
+//Test Leaf Child: issued (and signed) by Test Leaf
+constexpr std::array<std::uint8_t, 517u> x509_test_leaf_child_certificate{
+	0x30, 0x82, 0x02, 0x01, 0x30, 0x82, 0x01, 0x6a, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x04,
+	0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+	0x14, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x09, 0x54, 0x65, 0x73, 0x74,
+	0x20, 0x4c, 0x65, 0x61, 0x66, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x39, 0x30,
+	0x32, 0x35, 0x38, 0x34, 0x30, 0x5a, 0x17, 0x0d, 0x32, 0x37, 0x31, 0x30, 0x31, 0x39, 0x30, 0x32,
+	0x35, 0x38, 0x34, 0x30, 0x5a, 0x30, 0x1a, 0x31, 0x18, 0x30, 0x16, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0c, 0x0f, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4c, 0x65, 0x61, 0x66, 0x20, 0x43, 0x68, 0x69, 0x6c,
+	0x64, 0x30, 0x81, 0x9f, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01,
+	0x01, 0x05, 0x00, 0x03, 0x81, 0x8d, 0x00, 0x30, 0x81, 0x89, 0x02, 0x81, 0x81, 0x00, 0xa8, 0x4c,
+	0xf8, 0xf0, 0xd5, 0x51, 0xa0, 0x41, 0x3d, 0x11, 0xb0, 0xdc, 0x48, 0x1c, 0x8e, 0x17, 0x44, 0xef,
+	0x5f, 0x6a, 0xa8, 0x80, 0x7b, 0xb3, 0x20, 0x85, 0xa6, 0x43, 0x21, 0x0e, 0xb6, 0x15, 0xc9, 0x7a,
+	0xab, 0x29, 0x42, 0xe9, 0xb4, 0x9c, 0x28, 0x7e, 0xf3, 0xc5, 0x0a, 0x60, 0x46, 0x13, 0x8d, 0x2e,
+	0xa2, 0x15, 0x41, 0xd3, 0xa1, 0x81, 0x5e, 0x5d, 0xd8, 0xa7, 0x70, 0x55, 0x55, 0x66, 0x1b, 0xf6,
+	0x26, 0x2e, 0x23, 0x6b, 0xa7, 0x85, 0x1c, 0x2d, 0xc8, 0x01, 0xe0, 0xc2, 0x74, 0xab, 0x23, 0xee,
+	0xcc, 0x4d, 0x36, 0x51, 0x08, 0x91, 0x73, 0x6d, 0xfb, 0x81, 0xcd, 0x3a, 0xc3, 0x92, 0xe6, 0x1f,
+	0x8b, 0xa2, 0x22, 0xa5, 0xa0, 0xf1, 0x1b, 0xc7, 0x94, 0xb1, 0x09, 0x7f, 0xed, 0x46, 0x76, 0xc6,
+	0x91, 0x68, 0x73, 0xb6, 0xac, 0xd2, 0x2d, 0x41, 0xe2, 0xef, 0x22, 0x07, 0x53, 0x61, 0x02, 0x03,
+	0x01, 0x00, 0x01, 0xa3, 0x5d, 0x30, 0x5b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x04, 0x02,
+	0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02,
+	0x07, 0x80, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x9c, 0x00, 0x97,
+	0xf8, 0xcb, 0x44, 0x29, 0x89, 0x98, 0x1d, 0x4d, 0xb4, 0xff, 0xab, 0xe1, 0xdd, 0x1e, 0x37, 0x30,
+	0xa4, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x61, 0x92,
+	0xad, 0x62, 0x26, 0xea, 0xc7, 0xaa, 0x3d, 0x86, 0x39, 0x4e, 0xb1, 0x60, 0x99, 0x89, 0xb2, 0x7c,
+	0xc7, 0x7e, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05,
+	0x00, 0x03, 0x81, 0x81, 0x00, 0x71, 0x1f, 0x5b, 0xac, 0x14, 0xd6, 0xdc, 0xce, 0xa1, 0xa3, 0xed,
+	0x30, 0x01, 0x5a, 0xa9, 0xbb, 0x48, 0x8b, 0xba, 0xb2, 0x49, 0x74, 0x42, 0x32, 0xeb, 0x44, 0xdf,
+	0xa8, 0xc4, 0x26, 0xbc, 0x9f, 0xdf, 0x47, 0xd2, 0x17, 0xc5, 0x25, 0x97, 0x97, 0x8a, 0x8d, 0xa4,
+	0x10, 0x7e, 0x57, 0xed, 0x3d, 0x5f, 0xc1, 0x0b, 0x92, 0xc0, 0x2b, 0x6e, 0xcb, 0x9a, 0xe0, 0xf1,
+	0xed, 0x3f, 0xbb, 0xb9, 0x61, 0x46, 0x56, 0x42, 0xbe, 0x80, 0xbf, 0xd9, 0xe6, 0x61, 0x24, 0xe0,
+	0x17, 0xa4, 0xf9, 0xd3, 0xe1, 0x2c, 0xd6, 0x0e, 0x3b, 0xe1, 0xed, 0x99, 0x20, 0x4b, 0xc2, 0xb0,
+	0x60, 0x6d, 0x7e, 0xd3, 0x94, 0x1f, 0xb9, 0xe8, 0xd8, 0x06, 0xef, 0xbc, 0x87, 0xee, 0x84, 0xe0,
+	0x28, 0x8d, 0xfe, 0xd9, 0xd3, 0x4b, 0xee, 0x97, 0x50, 0xa3, 0x0c, 0xb7, 0xfa, 0xf0, 0x6e, 0xac,
+	0xd1, 0xca, 0x3d, 0xbc, 0x75
+};
+
+constexpr std::string_view x509_test_root_certificate_pem =
+	"-----BEGIN CERTIFICATE-----\n"
+	"MIIB4jCCAUugAwIBAgIBATANBgkqhkiG9w0BAQsFADAUMRIwEAYDVQQDDAlUZXN0\n"
+	"IFJvb3QwIBcNMjYxMDE5MDI1ODQwWhgPMjA1NDAzMDYwMjU4NDBaMBQxEjAQBgNV\n"
+	"BAMMCVRlc3QgUm9vdDCBnzANBgkqhkiG9w0BAQEFAAOBjQAwgYkCgYEAyc+jLib8\n"
+	"Ow/LMbf4i/xN2tCU3ooi4Hk0EnkyQPTtv8tS/MQvUSiHDaftKlK7lbBtpbTcvSnE\n"
+	"g+JMa6/HFAIHTPDd5LqxlCN9NQFOv95gyyRMomq4fKFetZYor35S7TCRtUEOPl7i\n"
+	"JieMncZUBG9EF6AAg/9SAcK3GBHq21iSkrsCAwEAAaNCMEAwDwYDVR0TAQH/BAUw\n"
+	"AwEB/zAOBgNVHQ8BAf8EBAMCAQYwHQYDVR0OBBYEFMoOg69+fdJQ9nEp24W1HbE0\n"
+	"3oKaMA0GCSqGSIb3DQEBCwUAA4GBADOj99Uof4CLrHrZY36aegSWAXYwc6d2U4dh\n"
+	"bKXI7pgPZOHMgEBC8ICpXVox264L28DJnbUBcdy59D8ABbT/9C4TNqq2qFgH+z2v\n"
+	"+GIWcjt+/IygQ6gLdeeI9F0n2yva1gV1nKNUkTuAF+C9ngiSMmOsM3U/ldLXmvCT\n"
+	"CNaNzXdd\n"
+	"-----END CERTIFICATE-----\n";
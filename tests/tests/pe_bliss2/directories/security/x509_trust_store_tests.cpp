@@ -0,0 +1,191 @@
+#include "pe_bliss2/security/x509/x509_trust_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "pe_bliss2/error_list.h"
+#include "pe_bliss2/security/byte_range_types.h"
+#include "pe_bliss2/security/x509/x509_certificate_store.h"
+#include "pe_bliss2/security/x509/x509_chain_builder.h"
+#include "pe_bliss2/security/x509/x509_der_certificate.h"
+
+#include "tests/pe_bliss2/directories/security/x509_test_certificates.h"
+
+using namespace pe_bliss::security;
+using namespace pe_bliss::security::x509;
+
+namespace
+{
+template<typename Array>
+span_range_type as_range(const Array& data) noexcept
+{
+	return std::as_bytes(std::span(data));
+}
+
+constexpr std::string_view invalid_pem_certificate =
+	"-----BEGIN CERTIFICATE-----\nAAAA\n-----END CERTIFICATE-----\n";
+
+std::string create_bundle()
+{
+	std::string bundle(invalid_pem_certificate);
+	bundle += x509_test_root_certificate_pem;
+	bundle += x509_test_root_certificate_pem;
+	return bundle;
+}
+
+class X509TrustStoreChainTests : public testing::Test
+{
+public:
+	X509TrustStoreChainTests()
+	{
+		trust_store.add_certificates(as_range(x509_test_root_certificate));
+		intermediates.add_certificate(x509_der_certificate(
+			as_range(x509_test_intermediate_certificate)));
+		intermediates.add_certificate(x509_der_certificate(
+			as_range(x509_test_leaf_certificate)));
+		intermediates.add_certificate(x509_der_certificate(
+			as_range(x509_test_leaf_child_certificate)));
+		options.validation_time = std::chrono::sys_days(
+			std::chrono::year(2027) / std::chrono::January / 1);
+	}
+
+	const x509_der_certificate& get_certificate(std::uint8_t serial_number) const
+	{
+		for (const auto& cert : intermediates.get_certificates())
+		{
+			if (cert.get_serial_number().size() == 1u
+				&& cert.get_serial_number()[0] == std::byte{ serial_number })
+			{
+				return cert;
+			}
+		}
+		throw std::runtime_error("Certificate not found");
+	}
+
+public:
+	x509_trust_store trust_store;
+	x509_certificate_store<x509_der_certificate> intermediates;
+	x509_chain_options options;
+};
+} //namespace
+
+TEST(X509TrustStoreTests, AddDerCertificate)
+{
+	x509_trust_store store;
+	pe_bliss::error_list warnings;
+	EXPECT_EQ(store.add_certificates(as_range(x509_test_root_certificate), &warnings), 1u);
+	EXPECT_FALSE(warnings.has_errors());
+	EXPECT_EQ(store.get_store().size(), 1u);
+
+	EXPECT_EQ(store.add_certificates(as_range(x509_test_root_certificate), &warnings), 0u);
+	EXPECT_TRUE(warnings.has_error(x509_trust_store_errc::duplicate_certificate, 0u));
+	EXPECT_EQ(store.get_store().size(), 1u);
+}
+
+TEST(X509TrustStoreTests, AddPemBundle)
+{
+	x509_trust_store store;
+	pe_bliss::error_list warnings;
+	const auto bundle = create_bundle();
+	EXPECT_EQ(store.add_certificates(std::as_bytes(std::span(bundle)), &warnings), 1u);
+	EXPECT_EQ(store.get_store().size(), 1u);
+	ASSERT_EQ(warnings.get_errors()->size(), 2u);
+	EXPECT_TRUE(warnings.has_error(x509_der_certificate_errc::invalid_certificate, 0u));
+	EXPECT_TRUE(warnings.has_error(x509_trust_store_errc::duplicate_certificate, 2u));
+
+	//Certificate end marker is absent
+	warnings.clear_errors();
+	const std::string truncated(x509_test_root_certificate_pem.substr(0u, 40u));
+	EXPECT_EQ(store.add_certificates(std::as_bytes(std::span(truncated)), &warnings), 0u);
+	EXPECT_TRUE(warnings.has_error(x509_trust_store_errc::invalid_certificate, 0u));
+}
+
+TEST(X509TrustStoreTests, LoadDirectory)
+{
+	const auto directory = std::filesystem::temp_directory_path()
+		/ "pe_bliss_x509_trust_store_tests";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	{
+		std::ofstream(directory / "root.cer", std::ios::binary).write(
+			reinterpret_cast<const char*>(x509_test_root_certificate.data()),
+			x509_test_root_certificate.size());
+		std::ofstream(directory / "bundle.pem", std::ios::binary) << create_bundle();
+		std::ofstream(directory / "readme.txt", std::ios::binary) << "text";
+	}
+
+	x509_trust_store store;
+	pe_bliss::error_list warnings;
+	store.load_directory(directory, &warnings);
+	std::filesystem::remove_all(directory);
+
+	EXPECT_EQ(store.get_store().size(), 1u);
+	EXPECT_TRUE(warnings.has_error(
+		x509_der_certificate_errc::invalid_certificate, "bundle.pem#0"));
+	EXPECT_TRUE(warnings.has_error(
+		x509_trust_store_errc::duplicate_certificate, "bundle.pem#2"));
+	//Either the root.cer or the second bundle.pem root is a duplicate,
+	//depending on the directory iteration order
+	EXPECT_EQ(warnings.get_errors()->size(), 3u);
+}
+
+TEST_F(X509TrustStoreChainTests, ValidChain)
+{
+	const auto& leaf = get_certificate(3u);
+	for (int i = 0; i != 2; ++i)
+	{
+		const auto chain = build_certificate_chain(leaf, intermediates, trust_store, options);
+		EXPECT_TRUE(chain.is_trusted());
+		ASSERT_EQ(chain.certificates.size(), 2u);
+		EXPECT_EQ(chain.certificates[0], &leaf);
+		EXPECT_EQ(chain.certificates[1], &get_certificate(2u));
+		EXPECT_EQ(chain.root, &*trust_store.get_store().get_certificates().begin());
+	}
+	EXPECT_EQ(trust_store.get_verification_cache().get_statistics().result_hits, 2u);
+}
+
+TEST_F(X509TrustStoreChainTests, Expired)
+{
+	options.validation_time = std::chrono::sys_days(
+		std::chrono::year(2030) / std::chrono::January / 1);
+	const auto chain = build_certificate_chain(get_certificate(3u),
+		intermediates, trust_store, options);
+	EXPECT_FALSE(chain.is_trusted());
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::certificate_expired, 0u));
+	EXPECT_EQ(chain.errors.get_errors()->size(), 1u);
+}
+
+TEST_F(X509TrustStoreChainTests, LeafAsIssuer)
+{
+	const auto chain = build_certificate_chain(get_certificate(4u),
+		intermediates, trust_store, options);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 1u);
+	EXPECT_EQ(chain.root, nullptr);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::issuer_is_not_ca, 0u));
+	EXPECT_EQ(chain.errors.get_errors()->size(), 1u);
+}
+
+TEST_F(X509TrustStoreChainTests, InvalidSignature)
+{
+	std::vector<std::byte> leaf_data(x509_test_leaf_certificate.size());
+	std::ranges::copy(as_range(x509_test_leaf_certificate), leaf_data.begin());
+	leaf_data.back() ^= std::byte{ 1u };
+	const x509_der_certificate leaf(leaf_data);
+
+	const auto chain = build_certificate_chain(leaf, intermediates, trust_store, options);
+	EXPECT_FALSE(chain.is_trusted());
+	ASSERT_EQ(chain.certificates.size(), 2u);
+	EXPECT_TRUE(chain.errors.has_error(x509_chain_errc::invalid_certificate_signature, 0u));
+}
@@ -3,11 +3,14 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <sstream>
 #include <tuple>
 
 #include "gtest/gtest.h"
 
+#include "buffers/input_stream_buffer.h"
 #include "pe_bliss2/core/data_directories.h"
 #include "pe_bliss2/image/image.h"
 #include "tests/pe_bliss2/pe_error_helper.h"
@@ -115,6 +118,38 @@ TEST(SecurityDirectoryLoaderTests, ValidCopyData)
 	validate_security_directory(dir, true);
 }
 
+namespace
+{
+pe_bliss::image::image create_stream_image()
+{
+	auto stream = std::make_shared<std::stringstream>();
+	stream->write(reinterpret_cast<const char*>(directory.data()), directory.size());
+	auto buffer = std::make_shared<buffers::input_stream_buffer>(stream);
+	buffer->set_absolute_offset(1024u);
+
+	auto result = create_image(std::array<std::byte, 0>{},
+		static_cast<std::uint32_t>(directory.size()));
+	result.get_overlay().get_buffer().deserialize(buffer, false);
+	return result;
+}
+} //namespace
+
+TEST(SecurityDirectoryLoaderTests, ValidNonContiguous)
+{
+	auto dir = load(create_stream_image());
+	validate_security_directory(dir, true);
+}
+
+TEST(SecurityDirectoryLoaderTests, ValidNonContiguousNoCopy)
+{
+	auto dir = load(create_stream_image(), { .copy_non_contiguous_raw_data = false });
+	ASSERT_TRUE(dir);
+	expect_contains_errors(*dir);
+	ASSERT_EQ(dir->get_entries().size(), 2u);
+	EXPECT_FALSE(dir->get_entries()[0].get_certificate().is_copied());
+	EXPECT_FALSE(dir->get_entries()[1].get_certificate().is_copied());
+}
+
 TEST(SecurityDirectoryLoaderTests, ValidLimit)
 {
 	auto dir = load(create_image(directory), { .max_entries = 1u });
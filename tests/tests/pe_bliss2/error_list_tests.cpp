@@ -1,13 +1,20 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <array>
+#include <cstddef>
 #include <exception>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 #include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 
 #include "pe_bliss2/error_list.h"
+#include "utilities/scoped_guard.h"
 
 using namespace ::testing;
 
@@ -95,3 +102,132 @@ TEST(ErrorListTests, ErrorListTest3)
 		EXPECT_EQ(std::string(e.what()), "test");
 	}
 }
+
+TEST(ErrorListTests, ErrorListStringContext)
+{
+	pe_bliss::error_list errors;
+	{
+		std::string context("context");
+		errors.add_error(std::make_error_code(std::errc::timed_out), context);
+		context = "other";
+	}
+
+	EXPECT_TRUE(errors.has_error(std::errc::timed_out, "context"));
+	EXPECT_FALSE(errors.has_error(std::errc::timed_out, "other"));
+	const auto* context = std::get_if<std::string>(
+		&errors.get_errors()->begin()->first.context);
+	ASSERT_NE(context, nullptr);
+	EXPECT_EQ(*context, "context");
+}
+
+TEST(ErrorListTests, ErrorListDeduplication)
+{
+	pe_bliss::error_list errors;
+	errors.add_error(std::make_error_code(std::errc::timed_out), 1u);
+	errors.add_error(std::make_error_code(std::errc::timed_out));
+	errors.add_error(std::make_error_code(std::errc::timed_out), 1u);
+	errors.add_error(std::make_error_code(std::errc::timed_out), 2u);
+	ASSERT_THAT(*errors.get_errors(), UnorderedElementsAre(
+		Pair(pe_bliss::error_list::error_context{
+			std::make_error_code(std::errc::timed_out), 1u }, _),
+		Pair(pe_bliss::error_list::error_context{
+			std::make_error_code(std::errc::timed_out) }, _),
+		Pair(pe_bliss::error_list::error_context{
+			std::make_error_code(std::errc::timed_out), 2u }, _)));
+
+	EXPECT_TRUE(errors.has_error(std::errc::timed_out));
+	EXPECT_TRUE(errors.has_error(std::errc::timed_out, 2u));
+	EXPECT_FALSE(errors.has_error(std::errc::timed_out, 3u));
+}
+
+TEST(ErrorListTests, ErrorListManyErrors)
+{
+	static constexpr std::size_t count = 1000u;
+	pe_bliss::error_list errors;
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		errors.add_error(std::make_error_code(std::errc::timed_out), i);
+		errors.add_error(std::make_error_code(std::errc::timed_out), i / 2u);
+		errors.add_error(std::make_error_code(std::errc::io_error),
+			std::to_string(i % 10u));
+	}
+	errors.add_error(std::make_error_code(std::errc::timed_out));
+	errors.add_error(std::make_error_code(std::errc::timed_out));
+
+	ASSERT_EQ(errors.get_errors()->size(), count + 10u + 1u);
+	EXPECT_TRUE(errors.has_error(std::errc::timed_out));
+	EXPECT_TRUE(errors.has_error(std::errc::timed_out, count - 1u));
+	EXPECT_FALSE(errors.has_error(std::errc::timed_out, count));
+	EXPECT_TRUE(errors.has_error(std::errc::io_error, "9"));
+	EXPECT_FALSE(errors.has_error(std::errc::io_error, "10"));
+	EXPECT_FALSE(errors.has_error(std::errc::io_error));
+
+	auto copy = errors;
+	copy.add_error(std::make_error_code(std::errc::timed_out), 1u);
+	copy.add_error(std::make_error_code(std::errc::timed_out), count);
+	EXPECT_EQ(copy.get_errors()->size(), count + 10u + 2u);
+	EXPECT_FALSE(errors.has_error(std::errc::timed_out, count));
+
+	copy.clear_errors();
+	EXPECT_FALSE(copy.has_errors());
+	copy.add_error(std::make_error_code(std::errc::timed_out), 1u);
+	EXPECT_TRUE(copy.has_error(std::errc::timed_out, 1u));
+}
+
+TEST(ErrorListTests, ErrorListMapType)
+{
+	static_assert(std::is_same_v<pe_bliss::error_list::error_map_type,
+		std::unordered_map<pe_bliss::error_list::error_context,
+			pe_bliss::error_list::error_info,
+			pe_bliss::error_list::error_context_hash>>);
+
+	pe_bliss::error_list errors;
+	EXPECT_EQ(errors.get_errors(), nullptr);
+	errors.add_error(std::make_error_code(std::errc::timed_out), 1u);
+	const auto* map = errors.get_errors();
+	ASSERT_NE(map, nullptr);
+	EXPECT_EQ(errors.get_errors(), map);
+	EXPECT_EQ(map->size(), 1u);
+
+	errors.add_error(std::make_error_code(std::errc::timed_out), 2u);
+	ASSERT_THAT(*errors.get_errors(), UnorderedElementsAre(
+		Pair(pe_bliss::error_list::error_context{
+			std::make_error_code(std::errc::timed_out), 1u }, _),
+		Pair(pe_bliss::error_list::error_context{
+			std::make_error_code(std::errc::timed_out), 2u }, _)));
+
+	auto moved = std::move(errors);
+	EXPECT_FALSE(errors.has_errors());
+	EXPECT_EQ(errors.get_errors(), nullptr);
+	ASSERT_NE(moved.get_errors(), nullptr);
+	EXPECT_EQ(moved.get_errors()->size(), 2u);
+
+	moved.clear_errors();
+	EXPECT_EQ(moved.get_errors(), nullptr);
+}
+
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+TEST(ErrorListTests, ErrorListMemoryResource)
+{
+	static constexpr std::size_t count = 100u;
+	std::array<std::byte, 0x10000u> buffer{};
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+		std::pmr::null_memory_resource());
+	//Errors and their index must not be allocated from the default resource
+	auto* default_resource = std::pmr::set_default_resource(
+		std::pmr::null_memory_resource());
+	utilities::scoped_guard restore([default_resource] {
+		std::pmr::set_default_resource(default_resource); });
+
+	pe_bliss::error_list errors;
+	errors.use_error_memory_resource(&arena);
+	for (std::size_t i = 0; i != count; ++i)
+		errors.add_error(std::make_error_code(std::errc::timed_out), i);
+	errors.add_error(std::make_error_code(std::errc::timed_out), 0u);
+
+	EXPECT_TRUE(errors.has_error(std::errc::timed_out, count - 1u));
+	EXPECT_FALSE(errors.has_error(std::errc::timed_out, count));
+	ASSERT_NE(errors.get_errors(), nullptr);
+	EXPECT_EQ(errors.get_errors()->size(), count);
+}
+#endif //PE_BLISS_ENABLE_PMR_LISTS
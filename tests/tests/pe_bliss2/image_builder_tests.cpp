@@ -1,11 +1,14 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <span>
+#include <vector>
 
 #include "buffers/output_memory_buffer.h"
+#include "buffers/output_memory_ref_buffer.h"
 
 #include "pe_bliss2/core/data_directories.h"
 #include "pe_bliss2/core/image_signature.h"
@@ -130,6 +133,7 @@ TEST_P(ImageBuilderTestsFixture, BuildNoSections)
 {
 	EXPECT_NO_THROW(image::image_builder::build(instance, buf));
 	ASSERT_EQ(get_data_span().size(), full_headers_length);
+	EXPECT_EQ(image::image_builder::get_built_size(instance), full_headers_length);
 	validate_pe_headers();
 }
 
@@ -146,6 +150,7 @@ TEST_P(ImageBuilderTestsFixture, BuildOverlappingELfanew)
 		+ core::file_header::descriptor_type::packed_size
 		+ instance.get_optional_header().get_size_of_structure()
 		+ core::data_directories::directory_packed_size * number_of_data_directories);
+	EXPECT_EQ(image::image_builder::get_built_size(instance), data_span.size());
 
 	EXPECT_EQ(data_span[0], std::byte{ 'M' });
 	EXPECT_EQ(data_span[1], std::byte{ 'Z' });
@@ -168,6 +173,7 @@ TEST_P(ImageBuilderTestsFixture, BuildNoSectionsWithFullHeadersData)
 
 	auto data_span = get_data_span();
 	ASSERT_EQ(data_span.size(), full_headers_length + extra_full_headers_length);
+	EXPECT_EQ(image::image_builder::get_built_size(instance), data_span.size());
 
 	EXPECT_EQ(data_span[full_headers_length], first_extra_headers_byte);
 }
@@ -206,8 +212,15 @@ TEST_P(ImageBuilderTestsFixture, BuildWithSections)
 
 	auto data_span = get_data_span();
 	ASSERT_EQ(data_span.size(), header2->pointer_to_raw_data + data2.size());
+	EXPECT_EQ(image::image_builder::get_built_size(instance), data_span.size());
 	auto offset = validate_pe_headers();
 
+	//Reused buffer gaps are zeroed
+	std::vector<std::byte> reused(data_span.size(), std::byte{ 0xffu });
+	buffers::output_memory_ref_buffer reused_buf(reused.data(), reused.size());
+	EXPECT_NO_THROW(image::image_builder::build(instance, reused_buf));
+	EXPECT_TRUE(std::equal(reused.begin(), reused.end(), data_span.begin()));
+
 	EXPECT_EQ(data_span[offset], std::byte{ section1_first_name_char });
 	offset += section::section_header::descriptor_type::packed_size;
 	EXPECT_EQ(data_span[offset], std::byte{ section2_first_name_char });
@@ -237,6 +250,7 @@ TEST_P(ImageBuilderTestsFixture, BuildWithOptionalHeaderGap)
 	auto data_span = get_data_span();
 	ASSERT_EQ(data_span.size(), full_headers_length + optional_header_gap
 		+ section::section_header::descriptor_type::packed_size);
+	EXPECT_EQ(image::image_builder::get_built_size(instance), data_span.size());
 	validate_pe_headers();
 
 	EXPECT_EQ(data_span[full_headers_length], first_extra_headers_byte);
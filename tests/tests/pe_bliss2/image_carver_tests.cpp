@@ -0,0 +1,176 @@
+#include "pe_bliss2/image/image_carver.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/input_buffer_section.h"
+#include "buffers/input_container_buffer.h"
+#include "buffers/input_stream_buffer.h"
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_builder.h"
+#include "pe_bliss2/image/image_loader.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+
+using namespace pe_bliss;
+
+namespace
+{
+class ImageCarverTestFixture : public ::testing::TestWithParam<bool>
+{
+public:
+	ImageCarverTestFixture()
+	{
+		std::vector<std::byte> pe32, pe64;
+		buffers::output_memory_buffer pe32_buf(pe32);
+		image::image_builder::build(create_test_image({}), pe32_buf);
+		buffers::output_memory_buffer pe64_buf(pe64);
+		image::image_builder::build(create_test_image({ .is_x64 = true }), pe64_buf);
+		pe32_size = pe32.size();
+		pe64_size = pe64.size();
+
+		data.resize(pe64_offset + pe64_size + 0x100u, std::byte{ 0xccu });
+		//False candidates
+		for (auto offset : { 0x10u, 0x7feu, 0x8000u })
+		{
+			data[offset] = std::byte{ 'M' };
+			data[offset + 1u] = std::byte{ 'Z' };
+		}
+		std::copy(pe32.begin(), pe32.end(), data.begin() + pe32_offset);
+		std::copy(pe64.begin(), pe64.end(), data.begin() + pe64_offset);
+
+		if (GetParam())
+		{
+			buffer = std::make_shared<buffers::input_stream_buffer>(
+				std::make_shared<std::istringstream>(std::string(
+					reinterpret_cast<const char*>(data.data()), data.size())));
+		}
+		else
+		{
+			auto container = std::make_shared<buffers::input_container_buffer>();
+			container->get_container() = data;
+			buffer = container;
+		}
+	}
+
+public:
+	//Signature crosses the boundary of the first chunk
+	static constexpr std::size_t pe32_offset = 0x7ffu;
+	static constexpr std::size_t pe64_offset = 0x9000u;
+	static constexpr image::carver_options options{ .chunk_size = 0x800u };
+	std::vector<std::byte> data;
+	std::size_t pe32_size{};
+	std::size_t pe64_size{};
+	buffers::input_buffer_ptr buffer;
+};
+} //namespace
+
+TEST_P(ImageCarverTestFixture, Scan)
+{
+	auto images = image::image_carver::scan(buffer, options);
+	ASSERT_EQ(images.size(), 2u);
+	EXPECT_EQ(images[0].offset, pe32_offset);
+	EXPECT_EQ(images[0].size, pe32_size);
+	EXPECT_EQ(images[0].format, image::detected_format::pe32);
+	EXPECT_EQ(images[1].offset, pe64_offset);
+	EXPECT_EQ(images[1].size, pe64_size);
+	EXPECT_EQ(images[1].format, image::detected_format::pe64);
+
+	for (const auto& carved : images)
+	{
+		auto loaded = image::image_loader::load(
+			buffers::reduce(buffer, carved.offset, carved.size));
+		EXPECT_TRUE(loaded);
+	}
+}
+
+TEST_P(ImageCarverTestFixture, ScanStop)
+{
+	std::size_t count{};
+	image::image_carver::scan(buffer, [&count](const image::carved_image&) {
+		++count;
+		return false;
+	}, options);
+	EXPECT_EQ(count, 1u);
+}
+
+TEST_P(ImageCarverTestFixture, ScanMaxELfanew)
+{
+	EXPECT_TRUE(image::image_carver::scan(buffer, { .max_e_lfanew = 0x40u }).empty());
+}
+
+TEST_P(ImageCarverTestFixture, ScanSkipFoundImages)
+{
+	//The second image is placed inside the first one
+	std::copy(data.begin() + pe64_offset, data.begin() + pe64_offset + 0x200u,
+		data.begin() + pe32_offset + 0x1000u);
+	auto container = std::make_shared<buffers::input_container_buffer>();
+	container->get_container() = data;
+
+	EXPECT_EQ(image::image_carver::scan(container, options).size(), 3u);
+	auto images = image::image_carver::scan(container, {
+		.chunk_size = 0x100u, .skip_found_images = true });
+	ASSERT_EQ(images.size(), 2u);
+	EXPECT_EQ(images[0].offset, pe32_offset);
+	EXPECT_EQ(images[1].offset, pe64_offset);
+}
+
+TEST(ImageCarverTests, ScanImageLoadedToMemory)
+{
+	auto instance = create_test_image({});
+	instance.update_image_size();
+	std::vector<std::byte> raw;
+	buffers::output_memory_buffer raw_buf(raw);
+	image::image_builder::build(instance, raw_buf);
+
+	//Convert the image to the in-memory layout
+	const auto size_of_image = instance.get_optional_header().get_raw_size_of_image();
+	const auto size_of_headers = instance.get_optional_header().get_raw_size_of_headers();
+	const auto section_alignment = instance.get_optional_header().get_raw_section_alignment();
+	std::vector<std::byte> memory(size_of_image);
+	std::copy_n(raw.begin(), size_of_headers, memory.begin());
+	for (const auto& header : instance.get_section_table().get_section_headers())
+	{
+		std::copy_n(raw.begin() + header.get_pointer_to_raw_data(),
+			header.get_raw_size(section_alignment), memory.begin() + header.get_rva());
+	}
+	ASSERT_GT(memory.size(), raw.size());
+
+	static constexpr std::size_t image_offset = 0x1000u;
+	auto container = std::make_shared<buffers::input_container_buffer>();
+	auto& data = container->get_container();
+	data.resize(image_offset * 2u + memory.size(), std::byte{ 0xccu });
+	std::copy(memory.begin(), memory.end(), data.begin() + image_offset);
+	//Image inside the in-memory image, which is skipped
+	std::copy(raw.begin(), raw.begin() + 0x200u, data.begin() + image_offset + 0x2000u);
+	//Image after the in-memory image
+	const auto second_offset = data.size() - image_offset;
+	std::copy(raw.begin(), raw.begin() + 0x200u, data.begin() + second_offset);
+
+	auto images = image::image_carver::scan(container, {
+		.chunk_size = 0x100u, .skip_found_images = true,
+		.image_loaded_to_memory = true });
+	ASSERT_EQ(images.size(), 2u);
+	EXPECT_EQ(images[0].offset, image_offset);
+	EXPECT_EQ(images[0].size, size_of_image);
+	EXPECT_EQ(images[1].offset, second_offset);
+
+	auto loaded = image::image_loader::load(
+		buffers::reduce(container, images[0].offset, images[0].size),
+		{ .image_loaded_to_memory = true });
+	EXPECT_TRUE(loaded);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+	ImageCarverTests,
+	ImageCarverTestFixture,
+	::testing::Values(
+		false, true
+	));
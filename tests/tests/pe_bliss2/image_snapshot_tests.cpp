@@ -0,0 +1,261 @@
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffers/input_container_buffer.h"
+#include "buffers/output_memory_buffer.h"
+#include "buffers/ref_buffer.h"
+
+#include "pe_bliss2/exports/export_directory.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/imports/import_directory.h"
+#include "pe_bliss2/resources/resource_directory.h"
+#include "pe_bliss2/snapshot/image_snapshot.h"
+#include "pe_bliss2/snapshot/image_snapshot_cache.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::snapshot;
+
+namespace
+{
+
+std::vector<std::byte> get_buffer_data(const buffers::ref_buffer& buf)
+{
+	auto data = buf.data();
+	std::vector<std::byte> result(data->size());
+	if (!result.empty())
+		data->read(0u, result.size(), result.data());
+	return result;
+}
+
+buffers::input_buffer_ptr to_input_buffer(const std::vector<std::byte>& data)
+{
+	auto result = std::make_shared<buffers::input_container_buffer>();
+	result->get_container() = data;
+	return result;
+}
+
+class ImageSnapshotTests : public ::testing::Test
+{
+public:
+	ImageSnapshotTests()
+	{
+		auto& instance = snapshot.image;
+		instance = create_test_image({});
+		instance.get_section_data_list()[0].copied_data()[1] = std::byte{ 0x12u };
+		instance.get_dos_stub().copied_data() = { std::byte{ 1 }, std::byte{ 2 } };
+		instance.get_overlay().copied_data() = { std::byte{ 3 } };
+
+		auto& exports = snapshot.exports.emplace();
+		exports.get_descriptor()->base = 5u;
+		exports.get_library_name().value() = "test.dll";
+		auto& exported = exports.get_export_list().emplace_back();
+		exported.set_rva_ordinal(3u);
+		exported.get_rva().get() = 0x1234u;
+		exported.get_forwarded_name().emplace().value() = "other.func";
+		exported.get_names().emplace_back().get_name().emplace().value() = "func";
+
+		auto& imports = snapshot.imports.emplace();
+		auto& library = imports.get_list().emplace<
+			imports::import_directory_details::imported_library64_list_type>()
+			.emplace_back();
+		library.get_library_name().value() = "kernel32.dll";
+		library.get_descriptor()->lookup_table = 0x3000u;
+		auto& hint_name = library.get_imports().emplace_back().get_import_info()
+			.emplace<2>();
+		hint_name.get_name().value() = "ExitProcess";
+		hint_name.get_hint().get() = 10u;
+		library.get_imports().emplace_back().get_import_info()
+			.emplace<1>().set_ordinal(15u);
+
+		auto& resources = snapshot.resources.emplace();
+		auto& named = resources.get_entries().emplace_back();
+		named.get_name_or_id().emplace<resources::resource_name_type>()
+			.value() = u"name";
+		auto& data = named.get_data_or_directory()
+			.emplace<resources::resource_data_entry_details>();
+		data.get_raw_data().copied_data() = { std::byte{ 5 }, std::byte{ 6 } };
+		auto& by_id = resources.get_entries().emplace_back();
+		by_id.get_name_or_id().emplace<resources::resource_id_type>(7u);
+		by_id.get_data_or_directory()
+			.emplace<resources::resource_directory_details>()
+			.get_entries().emplace_back()
+			.get_data_or_directory().emplace<rva_type>(0x20u);
+
+		content_hash[0] = std::byte{ 0xabu };
+	}
+
+	std::vector<std::byte> write(const snapshot_write_options& options = {})
+	{
+		std::vector<std::byte> result;
+		buffers::output_memory_buffer buf(result);
+		write_snapshot(snapshot, content_hash, buf, options);
+		return result;
+	}
+
+public:
+	image_snapshot snapshot;
+	content_hash_type content_hash{};
+};
+
+} //namespace
+
+TEST_F(ImageSnapshotTests, RoundTrip)
+{
+	auto loaded = load_snapshot(to_input_buffer(write()), content_hash);
+
+	const auto& instance = loaded.image;
+	EXPECT_EQ(instance.get_section_table().get_section_headers().size(), 3u);
+	ASSERT_EQ(instance.get_section_data_list().size(), 3u);
+	EXPECT_FALSE(instance.get_section_data_list()[0].is_copied());
+	EXPECT_EQ(get_buffer_data(instance.get_section_data_list()[0].get_buffer()),
+		get_buffer_data(snapshot.image.get_section_data_list()[0].get_buffer()));
+	EXPECT_EQ(instance.get_section_data_list()[2].virtual_size(),
+		snapshot.image.get_section_data_list()[2].virtual_size());
+	EXPECT_EQ(get_buffer_data(instance.get_dos_stub().get_buffer()),
+		get_buffer_data(snapshot.image.get_dos_stub().get_buffer()));
+	EXPECT_EQ(get_buffer_data(instance.get_overlay().get_buffer()),
+		get_buffer_data(snapshot.image.get_overlay().get_buffer()));
+	EXPECT_EQ(instance.get_optional_header().get_raw_image_base(),
+		snapshot.image.get_optional_header().get_raw_image_base());
+	EXPECT_EQ(instance.get_data_directories().get_directories().size(), 16u);
+
+	ASSERT_TRUE(loaded.exports);
+	EXPECT_EQ(loaded.exports->get_descriptor()->base, 5u);
+	EXPECT_EQ(loaded.exports->get_library_name().value(), "test.dll");
+	ASSERT_EQ(loaded.exports->get_export_list().size(), 1u);
+	const auto& exported = loaded.exports->get_export_list()[0];
+	EXPECT_EQ(exported.get_rva_ordinal(), 3u);
+	EXPECT_EQ(exported.get_rva().get(), 0x1234u);
+	ASSERT_TRUE(exported.get_forwarded_name());
+	EXPECT_EQ(exported.get_forwarded_name()->value(), "other.func");
+	ASSERT_EQ(exported.get_names().size(), 1u);
+	ASSERT_TRUE(exported.get_names()[0].get_name());
+	EXPECT_EQ(exported.get_names()[0].get_name()->value(), "func");
+
+	ASSERT_TRUE(loaded.imports);
+	const auto* libraries = std::get_if<
+		imports::import_directory_details::imported_library64_list_type>(
+			&loaded.imports->get_list());
+	ASSERT_NE(libraries, nullptr);
+	ASSERT_EQ(libraries->size(), 1u);
+	EXPECT_EQ((*libraries)[0].get_library_name().value(), "kernel32.dll");
+	EXPECT_EQ((*libraries)[0].get_descriptor()->lookup_table, 0x3000u);
+	ASSERT_EQ((*libraries)[0].get_imports().size(), 2u);
+	const auto& hint_name = std::get<2>(
+		(*libraries)[0].get_imports()[0].get_import_info());
+	EXPECT_EQ(hint_name.get_name().value(), "ExitProcess");
+	EXPECT_EQ(hint_name.get_hint().get(), 10u);
+	EXPECT_EQ(std::get<1>((*libraries)[0].get_imports()[1].get_import_info())
+		.get_ordinal(), 15u);
+
+	ASSERT_TRUE(loaded.resources);
+	const auto& entries = loaded.resources->get_entries();
+	ASSERT_EQ(entries.size(), 2u);
+	ASSERT_TRUE(entries[0].is_named());
+	EXPECT_EQ(entries[0].get_name().value(), u"name");
+	ASSERT_TRUE(entries[0].has_data());
+	EXPECT_EQ(get_buffer_data(entries[0].get_data().get_raw_data()),
+		(std::vector{ std::byte{ 5 }, std::byte{ 6 } }));
+	ASSERT_TRUE(entries[1].has_id());
+	EXPECT_EQ(entries[1].get_id(), 7u);
+	ASSERT_TRUE(entries[1].has_directory());
+	ASSERT_EQ(entries[1].get_directory().get_entries().size(), 1u);
+	EXPECT_EQ(std::get<rva_type>(entries[1].get_directory().get_entries()[0]
+		.get_data_or_directory()), 0x20u);
+}
+
+TEST_F(ImageSnapshotTests, SkipDirectoriesWithErrors)
+{
+	snapshot.exports->get_export_list()[0].get_names()[0].add_error(
+		image_snapshot_errc::directory_has_errors);
+	auto loaded = load_snapshot(to_input_buffer(write()), content_hash);
+	EXPECT_FALSE(loaded.exports);
+	EXPECT_TRUE(loaded.imports);
+	EXPECT_TRUE(loaded.resources);
+
+	loaded = load_snapshot(to_input_buffer(write({
+		.skip_directories_with_errors = false })), content_hash);
+	ASSERT_TRUE(loaded.exports);
+	EXPECT_FALSE(loaded.exports->get_export_list()[0].get_names()[0].has_errors());
+}
+
+TEST_F(ImageSnapshotTests, ContentHashMismatch)
+{
+	auto data = write();
+	content_hash[0] = std::byte{};
+	expect_throw_pe_error([&] {
+		(void)load_snapshot(to_input_buffer(data), content_hash);
+	}, image_snapshot_errc::content_hash_mismatch);
+}
+
+TEST_F(ImageSnapshotTests, SnapshotHashMismatch)
+{
+	auto data = write();
+	data.back() = ~data.back();
+	expect_throw_pe_error([&] {
+		(void)load_snapshot(to_input_buffer(data), content_hash);
+	}, image_snapshot_errc::snapshot_hash_mismatch);
+}
+
+TEST_F(ImageSnapshotTests, InvalidSignature)
+{
+	auto data = write();
+	data[0] = std::byte{};
+	expect_throw_pe_error([&] {
+		(void)load_snapshot(to_input_buffer(data), content_hash);
+	}, image_snapshot_errc::invalid_snapshot_signature);
+
+	expect_throw_pe_error([&] {
+		(void)load_snapshot(to_input_buffer({}), content_hash);
+	}, image_snapshot_errc::invalid_snapshot_signature);
+}
+
+TEST_F(ImageSnapshotTests, TruncatedSnapshot)
+{
+	auto data = write();
+	data.pop_back();
+	expect_throw_pe_error([&] {
+		(void)load_snapshot(to_input_buffer(data), content_hash,
+			{ .verify_snapshot_hash = false });
+	}, image_snapshot_errc::invalid_snapshot_data);
+}
+
+TEST(ImageSnapshotCacheTests, StoreAndLoad)
+{
+	auto directory = std::filesystem::temp_directory_path()
+		/ "pe_bliss_image_snapshot_cache_tests";
+	std::filesystem::remove_all(directory);
+
+	image_snapshot_cache cache(directory);
+	EXPECT_EQ(cache.get_directory(), directory);
+
+	std::vector<std::byte> file{ std::byte{ 1 }, std::byte{ 2 } };
+	buffers::input_container_buffer file_buffer;
+	file_buffer.get_container() = file;
+	auto content_hash = calculate_content_hash(file_buffer);
+
+	EXPECT_FALSE(cache.try_load(content_hash));
+
+	image_snapshot snapshot;
+	snapshot.image = create_test_image({});
+	ASSERT_NO_THROW(cache.store(snapshot, content_hash));
+	EXPECT_TRUE(std::filesystem::exists(cache.get_snapshot_path(content_hash)));
+
+	auto loaded = cache.try_load(content_hash);
+	ASSERT_TRUE(loaded);
+	EXPECT_EQ(loaded->image.get_section_data_list().size(), 3u);
+
+	content_hash[0] = ~content_hash[0];
+	EXPECT_FALSE(cache.try_load(content_hash));
+
+	std::filesystem::remove_all(directory);
+}
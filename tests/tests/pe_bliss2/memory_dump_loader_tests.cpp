@@ -0,0 +1,133 @@
+#include "pe_bliss2/image/memory_dump_loader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "buffers/input_memory_buffer.h"
+#include "buffers/output_memory_buffer.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/image_builder.h"
+#include "pe_bliss2/pe_error.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss;
+
+namespace
+{
+//Test image sections have equal RVAs and raw offsets,
+//so the built images are also laid out as in memory
+image::dump_module_list build_dump(std::vector<std::byte>& dump)
+{
+	buffers::output_memory_buffer buf(dump);
+	image::dump_module_list modules;
+	for (bool is_x64 : { false, true, false })
+	{
+		static constexpr std::uint32_t size_of_image = 0x7000u;
+		auto instance = create_test_image({ .is_x64 = is_x64 });
+		instance.get_optional_header().set_raw_size_of_image(size_of_image);
+		auto& module = modules.emplace_back();
+		module.offset = dump.size();
+		module.size = size_of_image;
+		image::image_builder::build(instance, buf);
+		dump.resize(module.offset + module.size);
+		buf.set_wpos(dump.size());
+	}
+	modules.push_back({ .offset = dump.size() - 0x10u, .size = 0x20u });
+	return modules;
+}
+
+void check_results(std::span<const image::image_load_result> results,
+	const image::dump_module_list& modules)
+{
+	ASSERT_EQ(results.size(), modules.size());
+	for (std::size_t i = 0; i != 3u; ++i)
+	{
+		ASSERT_TRUE(results[i]) << i;
+		EXPECT_EQ(results[i].image.is_64bit(), i == 1u);
+		EXPECT_TRUE(results[i].image.is_loaded_to_memory());
+		const auto& section = results[i].image.get_section_data_list()[0];
+		EXPECT_FALSE(section.is_copied());
+		EXPECT_EQ(section.data()->absolute_offset(), modules[i].offset + 0x1000u);
+	}
+
+	ASSERT_FALSE(results[3]);
+	try
+	{
+		std::rethrow_exception(results[3].fatal_error);
+	}
+	catch (const pe_error& e)
+	{
+		EXPECT_EQ(e.code(), image::memory_dump_loader_errc::module_is_out_of_dump_bounds);
+	}
+}
+} //namespace
+
+TEST(MemoryDumpLoaderTests, ParseModuleIndex)
+{
+	std::istringstream index("# offset size name\n"
+		"0x1000 0x2000 kernel32.dll\r\n"
+		"\n"
+		"  16384 4096 C:\\Program Files\\app.exe\n");
+	auto modules = image::memory_dump_loader::parse_module_index(index);
+	ASSERT_EQ(modules.size(), 2u);
+	EXPECT_EQ(modules[0].name, "kernel32.dll");
+	EXPECT_EQ(modules[0].offset, 0x1000u);
+	EXPECT_EQ(modules[0].size, 0x2000u);
+	EXPECT_EQ(modules[1].name, "C:\\Program Files\\app.exe");
+	EXPECT_EQ(modules[1].offset, 16384u);
+	EXPECT_EQ(modules[1].size, 4096u);
+
+	for (const char* invalid : { "0x1000\n", "abc 0x10 name\n", "0x10z 0x10 name\n" })
+	{
+		std::istringstream invalid_index(invalid);
+		expect_throw_pe_error([&invalid_index] {
+			(void)image::memory_dump_loader::parse_module_index(invalid_index);
+		}, image::memory_dump_loader_errc::invalid_module_index_entry);
+	}
+}
+
+TEST(MemoryDumpLoaderTests, Load)
+{
+	std::vector<std::byte> dump;
+	auto modules = build_dump(dump);
+	auto dump_buffer = std::make_shared<buffers::input_memory_buffer>(
+		dump.data(), dump.size());
+	auto results = image::memory_dump_loader::load(dump_buffer, modules,
+		{ .max_threads = 2u });
+	check_results(results, modules);
+}
+
+TEST(MemoryDumpLoaderTests, LoadFromFile)
+{
+	std::vector<std::byte> dump;
+	auto modules = build_dump(dump);
+	const auto path = std::filesystem::temp_directory_path()
+		/ "pe_bliss_memory_dump_loader_test.bin";
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(dump.data()), dump.size());
+	}
+
+	{
+		auto results = image::memory_dump_loader::load(path, modules,
+			{ .max_threads = 2u });
+		check_results(results, modules);
+	}
+
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+	EXPECT_THROW((void)image::memory_dump_loader::load(path, modules),
+		std::system_error);
+}
@@ -1,3 +1,4 @@
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -23,6 +24,21 @@ TEST(PackedReflectionTests, TypeSizeTest)
 	EXPECT_EQ(packed_reflection::get_type_size<simple>(), simple_size);
 	EXPECT_EQ(packed_reflection::get_type_size<arrays>(), arrays_size);
 	EXPECT_EQ(packed_reflection::get_type_size<nested>(), nested_size);
+	EXPECT_EQ(packed_reflection::get_type_size<padding_free>(), padding_free_size);
+}
+
+TEST(PackedReflectionTests, IsPaddingFreeTest)
+{
+	EXPECT_TRUE(packed_reflection::is_padding_free<std::uint32_t>());
+	EXPECT_TRUE((packed_reflection::is_padding_free<std::array<std::uint32_t, 3u>>()));
+	EXPECT_TRUE(packed_reflection::is_padding_free<padding_free>());
+	EXPECT_FALSE(packed_reflection::is_padding_free<simple>());
+	EXPECT_FALSE(packed_reflection::is_padding_free<arrays>());
+	EXPECT_FALSE(packed_reflection::is_padding_free<nested>());
+	EXPECT_FALSE((packed_reflection::is_padding_free<std::array<simple, 2u>>()));
+
+	struct empty {};
+	EXPECT_FALSE(packed_reflection::is_padding_free<empty>());
 }
 
 TEST(PackedReflectionTests, GetFieldOffsetTests)
@@ -160,7 +160,7 @@ void test_deserialization(std::string_view serialized,
 }
 
 using test_types = std::tuple<empty, std::uint8_t, std::uint16_t,
-	std::uint32_t, std::uint64_t, simple, nested_short>;
+	std::uint32_t, std::uint64_t, simple, nested_short, padding_free>;
 
 constexpr std::uint32_t simple_array[3]{
 	0x12345678u, 0xaabbccddu, 0xabcdef00u };
@@ -188,6 +188,13 @@ constexpr test_types serialized_values{
 			0x12u, 0x67890123u, 0x5566u, 0x778899aabbccddeeull
 		},
 		{ 0xffu, 0xeeu }
+	},
+	{
+		0x12345678u,
+		0xaabbu,
+		0xccddu,
+		{ 0x01u, 0x02u, 0x03u, 0x04u },
+		0x90abcdefu
 	}
 };
 
@@ -208,7 +215,8 @@ constexpr std::array serialized_representations{
 		"\xef" "\x45\x67\x89\x01" "\x11\x22" "\x44\x55\x66\x77\x88\x99\xaa\xbb"
 		"\xf1" "\x56\x78\x90\x12" "\x33\x44" "\x55\x66\x77\x88\x99\xaa\xbb\xcc"
 		"\x12" "\x67\x89\x01\x23" "\x55\x66" "\x77\x88\x99\xaa\xbb\xcc\xdd\xee"
-		"\xff" "\xee"sv
+		"\xff" "\xee"sv,
+	"\x12\x34\x56\x78" "\xaa\xbb" "\xcc\xdd" "\x01\x02\x03\x04" "\x90\xab\xcd\xef"sv
 };
 
 constexpr std::array serialized_representations_reversed{
@@ -226,7 +234,8 @@ constexpr std::array serialized_representations_reversed{
 		"\xef" "\x01\x89\x67\x45" "\x22\x11" "\xbb\xaa\x99\x88\x77\x66\x55\x44"
 		"\xf1" "\x12\x90\x78\x56" "\x44\x33" "\xcc\xbb\xaa\x99\x88\x77\x66\x55"
 		"\x12" "\x23\x01\x89\x67" "\x66\x55" "\xee\xdd\xcc\xbb\xaa\x99\x88\x77"
-		"\xff" "\xee"sv
+		"\xff" "\xee"sv,
+	"\x78\x56\x34\x12" "\xbb\xaa" "\xdd\xcc" "\x01\x02\x03\x04" "\xef\xcd\xab\x90"sv
 };
 
 constexpr auto simple_array_serialized_representation
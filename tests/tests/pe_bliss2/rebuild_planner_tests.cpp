@@ -0,0 +1,195 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include "pe_bliss2/bound_import/bound_import_directory_loader.h"
+#include "pe_bliss2/bound_import/bound_library.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/rebuild_planner.h"
+#include "pe_bliss2/relocations/base_relocation.h"
+#include "pe_bliss2/relocations/relocation_directory_loader.h"
+#include "pe_bliss2/relocations/relocation_entry.h"
+#include "pe_bliss2/section/section_header.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::image;
+
+namespace
+{
+class RebuildPlannerTestFixture : public ::testing::Test
+{
+public:
+	RebuildPlannerTestFixture()
+		: instance(create_test_image({}))
+	{
+		auto& block = relocs.emplace_back();
+		block.get_descriptor()->virtual_address = 0x1000u;
+		for (std::uint16_t address : { 0x10u, 0x20u, 0x30u })
+		{
+			auto& entry = block.get_relocations().emplace_back();
+			entry.set_type(relocations::relocation_type::highlow);
+			entry.set_address(address);
+		}
+
+		auto& library = bound_imports.emplace_back();
+		library.get_descriptor()->time_date_stamp = 0x12345678u;
+		library.get_descriptor()->number_of_module_forwarder_refs = 1u;
+		library.get_library_name().value() = "kernel32.dll";
+		auto& ref = library.get_references().emplace_back();
+		ref.get_descriptor()->time_date_stamp = 0xabcdef01u;
+		ref.get_library_name().value() = "ntdll.dll";
+	}
+
+	void check_loaded_directories()
+	{
+		auto loaded_relocs = relocations::load(instance);
+		ASSERT_TRUE(loaded_relocs);
+		EXPECT_FALSE(loaded_relocs->errors.has_errors());
+		ASSERT_EQ(loaded_relocs->relocations.size(), 1u);
+		const auto& loaded_block = loaded_relocs->relocations[0];
+		EXPECT_EQ(loaded_block.get_descriptor()->virtual_address, 0x1000u);
+		ASSERT_EQ(loaded_block.get_relocations().size(), 4u); //Alignment entry
+		EXPECT_EQ(loaded_block.get_relocations()[2].get_address(), 0x30u);
+		EXPECT_EQ(loaded_block.get_relocations()[2].get_type(),
+			relocations::relocation_type::highlow);
+
+		auto loaded_bound_imports = bound_import::load(instance);
+		ASSERT_TRUE(loaded_bound_imports);
+		ASSERT_EQ(loaded_bound_imports->size(), 1u);
+		const auto& library = (*loaded_bound_imports)[0];
+		EXPECT_FALSE(library.has_errors());
+		EXPECT_EQ(library.get_library_name().value(), "kernel32.dll");
+		EXPECT_EQ(library.get_descriptor()->time_date_stamp, 0x12345678u);
+		ASSERT_EQ(library.get_references().size(), 1u);
+		EXPECT_EQ(library.get_references()[0].get_library_name().value(), "ntdll.dll");
+	}
+
+public:
+	image::image instance;
+	relocations::base_relocation_list relocs;
+	bound_import::bound_library_list bound_imports;
+};
+} //namespace
+
+TEST_F(RebuildPlannerTestFixture, NewSection)
+{
+	rebuild_planner planner(instance);
+	planner.add(relocs).add(bound_imports);
+
+	const auto& plan = planner.plan({ .section_name = ".new" });
+	ASSERT_TRUE(planner.get_plan());
+	EXPECT_TRUE(plan.new_section);
+	EXPECT_EQ(plan.section_index, 3u);
+	EXPECT_EQ(plan.section_rva, 0x7000u);
+	EXPECT_EQ(plan.pointer_to_raw_data, 0x3000u);
+	EXPECT_EQ(plan.size_of_headers, 0x400u);
+	ASSERT_EQ(plan.entries.size(), 2u);
+	EXPECT_EQ(plan.entries[0].type, rebuild_directory_type::relocations);
+	EXPECT_EQ(plan.entries[0].rva, 0x7000u);
+	EXPECT_EQ(plan.entries[0].size, 16u);
+	EXPECT_EQ(plan.entries[1].type, rebuild_directory_type::bound_imports);
+	EXPECT_EQ(plan.entries[1].rva, 0x7010u);
+	EXPECT_EQ(plan.entries[1].size, 8u * 3u + sizeof("kernel32.dll") + sizeof("ntdll.dll"));
+	EXPECT_EQ(plan.section_virtual_size, 0x10u + plan.entries[1].size);
+	EXPECT_EQ(plan.section_raw_size, 0x200u);
+
+	//Image is not changed by planning
+	EXPECT_EQ(instance.get_section_table().get_section_headers().size(), 3u);
+
+	auto result = planner.build();
+	EXPECT_FALSE(planner.get_plan());
+	EXPECT_EQ(result.section_rva, 0x7000u);
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	ASSERT_EQ(headers.size(), 4u);
+	ASSERT_EQ(instance.get_section_data_list().size(), 4u);
+	EXPECT_EQ(instance.get_file_header().get_descriptor()->number_of_sections, 4u);
+	EXPECT_EQ(headers[3].get_name(), ".new");
+	EXPECT_EQ(headers[3].get_rva(), 0x7000u);
+	EXPECT_EQ(headers[3].get_pointer_to_raw_data(), 0x3000u);
+	EXPECT_EQ(headers[3].get_descriptor()->size_of_raw_data, 0x200u);
+	EXPECT_EQ(headers[3].get_descriptor()->virtual_size, result.section_virtual_size);
+	EXPECT_EQ(headers[3].get_characteristics(),
+		section::section_header::characteristics::mem_read
+		| section::section_header::characteristics::cnt_initialized_data);
+	EXPECT_EQ(instance.get_section_data_list()[3].size(), 0x200u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x8000u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_headers(), 0x400u);
+
+	const auto& dirs = instance.get_data_directories();
+	EXPECT_EQ(dirs.get_directory(core::data_directories::directory_type::basereloc)
+		->virtual_address, 0x7000u);
+	EXPECT_EQ(dirs.get_directory(core::data_directories::directory_type::basereloc)
+		->size, 16u);
+	EXPECT_EQ(dirs.get_directory(core::data_directories::directory_type::bound_import)
+		->virtual_address, 0x7010u);
+
+	check_loaded_directories();
+}
+
+TEST_F(RebuildPlannerTestFixture, ExistingSection)
+{
+	rebuild_planner planner(instance);
+	planner.add(bound_imports).add(relocs);
+
+	const auto& plan = planner.plan({ .section_index = 2u, .directory_alignment = 32u });
+	EXPECT_FALSE(plan.new_section);
+	EXPECT_EQ(plan.section_index, 2u);
+	EXPECT_EQ(plan.section_rva, 0x4000u);
+	EXPECT_EQ(plan.pointer_to_raw_data, 0x3000u);
+	ASSERT_EQ(plan.entries.size(), 2u);
+	EXPECT_EQ(plan.entries[0].type, rebuild_directory_type::bound_imports);
+	EXPECT_EQ(plan.entries[0].rva, 0x7000u);
+	EXPECT_EQ(plan.entries[1].type, rebuild_directory_type::relocations);
+	EXPECT_EQ(plan.entries[1].rva, 0x7040u);
+	EXPECT_EQ(plan.section_virtual_size, 0x3050u);
+	EXPECT_EQ(plan.section_raw_size, 0x3200u);
+
+	(void)planner.build();
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	ASSERT_EQ(headers.size(), 3u);
+	EXPECT_EQ(headers[2].get_pointer_to_raw_data(), 0x3000u);
+	EXPECT_EQ(headers[2].get_descriptor()->size_of_raw_data, 0x3200u);
+	EXPECT_EQ(headers[2].get_descriptor()->virtual_size, 0x3050u);
+	EXPECT_EQ(instance.get_section_data_list()[2].size(), 0x3200u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x8000u);
+
+	check_loaded_directories();
+}
+
+TEST_F(RebuildPlannerTestFixture, EmptyPlan)
+{
+	rebuild_planner planner(instance);
+	auto result = planner.build();
+	EXPECT_TRUE(result.entries.empty());
+	EXPECT_EQ(instance.get_section_table().get_section_headers().size(), 3u);
+}
+
+TEST_F(RebuildPlannerTestFixture, Errors)
+{
+	rebuild_planner planner(instance);
+	planner.add(relocs);
+	expect_throw_pe_error([&planner] {
+		(void)planner.plan({ .directory_alignment = 4u });
+	}, rebuild_planner_errc::invalid_directory_alignment);
+	expect_throw_pe_error([&planner] {
+		(void)planner.plan({ .directory_alignment = 24u });
+	}, rebuild_planner_errc::invalid_directory_alignment);
+	expect_throw_pe_error([&planner] {
+		(void)planner.plan({ .section_index = 3u });
+	}, rebuild_planner_errc::invalid_section_index);
+	expect_throw_pe_error([&planner] {
+		(void)planner.plan({ .section_index = 1u });
+	}, rebuild_planner_errc::section_is_not_last);
+
+	instance.get_section_table().get_section_headers()[0].set_pointer_to_raw_data(0x200u);
+	expect_throw_pe_error([&planner] {
+		(void)planner.plan();
+	}, rebuild_planner_errc::no_room_for_section_header);
+	EXPECT_FALSE(planner.get_plan());
+}
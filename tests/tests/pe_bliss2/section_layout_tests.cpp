@@ -0,0 +1,244 @@
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "buffers/input_container_buffer.h"
+#include "pe_bliss2/core/data_directories.h"
+#include "pe_bliss2/image/image.h"
+#include "pe_bliss2/image/section_layout.h"
+#include "pe_bliss2/section/section_data.h"
+#include "pe_bliss2/section/section_header.h"
+
+#include "tests/pe_bliss2/image_helper.h"
+#include "tests/pe_bliss2/pe_error_helper.h"
+
+using namespace pe_bliss;
+using namespace pe_bliss::image;
+
+namespace
+{
+class SectionLayoutTestFixture : public ::testing::Test
+{
+public:
+	SectionLayoutTestFixture()
+		: instance(create_test_image({}))
+	{
+		//Sections 0 and 1 reference the original image buffer
+		auto& sections = instance.get_section_data_list();
+		for (std::size_t i = 0; i != 2u; ++i)
+		{
+			auto buffer = std::make_shared<buffers::input_container_buffer>();
+			buffer->get_container().resize(sections[i].physical_size(),
+				static_cast<std::byte>(i + 1u));
+			sections[i].get_buffer().deserialize(buffer, false);
+		}
+
+		auto& dirs = instance.get_data_directories();
+		dirs.get_directory(core::data_directories::directory_type::exports).get()
+			= { .virtual_address = 0x1100u, .size = 0x10u };
+		dirs.get_directory(core::data_directories::directory_type::imports).get()
+			= { .virtual_address = 0x2100u, .size = 0x10u };
+		dirs.get_directory(core::data_directories::directory_type::resource).get()
+			= { .virtual_address = 0x4100u, .size = 0x10u };
+		dirs.get_directory(core::data_directories::directory_type::security).get()
+			= { .virtual_address = 0x3000u, .size = 0x10u };
+		instance.get_optional_header().set_raw_address_of_entry_point(0x2500u);
+	}
+
+	[[nodiscard]]
+	rva_type get_directory_rva(core::data_directories::directory_type type) const
+	{
+		return instance.get_data_directories().get_directory(type)->virtual_address;
+	}
+
+	void check_sections_not_copied() const
+	{
+		for (std::size_t i = 0; i != 2u; ++i)
+			EXPECT_FALSE(instance.get_section_data_list()[i].is_copied());
+	}
+
+	[[nodiscard]]
+	static section::section_data create_section_data(std::size_t size)
+	{
+		section::section_data data;
+		data.copied_data().resize(size);
+		return data;
+	}
+
+public:
+	image::image instance;
+};
+} //namespace
+
+TEST_F(SectionLayoutTestFixture, AddSection)
+{
+	section::section_header header;
+	header.set_name(".new");
+	auto& added = add_section(instance, header, create_section_data(0x1100u));
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	ASSERT_EQ(headers.size(), 4u);
+	ASSERT_EQ(instance.get_section_data_list().size(), 4u);
+	EXPECT_EQ(&added, &headers[3]);
+	EXPECT_EQ(added.get_name(), ".new");
+	EXPECT_EQ(added.get_rva(), 0x7000u);
+	EXPECT_EQ(added.get_pointer_to_raw_data(), 0x3000u);
+	EXPECT_EQ(added.get_descriptor()->size_of_raw_data, 0x1200u);
+	EXPECT_EQ(added.get_descriptor()->virtual_size, 0x1100u);
+	EXPECT_EQ(instance.get_file_header().get_descriptor()->number_of_sections, 4u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x9000u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_headers(), 0x400u);
+
+	//Existing sections are not moved
+	EXPECT_EQ(headers[0].get_pointer_to_raw_data(), 0x1000u);
+	EXPECT_EQ(headers[1].get_pointer_to_raw_data(), 0x2000u);
+	EXPECT_EQ(headers[2].get_rva(), 0x4000u);
+	check_sections_not_copied();
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(exports), 0x1100u);
+	EXPECT_EQ(get_directory_rva(imports), 0x2100u);
+	EXPECT_EQ(get_directory_rva(resource), 0x4100u);
+	EXPECT_EQ(get_directory_rva(security), 0x4200u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_address_of_entry_point(), 0x2500u);
+}
+
+TEST_F(SectionLayoutTestFixture, InsertSection)
+{
+	(void)insert_section(instance, 1u, {}, create_section_data(0x800u));
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	ASSERT_EQ(headers.size(), 4u);
+	EXPECT_EQ(headers[0].get_rva(), 0x1000u);
+	EXPECT_EQ(headers[0].get_pointer_to_raw_data(), 0x1000u);
+	EXPECT_EQ(headers[1].get_rva(), 0x2000u);
+	EXPECT_EQ(headers[1].get_pointer_to_raw_data(), 0x2000u);
+	EXPECT_EQ(headers[2].get_rva(), 0x3000u);
+	EXPECT_EQ(headers[2].get_pointer_to_raw_data(), 0x2800u);
+	EXPECT_EQ(headers[3].get_rva(), 0x5000u);
+	EXPECT_EQ(headers[3].get_descriptor()->pointer_to_raw_data, 0u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x8000u);
+	EXPECT_EQ(instance.get_section_data_list()[2].data()->size(), 0x1000u);
+	EXPECT_FALSE(instance.get_section_data_list()[0].is_copied());
+	EXPECT_FALSE(instance.get_section_data_list()[2].is_copied());
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(exports), 0x1100u);
+	EXPECT_EQ(get_directory_rva(imports), 0x3100u);
+	EXPECT_EQ(get_directory_rva(resource), 0x5100u);
+	EXPECT_EQ(get_directory_rva(security), 0x3800u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_address_of_entry_point(), 0x3500u);
+}
+
+TEST_F(SectionLayoutTestFixture, AddSectionMovesHeaders)
+{
+	instance.get_section_table().get_section_headers()[0].set_pointer_to_raw_data(0x300u);
+	(void)add_section(instance, {}, create_section_data(0x10u));
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	ASSERT_EQ(headers.size(), 4u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_headers(), 0x400u);
+	EXPECT_EQ(headers[0].get_rva(), 0x1000u);
+	EXPECT_EQ(headers[0].get_pointer_to_raw_data(), 0x400u);
+	EXPECT_EQ(headers[1].get_rva(), 0x2000u);
+	EXPECT_EQ(headers[1].get_pointer_to_raw_data(), 0x2000u);
+	EXPECT_EQ(headers[2].get_rva(), 0x4000u);
+	EXPECT_EQ(headers[3].get_rva(), 0x7000u);
+	EXPECT_EQ(headers[3].get_pointer_to_raw_data(), 0x3000u);
+	check_sections_not_copied();
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(exports), 0x1100u);
+	EXPECT_EQ(get_directory_rva(imports), 0x2100u);
+}
+
+TEST_F(SectionLayoutTestFixture, ResizeSection)
+{
+	resize_section(instance, 0u, 0x1800u, 0x1900u);
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	const auto& sections = instance.get_section_data_list();
+	EXPECT_EQ(headers[0].get_descriptor()->size_of_raw_data, 0x1800u);
+	EXPECT_EQ(headers[0].get_descriptor()->virtual_size, 0x1900u);
+	EXPECT_EQ(sections[0].physical_size(), 0x1800u);
+	EXPECT_EQ(sections[0].size(), 0x2000u);
+	EXPECT_EQ(headers[1].get_rva(), 0x3000u);
+	EXPECT_EQ(headers[1].get_pointer_to_raw_data(), 0x2800u);
+	EXPECT_FALSE(sections[1].is_copied());
+	EXPECT_EQ(headers[2].get_rva(), 0x5000u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x8000u);
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(imports), 0x3100u);
+	EXPECT_EQ(get_directory_rva(security), 0x3800u);
+}
+
+TEST_F(SectionLayoutTestFixture, ShrinkSection)
+{
+	resize_section(instance, 1u, 0x100u, 0x1000u);
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	const auto& sections = instance.get_section_data_list();
+	EXPECT_EQ(headers[1].get_descriptor()->size_of_raw_data, 0x200u);
+	EXPECT_EQ(sections[1].physical_size(), 0x100u);
+	EXPECT_EQ(sections[1].size(), 0x1000u);
+	check_sections_not_copied();
+	EXPECT_EQ(headers[2].get_rva(), 0x3000u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x6000u);
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(imports), 0x2100u);
+	EXPECT_EQ(get_directory_rva(resource), 0x3100u);
+	EXPECT_EQ(get_directory_rva(security), 0x2200u);
+}
+
+TEST_F(SectionLayoutTestFixture, RemoveSection)
+{
+	remove_section(instance, 1u);
+
+	const auto& headers = instance.get_section_table().get_section_headers();
+	ASSERT_EQ(headers.size(), 2u);
+	ASSERT_EQ(instance.get_section_data_list().size(), 2u);
+	EXPECT_EQ(instance.get_file_header().get_descriptor()->number_of_sections, 2u);
+	EXPECT_EQ(headers[1].get_rva(), 0x2000u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_size_of_image(), 0x5000u);
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(exports), 0x1100u);
+	EXPECT_EQ(get_directory_rva(imports), 0u);
+	EXPECT_EQ(instance.get_data_directories().get_directory(imports)->size, 0u);
+	EXPECT_EQ(get_directory_rva(resource), 0x2100u);
+	EXPECT_EQ(get_directory_rva(security), 0x2000u);
+}
+
+TEST_F(SectionLayoutTestFixture, KeepReferences)
+{
+	remove_section(instance, 1u, { .update_references = false });
+
+	using enum core::data_directories::directory_type;
+	EXPECT_EQ(get_directory_rva(imports), 0x2100u);
+	EXPECT_EQ(get_directory_rva(resource), 0x4100u);
+	EXPECT_EQ(instance.get_optional_header().get_raw_address_of_entry_point(), 0x2500u);
+}
+
+TEST_F(SectionLayoutTestFixture, Errors)
+{
+	expect_throw_pe_error([this] {
+		(void)insert_section(instance, 4u, {}, create_section_data(1u));
+	}, section_layout_errc::invalid_section_index);
+	expect_throw_pe_error([this] {
+		(void)add_section(instance, {}, {});
+	}, section_layout_errc::invalid_section_size);
+	expect_throw_pe_error([this] {
+		resize_section(instance, 3u, 1u, 1u);
+	}, section_layout_errc::invalid_section_index);
+	expect_throw_pe_error([this] {
+		resize_section(instance, 0u, 0u, 0u);
+	}, section_layout_errc::invalid_section_size);
+	expect_throw_pe_error([this] {
+		remove_section(instance, 3u);
+	}, section_layout_errc::invalid_section_index);
+	EXPECT_EQ(instance.get_section_table().get_section_headers().size(), 3u);
+}
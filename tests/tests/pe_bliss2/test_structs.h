@@ -23,6 +23,17 @@ struct arrays
 	friend auto operator<=>(const arrays&, const arrays&) = default;
 };
 
+constexpr std::size_t padding_free_size = 16u;
+struct padding_free
+{
+	std::uint32_t a;
+	std::uint16_t b;
+	std::uint16_t c;
+	std::array<std::uint8_t, 4> d;
+	std::uint32_t e;
+	friend auto operator<=>(const padding_free&, const padding_free&) = default;
+};
+
 constexpr std::size_t nested_size
 = simple_size * 11u + arrays_size + 15u;
 struct nested
@@ -0,0 +1,110 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utilities/list_allocator.h"
+
+using namespace utilities;
+
+namespace
+{
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+	std::size_t allocations = 0;
+	std::size_t deallocations = 0;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+	{
+		++deallocations;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+} //namespace
+
+TEST(ListAllocatorTests, DefaultAllocator)
+{
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+	EXPECT_TRUE((std::is_same_v<list_allocator<int>,
+		std::pmr::polymorphic_allocator<int>>));
+#else //PE_BLISS_ENABLE_PMR_LISTS
+	EXPECT_TRUE((std::is_same_v<list_allocator<int>, std::allocator<int>>));
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+}
+
+TEST(ListAllocatorTests, UseMemoryResourceStdAllocator)
+{
+	counting_resource resource;
+	std::vector<std::uint32_t> vec;
+	use_memory_resource(vec, &resource);
+	vec.resize(10u);
+	EXPECT_EQ(resource.allocations, 0u);
+}
+
+TEST(ListAllocatorTests, UseMemoryResource)
+{
+	counting_resource resource;
+	{
+		std::pmr::vector<std::uint32_t> vec;
+		use_memory_resource(vec, &resource);
+		EXPECT_EQ(vec.get_allocator().resource(), &resource);
+		vec.resize(10u);
+		EXPECT_EQ(resource.allocations, 1u);
+	}
+	EXPECT_EQ(resource.deallocations, 1u);
+}
+
+TEST(ListAllocatorTests, UseNullMemoryResource)
+{
+	counting_resource resource;
+	std::pmr::vector<std::uint32_t> vec(&resource);
+	use_memory_resource(vec, nullptr);
+	EXPECT_EQ(vec.get_allocator().resource(), &resource);
+}
+
+TEST(ListAllocatorTests, NestedListsInArena)
+{
+	counting_resource upstream;
+	{
+		std::pmr::monotonic_buffer_resource arena(&upstream);
+		std::pmr::vector<std::pmr::vector<char>> vec;
+		use_memory_resource(vec, &arena);
+		for (std::size_t i = 0; i != 100u; ++i)
+			vec.emplace_back(i + 1u, 'a');
+		EXPECT_EQ(vec.back().get_allocator().resource(), &arena);
+		EXPECT_LT(upstream.allocations, 100u);
+		EXPECT_EQ(upstream.deallocations, 0u);
+	}
+	EXPECT_EQ(upstream.deallocations, upstream.allocations);
+}
+
+TEST(ListAllocatorTests, UseMemoryResourceString)
+{
+	counting_resource resource;
+	{
+		std::pmr::string str;
+		use_memory_resource(str, &resource);
+		EXPECT_EQ(str.get_allocator().resource(), &resource);
+		str.assign(100u, 'a');
+		EXPECT_EQ(resource.allocations, 1u);
+	}
+	EXPECT_EQ(resource.deallocations, 1u);
+}
@@ -0,0 +1,52 @@
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+#include "utilities/sorted_table.h"
+#include "utilities/string.h"
+
+using namespace utilities;
+
+namespace
+{
+constexpr auto table = make_sorted_table<std::string_view, int>({
+	{ "b", 2 },
+	{ "c", 3 },
+	{ "a", 1 }
+});
+
+constexpr auto ci_table = make_sorted_table<std::string_view, int, ci_less>({
+	{ "Bc", 2 },
+	{ "aB", 1 }
+});
+} //namespace
+
+TEST(SortedTableTests, Find)
+{
+	static_assert(*table.find(std::string_view("a")) == 1);
+	ASSERT_NE(table.find(std::string_view("c")), nullptr);
+	EXPECT_EQ(*table.find(std::string_view("c")), 3);
+	EXPECT_EQ(table.find(std::string_view("d")), nullptr);
+	EXPECT_EQ(table.find(std::string_view("")), nullptr);
+	EXPECT_EQ(table.find(std::string_view("A")), nullptr);
+
+	EXPECT_EQ(table.get_entries()[0].first, "a");
+	EXPECT_EQ(table.get_entries()[2].first, "c");
+}
+
+TEST(SortedTableTests, FindCaseInsensitive)
+{
+	ASSERT_NE(ci_table.find(std::string_view("AB")), nullptr);
+	EXPECT_EQ(*ci_table.find(std::string_view("AB")), 1);
+	ASSERT_NE(ci_table.find(std::string_view("bc")), nullptr);
+	EXPECT_EQ(*ci_table.find(std::string_view("bc")), 2);
+	EXPECT_EQ(ci_table.find(std::string_view("abc")), nullptr);
+}
+
+TEST(SortedTableTests, Reverse)
+{
+	static constexpr auto reverse = make_reverse_sorted_table(table);
+	ASSERT_NE(reverse.find(2), nullptr);
+	EXPECT_EQ(*reverse.find(2), "b");
+	EXPECT_EQ(reverse.find(4), nullptr);
+}
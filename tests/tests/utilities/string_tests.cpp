@@ -57,3 +57,12 @@ TEST(StringTests, Trim)
 	trim(s2);
 	EXPECT_EQ(s2, "");
 }
+
+TEST(StringTests, CiLess)
+{
+	EXPECT_FALSE(ci_less{}("abc", "ABC"));
+	EXPECT_FALSE(ci_less{}("ABC", "abc"));
+	EXPECT_TRUE(ci_less{}("abc", "ABD"));
+	EXPECT_TRUE(ci_less{}("AB", "abc"));
+	EXPECT_FALSE(ci_less{}("abd", "ABC"));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+
+namespace utilities
+{
+
+//Allocator of the lists of loaded directory entries.
+//Lists use std::allocator, unless the library is built with
+//PE_BLISS_ENABLE_PMR_LISTS. In that case, they use std::pmr::polymorphic_allocator,
+//and loaders can allocate them from the memory resource passed in the loader options.
+#ifdef PE_BLISS_ENABLE_PMR_LISTS
+template<typename T>
+using list_allocator = std::pmr::polymorphic_allocator<T>;
+#else //PE_BLISS_ENABLE_PMR_LISTS
+template<typename T>
+using list_allocator = std::allocator<T>;
+#endif //PE_BLISS_ENABLE_PMR_LISTS
+
+//String type of loaded directory entry names, uses list_allocator
+template<typename Char>
+using list_basic_string = std::basic_string<Char, std::char_traits<Char>,
+	list_allocator<Char>>;
+using list_string = list_basic_string<char>;
+using list_u16string = list_basic_string<char16_t>;
+
+template<typename List>
+constexpr bool is_pmr_list_v = std::is_same_v<typename List::allocator_type,
+	std::pmr::polymorphic_allocator<typename List::value_type>>;
+
+//Makes the empty list or string allocate from the resource. Does nothing if
+//the resource is nullptr or the list does not use std::pmr::polymorphic_allocator.
+template<typename List>
+void use_memory_resource(List& list,
+	[[maybe_unused]] std::pmr::memory_resource* resource) noexcept
+{
+	if constexpr (is_pmr_list_v<List>)
+	{
+		if (!resource)
+			return;
+
+		assert(list.empty());
+		//polymorphic_allocator does not propagate on assignment,
+		//so the list is recreated with the new allocator
+		std::destroy_at(&list);
+		std::construct_at(&list, typename List::allocator_type(resource));
+	}
+}
+
+} //namespace utilities
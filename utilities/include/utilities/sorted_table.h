@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace utilities
+{
+
+//Immutable key-value table, which is sorted at compile time
+//and searched using binary search. Requires no static initialization
+//and no allocations, so it is safe to use concurrently.
+template<typename Key, typename Value, std::size_t N, typename Compare = std::less<>>
+class [[nodiscard]] sorted_table
+{
+public:
+	using value_type = std::pair<Key, Value>;
+	using container_type = std::array<value_type, N>;
+
+public:
+	consteval explicit sorted_table(const container_type& entries)
+		: entries_(entries)
+	{
+		std::sort(entries_.begin(), entries_.end(),
+			[](const value_type& l, const value_type& r) {
+				return Compare{}(l.first, r.first);
+			});
+		if (std::adjacent_find(entries_.cbegin(), entries_.cend(),
+			[](const value_type& l, const value_type& r) {
+				return !Compare{}(l.first, r.first);
+			}) != entries_.cend())
+		{
+			throw std::invalid_argument("Duplicate sorted_table key");
+		}
+	}
+
+	template<typename K>
+	[[nodiscard]]
+	constexpr const Value* find(const K& key) const noexcept
+	{
+		auto it = std::lower_bound(entries_.cbegin(), entries_.cend(), key,
+			[](const value_type& entry, const K& key) {
+				return Compare{}(entry.first, key);
+			});
+		if (it == entries_.cend() || Compare{}(key, it->first))
+			return nullptr;
+		return &it->second;
+	}
+
+	[[nodiscard]]
+	constexpr const container_type& get_entries() const noexcept
+	{
+		return entries_;
+	}
+
+private:
+	container_type entries_;
+};
+
+template<typename Key, typename Value,
+	typename Compare = std::less<>, std::size_t N>
+[[nodiscard]]
+consteval sorted_table<Key, Value, N, Compare> make_sorted_table(
+	std::pair<Key, Value>(&&entries)[N])
+{
+	return sorted_table<Key, Value, N, Compare>(std::to_array(std::move(entries)));
+}
+
+//Builds the table with keys and values swapped
+template<typename Compare = std::less<>, typename Key, typename Value,
+	std::size_t N, typename SourceCompare>
+[[nodiscard]]
+consteval sorted_table<Value, Key, N, Compare> make_reverse_sorted_table(
+	const sorted_table<Key, Value, N, SourceCompare>& table)
+{
+	std::array<std::pair<Value, Key>, N> entries{};
+	std::transform(table.get_entries().cbegin(), table.get_entries().cend(),
+		entries.begin(), [](const auto& entry) {
+			return std::pair<Value, Key>{ entry.second, entry.first };
+		});
+	return sorted_table<Value, Key, N, Compare>(entries);
+}
+
+} //namespace utilities
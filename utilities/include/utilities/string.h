@@ -34,6 +34,21 @@ constexpr bool iequal(std::string_view l, std::string_view r) noexcept
 		r.cbegin(), r.cend(), char_iequal);
 }
 
+//Case-insensitive ordering for ASCII strings
+struct ci_less final
+{
+	using is_transparent = void;
+
+	[[nodiscard]]
+	constexpr bool operator()(std::string_view l, std::string_view r) const noexcept
+	{
+		return std::lexicographical_compare(l.cbegin(), l.cend(),
+			r.cbegin(), r.cend(), [](char lc, char rc) {
+				return to_lower(lc) < to_lower(rc);
+			});
+	}
+};
+
 constexpr void trim(std::string_view& str) noexcept
 {
 	while (!str.empty() && str[0] == ' ')